@@ -84,6 +84,7 @@ static const struct app_bond_db_callbacks user_app_bond_db_callbacks = {
     .app_bdb_get_number_of_stored_irks  = default_app_bdb_get_number_of_stored_irks,
     .app_bdb_get_stored_irks            = default_app_bdb_get_stored_irks,
     .app_bdb_get_device_info_from_slot  = NULL,
+    .app_bdb_cache_rpa                  = default_app_bdb_cache_rpa,
 };
 #endif // (BLE_APP_SEC)
 
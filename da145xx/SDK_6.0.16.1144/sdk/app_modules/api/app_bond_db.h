@@ -70,6 +70,15 @@
 #define APP_BOND_DB_MAX_BONDED_PEERS    (USER_CFG_BOND_DB_MAX_BONDED_PEERS)
 #endif // USER_CFG_BOND_DB_MAX_BONDED_PEERS
 
+/// Number of resolvable private addresses remembered with the slot of the IRK that resolved
+/// them, so that a peer reconnecting with the same address is found without running AES.
+/// Zero disables the cache.
+#ifndef USER_CFG_BOND_DB_RPA_CACHE_SIZE
+#define APP_BOND_DB_RPA_CACHE_SIZE      (8)
+#else
+#define APP_BOND_DB_RPA_CACHE_SIZE      (USER_CFG_BOND_DB_RPA_CACHE_SIZE)
+#endif // USER_CFG_BOND_DB_RPA_CACHE_SIZE
+
 /// Database version
 #define BOND_DB_VERSION                 (0x0001)
 
@@ -140,8 +149,11 @@ void default_app_bdb_remove_entry(enum bdb_search_by_type search_type,
 /**
  ****************************************************************************************
  * @brief Search the database to find the slot with the bond data that match.
+ *        BD address and EDIV searches use hash indexes. Resolvable private address
+ *        searches only find the addresses added with default_app_bdb_cache_rpa().
  * @param[in] search_type   Indicates the type with which bond database will be searched.
- *                          A slot can be matched either by EDIV, BDA, IRK, or custom type.
+ *                          A slot can be matched either by EDIV, BDA, IRK, ID, RPA or
+ *                          custom type.
  * @param[in] search_param  Pointer to the value that will be matched
  * @param[in] search_param_length  Size of the value that will be matched
  * @return Pointer to the bond data if they were found. Otherwise null.
@@ -180,6 +192,18 @@ uint8_t default_app_bdb_get_stored_irks(struct gap_sec_key *valid_irk_irray);
 bool default_app_bdb_get_device_info_from_slot(uint8_t slot,
                                                struct gap_ral_dev_info *dev_info);
 
+/**
+ ****************************************************************************************
+ * @brief Remember that a resolvable private address has been resolved by the IRK stored
+ *        in a slot. Later searches by SEARCH_BY_RPA_TYPE find the slot directly. The least
+ *        recently used address is dropped when the cache is full, and the addresses of a
+ *        slot are dropped when the slot is replaced or removed.
+ * @param[in] rpa          Resolvable private address
+ * @param[in] slot         Slot of the bond data with the IRK which resolved the address
+ ****************************************************************************************
+ */
+void default_app_bdb_cache_rpa(const uint8_t *rpa, uint8_t slot);
+
 #endif // (BLE_APP_SEC)
 
 #endif // _APP_BOND_DB_H_
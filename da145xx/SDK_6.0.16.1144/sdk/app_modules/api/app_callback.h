@@ -168,7 +168,9 @@ struct app_bond_db_callbacks
     /// Callback upon 'bdb_remove_entry'
     void (*app_bdb_remove_entry)(enum bdb_search_by_type, enum bdb_remove_type, void *, uint8_t);
 
-    /// Callback upon 'bdb_search_entry'
+    /// Callback upon 'bdb_search_entry'. The default encryption request handler searches by
+    /// SEARCH_BY_RPA_TYPE first, a database that does not cache resolved addresses must return
+    /// NULL for it.
     const struct app_sec_bond_data_env_tag * (*app_bdb_search_entry)(enum bdb_search_by_type, void *, uint8_t);
 
     /// Callback upon 'bdb_get_number_of_stored_irks'
@@ -179,6 +181,9 @@ struct app_bond_db_callbacks
 
     /// Callback upon 'bdb_get_device_info_from_slot'
     bool (*app_bdb_get_device_info_from_slot)(uint8_t, struct gap_ral_dev_info *);
+
+    /// Callback upon 'bdb_cache_rpa'
+    void (*app_bdb_cache_rpa)(const uint8_t *, uint8_t);
 };
 #endif // (BLE_APP_SEC)
 
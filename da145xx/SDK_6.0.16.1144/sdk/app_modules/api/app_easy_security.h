@@ -326,6 +326,16 @@ uint8_t app_easy_security_bdb_get_stored_irks(struct gap_sec_key *valid_irk_irra
 bool app_easy_security_bdb_get_device_info_from_slot(uint8_t slot,
                                                      struct gap_ral_dev_info *dev_info);
 
+/**
+ ****************************************************************************************
+ * @brief Remember that a resolvable private address has been resolved by the IRK stored
+ *        in a slot, so that it can be found with SEARCH_BY_RPA_TYPE.
+ * @param[in] rpa          Resolvable private address
+ * @param[in] slot         Slot of the bond data with the IRK which resolved the address
+ ****************************************************************************************
+ */
+void app_easy_security_bdb_cache_rpa(const uint8_t *rpa, uint8_t slot);
+
 /**
  ****************************************************************************************
  * @brief Restore all bonded peers with stored identity info from bond database
@@ -26,6 +26,7 @@
  */
 
 #include "ke_msg.h"
+#include "user_config.h"
 
 /*
  * TYPE DEFINITIONS
@@ -38,6 +39,39 @@ typedef uint8_t timer_hnd;
 /// Timer callback function type definition
 typedef void (* timer_callback)(void);
 
+#if defined (USER_CFG_APP_EASY_TIMER_WHEEL)
+struct app_easy_wheel_timer;
+
+/// Timer wheel callback function type definition
+typedef void (* wheel_timer_callback)(struct app_easy_wheel_timer *timer);
+
+/**
+ * Timer of the timer wheel. The application allocates it, zero initialized. It must stay
+ * allocated while it is active and be in retention memory if it is active during sleep.
+ * The fields are managed by the timer wheel functions.
+ */
+struct app_easy_wheel_timer
+{
+    /// Next timer in the same list
+    struct app_easy_wheel_timer *next;
+
+    /// Previous timer in the same list
+    struct app_easy_wheel_timer *prev;
+
+    /// Expiry time in timer ticks, or the delay while the start is deferred
+    uint32_t expiry;
+
+    /// Period of a periodic timer, 0 for a one shot timer
+    uint32_t period;
+
+    /// Callback function
+    wheel_timer_callback fn;
+
+    /// List the timer is in, 0 if the timer is not active
+    uint8_t list;
+};
+#endif
+
 /*
  * DEFINES
  ****************************************************************************************
@@ -107,6 +141,62 @@ timer_hnd app_easy_timer_modify(const timer_hnd timer_id, const uint32_t delay);
  */
 void app_easy_timer_cancel_all(void);
 
+#if defined (USER_CFG_APP_EASY_TIMER_WHEEL)
+/*
+ * TIMER WHEEL
+ *
+ * Defining USER_CFG_APP_EASY_TIMER_WHEEL in user_config.h enables a hierarchical timer
+ * wheel. It runs any number of wheel timers on a single kernel timer. Start, stop and
+ * modify take constant time and do not send kernel messages while the BLE core is awake.
+ * The wheel takes the last easy timer message, so one timer less is left for
+ * app_easy_timer(). The wheel uses about 400 bytes of retention memory.
+ ****************************************************************************************
+ */
+
+/**
+ ****************************************************************************************
+ * @brief Start a wheel timer. Activate the ble if required. A timer that is already active
+ *        is restarted.
+ * @param[in] timer  The timer
+ * @param[in] delay  The amount of timer slots (10 ms) to wait, 1 to KE_TIMER_DELAY_MAX
+ * @param[in] period The period of a periodic timer in timer slots, 0 for a one shot timer.
+ *                   Periodic expiries follow each other without drift.
+ * @param[in] fn     The callback to be called when the timer expires
+ ****************************************************************************************
+ */
+void app_easy_wheel_timer_start(struct app_easy_wheel_timer *timer, uint32_t delay,
+                                uint32_t period, wheel_timer_callback fn);
+
+/**
+ ****************************************************************************************
+ * @brief Stop a wheel timer. Nothing happens if the timer is not active.
+ * @param[in] timer The timer
+ ****************************************************************************************
+ */
+void app_easy_wheel_timer_stop(struct app_easy_wheel_timer *timer);
+
+/**
+ ****************************************************************************************
+ * @brief Restart a wheel timer with a new delay, keeping its period and callback.
+ * @param[in] timer The timer, started at least once
+ * @param[in] delay The new delay value (time resolution is 10ms)
+ ****************************************************************************************
+ */
+void app_easy_wheel_timer_modify(struct app_easy_wheel_timer *timer, uint32_t delay);
+
+/**
+ ****************************************************************************************
+ * @brief Check if a wheel timer is active.
+ * @param[in] timer The timer
+ * @return true if the timer is started and has not expired or been stopped
+ ****************************************************************************************
+ */
+__STATIC_INLINE bool app_easy_wheel_timer_is_active(const struct app_easy_wheel_timer *timer)
+{
+    return (timer->list != 0);
+}
+#endif // USER_CFG_APP_EASY_TIMER_WHEEL
+
 #endif // _APP_EASY_TIMER_H_
 
 ///@}
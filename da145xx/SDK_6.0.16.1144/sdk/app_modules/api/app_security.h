@@ -52,6 +52,8 @@ enum bdb_search_by_type
     SEARCH_BY_SLOT_TYPE,
     /// Search bond database by custom value
     SEARCH_BY_CUSTOM_TYPE,
+    /// Search bond database by previously resolved Resolvable Private Address
+    SEARCH_BY_RPA_TYPE,
     /// Search bond database by custom value
     NO_SEARCH_TYPE,
 };
@@ -41,6 +41,34 @@
 #define BOND_DB_EMPTY_SLOT              (0)
 #define BOND_DB_SLOT_NOT_FOUND          (0xFF)
 
+#if (APP_BOND_DB_MAX_BONDED_PEERS >= BOND_DB_SLOT_NOT_FOUND)
+    #error "APP_BOND_DB_MAX_BONDED_PEERS must be lower than 255."
+#endif
+
+// Number of buckets of the BD address and EDIV indexes. A power of two, at least twice the
+// number of slots, so that the probe sequences stay short and no division is needed.
+#if (APP_BOND_DB_MAX_BONDED_PEERS <= 4)
+    #define BOND_DB_INDEX_SIZE          (8)
+#elif (APP_BOND_DB_MAX_BONDED_PEERS <= 8)
+    #define BOND_DB_INDEX_SIZE          (16)
+#elif (APP_BOND_DB_MAX_BONDED_PEERS <= 16)
+    #define BOND_DB_INDEX_SIZE          (32)
+#elif (APP_BOND_DB_MAX_BONDED_PEERS <= 32)
+    #define BOND_DB_INDEX_SIZE          (64)
+#elif (APP_BOND_DB_MAX_BONDED_PEERS <= 64)
+    #define BOND_DB_INDEX_SIZE          (128)
+#elif (APP_BOND_DB_MAX_BONDED_PEERS <= 128)
+    #define BOND_DB_INDEX_SIZE          (256)
+#else
+    #define BOND_DB_INDEX_SIZE          (512)
+#endif
+
+#define BOND_DB_INDEX_MASK              (BOND_DB_INDEX_SIZE - 1)
+
+// Offsets of the indexed keys in the bond data
+#define BOND_DB_BDA_OFFSET              (offsetof(struct app_sec_bond_data_env_tag, peer_bdaddr.addr))
+#define BOND_DB_EDIV_OFFSET             (offsetof(struct app_sec_bond_data_env_tag, ltk.ediv))
+
 /*
  * TYPE DEFINITIONS
  ****************************************************************************************
@@ -56,6 +84,36 @@ struct bond_db
     uint16_t end_hdr;
 };
 
+/// Hash indexes of the valid slots. They are derived from the bond data, they are not stored
+/// to the external memory and they are rebuilt whenever an entry is added or removed.
+struct bond_db_index
+{
+    /// Slots by peer BD address, open addressing with linear probing
+    uint8_t bda[BOND_DB_INDEX_SIZE];
+    /// Slots by EDIV, open addressing with linear probing
+    uint8_t ediv[BOND_DB_INDEX_SIZE];
+};
+
+#if (APP_BOND_DB_RPA_CACHE_SIZE > 0)
+/// Resolvable private address cache entry
+struct bond_db_rpa_entry
+{
+    /// Resolvable private address
+    uint8_t rpa[BD_ADDR_LEN];
+    /// Slot of the bond data with the IRK which resolves the address
+    uint8_t slot;
+};
+
+/// Resolvable private address cache, the most recently used entry first
+struct bond_db_rpa_cache
+{
+    /// Number of used entries
+    uint8_t nb;
+    /// Entries
+    struct bond_db_rpa_entry entry[APP_BOND_DB_RPA_CACHE_SIZE];
+};
+#endif
+
 /*
  * LOCAL VARIABLE DEFINITIONS
  ****************************************************************************************
@@ -63,6 +121,12 @@ struct bond_db
 
 static struct bond_db bdb __SECTION_ZERO("retention_mem_area0"); //@RETENTION MEMORY
 
+static struct bond_db_index bdb_index __SECTION_ZERO("retention_mem_area0"); //@RETENTION MEMORY
+
+#if (APP_BOND_DB_RPA_CACHE_SIZE > 0)
+static struct bond_db_rpa_cache bdb_rpa_cache __SECTION_ZERO("retention_mem_area0"); //@RETENTION MEMORY
+#endif
+
 /*
  * GLOBAL VARIABLE DEFINITIONS
  ****************************************************************************************
@@ -252,6 +316,208 @@ __STATIC_INLINE void bond_db_store_ext(bool scheduler_en)
     #endif
 }
 
+/**
+ ****************************************************************************************
+ * @brief Hash a key to a bucket of the bond database indexes
+ * @param[in] key       Key
+ * @param[in] len       Key length
+ * @return Bucket
+ ****************************************************************************************
+ */
+static uint16_t bond_db_index_hash(const uint8_t *key, uint8_t len)
+{
+    uint16_t h = 0;
+
+    while (len--)
+    {
+        // h * 33 + byte, without a multiplication
+        h = (h << 5) + h + *key++;
+    }
+
+    return (h ^ (h >> 8)) & BOND_DB_INDEX_MASK;
+}
+
+/**
+ ****************************************************************************************
+ * @brief Add a slot to an index
+ * @param[in] table     Index
+ * @param[in] offset    Offset of the key in the bond data
+ * @param[in] len       Key length
+ * @param[in] slot      Slot
+ ****************************************************************************************
+ */
+static void bond_db_index_insert(uint8_t *table, size_t offset, uint8_t len, uint8_t slot)
+{
+    uint16_t pos = bond_db_index_hash((const uint8_t *)&bdb.data[slot] + offset, len);
+
+    while (table[pos] != BOND_DB_SLOT_NOT_FOUND)
+    {
+        pos = (pos + 1) & BOND_DB_INDEX_MASK;
+    }
+    table[pos] = slot;
+}
+
+/**
+ ****************************************************************************************
+ * @brief Find a key in an index
+ * @param[in] table     Index
+ * @param[in] offset    Offset of the key in the bond data
+ * @param[in] key       Key
+ * @param[in] len       Key length
+ * @return The lowest slot with a matching key or BOND_DB_SLOT_NOT_FOUND
+ ****************************************************************************************
+ */
+static uint8_t bond_db_index_lookup(const uint8_t *table, size_t offset, const uint8_t *key, uint8_t len)
+{
+    uint8_t slot_found = BOND_DB_SLOT_NOT_FOUND;
+    uint16_t pos = bond_db_index_hash(key, len);
+    uint8_t slot;
+
+    // Walk the whole probe sequence, so that duplicate keys (e.g. EDIV) give the same slot as
+    // a linear search would
+    while ((slot = table[pos]) != BOND_DB_SLOT_NOT_FOUND)
+    {
+        if ((slot < slot_found) &&
+            (memcmp((const uint8_t *)&bdb.data[slot] + offset, key, len) == 0))
+        {
+            slot_found = slot;
+        }
+        pos = (pos + 1) & BOND_DB_INDEX_MASK;
+    }
+
+    return slot_found;
+}
+
+#if (APP_BOND_DB_RPA_CACHE_SIZE > 0)
+/**
+ ****************************************************************************************
+ * @brief Find a resolvable private address in the cache and make it the most recently used
+ * @param[in] rpa       Resolvable private address
+ * @return Slot or BOND_DB_SLOT_NOT_FOUND
+ ****************************************************************************************
+ */
+static uint8_t bond_db_rpa_cache_lookup(const uint8_t *rpa)
+{
+    struct bond_db_rpa_entry hit;
+
+    for (uint8_t i = 0; i < bdb_rpa_cache.nb; i++)
+    {
+        if (memcmp(bdb_rpa_cache.entry[i].rpa, rpa, BD_ADDR_LEN) == 0)
+        {
+            hit = bdb_rpa_cache.entry[i];
+            memmove(&bdb_rpa_cache.entry[1], &bdb_rpa_cache.entry[0], i * sizeof(struct bond_db_rpa_entry));
+            bdb_rpa_cache.entry[0] = hit;
+            return hit.slot;
+        }
+    }
+
+    return BOND_DB_SLOT_NOT_FOUND;
+}
+#endif
+
+/**
+ ****************************************************************************************
+ * @brief Rebuild the indexes after the bond data have changed
+ * @param[in] replaced_slot Slot whose bond data have been replaced or BOND_DB_SLOT_NOT_FOUND.
+ *                          Its cached addresses are dropped, as are the addresses of the
+ *                          slots which are no longer valid.
+ ****************************************************************************************
+ */
+static void bond_db_index_rebuild(uint8_t replaced_slot)
+{
+    memset(&bdb_index, BOND_DB_SLOT_NOT_FOUND, sizeof(struct bond_db_index));
+
+    for (uint8_t i = 0; i < APP_BOND_DB_MAX_BONDED_PEERS; i++)
+    {
+        if (bdb.valid_slot[i] == BOND_DB_VALID_ENTRY)
+        {
+            bond_db_index_insert(bdb_index.bda, BOND_DB_BDA_OFFSET, BD_ADDR_LEN, i);
+            bond_db_index_insert(bdb_index.ediv, BOND_DB_EDIV_OFFSET, sizeof(uint16_t), i);
+        }
+    }
+
+#if (APP_BOND_DB_RPA_CACHE_SIZE > 0)
+    uint8_t nb = 0;
+
+    for (uint8_t i = 0; i < bdb_rpa_cache.nb; i++)
+    {
+        uint8_t slot = bdb_rpa_cache.entry[i].slot;
+
+        if ((slot != replaced_slot) && (bdb.valid_slot[slot] == BOND_DB_VALID_ENTRY))
+        {
+            bdb_rpa_cache.entry[nb++] = bdb_rpa_cache.entry[i];
+        }
+    }
+    bdb_rpa_cache.nb = nb;
+#endif
+}
+
+/**
+ ****************************************************************************************
+ * @brief Find the slot with the bond data that match.
+ *        Full BD addresses and EDIVs are looked up in the indexes and resolvable private
+ *        addresses in the cache. Other searches scan the database.
+ * @param[in] search_type   Search type
+ * @param[in] search_param  Pointer to the value that will be matched
+ * @param[in] search_param_length  Size of the value that will be matched
+ * @return Slot or BOND_DB_SLOT_NOT_FOUND
+ ****************************************************************************************
+ */
+static uint8_t bond_db_find_slot(enum bdb_search_by_type search_type, const void *search_param,
+                                 uint8_t search_param_length)
+{
+    if ((search_type == SEARCH_BY_BDA_TYPE) && (search_param_length == BD_ADDR_LEN))
+    {
+        return bond_db_index_lookup(bdb_index.bda, BOND_DB_BDA_OFFSET, search_param, search_param_length);
+    }
+
+    if ((search_type == SEARCH_BY_EDIV_TYPE) && (search_param_length == sizeof(uint16_t)))
+    {
+        return bond_db_index_lookup(bdb_index.ediv, BOND_DB_EDIV_OFFSET, search_param, search_param_length);
+    }
+
+    if (search_type == SEARCH_BY_RPA_TYPE)
+    {
+#if (APP_BOND_DB_RPA_CACHE_SIZE > 0)
+        if (search_param_length == BD_ADDR_LEN)
+        {
+            return bond_db_rpa_cache_lookup(search_param);
+        }
+#endif
+        return BOND_DB_SLOT_NOT_FOUND;
+    }
+
+    for(uint8_t i = 0; i < APP_BOND_DB_MAX_BONDED_PEERS; i++)
+    {
+        // Check if EDIVs match
+        if ((search_type == SEARCH_BY_EDIV_TYPE) &&
+            ((memcmp(&bdb.data[i].ltk.ediv, search_param, search_param_length) == 0)))
+        {
+            return i;
+        }
+        // Check if BD addresses match
+        else if ((search_type == SEARCH_BY_BDA_TYPE) &&
+                 ((memcmp(&bdb.data[i].peer_bdaddr.addr, search_param, search_param_length) == 0)))
+        {
+            return i;
+        }
+        // Check if IRKs match
+        else if ((search_type == SEARCH_BY_IRK_TYPE) &&
+                 (memcmp(&bdb.data[i].rirk, search_param, search_param_length) == 0))
+        {
+            return i;
+        }
+        // Check if bond_db BD address and given ID address match
+        else if ((search_type == SEARCH_BY_ID_TYPE) &&
+                 (memcmp(&bdb.data[i].rirk.addr.addr, search_param, search_param_length) == 0))
+        {
+            return i;
+        }
+    }
+
+    return BOND_DB_SLOT_NOT_FOUND;
+}
+
 /**
  ****************************************************************************************
  * @brief Store Bond data entry to external memory
@@ -264,6 +530,7 @@ static void bond_db_store_at_idx(struct app_sec_bond_data_env_tag *data, int idx
     bdb.valid_slot[idx] = BOND_DB_VALID_ENTRY;
     // Update the cache
     memcpy(&bdb.data[idx], data, sizeof(struct app_sec_bond_data_env_tag));
+    bond_db_index_rebuild(idx);
     // Store new bond data to external memory
     // In case of Flash (erase then write) enable the scheduler
     bond_db_store_ext(true);
@@ -279,6 +546,7 @@ static void bond_db_clear(bool scheduler_en)
     memset((void *)&bdb, 0, sizeof(struct bond_db) ); // zero bond data
     bdb.start_hdr = BOND_DB_HEADER_START;
     bdb.end_hdr = BOND_DB_HEADER_END;
+    bond_db_index_rebuild(BOND_DB_SLOT_NOT_FOUND);
     // Store zero bond data to external memory
     // In case of Flash (erase then write) do not enable the scheduler
     bond_db_store_ext(scheduler_en);
@@ -299,6 +567,10 @@ void default_app_bdb_init(void)
     {
         bond_db_clear(false);
     }
+    else
+    {
+        bond_db_index_rebuild(BOND_DB_SLOT_NOT_FOUND);
+    }
 }
 
 uint8_t default_app_bdb_get_size(void)
@@ -394,39 +666,7 @@ void default_app_bdb_remove_entry(enum bdb_search_by_type search_type, enum bdb_
     }
     else
     {
-        for(i = 0; i < APP_BOND_DB_MAX_BONDED_PEERS; i++)
-        {
-            // Check if EDIVs match
-            if ((search_type == SEARCH_BY_EDIV_TYPE) &&
-                ((memcmp(&bdb.data[i].ltk.ediv, search_param, search_param_length) == 0)))
-            {
-                slot_found = i;
-                break;
-            }
-            // Check if BD addresses match
-            else if ((search_type == SEARCH_BY_BDA_TYPE) &&
-                     ((memcmp(&bdb.data[i].peer_bdaddr.addr, search_param, search_param_length) == 0)))
-            {
-                slot_found = i;
-                break;
-            }
-            // Check if IRKs match
-            else if ((search_type == SEARCH_BY_IRK_TYPE) &&
-                     (memcmp(&bdb.data[i].rirk, search_param, search_param_length) == 0))
-            {
-                slot_found = i;
-                break;
-            }
-            else if (search_type == SEARCH_BY_ID_TYPE)
-            {
-                // Check if bond_db BD address and given ID address match
-                if ((memcmp(&bdb.data[i].rirk.addr.addr, search_param, search_param_length) == 0))
-                {
-                    slot_found = i;
-                    break;
-                }
-            }
-        }
+        slot_found = bond_db_find_slot(search_type, search_param, search_param_length);
     }
 
     // Check if a valid slot has been found
@@ -452,6 +692,7 @@ void default_app_bdb_remove_entry(enum bdb_search_by_type search_type, enum bdb_
                 }
             }
         }
+        bond_db_index_rebuild(BOND_DB_SLOT_NOT_FOUND);
         // Store the updated cache to the external non volatile memory
         bond_db_store_ext(true);
     }
@@ -461,41 +702,14 @@ const struct app_sec_bond_data_env_tag* default_app_bdb_search_entry(enum bdb_se
                                                              void *search_param,
                                                              uint8_t search_param_length)
 {
-    struct app_sec_bond_data_env_tag *found_data = NULL;
+    uint8_t slot = bond_db_find_slot(search_type, search_param, search_param_length);
 
-    for(uint8_t i = 0; i < APP_BOND_DB_MAX_BONDED_PEERS; i++)
+    if (slot < APP_BOND_DB_MAX_BONDED_PEERS)
     {
-        // Check if EDIVs match
-        if ((search_type == SEARCH_BY_EDIV_TYPE) &&
-            ((memcmp(&bdb.data[i].ltk.ediv, search_param, search_param_length) == 0)))
-        {
-            found_data = &bdb.data[i];
-            break;
-        }
-        // Check if BD addresses match
-        else if ((search_type == SEARCH_BY_BDA_TYPE) &&
-                 ((memcmp(&bdb.data[i].peer_bdaddr.addr, search_param, search_param_length) == 0)))
-        {
-            found_data = &bdb.data[i];
-            break;
-        }
-        // Check if IRKs match
-        else if ((search_type == SEARCH_BY_IRK_TYPE) &&
-                 (memcmp(&bdb.data[i].rirk, search_param, search_param_length) == 0))
-        {
-            found_data = &bdb.data[i];
-            break;
-        }
-        // Check if IDs match
-        else if ((search_type == SEARCH_BY_ID_TYPE) &&
-                (memcmp(&bdb.data[i].rirk.addr.addr, search_param, search_param_length) == 0))
-        {
-            found_data = &bdb.data[i];
-            break;
-        }
+        return &bdb.data[slot];
     }
 
-    return found_data;
+    return NULL;
 }
 
 uint8_t default_app_bdb_get_number_of_stored_irks(void)
@@ -544,6 +758,35 @@ bool default_app_bdb_get_device_info_from_slot(uint8_t slot, struct gap_ral_dev_
     }
     return false;
 }
+
+void default_app_bdb_cache_rpa(const uint8_t *rpa, uint8_t slot)
+{
+#if (APP_BOND_DB_RPA_CACHE_SIZE > 0)
+    // Only cache addresses resolved by a stored IRK
+    if ((slot >= APP_BOND_DB_MAX_BONDED_PEERS) || (bdb.valid_slot[slot] != BOND_DB_VALID_ENTRY) ||
+        ((bdb.data[slot].valid_keys & RIRK_PRESENT) != RIRK_PRESENT))
+    {
+        return;
+    }
+
+    // Already cached, it is now the most recently used entry
+    if (bond_db_rpa_cache_lookup(rpa) != BOND_DB_SLOT_NOT_FOUND)
+    {
+        bdb_rpa_cache.entry[0].slot = slot;
+        return;
+    }
+
+    // Insert as the most recently used entry, dropping the least recently used one if full
+    if (bdb_rpa_cache.nb < APP_BOND_DB_RPA_CACHE_SIZE)
+    {
+        bdb_rpa_cache.nb++;
+    }
+    memmove(&bdb_rpa_cache.entry[1], &bdb_rpa_cache.entry[0],
+            (bdb_rpa_cache.nb - 1) * sizeof(struct bond_db_rpa_entry));
+    memcpy(bdb_rpa_cache.entry[0].rpa, rpa, BD_ADDR_LEN);
+    bdb_rpa_cache.entry[0].slot = slot;
+#endif
+}
 #endif // (BLE_APP_SEC)
 
 /// @} APP_BOND_DB
@@ -438,8 +438,17 @@ void default_app_on_encrypt_req_ind(uint8_t conidx,
             // Check if peer's BD address is Resolvable Private Address
             else if (bdaddr_type == APP_RANDOM_PRIVATE_RESOLV_ADDR_TYPE)
             {
+                // Search DB for an already resolved address
+                pbd = app_easy_security_bdb_search_entry(SEARCH_BY_RPA_TYPE, (void *) app_env[conidx].peer_addr.addr, BD_ADDR_LEN);
+                if (pbd)
+                {
+                    // Store device bond data to security environment
+                    app_sec_env[conidx] = *pbd;
+                    // Accept encryption
+                    app_easy_security_accept_encryption(conidx);
+                }
                 // Start BD address resolving procedure
-                if(!app_easy_security_resolve_bdaddr(conidx))
+                else if(!app_easy_security_resolve_bdaddr(conidx))
                 {
                     app_easy_security_reject_encryption(conidx);
                 }
@@ -516,6 +525,8 @@ void default_app_on_addr_solved_ind(uint8_t conidx,
     // If peer has been found in DB
     if(pbd)
     {
+        // Remember the address, next time it is found without resolving it
+        app_easy_security_bdb_cache_rpa(param->addr.addr, pbd->bdb_slot);
         // Store device bond data to security environment
         app_sec_env[conidx] = *pbd;
         // Accept encryption
@@ -454,6 +454,11 @@ bool app_easy_security_bdb_get_device_info_from_slot(uint8_t slot,
     return false;
 }
 
+void app_easy_security_bdb_cache_rpa(const uint8_t *rpa, uint8_t slot)
+{
+    CALLBACK_ARGS_2(user_app_bond_db_callbacks.app_bdb_cache_rpa, rpa, slot)
+}
+
 void app_easy_security_ral_sync_with_bdb(void)
 {
     uint8_t nb_key = 0;
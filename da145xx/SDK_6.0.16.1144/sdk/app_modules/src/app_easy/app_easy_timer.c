@@ -35,12 +35,23 @@
 #include "app_entry_point.h"
 #include "app_easy_timer.h"
 
+#if defined (USER_CFG_APP_EASY_TIMER_WHEEL)
+#include "lld_evt.h"
+#endif
+
 /*
  * DEFINES
  ****************************************************************************************
  */
 
+#if defined (USER_CFG_APP_EASY_TIMER_WHEEL)
+// The last timer message drives the timer wheel
+#define APP_TIMER_MAX_NUM                         (APP_TIMER_API_LAST_MES - APP_TIMER_API_MES0)
+#define APP_EASY_TIMER_WHEEL_MSG                  (APP_TIMER_API_LAST_MES)
+#define APP_EASY_TIMER_WHEEL_HND                  (APP_EASY_TIMER_MSG_ID_TO_HND(APP_EASY_TIMER_WHEEL_MSG))
+#else
 #define APP_TIMER_MAX_NUM                         (APP_TIMER_API_LAST_MES - APP_TIMER_API_MES0 + 1)
+#endif
 /*
     HND: Timer handler values = 1...APP_TIMER_MAX_NUM
     IDX: The index to the table = 0...APP_TIMER_MAX_NUM-1
@@ -54,6 +65,34 @@
 #define APP_EASY_TIMER_IDX_TO_HND(timer_id)       (timer_id + 1)
 #define APP_EASY_TIMER_HND_IS_VALID(timer_id)     ((timer_id > 0) && (timer_id <= APP_TIMER_MAX_NUM))
 
+#if defined (USER_CFG_APP_EASY_TIMER_WHEEL)
+/*
+    The wheel has WHEEL_LEVELS levels of WHEEL_SLOTS slots. A slot of level L spans
+    WHEEL_SLOTS^L ticks. A timer is kept in the level of the most significant digit (base
+    WHEEL_SLOTS) in which its expiry time differs from the wheel time, in the slot of that
+    digit. When the wheel time reaches the start of a slot of a level above 0, its timers are
+    moved down to the lower levels. The timers of a slot of level 0 expire together.
+    A timer moves down at most WHEEL_LEVELS - 1 times. The levels span 2^24 ticks, more than
+    twice KE_TIMER_DELAY_MAX, so the top level is used circularly.
+ */
+#define WHEEL_SLOT_BITS                           (4)
+#define WHEEL_SLOTS                               (1 << WHEEL_SLOT_BITS)
+#define WHEEL_LEVELS                              (6)
+#define WHEEL_TOP_SPAN_BITS                       (WHEEL_SLOT_BITS * WHEEL_LEVELS)
+
+// Lists: 0 = no list, 1...WHEEL_LEVELS*WHEEL_SLOTS = wheel slots, then the pending and firing lists
+#define WHEEL_SLOT_LIST(level, slot)              (1 + (level) * WHEEL_SLOTS + (slot))
+#define WHEEL_LIST_PENDING                        (1 + WHEEL_LEVELS * WHEEL_SLOTS)
+#define WHEEL_LIST_FIRING                         (WHEEL_LIST_PENDING + 1)
+#define WHEEL_NB_LISTS                            (WHEEL_LIST_FIRING)
+
+// Digit of a time in a level
+#define WHEEL_DIGIT(time, level)                  (((time) >> ((level) * WHEEL_SLOT_BITS)) & (WHEEL_SLOTS - 1))
+
+// Kernel time in timer ticks (10 ms) from the BLE base time counter (625 us)
+#define WHEEL_HW_TIME_MASK                        (BLE_BASETIMECNT_MASK >> 4)
+#endif
+
 /*
  * GLOBAL VARIABLE DEFINITIONS
  ****************************************************************************************
@@ -83,6 +122,31 @@ static timer_callback timer_callbacks[APP_TIMER_MAX_NUM]          __SECTION_ZERO
 // Array that holds the callback function of the active timers, whose delay period is to be modified
 static timer_callback modified_timer_callbacks[APP_TIMER_MAX_NUM] __SECTION_ZERO("retention_mem_area0");
 
+#if defined (USER_CFG_APP_EASY_TIMER_WHEEL)
+// First timer of each list of the timer wheel
+static struct app_easy_wheel_timer *wheel_lists[WHEEL_NB_LISTS]  __SECTION_ZERO("retention_mem_area0");
+
+// Bitmap of the non empty slots of each level
+static uint16_t wheel_slot_map[WHEEL_LEVELS]                      __SECTION_ZERO("retention_mem_area0");
+
+// Time up to which the wheel has been processed, in ticks
+static uint32_t wheel_time                                        __SECTION_ZERO("retention_mem_area0");
+
+// Current time is wheel_clock_base + elapsed kernel time since wheel_clock_hw_base
+static uint32_t wheel_clock_base                                  __SECTION_ZERO("retention_mem_area0");
+static uint32_t wheel_clock_hw_base                               __SECTION_ZERO("retention_mem_area0");
+
+// Expiry time of the kernel timer of the wheel, valid if wheel_armed is true
+static uint32_t wheel_armed_time                                  __SECTION_ZERO("retention_mem_area0");
+static bool wheel_armed                                           __SECTION_ZERO("retention_mem_area0");
+
+// True while the wheel calls the expired timers
+static bool wheel_busy                                            __SECTION_ZERO("retention_mem_area0");
+
+// True if the processing of the pending timers has been requested
+static bool wheel_sync_requested                                  __SECTION_ZERO("retention_mem_area0");
+#endif
+
 /*
  * FUNCTION DEFINITIONS
  ****************************************************************************************
@@ -198,6 +262,281 @@ static void create_timer(timer_hnd timer_id, uint32_t delay)
     }
 }
 
+#if defined (USER_CFG_APP_EASY_TIMER_WHEEL)
+/**
+ ****************************************************************************************
+ * @brief Get the current time of the timer wheel.
+ * @details The BLE core must be active. The kernel time wraps around, so the time must be
+ * read at least once per KE_TIMER_DELAY_MAX while timers are active, which the kernel timer
+ * of the wheel guarantees.
+ * @return The current time in ticks (10 ms)
+ ****************************************************************************************
+ */
+static uint32_t wheel_clock_sync(void)
+{
+    uint32_t hw_time = (lld_evt_time_get() >> 4) & WHEEL_HW_TIME_MASK;
+
+    wheel_clock_base += (hw_time - wheel_clock_hw_base) & WHEEL_HW_TIME_MASK;
+    wheel_clock_hw_base = hw_time;
+
+    return wheel_clock_base;
+}
+
+/**
+ ****************************************************************************************
+ * @brief Append a timer to a list of the wheel.
+ * @param[in] timer The timer
+ * @param[in] list  The list
+ ****************************************************************************************
+ */
+static void wheel_list_add(struct app_easy_wheel_timer *timer, uint8_t list)
+{
+    struct app_easy_wheel_timer *first = wheel_lists[list - 1];
+
+    if (first == NULL)
+    {
+        timer->next = timer;
+        timer->prev = timer;
+        wheel_lists[list - 1] = timer;
+
+        if (list < WHEEL_LIST_PENDING)
+        {
+            wheel_slot_map[(list - 1) / WHEEL_SLOTS] |= 1 << ((list - 1) % WHEEL_SLOTS);
+        }
+    }
+    else
+    {
+        // Timers of the same slot expire in the order they were started
+        timer->next = first;
+        timer->prev = first->prev;
+        first->prev->next = timer;
+        first->prev = timer;
+    }
+    timer->list = list;
+}
+
+/**
+ ****************************************************************************************
+ * @brief Remove a timer from its list.
+ * @param[in] timer The timer
+ ****************************************************************************************
+ */
+static void wheel_list_remove(struct app_easy_wheel_timer *timer)
+{
+    uint8_t list = timer->list;
+
+    if (timer->next == timer)
+    {
+        wheel_lists[list - 1] = NULL;
+
+        if (list < WHEEL_LIST_PENDING)
+        {
+            wheel_slot_map[(list - 1) / WHEEL_SLOTS] &= ~(1 << ((list - 1) % WHEEL_SLOTS));
+        }
+    }
+    else
+    {
+        timer->prev->next = timer->next;
+        timer->next->prev = timer->prev;
+
+        if (wheel_lists[list - 1] == timer)
+        {
+            wheel_lists[list - 1] = timer->next;
+        }
+    }
+    timer->list = 0;
+}
+
+/**
+ ****************************************************************************************
+ * @brief Put a timer in the slot of its expiry time.
+ * @param[in] timer The timer, expiry not before wheel_time
+ ****************************************************************************************
+ */
+static void wheel_insert(struct app_easy_wheel_timer *timer)
+{
+    uint32_t diff = timer->expiry ^ wheel_time;
+    uint8_t level = 0;
+
+    while ((diff >= WHEEL_SLOTS) && (level < WHEEL_LEVELS - 1))
+    {
+        diff >>= WHEEL_SLOT_BITS;
+        level++;
+    }
+
+    wheel_list_add(timer, WHEEL_SLOT_LIST(level, WHEEL_DIGIT(timer->expiry, level)));
+}
+
+/**
+ ****************************************************************************************
+ * @brief Find the next slot the wheel time reaches that has timers.
+ * @param[out] time The time the slot starts
+ * @return The list of the slot, 0 if the wheel is empty
+ ****************************************************************************************
+ */
+static uint8_t wheel_next_slot(uint32_t *time)
+{
+    for (uint8_t level = 0; level < WHEEL_LEVELS; level++)
+    {
+        uint8_t shift = level * WHEEL_SLOT_BITS;
+        uint8_t digit = WHEEL_DIGIT(wheel_time, level);
+        uint32_t base = wheel_time & ~((1UL << (shift + WHEEL_SLOT_BITS)) - 1);
+        uint16_t map = wheel_slot_map[level] & ~((2U << digit) - 1);
+
+        if ((map == 0) && (level == WHEEL_LEVELS - 1))
+        {
+            // The top level wraps around
+            map = wheel_slot_map[level] & ((1U << digit) - 1);
+            base += 1UL << WHEEL_TOP_SPAN_BITS;
+        }
+
+        if (map != 0)
+        {
+            uint8_t slot = 0;
+
+            while (!(map & 1))
+            {
+                map >>= 1;
+                slot++;
+            }
+            *time = base + ((uint32_t)slot << shift);
+            return WHEEL_SLOT_LIST(level, slot);
+        }
+    }
+    return 0;
+}
+
+/**
+ ****************************************************************************************
+ * @brief Move the wheel time to the start of the next slot with timers, moving its timers
+ *        down and calling the expired timers.
+ * @param[in] time The start of the next slot with timers
+ ****************************************************************************************
+ */
+static void wheel_process(uint32_t time)
+{
+    struct app_easy_wheel_timer *timer;
+    uint32_t diff = time ^ wheel_time;
+    uint8_t level = 0;
+
+    while ((diff >= WHEEL_SLOTS) && (level < WHEEL_LEVELS - 1))
+    {
+        diff >>= WHEEL_SLOT_BITS;
+        level++;
+    }
+
+    wheel_time = time;
+
+    // Only the slot that starts now in the highest level that changed can have timers
+    if (level > 0)
+    {
+        uint8_t list = WHEEL_SLOT_LIST(level, WHEEL_DIGIT(time, level));
+
+        while ((timer = wheel_lists[list - 1]) != NULL)
+        {
+            wheel_list_remove(timer);
+            wheel_insert(timer);
+        }
+    }
+
+    // The callbacks may stop any timer, including the ones that expire now
+    while ((timer = wheel_lists[WHEEL_SLOT_LIST(0, WHEEL_DIGIT(time, 0)) - 1]) != NULL)
+    {
+        wheel_list_remove(timer);
+        wheel_list_add(timer, WHEEL_LIST_FIRING);
+    }
+
+    while ((timer = wheel_lists[WHEEL_LIST_FIRING - 1]) != NULL)
+    {
+        wheel_list_remove(timer);
+
+        if (timer->period != 0)
+        {
+            timer->expiry += timer->period;
+            wheel_insert(timer);
+        }
+        timer->fn(timer);
+    }
+}
+
+/**
+ ****************************************************************************************
+ * @brief Set the kernel timer of the wheel to the first expiry of the wheel.
+ * @param[in] now The current time
+ ****************************************************************************************
+ */
+static void wheel_arm(uint32_t now)
+{
+    struct app_easy_wheel_timer *first, *timer;
+    uint32_t expiry;
+    uint8_t list = wheel_next_slot(&expiry);
+
+    if (list == 0)
+    {
+        // An armed kernel timer just runs the wheel once more
+        return;
+    }
+
+    // The timers of a slot above level 0 may expire in any order
+    first = wheel_lists[list - 1];
+    expiry = first->expiry;
+    for (timer = first->next; timer != first; timer = timer->next)
+    {
+        if ((int32_t)(timer->expiry - expiry) < 0)
+        {
+            expiry = timer->expiry;
+        }
+    }
+
+    if ((int32_t)(expiry - now) <= 0)
+    {
+        expiry = now + 1;
+    }
+
+    ke_timer_set(APP_EASY_TIMER_WHEEL_MSG, TASK_APP, expiry - now);
+    wheel_armed_time = expiry;
+    wheel_armed = true;
+}
+
+/**
+ ****************************************************************************************
+ * @brief Bring the wheel up to date: call the expired timers, start the pending timers and
+ *        set the kernel timer.
+ * @details Called when the kernel timer of the wheel expires and after the BLE core wakes
+ * up for the pending timers.
+ ****************************************************************************************
+ */
+static void wheel_run(void)
+{
+    struct app_easy_wheel_timer *timer;
+    uint32_t now = wheel_clock_sync();
+    uint32_t time;
+
+    wheel_armed = false;
+    wheel_sync_requested = false;
+    wheel_busy = true;
+
+    while ((wheel_next_slot(&time) != 0) && ((int32_t)(time - now) <= 0))
+    {
+        wheel_process(time);
+    }
+    wheel_time = now;
+
+    // Start the timers that were started while the BLE core was sleeping
+    while ((timer = wheel_lists[WHEEL_LIST_PENDING - 1]) != NULL)
+    {
+        wheel_list_remove(timer);
+        timer->expiry += now;
+        wheel_insert(timer);
+    }
+
+    wheel_busy = false;
+
+    // The callbacks may have taken some time
+    wheel_arm(wheel_clock_sync());
+}
+#endif // USER_CFG_APP_EASY_TIMER_WHEEL
+
 /**
  ****************************************************************************************
  * @brief Handler function that is called when the TASK_APP receives the APP_CREATE_TIMER
@@ -215,6 +554,15 @@ static int create_timer_handler(ke_msg_id_t const msgid,
                                 ke_task_id_t const dest_id,
                                 ke_task_id_t const src_id)
 {
+#if defined (USER_CFG_APP_EASY_TIMER_WHEEL)
+    if (param->timer_id == APP_EASY_TIMER_WHEEL_HND)
+    {
+        // The BLE core is awake, start the pending wheel timers
+        wheel_run();
+        return KE_MSG_CONSUMED;
+    }
+#endif
+
     // Sanity checks
     ASSERT_ERROR(param->delay > 0);                  // Delay should not be zero
     ASSERT_ERROR(param->delay <= KE_TIMER_DELAY_MAX); // Delay should not be more than maximum allowed
@@ -345,6 +693,13 @@ enum process_event_response app_timer_api_process_handler(ke_msg_id_t const msgi
             {
                 return PR_EVENT_UNHANDLED;
             }
+#if defined (USER_CFG_APP_EASY_TIMER_WHEEL)
+            else if (msgid == APP_EASY_TIMER_WHEEL_MSG)
+            {
+                wheel_run();
+                *msg_ret = KE_MSG_CONSUMED;
+            }
+#endif
             else
             {
                 *msg_ret = (enum ke_msg_status_tag)call_callback_handler(msgid, param, dest_id, src_id);
@@ -464,6 +819,80 @@ void app_easy_timer_cancel_all(void)
     }
 }
 
+#if defined (USER_CFG_APP_EASY_TIMER_WHEEL)
+void app_easy_wheel_timer_start(struct app_easy_wheel_timer *timer, uint32_t delay,
+                                uint32_t period, wheel_timer_callback fn)
+{
+    // Sanity checks
+    ASSERT_ERROR(delay > 0);                    // Delay should not be zero
+    ASSERT_ERROR(delay <= KE_TIMER_DELAY_MAX);  // Delay should not be more than maximum allowed
+    ASSERT_ERROR(period <= KE_TIMER_DELAY_MAX); // Period should not be more than maximum allowed
+
+    if (timer->list != 0)
+    {
+        wheel_list_remove(timer);
+    }
+
+    timer->period = period;
+    timer->fn = fn;
+
+    if (app_check_BLE_active())
+    {
+        uint32_t now = wheel_clock_sync();
+        uint32_t time;
+
+        // The wheel time can move freely while the wheel is empty
+        if (!wheel_busy && (wheel_next_slot(&time) == 0))
+        {
+            wheel_time = now;
+        }
+
+        timer->expiry = now + delay;
+        wheel_insert(timer);
+
+        // All timers expire at or after the armed time
+        if (!wheel_busy && (!wheel_armed || ((int32_t)(timer->expiry - wheel_armed_time) < 0)))
+        {
+            ke_timer_set(APP_EASY_TIMER_WHEEL_MSG, TASK_APP, delay);
+            wheel_armed_time = timer->expiry;
+            wheel_armed = true;
+        }
+    }
+    else
+    {
+        // The time cannot be read, start the timer when the BLE core is awake
+        timer->expiry = delay;
+        wheel_list_add(timer, WHEEL_LIST_PENDING);
+
+        if (!wheel_sync_requested)
+        {
+            struct create_timer_struct *req;
+
+            wheel_sync_requested = true;
+            arch_ble_force_wakeup();
+            req = KE_MSG_ALLOC(APP_CREATE_TIMER, TASK_APP, TASK_APP, create_timer_struct);
+            req->timer_id = APP_EASY_TIMER_WHEEL_HND;
+            req->delay = 0;
+            ke_msg_send(req);
+        }
+    }
+}
+
+void app_easy_wheel_timer_stop(struct app_easy_wheel_timer *timer)
+{
+    // The kernel timer is left armed, the wheel finds nothing to do when it expires
+    if (timer->list != 0)
+    {
+        wheel_list_remove(timer);
+    }
+}
+
+void app_easy_wheel_timer_modify(struct app_easy_wheel_timer *timer, uint32_t delay)
+{
+    app_easy_wheel_timer_start(timer, delay, timer->period, timer->fn);
+}
+#endif // USER_CFG_APP_EASY_TIMER_WHEEL
+
 #endif // (BLE_APP_PRESENT)
 
 /// @} APP
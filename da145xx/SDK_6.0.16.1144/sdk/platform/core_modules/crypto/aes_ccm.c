@@ -34,9 +34,6 @@
  ****************************************************************************************
  */
 
-#define HW_ENCODE 1
-#define HW_DECODE 0
-
 // Flags for input data formatting
 // [Sec. A.2.1 in NIST_SP_800-38C]
 #define CCM_FLAG_Q
@@ -75,44 +72,15 @@
 
 #define CCM_FLAG_SET(dst, flag, value) (dst = (dst & ~(flag##_MASK << flag##_OFFSET)) | ((value & flag##_MASK) << flag##_OFFSET))
 
-/*
- * STRUCTURES
- ****************************************************************************************
- */
-
-// Associated data encoding struct
+// Largest associated data length encoded in 2 bytes
 // [Sec. A.2.2 in NIST_SP_800-38C]
-struct Alen_encoding2 {
-    uint8_t data[2];
-};
-
-struct Alen_encoding6 {
-    uint8_t magic[2];
-    uint8_t data[4];
-};
-
-struct Alen_encoding10 {
-    uint8_t magic[2];
-    uint8_t data[8];
-};
-
-union Alen_encoding {
-    struct Alen_encoding2 alen2;
-    struct Alen_encoding6 alen6;
-    struct Alen_encoding10 alen10;
-};
+#define CCM_ADATA_LEN2_MAX      (65280)
 
 /*
  * GLOBAL VARIABLE DEFINITIONS
  ****************************************************************************************
  */
 
-// Data block
-struct aes_ccm_env_tag AES128_ccm_blk;
-
-// Memory block allocation
-uint8_t blk_mem_type        __SECTION_ZERO("retention_mem_area0"); //@RETENTION MEMORY
-
 // Length of Auth Bytes (TAG/MAC), options are 4,6,8,10,12,14 and 16
 uint8_t CCM_T               __SECTION_ZERO("retention_mem_area0"); //@RETENTION MEMORY
 // Length of the encoded Plain Text length field, options are 2~8
@@ -123,6 +91,9 @@ uint8_t CCM_N               __SECTION_ZERO("retention_mem_area0"); //@RETENTION
 // Key variable
 uint8_t key_aes[KEY_LEN]    __SECTION_ZERO("retention_mem_area0"); //@RETENTION MEMORY
 
+// Context of the aes_ccm_encrypt()/aes_ccm_decrypt() API, set up on every call
+static struct aes_ccm_ctx ccm_ctx;
+
 /*
  * STATIC FUNCTION DEFINITIONS
  ****************************************************************************************
@@ -130,489 +101,255 @@ uint8_t key_aes[KEY_LEN]    __SECTION_ZERO("retention_mem_area0"); //@RETENTION
 
 /**
  ****************************************************************************************
- * @brief AES Encryption
- * @param[in] input     Plain data to be encrypted
- * @param[out] output   Encrypted Data
- * @param[in] size      Data length
+ * @brief Absorb data into the CBC-MAC
+ * @details Data is xored into the X block, which is encrypted whenever it is complete.
+ * @param[in,out] ctx   Context
+ * @param[in] data      Data
+ * @param[in] len       Length in bytes
  ****************************************************************************************
  */
-static void aes_encrypt(uint8_t *input, uint8_t *output, uint16_t size)
+static void ccm_mac_update(struct aes_ccm_ctx *ctx, const uint8_t *data, uint32_t len)
 {
-    uint8_t num_blk = aes_get_blk_num(size);
+    while (len--)
+    {
+        ctx->x_blk[ctx->mac_pos++] ^= *data++;
 
-    aes_cbc_encrypt(input, num_blk, output, num_blk, key_aes, sizeof(key_aes), NULL);
+        if (ctx->mac_pos == CCM_BLK_SIZE)
+        {
+            aes_ttable_encrypt(&ctx->key, ctx->x_blk, ctx->x_blk);
+            ctx->mac_pos = 0;
+        }
+    }
 }
 
 /**
  ****************************************************************************************
- * @brief Set AES key for later use
- * @param[in] key   key to be used, should be 16 bytes
+ * @brief Pad the current CBC-MAC block with zeros and encrypt it
+ * @param[in,out] ctx   Context
  ****************************************************************************************
  */
-__STATIC_INLINE void aes_key_init(uint8_t *key)
+__STATIC_INLINE void ccm_mac_pad(struct aes_ccm_ctx *ctx)
 {
-    memcpy(&key_aes, key, 16);
+    // Xoring the padding zeros leaves the X block as it is
+    if (ctx->mac_pos)
+    {
+        aes_ttable_encrypt(&ctx->key, ctx->x_blk, ctx->x_blk);
+        ctx->mac_pos = 0;
+    }
 }
 
 /**
  ****************************************************************************************
- * @brief Allocate data blocks
- * @param[out] dest             pointer to store allocated blocks
- * @param[in] old_blk_count     current number of blocks
- * @param[in] new_blk_count     new number of blocks
+ * @brief Xor data with the CTR key stream
+ * @details A new S block is generated from the next counter block when the current one
+ * is used up.
+ * @param[in,out] ctx   Context
+ * @param[in] in        Input data
+ * @param[out] out      Output data, may be equal to in
+ * @param[in] len       Length in bytes
  ****************************************************************************************
  */
-static void blk_malloc(uint8_t (**dest)[CCM_BLK_SIZE], uint8_t old_blk_count,
-                       uint8_t new_blk_count)
+static void ccm_ctr_xor(struct aes_ccm_ctx *ctx, const uint8_t *in, uint8_t *out, uint32_t len)
 {
-    // Free old buffer if larger one is needed
-    if (*dest != NULL)
+    while (len--)
     {
-        if (old_blk_count < new_blk_count)
+        if (ctx->ctr_pos == CCM_BLK_SIZE)
         {
-            ke_free(*dest);
-            *dest = ke_malloc(new_blk_count * CCM_BLK_SIZE, blk_mem_type);
+            // Increment the Q bytes counter field (BE order)
+            for (int8_t i = CCM_BLK_SIZE - 1; i > ctx->n; i--)
+            {
+                if (++ctx->a_blk[i])
+                {
+                    break;
+                }
+            }
+
+            aes_ttable_encrypt(&ctx->key, ctx->a_blk, ctx->s_blk);
+            ctx->ctr_pos = 0;
         }
-    }
-    else
-    {
-        *dest = ke_malloc(new_blk_count * CCM_BLK_SIZE, blk_mem_type);
-    }
 
-    memset(*dest, 0, new_blk_count * CCM_BLK_SIZE);
+        *out++ = *in++ ^ ctx->s_blk[ctx->ctr_pos++];
+    }
 }
 
-/**
- ****************************************************************************************
- * @brief Format associated data block
- * @param[in] blk           Predefined AES_CCM structure,
- * @param[in] adata         Associated data,
- * @param[in] adata_len     Associated data length.
+/*
+ * PUBLIC FUNCTION DEFINITIONS
  ****************************************************************************************
  */
-__STATIC_INLINE void aes_format_ccm_adata(struct aes_ccm_env_tag *blk, const uint8_t *adata,
-                                        const uint16_t adata_len)
-{
-    union Alen_encoding *alenc;
-    uint8_t enclen;
-
-    // Length for adata length encoding
-    // [Sec. A.2.2 in NIST_SP_800-38C]
-    enclen = adata_len < 65280 ? 2 : adata_len < 4294967296 ? 6 : 10;
-
-    // Encode the Adata length
-    // [Sec. A.2.2 in NIST_SP_800-38C]
-    switch (enclen) {
-    case 2:
-        blk_malloc(&(blk->adata_blk), blk->adata_blk_cnt,
-                   aes_get_blk_num(adata_len + enclen));
-        alenc = (union Alen_encoding *) blk->adata_blk;
-
-        // Encoding in 2 bytes
-        memcpy(&(alenc->alen2.data[0]), (uint8_t *) &adata_len + 1, 1);
-        memcpy(&(alenc->alen2.data[1]), &adata_len, 1);
-        break;
-
-    case 6:
-        ASSERT_ERROR(0);
-        break;
-
-    case 10:
-        ASSERT_ERROR(0);
-        break;
-
-#if 0 // left for reference only - we support up to 255 blocks -> 4080 bytes
-    case 6:
-        blk_malloc(&(blk->adata_blk), blk->adata_blk_cnt,
-                   aes_get_blk_num(adata_len + enclen));
-        alenc = (union Alen_encoding *) blk->adata_blk;
-
-        // 2 Magic bytes
-        SetWord8(&(alenc->alen6.magic[0]), 0xff);
-        SetWord8(&(alenc->alen6.magic[1]), 0xfe);
-
-        // Encoding in 4 bytes
-        memcpy(&(alenc->alen6.data[0]), (uint8_t *) &adata_len + 3, 1);
-        memcpy(&(alenc->alen6.data[1]), (uint8_t *) &adata_len + 2, 1);
-        memcpy(&(alenc->alen6.data[2]), (uint8_t *) &adata_len + 1, 1);
-        memcpy(&(alenc->alen6.data[3]), &adata_len, 1);
-        break;
-
-    case 10:
-        blk_malloc(&(blk->adata_blk), blk->adata_blk_cnt,
-                   aes_get_blk_num(adata_len + enclen));
-        alenc = (union Alen_encoding *) blk->adata_blk;
-
-        // 2 Magic bytes
-        SetWord8(&(alenc->alen10.magic[0]), 0xff);
-        SetWord8(&(alenc->alen10.magic[1]), 0xff);
-
-        // Encoding in 8 bytes
-        memcpy(&(alenc->alen10.data[0]), (uint8_t *) &adata_len + 7, 1);
-        memcpy(&(alenc->alen10.data[1]), (uint8_t *) &adata_len + 6, 1);
-        memcpy(&(alenc->alen10.data[2]), (uint8_t *) &adata_len + 5, 1);
-        memcpy(&(alenc->alen10.data[3]), (uint8_t *) &adata_len + 4, 1);
-        memcpy(&(alenc->alen10.data[4]), (uint8_t *) &adata_len + 3, 1);
-        memcpy(&(alenc->alen10.data[5]), (uint8_t *) &adata_len + 2, 1);
-        memcpy(&(alenc->alen10.data[6]), (uint8_t *) &adata_len + 1, 1);
-        memcpy(&(alenc->alen10.data[7]), &adata_len, 1);
-        break;
-#endif
-    }
 
-    // Concatenate Adata
-    memcpy(((uint8_t*) blk->adata_blk) + enclen, adata, adata_len);
+void aes_ccm_ctx_init(struct aes_ccm_ctx *ctx, const uint8_t *key, uint8_t T, uint8_t N)
+{
+    ASSERT_ERROR((T >= AES_CCM_T4) && (T <= AES_CCM_T16) && !(T & 1));
+    ASSERT_ERROR((N >= AES_CCM_N7) && (N <= AES_CCM_N13));
 
-    // Update data length and block count
-    blk->adata_len = adata_len + enclen;
-    blk->adata_blk_cnt = aes_get_blk_num(blk->adata_len);
+    memset(ctx, 0, sizeof(*ctx));
+    aes_ttable_set_key(&ctx->key, key);
+    ctx->t = T;
+    ctx->n = N;
 }
 
-/**
- *****************************************************************************************
- * @brief Set up AES CCM operation parameters
- * @param[in] blk           Predefined AES_CCM structure
- * @param[in] payload       Data to be encrypted/decrypted
- * @param[in] payload_len   payload length in bytes,up to 32
- * @param[in] Nonce         Nonce array, should be unique for each AES-CCM operation
- * @param[in] Adata         Adata, or header, up to 32 bytes
- * @param[in] Adata_len     Adata length in bytes, up to 32
- * @param[in] type          choose ENCRYPT_PROCESS or DECRYPT_PROCESS
- ****************************************************************************************
- */
-static void aes_set_ccm_param(struct aes_ccm_env_tag *blk, uint8_t *payload,
-                              uint16_t payload_len, uint8_t *Nonce, uint8_t *Adata,
-                              uint16_t Adata_len, uint8_t type)
+void aes_ccm_start(struct aes_ccm_ctx *ctx, const uint8_t *nonce, uint16_t adata_len,
+                   uint32_t payload_len)
 {
-    // Set payload and nonce const pointers
-    blk->payload_input = payload;
-    blk->Nonce = Nonce;
+    uint8_t q = 15 - ctx->n;
 
-    if (Adata)
-    {
-        aes_format_ccm_adata(blk, Adata, Adata_len);
-    }
+    // Check if there is enough space for all significant bytes of the payload length
+    ASSERT_ERROR((q >= 4) || !(payload_len >> (q * 8)));
+    // Only the 2 bytes encoding of the Adata length is supported
+    ASSERT_ERROR(adata_len < CCM_ADATA_LEN2_MAX);
 
-    if (type == ENCRYPT_PROCESS)
+    // Generate B0 block with flags, nonce and payload length, straight into the X block
+    // [Sec. A.2.1 in NIST_SP_800-38C]
+    memset(ctx->x_blk, 0, CCM_BLK_SIZE);
+    if (adata_len)
     {
-        blk->payload_len = payload_len;
-        blk->payload_blk_cnt = aes_get_blk_num(payload_len);
+        CCM_FLAG_SET(ctx->x_blk[0], CCM_FLAG_ADATA, 1);
     }
-    else
+    CCM_FLAG_SET(ctx->x_blk[0], CCM_FLAG_T, ((ctx->t - 2) / 2));
+    CCM_FLAG_SET(ctx->x_blk[0], CCM_FLAG_Q, (q - 1));
+    memcpy(&ctx->x_blk[1], nonce, ctx->n);
+    for (uint8_t i = 0; (i < q) && (i < 4); i++)
     {
-        blk->payload_len = payload_len - CCM_T;
-        blk->payload_blk_cnt = aes_get_blk_num(blk->payload_len);
+        ctx->x_blk[CCM_BLK_SIZE - 1 - i] = (uint8_t) (payload_len >> (i * 8));
     }
-}
+    aes_ttable_encrypt(&ctx->key, ctx->x_blk, ctx->x_blk);
+    ctx->mac_pos = 0;
 
-/**
- ****************************************************************************************
- * @brief Format payload length in Q number of bytes
- * @param[out] dest         Destination buffer,
- * @param[in] source        Payload length,
- * @param[in] bytecount     Number of bytes to encode the payload length.
- ****************************************************************************************
- */
-static void aes_format_qfield(uint8_t *dest, const uint8_t *source, uint8_t bytecount)
-{
-    // Set padding bytes to 0
-    memset(dest, 0, CCM_Q - bytecount);
+    // Generate A0 block with flags, nonce and zero counter
+    // [Sec. A.3 in NIST_SP_800-38C]
+    memset(ctx->a_blk, 0, CCM_BLK_SIZE);
+    CCM_FLAG_SET(ctx->a_blk[0], CTR_FLAG_Q, (q - 1));
+    memcpy(&ctx->a_blk[1], nonce, ctx->n);
 
-    while (bytecount)
-    {
-        // Reverse byte order
-        memcpy(dest + CCM_Q - bytecount, source + bytecount - 1, 1);
-        bytecount--;
-    }
-}
+    // S0 encrypts the tag, payload starts with counter 1
+    aes_ttable_encrypt(&ctx->key, ctx->a_blk, ctx->s0_blk);
+    ctx->ctr_pos = CCM_BLK_SIZE;
 
-/**
- ****************************************************************************************
- * @brief Generate first B block with flags and formatting info.
- * @param[in,out] blk   Predefined AES_CCM structure
- ****************************************************************************************
- */
-static void aes_gen_ccm_bblk0(struct aes_ccm_env_tag *blk)
-{
-    uint8_t bytecount = 0;
+    ctx->adata_left = adata_len;
+    ctx->payload_left = payload_len;
 
-    // Get minimum number of octets to encode blk->payload_len
-    while (blk->payload_len >> (bytecount * 8))
+    // Encode the Adata length in 2 bytes [Sec. A.2.2 in NIST_SP_800-38C]
+    if (adata_len)
     {
-        bytecount++;
-    }
+        uint8_t alen[2] = { (uint8_t) (adata_len >> 8), (uint8_t) adata_len };
 
-    // Check if there is enough space for all significant bytes
-    ASSERT_ERROR(CCM_Q >= bytecount);
-
-    // Set flags [according to Sec. A.2.1 in NIST_SP_800-38C]
-    if (blk->adata_len)
-    {
-        CCM_FLAG_SET(blk->b_blk[0][0], CCM_FLAG_ADATA, 1);
+        ccm_mac_update(ctx, alen, sizeof(alen));
     }
-
-    CCM_FLAG_SET(blk->b_blk[0][0], CCM_FLAG_T, (CCM_T - 2) / 2);
-    CCM_FLAG_SET(blk->b_blk[0][0], CCM_FLAG_Q, CCM_Q - 1);
-    CCM_FLAG_SET(blk->b_blk[0][0], CCM_FLAG_RES, 0);
-
-    // Put Nounce after the flags
-    memcpy(&blk->b_blk[0][1], blk->Nonce, CCM_N);
-
-    // Encode payload length in CCM_Q bytes after the nonce (BE order)
-    aes_format_qfield(&blk->b_blk[0][1] + CCM_N,
-                      (const uint8_t *) &blk->payload_len, bytecount);
 }
 
-/**
- ****************************************************************************************
- * @brief Generate B block for AES CCM operation
- * @details Prepares all B blocks for the CBC-MAC pass
- * @param[in,out] blk   Predefined AES_CCM structure
- * @param[in] type      choose ENCRYPT_PROCESS or DECRYPT_PROCESS
- ****************************************************************************************
- */
-static void aes_gen_ccm_bblk(struct aes_ccm_env_tag *blk, uint8_t type)
+void aes_ccm_adata(struct aes_ccm_ctx *ctx, const uint8_t *adata, uint16_t len)
 {
-    uint8_t blk_cnt = 1 + (blk->adata_blk_cnt) + (blk->payload_blk_cnt);
-    uint8_t* s;
-
-    // Allocate blocks for formatted data and the CBC-MAC results
-    blk_malloc(&(blk->b_blk), blk->b_blk_cnt, blk_cnt);
-    blk_malloc(&(blk->x_blk), blk->b_blk_cnt, blk_cnt);
-    blk->b_blk_cnt = blk_cnt;
+    ASSERT_ERROR(len <= ctx->adata_left);
 
-    // Put flags, Nounce and payload length into the very first block
-    aes_gen_ccm_bblk0(blk);
+    ccm_mac_update(ctx, adata, len);
+    ctx->adata_left -= len;
 
-    // Put Associated Data in consecutive blocks. Additionally append
-    // it's encoded length [according to Sec. A.2.2 in NIST_SP_800-38C].
-    if (blk->adata_len)
+    // Adata is padded to a block boundary before the payload
+    if (!ctx->adata_left)
     {
-        // Adata length should already be encoded by Aes_Set_Ccm_Param(...)
-        s = blk->b_blk[1];
-        memcpy(s, blk->adata_blk, blk->adata_len);
-    }
-
-    // Put Input Payload in consecutive blocks
-    if (type == ENCRYPT_PROCESS)
-    {
-        s = blk->b_blk[1 + blk->adata_blk_cnt];
-        memcpy(s, blk->payload_input, blk->payload_len);
+        ccm_mac_pad(ctx);
     }
 }
 
-/**
- ****************************************************************************************
- * @brief Generate A block for AES CCM operation
- * @details Prepares all A blocks for the CTR pass
- * @param[in,out] blk   Predefined AES_CCM structure
- ****************************************************************************************
- */
-static void aes_gen_ccm_ablk(struct aes_ccm_env_tag *blk)
+void aes_ccm_encrypt_update(struct aes_ccm_ctx *ctx, const uint8_t *in, uint8_t *out,
+                            uint32_t len)
 {
-    uint8_t bytecount = 0;
-
-    // Allocate blocks for counter formatted data and the CTR results
-    blk_malloc(&(blk->a_blk), blk->a_blk_cnt, blk->b_blk_cnt);
-    blk_malloc(&(blk->s_blk), blk->a_blk_cnt, blk->b_blk_cnt);
-    blk->a_blk_cnt = blk->b_blk_cnt;
-
-    // Get minimum number of octets to encode counter for for A blocks
-    while (blk->a_blk_cnt >> (bytecount * 8))
-    {
-        bytecount++;
-    }
+    ASSERT_ERROR(!ctx->adata_left && (len <= ctx->payload_left));
 
-    // Check if there is enough space for all significant bytes
-    ASSERT_ERROR(CCM_Q >= bytecount);
-
-    for (int i = 0; i < blk->a_blk_cnt; i++)
-    {
-        // Set flags [according to Sec. A.3 in NIST_SP_800-38C]
-        CCM_FLAG_SET(blk->a_blk[i][0], CTR_FLAG_Q, CCM_Q - 1);
-        CCM_FLAG_SET(blk->a_blk[i][0], CTR_FLAG_ZERO, 0);
-        CCM_FLAG_SET(blk->a_blk[i][0], CTR_FLAG_RES1, 0);
-        CCM_FLAG_SET(blk->a_blk[i][0], CTR_FLAG_RES2, 0);
-
-        // Put Nounce after the flags
-        memcpy(&blk->a_blk[i][1], blk->Nonce, CCM_N);
-
-        // Put counter after nonce
-        aes_format_qfield(&blk->a_blk[i][1] + CCM_N,
-                          (const uint8_t *) &i, bytecount);
-    }
+    ccm_mac_update(ctx, in, len);
+    ccm_ctr_xor(ctx, in, out, len);
+    ctx->payload_left -= len;
 }
 
-/**
- ****************************************************************************************
- * @brief Generate S block for AES CCM operation
- * @details Calculates S blocks in CTR mode
- * @param[in,out] blk   Predefined AES_CCM structure
- ****************************************************************************************
- */
-static void aes_gen_ccm_sblk(struct aes_ccm_env_tag *blk)
+void aes_ccm_decrypt_update(struct aes_ccm_ctx *ctx, const uint8_t *in, uint8_t *out,
+                            uint32_t len)
 {
-    for (int i = 0; i < blk->a_blk_cnt; i++)
-    {
-        aes_encrypt(blk->a_blk[i], blk->s_blk[i], CCM_BLK_SIZE);
-    }
-}
+    ASSERT_ERROR(!ctx->adata_left && (len <= ctx->payload_left));
 
-/**
- ****************************************************************************************
- * @brief Generate X block for AES CCM operation
- * @details Calculates tag in CBC-MAC mode (fills the X block)
- * @param[in,out] blk   Predefined AES_CCM structure
- ****************************************************************************************
- */
-__STATIC_INLINE void aes_gen_ccm_xblk(struct aes_ccm_env_tag *blk)
-{
-    aes_cbc_encrypt(blk->b_blk[0], blk->b_blk_cnt,      // Input
-                    blk->x_blk[0], blk->b_blk_cnt,      // Output
-                    key_aes, sizeof(key_aes), NULL);    // Key, IV=0
+    ccm_ctr_xor(ctx, in, out, len);
+    ccm_mac_update(ctx, out, len);
+    ctx->payload_left -= len;
 }
 
-/**
- ****************************************************************************************
- * @brief Generate Output Array for AES CCM operation
- * @details Combines CBC-MAC with the CTR results into the final cyphertext
- * @param[in,out] blk       Predefined AES_CCM structure
- * @param[out] output       where output array to be placed
- ****************************************************************************************
- */
-static void aes_gen_ccm_output(struct aes_ccm_env_tag *blk, uint8_t *output)
+void aes_ccm_get_tag(struct aes_ccm_ctx *ctx, uint8_t *tag)
 {
-    uint8_t index = blk->b_blk_cnt - 1;
-    uint8_t payload_index = blk->adata_blk_cnt + 1;
+    ASSERT_ERROR(!ctx->adata_left && !ctx->payload_left);
 
-    aes_array_xor(blk->x_blk[index], blk->s_blk[0], CCM_T, output + blk->payload_len);
-    aes_array_xor(blk->b_blk[payload_index], blk->s_blk[1], blk->payload_len, output);
+    ccm_mac_pad(ctx);
+    aes_array_xor(ctx->x_blk, ctx->s0_blk, ctx->t, tag);
 }
 
-/**
- ****************************************************************************************
- * @brief Check if decrypted data match up with the authenticate data and provide the result
- * @param[in,out] blk       Predefined AES_CCM structure
- * @param[out] output       Decrypted data
- * @return                  0 if auth data matches up. 1 if something goes wrong
- ****************************************************************************************
- */
-static uint8_t aes_check_ccm_payload(struct aes_ccm_env_tag *blk, uint8_t *output)
+uint8_t aes_ccm_check_tag(struct aes_ccm_ctx *ctx, const uint8_t *tag)
 {
-    uint8_t index = blk->b_blk_cnt - 1;
-    uint8_t payload_index = blk->adata_blk_cnt + 1;
-    uint8_t *temp_mic = ke_malloc(CCM_T, KE_MEM_NON_RETENTION);
-    uint8_t ret = 1;
-
-    memset(temp_mic, 0, CCM_T);
+    uint8_t temp_mic[CCM_BLK_SIZE];
+    uint8_t diff = 0;
 
-    aes_array_xor(blk->payload_input, blk->s_blk[1], blk->payload_len,
-              blk->b_blk[payload_index]);
-    aes_gen_ccm_xblk(blk);
-    aes_array_xor(blk->x_blk[index], blk->s_blk[0], CCM_T, temp_mic);
+    aes_ccm_get_tag(ctx, temp_mic);
 
-    if (!memcmp(blk->payload_input + blk->payload_len, temp_mic, CCM_T))
+    // Go through the whole tag, the time taken must not reveal the first wrong byte
+    for (uint8_t i = 0; i < ctx->t; i++)
     {
-        memcpy(output, blk->b_blk[payload_index], blk->payload_len);
-        ret = 0;
+        diff |= temp_mic[i] ^ tag[i];
     }
 
-    ke_free(temp_mic);
-    return ret;
+    return diff ? 1 : 0;
 }
 
-/*
- * PUBLIC FUNCTION DEFINITIONS
- ****************************************************************************************
- */
-
 void aes_ccm_init(uint8_t *key, uint8_t T, uint8_t N, uint8_t ke_mem_type)
 {
-    struct aes_ccm_env_tag *blk = &AES128_ccm_blk;
-
-    aes_key_init(key);
-
-    blk_mem_type = ke_mem_type;
+    memcpy(key_aes, key, sizeof(key_aes));
 
     CCM_T = T;      // Length of Auth Bytes (TAG/MAC), options are 4,6,8,10,12,14 and 16
     CCM_Q = 15 - N; // Length of the encoded Plain Text length field, options are 2~8
     CCM_N = N;      // The nonce length
-
-    blk->adata_blk = 0;
-    blk->adata_len = 0;
-    blk->adata_blk_cnt = 0;
-    blk->b_blk = 0;
-    blk->b_blk_cnt = 0;
-    blk->x_blk = 0;
-    blk->a_blk = 0;
-    blk->a_blk_cnt = 0;
-    blk->s_blk = 0;
 }
 
 void aes_ccm_cleanup(void)
 {
-    struct aes_ccm_env_tag *blk = &AES128_ccm_blk;
-
-    if (blk->adata_blk)
-    {
-        ke_free(blk->adata_blk);
-        blk->adata_blk = 0;
-        blk->adata_len = 0;
-        blk->adata_blk_cnt = 0;
-    }
-
-    if (blk->b_blk)
-    {
-        ke_free(blk->b_blk);
-        blk->b_blk = 0;
-        blk->b_blk_cnt = 0;
-    }
-
-    if (blk->x_blk)
-    {
-        ke_free(blk->x_blk);
-        blk->x_blk = 0;
-    }
-
-    if (blk->a_blk)
-    {
-        ke_free(blk->a_blk);
-        blk->a_blk = 0;
-        blk->a_blk_cnt = 0;
-    }
-
-    if (blk->s_blk)
-    {
-        ke_free(blk->s_blk);
-        blk->s_blk = 0;
-    }
+    // Do not leave the expanded key behind
+    memset(&ccm_ctx, 0, sizeof(ccm_ctx));
 }
 
 void aes_ccm_encrypt(uint8_t *payload, uint16_t payload_len, uint8_t *Nonce,
                      uint8_t *Adata, uint16_t Adata_len, uint8_t *output)
 {
-    struct aes_ccm_env_tag *blk = &AES128_ccm_blk;
+    struct aes_ccm_ctx *ctx = &ccm_ctx;
 
-    aes_set_ccm_param(blk, payload, payload_len, Nonce, Adata, Adata_len, ENCRYPT_PROCESS);
-    aes_gen_ccm_bblk(blk, ENCRYPT_PROCESS);
+    if (!Adata)
+    {
+        Adata_len = 0;
+    }
 
-    aes_gen_ccm_ablk(blk);
-    aes_gen_ccm_sblk(blk);
-    aes_gen_ccm_xblk(blk);
-    aes_gen_ccm_output(blk, output);
+    aes_ccm_ctx_init(ctx, key_aes, CCM_T, CCM_N);
+    aes_ccm_start(ctx, Nonce, Adata_len, payload_len);
+    aes_ccm_adata(ctx, Adata, Adata_len);
+    aes_ccm_encrypt_update(ctx, payload, output, payload_len);
+    aes_ccm_get_tag(ctx, output + payload_len);
 }
 
 uint8_t aes_ccm_decrypt(uint8_t *payload, uint16_t payload_len, uint8_t *Nonce,
                         uint8_t *Adata, uint16_t Adata_len, uint8_t *output)
 {
-    struct aes_ccm_env_tag *blk = &AES128_ccm_blk;
+    struct aes_ccm_ctx *ctx = &ccm_ctx;
+    uint16_t plain_len = payload_len - CCM_T;
 
-    aes_set_ccm_param(blk, payload, payload_len, Nonce, Adata, Adata_len, DECRYPT_PROCESS);
-    aes_gen_ccm_bblk(blk, DECRYPT_PROCESS);
+    if (!Adata)
+    {
+        Adata_len = 0;
+    }
 
-    aes_gen_ccm_ablk(blk);
-    aes_gen_ccm_sblk(blk);
+    aes_ccm_ctx_init(ctx, key_aes, CCM_T, CCM_N);
+    aes_ccm_start(ctx, Nonce, Adata_len, plain_len);
+    aes_ccm_adata(ctx, Adata, Adata_len);
+    aes_ccm_decrypt_update(ctx, payload, output, plain_len);
+
+    if (aes_ccm_check_tag(ctx, payload + plain_len))
+    {
+        // Do not release unauthenticated plain text
+        memset(output, 0, plain_len);
+        return 1;
+    }
 
-    return aes_check_ccm_payload(blk, output);
+    return 0;
 }
 /// @} aes_ccm
@@ -22,6 +22,14 @@
 #ifndef AES_CCM_H_
 #define AES_CCM_H_
 
+/*
+ * INCLUDE FILES
+ ****************************************************************************************
+ */
+
+#include <stdint.h>
+#include "aes_ttable.h"
+
 /*
  * DEFINES
  ****************************************************************************************
@@ -76,40 +84,31 @@ enum {
  ****************************************************************************************
  */
 
-
-/// AES_CCM environment structure
-struct aes_ccm_env_tag
+/// AES-CCM streaming context, no heap allocations are used
+struct aes_ccm_ctx
 {
-    /// Nonce array
-    const uint8_t *Nonce;
-
-    /// Payload length
-    uint16_t payload_len;
-    /// Number of payload blocks
-    uint8_t payload_blk_cnt;
-    /// Payload input
-    const uint8_t *payload_input;
-
-    /// Adata block length
-    uint16_t adata_len;
-    /// Number of adata blocks
-    uint8_t adata_blk_cnt;
-    /// Adata array
-    uint8_t (*adata_blk)[CCM_BLK_SIZE];
-
-    /// CBC-MAC blocks
-    uint8_t b_blk_cnt;
-    /// B block array
-    uint8_t (*b_blk)[CCM_BLK_SIZE];
-    /// X block array
-    uint8_t (*x_blk)[CCM_BLK_SIZE];
-
-    /// CTR blocks
-    uint32_t a_blk_cnt;
-    /// A block array
-    uint8_t (*a_blk)[CCM_BLK_SIZE];
-    /// S block array
-    uint8_t (*s_blk)[CCM_BLK_SIZE];
+    /// Expanded key
+    struct aes_ttable_key key;
+    /// CBC-MAC chaining value (X block)
+    uint8_t x_blk[CCM_BLK_SIZE];
+    /// Counter block (A block)
+    uint8_t a_blk[CCM_BLK_SIZE];
+    /// Key stream of the current counter block (S block)
+    uint8_t s_blk[CCM_BLK_SIZE];
+    /// First key stream block (S0), encrypts the tag
+    uint8_t s0_blk[CCM_BLK_SIZE];
+    /// Tag length (T)
+    uint8_t t;
+    /// Nonce length (N)
+    uint8_t n;
+    /// Bytes of the current CBC-MAC block already absorbed into x_blk
+    uint8_t mac_pos;
+    /// Bytes of s_blk already used
+    uint8_t ctr_pos;
+    /// Associated data bytes still expected
+    uint16_t adata_left;
+    /// Payload bytes still expected
+    uint32_t payload_left;
 };
 
 /*
@@ -121,10 +120,10 @@ struct aes_ccm_env_tag
  ****************************************************************************************
  * @brief AES CCM encryption
  * @param[in] payload      Data to be encrypted/decrypted
- * @param[in] payload_len  payload length in bytes, up to 32
+ * @param[in] payload_len  payload length in bytes
  * @param[in] Nonce        Nonce array, should be unique for each AES-CCM operation
- * @param[in] Adata        Adata, or header, up to 32 bytes
- * @param[in] Adata_len    Adata length in bytes, up to 32
+ * @param[in] Adata        Adata, or header
+ * @param[in] Adata_len    Adata length in bytes, less than 65280
  * @param[out] output      where encrypted cipher to be placed. Header is not included
  ****************************************************************************************
  */
@@ -135,10 +134,10 @@ void aes_ccm_encrypt(uint8_t *payload, uint16_t payload_len, uint8_t *Nonce,
  ****************************************************************************************
  * @brief AES CCM decryption
  * @param[in] payload      Data to be encrypted/decrypted
- * @param[in] payload_len  payload length in bytes, up to 32
+ * @param[in] payload_len  payload length in bytes
  * @param[in] Nonce        Nonce array, should be unique for each AES-CCM operation
- * @param[in] Adata        Adata, or header, up to 32 bytes
- * @param[in] Adata_len    Adata length in bytes, up to 32
+ * @param[in] Adata        Adata, or header
+ * @param[in] Adata_len    Adata length in bytes, less than 65280
  * @param[out] output      where encrypted cipher to be placed. Header is not included
  * @return    0 if auth data matches up. 1 if something goes wrong
  ****************************************************************************************
@@ -149,6 +148,7 @@ uint8_t aes_ccm_decrypt(uint8_t *payload, uint16_t payload_len, uint8_t *Nonce,
 /**
  ****************************************************************************************
  * @brief Set AES key and memory pool type
+ * @note No memory is allocated, the memory pool type is ignored.
  * @param[in] key           key to be used, should be 16 bytes
  * @param[in] T             Tag length
  * @param[in] N             Nonce length
@@ -164,6 +164,88 @@ void aes_ccm_init(uint8_t *key, uint8_t T, uint8_t N, uint8_t ke_mem_type);
  */
 void aes_ccm_cleanup(void);
 
+/**
+ ****************************************************************************************
+ * @brief Initialize AES-CCM streaming context
+ * @details The context can then be used for any number of messages with aes_ccm_start().
+ * @param[out] ctx          Context
+ * @param[in] key           Key, 16 bytes
+ * @param[in] T             Tag length, one of AES_CCM_T4 ... AES_CCM_T16
+ * @param[in] N             Nonce length, one of AES_CCM_N7 ... AES_CCM_N13
+ ****************************************************************************************
+ */
+void aes_ccm_ctx_init(struct aes_ccm_ctx *ctx, const uint8_t *key, uint8_t T, uint8_t N);
+
+/**
+ ****************************************************************************************
+ * @brief Start AES-CCM processing of a message
+ * @details The associated data must then be passed with aes_ccm_adata() and the payload with
+ * aes_ccm_encrypt_update() or aes_ccm_decrypt_update(), in pieces of any size, until the
+ * lengths given here are reached.
+ * @param[in,out] ctx       Context
+ * @param[in] nonce         Nonce, N bytes, should be unique for each message
+ * @param[in] adata_len     Associated data length in bytes, less than 65280
+ * @param[in] payload_len   Payload length in bytes, without the tag
+ ****************************************************************************************
+ */
+void aes_ccm_start(struct aes_ccm_ctx *ctx, const uint8_t *nonce, uint16_t adata_len,
+                   uint32_t payload_len);
+
+/**
+ ****************************************************************************************
+ * @brief Authenticate associated data
+ * @param[in,out] ctx       Context
+ * @param[in] adata         Associated data
+ * @param[in] len           Length in bytes
+ ****************************************************************************************
+ */
+void aes_ccm_adata(struct aes_ccm_ctx *ctx, const uint8_t *adata, uint16_t len);
+
+/**
+ ****************************************************************************************
+ * @brief Encrypt and authenticate payload
+ * @param[in,out] ctx       Context
+ * @param[in] in            Plain text
+ * @param[out] out          Cipher text, may be equal to in
+ * @param[in] len           Length in bytes
+ ****************************************************************************************
+ */
+void aes_ccm_encrypt_update(struct aes_ccm_ctx *ctx, const uint8_t *in, uint8_t *out,
+                            uint32_t len);
+
+/**
+ ****************************************************************************************
+ * @brief Decrypt and authenticate payload
+ * @param[in,out] ctx       Context
+ * @param[in] in            Cipher text
+ * @param[out] out          Plain text, may be equal to in. It must not be used before
+ *                          aes_ccm_check_tag() has succeeded.
+ * @param[in] len           Length in bytes
+ ****************************************************************************************
+ */
+void aes_ccm_decrypt_update(struct aes_ccm_ctx *ctx, const uint8_t *in, uint8_t *out,
+                            uint32_t len);
+
+/**
+ ****************************************************************************************
+ * @brief Finish encryption and get the tag
+ * @param[in,out] ctx       Context
+ * @param[out] tag          Tag, T bytes
+ ****************************************************************************************
+ */
+void aes_ccm_get_tag(struct aes_ccm_ctx *ctx, uint8_t *tag);
+
+/**
+ ****************************************************************************************
+ * @brief Finish decryption and check the tag
+ * @details The comparison takes the same time wherever the tags differ.
+ * @param[in,out] ctx       Context
+ * @param[in] tag           Received tag, T bytes
+ * @return                  0 if the tag matches, 1 otherwise
+ ****************************************************************************************
+ */
+uint8_t aes_ccm_check_tag(struct aes_ccm_ctx *ctx, const uint8_t *tag);
+
 #endif // AES_CCM_H_
 
 /// @}
@@ -22,6 +22,15 @@
 #ifndef AES_CMAC_H_
 #define AES_CMAC_H_
 
+/*
+ * INCLUDE FILES
+ ****************************************************************************************
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "aes_ttable.h"
+
 /*
  * DEFINES
  ****************************************************************************************
@@ -30,6 +39,24 @@
 /// Input block size (128 bits)
 #define AES_CMAC_BLK_SIZE_128 (16)
 
+/*
+ * STRUCTURES
+ ****************************************************************************************
+ */
+
+/// AES-CMAC streaming context
+struct aes_cmac_ctx
+{
+    /// Expanded key
+    struct aes_ttable_key key;
+    /// CBC chaining value
+    uint8_t x_blk[AES_CMAC_BLK_SIZE_128];
+    /// Last, not yet encrypted, message block
+    uint8_t m_blk[AES_CMAC_BLK_SIZE_128];
+    /// Bytes in m_blk
+    uint8_t m_len;
+};
+
 /*
  * PUBLIC FUNCTIONS DECLARATION
  ****************************************************************************************
@@ -63,6 +90,36 @@ uint8_t aes_cmac_generate(const uint8_t *payload, uint16_t payload_len,
 bool aes_cmac_verify(const uint8_t *payload, uint16_t payload_len,
                      const uint8_t *key, const uint8_t *mac, uint8_t mac_len);
 
+/**
+ ****************************************************************************************
+ * @brief Start AES-CMAC calculation
+ * @param[out] ctx              Context
+ * @param[in] key               Key (128bit)
+ ****************************************************************************************
+ */
+void aes_cmac_start(struct aes_cmac_ctx *ctx, const uint8_t *key);
+
+/**
+ ****************************************************************************************
+ * @brief Add message data to AES-CMAC calculation
+ * @details The message can be passed in pieces of any size.
+ * @param[in,out] ctx           Context
+ * @param[in] data              Message data
+ * @param[in] len               Length (in bytes)
+ ****************************************************************************************
+ */
+void aes_cmac_update(struct aes_cmac_ctx *ctx, const uint8_t *data, uint32_t len);
+
+/**
+ ****************************************************************************************
+ * @brief Finish AES-CMAC calculation
+ * @param[in,out] ctx           Context
+ * @param[out] mac              MAC output buffer
+ * @param[in] mac_len           MAC buffer length (in bytes), up to 16
+ ****************************************************************************************
+ */
+void aes_cmac_finish(struct aes_cmac_ctx *ctx, uint8_t *mac, uint8_t mac_len);
+
 #endif // AES_CMAC_H_
 
 /// @}
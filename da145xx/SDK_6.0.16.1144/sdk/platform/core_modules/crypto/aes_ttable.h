@@ -0,0 +1,95 @@
+/**
+ ****************************************************************************************
+ * @addtogroup Core_Modules
+ * @{
+ * @addtogroup Crypto
+ * @{
+ * @addtogroup AES_TTABLE AES T-table
+ * @brief Word oriented software AES-128 encryption.
+ * @{
+ *
+ * @file aes_ttable.h
+ *
+ * @brief Word oriented software AES-128 block encryption header file.
+ *
+ * The cipher processes the state as four 32-bit columns and combines SubBytes, ShiftRows and
+ * MixColumns in a single 1 KB lookup table used with rotations, so a round costs 16 table
+ * lookups and 16 XORs. Only the forward cipher is provided, which is all that CTR, CCM and
+ * CMAC modes need. The key is expanded once and can then be used for any number of blocks.
+ *
+ * The table lookups depend on secret data. The Cortex-M0 has no data cache and SysRAM/ROM
+ * access time does not depend on the address, so the execution time does not depend on the
+ * key or the data on DA14585/586/531.
+ *
+ * Copyright (C) 2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ ****************************************************************************************
+ */
+
+#ifndef AES_TTABLE_H_
+#define AES_TTABLE_H_
+
+/*
+ * INCLUDE FILES
+ ****************************************************************************************
+ */
+
+#include <stdint.h>
+
+/*
+ * DEFINES
+ ****************************************************************************************
+ */
+
+/// Block size (128 bits)
+#define AES_TTABLE_BLK_SIZE     (16)
+
+/// Key size (128 bits)
+#define AES_TTABLE_KEY_SIZE     (16)
+
+/// Number of rounds of AES-128
+#define AES_TTABLE_ROUNDS       (10)
+
+/*
+ * STRUCTURES
+ ****************************************************************************************
+ */
+
+/// Expanded AES-128 key
+struct aes_ttable_key
+{
+    /// Round keys, big endian columns
+    uint32_t rk[4 * (AES_TTABLE_ROUNDS + 1)];
+};
+
+/*
+ * PUBLIC FUNCTIONS DECLARATION
+ ****************************************************************************************
+ */
+
+/**
+ ****************************************************************************************
+ * @brief Expand AES-128 key
+ * @param[out] key          Expanded key
+ * @param[in] user_key      Key, 16 bytes
+ ****************************************************************************************
+ */
+void aes_ttable_set_key(struct aes_ttable_key *key, const uint8_t *user_key);
+
+/**
+ ****************************************************************************************
+ * @brief Encrypt a single block
+ * @param[in] key           Expanded key
+ * @param[in] in            Input block, 16 bytes, any alignment
+ * @param[out] out          Output block, 16 bytes, any alignment, may be equal to in
+ ****************************************************************************************
+ */
+void aes_ttable_encrypt(const struct aes_ttable_key *key, const uint8_t *in, uint8_t *out);
+
+#endif // AES_TTABLE_H_
+
+/// @}
+/// @}
+/// @}
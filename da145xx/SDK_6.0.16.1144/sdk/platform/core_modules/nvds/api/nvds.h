@@ -19,6 +19,17 @@
  *       if not set, only GET action on TAGs is provided.
  *       if set, PUT/DEL/LOCK actions are provided in addition of GET action.
  *
+ *   The TAGs are looked up in a table generated from the TAG list of nvds.c. There is one
+ *   project option:
+ *     + CFG_NVDS_LOG :
+ *       if not set, the TAGs have the values of the CFG_NVDS_TAG_xxx options and PUT/DEL fail.
+ *       if set, the Bluetooth address and Channel Assessment TAGs can be PUT and DELeted.
+ *       The new values are kept in retention memory and written to a log in the SPI flash
+ *       (CFG_NVDS_LOG_OFFSET, CFG_NVDS_LOG_SECTORS sectors) by nvds_flush(), all at once.
+ *       The log is read when the NVDS is initialized. When a sector is full, the current
+ *       values are copied to the next one; the sectors are used in turn, so they wear evenly.
+ *       The SPI flash must have been set up by periph_init().
+ *
  * @{
  *
  * @file nvds.h
@@ -62,6 +73,17 @@ typedef uint8_t nvds_tag_len_t;
 typedef uint16_t nvds_tag_len_t;
 #endif // NVDS_8BIT_TAGLENGTH
 
+#if defined (CFG_NVDS_LOG)
+/// Offset of the NVDS log in the SPI flash, aligned to a sector
+#ifndef CFG_NVDS_LOG_OFFSET
+#define CFG_NVDS_LOG_OFFSET      (0x1C000)
+#endif
+
+/// Number of SPI flash sectors the NVDS log uses in turn, at least 2
+#ifndef CFG_NVDS_LOG_SECTORS
+#define CFG_NVDS_LOG_SECTORS     (2)
+#endif
+#endif // CFG_NVDS_LOG
 
 /*
  * ENUMERATION DEFINITIONS
@@ -357,6 +379,27 @@ uint8_t nvds_init(uint8_t *base, uint32_t len);
  */
 uint8_t nvds_get(uint8_t tag, nvds_tag_len_t * lengthPtr, uint8_t *buf);
 
+#if !defined (__DA14531__) || defined (__EXCLUDE_ROM_NVDS__)
+/**
+ ****************************************************************************************
+ * @brief Look for a specific tag and return, if found and matching (in length), a pointer
+ *        to the DATA part of the TAG instead of a copy.
+ *
+ * The data is constant, except for the TAGs changed by nvds_put() or nvds_del() when
+ * CFG_NVDS_LOG is defined: their data changes with the next call of these functions.
+ *
+ * @param[in]  tag          TAG to look for whose DATA is to be retrieved
+ * @param[in]  lengthPtr    Expected length of the TAG, set to the length of the TAG
+ * @param[out] data         Set to the DATA part of the TAG
+ *
+ * @return  NVDS_OK                  The TAG was found
+ *          NVDS_LENGTH_OUT_OF_RANGE The length passed in parameter is smaller than the TAG's
+ *          NVDS_FAIL                The TAG is not defined
+ ****************************************************************************************
+ */
+uint8_t nvds_get_ref(uint8_t tag, nvds_tag_len_t *lengthPtr, const uint8_t **data);
+#endif
+
 #if (NVDS_READ_WRITE == 1)
 
 /**
@@ -368,7 +411,10 @@ uint8_t nvds_get(uint8_t tag, nvds_tag_len_t * lengthPtr, uint8_t *buf);
  *
  * @param[in]  tag    TAG to mark as deleted
  *
- * @return NVDS_FAIL
+ * @return NVDS_OK                  TAG deleted, it has its default value again (CFG_NVDS_LOG)
+ *         NVDS_PARAM_LOCKED        TAG cannot be deleted (CFG_NVDS_LOG)
+ *         NVDS_TAG_NOT_DEFINED     TAG is not defined (CFG_NVDS_LOG)
+ *         NVDS_FAIL                Without CFG_NVDS_LOG
  ****************************************************************************************
  */
 uint8_t nvds_del(uint8_t tag);
@@ -410,13 +456,34 @@ uint8_t nvds_lock(uint8_t tag);
  * @param[in]  buf     Pointer to the buffer containing the DATA part of the TAG to add to
  *                     the NVDS
  *
+ * With CFG_NVDS_LOG, the TAG is only written to the SPI flash by nvds_flush().
+ *
  * @return NVDS_OK                  New TAG correctly written to the NVDS
  *         NVDS_PARAM_LOCKED        New TAG is trying to overwrite a TAG that is locked
  *         NO_SPACE_AVAILABLE       New TAG can not fit in the available space in the NVDS
+ *         NVDS_LENGTH_OUT_OF_RANGE Length is not the one of the TAG (CFG_NVDS_LOG)
+ *         NVDS_TAG_NOT_DEFINED     TAG is not defined (CFG_NVDS_LOG)
+ *         NVDS_FAIL                Without CFG_NVDS_LOG
  ****************************************************************************************
  */
 uint8_t nvds_put(uint8_t tag, nvds_tag_len_t length, uint8_t *buf);
 
+#if defined (CFG_NVDS_LOG)
+/**
+ ****************************************************************************************
+ * @brief Write the TAGs put or deleted since the last call to the log in the SPI flash.
+ *
+ * Meant to be called on application events where a flash write does not disturb the link
+ * (e.g. disconnection, before going to sleep). Takes a sector erase when the current sector
+ * of the log is full.
+ *
+ * @return NVDS_OK                  Nothing to write, or the TAGs were written
+ *         NVDS_FAIL                The flash write failed, the TAGs are kept for the next call
+ ****************************************************************************************
+ */
+uint8_t nvds_flush(void);
+#endif
+
 #endif //(NVDS_READ_WRITE == 1)
 
 #endif // _NVDS_H_
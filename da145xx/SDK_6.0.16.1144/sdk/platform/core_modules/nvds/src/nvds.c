@@ -31,6 +31,9 @@
 #include "co_bt.h"
 #include "co_utils.h"
 #include "rwip_config.h"
+#if defined (CFG_NVDS_LOG)
+#include "spi_flash.h"
+#endif
 
 /*
  * TYPE DEFINITIONS
@@ -73,154 +76,619 @@ static const struct nvds_data_struct nvds_data_storage =
 extern const uint8_t blank_otp_bdaddr[6];
 #endif
 
+#if !defined (__DA14531__) || defined (__EXCLUDE_ROM_NVDS__)
+
+/*
+ * TAG TABLE
+ ****************************************************************************************
+ */
+
+/// The tag can be changed with nvds_put() and nvds_del() (CFG_NVDS_LOG only)
+#define NVDS_TAG_WRITABLE       (0x01)
+/// nvds_get() fails if the length passed is smaller than the length of the tag
+#define NVDS_TAG_LEN_CHECK      (0x02)
+/// The value is dev_bdaddr, unless it is blank
+#define NVDS_TAG_DEV_BDADDR     (0x04)
+
+/// Tags kept in nvds_data_storage: tag, field of struct nvds_data_struct, flags. The lookup
+/// tables below are generated from this list.
+#define NVDS_TAG_TABLE(X)                                                                   \
+    X(BD_ADDRESS,           bd_address,         NVDS_TAG_DEV_BDADDR | NVDS_TAG_WRITABLE)    \
+    X(LPCLK_DRIFT,          lpclk_drift,        NVDS_TAG_LEN_CHECK)                         \
+    X(BLE_CA_TIMER_DUR,     ble_ca_timer_dur,   NVDS_TAG_LEN_CHECK | NVDS_TAG_WRITABLE)     \
+    X(BLE_CRA_TIMER_DUR,    ble_cra_timer_dur,  NVDS_TAG_LEN_CHECK | NVDS_TAG_WRITABLE)     \
+    X(BLE_CA_MIN_RSSI,      ble_ca_min_rssi,    NVDS_TAG_LEN_CHECK | NVDS_TAG_WRITABLE)     \
+    X(BLE_CA_NB_PKT,        ble_ca_nb_pkt,      NVDS_TAG_LEN_CHECK | NVDS_TAG_WRITABLE)     \
+    X(BLE_CA_NB_BAD_PKT,    ble_ca_nb_bad_pkt,  NVDS_TAG_LEN_CHECK | NVDS_TAG_WRITABLE)
+
+/// Tag descriptor
+struct nvds_tag_desc
+{
+    uint8_t     tag;
+    /// Offset of the value in struct nvds_data_struct
+    uint8_t     offset;
+    uint8_t     len;
+    uint8_t     flags;
+};
+
+/// Position of each tag in nvds_tag_desc[]
+enum nvds_tag_idx
+{
+#define NVDS_TAG_IDX(name, field, flags)        NVDS_IDX_##name,
+    NVDS_TAG_TABLE(NVDS_TAG_IDX)
+#undef NVDS_TAG_IDX
+    NVDS_IDX_COUNT
+};
+
+// The field of each tag has the length of the tag
+#define NVDS_TAG_LEN_ASSERT(name, field, flags)                                             \
+    typedef char nvds_tag_len_##name[(sizeof(((struct nvds_data_struct *) 0)->field) ==     \
+                                      NVDS_LEN_##name) ? 1 : -1];
+NVDS_TAG_TABLE(NVDS_TAG_LEN_ASSERT)
+#undef NVDS_TAG_LEN_ASSERT
+
+static const struct nvds_tag_desc nvds_tag_desc[NVDS_IDX_COUNT] =
+{
+#define NVDS_TAG_DESC(name, field, flags)                                                   \
+    { NVDS_TAG_##name, offsetof(struct nvds_data_struct, field), NVDS_LEN_##name, (flags) },
+    NVDS_TAG_TABLE(NVDS_TAG_DESC)
+#undef NVDS_TAG_DESC
+};
+
+/// Position in nvds_tag_desc[] + 1 of each tag, 0 for the tags that are not kept
+static const uint8_t nvds_tag_index[] =
+{
+#define NVDS_TAG_INDEX(name, field, flags)      [NVDS_TAG_##name] = NVDS_IDX_##name + 1,
+    NVDS_TAG_TABLE(NVDS_TAG_INDEX)
+#undef NVDS_TAG_INDEX
+};
+
+#if defined (CFG_NVDS_LOG)
+
+/*
+ * LOG DEFINITIONS
+ ****************************************************************************************
+ */
+
+/// Address of a sector of the log
+#define NVDS_LOG_SECTOR_ADDR(s)     (CFG_NVDS_LOG_OFFSET + (uint32_t) (s) * SPI_FLASH_SECTOR_SIZE)
+
+/// Magic number of the sector header ("NVDS")
+#define NVDS_LOG_MAGIC              (0x5344564E)
+
+/// Record header: tag, length (0 for a deleted tag), CRC-16 of the tag, length and data
+#define NVDS_LOG_REC_HDR            (4)
+/// Largest value of a writable tag
+#define NVDS_LOG_DATA_MAX           (NVDS_LEN_BD_ADDRESS)
+/// Largest record
+#define NVDS_LOG_REC_MAX            (NVDS_LOG_REC_HDR + NVDS_LOG_DATA_MAX)
+
+/// Tag of the erased space after the last record
+#define NVDS_LOG_TAG_END            (0xFF)
+
+#define NVDS_LOG_TAG_BIT(desc)      (1 << ((desc) - nvds_tag_desc))
+
+// Every tag has a bit in the tag masks and fits in a record
+typedef char nvds_log_tag_count[(NVDS_IDX_COUNT <= 16) ? 1 : -1];
+#define NVDS_LOG_DATA_ASSERT(name, field, flags)                                            \
+    typedef char nvds_log_data_##name[(NVDS_LEN_##name <= NVDS_LOG_DATA_MAX) ? 1 : -1];
+NVDS_TAG_TABLE(NVDS_LOG_DATA_ASSERT)
+#undef NVDS_LOG_DATA_ASSERT
+
+/// Sector header, written after the records copied to the sector by a compaction
+struct nvds_log_hdr
+{
+    uint32_t    magic;
+    /// Incremented by every compaction, the current sector has the highest one
+    uint32_t    seq;
+};
+
+/// Log state
+struct nvds_log_env
+{
+    /// Values put, valid for the tags in present
+    struct nvds_data_struct data;
+    /// Sequence number of the current sector
+    uint32_t    seq;
+    /// Offset of the next record in the current sector
+    uint16_t    write_off;
+    /// Tags put and not deleted, by position in nvds_tag_desc[]
+    uint16_t    present;
+    /// Tags put or deleted since the last flush
+    uint16_t    dirty;
+    /// Current sector
+    uint8_t     sector;
+    /// The log has been read from the flash
+    bool        loaded;
+    /// The next flush must compact the log: the current sector is full, has a torn record
+    /// or there is no log yet
+    bool        compact;
+};
+
+static struct nvds_log_env nvds_log __SECTION_ZERO("retention_mem_area0"); //@RETENTION MEMORY
+
+#endif // CFG_NVDS_LOG
+
 /*
  * FUNCTION DEFINITIONS
  ****************************************************************************************
  */
 
-#if !defined (__DA14531__) || defined (__EXCLUDE_ROM_NVDS__)
+static const struct nvds_tag_desc *nvds_tag_lookup(uint8_t tag)
+{
+    uint8_t idx = (tag < sizeof(nvds_tag_index)) ? nvds_tag_index[tag] : 0;
 
-uint8_t nvds_get_func(uint8_t tag, nvds_tag_len_t *lengthPtr, uint8_t *buf)
+    return idx ? &nvds_tag_desc[idx - 1] : NULL;
+}
+
+#if defined (CFG_NVDS_LOG)
+
+static void nvds_log_flash_init(void)
 {
-    extern struct bd_addr dev_bdaddr;
-    uint8_t status = NVDS_FAIL;
+    uint8_t dev_id;
+
+    // Release the SPI flash from power down
+    spi_flash_release_from_power_down();
 
-    switch (tag)
+    // Disable the SPI flash memory protection (unprotect all sectors)
+    spi_flash_configure_memory_protection(SPI_FLASH_MEM_PROT_NONE);
+
+    // Try to auto-detect the SPI flash memory
+    spi_flash_auto_detect(&dev_id);
+}
+
+static uint16_t nvds_log_crc(uint16_t crc, const uint8_t *data, uint8_t len)
+{
+    // CRC-16/CCITT
+    while (len--)
     {
-        case NVDS_TAG_BD_ADDRESS:
+        crc ^= (uint16_t) *data++ << 8;
+        for (int i = 0; i < 8; i++)
         {
-#if defined (__DA14531__)
-            //check if dev_bdaddr is not blank (ones)
-            if(memcmp(&dev_bdaddr, &blank_otp_bdaddr, NVDS_LEN_BD_ADDRESS))
-#else
-            //check if dev_bdaddr is not blank (zeros)
-            if(memcmp(&dev_bdaddr, &co_null_bdaddr, NVDS_LEN_BD_ADDRESS))
-#endif
-            {
-                memcpy(buf, &dev_bdaddr, NVDS_LEN_BD_ADDRESS);
-                *lengthPtr = NVDS_LEN_BD_ADDRESS;
-                status = NVDS_OK;
-            }
-            else
-            {
-                memcpy(buf, nvds_data_storage.bd_address, NVDS_LEN_BD_ADDRESS);
-                *lengthPtr = NVDS_LEN_BD_ADDRESS;
-                status = NVDS_OK;
-            }
-        } break;
+            crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+        }
+    }
+
+    return crc;
+}
+
+/**
+ ****************************************************************************************
+ * @brief Encode the record of a tag with its current value, or as deleted
+ * @param[out] rec      record
+ * @param[in]  desc     tag
+ * @return record length
+ ****************************************************************************************
+ */
+static uint8_t nvds_log_encode(uint8_t *rec, const struct nvds_tag_desc *desc)
+{
+    uint8_t len = (nvds_log.present & NVDS_LOG_TAG_BIT(desc)) ? desc->len : 0;
+    uint16_t crc;
+
+    rec[0] = desc->tag;
+    rec[1] = len;
+    memcpy(&rec[NVDS_LOG_REC_HDR], (uint8_t *) &nvds_log.data + desc->offset, len);
+    crc = nvds_log_crc(nvds_log_crc(0xFFFF, rec, 2), &rec[NVDS_LOG_REC_HDR], len);
+    rec[2] = crc & 0xFF;
+    rec[3] = crc >> 8;
 
-        case NVDS_TAG_LPCLK_DRIFT:
+    return NVDS_LOG_REC_HDR + len;
+}
+
+/**
+ ****************************************************************************************
+ * @brief Apply the records of the current sector, until the erased space or a torn record
+ ****************************************************************************************
+ */
+static void nvds_log_replay(void)
+{
+    uint32_t address = NVDS_LOG_SECTOR_ADDR(nvds_log.sector);
+    uint16_t offset = sizeof(struct nvds_log_hdr);
+    uint8_t rec[NVDS_LOG_REC_MAX];
+    uint32_t actual_size;
+
+    while (offset + NVDS_LOG_REC_HDR <= SPI_FLASH_SECTOR_SIZE)
+    {
+        uint16_t size = co_min(SPI_FLASH_SECTOR_SIZE - offset, NVDS_LOG_REC_MAX);
+        const struct nvds_tag_desc *desc;
+        uint16_t crc;
+        uint8_t len;
+
+        spi_flash_read_data(rec, address + offset, size, &actual_size);
+
+        if (rec[0] == NVDS_LOG_TAG_END)
         {
-            if (*lengthPtr < NVDS_LEN_LPCLK_DRIFT)
-            {
-                *lengthPtr = 0;
-                status = NVDS_LENGTH_OUT_OF_RANGE;
-            }
-            else
+            // End of the log, unless a record was only partly programmed
+            for (uint16_t i = 1; i < size; i++)
             {
-                memcpy(buf, &nvds_data_storage.lpclk_drift, NVDS_LEN_LPCLK_DRIFT);
-                *lengthPtr = NVDS_LEN_LPCLK_DRIFT;
-                status = NVDS_OK;
+                if (rec[i] != 0xFF)
+                {
+                    nvds_log.compact = true;
+                    break;
+                }
             }
-        } break;
+            break;
+        }
 
-        case NVDS_TAG_BLE_CA_TIMER_DUR:
+        len = rec[1];
+        if (len > NVDS_LOG_DATA_MAX || offset + NVDS_LOG_REC_HDR + len > SPI_FLASH_SECTOR_SIZE)
         {
-            if (*lengthPtr < NVDS_LEN_BLE_CA_TIMER_DUR)
-            {
-                *lengthPtr = 0;
-                status = NVDS_LENGTH_OUT_OF_RANGE;
-            }
-            else
-            {
-                memcpy(buf, &nvds_data_storage.ble_ca_timer_dur, NVDS_LEN_BLE_CA_TIMER_DUR);
-                *lengthPtr = NVDS_LEN_BLE_CA_TIMER_DUR;
-                status = NVDS_OK;
-            }
-        } break;
+            nvds_log.compact = true;
+            break;
+        }
+        crc = nvds_log_crc(nvds_log_crc(0xFFFF, rec, 2), &rec[NVDS_LOG_REC_HDR], len);
+        if (rec[2] != (crc & 0xFF) || rec[3] != (crc >> 8))
+        {
+            // Torn record, nothing can be appended after it
+            nvds_log.compact = true;
+            break;
+        }
 
-        case NVDS_TAG_BLE_CRA_TIMER_DUR:
+        // Records of tags that are no longer writable are skipped
+        desc = nvds_tag_lookup(rec[0]);
+        if (desc != NULL && (desc->flags & NVDS_TAG_WRITABLE))
         {
-            if (*lengthPtr < NVDS_LEN_BLE_CRA_TIMER_DUR)
+            if (len == desc->len)
             {
-                *lengthPtr = 0;
-                status = NVDS_LENGTH_OUT_OF_RANGE;
+                memcpy((uint8_t *) &nvds_log.data + desc->offset, &rec[NVDS_LOG_REC_HDR], len);
+                nvds_log.present |= NVDS_LOG_TAG_BIT(desc);
             }
-            else
+            else if (len == 0)
             {
-                memcpy(buf, &nvds_data_storage.ble_cra_timer_dur, NVDS_LEN_BLE_CRA_TIMER_DUR);
-                *lengthPtr = NVDS_LEN_BLE_CRA_TIMER_DUR;
-                status = NVDS_OK;
+                nvds_log.present &= ~NVDS_LOG_TAG_BIT(desc);
             }
-        } break;
+        }
+
+        offset += NVDS_LOG_REC_HDR + len;
+    }
+
+    nvds_log.write_off = offset;
+}
+
+/**
+ ****************************************************************************************
+ * @brief Read the log from the flash
+ ****************************************************************************************
+ */
+static void nvds_log_load(void)
+{
+    struct nvds_log_hdr hdr;
+    uint32_t actual_size;
+    bool found = false;
 
-        case NVDS_TAG_BLE_CA_MIN_RSSI:
+    memset(&nvds_log, 0, sizeof(nvds_log));
+    nvds_log.loaded = true;
+    // Without a log, the first flush creates it in the first sector
+    nvds_log.sector = CFG_NVDS_LOG_SECTORS - 1;
+    nvds_log.compact = true;
+
+    nvds_log_flash_init();
+
+    // The current sector is the one with the highest sequence number
+    for (uint8_t s = 0; s < CFG_NVDS_LOG_SECTORS; s++)
+    {
+        spi_flash_read_data((uint8_t *) &hdr, NVDS_LOG_SECTOR_ADDR(s), sizeof(hdr), &actual_size);
+        if (hdr.magic == NVDS_LOG_MAGIC && (!found || (int32_t) (hdr.seq - nvds_log.seq) > 0))
         {
-            if (*lengthPtr < NVDS_LEN_BLE_CA_MIN_RSSI)
-            {
-                *lengthPtr = 0;
-                status = NVDS_LENGTH_OUT_OF_RANGE;
-            }
-            else
-            {
-                memcpy(buf, &nvds_data_storage.ble_ca_min_rssi, NVDS_LEN_BLE_CA_MIN_RSSI);
-                *lengthPtr = NVDS_LEN_BLE_CA_MIN_RSSI;
-                status = NVDS_OK;
-            }
-        } break;
+            nvds_log.sector = s;
+            nvds_log.seq = hdr.seq;
+            found = true;
+        }
+    }
+
+    if (found)
+    {
+        nvds_log.compact = false;
+        nvds_log_replay();
+    }
+
+    // Power down flash
+    spi_flash_power_down();
+}
+
+/**
+ ****************************************************************************************
+ * @brief Copy the values of the tags put to the next sector, which becomes the current one.
+ *
+ * The sectors are used in turn, so they are erased evenly. The header of the new sector is
+ * written last: if the compaction is cut short, the previous sector is still the current one.
+ *
+ * @return SPI_FLASH_ERR_OK or the error of the flash
+ ****************************************************************************************
+ */
+static int8_t nvds_log_compact(void)
+{
+    uint8_t sector = (nvds_log.sector + 1) % CFG_NVDS_LOG_SECTORS;
+    uint32_t address = NVDS_LOG_SECTOR_ADDR(sector);
+    uint8_t batch[NVDS_IDX_COUNT * NVDS_LOG_REC_MAX];
+    struct nvds_log_hdr hdr;
+    uint32_t actual_size;
+    uint16_t len = 0;
+    int8_t ret;
 
-        case NVDS_TAG_BLE_CA_NB_PKT:
+    for (uint8_t i = 0; i < NVDS_IDX_COUNT; i++)
+    {
+        if (nvds_log.present & (1 << i))
         {
-            if (*lengthPtr < NVDS_LEN_BLE_CA_NB_PKT)
-            {
-                *lengthPtr = 0;
-                status = NVDS_LENGTH_OUT_OF_RANGE;
-            }
-            else
-            {
-                memcpy(buf, &nvds_data_storage.ble_ca_nb_pkt, NVDS_LEN_BLE_CA_NB_PKT);
-                *lengthPtr = NVDS_LEN_BLE_CA_NB_PKT;
-                status = NVDS_OK;
-            }
-        } break;
+            len += nvds_log_encode(&batch[len], &nvds_tag_desc[i]);
+        }
+    }
+
+    ret = spi_flash_block_erase(address, SPI_FLASH_OP_SE);
+    if (ret == SPI_FLASH_ERR_OK && len)
+    {
+        ret = spi_flash_write_data(batch, address + sizeof(hdr), len, &actual_size);
+    }
+    if (ret == SPI_FLASH_ERR_OK)
+    {
+        hdr.magic = NVDS_LOG_MAGIC;
+        hdr.seq = nvds_log.seq + 1;
+        ret = spi_flash_write_data((uint8_t *) &hdr, address, sizeof(hdr), &actual_size);
+    }
+    if (ret == SPI_FLASH_ERR_OK)
+    {
+        nvds_log.sector = sector;
+        nvds_log.seq++;
+        nvds_log.write_off = sizeof(hdr) + len;
+        nvds_log.compact = false;
+    }
+
+    return ret;
+}
+
+uint8_t nvds_flush(void)
+{
+    uint8_t batch[NVDS_IDX_COUNT * NVDS_LOG_REC_MAX];
+    uint32_t actual_size;
+    uint16_t len = 0;
+    int8_t ret;
+
+    if (!nvds_log.loaded)
+    {
+        nvds_log_load();
+    }
 
+    if (nvds_log.dirty == 0)
+    {
+        return NVDS_OK;
+    }
 
-        case NVDS_TAG_BLE_CA_NB_BAD_PKT:
+    for (uint8_t i = 0; i < NVDS_IDX_COUNT; i++)
+    {
+        if (nvds_log.dirty & (1 << i))
         {
-            if (*lengthPtr < NVDS_LEN_BLE_CA_NB_BAD_PKT)
-            {
-                *lengthPtr = 0;
-                status = NVDS_LENGTH_OUT_OF_RANGE;
-            }
-            else
-            {
-                memcpy(buf, &nvds_data_storage.ble_ca_nb_bad_pkt, NVDS_LEN_BLE_CA_NB_BAD_PKT);
-                *lengthPtr = NVDS_LEN_BLE_CA_NB_BAD_PKT;
-                status = NVDS_OK;
-            }
-        } break;
+            len += nvds_log_encode(&batch[len], &nvds_tag_desc[i]);
+        }
+    }
 
-    } // switch
+    nvds_log_flash_init();
 
-    return status;
+    if (!nvds_log.compact && nvds_log.write_off + len <= SPI_FLASH_SECTOR_SIZE)
+    {
+        // Append the records of the batch
+        ret = spi_flash_write_data(batch, NVDS_LOG_SECTOR_ADDR(nvds_log.sector) + nvds_log.write_off,
+                                   len, &actual_size);
+        if (ret == SPI_FLASH_ERR_OK)
+        {
+            nvds_log.write_off += len;
+        }
+        else
+        {
+            nvds_log.compact = true;
+        }
+    }
+    else
+    {
+        ret = nvds_log_compact();
+    }
+
+    // Power down flash
+    spi_flash_power_down();
+
+    if (ret != SPI_FLASH_ERR_OK)
+    {
+        // The batch is kept for the next flush
+        return NVDS_FAIL;
+    }
+
+    nvds_log.dirty = 0;
+
+    return NVDS_OK;
+}
+
+#endif // CFG_NVDS_LOG
+
+/**
+ ****************************************************************************************
+ * @brief Get the value of a tag: the value put, the OTP BD address or the default value
+ ****************************************************************************************
+ */
+static inline const uint8_t *nvds_tag_data(const struct nvds_tag_desc *desc)
+{
+    extern struct bd_addr dev_bdaddr;
+
+#if defined (CFG_NVDS_LOG)
+    // Only writable tags are ever present
+    if (nvds_log.present & NVDS_LOG_TAG_BIT(desc))
+    {
+        return (const uint8_t *) &nvds_log.data + desc->offset;
+    }
+#endif
+
+    if (desc->flags & NVDS_TAG_DEV_BDADDR)
+    {
+#if defined (__DA14531__)
+        //check if dev_bdaddr is not blank (ones)
+        if(memcmp(&dev_bdaddr, &blank_otp_bdaddr, NVDS_LEN_BD_ADDRESS))
+#else
+        //check if dev_bdaddr is not blank (zeros)
+        if(memcmp(&dev_bdaddr, &co_null_bdaddr, NVDS_LEN_BD_ADDRESS))
+#endif
+        {
+            return (const uint8_t *) &dev_bdaddr;
+        }
+    }
+
+    return (const uint8_t *) &nvds_data_storage + desc->offset;
+}
+
+uint8_t nvds_get_ref(uint8_t tag, nvds_tag_len_t *lengthPtr, const uint8_t **data)
+{
+    const struct nvds_tag_desc *desc;
+
+#if defined (CFG_NVDS_LOG)
+    if (!nvds_log.loaded)
+    {
+        nvds_log_load();
+    }
+#endif
+
+    desc = nvds_tag_lookup(tag);
+    if (desc == NULL)
+    {
+        return NVDS_FAIL;
+    }
+
+    if ((desc->flags & NVDS_TAG_LEN_CHECK) && *lengthPtr < desc->len)
+    {
+        *lengthPtr = 0;
+        return NVDS_LENGTH_OUT_OF_RANGE;
+    }
+
+    *lengthPtr = desc->len;
+    *data = nvds_tag_data(desc);
+
+    return NVDS_OK;
+}
+
+
+uint8_t nvds_get_func(uint8_t tag, nvds_tag_len_t *lengthPtr, uint8_t *buf)
+{
+    uint8_t idx;
+    const struct nvds_tag_desc *desc;
+    const uint8_t *data;
+
+#if defined (CFG_NVDS_LOG)
+    // Read the log on the first get since the boot, before the lookup so that it does not
+    // have to be kept across the call
+    if (!nvds_log.loaded)
+    {
+        nvds_log_load();
+    }
+#endif
+
+    // nvds_tag_lookup() inlined
+    idx = (tag < sizeof(nvds_tag_index)) ? nvds_tag_index[tag] : 0;
+    if (idx == 0)
+    {
+        return NVDS_FAIL;
+    }
+    desc = &nvds_tag_desc[idx - 1];
+
+    if ((desc->flags & NVDS_TAG_LEN_CHECK) && *lengthPtr < desc->len)
+    {
+        *lengthPtr = 0;
+        return NVDS_LENGTH_OUT_OF_RANGE;
+    }
+
+    *lengthPtr = desc->len;
+    data = nvds_tag_data(desc);
+
+    // Values are 1, 2 or 6 bytes long: copies of a constant length are inlined
+    switch (desc->len)
+    {
+        case 1:
+            buf[0] = data[0];
+            break;
+        case 2:
+            memcpy(buf, data, 2);
+            break;
+        default:
+            memcpy(buf, data, desc->len);
+            break;
+    }
+
+    return NVDS_OK;
 }
 
 #if (NVDS_READ_WRITE == 1)
 uint8_t nvds_init_func(uint8_t *base, uint32_t len)
 {
+#if defined (CFG_NVDS_LOG)
+    nvds_log_load();
+#endif
     return NVDS_OK;
 }
 
 /// NVDS API implementation - required by ROM function table
 uint8_t nvds_del_func(uint8_t tag)
 {
+#if defined (CFG_NVDS_LOG)
+    const struct nvds_tag_desc *desc = nvds_tag_lookup(tag);
+
+    if (desc == NULL)
+    {
+        return NVDS_TAG_NOT_DEFINED;
+    }
+    if (!(desc->flags & NVDS_TAG_WRITABLE))
+    {
+        return NVDS_PARAM_LOCKED;
+    }
+
+    if (!nvds_log.loaded)
+    {
+        nvds_log_load();
+    }
+    if (nvds_log.present & NVDS_LOG_TAG_BIT(desc))
+    {
+        nvds_log.present &= ~NVDS_LOG_TAG_BIT(desc);
+        nvds_log.dirty |= NVDS_LOG_TAG_BIT(desc);
+    }
+
+    return NVDS_OK;
+#else
     return NVDS_FAIL;
+#endif
 }
 
 /// NVDS API implementation - required by ROM function table
 uint8_t nvds_put_func(uint8_t tag, nvds_tag_len_t length, uint8_t *buf)
 {
+#if defined (CFG_NVDS_LOG)
+    const struct nvds_tag_desc *desc = nvds_tag_lookup(tag);
+    uint8_t *value;
+
+    if (desc == NULL)
+    {
+        return NVDS_TAG_NOT_DEFINED;
+    }
+    if (!(desc->flags & NVDS_TAG_WRITABLE))
+    {
+        return NVDS_PARAM_LOCKED;
+    }
+    if (length != desc->len)
+    {
+        return NVDS_LENGTH_OUT_OF_RANGE;
+    }
+
+    if (!nvds_log.loaded)
+    {
+        nvds_log_load();
+    }
+
+    // Putting the value a tag already has does not wear the flash
+    value = (uint8_t *) &nvds_log.data + desc->offset;
+    if (!(nvds_log.present & NVDS_LOG_TAG_BIT(desc)) || memcmp(value, buf, length))
+    {
+        memcpy(value, buf, length);
+        nvds_log.present |= NVDS_LOG_TAG_BIT(desc);
+        nvds_log.dirty |= NVDS_LOG_TAG_BIT(desc);
+    }
+
+    return NVDS_OK;
+#else
     return NVDS_FAIL;
+#endif
 }
 #endif //(NVDS_READ_WRITE == 1)
 
@@ -1214,6 +1214,219 @@ int8_t spi_flash_read_data_dma(uint8_t *rd_data_ptr, uint32_t address,
 }
 #endif
 
+int8_t spi_flash_read_stream_start(uint32_t address)
+{
+    SPI_FLASH_ENABLE_POWER_PIN();
+
+    // Check if SPI Flash is ready
+    int8_t status = spi_flash_is_busy();
+    if (status != SPI_FLASH_ERR_OK)
+    {
+        return status;
+    }
+
+    // Send Command
+    spi_set_bitmode(SPI_MODE_32BIT);
+    spi_cs_low();
+    // Send sequencial read from memory Command
+    spi_access((SPI_FLASH_OP_READ << 24) | address);
+
+    spi_set_bitmode(SPI_MODE_8BIT);
+
+    return SPI_FLASH_ERR_OK;
+}
+
+void spi_flash_read_stream_stop(void)
+{
+    spi_cs_high();
+}
+
+/*
+ * SPI Flash Burst Write functions
+ ****************************************************************************************
+ */
+
+/**
+ ****************************************************************************************
+ * @brief Start erasing the next block of a burst write region, with the largest erase
+ *        the alignment and the rest of the region allow.
+ * @param[in] burst         Writer state
+ * @return Error code
+ ****************************************************************************************
+ */
+static int8_t spi_flash_burst_erase_next(spi_flash_burst_t *burst)
+{
+    uint32_t left = burst->end - burst->erased_end;
+    spi_flash_op_t erase_op = SPI_FLASH_OP_SE;
+    uint32_t erase_size = SPI_FLASH_SECTOR_SIZE;
+
+    if (((burst->erased_end % SPI_FLASH_BLOCK64_SIZE) == 0) && (left >= SPI_FLASH_BLOCK64_SIZE))
+    {
+        erase_op = SPI_FLASH_OP_BE64;
+        erase_size = SPI_FLASH_BLOCK64_SIZE;
+    }
+    else if (((burst->erased_end % SPI_FLASH_BLOCK32_SIZE) == 0) && (left >= SPI_FLASH_BLOCK32_SIZE))
+    {
+        erase_op = SPI_FLASH_OP_BE32;
+        erase_size = SPI_FLASH_BLOCK32_SIZE;
+    }
+
+    // Wait for the previous program or erase
+    int8_t status = spi_flash_wait_till_ready();
+    if (status != SPI_FLASH_ERR_OK)
+    {
+        return status;
+    }
+
+    status = spi_flash_block_erase_no_wait(burst->erased_end, erase_op);
+    if (status != SPI_FLASH_ERR_OK)
+    {
+        return status;
+    }
+
+    burst->erased_end += erase_size;
+
+    return SPI_FLASH_ERR_OK;
+}
+
+/**
+ ****************************************************************************************
+ * @brief Start programming a page without waiting for it to complete.
+ * @param[in] wr_data_ptr   Pointer to the data to be written
+ * @param[in] address       Starting address of data to be written
+ * @param[in] size          Size of the data to be written (up to the end of the page)
+ * @return Error code
+ ****************************************************************************************
+ */
+static int8_t spi_flash_burst_program_page(const uint8_t *wr_data_ptr, uint32_t address,
+                                           uint16_t size)
+{
+    // Wait for the previous program or erase, the caller prepared the data meanwhile
+    int8_t status = spi_flash_wait_till_ready();
+    if (status != SPI_FLASH_ERR_OK)
+    {
+        return status;
+    }
+
+    // Send Write Enable instruction
+    status = spi_flash_write_enable(SPI_FLASH_OP_WREN);
+    if (status != SPI_FLASH_ERR_OK)
+    {
+        return status;
+    }
+
+    // Send command
+    spi_set_bitmode(SPI_MODE_32BIT);
+    spi_cs_low();
+    spi_access((SPI_FLASH_OP_PP << 24) | address);
+
+    // Send data
+    spi_set_bitmode(SPI_MODE_8BIT);
+#if defined (CFG_SPI_DMA_SUPPORT)
+    spi_send(wr_data_ptr, size, SPI_OP_DMA);
+    // Wait for DMA to finish, the page is programmed once CS is released
+    spi_wait_dma_write_to_finish();
+#else
+    spi_send(wr_data_ptr, size, SPI_OP_BLOCKING);
+#endif
+    spi_cs_high();
+
+    return SPI_FLASH_ERR_OK;
+}
+
+int8_t spi_flash_burst_start(spi_flash_burst_t *burst, uint32_t address, uint32_t size)
+{
+    SPI_FLASH_ENABLE_POWER_PIN();
+
+    if ((address % SPI_FLASH_SECTOR_SIZE) != 0)
+    {
+        return SPI_FLASH_ERR_ALIGN;
+    }
+
+    // The region must be located in a valid Flash memory address space
+    if ((size == 0) || (address >= spi_flash_cfg_env.chip_size) ||
+        (size > spi_flash_cfg_env.chip_size - address))
+    {
+        return SPI_FLASH_ERR_INVAL;
+    }
+
+    burst->address = address;
+    burst->erased_end = address;
+    burst->end = address + ((size + SPI_FLASH_SECTOR_SIZE - 1) / SPI_FLASH_SECTOR_SIZE) * SPI_FLASH_SECTOR_SIZE;
+
+    return spi_flash_burst_erase_next(burst);
+}
+
+int8_t spi_flash_burst_write(spi_flash_burst_t *burst, const uint8_t *wr_data_ptr,
+                             uint32_t size)
+{
+    int8_t status;
+
+    if (size > burst->end - burst->address)
+    {
+        return SPI_FLASH_ERR_INVAL;
+    }
+
+    while (size > 0)
+    {
+        // Limit the transaction to the upper limit of the current page
+        uint32_t bytes_to_send = SPI_FLASH_PAGE_SIZE - (burst->address % SPI_FLASH_PAGE_SIZE);
+        if (bytes_to_send > size)
+        {
+            bytes_to_send = size;
+        }
+
+        // Erase blocks are sector multiples, a page never crosses the end of the erased part
+        while (burst->address >= burst->erased_end)
+        {
+            status = spi_flash_burst_erase_next(burst);
+            if (status != SPI_FLASH_ERR_OK)
+            {
+                return status;
+            }
+        }
+
+        status = spi_flash_burst_program_page(wr_data_ptr, burst->address, bytes_to_send);
+        if (status != SPI_FLASH_ERR_OK)
+        {
+            return status;
+        }
+
+        wr_data_ptr += bytes_to_send;
+        burst->address += bytes_to_send;
+        size -= bytes_to_send;
+
+        // Block written, erase the next one while the caller prepares more data
+        if ((burst->address == burst->erased_end) && (burst->erased_end < burst->end))
+        {
+            status = spi_flash_burst_erase_next(burst);
+            if (status != SPI_FLASH_ERR_OK)
+            {
+                return status;
+            }
+        }
+    }
+
+    return SPI_FLASH_ERR_OK;
+}
+
+int8_t spi_flash_burst_finish(spi_flash_burst_t *burst)
+{
+    int8_t status;
+
+    // Erase the part of the region that has not been written
+    while (burst->erased_end < burst->end)
+    {
+        status = spi_flash_burst_erase_next(burst);
+        if (status != SPI_FLASH_ERR_OK)
+        {
+            return status;
+        }
+    }
+
+    return spi_flash_wait_till_ready();
+}
+
 /*
  * SPI Flash Check Empty functions
  ****************************************************************************************
@@ -54,6 +54,8 @@
 /** Definition for standard SPI Flash devices */
 #define SPI_FLASH_SECTOR_SIZE                   4096
 #define SPI_FLASH_PAGE_SIZE                     256
+#define SPI_FLASH_BLOCK32_SIZE                  0x8000
+#define SPI_FLASH_BLOCK64_SIZE                  0x10000
 #define SPI_FLASH_MEM_PROT_NONE                 0
 #define SPI_FLASH_MEM_PROT_MASK                 0x7C
 ///@}
@@ -525,6 +527,17 @@ typedef struct
     uint32_t chip_size;
 } spi_flash_cfg_t;
 
+/// SPI Flash burst writer state, see spi_flash_burst_start()
+typedef struct
+{
+    /// Next address to be programmed
+    uint32_t address;
+    /// End of the erased part of the region, the last erase may still be in progress
+    uint32_t erased_end;
+    /// End of the region, aligned to SPI Flash sector size
+    uint32_t end;
+} spi_flash_burst_t;
+
 /*
  * FUNCTION DECLARATIONS
  ****************************************************************************************
@@ -974,6 +987,69 @@ int8_t spi_flash_read_data_dma(uint8_t *rd_data_ptr, uint32_t address,
                                uint32_t size, uint32_t *actual_size);
 #endif
 
+/**
+ ****************************************************************************************
+ * @brief Start a sequential read from a given starting address
+ * @details Selects the flash and sends the read command. The data is then clocked in with
+ * any number of spi_receive() calls, e.g. with SPI_OP_DMA to process the previous block
+ * while the next one is transferred, until spi_flash_read_stream_stop() is called.
+ * The caller must not read beyond the end of the flash.
+ * @param[in] address       Starting address of data to be read
+ * @return Error code
+ ****************************************************************************************
+ */
+int8_t spi_flash_read_stream_start(uint32_t address);
+
+/**
+ ****************************************************************************************
+ * @brief Stop a sequential read started with spi_flash_read_stream_start()
+ * @note Any DMA transfer must have finished before this is called.
+ ****************************************************************************************
+ */
+void spi_flash_read_stream_stop(void);
+
+/**
+ ****************************************************************************************
+ * @brief Start writing a region that is erased on the way
+ * @details The sectors covering the region are erased while it is being written, with
+ * Block64 and Block32 erases where the region is aligned to them. The first erase is started
+ * here and not waited for, so the caller can prepare the first data meanwhile.
+ * @param[out] burst        Writer state
+ * @param[in] address       Starting address of the region (must be a multiple of SPI Flash
+ *                          sector size)
+ * @param[in] size          Size of the region
+ * @return Error code
+ ****************************************************************************************
+ */
+int8_t spi_flash_burst_start(spi_flash_burst_t *burst, uint32_t address, uint32_t size);
+
+/**
+ ****************************************************************************************
+ * @brief Write the next data of a region started with spi_flash_burst_start()
+ * @details Programs page by page, waiting for the flash only before each operation. When a
+ * block has been written, the erase of the next block is started before returning, so the
+ * erase and the last page program run while the caller prepares the next data.
+ * @param[in] burst         Writer state
+ * @param[in] wr_data_ptr   Pointer to the data to be written, can be reused on return
+ * @param[in] size          Size of the data to be written (any size, up to the end of the
+ *                          region)
+ * @return Error code
+ ****************************************************************************************
+ */
+int8_t spi_flash_burst_write(spi_flash_burst_t *burst, const uint8_t *wr_data_ptr,
+                             uint32_t size);
+
+/**
+ ****************************************************************************************
+ * @brief Finish writing a region started with spi_flash_burst_start()
+ * @details Erases the part of the region that has not been written and waits until the
+ * flash is ready.
+ * @param[in] burst         Writer state
+ * @return Error code
+ ****************************************************************************************
+ */
+int8_t spi_flash_burst_finish(spi_flash_burst_t *burst);
+
 /**
  ****************************************************************************************
  * @brief Check if a page is erased
@@ -0,0 +1,260 @@
+/**
+ ****************************************************************************************
+ *
+ * @file protocol.h
+ *
+ * @brief Flash programmer UART protocol engine
+ *
+ * Every packet, in both directions, is a big endian header of the payload length (uint16_t)
+ * and its CRC32 (uint32_t), followed by the payload. The first payload byte of a request is
+ * the action, the first byte of a response is the status.
+ *
+ * Packets are received by spans: prot_rx_span() tells where the next bytes go and how many
+ * are expected, the UART driver receives them (interrupt or DMA driven on the target, read()
+ * on the host) and prot_rx_received() accounts for them. The CRC is only checked by
+ * prot_rx_check(), so a packet can be checked and processed while the next one is received
+ * into another buffer.
+ *
+ * Streaming write (ACTION_STREAM_WRITE, target, address, size):
+ * - The device prepares the target (e.g. erases the region of the SPI flash) and replies
+ *   ACTION_CONTENTS with the largest chunk (uint16_t), or ACTION_ERROR with the error code.
+ * - The host sends the data in ACTION_DATA packets of up to that many bytes. All chunks but
+ *   the last one are a multiple of the alignment of the target.
+ * - The device acknowledges every chunk as soon as it has arrived, before writing it, and
+ *   receives the next one while it writes. The host sends a chunk when the previous one has
+ *   been acknowledged. A corrupted chunk is answered with ACTION_INVALID_CRC and must be sent
+ *   again. A write error is reported instead of the acknowledgement of the next chunk, and
+ *   ends the stream. The acknowledgement of the last chunk is only sent once all data is
+ *   written.
+ *
+ * Baud rate negotiation (ACTION_UART_BAUD_NEGOTIATE, baud rate):
+ * - The device replies ACTION_CONTENTS with the highest baud rate it supports up to the one
+ *   requested, or ACTION_ERROR, and switches to it.
+ * - The host switches too and sends ACTION_UART_BAUD_CONFIRM within
+ *   PROT_BAUD_CONFIRM_TIMEOUT ms, which the device acknowledges at the new baud rate. If the
+ *   confirmation does not arrive intact in time, the device returns to the previous baud
+ *   rate; a host that gets no acknowledgement does the same.
+ *
+ * Copyright (C) 2016-2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ ****************************************************************************************
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifndef __PROTOCOL_INCLUDED__
+#define __PROTOCOL_INCLUDED__
+
+#define ERR_OK                  0
+#define ERR_INVAL               -4
+
+#define NO_ACTION               0
+#define ACTION_READ_VERSION     0x10
+#define ACTION_RETRIEVE_STATUS  0x20
+
+#define ACTION_UART_BAUD        0x30
+#define ACTION_UART_GPIOS       0x31
+#define ACTION_GPIOS            0x32
+#define ACTION_UART_BAUD_NEGOTIATE  0x33
+#define ACTION_UART_BAUD_CONFIRM    0x34
+
+#define ACTION_READ             0x80
+#define ACTION_WRITE            0x81
+
+#define ACTION_OTP_READ         0x80
+#define ACTION_OTP_WRITE        0x81
+
+#define ACTION_CONTENTS         0x82
+#define ACTION_OK               0x83
+#define ACTION_ERROR            0x84
+#define ACTION_DATA             0x85
+#define ACTION_INVALID_COMMAND  0x86
+#define ACTION_INVALID_CRC      0x87
+#define ACTION_STREAM_WRITE     0x88
+
+#define ACTION_SPI_READ         0x90
+#define ACTION_SPI_WRITE        0x91
+#define ACTION_SPI_ERASE        0x92
+#define ACTION_SPI_ID           0x93
+#define ACTION_SPI_ERASE_BLOCK  0x94
+#define ACTION_SPI_GPIOS        0x95
+#define ACTION_SPI_IS_EMPTY     0x96
+#define ACTION_SPI_INIT         0x97
+
+#define ACTION_EEPROM_READ      0xA0
+#define ACTION_EEPROM_WRITE     0xA1
+#define ACTION_EEPROM_ERASE     0xA2
+#define ACTION_I2C_GPIOS        0xA3
+#define ACTION_EEPROM_INIT      0xA4
+
+#define ACTION_GPIO_WD          0xB0
+
+#define ACTION_PLATFORM_RESET   0xC0
+#define ACTION_RESET_MODE       0xC1
+
+/// Targets of ACTION_STREAM_WRITE
+#define STREAM_TARGET_SPI       0
+#define STREAM_TARGET_OTP       1
+
+#define PROT_HEADER_SIZE        6
+
+/// Chunk sizes of a streaming write are rounded down to a multiple of this
+#define PROT_CHUNK_GRANULE      256
+
+/// Time the device waits for ACTION_UART_BAUD_CONFIRM, in ms
+#define PROT_BAUD_CONFIRM_TIMEOUT   100
+
+typedef enum
+{
+    PROT_RX_HEADER,
+    PROT_RX_DATA,
+    PROT_RX_DONE,
+} PROT_RX_STATE;
+
+/// Packet reception
+typedef struct
+{
+    uint8_t *buf;                       ///< Payload buffer
+    uint16_t size;                      ///< Size of the payload buffer
+    uint16_t len;                       ///< Payload length, from the header
+    uint32_t pos;                       ///< Bytes received of the header or of the payload
+    uint8_t header[PROT_HEADER_SIZE];
+    volatile PROT_RX_STATE state;
+} prot_rx_t;
+
+/// Target of a streaming write
+typedef struct
+{
+    /// Prepare the region, returns 0 on success
+    int (*begin)(uint32_t address, uint32_t size);
+    /// Write the next chunk of data, returns 0 on success
+    int (*write)(const uint8_t *data, uint32_t size);
+    /// Complete the write, returns 0 on success
+    int (*end)(void);
+    /// Chunks but the last one must be a multiple of this
+    uint16_t align;
+} prot_target_t;
+
+/**
+ ****************************************************************************************
+ * @brief Prepare the reception of a packet
+ * @param[in] rx        reception
+ * @param[in] buf       payload buffer, the payload of a longer packet is discarded
+ * @param[in] size      size of the payload buffer
+ ****************************************************************************************
+ */
+void prot_rx_arm(prot_rx_t *rx, uint8_t *buf, uint16_t size);
+
+/**
+ ****************************************************************************************
+ * @brief Get where the next bytes of the packet go
+ * @param[in] rx        reception
+ * @param[out] dst      destination of the next bytes
+ * @return number of bytes expected there, 0 once the packet is complete
+ ****************************************************************************************
+ */
+uint16_t prot_rx_span(prot_rx_t *rx, uint8_t **dst);
+
+/**
+ ****************************************************************************************
+ * @brief Account for bytes received at the destination returned by prot_rx_span()
+ * @param[in] rx        reception
+ * @param[in] count     bytes received, up to the span
+ ****************************************************************************************
+ */
+void prot_rx_received(prot_rx_t *rx, uint16_t count);
+
+/**
+ ****************************************************************************************
+ * @brief Check whether the packet is complete
+ * @param[in] rx        reception
+ * @return true once the whole packet has been received
+ ****************************************************************************************
+ */
+bool prot_rx_done(const prot_rx_t *rx);
+
+/**
+ ****************************************************************************************
+ * @brief Check a complete packet
+ * @param[in] rx        reception
+ * @return payload length, -1 if the packet did not fit the buffer or its CRC is wrong
+ ****************************************************************************************
+ */
+int32_t prot_rx_check(const prot_rx_t *rx);
+
+/**
+ ****************************************************************************************
+ * @brief Handle ACTION_STREAM_WRITE, until the last chunk has been acknowledged
+ * @param[in] cmd       the ACTION_STREAM_WRITE packet
+ * @param[in] buffer    buffer for the chunks, split in two
+ * @param[in] size      size of the buffer
+ * @param[in] target    target of the write
+ * @return 0 on success, the error reported to the host otherwise, -1 if the port failed
+ ****************************************************************************************
+ */
+int prot_stream_write(const uint8_t *cmd, uint8_t *buffer, uint16_t size,
+                      const prot_target_t *target);
+
+/**
+ ****************************************************************************************
+ * @brief Handle ACTION_UART_BAUD_NEGOTIATE
+ * @param[in] cmd       the ACTION_UART_BAUD_NEGOTIATE packet
+ * @param[in] current   current baud rate
+ * @return baud rate in use afterwards
+ ****************************************************************************************
+ */
+uint32_t prot_baud_negotiate(const uint8_t *cmd, uint32_t current);
+
+/*
+ * Port functions, implemented by the application
+ ****************************************************************************************
+ */
+
+/**
+ ****************************************************************************************
+ * @brief Start receiving the packet, from the span returned by prot_rx_span() on
+ * @param[in] rx        reception, prepared with prot_rx_arm()
+ ****************************************************************************************
+ */
+void prot_port_rx_start(prot_rx_t *rx);
+
+/**
+ ****************************************************************************************
+ * @brief Wait until the packet is complete
+ * @param[in] rx        reception, started with prot_port_rx_start()
+ * @param[in] timeout   in ms, 0 to wait forever
+ * @return false on timeout or if the port failed, the reception is then stopped
+ ****************************************************************************************
+ */
+bool prot_port_rx_wait(prot_rx_t *rx, uint32_t timeout);
+
+/**
+ ****************************************************************************************
+ * @brief Send a packet, with its header
+ * @param[in] buf       payload
+ * @param[in] len       payload length
+ ****************************************************************************************
+ */
+void prot_port_send(uint8_t *buf, uint16_t len);
+
+/**
+ ****************************************************************************************
+ * @brief Get the highest supported baud rate up to a requested one
+ * @param[in] requested baud rate
+ * @return baud rate, 0 if there is none
+ ****************************************************************************************
+ */
+uint32_t prot_port_baud_select(uint32_t requested);
+
+/**
+ ****************************************************************************************
+ * @brief Switch the UART to a baud rate, once the transmission in progress has finished
+ * @param[in] baud      baud rate returned by prot_port_baud_select()
+ ****************************************************************************************
+ */
+void prot_port_set_baud(uint32_t baud);
+
+#endif
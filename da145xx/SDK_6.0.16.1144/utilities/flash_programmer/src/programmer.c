@@ -17,6 +17,7 @@
 #include <string.h>
 #include "arch_system.h"
 #include "programmer.h"
+#include "protocol.h"
 #include "spi.h"
 #include "spi_flash.h"
 #include "i2c_eeprom.h"
@@ -36,49 +37,7 @@
 #define ACTION_READY            0x5A
 #define SPI_IS_EMPTY_ALL        0x01
 
-#define ERR_OK                  0
-#define ERR_INVAL               -4
-
-#define NO_ACTION               0
-#define ACTION_READ_VERSION     0x10
-#define ACTION_RETRIEVE_STATUS  0x20
-
-#define ACTION_UART_BAUD        0x30
-#define ACTION_UART_GPIOS       0x31
-#define ACTION_GPIOS            0x32
-
-#define ACTION_READ             0x80
-#define ACTION_WRITE            0x81
-
-#define ACTION_OTP_READ         0x80
-#define ACTION_OTP_WRITE        0x81
-
-#define ACTION_CONTENTS         0x82
-#define ACTION_OK               0x83
-#define ACTION_ERROR            0x84
-#define ACTION_DATA             0x85
-#define ACTION_INVALID_COMMAND  0x86
-#define ACTION_INVALID_CRC      0x87
-
-#define ACTION_SPI_READ         0x90
-#define ACTION_SPI_WRITE        0x91
-#define ACTION_SPI_ERASE        0x92
-#define ACTION_SPI_ID           0x93
-#define ACTION_SPI_ERASE_BLOCK  0x94
-#define ACTION_SPI_GPIOS        0x95
-#define ACTION_SPI_IS_EMPTY     0x96
-#define ACTION_SPI_INIT         0x97
-
-#define ACTION_EEPROM_READ      0xA0
-#define ACTION_EEPROM_WRITE     0xA1
-#define ACTION_EEPROM_ERASE     0xA2
-#define ACTION_I2C_GPIOS        0xA3
-#define ACTION_EEPROM_INIT      0xA4
-
-#define ACTION_GPIO_WD          0xB0
-
-#define ACTION_PLATFORM_RESET   0xC0
-#define ACTION_RESET_MODE       0xC1
+// The actions and the error codes are defined in protocol.h
 
 
 // Address definitions needed for:
@@ -106,6 +65,9 @@
 #define UART_BAUD_115200 3
 #define UART_BAUD_1M     4
 
+// Approximate iterations per ms of a polling loop, at 16 MHz
+#define RX_WAIT_LOOPS_PER_MS    1600
+
 extern _uart_sel_pins uart_sel_pins;
 extern _spi_sel_pins spi_sel_pins;
 
@@ -419,6 +381,47 @@ static UART_BAUDRATE get_baudrate(uint8_t baud_sel)
     return baud;
 }
 
+/// Baud rates of ACTION_UART_BAUD_NEGOTIATE
+static const struct
+{
+    uint32_t rate;
+    UART_BAUDRATE cfg;
+} uart_rates[] = {
+    {    9600, UART_BAUDRATE_9600 },
+    {   19200, UART_BAUDRATE_19200 },
+    {   57600, UART_BAUDRATE_57600 },
+    {  115200, UART_BAUDRATE_115200 },
+    {  230400, UART_BAUDRATE_230400 },
+    {  460800, UART_BAUDRATE_460800 },
+    {  500000, UART_BAUDRATE_500000 },
+    {  921600, UART_BAUDRATE_921600 },
+    { 1000000, UART_BAUDRATE_1000000 },
+};
+
+/// Current baud rate
+static uint32_t uart_baud_rate;
+
+/// Packet being received by the UART interrupt
+static prot_rx_t *volatile uart_rx;
+
+/**
+ ****************************************************************************************
+ * @brief UART receive callback, continues the reception of the packet.
+ ****************************************************************************************
+ */
+static void uart_rx_cb(uint16_t count)
+{
+    uint8_t *dst;
+    uint16_t span;
+
+    prot_rx_received(uart_rx, count);
+    span = prot_rx_span(uart_rx, &dst);
+    if (span)
+    {
+        uart_receive(UART1, dst, span, UART_OP_INTR);
+    }
+}
+
 /**
  ****************************************************************************************
  * @brief Set UART pads.
@@ -458,15 +461,23 @@ static void uart_pads(uint8_t sel)
 
 /**
  ****************************************************************************************
- * @brief Configures UART.
+ * @brief Configures UART with a baud rate.
  ****************************************************************************************
  */
-static void uart_set_config(uint8_t pad_sel, uint8_t baud_sel)
+static void uart_apply_config(uint8_t pad_sel, UART_BAUDRATE baud)
 {
-    UART_BAUDRATE baud = get_baudrate(baud_sel);
     uart_cfg_t uart_cfg = {.baud_rate = baud, .data_bits = UART_DATABITS_8, .parity = UART_PARITY_NONE,
                            .stop_bits = UART_STOPBITS_1, .auto_flow_control = UART_AFCE_DIS, .use_fifo = UART_FIFO_DIS,
-                           .tx_fifo_tr_lvl = UART_TX_FIFO_LEVEL_0, .rx_fifo_tr_lvl = UART_RX_FIFO_LEVEL_0, .intr_priority = 2 };
+                           .tx_fifo_tr_lvl = UART_TX_FIFO_LEVEL_0, .rx_fifo_tr_lvl = UART_RX_FIFO_LEVEL_0, .intr_priority = 2,
+                           .uart_rx_cb = uart_rx_cb };
+
+    for (int i = 0; i < sizeof(uart_rates) / sizeof(uart_rates[0]); i++)
+    {
+        if (uart_rates[i].cfg == baud)
+        {
+            uart_baud_rate = uart_rates[i].rate;
+        }
+    }
 
     uart_initialize(UART1, &uart_cfg);
 
@@ -489,6 +500,16 @@ static void uart_set_config(uint8_t pad_sel, uint8_t baud_sel)
     uart_pads(pad_sel);
 }
 
+/**
+ ****************************************************************************************
+ * @brief Configures UART.
+ ****************************************************************************************
+ */
+static void uart_set_config(uint8_t pad_sel, uint8_t baud_sel)
+{
+    uart_apply_config(pad_sel, get_baudrate(baud_sel));
+}
+
 /**
  ****************************************************************************************
   @brief Put a  byte into transmittion buffer
@@ -663,28 +684,6 @@ uint32_t get_uint32_rev(uint8_t *buffer)
     return (w0 << 16) | w1;
 }
 
-/**
- ****************************************************************************************
-  @brief receive buffer
-
- ****************************************************************************************
-*/
-int32_t receive_packet(uint8_t *buffer)
-{
-    uint16_t length = receive_uint16();
-    uint32_t crc_remote = receive_uint32();
-    uint32_t crc_local;
-    size_t i;
-
-    for (i = 0; i < length; i++)
-        buffer[i] = receive_byte();
-
-    crc_local = crc32(0, buffer, length);
-    if (crc_local != crc_remote)
-        return communication_error();
-    return length;
-}
-
 /**
  ****************************************************************************************
  * @brief Send pachet to uart
@@ -706,6 +705,70 @@ void send_packet(uint8_t *buffer, uint16_t length)
 #endif
     uart_wait_tx_finish(UART1);
 }
+
+/****************************************************************************************
+   ****************************** PROTOCOL PORT *****************************
+ ****************************************************************************************/
+
+extern uint8_t port_sel;
+
+void prot_port_rx_start(prot_rx_t *rx)
+{
+    uint8_t *dst;
+    uint16_t span = prot_rx_span(rx, &dst);
+
+    uart_rx = rx;
+    uart_receive(UART1, dst, span, UART_OP_INTR);
+}
+
+bool prot_port_rx_wait(prot_rx_t *rx, uint32_t timeout)
+{
+    uint32_t loops = timeout * RX_WAIT_LOOPS_PER_MS;
+
+    while (!prot_rx_done(rx))
+    {
+        if (timeout && loops-- == 0)
+        {
+            uart_rxdata_intr_setf(UART1, UART_BIT_DIS);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void prot_port_send(uint8_t *buf, uint16_t len)
+{
+    send_packet(buf, len);
+}
+
+uint32_t prot_port_baud_select(uint32_t requested)
+{
+    uint32_t baud = 0;
+
+    for (int i = 0; i < sizeof(uart_rates) / sizeof(uart_rates[0]); i++)
+    {
+        if (uart_rates[i].rate <= requested)
+        {
+            baud = uart_rates[i].rate;
+        }
+    }
+
+    return baud;
+}
+
+void prot_port_set_baud(uint32_t baud)
+{
+    uart_wait_tx_finish(UART1);
+
+    for (int i = 0; i < sizeof(uart_rates) / sizeof(uart_rates[0]); i++)
+    {
+        if (uart_rates[i].rate == baud)
+        {
+            uart_apply_config(port_sel, uart_rates[i].cfg);
+        }
+    }
+}
 #endif
 
 /****************************************************************************************
@@ -997,10 +1060,128 @@ static int8_t erase_flash_sectors(uint32_t starting_address, uint32_t size)
     return ret;
 }
 
+/**
+ ****************************************************************************************
+ * @brief Write OTP cells
+ *
+ ****************************************************************************************
+ */
+static int otp_write_cells(uint32_t address, const uint8_t *data, uint32_t size)
+{
+    uint32_t word2write[HW_OTP_CELL_SIZE / 4];
+    volatile size_t i;
+    unsigned int target_address = (unsigned int) address;
+    int result = 0;
+
+    for (i = 0; i < size; i += HW_OTP_CELL_SIZE)
+    {
+        memcpy(word2write, data + i, sizeof(word2write));
+
+        /*
+         * OTP cell must be powered on, so we turn on the related clock.
+         * However, the OTP LDO will not be able to sustain an infinite
+         * amount of writes. So we keep our writes limited. Turning off the
+         * LDO at the end of the operation ensures that we restart the
+         * operation appropriately for the next write.
+         */
+        hw_otpc_init();
+        #if defined (__DA14531__)
+        if (word2write[0] != 0xffffffff)
+        {
+            result = hw_otpc_prog_and_verify((word2write), target_address >> 2, 1)? 0 : 1;
+        }
+        #else
+        /* From the manual: The destination address is a word aligned address, that represents the OTP memory
+        address. It is not an AHB bus address. The lower allowed value is 0x0000 and the maximum allowed
+        value is 0x1FFF (8K words space). */
+        result = hw_otpc_fifo_prog((const uint32_t *) (&word2write),
+                                   target_address >> 3,
+                                   HW_OTPC_WORD_LOW, 2, false) ? 0 : 1;
+        #endif
+        hw_otpc_disable();
+
+        target_address += HW_OTP_CELL_SIZE;
+
+        if (result != 0)
+            break;
+    }
+
+    return result;
+}
+
+#ifdef USE_UART
+/****************************************************************************************
+   ****************************** STREAMING WRITE TARGETS *****************************
+ ****************************************************************************************/
+
+static spi_flash_burst_t spi_burst;
+static uint32_t otp_stream_address;
+
+static int spi_stream_begin(uint32_t address, uint32_t size)
+{
+    return spi_flash_burst_start(&spi_burst, address, size);
+}
+
+static int spi_stream_write(const uint8_t *data, uint32_t size)
+{
+    return spi_flash_burst_write(&spi_burst, data, size);
+}
+
+static int spi_stream_end(void)
+{
+    return spi_flash_burst_finish(&spi_burst);
+}
+
+/// SPI flash, the region is erased with the largest erase commands that fit
+static const prot_target_t spi_stream = {
+    .begin = spi_stream_begin,
+    .write = spi_stream_write,
+    .end = spi_stream_end,
+    .align = 1,
+};
+
+static int otp_stream_begin(uint32_t address, uint32_t size)
+{
+    if ((address % HW_OTP_CELL_SIZE) || (size % HW_OTP_CELL_SIZE))
+    {
+        return ERR_INVAL;
+    }
+
+    otp_stream_address = address;
+    return ERR_OK;
+}
+
+static int otp_stream_write(const uint8_t *data, uint32_t size)
+{
+    int result = otp_write_cells(otp_stream_address, data, size);
+
+    otp_stream_address += size;
+    return result;
+}
+
+static int otp_stream_end(void)
+{
+    return ERR_OK;
+}
+
+/// OTP, whole cells
+static const prot_target_t otp_stream = {
+    .begin = otp_stream_begin,
+    .write = otp_stream_write,
+    .end = otp_stream_end,
+    .align = HW_OTP_CELL_SIZE,
+};
+#endif
+
 int32_t read_data(uint8_t *buffer)
 {
 #ifdef USE_UART
-    return receive_packet(buffer);
+    static prot_rx_t cmd_rx;
+
+    prot_rx_arm(&cmd_rx, buffer, ALLOWED_DATA_UART);
+    prot_port_rx_start(&cmd_rx);
+    prot_port_rx_wait(&cmd_rx, 0);
+    return prot_rx_check(&cmd_rx);
 #else
     return 0;
 #endif
@@ -1193,6 +1374,40 @@ int main(void)
                     uart_set_config(port_sel, buffer[1]);
                 break;
             }
+            case ACTION_UART_BAUD_NEGOTIATE:
+            {
+                prot_baud_negotiate(buffer, uart_baud_rate);
+                break;
+            }
+            case ACTION_STREAM_WRITE:
+            {
+                const prot_target_t *target = NULL;
+
+                if (buffer[1] == STREAM_TARGET_SPI)
+                {
+                    set_pad_spi();
+                    if (spi_flash_peripheral_init() != ERR_OK)
+                    {
+                        response_action_error(buffer, (uint32_t)SPI_FLASH_ERR_UNKNOWN_FLASH_TYPE, port_sel);
+                        break;
+                    }
+                    target = &spi_stream;
+                }
+                else if (buffer[1] == STREAM_TARGET_OTP)
+                {
+                    target = &otp_stream;
+                }
+
+                if (target == NULL)
+                {
+                    response_action_error(buffer, (uint32_t)ERR_INVAL, port_sel);
+                    break;
+                }
+
+                // The chunks are received into both halves of the buffer
+                prot_stream_write(buffer, buffer, ALLOWED_DATA_UART, target);
+                break;
+            }
             case ACTION_UART_GPIOS:
             {
                 result = validate_action_uart_gpios(buffer);
@@ -1624,45 +1839,8 @@ int main(void)
             }
             case ACTION_OTP_WRITE:
             {
-                uint32_t word2write[HW_OTP_CELL_SIZE / 4];
-                volatile size_t i;
-                unsigned int target_address = (unsigned int) address;
-                result = 0;
-
                 p = get_write_position(buffer);
-
-                for (i = 0; i < size; i += HW_OTP_CELL_SIZE)
-                {
-                    memcpy(word2write, p + i, sizeof(word2write));
-
-                    /*
-                     * OTP cell must be powered on, so we turn on the related clock.
-                     * However, the OTP LDO will not be able to sustain an infinite
-                     * amount of writes. So we keep our writes limited. Turning off the
-                     * LDO at the end of the operation ensures that we restart the
-                     * operation appropriately for the next write.
-                     */
-                    hw_otpc_init();
-                    #if defined (__DA14531__)
-                    if (word2write[0] != 0xffffffff)
-                    {
-                        result = hw_otpc_prog_and_verify((word2write), target_address >> 2, 1)? 0 : 1;
-                    }
-                    #else
-                    /* From the manual: The destination address is a word aligned address, that represents the OTP memory
-                    address. It is not an AHB bus address. The lower allowed value is 0x0000 and the maximum allowed
-                    value is 0x1FFF (8K words space). */
-                    result = hw_otpc_fifo_prog((const uint32_t *) (&word2write),
-                                               target_address >> 3,
-                                               HW_OTPC_WORD_LOW, 2, false) ? 0 : 1;
-                    #endif
-                    hw_otpc_disable();
-
-                    target_address += HW_OTP_CELL_SIZE;
-
-                    if (result != 0)
-                        break;
-                }
+                result = otp_write_cells(address, p, size);
                 response_write_action_result(buffer, result, port_sel);
                 break;
             }
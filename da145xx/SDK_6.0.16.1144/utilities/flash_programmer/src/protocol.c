@@ -0,0 +1,245 @@
+/**
+ ****************************************************************************************
+ *
+ * @file protocol.c
+ *
+ * @brief Flash programmer UART protocol engine
+ *
+ * Copyright (C) 2016-2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ ****************************************************************************************
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include "protocol.h"
+
+#ifdef USE_UART
+
+extern uint32_t crc32(uint32_t crc, const void *buf, size_t size);
+
+static uint32_t get_be32(const uint8_t *p)
+{
+    return ((uint32_t) p[0] << 24) | ((uint32_t) p[1] << 16) | ((uint32_t) p[2] << 8) | p[3];
+}
+
+static void put_be32(uint8_t *p, uint32_t value)
+{
+    p[0] = value >> 24;
+    p[1] = value >> 16;
+    p[2] = value >> 8;
+    p[3] = value;
+}
+
+/****************************************************************************************
+   ****************************** PACKET RECEPTION *****************************
+ ****************************************************************************************/
+
+void prot_rx_arm(prot_rx_t *rx, uint8_t *buf, uint16_t size)
+{
+    rx->buf = buf;
+    rx->size = size;
+    rx->len = 0;
+    rx->pos = 0;
+    rx->state = PROT_RX_HEADER;
+}
+
+uint16_t prot_rx_span(prot_rx_t *rx, uint8_t **dst)
+{
+    uint16_t offset;
+
+    switch (rx->state)
+    {
+        case PROT_RX_HEADER:
+            *dst = &rx->header[rx->pos];
+            return PROT_HEADER_SIZE - rx->pos;
+
+        case PROT_RX_DATA:
+            // The payload of a packet too long for the buffer overwrites it, and is rejected
+            offset = rx->pos % rx->size;
+            *dst = &rx->buf[offset];
+            if (rx->len - rx->pos < rx->size - offset)
+            {
+                return rx->len - rx->pos;
+            }
+            return rx->size - offset;
+
+        default:
+            return 0;
+    }
+}
+
+void prot_rx_received(prot_rx_t *rx, uint16_t count)
+{
+    rx->pos += count;
+
+    if (rx->state == PROT_RX_HEADER && rx->pos == PROT_HEADER_SIZE)
+    {
+        rx->len = (rx->header[0] << 8) | rx->header[1];
+        rx->pos = 0;
+        rx->state = PROT_RX_DATA;
+    }
+
+    if (rx->state == PROT_RX_DATA && rx->pos == rx->len)
+    {
+        rx->state = PROT_RX_DONE;
+    }
+}
+
+bool prot_rx_done(const prot_rx_t *rx)
+{
+    return rx->state == PROT_RX_DONE;
+}
+
+int32_t prot_rx_check(const prot_rx_t *rx)
+{
+    if (rx->len > rx->size || crc32(0, rx->buf, rx->len) != get_be32(&rx->header[2]))
+    {
+        return -1;
+    }
+
+    return rx->len;
+}
+
+/****************************************************************************************
+   ****************************** STREAMING WRITE *****************************
+ ****************************************************************************************/
+
+static void send_status(uint8_t status, int result)
+{
+    uint8_t reply[5];
+    uint16_t len = 1;
+
+    reply[0] = status;
+    if (status == ACTION_ERROR)
+    {
+        put_be32(&reply[1], (uint32_t) result);
+        len = 5;
+    }
+    prot_port_send(reply, len);
+}
+
+int prot_stream_write(const uint8_t *cmd, uint8_t *buffer, uint16_t size,
+                      const prot_target_t *target)
+{
+    uint16_t half = size / 2;
+    uint16_t max_chunk = (half - 1) / PROT_CHUNK_GRANULE * PROT_CHUNK_GRANULE;
+    uint32_t remaining = get_be32(&cmd[6]);
+    prot_rx_t rx[2];
+    uint8_t reply[3];
+    int cur = 0;
+    int result;
+
+    result = target->begin(get_be32(&cmd[2]), remaining);
+    if (result != ERR_OK)
+    {
+        send_status(ACTION_ERROR, result);
+        return result;
+    }
+
+    reply[0] = ACTION_CONTENTS;
+    reply[1] = max_chunk >> 8;
+    reply[2] = max_chunk;
+    prot_rx_arm(&rx[0], buffer, half);
+    prot_port_rx_start(&rx[0]);
+    prot_port_send(reply, sizeof(reply));
+
+    while (remaining)
+    {
+        uint8_t *data = rx[cur].buf + 1;
+        int32_t len;
+
+        if (!prot_port_rx_wait(&rx[cur], 0))
+        {
+            return -1;
+        }
+
+        len = prot_rx_check(&rx[cur]);
+        if (len < 0)
+        {
+            prot_rx_arm(&rx[cur], rx[cur].buf, half);
+            prot_port_rx_start(&rx[cur]);
+            send_status(ACTION_INVALID_CRC, 0);
+            continue;
+        }
+
+        len--;
+        if (len < 0 || rx[cur].buf[0] != ACTION_DATA || len > remaining ||
+            (len < remaining && (len == 0 || len % target->align)))
+        {
+            result = ERR_INVAL;
+            break;
+        }
+        remaining -= len;
+
+        // Receive the next chunk into the other half while this one is written
+        if (remaining)
+        {
+            prot_rx_arm(&rx[cur ^ 1], buffer + (cur ^ 1) * half, half);
+            prot_port_rx_start(&rx[cur ^ 1]);
+            send_status(ACTION_OK, 0);
+        }
+
+        result = target->write(data, len);
+        if (result != ERR_OK)
+        {
+            // Report the error in place of the acknowledgement of the chunk in flight
+            if (remaining && !prot_port_rx_wait(&rx[cur ^ 1], 0))
+            {
+                return -1;
+            }
+            break;
+        }
+
+        cur ^= 1;
+    }
+
+    if (result == ERR_OK)
+    {
+        result = target->end();
+    }
+
+    send_status(result == ERR_OK ? ACTION_OK : ACTION_ERROR, result);
+
+    return result;
+}
+
+/****************************************************************************************
+   ****************************** BAUD RATE NEGOTIATION *****************************
+ ****************************************************************************************/
+
+uint32_t prot_baud_negotiate(const uint8_t *cmd, uint32_t current)
+{
+    uint32_t baud = prot_port_baud_select(get_be32(&cmd[1]));
+    uint8_t confirm[8];
+    uint8_t reply[5];
+    prot_rx_t rx;
+
+    if (baud == 0)
+    {
+        send_status(ACTION_ERROR, ERR_INVAL);
+        return current;
+    }
+
+    reply[0] = ACTION_CONTENTS;
+    put_be32(&reply[1], baud);
+    prot_port_send(reply, sizeof(reply));
+    prot_port_set_baud(baud);
+
+    prot_rx_arm(&rx, confirm, sizeof(confirm));
+    prot_port_rx_start(&rx);
+    if (!prot_port_rx_wait(&rx, PROT_BAUD_CONFIRM_TIMEOUT) || prot_rx_check(&rx) != 1 ||
+        confirm[0] != ACTION_UART_BAUD_CONFIRM)
+    {
+        prot_port_set_baud(current);
+        return current;
+    }
+
+    send_status(ACTION_OK, 0);
+
+    return baud;
+}
+
+#endif // USE_UART
@@ -0,0 +1,35 @@
+/**
+ ****************************************************************************************
+ *
+ * @file host_preinclude.h
+ *
+ * @brief Host replacements of the toolchain and platform definitions the core modules
+ * get from the project preinclude file.
+ *
+ * Copyright (C) 2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ ****************************************************************************************
+ */
+
+#ifndef HOST_PREINCLUDE_H_
+#define HOST_PREINCLUDE_H_
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// There is no retention memory on the host
+#define __SECTION_ZERO(sec_name)
+#define __STATIC_INLINE         static inline
+
+#define ASSERT_ERROR(cond)      assert(cond)
+#define ASSERT_WARNING(cond)    assert(cond)
+
+// From co_bt.h
+#define KEY_LEN                 0x10
+#define ENC_DATA_LEN            0x10
+
+#endif // HOST_PREINCLUDE_H_
@@ -0,0 +1,92 @@
+/**
+ ****************************************************************************************
+ *
+ * @file bench.h
+ *
+ * @brief Host benchmark suite
+ *
+ * Copyright (C) 2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ ****************************************************************************************
+ */
+
+#ifndef BENCH_H_
+#define BENCH_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/// Benchmark definition
+typedef struct
+{
+    /// Name used to select benchmark on the command line
+    const char *name;
+    /// Runs the benchmark, scale multiplies iterations, returns the number of failed checks
+    int (*run)(uint32_t scale);
+} bench_t;
+
+/**
+ ****************************************************************************************
+ * @brief Get monotonic host time
+ * @return time in nanoseconds
+ ****************************************************************************************
+ */
+uint64_t bench_now_ns(void);
+
+/**
+ ****************************************************************************************
+ * @brief Get host CPU cycle counter
+ * @return time stamp counter on x86 hosts, 0 elsewhere
+ ****************************************************************************************
+ */
+static inline uint64_t bench_now_cycles(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __builtin_ia32_rdtsc();
+#else
+    return 0;
+#endif
+}
+
+/**
+ ****************************************************************************************
+ * @brief Print one result line
+ * @param[in] name      result name
+ * @param[in] ops       number of operations performed
+ * @param[in] ns        time spent in nanoseconds
+ * @param[in] fmt       additional printf-like information, can be NULL
+ ****************************************************************************************
+ */
+void bench_report(const char *name, uint32_t ops, uint64_t ns, const char *fmt, ...)
+                                                        __attribute__((format(printf, 4, 5)));
+
+/**
+ ****************************************************************************************
+ * @brief Print the result of a check
+ * @param[in] name      check name
+ * @param[in] ok        result
+ * @return              0 if ok, 1 otherwise
+ ****************************************************************************************
+ */
+int bench_check(const char *name, bool ok);
+
+/**
+ ****************************************************************************************
+ * @brief Get pseudo random number
+ * @return next value of a xorshift generator with a fixed seed
+ ****************************************************************************************
+ */
+uint32_t bench_rand(void);
+
+// Benchmarks
+int bench_crypto(uint32_t scale);
+int bench_boot(uint32_t scale);
+int bench_bond_db(uint32_t scale);
+int bench_timer(uint32_t scale);
+int bench_flash(uint32_t scale);
+int bench_programmer(uint32_t scale);
+int bench_nvds(uint32_t scale);
+
+#endif // BENCH_H_
@@ -0,0 +1,419 @@
+/**
+ ****************************************************************************************
+ *
+ * @file bench_bond_db.c
+ *
+ * @brief Bond database benchmark
+ *
+ * Fills the bond database (app_bond_db.c) with 8 to 200 bonded peers and checks the indexed
+ * BD address and EDIV searches and the resolvable private address cache against a linear
+ * search. Then measures lookups per second of both, and the resolution of private addresses
+ * of a few peers that keep reconnecting, with and without the cache.
+ *
+ * Copyright (C) 2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ ****************************************************************************************
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "app_bond_db.h"
+#include "aes_ttable.h"
+#include "bench.h"
+
+#define LOOKUPS_PER_RUN         (65536)
+#define RESOLVES_PER_RUN        (4096)
+#define QUERIES                 (1024)
+
+// Peers advertising and reconnecting with the same private address
+#define ACTIVE_PEERS            (APP_BOND_DB_RPA_CACHE_SIZE)
+
+static const uint8_t peer_counts[] = { 8, 32, 64, 128, 200 };
+
+// Bond data as stored, in slot order
+static struct app_sec_bond_data_env_tag peers[APP_BOND_DB_MAX_BONDED_PEERS];
+
+// IRKs as given to the controller
+static struct gap_sec_key irks[APP_BOND_DB_MAX_BONDED_PEERS];
+
+// Search keys, stored ones and unknown ones
+static uint8_t query_bda[QUERIES][BD_ADDR_LEN];
+static uint16_t query_ediv[QUERIES];
+static uint8_t miss_bda[QUERIES][BD_ADDR_LEN];
+
+static volatile uintptr_t sink;
+
+static void fill_rand(uint8_t *buf, uint32_t len)
+{
+    for (uint32_t i = 0; i < len; i++)
+    {
+        buf[i] = bench_rand();
+    }
+}
+
+static void make_peer(struct app_sec_bond_data_env_tag *p)
+{
+    memset(p, 0, sizeof(*p));
+    p->valid_keys = LTK_PRESENT | RIRK_PRESENT;
+    fill_rand(p->ltk.ltk.key, KEY_LEN);
+    p->ltk.ediv = bench_rand();
+    fill_rand(p->ltk.randnb.nb, RAND_NB_LEN);
+    p->ltk.key_size = KEY_LEN;
+    fill_rand(p->rirk.irk.key, KEY_LEN);
+    fill_rand(p->rirk.addr.addr.addr, BD_ADDR_LEN);
+    p->rirk.addr.addr.addr[5] |= 0xC0;
+    p->rirk.addr.addr_type = 1;
+    fill_rand(p->peer_bdaddr.addr.addr, BD_ADDR_LEN);
+}
+
+// Clear the database and store n peers, they end up in slots 0 to n - 1
+static void fill_db(uint8_t n)
+{
+    default_app_bdb_remove_entry(NO_SEARCH_TYPE, REMOVE_ALL, NULL, 0);
+
+    for (uint8_t i = 0; i < n; i++)
+    {
+        make_peer(&peers[i]);
+        default_app_bdb_add_entry(&peers[i]);
+        memcpy(&irks[i], &peers[i].rirk.irk, sizeof(struct gap_sec_key));
+    }
+    memset(&peers[n], 0, (APP_BOND_DB_MAX_BONDED_PEERS - n) * sizeof(peers[0]));
+}
+
+// Search as default_app_bdb_search_entry() did before the indexes, on a database of n slots
+static const struct app_sec_bond_data_env_tag *linear_search(uint8_t n, enum bdb_search_by_type search_type,
+                                                             const void *search_param,
+                                                             uint8_t search_param_length)
+{
+    for (uint8_t i = 0; i < n; i++)
+    {
+        if ((search_type == SEARCH_BY_EDIV_TYPE) &&
+            (memcmp(&peers[i].ltk.ediv, search_param, search_param_length) == 0))
+        {
+            return &peers[i];
+        }
+        else if ((search_type == SEARCH_BY_BDA_TYPE) &&
+                 (memcmp(&peers[i].peer_bdaddr.addr, search_param, search_param_length) == 0))
+        {
+            return &peers[i];
+        }
+        else if ((search_type == SEARCH_BY_IRK_TYPE) &&
+                 (memcmp(&peers[i].rirk, search_param, search_param_length) == 0))
+        {
+            return &peers[i];
+        }
+    }
+
+    return NULL;
+}
+
+// Slot of a search result, -1 if not found
+static int slot_of(const struct app_sec_bond_data_env_tag *p)
+{
+    return p ? p->bdb_slot : -1;
+}
+
+// Random address hash ah(), Bluetooth Core Vol 3 Part H 2.2.2. Keys and data are given to
+// e() most significant byte first, addresses are stored least significant byte first.
+static void rpa_hash(const struct gap_sec_key *irk, const uint8_t *prand, uint8_t *hash)
+{
+    struct aes_ttable_key key;
+    uint8_t blk[AES_TTABLE_BLK_SIZE] = { 0 };
+    uint8_t k[AES_TTABLE_KEY_SIZE];
+
+    for (int i = 0; i < AES_TTABLE_KEY_SIZE; i++)
+    {
+        k[i] = irk->key[AES_TTABLE_KEY_SIZE - 1 - i];
+    }
+    aes_ttable_set_key(&key, k);
+
+    blk[13] = prand[2];
+    blk[14] = prand[1];
+    blk[15] = prand[0];
+    aes_ttable_encrypt(&key, blk, blk);
+
+    hash[0] = blk[15];
+    hash[1] = blk[14];
+    hash[2] = blk[13];
+}
+
+static void make_rpa(const struct gap_sec_key *irk, uint8_t *rpa)
+{
+    fill_rand(&rpa[3], 3);
+    rpa[5] = (rpa[5] & 0x3F) | 0x40;
+    rpa_hash(irk, &rpa[3], rpa);
+}
+
+// Try all IRKs on an address, as the controller does for GAPM_RESOLV_ADDR_CMD
+static const struct gap_sec_key *resolve_rpa(const uint8_t *rpa, uint8_t nb_irk)
+{
+    uint8_t hash[3];
+
+    for (uint8_t i = 0; i < nb_irk; i++)
+    {
+        rpa_hash(&irks[i], &rpa[3], hash);
+        if (memcmp(hash, rpa, 3) == 0)
+        {
+            return &irks[i];
+        }
+    }
+
+    return NULL;
+}
+
+// Find the bond data of a private address, as the default handlers do
+static const struct app_sec_bond_data_env_tag *find_rpa(const uint8_t *rpa, uint8_t nb_irk, bool use_cache)
+{
+    const struct app_sec_bond_data_env_tag *pbd;
+    const struct gap_sec_key *irk;
+
+    if (use_cache)
+    {
+        pbd = default_app_bdb_search_entry(SEARCH_BY_RPA_TYPE, (void *) rpa, BD_ADDR_LEN);
+        if (pbd)
+        {
+            return pbd;
+        }
+    }
+
+    irk = resolve_rpa(rpa, nb_irk);
+    if (irk == NULL)
+    {
+        return NULL;
+    }
+
+    pbd = default_app_bdb_search_entry(SEARCH_BY_IRK_TYPE, (void *) irk, sizeof(struct gap_sec_key));
+    if (pbd && use_cache)
+    {
+        default_app_bdb_cache_rpa(rpa, pbd->bdb_slot);
+    }
+
+    return pbd;
+}
+
+// Compare the indexed searches with the linear search on every stored peer and on unknown keys
+static bool check_lookups(uint8_t n)
+{
+    bool ok = true;
+
+    for (uint8_t i = 0; i < n; i++)
+    {
+        ok &= slot_of(default_app_bdb_search_entry(SEARCH_BY_BDA_TYPE, peers[i].peer_bdaddr.addr.addr, BD_ADDR_LEN)) == i;
+        ok &= slot_of(default_app_bdb_search_entry(SEARCH_BY_EDIV_TYPE, &peers[i].ltk.ediv, sizeof(uint16_t))) ==
+              slot_of(linear_search(n, SEARCH_BY_EDIV_TYPE, &peers[i].ltk.ediv, sizeof(uint16_t)));
+        // Partial keys still work
+        ok &= slot_of(default_app_bdb_search_entry(SEARCH_BY_BDA_TYPE, peers[i].peer_bdaddr.addr.addr, 3)) ==
+              slot_of(linear_search(n, SEARCH_BY_BDA_TYPE, peers[i].peer_bdaddr.addr.addr, 3));
+        ok &= slot_of(default_app_bdb_search_entry(SEARCH_BY_IRK_TYPE, &peers[i].rirk.irk, sizeof(struct gap_sec_key))) == i;
+    }
+
+    for (int i = 0; i < QUERIES; i++)
+    {
+        ok &= slot_of(default_app_bdb_search_entry(SEARCH_BY_BDA_TYPE, miss_bda[i], BD_ADDR_LEN)) ==
+              slot_of(linear_search(n, SEARCH_BY_BDA_TYPE, miss_bda[i], BD_ADDR_LEN));
+    }
+
+    return ok;
+}
+
+// Peers with the same EDIV give the lowest slot, and the indexes follow removals and replacements
+static bool check_updates(void)
+{
+    struct app_sec_bond_data_env_tag p;
+    uint16_t ediv;
+    uint8_t slot;
+    bool ok = true;
+
+    fill_db(16);
+
+    ediv = peers[3].ltk.ediv;
+    peers[9].ltk.ediv = ediv;
+    default_app_bdb_add_entry(&peers[9]);
+    ok &= slot_of(default_app_bdb_search_entry(SEARCH_BY_EDIV_TYPE, &ediv, sizeof(ediv))) == 3;
+
+    slot = 3;
+    default_app_bdb_remove_entry(SEARCH_BY_SLOT_TYPE, REMOVE_THIS_ENTRY, &slot, sizeof(slot));
+    ok &= slot_of(default_app_bdb_search_entry(SEARCH_BY_EDIV_TYPE, &ediv, sizeof(ediv))) == 9;
+    ok &= default_app_bdb_search_entry(SEARCH_BY_BDA_TYPE, peers[3].peer_bdaddr.addr.addr, BD_ADDR_LEN) == NULL;
+
+    // The same peer bonds again with new keys, in the same slot
+    p = peers[5];
+    fill_rand(p.peer_bdaddr.addr.addr, BD_ADDR_LEN);
+    p.ltk.ediv = ~p.ltk.ediv;
+    default_app_bdb_add_entry(&p);
+    ok &= slot_of(default_app_bdb_search_entry(SEARCH_BY_BDA_TYPE, p.peer_bdaddr.addr.addr, BD_ADDR_LEN)) == 5;
+    ok &= slot_of(default_app_bdb_search_entry(SEARCH_BY_EDIV_TYPE, &p.ltk.ediv, sizeof(uint16_t))) == 5;
+    ok &= default_app_bdb_search_entry(SEARCH_BY_BDA_TYPE, peers[5].peer_bdaddr.addr.addr, BD_ADDR_LEN) == NULL;
+
+    // The freed slot is reused
+    make_peer(&p);
+    default_app_bdb_add_entry(&p);
+    ok &= slot_of(default_app_bdb_search_entry(SEARCH_BY_BDA_TYPE, p.peer_bdaddr.addr.addr, BD_ADDR_LEN)) == 3;
+
+    return ok;
+}
+
+// Addresses are found once resolved, the least recently used one is dropped, and the addresses
+// of removed or replaced slots are dropped
+static bool check_rpa_cache(void)
+{
+    uint8_t rpa[APP_BOND_DB_RPA_CACHE_SIZE + 1][BD_ADDR_LEN];
+    struct app_sec_bond_data_env_tag p;
+    uint8_t slot;
+    bool ok = true;
+
+    fill_db(32);
+
+    for (int i = 0; i <= APP_BOND_DB_RPA_CACHE_SIZE; i++)
+    {
+        make_rpa(&irks[i], rpa[i]);
+        ok &= default_app_bdb_search_entry(SEARCH_BY_RPA_TYPE, rpa[i], BD_ADDR_LEN) == NULL;
+        ok &= slot_of(find_rpa(rpa[i], 32, true)) == i;
+        ok &= slot_of(default_app_bdb_search_entry(SEARCH_BY_RPA_TYPE, rpa[i], BD_ADDR_LEN)) == i;
+        // Keep the first address in use
+        ok &= slot_of(default_app_bdb_search_entry(SEARCH_BY_RPA_TYPE, rpa[0], BD_ADDR_LEN)) == 0;
+    }
+    ok &= default_app_bdb_search_entry(SEARCH_BY_RPA_TYPE, rpa[1], BD_ADDR_LEN) == NULL;
+
+    slot = 2;
+    default_app_bdb_remove_entry(SEARCH_BY_SLOT_TYPE, REMOVE_THIS_ENTRY, &slot, sizeof(slot));
+    ok &= default_app_bdb_search_entry(SEARCH_BY_RPA_TYPE, rpa[2], BD_ADDR_LEN) == NULL;
+
+    p = peers[4];
+    fill_rand(p.ltk.ltk.key, KEY_LEN);
+    default_app_bdb_add_entry(&p);
+    ok &= default_app_bdb_search_entry(SEARCH_BY_RPA_TYPE, rpa[4], BD_ADDR_LEN) == NULL;
+    ok &= slot_of(default_app_bdb_search_entry(SEARCH_BY_RPA_TYPE, rpa[5], BD_ADDR_LEN)) == 5;
+
+    // Unknown addresses are not cached
+    default_app_bdb_cache_rpa(rpa[2], 2);
+    ok &= default_app_bdb_search_entry(SEARCH_BY_RPA_TYPE, rpa[2], BD_ADDR_LEN) == NULL;
+
+    return ok;
+}
+
+// Time n lookups of one search type, with the database or the linear search
+static uint64_t time_lookups(uint8_t n, enum bdb_search_by_type type, bool indexed, bool miss, uint32_t ops)
+{
+    uintptr_t acc = 0;
+    uint64_t t0 = bench_now_ns();
+
+    for (uint32_t i = 0; i < ops; i++)
+    {
+        const void *key;
+        uint8_t len;
+
+        if (type == SEARCH_BY_EDIV_TYPE)
+        {
+            key = &query_ediv[i % QUERIES];
+            len = sizeof(uint16_t);
+        }
+        else
+        {
+            key = miss ? miss_bda[i % QUERIES] : query_bda[i % QUERIES];
+            len = BD_ADDR_LEN;
+        }
+
+        if (indexed)
+        {
+            acc += (uintptr_t) default_app_bdb_search_entry(type, (void *) key, len);
+        }
+        else
+        {
+            acc += (uintptr_t) linear_search(n, type, key, len);
+        }
+    }
+    sink = acc;
+
+    return bench_now_ns() - t0;
+}
+
+// Time the resolution of the private addresses of the peers that keep reconnecting
+static uint64_t time_resolves(uint8_t n, uint8_t (*rpa)[BD_ADDR_LEN], bool use_cache, uint32_t ops)
+{
+    uintptr_t acc = 0;
+    uint64_t t0 = bench_now_ns();
+
+    for (uint32_t i = 0; i < ops; i++)
+    {
+        acc += (uintptr_t) find_rpa(rpa[bench_rand() % ACTIVE_PEERS], n, use_cache);
+    }
+    sink = acc;
+
+    return bench_now_ns() - t0;
+}
+
+int bench_bond_db(uint32_t scale)
+{
+    uint8_t rpa[ACTIVE_PEERS][BD_ADDR_LEN];
+    uint32_t lookups = LOOKUPS_PER_RUN * scale;
+    uint32_t resolves = RESOLVES_PER_RUN * scale;
+    int failed = 0;
+    bool ok = true;
+
+    default_app_bdb_init();
+
+    for (int i = 0; i < QUERIES; i++)
+    {
+        fill_rand(miss_bda[i], BD_ADDR_LEN);
+    }
+
+    for (size_t k = 0; k < sizeof(peer_counts); k++)
+    {
+        fill_db(peer_counts[k]);
+        ok &= check_lookups(peer_counts[k]);
+    }
+    failed += bench_check("index vs linear search", ok);
+    failed += bench_check("index updates", check_updates());
+    failed += bench_check("rpa cache", check_rpa_cache());
+
+    for (size_t k = 0; k < sizeof(peer_counts); k++)
+    {
+        uint8_t n = peer_counts[k];
+        char name[40];
+        uint64_t ns, ns_ref;
+        bool found = true;
+
+        fill_db(n);
+        for (int i = 0; i < QUERIES; i++)
+        {
+            uint8_t j = bench_rand() % n;
+
+            memcpy(query_bda[i], peers[j].peer_bdaddr.addr.addr, BD_ADDR_LEN);
+            query_ediv[i] = peers[j].ltk.ediv;
+        }
+
+        ns = time_lookups(n, SEARCH_BY_BDA_TYPE, true, false, lookups);
+        ns_ref = time_lookups(n, SEARCH_BY_BDA_TYPE, false, false, lookups);
+        snprintf(name, sizeof(name), "bda, %u peers", n);
+        bench_report(name, lookups, ns, "linear %.0f ops/s, x%.1f", lookups * 1e9 / ns_ref, (double) ns_ref / ns);
+
+        ns = time_lookups(n, SEARCH_BY_BDA_TYPE, true, true, lookups);
+        ns_ref = time_lookups(n, SEARCH_BY_BDA_TYPE, false, true, lookups);
+        snprintf(name, sizeof(name), "unknown bda, %u peers", n);
+        bench_report(name, lookups, ns, "linear %.0f ops/s, x%.1f", lookups * 1e9 / ns_ref, (double) ns_ref / ns);
+
+        ns = time_lookups(n, SEARCH_BY_EDIV_TYPE, true, false, lookups);
+        ns_ref = time_lookups(n, SEARCH_BY_EDIV_TYPE, false, false, lookups);
+        snprintf(name, sizeof(name), "ediv, %u peers", n);
+        bench_report(name, lookups, ns, "linear %.0f ops/s, x%.1f", lookups * 1e9 / ns_ref, (double) ns_ref / ns);
+
+        // The reconnecting peers are spread over the database
+        for (int i = 0; i < ACTIVE_PEERS; i++)
+        {
+            make_rpa(&irks[(i * n) / ACTIVE_PEERS], rpa[i]);
+            found &= slot_of(find_rpa(rpa[i], n, false)) == (i * n) / ACTIVE_PEERS;
+        }
+        failed += bench_check("rpa resolution", found);
+
+        ns = time_resolves(n, rpa, true, resolves);
+        ns_ref = time_resolves(n, rpa, false, resolves);
+        snprintf(name, sizeof(name), "rpa, %u peers", n);
+        bench_report(name, resolves, ns, "%u active, IRK scan %.0f ops/s, x%.1f", ACTIVE_PEERS,
+                     resolves * 1e9 / ns_ref, (double) ns_ref / ns);
+    }
+
+    return failed;
+}
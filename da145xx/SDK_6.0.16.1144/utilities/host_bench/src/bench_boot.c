@@ -0,0 +1,309 @@
+/**
+ ****************************************************************************************
+ *
+ * @file bench_boot.c
+ *
+ * @brief Secondary bootloader image loading benchmark
+ *
+ * Runs the secondary bootloader (utilities/secondary_bootloader) on flash images written to
+ * a file and loaded by the SPI flash model, and checks that the loaded image is the expected
+ * one. The same images are also loaded in separate read, decrypt and CRC passes, as the
+ * bootloader used to do, to compare the modelled boot time.
+ *
+ * Copyright (C) 2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ ****************************************************************************************
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "bootloader.h"
+#include "decrypt.h"
+#include "spi_flash.h"
+#include "spi_flash_sim.h"
+#include "sw_aes.h"
+#include "uart_booter.h"
+#include "user_periph_setup.h"
+#include "bench.h"
+
+#define BANK1_POSITION          (0x00000)
+#define BANK2_POSITION          (0x1C000)
+
+uint8_t host_sysram[MAX_CODE_LENGTH_SPI];
+
+extern uint32_t crc32(uint32_t crc, const void *buf, size_t size);
+extern const uint8_t Key[16];
+extern const uint8_t IV[16];
+
+// DA14585 at 16 MHz with the SPI at 8 MHz. The CPU costs are estimates for the Cortex-M0:
+// table driven CRC32 and the byte oriented sw_aes.c decryption.
+static const spi_flash_sim_cost_t cost =
+{
+    .spi_byte = 16,
+    .spi_command = 80,
+    .dma_setup = 40,
+    .crc_byte = 11,
+    .aes_block = 4400,
+};
+
+// Bank contents
+typedef struct
+{
+    uint32_t size;
+    uint8_t id;
+    bool encrypted;
+    bool corrupted;
+} bank_t;
+
+static uint8_t flash_image[SPI_FLASH_DEV_SIZE];
+static uint8_t plain[2][MAX_CODE_LENGTH_SPI];
+
+static void put32(uint8_t *p, uint32_t v)
+{
+    memcpy(p, &v, sizeof(v));
+}
+
+// Build a flash image with the product header and up to two images of random contents
+static void build_flash(const bank_t *bank1, const bank_t *bank2)
+{
+    const bank_t *banks[2] = { bank1, bank2 };
+    const uint32_t positions[2] = { BANK1_POSITION, BANK2_POSITION };
+    s_productHeader *ph = (s_productHeader *) &flash_image[PRODUCT_HEADER_POSITION];
+
+    memset(flash_image, 0xFF, sizeof(flash_image));
+    ph->signature[0] = PRODUCT_HEADER_SIGNATURE1;
+    ph->signature[1] = PRODUCT_HEADER_SIGNATURE2;
+    put32((uint8_t *) &ph->offset1, BANK1_POSITION);
+    put32((uint8_t *) &ph->offset2, BANK2_POSITION);
+
+    for (int b = 0; b < 2; b++)
+    {
+        const bank_t *bank = banks[b];
+        s_imageHeader *ih = (s_imageHeader *) &flash_image[positions[b]];
+        uint8_t *code = &flash_image[positions[b] + CODE_OFFSET];
+        uint32_t crc;
+
+        if (!bank)
+        {
+            continue;
+        }
+
+        for (uint32_t i = 0; i < bank->size; i++)
+        {
+            plain[b][i] = bench_rand();
+        }
+        crc = crc32(0, plain[b], bank->size);
+        memcpy(code, plain[b], bank->size);
+
+        if (bank->encrypted)
+        {
+            AES_CTX ctx;
+
+            AES_set_key(&ctx, Key, IV, AES_MODE_128);
+            AES_cbc_encrypt(&ctx, code, code, bank->size);
+        }
+        if (bank->corrupted)
+        {
+            code[bank->size / 2] ^= 0x01;
+        }
+
+        memset(ih, 0, sizeof(*ih));
+        ih->signature[0] = IMAGE_HEADER_SIGNATURE1;
+        ih->signature[1] = IMAGE_HEADER_SIGNATURE2;
+        ih->validflag = STATUS_VALID_IMAGE;
+        ih->imageid = bank->id;
+        ih->code_size = bank->size;
+        ih->CRC = crc;
+        ih->encryption = bank->encrypted;
+    }
+}
+
+// Write the flash image to a file and load it in the flash model
+static int load_flash(void)
+{
+    char path[] = "/tmp/host_bench_flash_XXXXXX";
+    int fd = mkstemp(path);
+    int ret = -1;
+
+    if (fd >= 0)
+    {
+        if (write(fd, flash_image, sizeof(flash_image)) == sizeof(flash_image))
+        {
+            ret = spi_flash_sim_load(path);
+        }
+        close(fd);
+        unlink(path);
+    }
+
+    return ret;
+}
+
+// The previous loader: whole image read, then decrypted, then the CRC computed
+static int legacy_load_image(uint32_t position, uint32_t codesize, uint8_t encryption,
+                             uint32_t crc_image)
+{
+    uint32_t actual;
+
+    spi_flash_read_data_dma(host_sysram, position + CODE_OFFSET, codesize, &actual);
+    if (encryption)
+    {
+        Decrypt_Image(codesize);
+    }
+
+    return (crc_image == crc32(0, host_sysram, codesize)) ? 0 : -1;
+}
+
+// Header parsing and bank selection of loadActiveImage(), on top of legacy_load_image()
+static int legacy_load_active_image(void)
+{
+    uint8_t buf[64];
+    s_productHeader ph;
+    s_imageHeader ih[2];
+    uint32_t positions[2];
+    uint32_t actual;
+    int valid[2];
+    int first;
+
+    spi_flash_read_data_dma(buf, PRODUCT_HEADER_POSITION, sizeof(ph), &actual);
+    memcpy(&ph, buf, sizeof(ph));
+    if (ph.signature[0] != PRODUCT_HEADER_SIGNATURE1 ||
+        ph.signature[1] != PRODUCT_HEADER_SIGNATURE2)
+    {
+        return -1;
+    }
+    positions[0] = ph.offset1;
+    positions[1] = ph.offset2;
+
+    for (int b = 0; b < 2; b++)
+    {
+        spi_flash_read_data_dma(buf, positions[b], sizeof(ih[b]), &actual);
+        memcpy(&ih[b], buf, sizeof(ih[b]));
+        valid[b] = ih[b].validflag == STATUS_VALID_IMAGE &&
+                   ih[b].signature[0] == IMAGE_HEADER_SIGNATURE1 &&
+                   ih[b].signature[1] == IMAGE_HEADER_SIGNATURE2;
+    }
+
+    if (!valid[0] && !valid[1])
+    {
+        return 0;
+    }
+    first = (valid[0] && valid[1]) ? (ih[0].imageid >= ih[1].imageid ? 0 : 1) : (valid[0] ? 0 : 1);
+
+    if (legacy_load_image(positions[first], ih[first].code_size, ih[first].encryption,
+                          ih[first].CRC) != 0 && valid[!first])
+    {
+        return legacy_load_image(positions[!first], ih[!first].code_size,
+                                 ih[!first].encryption, ih[!first].CRC);
+    }
+
+    return 0;
+}
+
+// Load with both loaders, check the result and report the modelled time per KiB
+static int run_case(const char *name, const uint8_t *expected, uint32_t size, uint32_t scale)
+{
+    static uint8_t legacy[MAX_CODE_LENGTH_SPI];
+    uint64_t legacy_cycles, cycles, ns;
+    int legacy_ret, ret = -1;
+    int failed = 0;
+    char line[64];
+
+    spi_flash_sim_reset(&cost);
+    memset(host_sysram, 0, sizeof(host_sysram));
+    legacy_ret = legacy_load_active_image();
+    legacy_cycles = spi_flash_sim_cycles();
+    memcpy(legacy, host_sysram, size);
+
+    ns = bench_now_ns();
+    for (uint32_t i = 0; i < scale; i++)
+    {
+        spi_flash_sim_reset(&cost);
+        memset(host_sysram, 0, sizeof(host_sysram));
+        ret = spi_loadActiveImage();
+    }
+    ns = bench_now_ns() - ns;
+    cycles = spi_flash_sim_cycles();
+
+    snprintf(line, sizeof(line), "%s", name);
+    if (expected)
+    {
+        failed += bench_check(line, !ret && !memcmp(host_sysram, expected, size));
+    }
+    else
+    {
+        failed += bench_check(line, ret == legacy_ret && !memcmp(host_sysram, legacy, size));
+    }
+
+    bench_report("  single pass (host time)", scale, ns,
+                 "%8.0f cycles/KiB modelled, %.0f before (%.2fx)",
+                 cycles * 1024.0 / size, legacy_cycles * 1024.0 / size,
+                 (double) legacy_cycles / cycles);
+
+    return failed;
+}
+
+int bench_boot(uint32_t scale)
+{
+    const spi_flash_cfg_t flash_cfg =
+    {
+        .dev_index = W25X20CL_DEV_INDEX,
+        .jedec_id = W25X20CL_JEDEC_ID,
+        .chip_size = SPI_FLASH_DEV_SIZE,
+    };
+    const char *user_image = getenv("HOST_BENCH_FLASH_IMAGE");
+    int failed = 0;
+
+    spi_flash_configure_env(&flash_cfg);
+
+    {
+        bank_t b1 = { .size = 32 * 1024, .id = 1 };
+
+        build_flash(&b1, NULL);
+        load_flash();
+        failed += run_case("plain 32 KiB", plain[0], b1.size, scale);
+    }
+
+    {
+        bank_t b1 = { .size = 70001, .id = 1 };
+
+        build_flash(&b1, NULL);
+        load_flash();
+        failed += run_case("plain 70001 bytes", plain[0], b1.size, scale);
+    }
+
+    {
+        bank_t b1 = { .size = 32 * 1024, .id = 1, .encrypted = true };
+
+        build_flash(&b1, NULL);
+        load_flash();
+        failed += run_case("encrypted 32 KiB", plain[0], b1.size, scale);
+    }
+
+    {
+        bank_t b1 = { .size = 48 * 1024, .id = 2, .encrypted = true, .corrupted = true };
+        bank_t b2 = { .size = 40 * 1024 + 16, .id = 1, .encrypted = true };
+
+        build_flash(&b1, &b2);
+        load_flash();
+        failed += run_case("newer image corrupted, fallback", plain[1], b2.size, scale);
+    }
+
+    if (user_image)
+    {
+        if (spi_flash_sim_load(user_image))
+        {
+            failed += bench_check(user_image, false);
+        }
+        else
+        {
+            // Compare both loaders on the whole SYSRAM
+            failed += run_case(user_image, NULL, sizeof(host_sysram), scale);
+        }
+    }
+
+    return failed;
+}
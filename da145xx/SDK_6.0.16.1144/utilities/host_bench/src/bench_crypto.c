@@ -0,0 +1,373 @@
+/**
+ ****************************************************************************************
+ *
+ * @file bench_crypto.c
+ *
+ * @brief AES, AES-CCM and AES-CMAC benchmark
+ *
+ * Checks the word oriented cipher (aes_ttable.h) and the CCM and CMAC modes built on it
+ * against the NIST example vectors and against the byte oriented cipher (sw_aes.h), then
+ * measures host cycles per byte of each.
+ *
+ * Copyright (C) 2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ ****************************************************************************************
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "aes_ttable.h"
+#include "aes_ccm.h"
+#include "aes_cmac.h"
+#include "aes_cbc.h"
+#include "aes_api.h"
+#include "sw_aes.h"
+#include "bench.h"
+
+#define BLOCKS_PER_RUN          (4096)
+
+// FIPS-197 Appendix C.1
+static const uint8_t fips_key[16] =
+{
+    0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f
+};
+static const uint8_t fips_pt[16] =
+{
+    0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff
+};
+static const uint8_t fips_ct[16] =
+{
+    0x69, 0xc4, 0xe0, 0xd8, 0x6a, 0x7b, 0x04, 0x30, 0xd8, 0xcd, 0xb7, 0x80, 0x70, 0xb4, 0xc5, 0x5a
+};
+
+// NIST SP 800-38C Appendix C, Examples 1-3
+static const uint8_t ccm_key[16] =
+{
+    0x40, 0x41, 0x42, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48, 0x49, 0x4a, 0x4b, 0x4c, 0x4d, 0x4e, 0x4f
+};
+
+static const uint8_t ccm_ct1[] =
+{
+    0x71, 0x62, 0x01, 0x5b, 0x4d, 0xac, 0x25, 0x5d
+};
+static const uint8_t ccm_ct2[] =
+{
+    0xd2, 0xa1, 0xf0, 0xe0, 0x51, 0xea, 0x5f, 0x62, 0x08, 0x1a, 0x77, 0x92, 0x07, 0x3d, 0x59, 0x3d,
+    0x1f, 0xc6, 0x4f, 0xbf, 0xac, 0xcd
+};
+static const uint8_t ccm_ct3[] =
+{
+    0xe3, 0xb2, 0x01, 0xa9, 0xf5, 0xb7, 0x1a, 0x7a, 0x9b, 0x1c, 0xea, 0xec, 0xcd, 0x97, 0xe7, 0x0b,
+    0x61, 0x76, 0xaa, 0xd9, 0xa4, 0x42, 0x8a, 0xa5, 0x48, 0x43, 0x92, 0xfb, 0xc1, 0xb0, 0x99, 0x51
+};
+
+static const struct
+{
+    uint8_t t, n, a_len, p_len;
+    const uint8_t *ct;
+} ccm_vectors[] =
+{
+    { AES_CCM_T4,  AES_CCM_N7,  8,  4,  ccm_ct1 },
+    { AES_CCM_T6,  AES_CCM_N8,  16, 16, ccm_ct2 },
+    { AES_CCM_T8,  AES_CCM_N12, 20, 24, ccm_ct3 },
+};
+
+// NIST SP 800-38B Appendix D.1
+static const uint8_t cmac_key[16] =
+{
+    0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6, 0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c
+};
+static const uint8_t cmac_msg[64] =
+{
+    0x6b, 0xc1, 0xbe, 0xe2, 0x2e, 0x40, 0x9f, 0x96, 0xe9, 0x3d, 0x7e, 0x11, 0x73, 0x93, 0x17, 0x2a,
+    0xae, 0x2d, 0x8a, 0x57, 0x1e, 0x03, 0xac, 0x9c, 0x9e, 0xb7, 0x6f, 0xac, 0x45, 0xaf, 0x8e, 0x51,
+    0x30, 0xc8, 0x1c, 0x46, 0xa3, 0x5c, 0xe4, 0x11, 0xe5, 0xfb, 0xc1, 0x19, 0x1a, 0x0a, 0x52, 0xef,
+    0xf6, 0x9f, 0x24, 0x45, 0xdf, 0x4f, 0x9b, 0x17, 0xad, 0x2b, 0x41, 0x7b, 0xe6, 0x6c, 0x37, 0x10
+};
+static const struct
+{
+    uint8_t len;
+    uint8_t mac[16];
+} cmac_vectors[] =
+{
+    { 0,  { 0xbb, 0x1d, 0x69, 0x29, 0xe9, 0x59, 0x37, 0x28,
+            0x7f, 0xa3, 0x7d, 0x12, 0x9b, 0x75, 0x67, 0x46 } },
+    { 16, { 0x07, 0x0a, 0x16, 0xb4, 0x6b, 0x4d, 0x41, 0x44,
+            0xf7, 0x9b, 0xdd, 0x9d, 0xd0, 0x4a, 0x28, 0x7c } },
+    { 40, { 0xdf, 0xa6, 0x67, 0x47, 0xde, 0x9a, 0xe6, 0x30,
+            0x30, 0xca, 0x32, 0x61, 0x14, 0x97, 0xc8, 0x27 } },
+    { 64, { 0x51, 0xf0, 0xbe, 0xbf, 0x7e, 0x3b, 0x9d, 0x92,
+            0xfc, 0x49, 0x74, 0x17, 0x79, 0x36, 0x3c, 0xfe } },
+};
+
+// Byte pattern of the CCM examples: nonce 0x10.., adata 0x00.., payload 0x20..
+static void fill_seq(uint8_t *buf, uint8_t start, uint32_t len)
+{
+    for (uint32_t i = 0; i < len; i++)
+    {
+        buf[i] = start + i;
+    }
+}
+
+static void fill_rand(uint8_t *buf, uint32_t len)
+{
+    for (uint32_t i = 0; i < len; i++)
+    {
+        buf[i] = bench_rand();
+    }
+}
+
+// Encrypt a block with the byte oriented cipher
+static void sw_aes_encrypt(const AES_CTX *ctx, const uint8_t *in, uint8_t *out)
+{
+    uint32_t temp[4];
+
+    for (int j = 0; j < 16; j += 4)
+    {
+        temp[j / 4] = GETU32(&in[j]);
+    }
+    AES_encrypt(ctx, temp);
+    for (int j = 0; j < 16; j += 4)
+    {
+        PUTU32(&out[j], temp[j / 4]);
+    }
+}
+
+// Run the CCM examples, in one piece and in random pieces, and check tamper detection
+static int check_ccm(void)
+{
+    int failed = 0;
+
+    for (size_t v = 0; v < sizeof(ccm_vectors) / sizeof(ccm_vectors[0]); v++)
+    {
+        uint8_t t = ccm_vectors[v].t;
+        uint8_t n = ccm_vectors[v].n;
+        uint8_t a_len = ccm_vectors[v].a_len;
+        uint8_t p_len = ccm_vectors[v].p_len;
+        uint8_t nonce[16], adata[32], payload[32], out[48], plain[32];
+        struct aes_ccm_ctx ctx;
+        char name[40];
+        bool ok;
+
+        fill_seq(nonce, 0x10, n);
+        fill_seq(adata, 0x00, a_len);
+        fill_seq(payload, 0x20, p_len);
+
+        // Legacy API
+        aes_ccm_init((uint8_t *) ccm_key, t, n, 0);
+        aes_ccm_encrypt(payload, p_len, nonce, adata, a_len, out);
+        snprintf(name, sizeof(name), "ccm example %u encrypt", (unsigned) v + 1);
+        failed += bench_check(name, !memcmp(out, ccm_vectors[v].ct, p_len + t));
+
+        ok = !aes_ccm_decrypt(out, p_len + t, nonce, adata, a_len, plain) &&
+             !memcmp(plain, payload, p_len);
+        snprintf(name, sizeof(name), "ccm example %u decrypt", (unsigned) v + 1);
+        failed += bench_check(name, ok);
+
+        out[bench_rand() % (p_len + t)] ^= 1 << (bench_rand() % 8);
+        memset(plain, 0xa5, sizeof(plain));
+        ok = aes_ccm_decrypt(out, p_len + t, nonce, adata, a_len, plain);
+        for (uint8_t i = 0; i < p_len; i++)
+        {
+            ok &= !plain[i];
+        }
+        snprintf(name, sizeof(name), "ccm example %u tampered", (unsigned) v + 1);
+        failed += bench_check(name, ok);
+        aes_ccm_cleanup();
+
+        // Streaming API, random pieces, in place
+        ok = true;
+        for (int r = 0; r < 100; r++)
+        {
+            uint32_t pos;
+
+            aes_ccm_ctx_init(&ctx, ccm_key, t, n);
+            aes_ccm_start(&ctx, nonce, a_len, p_len);
+            for (pos = 0; pos < a_len; )
+            {
+                uint32_t len = 1 + bench_rand() % (a_len - pos);
+
+                aes_ccm_adata(&ctx, &adata[pos], len);
+                pos += len;
+            }
+            memcpy(out, payload, p_len);
+            for (pos = 0; pos < p_len; )
+            {
+                uint32_t len = 1 + bench_rand() % (p_len - pos);
+
+                aes_ccm_encrypt_update(&ctx, &out[pos], &out[pos], len);
+                pos += len;
+            }
+            aes_ccm_get_tag(&ctx, &out[p_len]);
+            ok &= !memcmp(out, ccm_vectors[v].ct, p_len + t);
+
+            aes_ccm_start(&ctx, nonce, a_len, p_len);
+            aes_ccm_adata(&ctx, adata, a_len);
+            for (pos = 0; pos < p_len; )
+            {
+                uint32_t len = 1 + bench_rand() % (p_len - pos);
+
+                aes_ccm_decrypt_update(&ctx, &out[pos], &out[pos], len);
+                pos += len;
+            }
+            ok &= !aes_ccm_check_tag(&ctx, &out[p_len]) && !memcmp(out, payload, p_len);
+        }
+        snprintf(name, sizeof(name), "ccm example %u streaming", (unsigned) v + 1);
+        failed += bench_check(name, ok);
+    }
+
+    return failed;
+}
+
+// Run the CMAC examples with the one shot and the streaming API
+static int check_cmac(void)
+{
+    int failed = 0;
+
+    for (size_t v = 0; v < sizeof(cmac_vectors) / sizeof(cmac_vectors[0]); v++)
+    {
+        uint8_t len = cmac_vectors[v].len;
+        uint8_t mac[16], bad[16];
+        struct aes_cmac_ctx ctx;
+        char name[40];
+        bool ok;
+
+        ok = (aes_cmac_generate(cmac_msg, len, cmac_key, mac, sizeof(mac)) == AES_CBC_ERR_NO_ERR) &&
+             !memcmp(mac, cmac_vectors[v].mac, sizeof(mac));
+        ok &= aes_cmac_verify(cmac_msg, len, cmac_key, cmac_vectors[v].mac, 4);
+        memcpy(bad, cmac_vectors[v].mac, sizeof(bad));
+        bad[bench_rand() % sizeof(bad)] ^= 0x80;
+        ok &= !aes_cmac_verify(cmac_msg, len, cmac_key, bad, sizeof(bad));
+
+        for (int r = 0; r < 100; r++)
+        {
+            uint32_t pos = 0;
+
+            aes_cmac_start(&ctx, cmac_key);
+            while (pos < len)
+            {
+                uint32_t chunk = 1 + bench_rand() % (len - pos);
+
+                aes_cmac_update(&ctx, &cmac_msg[pos], chunk);
+                pos += chunk;
+            }
+            aes_cmac_finish(&ctx, mac, sizeof(mac));
+            ok &= !memcmp(mac, cmac_vectors[v].mac, sizeof(mac));
+        }
+
+        snprintf(name, sizeof(name), "cmac example %u (%u bytes)", (unsigned) v + 1, len);
+        failed += bench_check(name, ok);
+    }
+
+    return failed;
+}
+
+static void report_cpb(const char *name, uint32_t bytes, uint64_t ns, uint64_t cycles)
+{
+    if (cycles)
+    {
+        bench_report(name, bytes / 16, ns, "%7.1f cycles/byte", (double) cycles / bytes);
+    }
+    else
+    {
+        bench_report(name, bytes / 16, ns, "%7.2f ns/byte", (double) ns / bytes);
+    }
+}
+
+int bench_crypto(uint32_t scale)
+{
+    static uint8_t buf[BLOCKS_PER_RUN * 16];
+    uint32_t blocks = BLOCKS_PER_RUN * scale;
+    struct aes_ttable_key tkey;
+    AES_CTX sw_ctx;
+    uint8_t key[16], blk[16], ref[16], iv[16] = {0};
+    uint64_t ns, cycles;
+    int failed = 0;
+    bool ok;
+
+    // Cipher
+    aes_ttable_set_key(&tkey, fips_key);
+    aes_ttable_encrypt(&tkey, fips_pt, blk);
+    failed += bench_check("aes fips-197 c.1", !memcmp(blk, fips_ct, 16));
+
+    ok = true;
+    for (int r = 0; r < 1000; r++)
+    {
+        fill_rand(key, sizeof(key));
+        fill_rand(blk, sizeof(blk));
+        AES_set_key(&sw_ctx, key, iv, AES_MODE_128);
+        sw_aes_encrypt(&sw_ctx, blk, ref);
+        aes_ttable_set_key(&tkey, key);
+        aes_ttable_encrypt(&tkey, blk, blk);
+        ok &= !memcmp(blk, ref, 16);
+    }
+    failed += bench_check("aes random keys vs sw_aes", ok);
+
+    failed += check_ccm();
+    failed += check_cmac();
+
+    fill_rand(buf, sizeof(buf));
+    fill_rand(key, sizeof(key));
+    AES_set_key(&sw_ctx, key, iv, AES_MODE_128);
+    aes_ttable_set_key(&tkey, key);
+
+    // Block cipher alone, key expanded once
+    ns = bench_now_ns();
+    cycles = bench_now_cycles();
+    for (uint32_t i = 0; i < blocks; i++)
+    {
+        uint8_t *p = &buf[(i % BLOCKS_PER_RUN) * 16];
+
+        sw_aes_encrypt(&sw_ctx, p, p);
+    }
+    report_cpb("sw_aes encrypt", blocks * 16, bench_now_ns() - ns, bench_now_cycles() - cycles);
+
+    ns = bench_now_ns();
+    cycles = bench_now_cycles();
+    for (uint32_t i = 0; i < blocks; i++)
+    {
+        uint8_t *p = &buf[(i % BLOCKS_PER_RUN) * 16];
+
+        aes_ttable_encrypt(&tkey, p, p);
+    }
+    report_cpb("aes_ttable encrypt", blocks * 16, bench_now_ns() - ns,
+               bench_now_cycles() - cycles);
+
+    // CBC-MAC of 256 byte messages, key set per block as aes_cbc.c does
+    ns = bench_now_ns();
+    cycles = bench_now_cycles();
+    for (uint32_t i = 0; i < blocks; i += 16)
+    {
+        aes_cbc_encrypt(&buf[(i % BLOCKS_PER_RUN) * 16], 16, blk, 1, key, 16, NULL);
+    }
+    report_cpb("aes_cbc cbc-mac (host model)", blocks * 16, bench_now_ns() - ns,
+               bench_now_cycles() - cycles);
+
+    // CMAC and CCM of 256 byte messages
+    ns = bench_now_ns();
+    cycles = bench_now_cycles();
+    for (uint32_t i = 0; i < blocks; i += 16)
+    {
+        aes_cmac_generate(&buf[(i % BLOCKS_PER_RUN) * 16], 256, key, blk, 16);
+    }
+    report_cpb("aes_cmac 256 bytes", blocks * 16, bench_now_ns() - ns,
+               bench_now_cycles() - cycles);
+
+    aes_ccm_init(key, AES_CCM_T4, AES_CCM_N13, 0);
+    ns = bench_now_ns();
+    cycles = bench_now_cycles();
+    for (uint32_t i = 0; i < blocks; i += 16)
+    {
+        uint8_t *p = &buf[(i % BLOCKS_PER_RUN) * 16];
+        static uint8_t out[256 + 16];
+
+        aes_ccm_encrypt(p, 256 - 13, p + 243, NULL, 0, out);
+    }
+    report_cpb("aes_ccm 243 bytes", blocks * 16, bench_now_ns() - ns,
+               bench_now_cycles() - cycles);
+    aes_ccm_cleanup();
+
+    return failed;
+}
@@ -0,0 +1,290 @@
+/**
+ ****************************************************************************************
+ *
+ * @file bench_flash.c
+ *
+ * @brief SPI flash burst writer benchmark
+ *
+ * Writes regions of the flash model, whose previous contents are random, through the SDK SPI
+ * flash driver: once as the applications do it today (sector erases, then
+ * spi_flash_write_data_dma() for every chunk of data as it becomes available) and once with
+ * the burst writer (spi_flash_burst_start(), spi_flash_burst_write() for every chunk,
+ * spi_flash_burst_finish()). Preparing each chunk costs CPU time (receiving it, decrypting it,
+ * ...), which the burst writer overlaps with the programs and erases of the flash.
+ *
+ * Checks the flash contents and the protocol of both, and that the erases of the burst writer
+ * cover the region exactly, in order, each one aligned to its size. Reports the modelled time
+ * of both and the erase commands used.
+ *
+ * Copyright (C) 2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ ****************************************************************************************
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "spi_flash.h"
+#include "spi_flash_sim.h"
+#include "user_periph_setup.h"
+#include "bench.h"
+
+#define CYCLES_PER_MS           (16000)
+#define MAX_ERASES              (SPI_FLASH_DEV_SIZE / SPI_FLASH_SECTOR_SIZE)
+
+// DA14585 at 16 MHz with the SPI at 8 MHz, typical MX25R2035F program and erase times
+static const spi_flash_sim_cost_t cost =
+{
+    .spi_byte = 16,
+    .spi_command = 80,
+    .dma_setup = 40,
+    .page_program = 850 * CYCLES_PER_MS / 1000,
+    .sector_erase = 40 * CYCLES_PER_MS,
+    .block32_erase = 240 * CYCLES_PER_MS,
+    .block64_erase = 480 * CYCLES_PER_MS,
+};
+
+static const spi_cfg_t spi_cfg =
+{
+    .spi_ms = SPI_MS_MODE_MASTER,
+    .spi_cp = SPI_CP_MODE_0,
+    .spi_speed = SPI_SPEED_MODE_8MHz,
+    .spi_wsz = SPI_MODE_8BIT,
+    .spi_cs = SPI_CS_0,
+};
+
+typedef struct
+{
+    const char *name;
+    uint32_t address;
+    uint32_t region;            // Size of the region
+    uint32_t size;              // Data written, up to the region size
+    uint32_t chunk;             // Data made available at a time
+    uint32_t prepare_byte;      // CPU cycles per byte to prepare the data
+} flash_case_t;
+
+static const flash_case_t cases[] =
+{
+    { "128 KiB from RAM",            0x00000,  128 * 1024,  128 * 1024, 4096,   0 },
+    { "128 KiB decrypted",           0x00000,  128 * 1024,  128 * 1024, 4096, 275 },
+    { "200 KiB over UART 1 Mbaud",   0x00000,  200 * 1024,  200 * 1024, 1024, 160 },
+    { "96 KiB at 0x08000",           0x08000,   96 * 1024,   96 * 1024, 4096,   0 },
+    { "70001 bytes at 0x21000",      0x21000,       70001,       70001, 4096,   0 },
+    { "10000 of 48 KiB at 0x30000",  0x30000,   48 * 1024,       10000,  512,   0 },
+};
+
+static uint8_t data[SPI_FLASH_DEV_SIZE];
+static uint8_t old[SPI_FLASH_DEV_SIZE];
+
+// Erase commands of the burst writer
+static struct
+{
+    uint8_t opcode;
+    uint32_t address;
+} erases[MAX_ERASES];
+static uint32_t erase_cnt;
+
+static void trace_erase(uint8_t opcode, uint32_t address, uint32_t length, uint64_t cycles)
+{
+    if ((opcode == SPI_FLASH_OP_SE || opcode == SPI_FLASH_OP_BE32 ||
+         opcode == SPI_FLASH_OP_BE64) && erase_cnt < MAX_ERASES)
+    {
+        erases[erase_cnt].opcode = opcode;
+        erases[erase_cnt].address = address;
+        erase_cnt++;
+    }
+}
+
+static uint32_t erase_size(uint8_t opcode)
+{
+    return opcode == SPI_FLASH_OP_BE64 ? SPI_FLASH_BLOCK64_SIZE :
+           (opcode == SPI_FLASH_OP_BE32 ? SPI_FLASH_BLOCK32_SIZE : SPI_FLASH_SECTOR_SIZE);
+}
+
+static uint32_t region_end(const flash_case_t *c)
+{
+    return c->address + (c->region + SPI_FLASH_SECTOR_SIZE - 1) / SPI_FLASH_SECTOR_SIZE *
+                        SPI_FLASH_SECTOR_SIZE;
+}
+
+// Random previous contents, so that a missing erase shows up
+static void fill_flash(void)
+{
+    uint8_t *flash = spi_flash_sim_memory();
+
+    for (uint32_t i = 0; i < SPI_FLASH_DEV_SIZE; i++)
+    {
+        flash[i] = bench_rand();
+    }
+    memcpy(old, flash, SPI_FLASH_DEV_SIZE);
+}
+
+// Data written, the rest of the region erased, everything else untouched
+static bool check_flash(const flash_case_t *c)
+{
+    const uint8_t *flash = spi_flash_sim_memory();
+    uint32_t end = region_end(c);
+
+    for (uint32_t i = 0; i < SPI_FLASH_DEV_SIZE; i++)
+    {
+        uint8_t expected = old[i];
+
+        if (i >= c->address && i < end)
+        {
+            expected = (i - c->address < c->size) ? data[i - c->address] : 0xFF;
+        }
+        if (flash[i] != expected)
+        {
+            printf("  flash at 0x%05X: 0x%02X, expected 0x%02X\n", i, flash[i], expected);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// Erases in order, aligned to their size, covering the region exactly
+static bool check_erases(const flash_case_t *c)
+{
+    uint32_t next = c->address;
+
+    for (uint32_t i = 0; i < erase_cnt; i++)
+    {
+        uint32_t size = erase_size(erases[i].opcode);
+
+        if (erases[i].address != next || (erases[i].address % size) != 0)
+        {
+            return false;
+        }
+        next += size;
+    }
+
+    return next == region_end(c);
+}
+
+static int8_t write_legacy(const flash_case_t *c)
+{
+    int8_t status = SPI_FLASH_ERR_OK;
+    uint32_t actual_size;
+
+    for (uint32_t a = c->address; a < region_end(c) && status == SPI_FLASH_ERR_OK;
+         a += SPI_FLASH_SECTOR_SIZE)
+    {
+        status = spi_flash_block_erase(a, SPI_FLASH_OP_SE);
+    }
+
+    for (uint32_t done = 0; done < c->size && status == SPI_FLASH_ERR_OK; done += c->chunk)
+    {
+        uint32_t len = c->size - done < c->chunk ? c->size - done : c->chunk;
+
+        spi_flash_sim_charge((uint64_t) len * c->prepare_byte);
+        status = spi_flash_write_data_dma(&data[done], c->address + done, len, &actual_size);
+    }
+
+    return status;
+}
+
+static int8_t write_burst(const flash_case_t *c)
+{
+    spi_flash_burst_t burst;
+    int8_t status;
+
+    status = spi_flash_burst_start(&burst, c->address, c->region);
+
+    for (uint32_t done = 0; done < c->size && status == SPI_FLASH_ERR_OK; done += c->chunk)
+    {
+        uint32_t len = c->size - done < c->chunk ? c->size - done : c->chunk;
+
+        spi_flash_sim_charge((uint64_t) len * c->prepare_byte);
+        status = spi_flash_burst_write(&burst, &data[done], len);
+    }
+
+    if (status == SPI_FLASH_ERR_OK)
+    {
+        status = spi_flash_burst_finish(&burst);
+    }
+
+    return status;
+}
+
+static int run_case(const flash_case_t *c, uint32_t scale)
+{
+    spi_flash_sim_stats_t legacy_stats, stats;
+    uint64_t legacy_cycles, cycles, ns;
+    int8_t status = SPI_FLASH_ERR_OK;
+    char line[80];
+    int failed = 0;
+
+    for (uint32_t i = 0; i < c->size; i++)
+    {
+        data[i] = bench_rand();
+    }
+
+    fill_flash();
+    spi_flash_sim_reset(&cost);
+    status = write_legacy(c);
+    legacy_cycles = spi_flash_sim_cycles();
+    legacy_stats = *spi_flash_sim_stats();
+    snprintf(line, sizeof(line), "%s, legacy", c->name);
+    failed += bench_check(line, status == SPI_FLASH_ERR_OK && legacy_stats.errors == 0 &&
+                                check_flash(c));
+
+    spi_flash_sim_set_trace(trace_erase);
+    ns = 0;
+    for (uint32_t i = 0; i < scale; i++)
+    {
+        uint64_t t0;
+
+        fill_flash();
+        spi_flash_sim_reset(&cost);
+        erase_cnt = 0;
+        t0 = bench_now_ns();
+        status = write_burst(c);
+        ns += bench_now_ns() - t0;
+    }
+    spi_flash_sim_set_trace(NULL);
+    cycles = spi_flash_sim_cycles();
+    stats = *spi_flash_sim_stats();
+    snprintf(line, sizeof(line), "%s, burst", c->name);
+    failed += bench_check(line, status == SPI_FLASH_ERR_OK && stats.errors == 0 &&
+                                check_flash(c) && check_erases(c));
+
+    bench_report("  burst (host time)", scale, ns,
+                 "%7.1f ms modelled, %.1f before (%.2fx)  SE/BE32/BE64 %u/%u/%u, %u SE before  "
+                 "%u status reads while busy, %u before",
+                 (double) cycles / CYCLES_PER_MS, (double) legacy_cycles / CYCLES_PER_MS,
+                 (double) legacy_cycles / cycles, stats.erases[0], stats.erases[1],
+                 stats.erases[2], legacy_stats.erases[0], stats.busy_status_reads,
+                 legacy_stats.busy_status_reads);
+
+    return failed;
+}
+
+int bench_flash(uint32_t scale)
+{
+    spi_flash_burst_t burst;
+    uint8_t dev_id = 0;
+    int failed = 0;
+
+    spi_flash_sim_reset(&cost);
+    failed += bench_check("autodetect", spi_flash_enable_with_autodetect(&spi_cfg, &dev_id) ==
+                                        SPI_FLASH_ERR_OK && dev_id == W25X20CL_DEV_INDEX);
+
+    failed += bench_check("unaligned region",
+                          spi_flash_burst_start(&burst, 0x1100, 4096) == SPI_FLASH_ERR_ALIGN);
+    failed += bench_check("region beyond the flash",
+                          spi_flash_burst_start(&burst, SPI_FLASH_DEV_SIZE - 4096, 8192) ==
+                          SPI_FLASH_ERR_INVAL);
+    failed += bench_check("write beyond the region",
+                          spi_flash_burst_start(&burst, 0, 100) == SPI_FLASH_ERR_OK &&
+                          spi_flash_burst_write(&burst, data, 4097) == SPI_FLASH_ERR_INVAL &&
+                          spi_flash_burst_finish(&burst) == SPI_FLASH_ERR_OK);
+
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++)
+    {
+        failed += run_case(&cases[i], scale);
+    }
+
+    return failed;
+}
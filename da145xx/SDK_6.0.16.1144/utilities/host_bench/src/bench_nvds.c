@@ -0,0 +1,629 @@
+/**
+ ****************************************************************************************
+ *
+ * @file bench_nvds.c
+ *
+ * @brief NVDS benchmark
+ *
+ * Checks nvds_get_func() and nvds_get_ref() for every tag and every length against the switch
+ * they replace, with a blank and a programmed OTP BD address. Then checks nvds_put_func(),
+ * nvds_del_func() and nvds_flush() with the log in the SPI flash model (CFG_NVDS_LOG, four
+ * sectors): values surviving a reboot (nvds_init_func()), a torn record and a torn compaction
+ * left by a power loss, and long runs of flushes wearing the sectors evenly.
+ *
+ * Reports the host time of the lookups against the switch, and the modelled time of a flush
+ * and of reading a full log at boot.
+ *
+ * Copyright (C) 2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ ****************************************************************************************
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "nvds.h"
+#include "co_bt.h"
+#include "spi_flash.h"
+#include "spi_flash_sim.h"
+#include "user_periph_setup.h"
+#include "bench.h"
+
+#define CYCLES_PER_MS           (16000)
+#define LOG_END                 (CFG_NVDS_LOG_OFFSET + CFG_NVDS_LOG_SECTORS * SPI_FLASH_SECTOR_SIZE)
+
+// The NVDS functions of the ROM function table
+uint8_t nvds_get_func(uint8_t tag, nvds_tag_len_t *lengthPtr, uint8_t *buf);
+uint8_t nvds_put_func(uint8_t tag, nvds_tag_len_t length, uint8_t *buf);
+uint8_t nvds_del_func(uint8_t tag);
+uint8_t nvds_init_func(uint8_t *base, uint32_t len);
+
+// nvds.c built without CFG_NVDS_LOG
+uint8_t nolog_nvds_get_func(uint8_t tag, nvds_tag_len_t *lengthPtr, uint8_t *buf);
+uint8_t nolog_nvds_get_ref(uint8_t tag, nvds_tag_len_t *lengthPtr, const uint8_t **data);
+
+struct bd_addr dev_bdaddr;
+const struct bd_addr co_null_bdaddr;
+
+// DA14585 at 16 MHz with the SPI at 8 MHz, typical MX25R2035F program and erase times
+static const spi_flash_sim_cost_t cost =
+{
+    .spi_byte = 16,
+    .spi_command = 80,
+    .dma_setup = 40,
+    .page_program = 850 * CYCLES_PER_MS / 1000,
+    .sector_erase = 40 * CYCLES_PER_MS,
+    .block32_erase = 240 * CYCLES_PER_MS,
+    .block64_erase = 480 * CYCLES_PER_MS,
+};
+
+static const spi_cfg_t spi_cfg =
+{
+    .spi_ms = SPI_MS_MODE_MASTER,
+    .spi_cp = SPI_CP_MODE_0,
+    .spi_speed = SPI_SPEED_MODE_8MHz,
+    .spi_wsz = SPI_MODE_8BIT,
+    .spi_cs = SPI_CS_0,
+};
+
+static const struct bd_addr otp_bdaddr = {{ 0x11, 0x22, 0x33, 0x44, 0x55, 0x66 }};
+
+/****************************************************************************************
+   ****************************** REFERENCE *****************************
+ ****************************************************************************************/
+
+static const uint8_t ref_bd_address[NVDS_LEN_BD_ADDRESS] = CFG_NVDS_TAG_BD_ADDRESS;
+static const uint16_t ref_lpclk_drift = CFG_NVDS_TAG_LPCLK_DRIFT;
+static const uint16_t ref_ble_ca_timer_dur = CFG_NVDS_TAG_BLE_CA_TIMER_DUR;
+static const uint8_t ref_ble_cra_timer_dur = CFG_NVDS_TAG_BLE_CRA_TIMER_DUR;
+static const uint8_t ref_ble_ca_min_rssi = CFG_NVDS_TAG_BLE_CA_MIN_RSSI;
+static const uint8_t ref_ble_ca_nb_pkt = CFG_NVDS_TAG_BLE_CA_NB_PKT;
+static const uint8_t ref_ble_ca_nb_bad_pkt = CFG_NVDS_TAG_BLE_CA_NB_BAD_PKT;
+
+static uint8_t ref_copy(nvds_tag_len_t *lengthPtr, uint8_t *buf, const void *data,
+                        nvds_tag_len_t len)
+{
+    if (*lengthPtr < len)
+    {
+        *lengthPtr = 0;
+        return NVDS_LENGTH_OUT_OF_RANGE;
+    }
+
+    memcpy(buf, data, len);
+    *lengthPtr = len;
+
+    return NVDS_OK;
+}
+
+// nvds_get_func() before the tag table, not inlined as it was in another file
+static __attribute__((noinline)) uint8_t ref_get(uint8_t tag, nvds_tag_len_t *lengthPtr, uint8_t *buf)
+{
+    switch (tag)
+    {
+        case NVDS_TAG_BD_ADDRESS:
+            // No length check
+            if (memcmp(&dev_bdaddr, &co_null_bdaddr, NVDS_LEN_BD_ADDRESS))
+            {
+                memcpy(buf, &dev_bdaddr, NVDS_LEN_BD_ADDRESS);
+            }
+            else
+            {
+                memcpy(buf, ref_bd_address, NVDS_LEN_BD_ADDRESS);
+            }
+            *lengthPtr = NVDS_LEN_BD_ADDRESS;
+            return NVDS_OK;
+
+        case NVDS_TAG_LPCLK_DRIFT:
+            return ref_copy(lengthPtr, buf, &ref_lpclk_drift, NVDS_LEN_LPCLK_DRIFT);
+
+        case NVDS_TAG_BLE_CA_TIMER_DUR:
+            return ref_copy(lengthPtr, buf, &ref_ble_ca_timer_dur, NVDS_LEN_BLE_CA_TIMER_DUR);
+
+        case NVDS_TAG_BLE_CRA_TIMER_DUR:
+            return ref_copy(lengthPtr, buf, &ref_ble_cra_timer_dur, NVDS_LEN_BLE_CRA_TIMER_DUR);
+
+        case NVDS_TAG_BLE_CA_MIN_RSSI:
+            return ref_copy(lengthPtr, buf, &ref_ble_ca_min_rssi, NVDS_LEN_BLE_CA_MIN_RSSI);
+
+        case NVDS_TAG_BLE_CA_NB_PKT:
+            return ref_copy(lengthPtr, buf, &ref_ble_ca_nb_pkt, NVDS_LEN_BLE_CA_NB_PKT);
+
+        case NVDS_TAG_BLE_CA_NB_BAD_PKT:
+            return ref_copy(lengthPtr, buf, &ref_ble_ca_nb_bad_pkt, NVDS_LEN_BLE_CA_NB_BAD_PKT);
+
+        default:
+            return NVDS_FAIL;
+    }
+}
+
+/****************************************************************************************
+   ****************************** LOOKUPS *****************************
+ ****************************************************************************************/
+
+// Every tag with every length: status, length and the whole buffer as the switch left them
+static bool check_get(void)
+{
+    uint8_t buf[256], ref_buf[256];
+
+    for (uint32_t tag = 0; tag < 256; tag++)
+    {
+        for (uint32_t len = 0; len < 256; len++)
+        {
+            nvds_tag_len_t length = len, ref_length = len;
+            const uint8_t *data = NULL;
+            uint8_t status, ref_status;
+
+            memset(buf, 0xA5, sizeof(buf));
+            memset(ref_buf, 0xA5, sizeof(ref_buf));
+            status = nvds_get_func(tag, &length, buf);
+            ref_status = ref_get(tag, &ref_length, ref_buf);
+            if (status != ref_status || length != ref_length || memcmp(buf, ref_buf, sizeof(buf)))
+            {
+                printf("  tag 0x%02X length %u: status %u length %u, expected %u %u\n",
+                       tag, len, status, length, ref_status, ref_length);
+                return false;
+            }
+
+            length = len;
+            status = nvds_get_ref(tag, &length, &data);
+            if (status != ref_status || length != ref_length ||
+                (status == NVDS_OK && memcmp(data, ref_buf, length)))
+            {
+                printf("  tag 0x%02X length %u: nvds_get_ref() differs\n", tag, len);
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+/****************************************************************************************
+   ****************************** LOG *****************************
+ ****************************************************************************************/
+
+static uint32_t sector_erases[CFG_NVDS_LOG_SECTORS];
+static uint32_t stray_erases;
+
+static void trace_erase(uint8_t opcode, uint32_t address, uint32_t length, uint64_t cycles)
+{
+    if (opcode == SPI_FLASH_OP_SE && address >= CFG_NVDS_LOG_OFFSET && address < LOG_END)
+    {
+        sector_erases[(address - CFG_NVDS_LOG_OFFSET) / SPI_FLASH_SECTOR_SIZE]++;
+    }
+    else if (opcode == SPI_FLASH_OP_SE || opcode == SPI_FLASH_OP_BE32 ||
+             opcode == SPI_FLASH_OP_BE64)
+    {
+        stray_erases++;
+    }
+}
+
+// Random old contents, nothing outside the log may change
+static uint8_t old[SPI_FLASH_DEV_SIZE];
+
+static void fill_flash(void)
+{
+    uint8_t *flash = spi_flash_sim_memory();
+
+    for (uint32_t i = 0; i < SPI_FLASH_DEV_SIZE; i++)
+    {
+        flash[i] = bench_rand();
+    }
+    memcpy(old, flash, SPI_FLASH_DEV_SIZE);
+    memset(sector_erases, 0, sizeof(sector_erases));
+    stray_erases = 0;
+}
+
+static bool flash_intact(void)
+{
+    const uint8_t *flash = spi_flash_sim_memory();
+
+    return !memcmp(flash, old, CFG_NVDS_LOG_OFFSET) &&
+           !memcmp(&flash[LOG_END], &old[LOG_END], SPI_FLASH_DEV_SIZE - LOG_END) &&
+           stray_erases == 0 && spi_flash_sim_stats()->errors == 0;
+}
+
+static void reboot(void)
+{
+    nvds_init_func(NULL, 0);
+}
+
+static bool get_is(uint8_t tag, const void *value, nvds_tag_len_t len)
+{
+    uint8_t buf[NVDS_LEN_BD_ADDRESS];
+    nvds_tag_len_t length = sizeof(buf);
+
+    return nvds_get_func(tag, &length, buf) == NVDS_OK && length == len && !memcmp(buf, value, len);
+}
+
+static bool put_u16(uint8_t tag, uint16_t value)
+{
+    return nvds_put_func(tag, sizeof(value), (uint8_t *) &value) == NVDS_OK;
+}
+
+static bool check_put_errors(void)
+{
+    uint8_t value[NVDS_LEN_BD_ADDRESS] = { 0 };
+
+    return nvds_put_func(0x00, 1, value) == NVDS_TAG_NOT_DEFINED &&
+           nvds_put_func(NVDS_TAG_DEVICE_NAME, 1, value) == NVDS_TAG_NOT_DEFINED &&
+           nvds_put_func(0xFF, 1, value) == NVDS_TAG_NOT_DEFINED &&
+           nvds_put_func(NVDS_TAG_LPCLK_DRIFT, NVDS_LEN_LPCLK_DRIFT, value) == NVDS_PARAM_LOCKED &&
+           nvds_put_func(NVDS_TAG_BD_ADDRESS, NVDS_LEN_BD_ADDRESS - 1, value) ==
+           NVDS_LENGTH_OUT_OF_RANGE &&
+           nvds_put_func(NVDS_TAG_BLE_CA_NB_PKT, 2, value) == NVDS_LENGTH_OUT_OF_RANGE &&
+           nvds_del_func(NVDS_TAG_LPCLK_DRIFT) == NVDS_PARAM_LOCKED &&
+           nvds_del_func(0x00) == NVDS_TAG_NOT_DEFINED;
+}
+
+static bool check_persistence(void)
+{
+    const struct bd_addr addr = {{ 0xC0, 0xFF, 0xEE, 0x12, 0x34, 0xD5 }};
+    const uint8_t rssi = 0x30;
+    const uint16_t dur = 1234;
+    bool ok;
+
+    // No log in the random contents of the flash
+    fill_flash();
+    reboot();
+    ok = check_get();
+
+    ok = ok && nvds_put_func(NVDS_TAG_BD_ADDRESS, NVDS_LEN_BD_ADDRESS, (uint8_t *) &addr) == NVDS_OK &&
+         nvds_put_func(NVDS_TAG_BLE_CA_MIN_RSSI, 1, (uint8_t *) &rssi) == NVDS_OK &&
+         put_u16(NVDS_TAG_BLE_CA_TIMER_DUR, dur);
+
+    // The values put override the OTP address at once, and are lost without a flush
+    ok = ok && get_is(NVDS_TAG_BD_ADDRESS, &addr, NVDS_LEN_BD_ADDRESS) &&
+         get_is(NVDS_TAG_BLE_CA_MIN_RSSI, &rssi, 1) && get_is(NVDS_TAG_BLE_CA_TIMER_DUR, &dur, 2);
+    reboot();
+    ok = ok && get_is(NVDS_TAG_BD_ADDRESS, &dev_bdaddr, NVDS_LEN_BD_ADDRESS) &&
+         get_is(NVDS_TAG_BLE_CA_MIN_RSSI, &ref_ble_ca_min_rssi, 1);
+
+    ok = ok && nvds_put_func(NVDS_TAG_BD_ADDRESS, NVDS_LEN_BD_ADDRESS, (uint8_t *) &addr) == NVDS_OK &&
+         nvds_put_func(NVDS_TAG_BLE_CA_MIN_RSSI, 1, (uint8_t *) &rssi) == NVDS_OK &&
+         put_u16(NVDS_TAG_BLE_CA_TIMER_DUR, dur) && nvds_flush() == NVDS_OK;
+    reboot();
+    ok = ok && get_is(NVDS_TAG_BD_ADDRESS, &addr, NVDS_LEN_BD_ADDRESS) &&
+         get_is(NVDS_TAG_BLE_CA_MIN_RSSI, &rssi, 1) && get_is(NVDS_TAG_BLE_CA_TIMER_DUR, &dur, 2) &&
+         get_is(NVDS_TAG_BLE_CA_NB_PKT, &ref_ble_ca_nb_pkt, 1);
+
+    // Deleted tags get their default value back
+    ok = ok && nvds_del_func(NVDS_TAG_BD_ADDRESS) == NVDS_OK &&
+         nvds_del_func(NVDS_TAG_BLE_CA_MIN_RSSI) == NVDS_OK && nvds_flush() == NVDS_OK;
+    reboot();
+    ok = ok && get_is(NVDS_TAG_BD_ADDRESS, &dev_bdaddr, NVDS_LEN_BD_ADDRESS) &&
+         get_is(NVDS_TAG_BLE_CA_MIN_RSSI, &ref_ble_ca_min_rssi, 1) &&
+         get_is(NVDS_TAG_BLE_CA_TIMER_DUR, &dur, 2);
+
+    return ok && flash_intact();
+}
+
+static bool check_unchanged_put(void)
+{
+    uint32_t commands;
+    bool ok;
+
+    ok = put_u16(NVDS_TAG_BLE_CA_TIMER_DUR, 4321) && nvds_flush() == NVDS_OK;
+    commands = spi_flash_sim_stats()->commands;
+    ok = ok && put_u16(NVDS_TAG_BLE_CA_TIMER_DUR, 4321) && nvds_flush() == NVDS_OK;
+
+    return ok && spi_flash_sim_stats()->commands == commands;
+}
+
+// Address of the current sector: the one with the highest sequence number
+static uint32_t current_sector(void)
+{
+    const uint8_t *flash = spi_flash_sim_memory();
+    uint32_t best = 0, best_seq = 0;
+
+    for (uint32_t s = 0; s < CFG_NVDS_LOG_SECTORS; s++)
+    {
+        uint32_t address = CFG_NVDS_LOG_OFFSET + s * SPI_FLASH_SECTOR_SIZE;
+        uint32_t magic, seq;
+
+        memcpy(&magic, &flash[address], 4);
+        memcpy(&seq, &flash[address + 4], 4);
+        if (magic == 0x5344564E && (best == 0 || (int32_t) (seq - best_seq) > 0))
+        {
+            best = address;
+            best_seq = seq;
+        }
+    }
+
+    return best;
+}
+
+// End of the records of the current sector
+static uint32_t log_end(void)
+{
+    const uint8_t *flash = spi_flash_sim_memory();
+    uint32_t sector = current_sector();
+    uint32_t offset = 8;
+
+    while (offset < SPI_FLASH_SECTOR_SIZE && flash[sector + offset] != 0xFF)
+    {
+        offset += 4 + flash[sector + offset + 1];
+    }
+
+    return sector + offset;
+}
+
+// A power loss while the last record was programmed leaves the previous value
+static bool check_torn_record(void)
+{
+    uint8_t *flash = spi_flash_sim_memory();
+    uint32_t erases = spi_flash_sim_stats()->erases[0];
+    bool ok;
+
+    ok = put_u16(NVDS_TAG_BLE_CA_TIMER_DUR, 1000) && nvds_flush() == NVDS_OK &&
+         put_u16(NVDS_TAG_BLE_CA_TIMER_DUR, 1001) && nvds_flush() == NVDS_OK;
+
+    // Only some bits of the last data byte were programmed
+    flash[log_end() - 1] |= 0xF0;
+    reboot();
+    ok = ok && get_is(NVDS_TAG_BLE_CA_TIMER_DUR, &(uint16_t) { 1000 }, 2);
+
+    // Nothing is programmed after the torn record, the next flush compacts the log
+    ok = ok && put_u16(NVDS_TAG_BLE_CA_TIMER_DUR, 1002) && nvds_flush() == NVDS_OK &&
+         spi_flash_sim_stats()->erases[0] == erases + 1;
+    reboot();
+
+    return ok && get_is(NVDS_TAG_BLE_CA_TIMER_DUR, &(uint16_t) { 1002 }, 2) && flash_intact();
+}
+
+// A power loss during a compaction leaves the previous sector current
+static bool check_torn_compaction(void)
+{
+    uint8_t *flash = spi_flash_sim_memory();
+    uint16_t value = 0;
+    uint32_t erases;
+    bool ok = true;
+
+    // Flush until a compaction
+    do
+    {
+        erases = spi_flash_sim_stats()->erases[0];
+        value++;
+        ok = ok && put_u16(NVDS_TAG_BLE_CA_TIMER_DUR, value) && nvds_flush() == NVDS_OK;
+    } while (ok && spi_flash_sim_stats()->erases[0] == erases && value < 10000);
+
+    // The header is written last
+    memset(&flash[current_sector()], 0xFF, 8);
+    reboot();
+    ok = ok && get_is(NVDS_TAG_BLE_CA_TIMER_DUR, &(uint16_t) { value - 1 }, 2);
+
+    ok = ok && put_u16(NVDS_TAG_BLE_CA_TIMER_DUR, value + 1) && nvds_flush() == NVDS_OK;
+    reboot();
+
+    return ok && get_is(NVDS_TAG_BLE_CA_TIMER_DUR, &(uint16_t) { value + 1 }, 2) && flash_intact();
+}
+
+// Random puts and deletes, flushed in batches of 1 to 3 tags
+static bool run_flushes(uint32_t count, uint64_t *flush_cycles)
+{
+    static const uint8_t tags[] =
+    {
+        NVDS_TAG_BD_ADDRESS, NVDS_TAG_BLE_CA_TIMER_DUR, NVDS_TAG_BLE_CRA_TIMER_DUR,
+        NVDS_TAG_BLE_CA_MIN_RSSI, NVDS_TAG_BLE_CA_NB_PKT, NVDS_TAG_BLE_CA_NB_BAD_PKT,
+    };
+    static const uint8_t lens[] = { 6, 2, 1, 1, 1, 1 };
+    uint8_t values[sizeof(tags)][NVDS_LEN_BD_ADDRESS];
+    bool present[sizeof(tags)] = { false };
+    bool ok = true;
+
+    *flush_cycles = 0;
+    for (uint32_t i = 0; i < count && ok; i++)
+    {
+        uint32_t batch = 1 + bench_rand() % 3;
+        uint64_t t0;
+
+        for (uint32_t j = 0; j < batch; j++)
+        {
+            uint32_t t = bench_rand() % sizeof(tags);
+
+            if (bench_rand() % 8 == 0)
+            {
+                ok = ok && nvds_del_func(tags[t]) == NVDS_OK;
+                present[t] = false;
+            }
+            else
+            {
+                for (uint32_t k = 0; k < lens[t]; k++)
+                {
+                    values[t][k] = bench_rand();
+                }
+                ok = ok && nvds_put_func(tags[t], lens[t], values[t]) == NVDS_OK;
+                present[t] = true;
+            }
+        }
+
+        t0 = spi_flash_sim_cycles();
+        ok = ok && nvds_flush() == NVDS_OK;
+        *flush_cycles += spi_flash_sim_cycles() - t0;
+    }
+
+    reboot();
+    for (uint32_t t = 0; t < sizeof(tags) && ok; t++)
+    {
+        uint8_t expected[NVDS_LEN_BD_ADDRESS];
+        nvds_tag_len_t length = lens[t];
+
+        memcpy(expected, values[t], lens[t]);
+        if (!present[t])
+        {
+            // The default value, from the switch
+            ref_get(tags[t], &length, expected);
+        }
+        ok = get_is(tags[t], expected, lens[t]);
+    }
+
+    return ok && flash_intact();
+}
+
+static bool wear_even(void)
+{
+    uint32_t min = sector_erases[0], max = sector_erases[0];
+
+    for (uint32_t s = 1; s < CFG_NVDS_LOG_SECTORS; s++)
+    {
+        min = sector_erases[s] < min ? sector_erases[s] : min;
+        max = sector_erases[s] > max ? sector_erases[s] : max;
+    }
+
+    return max - min <= 1;
+}
+
+/****************************************************************************************
+   ****************************** BENCHMARK *****************************
+ ****************************************************************************************/
+
+static const uint8_t lookup_tags[] =
+{
+    NVDS_TAG_BD_ADDRESS, NVDS_TAG_LPCLK_DRIFT, NVDS_TAG_BLE_CA_TIMER_DUR,
+    NVDS_TAG_BLE_CRA_TIMER_DUR, NVDS_TAG_BLE_CA_MIN_RSSI, NVDS_TAG_BLE_CA_NB_PKT,
+    NVDS_TAG_BLE_CA_NB_BAD_PKT, NVDS_TAG_SLEEP_ENABLE, NVDS_TAG_EXT_WAKEUP_TIME,
+};
+
+static uint64_t time_get(uint8_t (*get)(uint8_t, nvds_tag_len_t *, uint8_t *), uint32_t iterations)
+{
+    volatile uint8_t sink = 0;
+    uint8_t buf[NVDS_LEN_BD_ADDRESS];
+    uint64_t t0 = bench_now_ns();
+
+    for (uint32_t i = 0; i < iterations; i++)
+    {
+        for (uint32_t t = 0; t < sizeof(lookup_tags); t++)
+        {
+            nvds_tag_len_t length = sizeof(buf);
+
+            sink += get(lookup_tags[t], &length, buf);
+        }
+    }
+    (void) sink;
+
+    return bench_now_ns() - t0;
+}
+
+static uint64_t time_get_ref(uint8_t (*get_ref)(uint8_t, nvds_tag_len_t *, const uint8_t **),
+                             uint32_t iterations)
+{
+    volatile uint8_t sink = 0;
+    uint64_t t0 = bench_now_ns();
+
+    for (uint32_t i = 0; i < iterations; i++)
+    {
+        for (uint32_t t = 0; t < sizeof(lookup_tags); t++)
+        {
+            nvds_tag_len_t length = NVDS_LEN_BD_ADDRESS;
+            const uint8_t *data;
+
+            sink += get_ref(lookup_tags[t], &length, &data);
+        }
+    }
+    (void) sink;
+
+    return bench_now_ns() - t0;
+}
+
+// Every writable tag put with another value, or deleted, without a flush
+static void put_all(bool put)
+{
+    static const uint8_t tags[] =
+    {
+        NVDS_TAG_BD_ADDRESS, NVDS_TAG_BLE_CA_TIMER_DUR, NVDS_TAG_BLE_CRA_TIMER_DUR,
+        NVDS_TAG_BLE_CA_MIN_RSSI, NVDS_TAG_BLE_CA_NB_PKT, NVDS_TAG_BLE_CA_NB_BAD_PKT,
+    };
+
+    for (uint32_t t = 0; t < sizeof(tags); t++)
+    {
+        uint8_t buf[NVDS_LEN_BD_ADDRESS];
+        nvds_tag_len_t length = sizeof(buf);
+
+        if (put)
+        {
+            nvds_get_func(tags[t], &length, buf);
+            buf[0] ^= 1;
+            nvds_put_func(tags[t], length, buf);
+        }
+        else
+        {
+            nvds_del_func(tags[t]);
+        }
+    }
+}
+
+// The lookups against the switch, with NVDS built without the log, with the log and nothing
+// put, and with every writable tag put
+static void bench_lookups(uint32_t scale)
+{
+    uint32_t iterations = 200000 * scale;
+    uint32_t ops = iterations * sizeof(lookup_tags);
+    uint64_t ref_ns = time_get(ref_get, iterations);
+
+    bench_report("  switch", ops, ref_ns, NULL);
+    bench_report("  nvds_get_func(), no log", ops, time_get(nolog_nvds_get_func, iterations), NULL);
+    bench_report("  nvds_get_ref(), no log", ops, time_get_ref(nolog_nvds_get_ref, iterations), NULL);
+
+    put_all(false);
+    bench_report("  nvds_get_func(), log empty", ops, time_get(nvds_get_func, iterations), NULL);
+    bench_report("  nvds_get_ref(), log empty", ops, time_get_ref(nvds_get_ref, iterations), NULL);
+
+    put_all(true);
+    bench_report("  nvds_get_func(), tags put", ops, time_get(nvds_get_func, iterations), NULL);
+    bench_report("  nvds_get_ref(), tags put", ops, time_get_ref(nvds_get_ref, iterations), NULL);
+}
+
+int bench_nvds(uint32_t scale)
+{
+    uint32_t flushes = 2000 * scale;
+    uint64_t flush_cycles, boot_cycles, t0;
+    uint32_t erases;
+    uint8_t dev_id = 0;
+    int failed = 0;
+
+    spi_flash_sim_reset(&cost);
+    failed += bench_check("autodetect", spi_flash_enable_with_autodetect(&spi_cfg, &dev_id) ==
+                                        SPI_FLASH_ERR_OK);
+    spi_flash_sim_set_trace(trace_erase);
+
+    // Without values put, nvds_get_func() returns what the switch did
+    fill_flash();
+    reboot();
+    memset(&dev_bdaddr, 0, sizeof(dev_bdaddr));
+    failed += bench_check("get, every tag and length, blank OTP address", check_get());
+    dev_bdaddr = otp_bdaddr;
+    failed += bench_check("get, every tag and length, OTP address", check_get());
+
+    failed += bench_check("put and delete errors", check_put_errors());
+    failed += bench_check("put, delete, flush and reboot", check_persistence());
+    failed += bench_check("put of the current value", check_unchanged_put());
+    failed += bench_check("torn record", check_torn_record());
+    failed += bench_check("torn compaction", check_torn_compaction());
+
+    fill_flash();
+    reboot();
+    spi_flash_sim_reset(&cost);
+    failed += bench_check("random puts and deletes, even wear",
+                          run_flushes(flushes, &flush_cycles) && wear_even());
+    erases = spi_flash_sim_stats()->erases[0];
+
+    // Reading the log at boot, with the current sector almost full
+    while (log_end() + 16 < current_sector() + SPI_FLASH_SECTOR_SIZE)
+    {
+        put_u16(NVDS_TAG_BLE_CA_TIMER_DUR, bench_rand());
+        nvds_flush();
+    }
+    t0 = spi_flash_sim_cycles();
+    reboot();
+    boot_cycles = spi_flash_sim_cycles() - t0;
+    spi_flash_sim_set_trace(NULL);
+
+    bench_lookups(scale);
+    printf("  flush: %.2f ms modelled on average, %u sector erases in %u flushes\n",
+           (double) flush_cycles / flushes / CYCLES_PER_MS, erases, flushes);
+    printf("  init with %u bytes of records: %.2f ms modelled\n",
+           log_end() - current_sector() - 8, (double) boot_cycles / CYCLES_PER_MS);
+
+    return failed;
+}
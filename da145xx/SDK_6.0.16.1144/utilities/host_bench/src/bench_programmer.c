@@ -0,0 +1,628 @@
+/**
+ ****************************************************************************************
+ *
+ * @file bench_programmer.c
+ *
+ * @brief Flash programmer protocol benchmark
+ *
+ * Runs the protocol engine of the flash programmer (utilities/flash_programmer/src/protocol.c)
+ * in a device thread on the slave side of a pseudo terminal, with the SDK SPI flash driver on
+ * the flash model, and talks to it from the master side like the external tool does.
+ *
+ * Checks the baud rate negotiation, including a corrupted and a missing confirmation, and
+ * streaming writes, including chunks corrupted on the way and a region out of the flash.
+ * Then compares the modelled time to write an image with the legacy protocol (sector erases,
+ * then ACTION_SPI_WRITE packets written before they are acknowledged) at the default baud
+ * rate, and with streaming writes at the default and at a negotiated baud rate.
+ *
+ * The device keeps the clock of the flash model: UART transmissions are blocking, a packet
+ * from the host is complete PACKET_TURNAROUND after the previous response plus its
+ * transmission time, and the device only waits for what is left of it when it needs it.
+ *
+ * Copyright (C) 2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ ****************************************************************************************
+ */
+
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <unistd.h>
+#include "protocol.h"
+#include "spi_flash.h"
+#include "spi_flash_sim.h"
+#include "user_periph_setup.h"
+#include "bench.h"
+
+#define CYCLES_PER_SEC          (16000000)
+// Response to request turnaround of the host, USB to UART bridge included
+#define PACKET_TURNAROUND       (CYCLES_PER_SEC / 1000)
+// Receive buffer of the DA14585/586 flash programmer, ALLOWED_DATA_UART
+#define DEVICE_BUFFER_SIZE      (0xFFFF)
+#define DEFAULT_BAUD            (57600)
+#define LEGACY_PACKET           (0x8000)
+#define IMAGE_SIZE              (200 * 1024)
+
+extern uint32_t crc32(uint32_t crc, const void *buf, size_t size);
+
+// DA14585 at 16 MHz with the SPI at 2 MHz, as configured by the flash programmer, typical
+// MX25R2035F program and erase times
+static const spi_flash_sim_cost_t cost =
+{
+    .spi_byte = 64,
+    .spi_command = 80,
+    .dma_setup = 40,
+    .page_program = 850 * (CYCLES_PER_SEC / 1000000),
+    .sector_erase = 40 * (CYCLES_PER_SEC / 1000),
+    .block32_erase = 240 * (CYCLES_PER_SEC / 1000),
+    .block64_erase = 480 * (CYCLES_PER_SEC / 1000),
+};
+
+static int device_fd;
+static int host_fd;
+static uint8_t device_buffer[DEVICE_BUFFER_SIZE];
+static volatile uint32_t device_baud;
+// Modelled time at which the host may start sending the next packet
+static uint64_t link_free;
+
+static uint8_t image[IMAGE_SIZE];
+static uint8_t old[SPI_FLASH_DEV_SIZE];
+
+/*
+ * Device port
+ ****************************************************************************************
+ */
+
+static uint64_t byte_cycles(void)
+{
+    // 8N1
+    return (uint64_t) CYCLES_PER_SEC * 10 / device_baud;
+}
+
+void prot_port_rx_start(prot_rx_t *rx)
+{
+}
+
+bool prot_port_rx_wait(prot_rx_t *rx, uint32_t timeout)
+{
+    struct pollfd pfd = { .fd = device_fd, .events = POLLIN };
+    uint8_t *dst;
+    uint16_t span;
+    uint64_t end;
+
+    while ((span = prot_rx_span(rx, &dst)) != 0)
+    {
+        ssize_t n;
+
+        if (poll(&pfd, 1, timeout ? (int) timeout : -1) <= 0)
+        {
+            return false;
+        }
+        n = read(device_fd, dst, span);
+        if (n <= 0)
+        {
+            return false;
+        }
+        prot_rx_received(rx, n);
+    }
+
+    end = link_free + (PROT_HEADER_SIZE + rx->len) * byte_cycles();
+    if (spi_flash_sim_cycles() < end)
+    {
+        spi_flash_sim_charge(end - spi_flash_sim_cycles());
+    }
+
+    return true;
+}
+
+void prot_port_send(uint8_t *buf, uint16_t len)
+{
+    uint8_t header[PROT_HEADER_SIZE];
+    uint32_t crc = crc32(0, buf, len);
+
+    header[0] = len >> 8;
+    header[1] = len;
+    header[2] = crc >> 24;
+    header[3] = crc >> 16;
+    header[4] = crc >> 8;
+    header[5] = crc;
+
+    spi_flash_sim_charge((PROT_HEADER_SIZE + len) * byte_cycles());
+    link_free = spi_flash_sim_cycles() + PACKET_TURNAROUND;
+
+    if (write(device_fd, header, sizeof(header)) != sizeof(header) ||
+        write(device_fd, buf, len) != len)
+    {
+        printf("  device: response lost\n");
+    }
+}
+
+uint32_t prot_port_baud_select(uint32_t requested)
+{
+    static const uint32_t rates[] = { 9600, 19200, 57600, 115200, 230400, 460800, 500000,
+                                      921600, 1000000 };
+    uint32_t baud = 0;
+
+    for (size_t i = 0; i < sizeof(rates) / sizeof(rates[0]); i++)
+    {
+        if (rates[i] <= requested)
+        {
+            baud = rates[i];
+        }
+    }
+
+    return baud;
+}
+
+void prot_port_set_baud(uint32_t baud)
+{
+    device_baud = baud;
+}
+
+/*
+ * Device
+ ****************************************************************************************
+ */
+
+static spi_flash_burst_t burst;
+
+static int spi_stream_begin(uint32_t address, uint32_t size)
+{
+    return spi_flash_burst_start(&burst, address, size);
+}
+
+static int spi_stream_write(const uint8_t *data, uint32_t size)
+{
+    return spi_flash_burst_write(&burst, data, size);
+}
+
+static int spi_stream_end(void)
+{
+    return spi_flash_burst_finish(&burst);
+}
+
+static const prot_target_t spi_stream =
+{
+    .begin = spi_stream_begin,
+    .write = spi_stream_write,
+    .end = spi_stream_end,
+    .align = 1,
+};
+
+static uint32_t get_be32(const uint8_t *p)
+{
+    return ((uint32_t) p[0] << 24) | ((uint32_t) p[1] << 16) | ((uint32_t) p[2] << 8) | p[3];
+}
+
+static void device_status(int result)
+{
+    uint8_t status = result == ERR_OK ? ACTION_OK : ACTION_ERROR;
+
+    prot_port_send(&status, 1);
+}
+
+// The actions of the flash programmer used here, on the same packets
+static void *device_main(void *arg)
+{
+    prot_rx_t rx;
+
+    for (;;)
+    {
+        uint8_t *cmd = device_buffer;
+        uint32_t actual_size;
+        int32_t len;
+        int result;
+
+        prot_rx_arm(&rx, device_buffer, sizeof(device_buffer));
+        prot_port_rx_start(&rx);
+        if (!prot_port_rx_wait(&rx, 0))
+        {
+            break;
+        }
+
+        len = prot_rx_check(&rx);
+        if (len <= 0)
+        {
+            uint8_t status = ACTION_INVALID_CRC;
+
+            prot_port_send(&status, 1);
+            continue;
+        }
+
+        switch (cmd[0])
+        {
+            case ACTION_UART_BAUD_NEGOTIATE:
+                prot_baud_negotiate(cmd, device_baud);
+                break;
+
+            case ACTION_STREAM_WRITE:
+                prot_stream_write(cmd, device_buffer, sizeof(device_buffer), &spi_stream);
+                break;
+
+            case ACTION_SPI_ERASE_BLOCK:
+                result = ERR_OK;
+                for (uint32_t i = 0; i < ((cmd[5] << 8) | cmd[6]) && result == ERR_OK; i++)
+                {
+                    result = spi_flash_block_erase(get_be32(&cmd[1]) + i * SPI_FLASH_SECTOR_SIZE,
+                                                   SPI_FLASH_OP_SE);
+                }
+                device_status(result);
+                break;
+
+            case ACTION_SPI_WRITE:
+                result = spi_flash_write_data(&cmd[7], get_be32(&cmd[1]), (cmd[5] << 8) | cmd[6],
+                                              &actual_size);
+                device_status(result);
+                break;
+
+            default:
+                device_status(ERR_INVAL);
+                break;
+        }
+    }
+
+    return NULL;
+}
+
+/*
+ * Host
+ ****************************************************************************************
+ */
+
+static void put_be32(uint8_t *p, uint32_t value)
+{
+    p[0] = value >> 24;
+    p[1] = value >> 16;
+    p[2] = value >> 8;
+    p[3] = value;
+}
+
+static void host_send(const uint8_t *payload, uint16_t len, bool corrupt)
+{
+    uint8_t header[PROT_HEADER_SIZE];
+    uint32_t crc = crc32(0, payload, len) ^ (corrupt ? 1 : 0);
+
+    header[0] = len >> 8;
+    header[1] = len;
+    put_be32(&header[2], crc);
+
+    if (write(host_fd, header, sizeof(header)) != sizeof(header) ||
+        write(host_fd, payload, len) != len)
+    {
+        printf("  host: request lost\n");
+    }
+}
+
+static bool host_read(uint8_t *buf, size_t len, int timeout)
+{
+    struct pollfd pfd = { .fd = host_fd, .events = POLLIN };
+
+    while (len)
+    {
+        ssize_t n;
+
+        if (poll(&pfd, 1, timeout) <= 0)
+        {
+            return false;
+        }
+        n = read(host_fd, buf, len);
+        if (n <= 0)
+        {
+            return false;
+        }
+        buf += n;
+        len -= n;
+    }
+
+    return true;
+}
+
+// Receive a response, returns its length or -1 on timeout or corruption
+static int host_receive(uint8_t *payload, uint16_t size, int timeout)
+{
+    uint8_t header[PROT_HEADER_SIZE];
+    uint16_t len;
+
+    if (!host_read(header, sizeof(header), timeout))
+    {
+        return -1;
+    }
+    len = (header[0] << 8) | header[1];
+    if (len > size || !host_read(payload, len, timeout) ||
+        crc32(0, payload, len) != get_be32(&header[2]))
+    {
+        return -1;
+    }
+
+    return len;
+}
+
+// Negotiate a baud rate, the confirmation can be corrupted or left out
+static uint32_t host_negotiate(uint32_t requested, bool corrupt, bool confirm)
+{
+    uint8_t cmd[5] = { ACTION_UART_BAUD_NEGOTIATE };
+    uint8_t reply[8];
+    uint32_t baud;
+
+    put_be32(&cmd[1], requested);
+    host_send(cmd, sizeof(cmd), false);
+    if (host_receive(reply, sizeof(reply), 1000) != 5 || reply[0] != ACTION_CONTENTS)
+    {
+        return 0;
+    }
+    baud = get_be32(&reply[1]);
+
+    if (confirm)
+    {
+        cmd[0] = ACTION_UART_BAUD_CONFIRM;
+        host_send(cmd, 1, corrupt);
+    }
+    if (host_receive(reply, sizeof(reply), 3 * PROT_BAUD_CONFIRM_TIMEOUT) != 1 ||
+        reply[0] != ACTION_OK)
+    {
+        return 0;
+    }
+
+    return baud;
+}
+
+typedef struct
+{
+    uint32_t chunks;
+    uint32_t resent;
+    uint32_t acks;
+} host_stats_t;
+
+// Streaming write, every corrupt_every-th chunk is corrupted once
+static int host_stream(uint32_t address, const uint8_t *data, uint32_t size,
+                       uint32_t corrupt_every, host_stats_t *stats)
+{
+    static uint8_t packet[DEVICE_BUFFER_SIZE];
+    uint8_t reply[8] = { 0 };
+    uint32_t done = 0;
+    uint16_t max_chunk;
+
+    memset(stats, 0, sizeof(*stats));
+
+    packet[0] = ACTION_STREAM_WRITE;
+    packet[1] = STREAM_TARGET_SPI;
+    put_be32(&packet[2], address);
+    put_be32(&packet[6], size);
+    host_send(packet, 10, false);
+    if (host_receive(reply, sizeof(reply), 5000) != 3 || reply[0] != ACTION_CONTENTS)
+    {
+        return reply[0] == ACTION_ERROR ? (int) get_be32(&reply[1]) : -1;
+    }
+    max_chunk = (reply[1] << 8) | reply[2];
+
+    while (done < size)
+    {
+        uint32_t len = size - done < max_chunk ? size - done : max_chunk;
+        bool corrupt = corrupt_every && (stats->chunks % corrupt_every) == corrupt_every - 1;
+
+        packet[0] = ACTION_DATA;
+        memcpy(&packet[1], &data[done], len);
+        do
+        {
+            host_send(packet, len + 1, corrupt);
+            if (host_receive(reply, sizeof(reply), 5000) < 1)
+            {
+                return -1;
+            }
+            stats->resent += corrupt;
+            corrupt = false;
+        } while (reply[0] == ACTION_INVALID_CRC);
+
+        stats->acks++;
+        if (reply[0] != ACTION_OK)
+        {
+            return (int) get_be32(&reply[1]);
+        }
+        stats->chunks++;
+        done += len;
+    }
+
+    return ERR_OK;
+}
+
+// Legacy write: erase the sectors, then ACTION_SPI_WRITE packets
+static int host_legacy(uint32_t address, const uint8_t *data, uint32_t size)
+{
+    static uint8_t packet[7 + LEGACY_PACKET];
+    uint16_t sectors = (size + SPI_FLASH_SECTOR_SIZE - 1) / SPI_FLASH_SECTOR_SIZE;
+    uint8_t reply[8];
+
+    packet[0] = ACTION_SPI_ERASE_BLOCK;
+    put_be32(&packet[1], address);
+    packet[5] = sectors >> 8;
+    packet[6] = sectors;
+    host_send(packet, 7, false);
+    if (host_receive(reply, sizeof(reply), 5000) < 1 || reply[0] != ACTION_OK)
+    {
+        return -1;
+    }
+
+    for (uint32_t done = 0; done < size; done += LEGACY_PACKET)
+    {
+        uint16_t len = size - done < LEGACY_PACKET ? size - done : LEGACY_PACKET;
+
+        packet[0] = ACTION_SPI_WRITE;
+        put_be32(&packet[1], address + done);
+        packet[5] = len >> 8;
+        packet[6] = len;
+        memcpy(&packet[7], &data[done], len);
+        host_send(packet, 7 + len, false);
+        if (host_receive(reply, sizeof(reply), 5000) < 1 || reply[0] != ACTION_OK)
+        {
+            return -1;
+        }
+    }
+
+    return ERR_OK;
+}
+
+/*
+ * Benchmark
+ ****************************************************************************************
+ */
+
+static int open_pty(void)
+{
+    struct termios tio;
+    int fd = posix_openpt(O_RDWR | O_NOCTTY);
+
+    if (fd < 0 || grantpt(fd) || unlockpt(fd))
+    {
+        return -1;
+    }
+    device_fd = open(ptsname(fd), O_RDWR | O_NOCTTY);
+    if (device_fd < 0 || tcgetattr(device_fd, &tio))
+    {
+        return -1;
+    }
+    cfmakeraw(&tio);
+    if (tcsetattr(device_fd, TCSANOW, &tio))
+    {
+        return -1;
+    }
+    host_fd = fd;
+
+    return 0;
+}
+
+static void fill_flash(void)
+{
+    uint8_t *flash = spi_flash_sim_memory();
+
+    for (uint32_t i = 0; i < SPI_FLASH_DEV_SIZE; i++)
+    {
+        flash[i] = bench_rand();
+    }
+    memcpy(old, flash, SPI_FLASH_DEV_SIZE);
+}
+
+static bool check_flash(uint32_t address, uint32_t size)
+{
+    const uint8_t *flash = spi_flash_sim_memory();
+
+    return memcmp(&flash[address], image, size) == 0 &&
+           memcmp(flash, old, address) == 0 &&
+           spi_flash_sim_stats()->errors == 0;
+}
+
+static void reset_clock(void)
+{
+    spi_flash_sim_reset(&cost);
+    link_free = 0;
+}
+
+// Write the image and report the modelled time, returns the number of failed checks
+static int run_write(const char *name, bool stream, uint32_t baud, uint32_t scale)
+{
+    double seconds = 0;
+    uint64_t ns = 0;
+    bool ok = true;
+    char line[80];
+
+    if (host_negotiate(baud, false, true) != baud)
+    {
+        snprintf(line, sizeof(line), "%s, negotiation", name);
+        return bench_check(line, false);
+    }
+
+    for (uint32_t i = 0; i < scale; i++)
+    {
+        host_stats_t stats;
+        uint64_t t0;
+        int result;
+
+        fill_flash();
+        reset_clock();
+        t0 = bench_now_ns();
+        result = stream ? host_stream(0, image, IMAGE_SIZE, 0, &stats) :
+                          host_legacy(0, image, IMAGE_SIZE);
+        ns += bench_now_ns() - t0;
+        seconds = (double) spi_flash_sim_cycles() / CYCLES_PER_SEC;
+        ok = ok && result == ERR_OK && check_flash(0, IMAGE_SIZE);
+    }
+
+    snprintf(line, sizeof(line), "%s", name);
+    bench_report(line, scale, ns, "%6.2f s modelled, %5.1f KiB/s at %u baud, %5.1f MiB/s on the pty",
+                 seconds, IMAGE_SIZE / 1024.0 / seconds, baud,
+                 (double) IMAGE_SIZE * scale / (1024 * 1024) / (ns / 1e9));
+
+    return bench_check("  written", ok);
+}
+
+int bench_programmer(uint32_t scale)
+{
+    const spi_flash_cfg_t flash_cfg =
+    {
+        .dev_index = W25X20CL_DEV_INDEX,
+        .jedec_id = W25X20CL_JEDEC_ID,
+        .chip_size = SPI_FLASH_DEV_SIZE,
+    };
+    host_stats_t stats;
+    pthread_t device;
+    int failed = 0;
+    int result;
+
+    if (open_pty())
+    {
+        return bench_check("pseudo terminal", false);
+    }
+
+    for (uint32_t i = 0; i < IMAGE_SIZE; i++)
+    {
+        image[i] = bench_rand();
+    }
+
+    spi_flash_configure_env(&flash_cfg);
+    reset_clock();
+    device_baud = DEFAULT_BAUD;
+    pthread_create(&device, NULL, device_main, NULL);
+
+    failed += bench_check("negotiate 2000000",
+                          host_negotiate(2000000, false, true) == 1000000 &&
+                          device_baud == 1000000);
+    failed += bench_check("negotiate 300", host_negotiate(300, false, true) == 0 &&
+                                           device_baud == 1000000);
+    failed += bench_check("corrupted confirmation",
+                          host_negotiate(460800, true, true) == 0 && device_baud == 1000000);
+    failed += bench_check("missing confirmation",
+                          host_negotiate(115200, false, false) == 0 && device_baud == 1000000);
+    failed += bench_check("negotiate 230400",
+                          host_negotiate(230400, false, true) == 230400 &&
+                          device_baud == 230400);
+
+    fill_flash();
+    result = host_stream(0x3000, image, 100000, 0, &stats);
+    failed += bench_check("stream 100000 at 0x3000", result == ERR_OK &&
+                          check_flash(0x3000, 100000) && stats.acks == stats.chunks);
+
+    fill_flash();
+    result = host_stream(0, image, IMAGE_SIZE, 3, &stats);
+    failed += bench_check("stream with corrupted chunks", result == ERR_OK &&
+                          check_flash(0, IMAGE_SIZE) && stats.resent == stats.chunks / 3);
+
+    failed += bench_check("stream out of the flash",
+                          host_stream(SPI_FLASH_DEV_SIZE - 4096, image, 8192, 0, &stats) ==
+                          SPI_FLASH_ERR_INVAL);
+
+    failed += run_write("legacy, 57600 baud", false, DEFAULT_BAUD, scale);
+    failed += run_write("stream, 57600 baud", true, DEFAULT_BAUD, scale);
+    failed += run_write("legacy, 1000000 baud", false, 1000000, scale);
+    failed += run_write("stream, 1000000 baud", true, 1000000, scale);
+
+    close(host_fd);
+    pthread_join(device, NULL);
+    close(device_fd);
+
+    return failed;
+}
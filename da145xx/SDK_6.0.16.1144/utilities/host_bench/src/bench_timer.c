@@ -0,0 +1,441 @@
+/**
+ ****************************************************************************************
+ *
+ * @file bench_timer.c
+ *
+ * @brief Timer wheel benchmark
+ *
+ * Replays random workloads of the easy timer wheel (app_easy_timer.c) on the kernel model and
+ * checks the firing time and order of every timer against a reference model, across the wrap
+ * of the BLE time and with starts while the BLE core sleeps. Then measures start, stop and
+ * modify operations per second for 10 to 10000 timers and the kernel operations they cost,
+ * against the easy timers that use one kernel timer each.
+ *
+ * Copyright (C) 2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ ****************************************************************************************
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "ke_sim.h"
+#include "app.h"
+#include "app_entry_point.h"
+#include "app_msg_utils.h"
+#include "app_easy_timer.h"
+#include "lld_evt.h"
+#include "bench.h"
+
+#define MAX_TIMERS              (10000)
+#define CHECK_TIMERS            (64)
+#define OPS_PER_RUN             (200000)
+
+// BLE time 10 s before it wraps
+#define SLOTS_BEFORE_WRAP       (BLE_BASETIMECNT_MASK + 1 - 16000)
+
+// Forced wakeup latency, 25 ms
+#define WAKEUP_SLOTS            (40)
+#define WAKEUP_TICKS            ((WAKEUP_SLOTS + 15) / 16)
+
+static const uint32_t timer_counts[] = { 10, 100, 1000, 10000 };
+
+/// Workload of a check
+typedef struct
+{
+    /// Name of the check
+    const char *name;
+    /// Number of steps, operations are done between them
+    uint32_t steps;
+    /// Longest time between steps, in ticks
+    uint32_t max_step;
+    /// Longest delay, in ticks
+    uint32_t max_delay;
+    /// The BLE core sleeps between steps
+    bool sleep;
+} workload_t;
+
+static const workload_t workloads[] =
+{
+    { "short delays",           20000,    20,               1000, false },
+    { "long delays, wraps",      4000, 50000, KE_TIMER_DELAY_MAX, false },
+    { "deferred starts",        20000,    20,               1000, true  },
+};
+
+// Reference model of a timer
+typedef struct
+{
+    bool active;
+    // Expected expiry, in ticks since the reset
+    uint64_t expiry;
+    uint32_t period;
+    // Start order, timers expiring together fire in this order
+    uint32_t seq;
+    // Started while the BLE core was sleeping, the delay starts at the wakeup
+    bool deferred;
+    uint64_t started;
+    uint32_t delay;
+} ref_timer_t;
+
+static struct app_easy_wheel_timer timers[MAX_TIMERS];
+static ref_timer_t ref[CHECK_TIMERS];
+
+static const workload_t *workload;
+static uint32_t seq;
+static uint64_t last_fire;
+static uint32_t last_seq;
+static uint32_t fired;
+static uint32_t late;
+static uint32_t misordered;
+static uint32_t spurious;
+static uint64_t max_jitter;
+static bool draining;
+
+static uint32_t callbacks;
+static timer_hnd easy_timers[APP_TIMER_API_LAST_MES - APP_TIMER_API_MES0];
+
+static uint32_t rand_delay(uint32_t max_delay)
+{
+    switch (bench_rand() % 4)
+    {
+        case 0:  return 1 + bench_rand() % 16;
+        case 1:  return 1 + bench_rand() % 256;
+        default: return 1 + bench_rand() % max_delay;
+    }
+}
+
+static void on_check_timer(struct app_easy_wheel_timer *timer);
+
+// Update the reference model for a timer that has been started
+static void ref_started(uint32_t i, uint32_t delay, uint32_t period)
+{
+    ref[i].active = true;
+    ref[i].period = period;
+    ref[i].deferred = !app_check_BLE_active();
+    ref[i].started = ke_sim_ticks();
+    ref[i].delay = delay;
+    ref[i].expiry = ke_sim_ticks() + delay;
+    ref[i].seq = ++seq;
+}
+
+// Start, stop or modify a random timer
+static void random_op(void)
+{
+    uint32_t i = bench_rand() % CHECK_TIMERS;
+    uint32_t delay = rand_delay(workload->max_delay);
+    uint32_t period = 1 + bench_rand() % 64;
+
+    switch (bench_rand() % 8)
+    {
+        case 0:
+        case 1:
+            app_easy_wheel_timer_stop(&timers[i]);
+            ref[i].active = false;
+            break;
+
+        case 2:
+            if (timers[i].fn != NULL)
+            {
+                app_easy_wheel_timer_modify(&timers[i], delay);
+                ref_started(i, delay, ref[i].period);
+            }
+            break;
+
+        case 3:
+            app_easy_wheel_timer_start(&timers[i], delay, period, on_check_timer);
+            ref_started(i, delay, period);
+            break;
+
+        default:
+            app_easy_wheel_timer_start(&timers[i], delay, 0, on_check_timer);
+            ref_started(i, delay, 0);
+            break;
+    }
+}
+
+static void on_check_timer(struct app_easy_wheel_timer *timer)
+{
+    uint32_t i = timer - timers;
+    uint64_t now = ke_sim_ticks();
+
+    fired++;
+
+    if (!ref[i].active)
+    {
+        spurious++;
+        return;
+    }
+
+    if (ref[i].deferred)
+    {
+        // The delay starts when the BLE core is awake
+        uint64_t jitter = now - (ref[i].started + ref[i].delay);
+
+        if (now < ref[i].started + ref[i].delay || jitter > WAKEUP_TICKS)
+        {
+            late++;
+        }
+        if (jitter > max_jitter)
+        {
+            max_jitter = jitter;
+        }
+    }
+    else
+    {
+        if (now != ref[i].expiry)
+        {
+            late++;
+        }
+
+        // Same expiry, same order as started
+        if (!workload->sleep && (now == last_fire) && (ref[i].seq < last_seq))
+        {
+            misordered++;
+        }
+        last_fire = now;
+        last_seq = ref[i].seq;
+    }
+
+    if (ref[i].period)
+    {
+        ref[i].expiry = now + ref[i].period;
+        ref[i].deferred = false;
+        ref[i].seq = ++seq;
+    }
+    else
+    {
+        ref[i].active = false;
+    }
+
+    // Callbacks change the timers too
+    if (!draining && (bench_rand() % 4 == 0))
+    {
+        random_op();
+    }
+}
+
+// Stop all timers and let the kernel timer of the wheel expire, then reset the kernel model
+static void reset(uint32_t slots)
+{
+    for (uint32_t i = 0; i < MAX_TIMERS; i++)
+    {
+        app_easy_wheel_timer_stop(&timers[i]);
+    }
+    ke_sim_run(ke_sim_ticks() + KE_TIMER_DELAY_MAX + 1);
+
+    memset(timers, 0, sizeof(timers));
+    ke_sim_reset(slots, WAKEUP_SLOTS);
+}
+
+static bool check_workload(const workload_t *w)
+{
+    bool consistent = true;
+
+    workload = w;
+    reset(SLOTS_BEFORE_WRAP);
+    memset(ref, 0, sizeof(ref));
+    seq = 0;
+    last_fire = 0;
+    last_seq = 0;
+    fired = late = misordered = spurious = 0;
+    max_jitter = 0;
+
+    for (uint32_t step = 0; step < w->steps; step++)
+    {
+        ke_sim_run(ke_sim_ticks() + bench_rand() % (w->max_step + 1));
+
+        if (w->sleep && (bench_rand() % 2))
+        {
+            ke_sim_sleep();
+        }
+
+        for (uint32_t n = bench_rand() % 4; n > 0; n--)
+        {
+            random_op();
+        }
+
+        for (uint32_t i = 0; i < CHECK_TIMERS; i++)
+        {
+            consistent &= (app_easy_wheel_timer_is_active(&timers[i]) == ref[i].active);
+        }
+    }
+
+    // Let the one shot timers expire
+    for (uint32_t i = 0; i < CHECK_TIMERS; i++)
+    {
+        if (ref[i].period)
+        {
+            app_easy_wheel_timer_stop(&timers[i]);
+            ref[i].active = false;
+        }
+    }
+    draining = true;
+    ke_sim_run(ke_sim_ticks() + KE_TIMER_DELAY_MAX + WAKEUP_TICKS + 1);
+    draining = false;
+    for (uint32_t i = 0; i < CHECK_TIMERS; i++)
+    {
+        consistent &= !ref[i].active && !app_easy_wheel_timer_is_active(&timers[i]);
+    }
+
+    printf("  %-32s %u fired, max jitter %u ticks, %u wakeups\n", w->name, fired,
+           (unsigned) max_jitter, ke_sim_stats()->wakeups);
+
+    return consistent && (fired > 0) && !late && !misordered && !spurious;
+}
+
+static void on_bench_timer(struct app_easy_wheel_timer *timer)
+{
+    callbacks++;
+}
+
+// Start, stop or modify a random timer out of n
+static void wheel_op(uint32_t n, uint32_t k, uint32_t max_delay)
+{
+    struct app_easy_wheel_timer *timer = &timers[bench_rand() % n];
+
+    if (timer->fn == NULL)
+    {
+        app_easy_wheel_timer_start(timer, rand_delay(max_delay), 0, on_bench_timer);
+        return;
+    }
+
+    switch (k % 4)
+    {
+        case 0:
+            app_easy_wheel_timer_stop(timer);
+            break;
+        case 1:
+            app_easy_wheel_timer_start(timer, rand_delay(max_delay), 0, on_bench_timer);
+            break;
+        default:
+            app_easy_wheel_timer_modify(timer, rand_delay(max_delay));
+            break;
+    }
+}
+
+static uint64_t time_ops(uint32_t n, uint32_t ops)
+{
+    uint64_t start = bench_now_ns();
+
+    for (uint32_t k = 0; k < ops; k++)
+    {
+        wheel_op(n, k, KE_TIMER_DELAY_MAX);
+    }
+
+    return bench_now_ns() - start;
+}
+
+static void on_easy_timer(timer_hnd hnd)
+{
+    for (uint32_t i = 0; i < sizeof(easy_timers) / sizeof(easy_timers[0]); i++)
+    {
+        if (easy_timers[i] == hnd)
+        {
+            easy_timers[i] = EASY_TIMER_INVALID_TIMER;
+        }
+    }
+    callbacks++;
+}
+
+// The same operations on the easy timers, there are as many as kernel messages for them
+static void easy_timer_ops(uint32_t ops)
+{
+    uint32_t n = sizeof(easy_timers) / sizeof(easy_timers[0]);
+
+    memset(easy_timers, 0, sizeof(easy_timers));
+
+    for (uint32_t k = 0; k < ops; k++)
+    {
+        uint32_t i = bench_rand() % n;
+
+        if (easy_timers[i] == EASY_TIMER_INVALID_TIMER)
+        {
+            easy_timers[i] = app_easy_timer(rand_delay(100000), (timer_callback) on_easy_timer);
+        }
+        else if (k % 4 == 0)
+        {
+            app_easy_timer_cancel(easy_timers[i]);
+            easy_timers[i] = EASY_TIMER_INVALID_TIMER;
+        }
+        else
+        {
+            app_easy_timer_modify(easy_timers[i], rand_delay(100000));
+        }
+
+        // Cancel and modify complete in kernel messages
+        ke_sim_run(ke_sim_ticks() + bench_rand() % 2);
+    }
+    app_easy_timer_cancel_all();
+    ke_sim_run(ke_sim_ticks() + 1);
+}
+
+static void report_kernel_ops(const char *name, uint32_t ops)
+{
+    const ke_sim_stats_t *st = ke_sim_stats();
+
+    printf("  %-32s %9u ops %8.3f timer sets/op %8.3f msgs/op %6.1f walk/set %4u armed\n", name, ops,
+           (double) st->timer_set / ops, (double) st->msg_sent / ops,
+           st->timer_set ? (double) st->timer_walk / st->timer_set : 0.0, st->max_armed);
+}
+
+int bench_timer(uint32_t scale)
+{
+    uint32_t ops = OPS_PER_RUN * scale;
+    int failed = 0;
+
+    for (size_t k = 0; k < sizeof(workloads) / sizeof(workloads[0]); k++)
+    {
+        failed += bench_check(workloads[k].name, check_workload(&workloads[k]));
+    }
+
+    for (size_t k = 0; k < sizeof(timer_counts) / sizeof(timer_counts[0]); k++)
+    {
+        uint32_t n = timer_counts[k];
+        char name[40];
+        uint64_t ns;
+
+        reset(0);
+        for (uint32_t i = 0; i < n; i++)
+        {
+            app_easy_wheel_timer_start(&timers[i], rand_delay(KE_TIMER_DELAY_MAX), 0, on_bench_timer);
+        }
+
+        ns = time_ops(n, ops);
+        snprintf(name, sizeof(name), "start/stop/modify, %u timers", n);
+        bench_report(name, ops, ns, NULL);
+        snprintf(name, sizeof(name), "kernel, %u timers", n);
+        report_kernel_ops(name, ops + n);
+
+        // Periodic timers expiring, host time per callback
+        reset(0);
+        for (uint32_t i = 0; i < n; i++)
+        {
+            app_easy_wheel_timer_start(&timers[i], 1 + bench_rand() % 100, 1 + bench_rand() % 1000,
+                                       on_bench_timer);
+        }
+        callbacks = 0;
+        ns = bench_now_ns();
+        ke_sim_run(10000ULL * scale);
+        ns = bench_now_ns() - ns;
+        snprintf(name, sizeof(name), "expiries, %u periodic timers", n);
+        bench_report(name, callbacks, ns, "%.3f timer sets/expiry",
+                     (double) ke_sim_stats()->timer_set / callbacks);
+    }
+
+    // The same operations on 9 wheel timers and on the 9 easy timers left, the kernel is run
+    // between the operations
+    reset(0);
+    for (uint32_t k = 0; k < ops / 10; k++)
+    {
+        wheel_op(9, k, 100000);
+        ke_sim_run(ke_sim_ticks() + bench_rand() % 2);
+    }
+    report_kernel_ops("kernel, 9 wheel timers", ops / 10);
+
+    reset(0);
+    easy_timer_ops(ops / 10);
+    report_kernel_ops("kernel, 9 easy timers", ops / 10);
+
+    return failed;
+}
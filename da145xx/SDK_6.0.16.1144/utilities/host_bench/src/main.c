@@ -0,0 +1,145 @@
+/**
+ ****************************************************************************************
+ *
+ * @file main.c
+ *
+ * @brief Host benchmark suite
+ *
+ * Runs the selected benchmarks of core modules that do not depend on the hardware.
+ *
+ * Copyright (C) 2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ ****************************************************************************************
+ */
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "bench.h"
+
+static const bench_t benches[] =
+{
+    { "crypto",     bench_crypto    },
+    { "boot",       bench_boot      },
+    { "bond_db",    bench_bond_db   },
+    { "timer",      bench_timer     },
+    { "flash",      bench_flash     },
+    { "programmer", bench_programmer },
+    { "nvds", bench_nvds },
+};
+
+static uint32_t rand_state = 0x12345678;
+
+uint64_t bench_now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t) ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+void bench_report(const char *name, uint32_t ops, uint64_t ns, const char *fmt, ...)
+{
+    va_list args;
+
+    printf("  %-32s %9u ops %12.1f ns/op %12.0f ops/s", name, ops,
+           ops ? (double) ns / ops : 0.0, ns ? ops * 1e9 / ns : 0.0);
+    if (fmt)
+    {
+        printf("  ");
+        va_start(args, fmt);
+        vprintf(fmt, args);
+        va_end(args);
+    }
+    printf("\n");
+    fflush(stdout);
+}
+
+int bench_check(const char *name, bool ok)
+{
+    printf("  %-32s %s\n", name, ok ? "ok" : "FAILED");
+
+    return ok ? 0 : 1;
+}
+
+uint32_t bench_rand(void)
+{
+    rand_state ^= rand_state << 13;
+    rand_state ^= rand_state >> 17;
+    rand_state ^= rand_state << 5;
+
+    return rand_state;
+}
+
+static void usage(const char *prog)
+{
+    printf("usage: %s [-s scale] [benchmark...]\n\nbenchmarks:", prog);
+    for (size_t i = 0; i < sizeof(benches) / sizeof(benches[0]); i++)
+    {
+        printf(" %s", benches[i].name);
+    }
+    printf("\n");
+}
+
+int main(int argc, char *argv[])
+{
+    uint32_t scale = 1;
+    int first = 1;
+    int failed = 0;
+
+    if ((argc > 2) && !strcmp(argv[1], "-s"))
+    {
+        scale = strtoul(argv[2], NULL, 0);
+        if (!scale)
+        {
+            usage(argv[0]);
+            return 2;
+        }
+        first = 3;
+    }
+
+    for (int i = first; i < argc; i++)
+    {
+        size_t j;
+
+        for (j = 0; j < sizeof(benches) / sizeof(benches[0]); j++)
+        {
+            if (!strcmp(argv[i], benches[j].name))
+            {
+                break;
+            }
+        }
+        if (j == sizeof(benches) / sizeof(benches[0]))
+        {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+
+    for (size_t j = 0; j < sizeof(benches) / sizeof(benches[0]); j++)
+    {
+        bool run = (first == argc);
+
+        for (int i = first; i < argc; i++)
+        {
+            run |= !strcmp(argv[i], benches[j].name);
+        }
+        if (run)
+        {
+            printf("%s:\n", benches[j].name);
+            failed += benches[j].run(scale);
+        }
+    }
+
+    if (failed)
+    {
+        printf("%d check(s) FAILED\n", failed);
+    }
+
+    return failed ? 1 : 0;
+}
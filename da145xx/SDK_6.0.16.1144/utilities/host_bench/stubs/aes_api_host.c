@@ -0,0 +1,69 @@
+/**
+ ****************************************************************************************
+ *
+ * @file aes_api_host.c
+ *
+ * @brief Host model of the AES API.
+ *
+ * The BLE core encryption block is replaced by the software cipher. The key schedule is run
+ * by aes_set_key() for both directions, so callers that set the key for every block, like
+ * aes_cbc.c, pay for it as they pay for loading the key registers on the target.
+ *
+ * Copyright (C) 2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ ****************************************************************************************
+ */
+
+#include <string.h>
+#include "aes_api.h"
+
+int aes_set_key(const uint8_t *userKey, const uint32_t bits, AES_KEY *key, uint8_t enc_dec)
+{
+    uint8_t iv[AES_IV_SIZE] = {0};
+
+    if ((userKey == NULL) || (key == NULL))
+    {
+        return -1;
+    }
+
+    if (bits != 128)
+    {
+        return -2;
+    }
+
+    AES_set_key(key, userKey, iv, AES_MODE_128);
+    if (enc_dec == AES_DECRYPT)
+    {
+        AES_convert_key(key);
+    }
+
+    return 0;
+}
+
+int aes_enc_dec(uint8_t *in, uint8_t *out, AES_KEY *key, uint8_t enc_dec, uint8_t ble_flags)
+{
+    uint32_t temp[4];
+
+    for (int j = 0; j < ENC_DATA_LEN; j += 4)
+    {
+        temp[j / 4] = GETU32(&in[j]);
+    }
+
+    if (enc_dec == AES_ENCRYPT)
+    {
+        AES_encrypt(key, temp);
+    }
+    else
+    {
+        AES_decrypt(key, temp);
+    }
+
+    for (int j = 0; j < ENC_DATA_LEN; j += 4)
+    {
+        PUTU32(&out[j], temp[j / 4]);
+    }
+
+    return 0;
+}
@@ -0,0 +1,36 @@
+/**
+ ****************************************************************************************
+ *
+ * @file app.h
+ *
+ * @brief Host replacement of the application task definitions, the easy timer messages.
+ *
+ * Copyright (C) 2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ ****************************************************************************************
+ */
+
+#ifndef _APP_H_
+#define _APP_H_
+
+#include "ke_msg.h"
+
+#define TASK_APP                    (12)
+#define KE_FIRST_MSG(task)          ((ke_msg_id_t)((task) << 8))
+
+/// APP Task messages, as in the SDK app.h
+enum APP_MSG
+{
+    APP_MODULE_INIT_CMP_EVT = KE_FIRST_MSG(TASK_APP),
+
+    APP_CREATE_TIMER,
+    APP_CANCEL_TIMER,
+    APP_MODIFY_TIMER,
+
+    APP_TIMER_API_MES0,
+    APP_TIMER_API_LAST_MES=APP_TIMER_API_MES0+9,
+};
+
+#endif
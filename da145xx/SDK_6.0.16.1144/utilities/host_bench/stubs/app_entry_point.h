@@ -0,0 +1,30 @@
+/**
+ ****************************************************************************************
+ *
+ * @file app_entry_point.h
+ *
+ * @brief Host replacement of the application entry point, the process event types.
+ *
+ * Copyright (C) 2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ ****************************************************************************************
+ */
+
+#ifndef _APP_ENTRY_POINT_H_
+#define _APP_ENTRY_POINT_H_
+
+#include "ke_msg.h"
+
+/// Process event response
+enum process_event_response
+{
+    /// Handled
+    PR_EVENT_HANDLED = 0,
+
+    /// Unhandled
+    PR_EVENT_UNHANDLED
+};
+
+#endif
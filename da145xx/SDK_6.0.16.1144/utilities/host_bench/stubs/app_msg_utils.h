@@ -0,0 +1,22 @@
+/**
+ ****************************************************************************************
+ *
+ * @file app_msg_utils.h
+ *
+ * @brief Host replacement of the application message utilities, the BLE state of the kernel model.
+ *
+ * Copyright (C) 2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ ****************************************************************************************
+ */
+
+#ifndef _APP_MSG_UTILS_H_
+#define _APP_MSG_UTILS_H_
+
+#include <stdbool.h>
+
+bool app_check_BLE_active(void);
+
+#endif
@@ -0,0 +1,18 @@
+/**
+ ****************************************************************************************
+ *
+ * @file arch.h
+ *
+ * @brief Host replacement of the architecture definitions, the NVDS needs none of them.
+ *
+ * Copyright (C) 2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ ****************************************************************************************
+ */
+
+#ifndef _ARCH_H_
+#define _ARCH_H_
+
+#endif
@@ -0,0 +1,20 @@
+/**
+ ****************************************************************************************
+ *
+ * @file arch_api.h
+ *
+ * @brief Host replacement of the architecture API, the BLE wakeup of the easy timers.
+ *
+ * Copyright (C) 2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ ****************************************************************************************
+ */
+
+#ifndef _ARCH_API_H_
+#define _ARCH_API_H_
+
+void arch_ble_force_wakeup(void);
+
+#endif
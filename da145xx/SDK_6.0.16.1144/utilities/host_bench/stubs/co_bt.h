@@ -0,0 +1,35 @@
+/**
+ ****************************************************************************************
+ *
+ * @file co_bt.h
+ *
+ * @brief Host replacement of the Bluetooth definitions, the ones used by the bond database.
+ *
+ * Copyright (C) 2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ ****************************************************************************************
+ */
+
+#ifndef _CO_BT_H_
+#define _CO_BT_H_
+
+#include <string.h>
+
+#define BD_ADDR_LEN                 6
+#define RAND_NB_LEN                 0x08
+
+/// BD address
+struct bd_addr
+{
+    uint8_t addr[BD_ADDR_LEN];
+};
+
+/// Random number
+struct rand_nb
+{
+    uint8_t nb[RAND_NB_LEN];
+};
+
+#endif
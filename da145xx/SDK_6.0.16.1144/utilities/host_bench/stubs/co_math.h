@@ -0,0 +1,23 @@
+/**
+ ****************************************************************************************
+ *
+ * @file co_math.h
+ *
+ * @brief Host replacement of the common math functions, the ones used by the NVDS.
+ *
+ * Copyright (C) 2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ ****************************************************************************************
+ */
+
+#ifndef _CO_MATH_H_
+#define _CO_MATH_H_
+
+__STATIC_INLINE uint32_t co_min(uint32_t a, uint32_t b)
+{
+    return a < b ? a : b;
+}
+
+#endif
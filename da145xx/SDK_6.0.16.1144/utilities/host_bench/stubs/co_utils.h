@@ -0,0 +1,23 @@
+/**
+ ****************************************************************************************
+ *
+ * @file co_utils.h
+ *
+ * @brief Host replacement of the common utilities, the ones used by the NVDS.
+ *
+ * Copyright (C) 2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ ****************************************************************************************
+ */
+
+#ifndef _CO_UTILS_H_
+#define _CO_UTILS_H_
+
+#include "co_bt.h"
+
+/// Blank BD address, defined by the benchmark
+extern const struct bd_addr co_null_bdaddr;
+
+#endif
@@ -0,0 +1,34 @@
+/**
+ ****************************************************************************************
+ *
+ * @file da1458x_config_advanced.h
+ *
+ * @brief Host replacement of the advanced project configuration, the NVDS options of the
+ * example applications with the NVDS log in four sectors.
+ *
+ * Copyright (C) 2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ ****************************************************************************************
+ */
+
+#ifndef _DA1458X_CONFIG_ADVANCED_H_
+#define _DA1458X_CONFIG_ADVANCED_H_
+
+#define CFG_NVDS_TAG_BD_ADDRESS             {0x02, 0x00, 0x00, 0xCA, 0xEA, 0x80}
+
+#define CFG_NVDS_TAG_LPCLK_DRIFT            500
+#define CFG_NVDS_TAG_BLE_CA_TIMER_DUR       2000
+#define CFG_NVDS_TAG_BLE_CRA_TIMER_DUR      6
+#define CFG_NVDS_TAG_BLE_CA_MIN_RSSI        0x40
+#define CFG_NVDS_TAG_BLE_CA_NB_PKT          100
+#define CFG_NVDS_TAG_BLE_CA_NB_BAD_PKT      50
+
+#if !defined (HOST_BENCH_NVDS_NO_LOG)
+#define CFG_NVDS_LOG
+#define CFG_NVDS_LOG_OFFSET                 (0x1C000)
+#define CFG_NVDS_LOG_SECTORS                (4)
+#endif
+
+#endif
@@ -0,0 +1,26 @@
+/**
+ ****************************************************************************************
+ *
+ * @file datasheet.h
+ *
+ * @brief Host replacement of the register definitions used by the secondary bootloader.
+ *
+ * Copyright (C) 2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ ****************************************************************************************
+ */
+
+#ifndef _DATASHEET_H_
+#define _DATASHEET_H_
+
+#define WATCHDOG_REG                (0)
+#define WATCHDOG_REG_RESET          (0xFF)
+
+#define SetWord16(a, d)             ((void) (a), (void) (d))
+
+#define DMA_IRQn                    (0)
+#define NVIC_DisableIRQ(irq)        ((void) (irq))
+
+#endif
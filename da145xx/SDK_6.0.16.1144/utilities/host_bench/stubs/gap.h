@@ -0,0 +1,42 @@
+/**
+ ****************************************************************************************
+ *
+ * @file gap.h
+ *
+ * @brief Host replacement of the GAP definitions, the ones used by the bond database.
+ *
+ * Copyright (C) 2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ ****************************************************************************************
+ */
+
+#ifndef _GAP_H_
+#define _GAP_H_
+
+#include "co_bt.h"
+
+/// Address information about a device address
+struct gap_bdaddr
+{
+    struct bd_addr addr;
+    uint8_t addr_type;
+};
+
+/// Generic Security key structure
+struct gap_sec_key
+{
+    uint8_t key[KEY_LEN];
+};
+
+/// Resolving list device information
+struct gap_ral_dev_info
+{
+    uint8_t addr_type;
+    uint8_t addr[BD_ADDR_LEN];
+    uint8_t peer_irk[KEY_LEN];
+    uint8_t local_irk[KEY_LEN];
+};
+
+#endif
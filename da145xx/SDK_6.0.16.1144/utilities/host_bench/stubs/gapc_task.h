@@ -0,0 +1,38 @@
+/**
+ ****************************************************************************************
+ *
+ * @file gapc_task.h
+ *
+ * @brief Host replacement of the GAP controller messages, the key structures of the bond data.
+ *
+ * Copyright (C) 2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ ****************************************************************************************
+ */
+
+#ifndef _GAPC_TASK_H_
+#define _GAPC_TASK_H_
+
+#include "gap.h"
+// The stack headers bring the GAP manager operations in
+#include "gapm_task.h"
+
+/// Long Term Key information
+struct gapc_ltk
+{
+    struct gap_sec_key ltk;
+    uint16_t ediv;
+    struct rand_nb randnb;
+    uint8_t key_size;
+};
+
+/// Identity Resolving Key information
+struct gapc_irk
+{
+    struct gap_sec_key irk;
+    struct gap_bdaddr addr;
+};
+
+#endif
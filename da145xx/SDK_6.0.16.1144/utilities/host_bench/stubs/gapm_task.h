@@ -0,0 +1,32 @@
+/**
+ ****************************************************************************************
+ *
+ * @file gapm_task.h
+ *
+ * @brief Host replacement of the GAP manager messages, the resolving list operations used
+ * by the application utilities.
+ *
+ * Copyright (C) 2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ ****************************************************************************************
+ */
+
+#ifndef _GAPM_TASK_H_
+#define _GAPM_TASK_H_
+
+/// Resolving list operations
+enum gapm_operation
+{
+    GAPM_GET_RAL_SIZE,
+    GAPM_GET_RAL_LOC_ADDR,
+    GAPM_GET_RAL_PEER_ADDR,
+    GAPM_ADD_DEV_IN_RAL,
+    GAPM_RMV_DEV_FRM_RAL,
+    GAPM_CLEAR_RAL,
+    GAPM_NETWORK_MODE_RAL,
+    GAPM_DEVICE_MODE_RAL,
+};
+
+#endif
@@ -0,0 +1,26 @@
+/**
+ ****************************************************************************************
+ *
+ * @file gpio.h
+ *
+ * @brief Host replacement of the GPIO driver, pins are not configured.
+ *
+ * Copyright (C) 2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ ****************************************************************************************
+ */
+
+#ifndef _GPIO_H_
+#define _GPIO_H_
+
+typedef enum { GPIO_PORT_0 } GPIO_PORT;
+typedef enum { GPIO_PIN_0, GPIO_PIN_1, GPIO_PIN_3 = 3, GPIO_PIN_4 } GPIO_PIN;
+typedef enum { INPUT, OUTPUT } GPIO_PUPD;
+typedef enum { PID_SPI_EN, PID_SPI_CLK, PID_SPI_DO, PID_SPI_DI } GPIO_FUNCTION;
+
+#define GPIO_ConfigurePin(port, pin, mode, function, high) \
+    ((void) (port), (void) (pin), (void) (mode), (void) (function), (void) (high))
+
+#endif
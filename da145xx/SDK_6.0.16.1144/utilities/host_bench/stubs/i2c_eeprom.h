@@ -0,0 +1,18 @@
+/**
+ ****************************************************************************************
+ *
+ * @file i2c_eeprom.h
+ *
+ * @brief Host replacement of the I2C EEPROM driver, not used by the simulation.
+ *
+ * Copyright (C) 2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ ****************************************************************************************
+ */
+
+#ifndef _I2C_EEPROM_H_
+#define _I2C_EEPROM_H_
+
+#endif
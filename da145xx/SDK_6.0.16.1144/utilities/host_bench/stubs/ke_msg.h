@@ -0,0 +1,39 @@
+/**
+ ****************************************************************************************
+ *
+ * @file ke_msg.h
+ *
+ * @brief Host replacement of the kernel message API, messages are queued by the kernel model.
+ *
+ * Copyright (C) 2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ ****************************************************************************************
+ */
+
+#ifndef _KE_MSG_H_
+#define _KE_MSG_H_
+
+#include <stdint.h>
+
+typedef uint16_t ke_msg_id_t;
+typedef uint16_t ke_task_id_t;
+
+/// Status returned by a task when handling a message
+enum ke_msg_status_tag
+{
+    KE_MSG_CONSUMED = 0,
+    KE_MSG_NO_FREE,
+    KE_MSG_SAVED,
+};
+
+#define KE_MSG_ALLOC(id, dest, src, param_str) \
+    (struct param_str*) ke_msg_alloc(id, dest, src, sizeof(struct param_str))
+
+void *ke_msg_alloc(ke_msg_id_t const id, ke_task_id_t const dest_id,
+                   ke_task_id_t const src_id, uint16_t const param_len);
+
+void ke_msg_send(void const *param_ptr);
+
+#endif
@@ -0,0 +1,252 @@
+/**
+ ****************************************************************************************
+ *
+ * @file ke_sim.c
+ *
+ * @brief Host model of the kernel timers and messages of the application task.
+ *
+ * Copyright (C) 2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ ****************************************************************************************
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "ke_msg.h"
+#include "ke_timer.h"
+#include "ke_sim.h"
+#include "arch_api.h"
+#include "app.h"
+#include "app_msg_utils.h"
+#include "app_entry_point.h"
+#include "app_easy_timer.h"
+#include "lld_evt.h"
+
+#define SLOTS_PER_TICK      (16)
+#define MAX_TIMERS          (APP_TIMER_API_LAST_MES - APP_TIMER_API_MES0 + 1)
+#define MAX_MSGS            (256)
+
+// Message as allocated by ke_msg_alloc(), the parameters follow
+struct sim_msg
+{
+    struct sim_msg *next;
+    ke_msg_id_t id;
+    uint32_t param[];
+};
+
+// Armed kernel timer
+struct sim_timer
+{
+    ke_msg_id_t id;
+    uint64_t expiry;
+};
+
+static uint64_t sim_slots;
+static uint64_t sim_start;
+static uint32_t sim_wakeup_slots;
+static bool sim_ble_active;
+static bool sim_wakeup_forced;
+
+static struct sim_timer timers[MAX_TIMERS];
+static uint32_t nb_timers;
+
+static struct sim_msg *msg_first;
+static struct sim_msg *msg_last;
+
+static ke_sim_stats_t stats;
+
+void ke_sim_reset(uint32_t slots, uint32_t wakeup_slots)
+{
+    struct sim_msg *msg;
+
+    while ((msg = msg_first) != NULL)
+    {
+        msg_first = msg->next;
+        free(msg);
+    }
+    msg_last = NULL;
+
+    // The kernel time is in whole ticks
+    sim_slots = slots & ~(SLOTS_PER_TICK - 1);
+    sim_start = sim_slots;
+    sim_wakeup_slots = wakeup_slots;
+    sim_ble_active = true;
+    sim_wakeup_forced = false;
+    nb_timers = 0;
+    memset(&stats, 0, sizeof(stats));
+}
+
+uint64_t ke_sim_ticks(void)
+{
+    return (sim_slots - sim_start) / SLOTS_PER_TICK;
+}
+
+void ke_sim_sleep(void)
+{
+    sim_ble_active = false;
+}
+
+const ke_sim_stats_t *ke_sim_stats(void)
+{
+    return &stats;
+}
+
+uint32_t lld_evt_time_get(void)
+{
+    return (uint32_t)sim_slots & BLE_BASETIMECNT_MASK;
+}
+
+bool app_check_BLE_active(void)
+{
+    return sim_ble_active;
+}
+
+void arch_ble_force_wakeup(void)
+{
+    if (!sim_ble_active)
+    {
+        sim_wakeup_forced = true;
+        stats.wakeups++;
+    }
+}
+
+void *ke_msg_alloc(ke_msg_id_t const id, ke_task_id_t const dest_id,
+                   ke_task_id_t const src_id, uint16_t const param_len)
+{
+    struct sim_msg *msg = calloc(1, sizeof(struct sim_msg) + param_len);
+
+    msg->id = id;
+
+    return msg->param;
+}
+
+void ke_msg_send(void const *param_ptr)
+{
+    struct sim_msg *msg = (struct sim_msg *)((uint8_t *)param_ptr - offsetof(struct sim_msg, param));
+
+    msg->next = NULL;
+    if (msg_last)
+    {
+        msg_last->next = msg;
+    }
+    else
+    {
+        msg_first = msg;
+    }
+    msg_last = msg;
+    stats.msg_sent++;
+}
+
+static void timer_remove(ke_msg_id_t const timer_id)
+{
+    for (uint32_t i = 0; i < nb_timers; i++)
+    {
+        if (timers[i].id == timer_id)
+        {
+            memmove(&timers[i], &timers[i + 1], (nb_timers - i - 1) * sizeof(timers[0]));
+            nb_timers--;
+            return;
+        }
+    }
+}
+
+void ke_timer_set(ke_msg_id_t const timer_id, ke_task_id_t const task, uint32_t delay)
+{
+    uint64_t expiry;
+    uint32_t i;
+
+    // Time in ticks, as ke_time()
+    expiry = sim_slots / SLOTS_PER_TICK + delay;
+
+    timer_remove(timer_id);
+
+    // Sorted list, as the kernel keeps it
+    for (i = 0; (i < nb_timers) && (timers[i].expiry <= expiry); i++)
+    {
+        stats.timer_walk++;
+    }
+    memmove(&timers[i + 1], &timers[i], (nb_timers - i) * sizeof(timers[0]));
+    timers[i].id = timer_id;
+    timers[i].expiry = expiry;
+    nb_timers++;
+
+    stats.timer_set++;
+    if (nb_timers > stats.max_armed)
+    {
+        stats.max_armed = nb_timers;
+    }
+}
+
+void ke_timer_clear(ke_msg_id_t const timer_id, ke_task_id_t const task)
+{
+    timer_remove(timer_id);
+    stats.timer_clear++;
+}
+
+void ke_sim_run(uint64_t ticks)
+{
+    uint64_t end = sim_start + ticks * SLOTS_PER_TICK;
+
+    for (;;)
+    {
+        struct sim_msg *msg = msg_first;
+
+        if (msg)
+        {
+            enum ke_msg_status_tag msg_ret;
+
+            // Messages wait for the BLE core, which is woken up earlier if a timer expires
+            if (!sim_ble_active)
+            {
+                uint64_t wakeup = sim_slots + (sim_wakeup_forced ? sim_wakeup_slots : 0);
+
+                if (nb_timers && (timers[0].expiry * SLOTS_PER_TICK < wakeup))
+                {
+                    wakeup = timers[0].expiry * SLOTS_PER_TICK;
+                }
+                if (wakeup > sim_slots)
+                {
+                    sim_slots = wakeup;
+                }
+                sim_ble_active = true;
+                sim_wakeup_forced = false;
+            }
+
+            msg_first = msg->next;
+            if (!msg_first)
+            {
+                msg_last = NULL;
+            }
+            app_timer_api_process_handler(msg->id, msg->param, TASK_APP, TASK_APP, &msg_ret);
+            free(msg);
+        }
+        else if (nb_timers && (timers[0].expiry * SLOTS_PER_TICK <= end))
+        {
+            struct sim_msg *timer_msg;
+
+            // The BLE core is woken up on time for a timer
+            if (timers[0].expiry * SLOTS_PER_TICK > sim_slots)
+            {
+                sim_slots = timers[0].expiry * SLOTS_PER_TICK;
+            }
+            sim_ble_active = true;
+            sim_wakeup_forced = false;
+
+            timer_msg = (struct sim_msg *)((uint8_t *)ke_msg_alloc(timers[0].id, TASK_APP, TASK_APP, 0) -
+                                           offsetof(struct sim_msg, param));
+            timer_remove(timers[0].id);
+            ke_msg_send(timer_msg->param);
+        }
+        else
+        {
+            break;
+        }
+    }
+
+    if (end > sim_slots)
+    {
+        sim_slots = end;
+    }
+}
@@ -0,0 +1,83 @@
+/**
+ ****************************************************************************************
+ *
+ * @file ke_sim.h
+ *
+ * @brief Host model of the kernel timers and messages of the application task.
+ *
+ * The model keeps the BLE time in 625 us slots and the kernel timers in 10 ms ticks, as the
+ * kernel does. Messages are queued and dispatched to app_timer_api_process_handler() in order.
+ * The BLE core can be put to sleep: a kernel timer wakes it up on time, a message sent after
+ * arch_ble_force_wakeup() is dispatched after the wakeup latency.
+ *
+ * Copyright (C) 2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ ****************************************************************************************
+ */
+
+#ifndef _KE_SIM_H_
+#define _KE_SIM_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/// Kernel operations done by the application
+typedef struct
+{
+    /// Calls of ke_timer_set()
+    uint32_t timer_set;
+    /// Calls of ke_timer_clear()
+    uint32_t timer_clear;
+    /// Timers passed while inserting in the sorted timer list, as ke_timer_set() does
+    uint64_t timer_walk;
+    /// Messages sent, including expired timers
+    uint32_t msg_sent;
+    /// Forced BLE wakeups
+    uint32_t wakeups;
+    /// Most kernel timers armed at the same time
+    uint32_t max_armed;
+} ke_sim_stats_t;
+
+/**
+ ****************************************************************************************
+ * @brief Reset the model, no timers and no messages
+ * @param[in] slots         BLE time, in 625 us slots
+ * @param[in] wakeup_slots  Latency of a forced BLE wakeup, in 625 us slots
+ ****************************************************************************************
+ */
+void ke_sim_reset(uint32_t slots, uint32_t wakeup_slots);
+
+/**
+ ****************************************************************************************
+ * @brief Get the time elapsed since the reset
+ * @return time in 10 ms ticks
+ ****************************************************************************************
+ */
+uint64_t ke_sim_ticks(void);
+
+/**
+ ****************************************************************************************
+ * @brief Dispatch the queued messages and the expired timers up to a time
+ * @param[in] ticks         Time elapsed since the reset, in 10 ms ticks
+ ****************************************************************************************
+ */
+void ke_sim_run(uint64_t ticks);
+
+/**
+ ****************************************************************************************
+ * @brief Put the BLE core to sleep, until a timer expires or a wakeup is forced
+ ****************************************************************************************
+ */
+void ke_sim_sleep(void);
+
+/**
+ ****************************************************************************************
+ * @brief Get the number of kernel operations since the reset
+ * @return statistics
+ ****************************************************************************************
+ */
+const ke_sim_stats_t *ke_sim_stats(void);
+
+#endif
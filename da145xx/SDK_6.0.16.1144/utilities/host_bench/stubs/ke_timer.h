@@ -0,0 +1,24 @@
+/**
+ ****************************************************************************************
+ *
+ * @file ke_timer.h
+ *
+ * @brief Host replacement of the kernel timer API, timers are kept by the kernel model.
+ *
+ * Copyright (C) 2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ ****************************************************************************************
+ */
+
+#ifndef _KE_TIMER_H_
+#define _KE_TIMER_H_
+
+#include "ke_msg.h"
+
+void ke_timer_set(ke_msg_id_t const timer_id, ke_task_id_t const task, uint32_t delay);
+
+void ke_timer_clear(ke_msg_id_t const timer_id, ke_task_id_t const task);
+
+#endif
@@ -0,0 +1,26 @@
+/**
+ ****************************************************************************************
+ *
+ * @file lld_evt.h
+ *
+ * @brief Host replacement of the link layer event API, the BLE time of the kernel model.
+ *
+ * Copyright (C) 2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ ****************************************************************************************
+ */
+
+#ifndef LLD_EVT_H_
+#define LLD_EVT_H_
+
+#include <stdint.h>
+
+// From reg_blecore.h
+#define BLE_BASETIMECNT_MASK   ((uint32_t)0x07FFFFFF)
+
+/// BLE time, in 625 us slots
+uint32_t lld_evt_time_get(void);
+
+#endif
@@ -0,0 +1,18 @@
+/**
+ ****************************************************************************************
+ *
+ * @file rwip.h
+ *
+ * @brief Host replacement of the stack scheduler interface, there is no scheduler.
+ *
+ * Copyright (C) 2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ ****************************************************************************************
+ */
+
+#ifndef _RWIP_H_
+#define _RWIP_H_
+
+#endif
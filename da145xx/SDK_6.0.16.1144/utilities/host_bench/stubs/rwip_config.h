@@ -0,0 +1,23 @@
+/**
+ ****************************************************************************************
+ *
+ * @file rwip_config.h
+ *
+ * @brief Host replacement of the stack configuration, only the application security is enabled.
+ *
+ * Copyright (C) 2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ ****************************************************************************************
+ */
+
+#ifndef _RWIP_CONFIG_H_
+#define _RWIP_CONFIG_H_
+
+#define BLE_APP_SEC                 1
+
+// From app.h, which is empty without BLE_APP_PRESENT
+#define APP_EASY_MAX_ACTIVE_CONNECTION  (1)
+
+#endif
@@ -0,0 +1,64 @@
+/**
+ ****************************************************************************************
+ *
+ * @file spi.h
+ *
+ * @brief Host replacement of the SPI driver, on the SPI flash model of spi_flash_sim.c.
+ *
+ * Copyright (C) 2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ ****************************************************************************************
+ */
+
+#ifndef _SPI_H_
+#define _SPI_H_
+
+#include <stdint.h>
+#include "datasheet.h"
+#include "gpio.h"
+
+typedef enum { SPI_MS_MODE_MASTER } SPI_MS_MODE_CFG;
+typedef enum { SPI_CP_MODE_0, SPI_CP_MODE_3 = 3 } SPI_CP_MODE_CFG;
+typedef enum { SPI_SPEED_MODE_8MHz } SPI_SPEED_MODE_CFG;
+typedef enum { SPI_MODE_8BIT, SPI_MODE_16BIT, SPI_MODE_32BIT } SPI_WSZ_MODE_CFG;
+typedef enum { SPI_CS_0 } SPI_CS_MODE_CFG;
+typedef enum { SPI_OP_BLOCKING, SPI_OP_DMA } SPI_OP_CFG;
+typedef enum { SPI_DMA_CHANNEL_01 } SPI_DMA_CHANNEL_CFG;
+typedef enum { DMA_PRIO_0 } DMA_PRIO_CFG;
+
+typedef struct
+{
+    SPI_MS_MODE_CFG spi_ms;
+    SPI_CP_MODE_CFG spi_cp;
+    SPI_SPEED_MODE_CFG spi_speed;
+    SPI_WSZ_MODE_CFG spi_wsz;
+    SPI_CS_MODE_CFG spi_cs;
+    struct
+    {
+        GPIO_PORT port;
+        GPIO_PIN pin;
+    } cs_pad;
+    void (*send_cb)(uint16_t length);
+    void (*receive_cb)(uint16_t length);
+    void (*transfer_cb)(uint16_t length);
+    SPI_DMA_CHANNEL_CFG spi_dma_channel;
+    DMA_PRIO_CFG spi_dma_priority;
+} spi_cfg_t;
+
+void spi_enable(void);
+void spi_disable(void);
+void spi_set_bitmode(SPI_WSZ_MODE_CFG spi_wsz);
+int8_t spi_initialize(const spi_cfg_t *spi_cfg);
+void spi_cs_low(void);
+void spi_cs_high(void);
+int8_t spi_send(const void *data, uint16_t num, SPI_OP_CFG op);
+int8_t spi_receive(void *data, uint16_t num, SPI_OP_CFG op);
+uint32_t spi_access(uint32_t dataToSend);
+uint32_t spi_transaction(uint32_t dataToSend);
+#define spi_release() spi_disable()
+void spi_wait_dma_write_to_finish(void);
+void spi_wait_dma_read_to_finish(void);
+
+#endif
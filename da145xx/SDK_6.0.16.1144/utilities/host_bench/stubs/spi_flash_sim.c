@@ -0,0 +1,500 @@
+/**
+ ****************************************************************************************
+ *
+ * @file spi_flash_sim.c
+ *
+ * @brief Host model of an SPI flash on the SPI bus, for the SPI flash driver.
+ *
+ * The SPI driver functions shift the bytes of each chip select frame through a model of
+ * the flash, which executes the command when the chip select is released. crc32() and
+ * AES_cbc_decrypt() are wrapped at link time (-Wl,--wrap) to charge the modelled CPU time
+ * of the work done between transfers.
+ *
+ * Copyright (C) 2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ ****************************************************************************************
+ */
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include "spi_flash.h"
+#include "spi_flash_sim.h"
+#include "sw_aes.h"
+#include "user_periph_setup.h"
+
+// The modelled device, its size is the one of the secondary bootloader configuration
+#define SIM_JEDEC_ID            W25X20CL_JEDEC_ID
+
+static uint8_t flash[SPI_FLASH_DEV_SIZE];
+static spi_flash_sim_cost_t sim_cost;
+static spi_flash_sim_stats_t sim_stats;
+static spi_flash_sim_trace_t sim_trace;
+
+// Modelled clocks of the CPU, of the end of the DMA transfer in progress and of the end of
+// the program or erase in progress
+static uint64_t cpu_now;
+static uint64_t dma_end;
+static uint64_t busy_end;
+
+static bool write_enabled;
+static SPI_WSZ_MODE_CFG bitmode;
+
+// Frame in progress, between spi_cs_low() and spi_cs_high()
+static bool cs_active;
+static uint32_t frame_len;
+static uint8_t opcode;
+static uint32_t address;
+static bool ignored;
+
+// Page Program data latch, bytes not sent are left erased
+static uint8_t page_latch[SPI_FLASH_PAGE_SIZE];
+static bool page_loaded[SPI_FLASH_PAGE_SIZE];
+
+// DMA read in progress, the data only lands in the destination when it is waited for
+static uint8_t dma_buf[0xFFFF];
+static uint8_t *dma_dst;
+static uint16_t dma_len;
+
+static void sim_error(const char *fmt, ...)
+{
+    va_list args;
+
+    printf("spi_flash_sim: ");
+    va_start(args, fmt);
+    vprintf(fmt, args);
+    va_end(args);
+    printf("\n");
+
+    sim_stats.errors++;
+}
+
+int spi_flash_sim_load(const char *path)
+{
+    FILE *f = fopen(path, "rb");
+
+    if (!f)
+    {
+        return -1;
+    }
+
+    memset(flash, 0xFF, sizeof(flash));
+    fread(flash, 1, sizeof(flash), f);
+    fclose(f);
+
+    return 0;
+}
+
+uint8_t *spi_flash_sim_memory(void)
+{
+    return flash;
+}
+
+void spi_flash_sim_reset(const spi_flash_sim_cost_t *cost)
+{
+    sim_cost = *cost;
+    memset(&sim_stats, 0, sizeof(sim_stats));
+    cpu_now = 0;
+    dma_end = 0;
+    busy_end = 0;
+    write_enabled = false;
+    cs_active = false;
+    dma_len = 0;
+}
+
+void spi_flash_sim_set_trace(spi_flash_sim_trace_t trace)
+{
+    sim_trace = trace;
+}
+
+void spi_flash_sim_charge(uint64_t cycles)
+{
+    cpu_now += cycles;
+}
+
+uint64_t spi_flash_sim_cycles(void)
+{
+    return cpu_now;
+}
+
+const spi_flash_sim_stats_t *spi_flash_sim_stats(void)
+{
+    return &sim_stats;
+}
+
+static bool flash_busy(void)
+{
+    return cpu_now < busy_end;
+}
+
+static bool has_address(uint8_t op)
+{
+    return op == SPI_FLASH_OP_READ || op == SPI_FLASH_OP_PP || op == SPI_FLASH_OP_SE ||
+           op == SPI_FLASH_OP_BE32 || op == SPI_FLASH_OP_BE64;
+}
+
+static uint8_t status_reg(void)
+{
+    // Write enable is cleared when the program or erase completes
+    if (flash_busy())
+    {
+        return SPI_FLASH_SR_BUSY | SPI_FLASH_SR_WEL;
+    }
+
+    return write_enabled ? SPI_FLASH_SR_WEL : 0;
+}
+
+// One byte in each direction on the bus
+static uint8_t shift(uint8_t out)
+{
+    uint32_t idx = frame_len++;
+
+    if (!cs_active)
+    {
+        sim_error("transfer with CS high");
+        return 0xFF;
+    }
+
+    if (idx == 0)
+    {
+        opcode = out;
+        address = 0;
+        ignored = flash_busy() && opcode != SPI_FLASH_OP_RDSR;
+        if (ignored)
+        {
+            sim_error("command 0x%02X while busy", opcode);
+        }
+        if (opcode == SPI_FLASH_OP_PP)
+        {
+            memset(page_latch, 0xFF, sizeof(page_latch));
+            memset(page_loaded, 0, sizeof(page_loaded));
+        }
+        return 0xFF;
+    }
+
+    if (ignored)
+    {
+        return 0xFF;
+    }
+
+    if (has_address(opcode) && idx <= 3)
+    {
+        address = (address << 8) | out;
+        return 0xFF;
+    }
+
+    switch (opcode)
+    {
+        case SPI_FLASH_OP_RDSR:
+            return status_reg();
+
+        case SPI_FLASH_OP_RDID:
+            return idx <= 3 ? (uint8_t) (SIM_JEDEC_ID >> (8 * (3 - idx))) : 0xFF;
+
+        case SPI_FLASH_OP_READ:
+            return flash[(address + idx - 4) % sizeof(flash)];
+
+        case SPI_FLASH_OP_PP:
+            // The address wraps within the page
+            page_latch[(address + idx - 4) % SPI_FLASH_PAGE_SIZE] = out;
+            page_loaded[(address + idx - 4) % SPI_FLASH_PAGE_SIZE] = true;
+            return 0xFF;
+
+        default:
+            return 0xFF;
+    }
+}
+
+static void start_busy(uint32_t cycles)
+{
+    busy_end = cpu_now + cycles;
+    sim_stats.busy_cycles += cycles;
+    write_enabled = false;
+}
+
+static void program_page(void)
+{
+    uint32_t base = (address % sizeof(flash)) & ~(SPI_FLASH_PAGE_SIZE - 1);
+    uint32_t not_erased = 0;
+
+    // Only the bytes sent are programmed, they must not have bits at 0 that should be 1
+    for (uint32_t i = 0; i < SPI_FLASH_PAGE_SIZE; i++)
+    {
+        if (page_loaded[i])
+        {
+            not_erased |= page_latch[i] & ~flash[base + i];
+        }
+        flash[base + i] &= page_latch[i];
+    }
+    if (not_erased)
+    {
+        sim_error("page 0x%05X programmed without erase", base);
+    }
+
+    sim_stats.page_programs++;
+    start_busy(sim_cost.page_program);
+}
+
+static void erase(uint32_t size, uint32_t cycles, int type)
+{
+    uint32_t base = (address % sizeof(flash)) & ~(size - 1);
+
+    memset(&flash[base], 0xFF, size < sizeof(flash) - base ? size : sizeof(flash) - base);
+
+    sim_stats.erases[type]++;
+    start_busy(cycles);
+}
+
+// The flash executes the command when CS is released
+static void execute(void)
+{
+    if (frame_len == 0)
+    {
+        return;
+    }
+
+    if (opcode == SPI_FLASH_OP_RDSR)
+    {
+        sim_stats.status_reads++;
+        if (flash_busy())
+        {
+            sim_stats.busy_status_reads++;
+        }
+        return;
+    }
+
+    if (ignored)
+    {
+        return;
+    }
+
+    sim_stats.commands++;
+
+    if (has_address(opcode) && frame_len < 4)
+    {
+        sim_error("command 0x%02X without address", opcode);
+        return;
+    }
+
+    switch (opcode)
+    {
+        case SPI_FLASH_OP_WREN:
+            write_enabled = true;
+            break;
+
+        case SPI_FLASH_OP_WRDI:
+            write_enabled = false;
+            break;
+
+        case SPI_FLASH_OP_PP:
+        case SPI_FLASH_OP_SE:
+        case SPI_FLASH_OP_BE32:
+        case SPI_FLASH_OP_BE64:
+            if (!write_enabled)
+            {
+                sim_error("command 0x%02X without write enable", opcode);
+                return;
+            }
+            if (opcode == SPI_FLASH_OP_PP)
+            {
+                program_page();
+            }
+            else if (opcode == SPI_FLASH_OP_SE)
+            {
+                erase(SPI_FLASH_SECTOR_SIZE, sim_cost.sector_erase, 0);
+            }
+            else if (opcode == SPI_FLASH_OP_BE32)
+            {
+                erase(SPI_FLASH_BLOCK32_SIZE, sim_cost.block32_erase, 1);
+            }
+            else
+            {
+                erase(SPI_FLASH_BLOCK64_SIZE, sim_cost.block64_erase, 2);
+            }
+            break;
+
+        case SPI_FLASH_OP_WRSR:
+            write_enabled = false;
+            break;
+
+        default:
+            break;
+    }
+
+    if (sim_trace)
+    {
+        sim_trace(opcode, address, frame_len - 1 - (has_address(opcode) ? 3 : 0), cpu_now);
+    }
+}
+
+void spi_enable(void)
+{
+}
+
+void spi_disable(void)
+{
+}
+
+int8_t spi_initialize(const spi_cfg_t *spi_cfg)
+{
+    bitmode = spi_cfg->spi_wsz;
+
+    return 0;
+}
+
+void spi_set_bitmode(SPI_WSZ_MODE_CFG spi_wsz)
+{
+    bitmode = spi_wsz;
+}
+
+void spi_cs_low(void)
+{
+    if (cs_active)
+    {
+        sim_error("CS asserted twice");
+    }
+    cs_active = true;
+    frame_len = 0;
+    cpu_now += sim_cost.spi_command;
+}
+
+void spi_cs_high(void)
+{
+    if (cpu_now < dma_end)
+    {
+        sim_error("CS released during a DMA transfer");
+    }
+    execute();
+    cs_active = false;
+}
+
+uint32_t spi_access(uint32_t dataToSend)
+{
+    uint32_t bytes = bitmode == SPI_MODE_32BIT ? 4 : (bitmode == SPI_MODE_16BIT ? 2 : 1);
+    uint32_t data = 0;
+
+    for (int i = bytes - 1; i >= 0; i--)
+    {
+        data = (data << 8) | shift((uint8_t) (dataToSend >> (8 * i)));
+    }
+    cpu_now += bytes * sim_cost.spi_byte;
+
+    return data;
+}
+
+uint32_t spi_transaction(uint32_t dataToSend)
+{
+    uint32_t data;
+
+    spi_cs_low();
+    data = spi_access(dataToSend);
+    spi_cs_high();
+
+    return data;
+}
+
+static void wait_dma(void)
+{
+    if (cpu_now < dma_end)
+    {
+        cpu_now = dma_end;
+    }
+
+    if (dma_len)
+    {
+        memcpy(dma_dst, dma_buf, dma_len);
+        dma_len = 0;
+    }
+}
+
+static void start_dma(uint16_t num)
+{
+    // A single DMA channel, the previous transfer must have been waited for
+    if (cpu_now < dma_end || dma_len)
+    {
+        sim_error("DMA transfer started while one is in progress");
+        wait_dma();
+    }
+
+    cpu_now += sim_cost.dma_setup;
+    dma_end = cpu_now + (uint64_t) num * sim_cost.spi_byte;
+}
+
+int8_t spi_send(const void *data, uint16_t num, SPI_OP_CFG op)
+{
+    const uint8_t *p = data;
+
+    if (op == SPI_OP_DMA)
+    {
+        start_dma(num);
+    }
+    else
+    {
+        cpu_now += (uint64_t) num * sim_cost.spi_byte;
+    }
+
+    // The flash only acts on the data when CS is released, after the transfer
+    for (uint16_t i = 0; i < num; i++)
+    {
+        shift(p[i]);
+    }
+
+    return 0;
+}
+
+int8_t spi_receive(void *data, uint16_t num, SPI_OP_CFG op)
+{
+    if (op == SPI_OP_DMA)
+    {
+        start_dma(num);
+        for (uint16_t i = 0; i < num; i++)
+        {
+            dma_buf[i] = shift(0xFF);
+        }
+        dma_dst = data;
+        dma_len = num;
+
+        // Until the transfer has been waited for, the destination holds stale data
+        memset(data, 0xEE, num);
+    }
+    else
+    {
+        for (uint16_t i = 0; i < num; i++)
+        {
+            ((uint8_t *) data)[i] = shift(0xFF);
+        }
+        cpu_now += (uint64_t) num * sim_cost.spi_byte;
+    }
+
+    return 0;
+}
+
+void spi_wait_dma_write_to_finish(void)
+{
+    wait_dma();
+}
+
+void spi_wait_dma_read_to_finish(void)
+{
+    wait_dma();
+}
+
+uint32_t __real_crc32(uint32_t crc, const void *buf, size_t size);
+
+uint32_t __wrap_crc32(uint32_t crc, const void *buf, size_t size)
+{
+    cpu_now += (uint64_t) size * sim_cost.crc_byte;
+
+    return __real_crc32(crc, buf, size);
+}
+
+void __real_AES_cbc_decrypt(AES_CTX *ctx, const uint8_t *msg, uint8_t *out, int length);
+
+void __wrap_AES_cbc_decrypt(AES_CTX *ctx, const uint8_t *msg, uint8_t *out, int length)
+{
+    cpu_now += (uint64_t) (length / AES_BLOCKSIZE) * sim_cost.aes_block;
+
+    __real_AES_cbc_decrypt(ctx, msg, out, length);
+}
@@ -0,0 +1,128 @@
+/**
+ ****************************************************************************************
+ *
+ * @file spi_flash_sim.h
+ *
+ * @brief Host model of an SPI flash on the SPI bus, for the SPI flash driver.
+ *
+ * The SDK SPI flash driver (spi_flash.c) runs unmodified on top of the SPI driver of
+ * spi.h, whose transfers are decoded as SPI flash commands: status and ID reads, write
+ * enable, read, page program and sector/block erase, with the busy time of programs and
+ * erases. Transfers are not timed on the host, instead the model keeps a clock of the cycles
+ * the target would spend: the CPU is charged for blocking transfers and, through
+ * spi_flash_sim_charge(), for the work between them; DMA transfers run in parallel and the
+ * CPU only waits for what is left in spi_wait_dma_read_to_finish() and
+ * spi_wait_dma_write_to_finish().
+ *
+ * Commands a real flash would ignore or misexecute (anything but a status read while busy,
+ * program or erase without write enable, programming bits that are not erased, CS released
+ * during a DMA transfer, ...) are protocol errors: they are printed and counted.
+ *
+ * Copyright (C) 2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ ****************************************************************************************
+ */
+
+#ifndef _SPI_FLASH_SIM_H_
+#define _SPI_FLASH_SIM_H_
+
+#include <stdint.h>
+#include "spi.h"
+
+/// Cost model, in system clock cycles
+typedef struct
+{
+    uint32_t spi_byte;          ///< SPI transfer of one byte
+    uint32_t spi_command;       ///< Chip select handling and driver overhead of a command
+    uint32_t dma_setup;         ///< Programming a DMA transfer
+    uint32_t crc_byte;          ///< crc32() per byte
+    uint32_t aes_block;         ///< AES_cbc_decrypt() per block
+    uint32_t page_program;      ///< Page Program busy time
+    uint32_t sector_erase;      ///< Sector erase busy time
+    uint32_t block32_erase;     ///< Block32 erase busy time
+    uint32_t block64_erase;     ///< Block64 erase busy time
+} spi_flash_sim_cost_t;
+
+/// Statistics since spi_flash_sim_reset()
+typedef struct
+{
+    uint32_t commands;          ///< Commands other than status reads
+    uint32_t status_reads;      ///< Status Register reads
+    uint32_t busy_status_reads; ///< Status Register reads while busy
+    uint32_t page_programs;     ///< Page Program commands
+    uint32_t erases[3];         ///< Sector, Block32 and Block64 erases
+    uint64_t busy_cycles;       ///< Time spent programming and erasing
+    uint32_t errors;            ///< Protocol errors
+} spi_flash_sim_stats_t;
+
+/**
+ ****************************************************************************************
+ * @brief Called when the flash executes a command other than a status read
+ * @param[in] opcode    command
+ * @param[in] address   address, for commands with an address
+ * @param[in] length    data bytes transferred after the command and address
+ * @param[in] cycles    modelled clock at the end of the command
+ ****************************************************************************************
+ */
+typedef void (*spi_flash_sim_trace_t)(uint8_t opcode, uint32_t address, uint32_t length,
+                                      uint64_t cycles);
+
+/**
+ ****************************************************************************************
+ * @brief Load the flash contents from a file, the rest of the flash is erased (0xFF)
+ * @param[in] path      file name
+ * @return 0 on success, -1 if the file cannot be read
+ ****************************************************************************************
+ */
+int spi_flash_sim_load(const char *path);
+
+/**
+ ****************************************************************************************
+ * @brief Get the flash contents, for setting them up and checking them directly
+ * @return SPI_FLASH_DEV_SIZE bytes
+ ****************************************************************************************
+ */
+uint8_t *spi_flash_sim_memory(void);
+
+/**
+ ****************************************************************************************
+ * @brief Set the cost model, reset the clock and the statistics
+ ****************************************************************************************
+ */
+void spi_flash_sim_reset(const spi_flash_sim_cost_t *cost);
+
+/**
+ ****************************************************************************************
+ * @brief Set the command trace callback
+ * @param[in] trace     callback, NULL to stop tracing
+ ****************************************************************************************
+ */
+void spi_flash_sim_set_trace(spi_flash_sim_trace_t trace);
+
+/**
+ ****************************************************************************************
+ * @brief Charge CPU work done between transfers
+ * @param[in] cycles    system clock cycles
+ ****************************************************************************************
+ */
+void spi_flash_sim_charge(uint64_t cycles);
+
+/**
+ ****************************************************************************************
+ * @brief Get the modelled clock
+ * @return cycles since spi_flash_sim_reset()
+ ****************************************************************************************
+ */
+uint64_t spi_flash_sim_cycles(void);
+
+/**
+ ****************************************************************************************
+ * @brief Get the statistics
+ * @return statistics since spi_flash_sim_reset()
+ ****************************************************************************************
+ */
+const spi_flash_sim_stats_t *spi_flash_sim_stats(void);
+
+#endif
@@ -0,0 +1,29 @@
+/**
+ ****************************************************************************************
+ *
+ * @file uart_booter.h
+ *
+ * @brief Host replacement of the secondary bootloader memory layout.
+ *
+ * Copyright (C) 2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ ****************************************************************************************
+ */
+
+#ifndef _UART_BOOTER_H
+#define _UART_BOOTER_H
+
+#include <stdint.h>
+
+#define MAX_CODE_LENGTH             (0x12000)
+#define SYSRAM_COPY_BASE_ADDRESS    (0x2000)
+#define MAX_CODE_LENGTH_SPI         (MAX_CODE_LENGTH + SYSRAM_COPY_BASE_ADDRESS)
+#define MAX_CODE_LENGTH_I2C         (MAX_CODE_LENGTH + SYSRAM_COPY_BASE_ADDRESS)
+
+/// SYSRAM is a host buffer
+extern uint8_t host_sysram[MAX_CODE_LENGTH_SPI];
+#define SYSRAM_BASE_ADDRESS         ((uintptr_t) host_sysram)
+
+#endif
@@ -0,0 +1,18 @@
+/**
+ ****************************************************************************************
+ *
+ * @file user_config.h
+ *
+ * @brief Host replacement of the application user configuration, the bond database defaults are used.
+ *
+ * Copyright (C) 2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ ****************************************************************************************
+ */
+
+#ifndef _USER_CONFIG_H_
+#define _USER_CONFIG_H_
+
+#endif
@@ -0,0 +1,31 @@
+/**
+ ****************************************************************************************
+ *
+ * @file user_periph_setup.h
+ *
+ * @brief Host replacement of the secondary bootloader peripheral setup.
+ *
+ * Copyright (C) 2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ ****************************************************************************************
+ */
+
+#ifndef _USER_PERIPH_SETUP_H_
+#define _USER_PERIPH_SETUP_H_
+
+#include "gpio.h"
+
+#define SPI_FLASH_DEV_SIZE          (256 * 1024)
+
+#define SPI_EN_PORT                 GPIO_PORT_0
+#define SPI_EN_PIN                  GPIO_PIN_3
+#define SPI_CLK_PORT                GPIO_PORT_0
+#define SPI_CLK_PIN                 GPIO_PIN_0
+#define SPI_DO_PORT                 GPIO_PORT_0
+#define SPI_DO_PIN                  GPIO_PIN_0
+#define SPI_DI_PORT                 GPIO_PORT_0
+#define SPI_DI_PIN                  GPIO_PIN_0
+
+#endif
@@ -15,6 +15,9 @@
 #ifndef _GETOPT_H_
 #define _GETOPT_H_
 
+#ifndef _WIN32
+#include <unistd.h> // getopt() is provided by the C library
+#else
 extern char *__progname;
 
 int getopt( int nargc, char* const *nargv, const char*ostr); 
@@ -26,5 +29,6 @@ extern int
     optreset;        /* reset getopt */
 
 extern char *optarg; /* argument associated with option */
+#endif
 
 #endif /* _GETOPT_H_ */
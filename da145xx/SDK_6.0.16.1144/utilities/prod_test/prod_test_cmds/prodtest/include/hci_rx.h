@@ -0,0 +1,57 @@
+/**
+ ****************************************************************************************
+ *
+ * @file hci_rx.h
+ *
+ * @brief Reassembly of the HCI events and FE messages received from the UART.
+ *
+ * Copyright (C) 2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ ****************************************************************************************
+ */
+
+#ifndef _HCI_RX_H_
+#define _HCI_RX_H_
+
+#include <stdint.h>
+
+/* Size of the reassembly buffer, fits the largest FE message and HCI event */
+#define HCI_RX_BUFFER_SIZE 1000
+
+/*
+ ****************************************************************************************
+ * @brief Called for every complete message.
+ * @param[in] ctx          Context given to hci_rx_byte().
+ * @param[in] payload_type 0x04 = HCI event, 0x05 = FE_MSG
+ * @param[in] length       Message size, without the payload type.
+ * @param[in] data         Message, without the payload type.
+ ****************************************************************************************
+*/
+typedef void (*hci_rx_cb_t)(void *ctx, unsigned char payload_type, unsigned short length, uint8_t *data);
+
+/* Reassembly state of one UART */
+typedef struct {
+    unsigned char state;
+    unsigned char hdr_bytes_read;
+    unsigned short pos;
+    unsigned short data_length;
+    unsigned char buf[HCI_RX_BUFFER_SIZE];
+} hci_rx_t;
+
+void hci_rx_init(hci_rx_t *rx);
+
+/*
+ ****************************************************************************************
+ * @brief Process one received byte.
+ * @param[in] rx   Reassembly state.
+ * @param[in] byte Received byte.
+ * @param[in] cb   Called when the byte completes a message. The data are only valid during
+ *                 the call.
+ * @param[in] ctx  Passed to cb.
+ ****************************************************************************************
+*/
+void hci_rx_byte(hci_rx_t *rx, unsigned char byte, hci_rx_cb_t cb, void *ctx);
+
+#endif /* _HCI_RX_H_ */
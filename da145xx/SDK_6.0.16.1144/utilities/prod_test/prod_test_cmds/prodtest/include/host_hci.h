@@ -19,6 +19,10 @@
 
 #include "stdbool.h"
 
+#ifndef _WIN32
+#define __stdcall
+#endif
+
 typedef struct {
   unsigned short opcode;
   unsigned char length;
@@ -71,6 +75,15 @@ typedef struct {
 #define CMD__REGISTER_RW_OP_READ_REG16   (2)
 #define CMD__REGISTER_RW_OP_WRITE_REG16  (3)
 
+/*
+ * Transport used by send_hci_command(). The default (no transport set) sends the command
+ * through UARTSend(). A tool driving several devices sets a transport with its own context
+ * before calling each of the HCI command functions below.
+ */
+typedef void (*hci_send_func_t)(void *ctx, unsigned char payload_type, unsigned short payload_size, unsigned char *payload);
+
+void hci_set_transport(hci_send_func_t send, void *ctx);
+
 hci_evt_t *hci_recv_event_wait(unsigned int millis);
 void handle_hci_event( hci_evt_t * evt);
 
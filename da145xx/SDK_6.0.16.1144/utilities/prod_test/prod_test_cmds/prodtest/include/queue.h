@@ -15,14 +15,17 @@
 #ifndef QUEUE_H_
 #define QUEUE_H_
 
-#include <conio.h>
-#include <process.h>
 #include <stdlib.h>
 #include <time.h>
 #include <stdio.h>
-#include <windows.h>
-#include <process.h>
 #include <stddef.h>     // standard definition
+#ifdef _WIN32
+#include <conio.h>
+#include <process.h>
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
 
 
 // Queue stuff.
@@ -43,6 +46,7 @@ typedef struct {
 } QueueElement;
 
 
+#ifdef _WIN32
 // Used to stop the tasks.
 extern BOOL StopRxTask;
 
@@ -53,6 +57,18 @@ extern HANDLE Rx232Id;  // Thread handles
 extern QueueRecord UARTRxQueue; // UART Rx queue
 
 extern HANDLE QueueHasAvailableData; // set when the UART Rx queue is not empty
+#else
+// Used to stop the tasks.
+extern volatile int StopRxTask;
+
+extern pthread_mutex_t UARTRxQueueSem; // mutex to protect RX queue
+
+extern pthread_t Rx232Id;  // Thread handles
+
+extern QueueRecord UARTRxQueue; // UART Rx queue
+
+extern pthread_cond_t QueueHasAvailableData; // signalled when an element is added, with UARTRxQueueSem held
+#endif
 
 void EnQueue(QueueRecord *rec,void *vdata);
 void *DeQueue(QueueRecord *rec);
@@ -16,15 +16,29 @@
 #define _UART_H_
 
 #include <stdint.h>
-#include <windows.h>
 
 #define MAX_PACKET_LENGTH 350
 #define MIN_PACKET_LENGTH 9
 
+/*
+ * Port is the COM port number on Windows. Elsewhere it selects /dev/ttyUSB<Port>.
+ */
 uint8_t InitUART(int Port, int BaudRate);
 
-VOID UARTProc(PVOID unused);
+void UARTProc(void *unused);
 
 void UARTSend(unsigned char payload_type, unsigned short payload_size, unsigned char *payload);
 
+#ifndef _WIN32
+/*
+ ****************************************************************************************
+ * @brief Open a serial device in raw mode, 8N1, no flow control, non blocking.
+ * @param[in] device    Device path, e.g. /dev/ttyUSB0.
+ * @param[in] BaudRate  Baud rate.
+ * @return file descriptor / -1 on failure.
+ ****************************************************************************************
+*/
+int uart_open(const char *device, int BaudRate);
+#endif
+
 #endif /* _UART_H_ */
@@ -0,0 +1,1022 @@
+/**
+ ****************************************************************************************
+ *
+ * @file prodtest_multi.c
+ *
+ * @brief Runs a production test plan on several devices at the same time.
+ *
+ * Every device under test (DUT) has its own serial port, HCI reassembly state and step
+ * state machine. A single thread waits on all ports with epoll, so a DUT that is waiting
+ * for its command complete event or dwelling in a test mode does not hold back the others.
+ * The plan uses the prodtest command syntax, one command per line, plus "wait <ms>".
+ *
+ * Copyright (C) 2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ ****************************************************************************************
+ */
+
+#include <stdint.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <errno.h>
+#include <poll.h>
+#include <sys/epoll.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "uart.h"
+#include "hci_rx.h"
+#include "host_hci.h"
+#include "commands.h"
+#include "sdk_version.h"
+
+#define MAX_DUTS            32
+#define MAX_STEPS           64
+#define MAX_STEP_ARGS       8
+#define MAX_STEP_VALUES     4
+#define MAX_LINE_LENGTH     128
+
+/* command complete timeouts that differ from RX_TIMEOUT_MILLIS, as in commands.c */
+#define PKT_TX_TIMEOUT_MILLIS       60000
+#define XTRIM_CAL_TIMEOUT_MILLIS    15000
+
+#define CMD__XTRIM_OP_RD      0x00
+#define CMD__XTRIM_OP_WR      0x01
+#define CMD__XTRIM_OP_EN      0x02
+#define CMD__XTRIM_OP_INC     0x03
+#define CMD__XTRIM_OP_DEC     0x04
+#define CMD__XTRIM_OP_DIS     0x05
+#define CMD__XTRIM_OP_CALTEST 0x06
+#define CMD__XTRIM_OP_CAL     0x07
+
+#define UNMODULATED_CMD_MODE_OFF 0x4F
+#define UNMODULATED_CMD_MODE_TX  0x54
+#define UNMODULATED_CMD_MODE_RX  0x52
+
+enum step_kind {
+    STEP_WAIT,
+    STEP_RESET,
+    STEP_CONT_PKT_TX,
+    STEP_PKT_TX,
+    STEP_START_PKT_RX,
+    STEP_START_PKT_RX_STATS,
+    STEP_STOP_PKT_RX_STATS,
+    STEP_STOPTEST,
+    STEP_UNMODULATED,
+    STEP_START_CONT_TX,
+    STEP_STOP_CONT_TX,
+    STEP_XTRIM,
+    STEP_OTP,
+    STEP_READ_REG32,
+    STEP_WRITE_REG32,
+    STEP_READ_REG16,
+    STEP_WRITE_REG16,
+};
+
+typedef struct {
+    const char *name;
+    enum step_kind kind;
+    int min_argc;               // including the command name
+    int max_argc;
+    unsigned short opcode;      // of the command complete event
+    unsigned char evt_length;
+} plan_cmd_t;
+
+static const plan_cmd_t plan_cmds[] = {
+    { "wait",               STEP_WAIT,               2, 2, 0,                                     0  },
+    { "reset",              STEP_RESET,              1, 1, 0x0C03,                                4  },
+    { "cont_pkt_tx",        STEP_CONT_PKT_TX,        4, 4, 0x201E,                                4  },
+    { "pkt_tx",             STEP_PKT_TX,             5, 5, HCI_TX_TEST_CMD_OPCODE,                3  },
+    { "start_pkt_rx",       STEP_START_PKT_RX,       2, 2, 0x201D,                                4  },
+    { "start_pkt_rx_stats", STEP_START_PKT_RX_STATS, 2, 2, HCI_START_PROD_RX_TEST_CMD_OPCODE,     3  },
+    { "stop_pkt_rx_stats",  STEP_STOP_PKT_RX_STATS,  1, 1, HCI_END_PROD_RX_TEST_CMD_OPCODE,       11 },
+    { "stoptest",           STEP_STOPTEST,           1, 1, 0x201F,                                6  },
+    { "unmodulated",        STEP_UNMODULATED,        2, 3, HCI_UNMODULATED_ON_CMD_OPCODE,         3  },
+    { "start_cont_tx",      STEP_START_CONT_TX,      3, 3, HCI_TX_START_CONTINUE_TEST_CMD_OPCODE, 3  },
+    { "stop_cont_tx",       STEP_STOP_CONT_TX,       1, 1, HCI_TX_END_CONTINUE_TEST_CMD_OPCODE,   3  },
+    { "xtrim",              STEP_XTRIM,              2, 3, HCI_XTAL_TRIM_CMD_OPCODE,              5  },
+    { "otp",                STEP_OTP,                2, 3, HCI_OTP_RW_CMD_OPCODE,                 10 },
+    { "read_reg32",         STEP_READ_REG32,         2, 2, HCI_REGISTER_RW_CMD_OPCODE,            9  },
+    { "write_reg32",        STEP_WRITE_REG32,        3, 3, HCI_REGISTER_RW_CMD_OPCODE,            9  },
+    { "read_reg16",         STEP_READ_REG16,         2, 2, HCI_REGISTER_RW_CMD_OPCODE,            9  },
+    { "write_reg16",        STEP_WRITE_REG16,        3, 3, HCI_REGISTER_RW_CMD_OPCODE,            9  },
+};
+
+typedef struct {
+    const plan_cmd_t *cmd;
+    char text[MAX_LINE_LENGTH];     // command as written in the plan
+    uint32_t arg[4];
+    uint8_t bd_addr[6];
+    unsigned int timeout;           // command complete timeout, or dwell time of "wait"
+} step_t;
+
+typedef struct {
+    char name[32];
+    char value[24];
+} step_value_t;
+
+typedef struct {
+    int status;
+    long time_ms;
+    int nb_values;
+    step_value_t values[MAX_STEP_VALUES];
+} step_result_t;
+
+enum dut_state {
+    DUT_IDLE,
+    DUT_WAIT_EVENT,
+    DUT_DWELL,
+    DUT_DONE,
+    DUT_FAILED,
+};
+
+typedef struct {
+    char device[64];
+    int index;
+    int fd;
+    enum dut_state state;
+    int step;                       // current step
+    long long step_start;
+    long long deadline;             // of the event timeout or the dwell
+    long long start;
+    long long end;
+    hci_rx_t rx;
+    step_result_t result[MAX_STEPS];
+} dut_t;
+
+static step_t plan[MAX_STEPS];
+static int nb_steps;
+
+static dut_t duts[MAX_DUTS];
+static int nb_duts;
+static int nb_active_duts;
+
+static long long now_ms(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (long long) ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+/*
+ * PLAN PARSING
+ ****************************************************************************************
+ */
+
+static int parse_long(long *result, const char *str, long min, long max)
+{
+    char *endptr;
+
+    errno = 0;
+    *result = strtol(str, &endptr, 10);
+
+    return (endptr == str || endptr[0] || errno || *result < min || max < *result);
+}
+
+static int parse_hex(uint32_t *result, const char *str)
+{
+    return (sscanf(str, "%x", result) != 1);
+}
+
+static int parse_frequency(uint32_t *channel, const char *str)
+{
+    long result;
+
+    // an even number between 2402 and 2480
+    if (parse_long(&result, str, 2402, 2480) || (result % 2))
+        return 1;
+
+    *channel = (result - 2402) / 2;
+
+    return 0;
+}
+
+static int parse_gpio(uint32_t *gpio, const char *str)
+{
+    unsigned int port, pin;
+    char end;
+
+    // Px_y, encoded as 10 * x + y
+    if (sscanf(str, "P%u_%u%c", &port, &pin, &end) != 2 || port > 3 || pin > 9)
+        return 1;
+
+    *gpio = 10 * port + pin;
+
+    return 0;
+}
+
+static int parse_bd_addr(uint8_t bd_addr[6], const char *str)
+{
+    unsigned int b[6];
+    int i;
+
+    if (sscanf(str, "%02X:%02X:%02X:%02X:%02X:%02X", &b[5], &b[4], &b[3], &b[2], &b[1], &b[0]) != 6)
+        return 1;
+
+    for (i = 0; i < 6; i++)
+        bd_addr[i] = b[i];
+
+    return 0;
+}
+
+static int parse_step(step_t *step, int argc, char **argv)
+{
+    const plan_cmd_t *cmd = NULL;
+    long value;
+    size_t kk;
+
+    for (kk = 0; kk < sizeof(plan_cmds) / sizeof(plan_cmds[0]); kk++)
+    {
+        if (0 == strcmp(argv[0], plan_cmds[kk].name))
+        {
+            cmd = &plan_cmds[kk];
+            break;
+        }
+    }
+
+    if (cmd == NULL)
+        return SC_INVALID_COMMAND;
+
+    if (argc < cmd->min_argc || cmd->max_argc < argc)
+        return SC_WRONG_NUMBER_OF_ARGUMENTS;
+
+    step->cmd = cmd;
+    step->timeout = RX_TIMEOUT_MILLIS;
+
+    switch (cmd->kind)
+    {
+        case STEP_WAIT:
+            if (parse_long(&value, argv[1], 0, 3600000))
+                return SC_WRONG_NUMBER_OF_ARGUMENTS;
+            step->timeout = value;
+            break;
+
+        case STEP_RESET:
+        case STEP_STOP_PKT_RX_STATS:
+        case STEP_STOPTEST:
+        case STEP_STOP_CONT_TX:
+            break;
+
+        case STEP_PKT_TX:
+            if (parse_long(&value, argv[4], 1, 65535))
+                return SC_INVALID_NUMBER_OF_PACKETS_ARG;
+            step->arg[3] = value;
+            step->timeout = PKT_TX_TIMEOUT_MILLIS;
+            // fall through
+        case STEP_CONT_PKT_TX:
+            if (parse_frequency(&step->arg[0], argv[1]))
+                return SC_INVALID_FREQUENCY_ARG;
+            if (parse_long(&value, argv[2], 0, 255))
+                return SC_INVALID_DATA_LENGTH_ARG;
+            step->arg[1] = value;
+            if (parse_long(&value, argv[3], 0, 7))
+                return SC_INVALID_PAYLOAD_TYPE_ARG;
+            step->arg[2] = value;
+            break;
+
+        case STEP_START_PKT_RX:
+        case STEP_START_PKT_RX_STATS:
+            if (parse_frequency(&step->arg[0], argv[1]))
+                return SC_INVALID_FREQUENCY_ARG;
+            break;
+
+        case STEP_UNMODULATED:
+            if (0 == strcmp(argv[1], "OFF") || 0 == strcmp(argv[1], "off"))
+                step->arg[0] = UNMODULATED_CMD_MODE_OFF;
+            else if (0 == strcmp(argv[1], "TX") || 0 == strcmp(argv[1], "tx"))
+                step->arg[0] = UNMODULATED_CMD_MODE_TX;
+            else if (0 == strcmp(argv[1], "RX") || 0 == strcmp(argv[1], "rx"))
+                step->arg[0] = UNMODULATED_CMD_MODE_RX;
+            else
+                return SC_INVALID_UNMODULATED_CMD_MODE_ARG;
+            if (argc != ((step->arg[0] == UNMODULATED_CMD_MODE_OFF) ? 2 : 3))
+                return SC_WRONG_NUMBER_OF_ARGUMENTS;
+            if (argc == 3 && parse_frequency(&step->arg[1], argv[2]))
+                return SC_INVALID_FREQUENCY_ARG;
+            break;
+
+        case STEP_START_CONT_TX:
+            if (parse_frequency(&step->arg[0], argv[1]))
+                return SC_INVALID_FREQUENCY_ARG;
+            if (parse_long(&value, argv[2], 0, 7))
+                return SC_INVALID_PAYLOAD_TYPE_ARG;
+            step->arg[1] = value;
+            break;
+
+        case STEP_XTRIM:
+            if      (0 == strcmp(argv[1], "rd"))      step->arg[0] = CMD__XTRIM_OP_RD;
+            else if (0 == strcmp(argv[1], "wr"))      step->arg[0] = CMD__XTRIM_OP_WR;
+            else if (0 == strcmp(argv[1], "en"))      step->arg[0] = CMD__XTRIM_OP_EN;
+            else if (0 == strcmp(argv[1], "inc"))     step->arg[0] = CMD__XTRIM_OP_INC;
+            else if (0 == strcmp(argv[1], "dec"))     step->arg[0] = CMD__XTRIM_OP_DEC;
+            else if (0 == strcmp(argv[1], "dis"))     step->arg[0] = CMD__XTRIM_OP_DIS;
+            else if (0 == strcmp(argv[1], "caltest")) step->arg[0] = CMD__XTRIM_OP_CALTEST;
+            else if (0 == strcmp(argv[1], "cal"))     step->arg[0] = CMD__XTRIM_OP_CAL;
+            else
+                return SC_INVALID_XTAL_TRIMMING_CMD_OPERATION_ARG;
+
+            switch (step->arg[0])
+            {
+                case CMD__XTRIM_OP_RD:
+                case CMD__XTRIM_OP_EN:
+                case CMD__XTRIM_OP_DIS:
+                    if (argc != 2)
+                        return SC_WRONG_NUMBER_OF_ARGUMENTS;
+                    break;
+                case CMD__XTRIM_OP_CALTEST:
+                case CMD__XTRIM_OP_CAL:
+                    if (argc != 3)
+                        return SC_WRONG_NUMBER_OF_ARGUMENTS;
+                    if (parse_gpio(&step->arg[1], argv[2]))
+                        return SC_INVALID_GPIO_ARG;
+                    step->timeout = XTRIM_CAL_TIMEOUT_MILLIS;
+                    break;
+                default:
+                    if (argc != 3)
+                        return SC_WRONG_NUMBER_OF_ARGUMENTS;
+                    if (parse_long(&value, argv[2], 0, 0xFFFF))
+                        return SC_INVALID_XTAL_TRIMMING_CMD_TRIM_VALUE_ARG;
+                    step->arg[1] = value;
+                    break;
+            }
+            break;
+
+        case STEP_OTP:
+            if      (0 == strcmp(argv[1], "rd_xtrim"))  step->arg[0] = CMD__OTP_OP_RD_XTRIM;
+            else if (0 == strcmp(argv[1], "wr_xtrim"))  step->arg[0] = CMD__OTP_OP_WR_XTRIM;
+            else if (0 == strcmp(argv[1], "rd_bdaddr")) step->arg[0] = CMD__OTP_OP_RD_BDADDR;
+            else if (0 == strcmp(argv[1], "wr_bdaddr")) step->arg[0] = CMD__OTP_OP_WR_BDADDR;
+            else if (0 == strcmp(argv[1], "re_xtrim"))  step->arg[0] = CMD__OTP_OP_RE_XTRIM;
+            else if (0 == strcmp(argv[1], "we_xtrim"))  step->arg[0] = CMD__OTP_OP_WE_XTRIM;
+            else
+                return SC_INVALID_OTP_CMD_OPERATION_ARG;
+
+            if (argc != ((step->arg[0] == CMD__OTP_OP_WR_XTRIM || step->arg[0] == CMD__OTP_OP_WR_BDADDR) ? 3 : 2))
+                return SC_WRONG_NUMBER_OF_ARGUMENTS;
+
+            if (step->arg[0] == CMD__OTP_OP_WR_XTRIM)
+            {
+                if (parse_long(&value, argv[2], 0, 0xFFFF))
+                    return SC_INVALID_OTP_CMD_TRIM_VALUE_ARG;
+                step->arg[1] = value;
+            }
+            else if (step->arg[0] == CMD__OTP_OP_WR_BDADDR)
+            {
+                if (parse_bd_addr(step->bd_addr, argv[2]))
+                    return SC_INVALID_OTP_CMD_BDADDR_ARG;
+            }
+            break;
+
+        case STEP_READ_REG32:
+        case STEP_READ_REG16:
+        case STEP_WRITE_REG32:
+        case STEP_WRITE_REG16:
+            if (parse_hex(&step->arg[0], argv[1]))
+                return SC_INVALID_REGISTER_ADDRESS_ARG;
+            if (argc == 3 && parse_hex(&step->arg[1], argv[2]))
+                return SC_INVALID_REGISTER_VALUE_ARG;
+            if (cmd->kind == STEP_WRITE_REG16 && step->arg[1] > 0xFFFF)
+                return SC_INVALID_REGISTER_VALUE_ARG;
+            break;
+    }
+
+    return SC_NO_ERROR;
+}
+
+static int load_plan(const char *filename)
+{
+    char line[MAX_LINE_LENGTH];
+    char tokens[MAX_LINE_LENGTH];
+    char *argv[MAX_STEP_ARGS];
+    int argc, line_number = 0, rc;
+    char *p;
+    FILE *f = fopen(filename, "r");
+
+    if (f == NULL)
+    {
+        fprintf(stderr, "Cannot open test plan %s: %s\n", filename, strerror(errno));
+        return SC_MISSING_COMMAND;
+    }
+
+    while (fgets(line, sizeof(line), f))
+    {
+        line_number++;
+
+        // strip comments and line endings
+        if ((p = strpbrk(line, "#\r\n")) != NULL)
+            *p = 0;
+
+        strcpy(tokens, line);
+        for (argc = 0, p = strtok(tokens, " \t"); p && argc < MAX_STEP_ARGS; p = strtok(NULL, " \t"))
+            argv[argc++] = p;
+
+        if (argc == 0)
+            continue;
+
+        if (nb_steps == MAX_STEPS)
+        {
+            fprintf(stderr, "%s:%d: more than %d steps\n", filename, line_number, MAX_STEPS);
+            fclose(f);
+            return SC_WRONG_NUMBER_OF_ARGUMENTS;
+        }
+
+        rc = parse_step(&plan[nb_steps], argc, argv);
+        if (rc != SC_NO_ERROR)
+        {
+            fprintf(stderr, "%s:%d: invalid step \"%s\", status = %d\n", filename, line_number, argv[0], rc);
+            fclose(f);
+            return rc;
+        }
+
+        // keep a normalized copy of the command for the reports
+        plan[nb_steps].text[0] = 0;
+        for (rc = 0; rc < argc; rc++)
+        {
+            if (rc)
+                strcat(plan[nb_steps].text, " ");
+            strcat(plan[nb_steps].text, argv[rc]);
+        }
+
+        nb_steps++;
+    }
+
+    fclose(f);
+
+    if (nb_steps == 0)
+    {
+        fprintf(stderr, "Test plan %s has no steps\n", filename);
+        return SC_MISSING_COMMAND;
+    }
+
+    return SC_NO_ERROR;
+}
+
+/*
+ * DUT STATE MACHINE
+ ****************************************************************************************
+ */
+
+static void dut_send(void *ctx, unsigned char payload_type, unsigned short payload_size, unsigned char *payload)
+{
+    dut_t *dut = (dut_t *) ctx;
+    unsigned char buf[500];
+    unsigned short size = payload_size + 1;
+    unsigned short written = 0;
+    struct pollfd pfd = { dut->fd, POLLOUT, 0 };
+
+    buf[0] = payload_type; // message header
+    memcpy(&buf[1], payload, payload_size);
+
+    while (written < size)
+    {
+        ssize_t n = write(dut->fd, &buf[written], size - written);
+
+        if (n > 0)
+            written += n;
+        else if (n < 0 && errno != EAGAIN && errno != EINTR)
+            break;
+        else
+            poll(&pfd, 1, 100);
+    }
+}
+
+static void add_value(step_result_t *result, const char *name, const char *fmt, ...)
+{
+    va_list ap;
+    step_value_t *v;
+
+    if (result->nb_values == MAX_STEP_VALUES)
+        return;
+
+    v = &result->values[result->nb_values++];
+    snprintf(v->name, sizeof(v->name), "%s", name);
+
+    va_start(ap, fmt);
+    vsnprintf(v->value, sizeof(v->value), fmt, ap);
+    va_end(ap);
+}
+
+static void send_step(dut_t *dut, const step_t *step)
+{
+    uint8_t bd_addr[6];
+    int i, carry;
+
+    hci_set_transport(dut_send, dut);
+
+    switch (step->cmd->kind)
+    {
+        case STEP_WAIT:
+            break;
+        case STEP_RESET:
+            hci_reset();
+            break;
+        case STEP_CONT_PKT_TX:
+            hci_tx_test(step->arg[0], step->arg[1], step->arg[2]);
+            break;
+        case STEP_PKT_TX:
+            hci_dialog_tx_test(step->arg[0], step->arg[1], step->arg[2], step->arg[3]);
+            break;
+        case STEP_START_PKT_RX:
+            hci_rx_test(step->arg[0]);
+            break;
+        case STEP_START_PKT_RX_STATS:
+            hci_dialog_rx_readback_test(step->arg[0]);
+            break;
+        case STEP_STOP_PKT_RX_STATS:
+            hci_dialog_rx_readback_test_end();
+            break;
+        case STEP_STOPTEST:
+            hci_test_end();
+            break;
+        case STEP_UNMODULATED:
+            hci_dialog_unmodulated_rx_tx(step->arg[0], step->arg[1]);
+            break;
+        case STEP_START_CONT_TX:
+            hci_dialog_tx_continuous_start(step->arg[0], step->arg[1]);
+            break;
+        case STEP_STOP_CONT_TX:
+            hci_dialog_tx_continuous_end();
+            break;
+        case STEP_XTRIM:
+            hci_dialog_xtal_trimming(step->arg[0], step->arg[1]);
+            break;
+        case STEP_OTP:
+            switch (step->arg[0])
+            {
+                case CMD__OTP_OP_RD_XTRIM:  hci_dialog_otp_rd_xtrim();            break;
+                case CMD__OTP_OP_WR_XTRIM:  hci_dialog_otp_wr_xtrim(step->arg[1]); break;
+                case CMD__OTP_OP_RD_BDADDR: hci_dialog_otp_rd_bdaddr();           break;
+                case CMD__OTP_OP_RE_XTRIM:  hci_dialog_otp_re_xtrim();            break;
+                case CMD__OTP_OP_WE_XTRIM:  hci_dialog_otp_we_xtrim();            break;
+                case CMD__OTP_OP_WR_BDADDR:
+                    // every DUT gets its own address: plan address + DUT index
+                    for (i = 0, carry = dut->index; i < 6; i++)
+                    {
+                        carry += step->bd_addr[i];
+                        bd_addr[i] = carry & 0xFF;
+                        carry >>= 8;
+                    }
+                    hci_dialog_otp_wr_bdaddr(bd_addr);
+                    add_value(&dut->result[dut->step], "otp_bd_addr", "%02X:%02X:%02X:%02X:%02X:%02X",
+                              bd_addr[5], bd_addr[4], bd_addr[3], bd_addr[2], bd_addr[1], bd_addr[0]);
+                    break;
+            }
+            break;
+        case STEP_READ_REG32:
+            hci_dialog_read_reg32(step->arg[0]);
+            break;
+        case STEP_WRITE_REG32:
+            hci_dialog_write_reg32(step->arg[0], step->arg[1]);
+            break;
+        case STEP_READ_REG16:
+            hci_dialog_read_reg16(step->arg[0]);
+            break;
+        case STEP_WRITE_REG16:
+            hci_dialog_write_reg16(step->arg[0], step->arg[1]);
+            break;
+    }
+
+    hci_set_transport(NULL, NULL);
+}
+
+/*
+ * Check the command complete event of the current step and extract its return values,
+ * with the same rules as the prodtest command handlers.
+ */
+static int check_event(const step_t *step, const hci_evt_t *evt, step_result_t *result)
+{
+    const uint8_t *p = evt->parameters;
+    int status = SC_NO_ERROR;
+
+    if (!(evt->event == 0x0E
+          && evt->length == step->cmd->evt_length
+          && p[1] == (step->cmd->opcode & 0x00FF)
+          && p[2] == (step->cmd->opcode >> 8)))
+    {
+        return SC_UNEXPECTED_EVENT;
+    }
+
+    switch (step->cmd->kind)
+    {
+        case STEP_RESET:
+        case STEP_CONT_PKT_TX:
+        case STEP_START_PKT_RX:
+            if (p[3] != 0)
+                status = SC_HCI_STANDARD_ERROR_CODE_BASE + p[3];
+            break;
+
+        case STEP_STOPTEST:
+            if (p[3] != 0)
+                status = SC_HCI_STANDARD_ERROR_CODE_BASE + p[3];
+            add_value(result, "number_of_packets", "%d", p[4] + 256 * p[5]);
+            break;
+
+        case STEP_STOP_PKT_RX_STATS:
+            add_value(result, "nb_packets_received_correctly", "%d", p[3] + 256 * p[4]);
+            add_value(result, "nb_packets_with_syncerror", "%d", p[5] + 256 * p[6]);
+            add_value(result, "nb_packets_received_with_crcerr", "%d", p[7] + 256 * p[8]);
+            add_value(result, "rssi", "%.2f", (0.474f * (p[9] + 256 * p[10])) - 112.4f);
+            break;
+
+        case STEP_XTRIM:
+            switch (step->arg[0])
+            {
+                case CMD__XTRIM_OP_RD:
+                    add_value(result, "trim_value", "%d", p[3] + 256 * p[4]);
+                    break;
+                case CMD__XTRIM_OP_CALTEST:
+                case CMD__XTRIM_OP_CAL:
+                    if (p[3] + 256 * p[4] == 0x01)
+                        status = SC_XTAL_TRIMMING_CAL_OUT_OF_RANGE_ERROR;
+                    else if (p[3] + 256 * p[4] == 0x02)
+                        status = SC_XTAL_TRIMMING_CAL_FREQ_NOT_CONNECTED;
+                    break;
+            }
+            break;
+
+        case STEP_OTP:
+            switch (step->arg[0])
+            {
+                case CMD__OTP_OP_RD_XTRIM:
+                    add_value(result, "otp_xtrim_value", "%d", p[4] + 256 * p[5]);
+                    break;
+                case CMD__OTP_OP_RD_BDADDR:
+                    add_value(result, "otp_bd_addr", "%02X:%02X:%02X:%02X:%02X:%02X",
+                              p[9], p[8], p[7], p[6], p[5], p[4]);
+                    break;
+                case CMD__OTP_OP_RE_XTRIM:
+                    add_value(result, "otp_xtrim_enable", "%d", p[4]);
+                    break;
+            }
+            break;
+
+        case STEP_READ_REG32:
+            add_value(result, "value", "0x%08X", p[5] | (p[6] << 8) | (p[7] << 16) | ((uint32_t) p[8] << 24));
+            break;
+
+        case STEP_READ_REG16:
+            add_value(result, "value", "0x%04X", p[5] | (p[6] << 8));
+            break;
+
+        default:
+            break;
+    }
+
+    return status;
+}
+
+static void dut_start_step(dut_t *dut)
+{
+    const step_t *step;
+
+    if (dut->step == nb_steps)
+    {
+        dut->state = DUT_DONE;
+        dut->end = now_ms();
+        nb_active_duts--;
+        return;
+    }
+
+    step = &plan[dut->step];
+    dut->step_start = now_ms();
+    dut->deadline = dut->step_start + step->timeout;
+
+    if (step->cmd->kind == STEP_WAIT)
+    {
+        dut->state = DUT_DWELL;
+    }
+    else
+    {
+        dut->state = DUT_WAIT_EVENT;
+        send_step(dut, step);
+    }
+}
+
+static void dut_step_done(dut_t *dut, int status)
+{
+    step_result_t *result = &dut->result[dut->step];
+
+    result->status = status;
+    result->time_ms = (long) (now_ms() - dut->step_start);
+
+    if (status != SC_NO_ERROR)
+    {
+        // the rest of the plan is skipped for this DUT
+        dut->state = DUT_FAILED;
+        dut->end = now_ms();
+        nb_active_duts--;
+        return;
+    }
+
+    dut->step++;
+    dut_start_step(dut);
+}
+
+static void dut_rx(void *ctx, unsigned char payload_type, unsigned short length, uint8_t *data)
+{
+    dut_t *dut = (dut_t *) ctx;
+
+    // FE API messages and unsolicited events are ignored
+    if (payload_type != 0x04 || dut->state != DUT_WAIT_EVENT)
+        return;
+
+    dut_step_done(dut, check_event(&plan[dut->step], (const hci_evt_t *) data, &dut->result[dut->step]));
+}
+
+static void run_plan(void)
+{
+    struct epoll_event ev, events[MAX_DUTS];
+    long long now, next;
+    int epfd, n, kk, i;
+    ssize_t len;
+    unsigned char buf[256];
+    dut_t *dut;
+
+    epfd = epoll_create1(0);
+
+    for (kk = 0; kk < nb_duts; kk++)
+    {
+        ev.events = EPOLLIN;
+        ev.data.ptr = &duts[kk];
+        epoll_ctl(epfd, EPOLL_CTL_ADD, duts[kk].fd, &ev);
+    }
+
+    nb_active_duts = nb_duts;
+    for (kk = 0; kk < nb_duts; kk++)
+    {
+        duts[kk].start = now_ms();
+        dut_start_step(&duts[kk]);
+    }
+
+    while (nb_active_duts > 0)
+    {
+        // sleep until data arrive or the nearest timeout / dwell expires
+        now = now_ms();
+        next = now + 1000;
+        for (kk = 0; kk < nb_duts; kk++)
+        {
+            if ((duts[kk].state == DUT_WAIT_EVENT || duts[kk].state == DUT_DWELL) && duts[kk].deadline < next)
+                next = duts[kk].deadline;
+        }
+
+        n = epoll_wait(epfd, events, MAX_DUTS, (next > now) ? (int) (next - now) : 0);
+
+        for (i = 0; i < n; i++)
+        {
+            dut = (dut_t *) events[i].data.ptr;
+
+            while ((len = read(dut->fd, buf, sizeof(buf))) > 0)
+            {
+                for (kk = 0; kk < len; kk++)
+                    hci_rx_byte(&dut->rx, buf[kk], dut_rx, dut);
+            }
+        }
+
+        now = now_ms();
+        for (kk = 0; kk < nb_duts; kk++)
+        {
+            if (duts[kk].state == DUT_WAIT_EVENT && now >= duts[kk].deadline)
+                dut_step_done(&duts[kk], SC_RX_TIMEOUT);
+            else if (duts[kk].state == DUT_DWELL && now >= duts[kk].deadline)
+                dut_step_done(&duts[kk], SC_NO_ERROR);
+        }
+    }
+
+    close(epfd);
+}
+
+/*
+ * REPORTS
+ ****************************************************************************************
+ */
+
+static int dut_status(const dut_t *dut)
+{
+    return (dut->state == DUT_FAILED) ? dut->result[dut->step].status : SC_NO_ERROR;
+}
+
+static int dut_nb_steps_run(const dut_t *dut)
+{
+    return (dut->state == DUT_FAILED) ? dut->step + 1 : dut->step;
+}
+
+static void write_csv(const char *filename)
+{
+    FILE *f = fopen(filename, "w");
+    const step_result_t *r;
+    int kk, s, v;
+
+    if (f == NULL)
+    {
+        fprintf(stderr, "Cannot write %s: %s\n", filename, strerror(errno));
+        return;
+    }
+
+    fprintf(f, "device,step,command,status,time_ms,values\n");
+
+    for (kk = 0; kk < nb_duts; kk++)
+    {
+        for (s = 0; s < dut_nb_steps_run(&duts[kk]); s++)
+        {
+            r = &duts[kk].result[s];
+            fprintf(f, "%s,%d,%s,%d,%ld,", duts[kk].device, s + 1, plan[s].text, r->status, r->time_ms);
+            for (v = 0; v < r->nb_values; v++)
+                fprintf(f, "%s%s=%s", v ? ";" : "", r->values[v].name, r->values[v].value);
+            fprintf(f, "\n");
+        }
+    }
+
+    fclose(f);
+}
+
+static void write_json_value(FILE *f, const char *value)
+{
+    char *endptr;
+
+    strtod(value, &endptr);
+
+    if (value[0] && !endptr[0] && strncmp(value, "0x", 2))
+        fprintf(f, "%s", value);
+    else
+        fprintf(f, "\"%s\"", value);
+}
+
+static void write_json(const char *filename, long long wall_time)
+{
+    FILE *f = fopen(filename, "w");
+    const step_result_t *r;
+    int kk, s, v;
+
+    if (f == NULL)
+    {
+        fprintf(stderr, "Cannot write %s: %s\n", filename, strerror(errno));
+        return;
+    }
+
+    fprintf(f, "{\n  \"wall_time_ms\": %lld,\n  \"duts\": [\n", wall_time);
+
+    for (kk = 0; kk < nb_duts; kk++)
+    {
+        fprintf(f, "    {\n      \"device\": \"%s\",\n      \"status\": %d,\n      \"time_ms\": %lld,\n      \"steps\": [\n",
+                duts[kk].device, dut_status(&duts[kk]), duts[kk].end - duts[kk].start);
+
+        for (s = 0; s < dut_nb_steps_run(&duts[kk]); s++)
+        {
+            r = &duts[kk].result[s];
+            fprintf(f, "        { \"command\": \"%s\", \"status\": %d, \"time_ms\": %ld, \"values\": {",
+                    plan[s].text, r->status, r->time_ms);
+            for (v = 0; v < r->nb_values; v++)
+            {
+                fprintf(f, "%s\"%s\": ", v ? ", " : " ", r->values[v].name);
+                write_json_value(f, r->values[v].value);
+            }
+            fprintf(f, "%s} }%s\n", r->nb_values ? " " : "", (s + 1 < dut_nb_steps_run(&duts[kk])) ? "," : "");
+        }
+
+        fprintf(f, "      ]\n    }%s\n", (kk + 1 < nb_duts) ? "," : "");
+    }
+
+    fprintf(f, "  ]\n}\n");
+
+    fclose(f);
+}
+
+static void print_summary(long long wall_time)
+{
+    long long serial_time = 0;
+    const dut_t *dut;
+    int kk;
+
+    printf("%-20s %-8s %-8s %s\n", "device", "status", "steps", "time_ms");
+
+    for (kk = 0; kk < nb_duts; kk++)
+    {
+        dut = &duts[kk];
+        printf("%-20s %-8d %3d/%-4d %lld", dut->device, dut_status(dut), dut_nb_steps_run(dut), nb_steps,
+               dut->end - dut->start);
+        if (dut->state == DUT_FAILED)
+            printf("   failed at step %d: %s", dut->step + 1, plan[dut->step].text);
+        printf("\n");
+
+        serial_time += dut->end - dut->start;
+    }
+
+    printf("wall time = %lld ms, sum of DUT times = %lld ms\n", wall_time, serial_time);
+}
+
+static void print_usage(void)
+{
+    printf("Usage: \n\n");
+
+    printf("prodtest_multi -h \n");
+    printf("prodtest_multi -v \n");
+    printf("prodtest_multi [-b <baud rate>] [-c <csv file>] [-j <json file>] <test plan> <device> [<device> ...] \n\n");
+
+    printf("A device is a serial port path or a number n for /dev/ttyUSB<n>. \n");
+    printf("The test plan has one prodtest command per line, e.g. \"pkt_tx 2402 37 0 1000\", \n");
+    printf("and \"wait <milliseconds>\" to let the DUT stay in the current test mode. \n");
+    printf("\"otp wr_bdaddr <BD address>\" writes <BD address> + n to the n-th device (n = 0, 1, ...). \n");
+}
+
+int main(int argc, char **argv)
+{
+    const char *csv_file = NULL;
+    const char *json_file = NULL;
+    long baud_rate = 115200;
+    long long wall_start, wall_time;
+    int opt, rc, kk;
+
+    while ((opt = getopt(argc, argv, "hvb:c:j:")) != -1)
+    {
+        switch (opt)
+        {
+            case 'h':
+                print_usage();
+                exit(SC_NO_ERROR);
+            case 'v':
+                printf("%s\n", SDK_VERSION);
+                exit(SC_NO_ERROR);
+            case 'b':
+                baud_rate = strtol(optarg, NULL, 10);
+                break;
+            case 'c':
+                csv_file = optarg;
+                break;
+            case 'j':
+                json_file = optarg;
+                break;
+            default:
+                print_usage();
+                exit(SC_WRONG_NUMBER_OF_ARGUMENTS);
+        }
+    }
+
+    if (argc - optind < 2)
+    {
+        print_usage();
+        exit(argc == optind ? SC_MISSING_COMMAND : SC_COM_PORT_NOT_SPECIFIED);
+    }
+
+    rc = load_plan(argv[optind++]);
+    if (rc != SC_NO_ERROR)
+        exit(rc);
+
+    if (argc - optind > MAX_DUTS)
+    {
+        fprintf(stderr, "At most %d devices are supported \n", MAX_DUTS);
+        exit(SC_INVALID_COM_PORT_NUMBER);
+    }
+
+    for (; optind < argc; optind++, nb_duts++)
+    {
+        dut_t *dut = &duts[nb_duts];
+        const char *p = argv[optind];
+
+        while (isdigit((unsigned char) *p))
+            p++;
+
+        if (*p == 0)
+            snprintf(dut->device, sizeof(dut->device), "/dev/ttyUSB%s", argv[optind]);
+        else
+            snprintf(dut->device, sizeof(dut->device), "%s", argv[optind]);
+
+        dut->index = nb_duts;
+        dut->state = DUT_IDLE;
+        hci_rx_init(&dut->rx);
+
+        dut->fd = uart_open(dut->device, baud_rate);
+        if (dut->fd < 0)
+        {
+            fprintf(stderr, "Cannot open %s \n", dut->device);
+            exit(SC_COM_PORT_INIT_ERROR);
+        }
+    }
+
+    wall_start = now_ms();
+    run_plan();
+    wall_time = now_ms() - wall_start;
+
+    print_summary(wall_time);
+
+    if (csv_file)
+        write_csv(csv_file);
+    if (json_file)
+        write_json(json_file, wall_time);
+
+    // exit with the status of the first failed DUT, as prodtest does for one DUT
+    for (kk = 0; kk < nb_duts; kk++)
+    {
+        close(duts[kk].fd);
+        if (rc == SC_NO_ERROR)
+            rc = dut_status(&duts[kk]);
+    }
+
+    return rc;
+}
@@ -15,8 +15,12 @@
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <errno.h>
 
+#ifdef _WIN32
 #include <windows.h>
+#endif
 
 #include "uart.h"
 #include "queue.h"
@@ -0,0 +1,167 @@
+/**
+ ****************************************************************************************
+ *
+ * @file hci_rx.c
+ *
+ * @brief Reassembly of the HCI events and FE messages received from the UART.
+ *
+ * Copyright (C) 2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ ****************************************************************************************
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "uart.h"
+#include "hci_rx.h"
+
+//#define COMM_DEBUG
+
+enum {
+    RX_STATE_IDLE           = 0,
+    RX_STATE_FE_HEADER      = 1,    // FE_MSG type, dstid, srcid
+    RX_STATE_FE_LENGTH_LSB  = 2,
+    RX_STATE_FE_LENGTH_MSB  = 3,
+    RX_STATE_FE_DATA        = 4,
+    RX_STATE_EVT_CODE       = 11,
+    RX_STATE_EVT_LENGTH     = 12,
+    RX_STATE_EVT_DATA       = 13,
+    RX_STATE_ECHO_OPCODE    = 21,   // HCI command echoed on 1-wire UART
+    RX_STATE_ECHO_LENGTH    = 22,
+    RX_STATE_ECHO_DATA      = 23,
+};
+
+void hci_rx_init(hci_rx_t *rx)
+{
+    memset(rx, 0, sizeof(*rx));
+}
+
+static void hci_rx_start(hci_rx_t *rx, unsigned char byte, unsigned char state)
+{
+    rx->state = state;
+    rx->data_length = 0;
+    rx->hdr_bytes_read = 0;
+    rx->buf[0] = byte;
+    rx->pos = 1;
+}
+
+void hci_rx_byte(hci_rx_t *rx, unsigned char byte, hci_rx_cb_t cb, void *ctx)
+{
+#ifdef COMM_DEBUG
+    printf("%02X ", byte);
+#endif
+
+    switch (rx->state)
+    {
+        case RX_STATE_IDLE:
+            if (byte == 0x05)       // FE_MSG
+                hci_rx_start(rx, byte, RX_STATE_FE_HEADER);
+            else if (byte == 0x04)  // HCI event
+                hci_rx_start(rx, byte, RX_STATE_EVT_CODE);
+            else if (byte == 0x01)  // 1-wire echo
+                hci_rx_start(rx, byte, RX_STATE_ECHO_OPCODE);
+            break;
+
+        case RX_STATE_FE_HEADER:    // header size = 6
+            rx->buf[rx->pos++] = byte;
+            if (++rx->hdr_bytes_read == 6)
+                rx->state = RX_STATE_FE_LENGTH_LSB;
+            break;
+
+        case RX_STATE_FE_LENGTH_LSB:
+            rx->data_length = byte;
+            if (rx->data_length > MAX_PACKET_LENGTH)
+            {
+                rx->state = RX_STATE_IDLE;
+            }
+            else
+            {
+                rx->buf[rx->pos++] = byte;
+                rx->state = RX_STATE_FE_LENGTH_MSB;
+            }
+            break;
+
+        case RX_STATE_FE_LENGTH_MSB:
+            rx->data_length += (unsigned short) (byte * 256);
+            if (rx->data_length > MAX_PACKET_LENGTH)
+            {
+                rx->state = RX_STATE_IDLE;
+            }
+            else if (rx->data_length == 0)
+            {
+                cb(ctx, 0x05, (unsigned short) (rx->pos - 1), &rx->buf[1]);
+                rx->state = RX_STATE_IDLE;
+            }
+            else
+            {
+                rx->buf[rx->pos++] = byte;
+                rx->state = RX_STATE_FE_DATA;
+            }
+            break;
+
+        case RX_STATE_FE_DATA:
+            rx->buf[rx->pos++] = byte;
+            // 1 (first byte - 0x05) + 2 (type) + 2 (dstid) + 2 (srcid) + 2 (length)
+            if (rx->pos == rx->data_length + 9)
+            {
+                cb(ctx, 0x05, (unsigned short) (rx->pos - 1), &rx->buf[1]);
+                rx->state = RX_STATE_IDLE;
+            }
+            break;
+
+        case RX_STATE_EVT_CODE:
+            rx->buf[rx->pos++] = byte;
+            rx->state = RX_STATE_EVT_LENGTH;
+            break;
+
+        case RX_STATE_EVT_LENGTH:
+            rx->data_length = byte;
+            rx->buf[rx->pos++] = byte;
+            if (rx->data_length == 0)
+            {
+                cb(ctx, 0x04, (unsigned short) (rx->pos - 1), &rx->buf[1]);
+                rx->state = RX_STATE_IDLE;
+            }
+            else
+            {
+                rx->state = RX_STATE_EVT_DATA;
+            }
+            break;
+
+        case RX_STATE_EVT_DATA:
+            rx->buf[rx->pos++] = byte;
+            // 1 (first byte - 0x04) + 1 (event) + 1 (length)
+            if (rx->pos == rx->data_length + 3)
+            {
+                cb(ctx, 0x04, (unsigned short) (rx->pos - 1), &rx->buf[1]);
+                rx->state = RX_STATE_IDLE;
+            }
+            break;
+
+        case RX_STATE_ECHO_OPCODE:
+            rx->buf[rx->pos++] = byte;
+            if (++rx->hdr_bytes_read == 2)
+                rx->state = RX_STATE_ECHO_LENGTH;
+            break;
+
+        case RX_STATE_ECHO_LENGTH:
+            rx->buf[rx->pos++] = byte;
+            rx->data_length = byte;
+            rx->state = (rx->data_length == 0) ? RX_STATE_IDLE : RX_STATE_ECHO_DATA;
+            break;
+
+        case RX_STATE_ECHO_DATA:
+            rx->buf[rx->pos++] = byte;
+            // 1 (first byte - 0x01) + 2 (opcode) + 1 (length) + x (data)
+            if (rx->pos == rx->data_length + 4)
+                rx->state = RX_STATE_IDLE;
+            break;
+
+        default:
+            rx->state = RX_STATE_IDLE;
+            break;
+    }
+}
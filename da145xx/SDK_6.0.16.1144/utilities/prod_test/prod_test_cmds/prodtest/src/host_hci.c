@@ -12,14 +12,20 @@
  ****************************************************************************************
  */
 
-#include <malloc.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <signal.h>
+#include <stdint.h>         
+#ifdef _WIN32
+#include <malloc.h>
 #include <windows.h>
 #include <conio.h>
-#include <stdint.h>         
+#else
+#include <errno.h>
+#include <pthread.h>
+#include <time.h>
+#endif
 
 #include "host_hci.h"
 #include "uart.h"
@@ -27,6 +33,15 @@
 
 /* HCI TEST MODE */
 
+static hci_send_func_t hci_send_func;
+static void *hci_send_ctx;
+
+void hci_set_transport(hci_send_func_t send, void *ctx)
+{
+	hci_send_func = send;
+	hci_send_ctx = ctx;
+}
+
 void send_hci_command(hci_cmd_t *cmd)
 {
 #ifdef DEVELOPMENT_MESSAGES
@@ -44,14 +59,17 @@ void send_hci_command(hci_cmd_t *cmd)
 	fprintf(stderr, "\n");
 #endif //DEVELOPMENT_MESSAGES
 
-	UARTSend(0x01, cmd->length + 3/*sizeof(hci_cmd_header_t)*/, (unsigned char *) cmd);
+	if (hci_send_func)
+		hci_send_func(hci_send_ctx, 0x01, cmd->length + 3/*sizeof(hci_cmd_header_t)*/, (unsigned char *) cmd);
+	else
+		UARTSend(0x01, cmd->length + 3/*sizeof(hci_cmd_header_t)*/, (unsigned char *) cmd);
 
 	free(cmd);
 }
 
 void *alloc_hci_command(unsigned short opcode, unsigned char length)
 {
-    hci_cmd_t *cmd = (hci_cmd_t *) malloc(sizeof(hci_cmd_t) + length - sizeof (unsigned char));
+    hci_cmd_t *cmd = (hci_cmd_t *) malloc(sizeof(hci_cmd_t) + length);
 
     cmd->opcode = opcode;
 	cmd->length = length;
@@ -65,9 +83,15 @@ void *alloc_hci_command(unsigned short opcode, unsigned char length)
 hci_evt_t *hci_recv_event_wait(unsigned int millis)
 {	
 	QueueElement *qe;
+#ifdef _WIN32
 	DWORD dw;
+#else
+	struct timespec deadline;
+	int rc = 0;
+#endif
 	hci_evt_t *evt;
 	
+#ifdef _WIN32
 	dw = WaitForSingleObject(QueueHasAvailableData, millis); // wait until elements are available
 	if (dw != WAIT_OBJECT_0)	
 	{
@@ -77,6 +101,27 @@ hci_evt_t *hci_recv_event_wait(unsigned int millis)
 	WaitForSingleObject(UARTRxQueueSem, INFINITE);
 	qe = (QueueElement *) DeQueue(&UARTRxQueue); 
 	ReleaseMutex(UARTRxQueueSem);
+#else
+	clock_gettime(CLOCK_REALTIME, &deadline);
+	deadline.tv_sec += millis / 1000;
+	deadline.tv_nsec += (millis % 1000) * 1000000L;
+	if (deadline.tv_nsec >= 1000000000L)
+	{
+		deadline.tv_sec++;
+		deadline.tv_nsec -= 1000000000L;
+	}
+
+	pthread_mutex_lock(&UARTRxQueueSem);
+	while (UARTRxQueue.First == NULL && rc != ETIMEDOUT) // wait until elements are available
+		rc = pthread_cond_timedwait(&QueueHasAvailableData, &UARTRxQueueSem, &deadline);
+	qe = (QueueElement *) DeQueue(&UARTRxQueue);
+	pthread_mutex_unlock(&UARTRxQueueSem);
+
+	if (qe == NULL)
+	{
+		return 0;
+	}
+#endif
 
 	evt = (hci_evt_t *) qe->payload;
 
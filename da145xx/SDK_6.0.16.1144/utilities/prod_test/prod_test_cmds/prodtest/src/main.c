@@ -14,8 +14,11 @@
 
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 
+#ifdef _WIN32
 #include <windows.h>
+#endif
 
 #include "uart.h"
 #include "queue.h"
@@ -96,7 +99,9 @@ int main(int argc, char **argv)
 	int cmd_argc;
 	char ** cmd_argv;
 
+#ifdef _WIN32
 	__progname = argv[0]; // used by getopt
+#endif
 
 	// parse command line switches
 	while( ( opt = getopt( argc, argv, "hvp:" ) )!= -1 )  
@@ -16,6 +16,7 @@
 //////////#include "console.h"
 #include "uart.h"
 
+#ifdef _WIN32
 // Used to stop the tasks.
 BOOL StopRxTask;
 
@@ -41,6 +42,39 @@ void InitTasks(void)
    QueueHasAvailableData = CreateEvent(0, TRUE, FALSE, NULL);
 }
 
+#define QUEUE_SET_AVAILABLE()   SetEvent(QueueHasAvailableData)
+#define QUEUE_RESET_AVAILABLE() ResetEvent(QueueHasAvailableData)
+#else
+// Used to stop the tasks.
+volatile int StopRxTask;
+
+pthread_mutex_t UARTRxQueueSem = PTHREAD_MUTEX_INITIALIZER;
+
+pthread_t Rx232Id; // Thread handles
+
+QueueRecord UARTRxQueue; //Queues UARTRx -> Main thread
+
+pthread_cond_t QueueHasAvailableData = PTHREAD_COND_INITIALIZER;
+
+static void *UARTThread(void *unused)
+{
+   UARTProc(unused);
+
+   return NULL;
+}
+
+void InitTasks(void)
+{
+   StopRxTask = 0;
+
+   pthread_create(&Rx232Id, NULL, UARTThread, NULL);
+}
+
+// The queue is only accessed with UARTRxQueueSem held, waiters check it is not empty
+#define QUEUE_SET_AVAILABLE()   pthread_cond_signal(&QueueHasAvailableData)
+#define QUEUE_RESET_AVAILABLE()
+#endif
+
 void EnQueue(QueueRecord *rec,void *vdata)
 {
   struct QueueStorage *tmp;
@@ -54,7 +88,7 @@ void EnQueue(QueueRecord *rec,void *vdata)
     rec->Last->Next=tmp;
     rec->Last=tmp;
   }
-  SetEvent(QueueHasAvailableData);
+  QUEUE_SET_AVAILABLE();
 }
 
 void *DeQueue(QueueRecord *rec)
@@ -63,7 +97,7 @@ void *DeQueue(QueueRecord *rec)
   struct QueueStorage *tmpqe;
   if(rec->First==NULL)
   {
-	  ResetEvent(QueueHasAvailableData);
+	  QUEUE_RESET_AVAILABLE();
     return NULL;
   }
   tmpqe=rec->First;
@@ -71,6 +105,6 @@ void *DeQueue(QueueRecord *rec)
   tmp=tmpqe->Data;
   free(tmpqe);
   if(rec->First==NULL) 
-	  ResetEvent(QueueHasAvailableData);
+	  QUEUE_RESET_AVAILABLE();
   return tmp;
 }
@@ -23,6 +23,7 @@
 
 #include "queue.h"
 #include "uart.h"
+#include "hci_rx.h"
 
 //#define COMM_DEBUG
 
@@ -58,11 +59,13 @@ void UARTSend(unsigned char payload_type, unsigned short payload_size, unsigned
 /*
  ****************************************************************************************
  * @brief Send message received from UART to application's main thread.
+ * @param[in] ctx           Not used.
+ * @param[in] payload_type  0x04 = HCI event, 0x05 = FE_MSG
  * @param[in] length        Message size.
  * @param[in] bInputDataPtr Pointer to message data.
  ****************************************************************************************
 */
-void SendToMain(unsigned char payload_type, unsigned short length, uint8_t *bInputDataPtr)
+void SendToMain(void *ctx, unsigned char payload_type, unsigned short length, uint8_t *bInputDataPtr)
 {
 	QueueElement * qe; 
 	unsigned char *bDataPtr; 
@@ -92,15 +95,13 @@ void SendToMain(unsigned char payload_type, unsigned short length, uint8_t *bInp
  * @brief UART Reception thread loop.
  ****************************************************************************************
 */
-void UARTProc(PVOID unused)
+void UARTProc(void *unused)
 {
    unsigned long dwBytesRead;
    unsigned char tmp;
-   unsigned short wReceive232Pos= 0 ;
-   unsigned short wDataLength = 0;
-   unsigned char bReceive232ElementArr[1000];
-   unsigned char bReceiveState = 0;
-   unsigned char bHdrBytesRead = 0;
+   hci_rx_t rx;
+
+   hci_rx_init(&rx);
 
    while(StopRxTask == FALSE)
    {
@@ -118,192 +119,7 @@ void UARTProc(PVOID unused)
                            &dwBytesRead,
                            TRUE );
 
-      switch(bReceiveState)
-      {
-         case 0:   // Receive FE_MSG
-            if(tmp == 0x05)
-            {
-               bReceiveState = 1;
-			   wDataLength = 0;
-               wReceive232Pos = 0;
-			   bHdrBytesRead = 0;
-
-			   bReceive232ElementArr[wReceive232Pos]=tmp;
-			   wReceive232Pos++;
-
-				#ifdef COMM_DEBUG
-					printf("\nI: ");
-					printf("%02X ", tmp);
-				#endif   
-            }
-			else if (tmp == 0x04) // HCI event	
-			{
-					bReceiveState = 11; 
-					wDataLength = 0;
-					wReceive232Pos = 0;
-					bHdrBytesRead = 0;
-
-					bReceive232ElementArr[wReceive232Pos]=tmp;
-					wReceive232Pos++; 	
-			}
-			else if (tmp == 0x01) // 1-wire echo
-			{
-					bReceiveState = 21;
-					wDataLength = 0;
-					wReceive232Pos = 0;
-					bHdrBytesRead = 0;
-
-					bReceive232ElementArr[wReceive232Pos]=tmp;
-					wReceive232Pos++;
-			}
-            else
-            {
-                  #ifdef COMM_DEBUG
-                     printf("%02X ", tmp);
-                  #endif
-            }
-            break;
-
-		 case 1:   // Receive Header size = 6
-               #ifdef COMM_DEBUG
-                  printf("%02X ", tmp);
-               #endif
-			 bHdrBytesRead++;
-			 bReceive232ElementArr[wReceive232Pos] = tmp;
-			 wReceive232Pos++;
-
-			 if (bHdrBytesRead == 6)
-				 bReceiveState = 2;
-				
-			 break;
-		 case 2:   // Receive LSB of the length
-			#ifdef COMM_DEBUG
-				printf("%02X ", tmp);
-			#endif
-			wDataLength += tmp;
-            if(wDataLength > MAX_PACKET_LENGTH)
-            {
-                 bReceiveState = 0;
-            }
-            else
-			{
-				bReceive232ElementArr[wReceive232Pos] = tmp;
-				wReceive232Pos++;
-                bReceiveState = 3;
-			}
-          break;
-         case 3:   // Receive MSB of the length
-               #ifdef COMM_DEBUG
-                  printf("%02X ", tmp);
-               #endif
-            wDataLength += (unsigned short) (tmp*256);
-            if(wDataLength > MAX_PACKET_LENGTH)
-            {
-
-				#ifdef COMM_DEBUG
-					printf("\nSIZE: %d ", wDataLength);
-				#endif
-                bReceiveState = 0;
-            }
-			else if(wDataLength == 0)
-			{
-				#ifdef COMM_DEBUG
-					printf("\nSIZE: %d ", wDataLength);
-				#endif
-				SendToMain(0x05, (unsigned short) (wReceive232Pos-1), &bReceive232ElementArr[1]); // an FE msg
-                bReceiveState = 0;
-			}
-            else
-			{
-			   bReceive232ElementArr[wReceive232Pos] = tmp;
-			   wReceive232Pos++;
-               bReceiveState = 4;
-			}
-            break;
-         case 4:   // Receive Data
-			#ifdef COMM_DEBUG
-				printf("%02X ", tmp);
-            #endif
-            bReceive232ElementArr[wReceive232Pos] = tmp;
-            wReceive232Pos++;
-			
-            if(wReceive232Pos == wDataLength + 9 ) // 1 ( first byte - 0x05) + 2 (Type) + 2 (dstid) + 2 (srcid) + 2 (lengths size)
-            {
-               // Sendmail program
-               SendToMain(0x05, (unsigned short) (wReceive232Pos-1), &bReceive232ElementArr[1]); ///FE msg
-			   bReceiveState = 0;
-				#ifdef COMM_DEBUG
-					printf("\nSIZE: %d ", wDataLength);
-				#endif
-            }
-           break;
-
-			
-		 case 11:   // Receive HCI event type byte
-				bReceive232ElementArr[wReceive232Pos] = tmp;
-				wReceive232Pos++;
-
-				bReceiveState = 12;
-				break;
-	
-		 case 12:   // Receive HCI event length byte
-				wDataLength = tmp;
-				
-				if(wDataLength == 0)
-				{
-					bReceive232ElementArr[wReceive232Pos] = tmp;
-					wReceive232Pos++;
-
-					SendToMain(0x04, (unsigned short) (wReceive232Pos-1), &bReceive232ElementArr[1]);
-					bReceiveState = 0;
-				}
-				else
-				{
-					bReceive232ElementArr[wReceive232Pos] = tmp;
-					wReceive232Pos++;
-					bReceiveState = 13;
-				}
-				break;
-	
-		 case 13:   // Receive HCI event data
-				bReceive232ElementArr[wReceive232Pos] = tmp;
-				wReceive232Pos++;
-
-				if(wReceive232Pos == wDataLength + 3 ) // 1 ( first byte - 0x01) + 1 (event) + 1 (length)
-				{
-					SendToMain(0x04, (unsigned short) (wReceive232Pos-1), &bReceive232ElementArr[1]);
-					bReceiveState = 0;
-				}
-				break;
-
-		 case 21: // HCI Echo Send command Opcode
-				 bReceive232ElementArr[wReceive232Pos] = tmp;
-				 wReceive232Pos++;
-				 bHdrBytesRead++;
-				 if (bHdrBytesRead == 2)
-					 bReceiveState = 22;
-				 break;
-
-		 case 22: // HCI Echo Send command length
-				 bReceive232ElementArr[wReceive232Pos] = tmp;
-				 wReceive232Pos++;
-				 wDataLength = tmp;
-
-				 if (wDataLength == 0)
-					 bReceiveState = 0;
-				 else
-					 bReceiveState = 23;
-				 break;
-
-		 case 23: // HCI Echo Send command length - payload
-				 bReceive232ElementArr[wReceive232Pos] = tmp;
-				 wReceive232Pos++;
-
-				 if (wReceive232Pos == wDataLength + 4) // 1 ( first byte - 0x01) + 2 (opcode) + 1 (length) + x (data)
-					 bReceiveState = 0;
-				 break;
-      	 }
-      
+      hci_rx_byte(&rx, tmp, SendToMain, NULL);
    }
 
    StopRxTask = TRUE;   // To indicate that the task has stopped
@@ -0,0 +1,232 @@
+/**
+ ****************************************************************************************
+ *
+ * @file uart_posix.c
+ *
+ * @brief UART interface for HCI messages, POSIX termios implementation.
+ *
+ * Copyright (C) 2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ ****************************************************************************************
+ */
+
+#ifndef _WIN32
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include "queue.h"
+#include "uart.h"
+#include "hci_rx.h"
+
+//#define COMM_DEBUG
+
+static int uart_fd = -1;
+
+static speed_t baud_to_speed(int BaudRate)
+{
+	switch (BaudRate)
+	{
+		case 9600:    return B9600;
+		case 19200:   return B19200;
+		case 38400:   return B38400;
+		case 57600:   return B57600;
+		case 115200:  return B115200;
+		case 230400:  return B230400;
+#ifdef B460800
+		case 460800:  return B460800;
+#endif
+#ifdef B921600
+		case 921600:  return B921600;
+#endif
+#ifdef B1000000
+		case 1000000: return B1000000;
+#endif
+		default:      return 0;
+	}
+}
+
+int uart_open(const char *device, int BaudRate)
+{
+	struct termios tio;
+	speed_t speed = baud_to_speed(BaudRate);
+	int fd;
+
+	if (speed == 0)
+	{
+		fprintf(stderr, "Unsupported baud rate %d\n", BaudRate);
+		return -1;
+	}
+
+	fd = open(device, O_RDWR | O_NOCTTY | O_NONBLOCK);
+	if (fd < 0)
+	{
+#ifdef DEVELOPMENT_MESSAGES
+		fprintf(stderr, "Failed to open %s: %s\n", device, strerror(errno));
+#endif //DEVELOPMENT_MESSAGES
+		return -1;
+	}
+
+	if (tcgetattr(fd, &tio) != 0)
+	{
+		close(fd);
+		return -1;
+	}
+
+	// raw 8N1, disable all kind of flow control and error handling
+	cfmakeraw(&tio);
+	tio.c_cflag &= ~(CSTOPB | PARENB | CRTSCTS);
+	tio.c_cflag |= CLOCAL | CREAD;
+	tio.c_iflag &= ~(IXON | IXOFF | IXANY);
+	tio.c_cc[VMIN]  = 0;
+	tio.c_cc[VTIME] = 0;
+	cfsetispeed(&tio, speed);
+	cfsetospeed(&tio, speed);
+
+	if (tcsetattr(fd, TCSANOW, &tio) != 0)
+	{
+		close(fd);
+		return -1;
+	}
+
+	tcflush(fd, TCIOFLUSH);
+
+#ifdef DEVELOPMENT_MESSAGES
+	fprintf(stderr, "[info] %s successfully opened, baud rate %d\n", device, BaudRate);
+#endif //DEVELOPMENT_MESSAGES
+
+	return fd;
+}
+
+/*
+ ****************************************************************************************
+ * @brief Write message to UART.
+ * @param[in] payload_type 0x01 = HCI_CMD, 0x05 = FE_MSG
+ * @param[in] payload_size Message size.
+ * @param[in] payload      Pointer to message data.
+ ****************************************************************************************
+*/
+void UARTSend(unsigned char payload_type, unsigned short payload_size, unsigned char *payload)
+{
+	unsigned char bTransmit232ElementArr[500];
+	unsigned short bSenderSize;
+	unsigned short written = 0;
+	struct pollfd pfd = { uart_fd, POLLOUT, 0 };
+
+	bTransmit232ElementArr[0] = payload_type; // message header
+	memcpy(&bTransmit232ElementArr[1], payload, payload_size);
+
+	bSenderSize = payload_size + 1;
+
+	while (written < bSenderSize)
+	{
+		ssize_t n = write(uart_fd, &bTransmit232ElementArr[written], bSenderSize - written);
+
+		if (n > 0)
+			written += n;
+		else if (n < 0 && errno != EAGAIN && errno != EINTR)
+			break;
+		else
+			poll(&pfd, 1, 100);
+	}
+}
+
+/*
+ ****************************************************************************************
+ * @brief Send message received from UART to application's main thread.
+ * @param[in] ctx           Not used.
+ * @param[in] payload_type  0x04 = HCI event, 0x05 = FE_MSG
+ * @param[in] length        Message size.
+ * @param[in] bInputDataPtr Pointer to message data.
+ ****************************************************************************************
+*/
+static void SendToMain(void *ctx, unsigned char payload_type, unsigned short length, uint8_t *bInputDataPtr)
+{
+	QueueElement * qe;
+	unsigned char *bDataPtr;
+
+	// filter out FE API messages
+	if (payload_type == 0x05)
+	{
+		return;
+	}
+
+	qe = (QueueElement *) malloc(sizeof(QueueElement));
+	bDataPtr = (unsigned char *) malloc(length);
+
+	memcpy(bDataPtr, bInputDataPtr, length);
+
+	qe->payload_type = payload_type;
+	qe->payload_size = length;
+	qe->payload = bDataPtr;
+
+	pthread_mutex_lock(&UARTRxQueueSem);
+	EnQueue(&UARTRxQueue, qe);
+	pthread_mutex_unlock(&UARTRxQueueSem);
+}
+
+/*
+ ****************************************************************************************
+ * @brief UART Reception thread loop.
+ ****************************************************************************************
+*/
+void UARTProc(void *unused)
+{
+	unsigned char tmp[256];
+	struct pollfd pfd = { uart_fd, POLLIN, 0 };
+	hci_rx_t rx;
+	ssize_t n, i;
+
+	hci_rx_init(&rx);
+
+	while (!StopRxTask)
+	{
+		// wake up periodically to check StopRxTask
+		if (poll(&pfd, 1, 100) <= 0)
+			continue;
+
+		n = read(uart_fd, tmp, sizeof(tmp));
+		for (i = 0; i < n; i++)
+			hci_rx_byte(&rx, tmp[i], SendToMain, NULL);
+	}
+
+	StopRxTask = 1;   // To indicate that the task has stopped
+
+	tcflush(uart_fd, TCIOFLUSH);
+
+	close(uart_fd);
+	uart_fd = -1;
+}
+
+/*
+ ****************************************************************************************
+ * @brief Init UART iface.
+ * @param[in] Port     Selects /dev/ttyUSB<Port>.
+ * @param[in] BaudRate Baud rate.
+ * @return -1 on failure / 0 on success.
+ ****************************************************************************************
+*/
+uint8_t InitUART(int Port, int BaudRate)
+{
+	char CPName[64];
+
+	snprintf(CPName, sizeof(CPName), "/dev/ttyUSB%d", Port);
+
+#ifdef DEVELOPMENT_MESSAGES
+	fprintf(stderr, "[info] Connecting to %s\n", CPName);
+#endif //DEVELOPMENT_MESSAGES
+
+	uart_fd = uart_open(CPName, BaudRate);
+
+	return (uart_fd < 0) ? -1 : 0;
+}
+
+#endif /* _WIN32 */
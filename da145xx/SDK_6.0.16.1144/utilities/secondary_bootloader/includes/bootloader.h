@@ -142,6 +142,11 @@ typedef struct __bootHeader585_i2c{
 #define CODE_OFFSET                 64
 #define STATUS_INVALID_IMAGE        0x0
 #define STATUS_VALID_IMAGE          0xAA
+
+// The image is loaded, decrypted and checked in a single pass, in chunks of this size. With
+// SPI DMA the next chunk is read while the previous one is processed. It must be a multiple
+// of the AES block size (16) and not larger than 0xFFFF.
+#define LOAD_CHUNK_SIZE             (1024)
 //product header structure
 typedef struct __productHeader {
     uint8_t signature[2];
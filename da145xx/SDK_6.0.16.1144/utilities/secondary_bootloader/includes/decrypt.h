@@ -15,6 +15,12 @@
 #ifndef _DECRYPT_H
 #define _DECRYPT_H
 
+#include <stdint.h>
+
+void Decrypt_Init(void);
+
+void Decrypt_Chunk(uint8_t *data, int nsize);
+
 void Decrypt_Image(int nsize);
 
 #endif
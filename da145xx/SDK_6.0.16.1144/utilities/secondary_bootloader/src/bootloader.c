@@ -119,6 +119,108 @@ static uint8_t findlatest(uint8_t id1, uint8_t id2)
 
 extern uint32_t crc32(uint32_t crc, const void *buf, size_t size);
 
+/**
+ ****************************************************************************************
+ * @brief Process a chunk of the image loaded in SYSRAM
+ * @param[in] chunk: the chunk
+ * @param[in] len: size of the chunk
+ * @param[in] encryption: the image is encrypted
+ * @param[in] crc: CRC of the preceding chunks
+ * @return CRC including this chunk
+ ****************************************************************************************
+ */
+static uint32_t processChunk(uint8_t *chunk, uint32_t len, uint8_t encryption, uint32_t crc)
+{
+#if AES_ENCRYPTED_IMAGE_SUPPORTED
+    if (encryption)
+    {
+        Decrypt_Chunk(chunk, len);
+    }
+#endif
+    return crc32(crc, chunk, len);
+}
+
+/**
+ ****************************************************************************************
+ * @brief Load an image to SYSRAM, decrypt it and check its CRC in a single pass
+ * @details The image is read in chunks of LOAD_CHUNK_SIZE. Each chunk is decrypted and
+ * added to the CRC right after it has been read. With SPI DMA the next chunk is read in the
+ * background meanwhile, so the SPI transfer time is hidden behind the processing.
+ * @param[in] position: position of the image header in the non-volatile memory
+ * @param[in] codesize: size of the image
+ * @param[in] encryption: the image is encrypted
+ * @param[in] crc_image: expected CRC of the (decrypted) image
+ * @return Success (0) or Error Code.
+ ****************************************************************************************
+ */
+static int loadImage(uint32_t position, uint32_t codesize, uint8_t encryption, uint32_t crc_image)
+{
+    uint8_t *sys_ram = (uint8_t*)SYSRAM_BASE_ADDRESS;
+    uint32_t crc = 0;
+    uint32_t done = 0;
+
+    if (encryption && !AES_ENCRYPTED_IMAGE_SUPPORTED)
+    {
+        return -1;
+    }
+
+#if AES_ENCRYPTED_IMAGE_SUPPORTED
+    if (encryption)
+    {
+        Decrypt_Init();
+    }
+#endif
+
+#if defined (SPI_FLASH_SUPPORTED) && defined (CFG_SPI_DMA_SUPPORT)
+    uint32_t requested;
+
+    if (spi_flash_read_stream_start(position + CODE_OFFSET) != SPI_FLASH_ERR_OK)
+    {
+        return -1;
+    }
+
+    requested = codesize < LOAD_CHUNK_SIZE ? codesize : LOAD_CHUNK_SIZE;
+    if (requested)
+    {
+        spi_receive(sys_ram, requested, SPI_OP_DMA);
+    }
+
+    while (done < codesize)
+    {
+        uint32_t len = requested - done;
+
+        // Wait for the chunk to arrive, then start reading the next one
+        spi_wait_dma_read_to_finish();
+        if (requested < codesize)
+        {
+            uint32_t next = codesize - requested < LOAD_CHUNK_SIZE ?
+                            codesize - requested : LOAD_CHUNK_SIZE;
+
+            spi_receive(sys_ram + requested, next, SPI_OP_DMA);
+            requested += next;
+        }
+
+        crc = processChunk(sys_ram + done, len, encryption, crc);
+        done += len;
+    }
+
+    spi_flash_read_stream_stop();
+#else
+    while (done < codesize)
+    {
+        uint32_t len = codesize - done < LOAD_CHUNK_SIZE ? codesize - done : LOAD_CHUNK_SIZE;
+
+        FlashRead((unsigned long)(sys_ram + done),
+                  (unsigned long)position + CODE_OFFSET + done,
+                  (unsigned long)len);
+        crc = processChunk(sys_ram + done, len, encryption, crc);
+        done += len;
+    }
+#endif
+
+    return (crc == crc_image) ? 0 : -1;
+}
+
 /**
  ****************************************************************************************
  * @brief Load the active (latest and valid) image from a non-volatile memory
@@ -201,31 +303,11 @@ static int loadActiveImage(void)
 
     if (activeImage == 1)
     {
-        FlashRead(SYSRAM_BASE_ADDRESS,
-                  (unsigned long) imageposition1 + CODE_OFFSET,
-                  (unsigned long) codesize1);
-        #if AES_ENCRYPTED_IMAGE_SUPPORTED
-        if (image1_encryption)
-        {
-            Decrypt_Image(codesize1);
-        }
-        #endif
-        if ((image1_encryption && !AES_ENCRYPTED_IMAGE_SUPPORTED) ||
-            (crc_image1 != crc32(0, (uint8_t*)SYSRAM_BASE_ADDRESS, codesize1)))
+        if (loadImage(imageposition1, codesize1, image1_encryption, crc_image1) != 0)
         {
             if (images_status == 3)
             {
-                FlashRead(SYSRAM_BASE_ADDRESS,
-                          (unsigned long) imageposition2 + CODE_OFFSET,
-                          (unsigned long) codesize2);
-                #if AES_ENCRYPTED_IMAGE_SUPPORTED
-                if (image2_encryption)
-                {
-                    Decrypt_Image(codesize2);
-                }
-                #endif
-                if ((image2_encryption && !AES_ENCRYPTED_IMAGE_SUPPORTED) ||
-                    crc_image2 != crc32(0, (uint8_t*)SYSRAM_BASE_ADDRESS, codesize2))
+                if (loadImage(imageposition2, codesize2, image2_encryption, crc_image2) != 0)
                 {
                     return -1;
                 }
@@ -234,33 +316,13 @@ static int loadActiveImage(void)
     }
     else if (activeImage == 2)
     {
-        FlashRead(SYSRAM_BASE_ADDRESS,
-                  (unsigned long) imageposition2 + CODE_OFFSET,
-                  (unsigned long) codesize2);
-        #if AES_ENCRYPTED_IMAGE_SUPPORTED
-        if (image2_encryption)
-        {
-            Decrypt_Image(codesize2);
-        }
-        #endif
-        if ((image2_encryption && !AES_ENCRYPTED_IMAGE_SUPPORTED) ||
-            crc_image2 != crc32(0, (uint8_t*)SYSRAM_BASE_ADDRESS, codesize2))
+        if (loadImage(imageposition2, codesize2, image2_encryption, crc_image2) != 0)
         {
             if (images_status == 3)
             {
-                FlashRead(SYSRAM_BASE_ADDRESS,
-                          (unsigned long) imageposition1 + CODE_OFFSET,
-                          (unsigned long) codesize1);
-                #if AES_ENCRYPTED_IMAGE_SUPPORTED
-                if (image1_encryption)
+                if (loadImage(imageposition1, codesize1, image1_encryption, crc_image1) != 0)
                 {
-                    Decrypt_Image(codesize1);
-                }
-                #endif
-                if ((image1_encryption && !AES_ENCRYPTED_IMAGE_SUPPORTED) ||
-                    crc_image1 != crc32(0, (uint8_t*)SYSRAM_BASE_ADDRESS, codesize1))
-                {
-                        return -1;
+                    return -1;
                 }
             }
         }
@@ -14,6 +14,7 @@
 
 #include "sw_aes.h"
 #include "uart_booter.h"
+#include "decrypt.h"
 #if !defined (__DA14531__)
 #include "datasheet.h"
 #endif
@@ -22,6 +23,35 @@ AES_CTX ctx;
 const uint8_t Key[16]= {0x06,0xa9,0x21,0x40,0x36,0xb8,0xa1,0x5b,0x51,0x2e,0x03,0xd5,0x34,0x12,0x00,0x06};
 const uint8_t IV[16] = {0x3d,0xaf,0xba,0x42,0x9d,0x9e,0xb4,0x30,0xb4,0x22,0xda,0x80,0x2c,0x9f,0xac,0x41};
 
+/**
+ ****************************************************************************************
+ * @brief Prepares the decryption of an image with Decrypt_Chunk().
+ ****************************************************************************************
+ */
+void Decrypt_Init(void)
+{
+    AES_set_key(&ctx,Key,IV,AES_MODE_128);
+    AES_convert_key(&ctx);
+}
+
+/**
+ ****************************************************************************************
+ * @brief Decrypts the next part of the encrypted image in place.
+ * @details The CBC chaining value is kept in the context, so consecutive parts of the
+ *          image can be decrypted as they are loaded.
+ * @param[in] data  the part of the image
+ * @param[in] nsize the size of the part which is expected to be a multiple of
+ *                  AES_BLOCKSIZE.
+ ****************************************************************************************
+ */
+void Decrypt_Chunk(uint8_t *data, int nsize)
+{
+    AES_cbc_decrypt(&ctx, (const uint8_t *)data, data, nsize);
+#if !defined (__DA14531__)
+    SetWord16(WATCHDOG_REG, WATCHDOG_REG_RESET);
+#endif
+}
+
 /**
  ****************************************************************************************
  * @brief Decrypts the encrypted image in place.
@@ -31,18 +61,16 @@ const uint8_t IV[16] = {0x3d,0xaf,0xba,0x42,0x9d,0x9e,0xb4,0x30,0xb4,0x22,0xda,0
  */
 void Decrypt_Image(int nsize)
 {
-    AES_set_key(&ctx,Key,IV,AES_MODE_128);
-    AES_convert_key(&ctx);
+    Decrypt_Init();
 #if defined (__DA14531__)
-    AES_cbc_decrypt(&ctx, (const uint8_t *)SYSRAM_BASE_ADDRESS, (uint8_t *)SYSRAM_BASE_ADDRESS, nsize);
+    Decrypt_Chunk((uint8_t *)SYSRAM_BASE_ADDRESS, nsize);
 #else
     const int DECRYPT_CHUNK = 32 * AES_BLOCKSIZE;
     uint8_t *sys_ram = (uint8_t *)SYSRAM_BASE_ADDRESS;
 
-    for (int i = nsize; i >= 0; i -= DECRYPT_CHUNK)
+    for (int i = nsize; i > 0; i -= DECRYPT_CHUNK)
     {
-        AES_cbc_decrypt(&ctx, (const uint8_t *)sys_ram, sys_ram, DECRYPT_CHUNK);
-        SetWord16(WATCHDOG_REG, WATCHDOG_REG_RESET);
+        Decrypt_Chunk(sys_ram, i < DECRYPT_CHUNK ? i : DECRYPT_CHUNK);
         sys_ram += DECRYPT_CHUNK;
     }
 #endif
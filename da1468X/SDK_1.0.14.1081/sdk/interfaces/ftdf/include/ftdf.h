@@ -1758,6 +1758,10 @@ typedef struct {
  * ftdf_key_table_t               keyTable =
  *           { sizeof(key_descriptors) / sizeof(ftdf_key_descriptor_t), key_descriptors };
  * \endcode
+ * \remark With FTDF_SECURITY_KEY_INDEX_SIZE or FTDF_SECURITY_DEVICE_INDEX_SIZE set, the key and
+ *         device tables are indexed when FTDF_PIB_KEY_TABLE or FTDF_PIB_DEVICE_TABLE is set. After
+ *         changing key id lookup descriptors, device descriptor handles or device addresses in
+ *         place, set the table again.
  */
 typedef struct {
         /** \brief Number of key descriptors in the key table */
@@ -196,6 +196,33 @@
 #define FTDF_USE_SLEEP_DURING_BACKOFF           1
 #endif /* FTDF_USE_SLEEP_DURING_BACKOFF */
 
+#ifndef FTDF_SECURITY_KEY_INDEX_SIZE
+/**
+ * \brief Number of slots of the key id lookup index (0 or a power of 2).
+ *
+ * By default, secured frames look up their key and device by scanning the key and device tables,
+ * which is fast enough for the tables of a typical node. A non-zero size builds a hash index of
+ * the table when FTDF_PIB_KEY_TABLE or FTDF_PIB_DEVICE_TABLE is set. Each slot takes 2 bytes of
+ * retention RAM and holds one key id lookup descriptor. When the tables need more than 3/4 of the
+ * slots, the lookup falls back to scanning the tables.
+ *
+ * A coordinator with 100 or more devices and a key per device (key id mode 0) should set 256, or
+ * 512 for up to 255 devices.
+ */
+#define FTDF_SECURITY_KEY_INDEX_SIZE            0
+#endif /* FTDF_SECURITY_KEY_INDEX_SIZE */
+
+#ifndef FTDF_SECURITY_DEVICE_INDEX_SIZE
+/**
+ * \brief Number of slots of the device index (0 or a power of 2).
+ *
+ * 0 scans the device descriptor handles of the key. Otherwise, each handle takes a slot for the
+ * extended address and one for the short address. A coordinator with 100 or more devices should
+ * set 512, which covers 192 handles in 1 KB of retention RAM, or 1024 for up to 255 devices.
+ */
+#define FTDF_SECURITY_DEVICE_INDEX_SIZE         0
+#endif /* FTDF_SECURITY_DEVICE_INDEX_SIZE */
+
 
 #endif /* FTDF_CONFIG_MAC_API_H_ */
 
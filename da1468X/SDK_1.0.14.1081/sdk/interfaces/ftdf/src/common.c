@@ -340,11 +340,11 @@ const pib_attribute_table_h pib_attribute_table = {
         .attribute_defs[FTDF_PIB_KEY_TABLE].addr = &ftdf_pib.key_table,
         .attribute_defs[FTDF_PIB_KEY_TABLE].size = sizeof(ftdf_pib.key_table),
         .attribute_defs[FTDF_PIB_KEY_TABLE].getFunc = NULL,
-        .attribute_defs[FTDF_PIB_KEY_TABLE].setFunc = NULL,
+        .attribute_defs[FTDF_PIB_KEY_TABLE].setFunc = ftdf_update_security_index,
         .attribute_defs[FTDF_PIB_DEVICE_TABLE].addr = &ftdf_pib.device_table,
         .attribute_defs[FTDF_PIB_DEVICE_TABLE].size = sizeof(ftdf_pib.device_table),
         .attribute_defs[FTDF_PIB_DEVICE_TABLE].getFunc = NULL,
-        .attribute_defs[FTDF_PIB_DEVICE_TABLE].setFunc = NULL,
+        .attribute_defs[FTDF_PIB_DEVICE_TABLE].setFunc = ftdf_update_security_index,
         .attribute_defs[FTDF_PIB_SECURITY_LEVEL_TABLE].addr = &ftdf_pib.security_level_table,
         .attribute_defs[FTDF_PIB_SECURITY_LEVEL_TABLE].size = sizeof(ftdf_pib.security_level_table),
         .attribute_defs[FTDF_PIB_SECURITY_LEVEL_TABLE].getFunc = NULL,
@@ -669,6 +669,7 @@ void ftdf_reset(int set_default_pib)
 
 #ifndef FTDF_LITE
                 memset(ftdf_pib.default_key_source, 0xff, 8);
+                ftdf_update_security_index();
 #endif /* !FTDF_LITE */
                 ftdf_pib.bo_irq_threshold = FTDF_BO_IRQ_THRESHOLD;
                 ftdf_pib.link_quality_mode = FTDF_LINK_QUALITY_MODE_RSSI;
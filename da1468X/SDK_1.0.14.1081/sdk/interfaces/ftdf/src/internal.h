@@ -510,11 +510,12 @@ ftdf_key_descriptor_t *ftdf_lookup_key(ftdf_address_mode_t dev_addr_mode,
                                        ftdf_key_index_t    key_index,
                                        ftdf_octet_t        *key_source);
 
-ftdf_device_descriptor_t *ftdf_lookup_device(ftdf_size_t                     nr_of_device_descriptor_handles,
-                                             ftdf_device_descriptor_handle_t *device_descriptor_handles,
-                                             ftdf_address_mode_t             dev_addr_mode,
-                                             ftdf_pan_id_t                   dev_pan_id,
-                                             ftdf_address_t                  dev_addr);
+ftdf_device_descriptor_t *ftdf_lookup_device(ftdf_key_descriptor_t *key_descriptor,
+                                             ftdf_address_mode_t   dev_addr_mode,
+                                             ftdf_pan_id_t         dev_pan_id,
+                                             ftdf_address_t        dev_addr);
+
+void ftdf_update_security_index(void);
 
 ftdf_security_level_descriptor_t *ftdf_get_security_level_descr(ftdf_frame_type_t       frame_type,
                                                                 ftdf_command_frame_id_t command_frame_id);
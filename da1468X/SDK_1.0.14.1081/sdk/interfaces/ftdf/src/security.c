@@ -13,6 +13,7 @@
  */
 
 #include <stdlib.h>
+#include <string.h>
 #include <ftdf.h>
 #include "internal.h"
 
@@ -309,8 +310,7 @@ ftdf_status_t ftdf_unsecure_frame(ftdf_octet_t         *buf_ptr,
         }
 
         ftdf_device_descriptor_t *device_descr =
-            ftdf_lookup_device(key_descr->nr_of_device_descriptor_handles,
-                               key_descr->device_descriptor_handles,
+            ftdf_lookup_device(key_descr,
                                dev_addr_mode,
                                dev_pan_id,
                                dev_addr);
@@ -469,6 +469,317 @@ ftdf_status_t ftdf_unsecure_frame(ftdf_octet_t         *buf_ptr,
         return FTDF_SUCCESS;
 }
 
+#if (FTDF_SECURITY_KEY_INDEX_SIZE & (FTDF_SECURITY_KEY_INDEX_SIZE - 1)) || \
+    (FTDF_SECURITY_DEVICE_INDEX_SIZE & (FTDF_SECURITY_DEVICE_INDEX_SIZE - 1))
+#error "FTDF_SECURITY_KEY_INDEX_SIZE and FTDF_SECURITY_DEVICE_INDEX_SIZE must be 0 or powers of 2"
+#endif
+
+#if FTDF_SECURITY_KEY_INDEX_SIZE || FTDF_SECURITY_DEVICE_INDEX_SIZE
+
+/*
+ * Open addressing hash indexes of the key and device tables. A key index entry is the key
+ * descriptor and key id lookup descriptor numbers, a device index entry the key descriptor number
+ * and the device descriptor handle. Only the first of equal lookup descriptors or device addresses
+ * is entered, so that the lookups return the same descriptor as a scan of the tables.
+ */
+#define FTDF_INDEX_EMPTY                0xffff
+#define FTDF_INDEX_ENTRY(key, n)        (((key) << 8) | (n))
+#define FTDF_INDEX_SLOT(hash, size)     (((hash) >> 16) & ((size) - 1))
+
+static struct {
+#if FTDF_SECURITY_KEY_INDEX_SIZE
+        ftdf_boolean_t keys_valid;
+        uint16_t       keys[FTDF_SECURITY_KEY_INDEX_SIZE];
+#endif
+#if FTDF_SECURITY_DEVICE_INDEX_SIZE
+        ftdf_boolean_t devices_valid;
+        uint16_t       devices[FTDF_SECURITY_DEVICE_INDEX_SIZE];
+#endif
+} ftdf_security_index __attribute__ ((section(".retention")));
+
+static uint32_t ftdf_index_hash(uint32_t hash, uint32_t value)
+{
+        return (hash ^ value) * 0x9e3779b1;
+}
+#endif /* FTDF_SECURITY_KEY_INDEX_SIZE || FTDF_SECURITY_DEVICE_INDEX_SIZE */
+
+#if FTDF_SECURITY_KEY_INDEX_SIZE
+static uint32_t ftdf_key_id_hash(ftdf_key_id_mode_t  key_id_mode,
+                                 ftdf_address_mode_t dev_addr_mode,
+                                 ftdf_pan_id_t       dev_pan_id,
+                                 ftdf_address_t      dev_addr,
+                                 ftdf_key_index_t    key_index,
+                                 const ftdf_octet_t  *key_source)
+{
+        uint32_t hash = ftdf_index_hash(0, key_id_mode);
+
+        if (key_id_mode == 0) {
+                hash = ftdf_index_hash(hash, (dev_addr_mode << 16) | dev_pan_id);
+
+                if (dev_addr_mode == FTDF_EXTENDED_ADDRESS) {
+                        hash = ftdf_index_hash(hash, (uint32_t)dev_addr.ext_address);
+                        return ftdf_index_hash(hash, (uint32_t)(dev_addr.ext_address >> 32));
+                }
+
+                return ftdf_index_hash(hash, dev_addr.short_address);
+        }
+
+        hash = ftdf_index_hash(hash, key_index);
+
+        if (key_id_mode != 1) {
+                int key_source_length = (key_id_mode == 2) ? 4 : 8;
+                int x;
+
+                for (x = 0; x < key_source_length; x += 4) {
+                        hash = ftdf_index_hash(hash, key_source[x] |
+                                                     (key_source[x + 1] << 8) |
+                                                     (key_source[x + 2] << 16) |
+                                                     ((uint32_t)key_source[x + 3] << 24));
+                }
+        }
+
+        return hash;
+}
+#endif /* FTDF_SECURITY_KEY_INDEX_SIZE */
+
+#if FTDF_SECURITY_DEVICE_INDEX_SIZE
+static uint32_t ftdf_device_hash(ftdf_size_t         key,
+                                 ftdf_address_mode_t dev_addr_mode,
+                                 ftdf_pan_id_t       dev_pan_id,
+                                 ftdf_address_t      dev_addr)
+{
+        uint32_t hash = ftdf_index_hash(key, dev_addr_mode);
+
+        if (dev_addr_mode == FTDF_EXTENDED_ADDRESS) {
+                hash = ftdf_index_hash(hash, (uint32_t)dev_addr.ext_address);
+                return ftdf_index_hash(hash, (uint32_t)(dev_addr.ext_address >> 32));
+        }
+
+        return ftdf_index_hash(hash, (dev_pan_id << 16) | dev_addr.short_address);
+}
+#endif /* FTDF_SECURITY_DEVICE_INDEX_SIZE */
+
+static ftdf_boolean_t ftdf_key_id_match(const ftdf_key_id_lookup_descriptor_t *key_id_lookup_descriptor,
+                                        ftdf_key_id_mode_t                    key_id_mode,
+                                        ftdf_address_mode_t                   dev_addr_mode,
+                                        ftdf_pan_id_t                         dev_pan_id,
+                                        ftdf_address_t                        dev_addr,
+                                        ftdf_key_index_t                      key_index,
+                                        const ftdf_octet_t                    *key_source)
+{
+        if (key_id_mode != key_id_lookup_descriptor->key_id_mode) {
+                return FTDF_FALSE;
+        }
+
+        if (key_id_mode == 0) {
+                if ((dev_addr_mode == key_id_lookup_descriptor->device_addr_mode) &&
+                        (dev_pan_id == key_id_lookup_descriptor->device_pan_id)) {
+
+                        if ((dev_addr_mode == FTDF_EXTENDED_ADDRESS) &&
+                                (dev_addr.ext_address ==
+                                 key_id_lookup_descriptor->device_address.ext_address)) {
+                                return FTDF_TRUE;
+
+                        } else if ((dev_addr_mode == FTDF_SHORT_ADDRESS) &&
+                                (dev_addr.short_address ==
+                                 key_id_lookup_descriptor->device_address.short_address)) {
+                                return FTDF_TRUE;
+                        }
+                }
+
+                return FTDF_FALSE;
+        }
+
+        if (key_index != key_id_lookup_descriptor->key_index) {
+                return FTDF_FALSE;
+        }
+
+        if (key_id_mode == 1) {
+                return FTDF_TRUE;
+        }
+
+        ftdf_size_t key_source_length;
+
+        if (key_id_mode == 2) {
+                key_source_length = 4;
+        } else {
+                key_source_length = 8;
+        }
+
+        int x;
+
+        for (x = 0; x < key_source_length; x++) {
+
+                if (key_source[x] != key_id_lookup_descriptor->key_source[x]) {
+                        return FTDF_FALSE;
+                }
+        }
+
+        return FTDF_TRUE;
+}
+
+static ftdf_boolean_t ftdf_device_match(const ftdf_device_descriptor_t *device_descriptor,
+                                        ftdf_address_mode_t            dev_addr_mode,
+                                        ftdf_pan_id_t                  dev_pan_id,
+                                        ftdf_address_t                 dev_addr)
+{
+        if ((dev_addr_mode == FTDF_EXTENDED_ADDRESS) &&
+                (dev_addr.ext_address == device_descriptor->ext_address)) {
+                return FTDF_TRUE;
+        } else if ((dev_addr_mode == FTDF_SHORT_ADDRESS) &&
+                (dev_addr.short_address == device_descriptor->short_address) &&
+                (dev_pan_id == device_descriptor->pan_id)) {
+                return FTDF_TRUE;
+        }
+
+        return FTDF_FALSE;
+}
+
+#if FTDF_SECURITY_KEY_INDEX_SIZE
+static ftdf_boolean_t ftdf_index_key_id(ftdf_size_t key, ftdf_size_t look_up, int *nr_of_entries)
+{
+        ftdf_key_id_lookup_descriptor_t *key_id_lookup_descriptor =
+                ftdf_pib.key_table.key_descriptors[key].key_id_lookup_descriptors + look_up;
+        ftdf_key_id_mode_t key_id_mode = key_id_lookup_descriptor->key_id_mode;
+        ftdf_address_mode_t dev_addr_mode = key_id_lookup_descriptor->device_addr_mode;
+
+        /* Key id mode 0 descriptors without an extended or short address never match */
+        if ((key_id_mode == 0) && (dev_addr_mode != FTDF_EXTENDED_ADDRESS) &&
+                (dev_addr_mode != FTDF_SHORT_ADDRESS)) {
+                return FTDF_TRUE;
+        }
+
+        uint32_t slot = FTDF_INDEX_SLOT(ftdf_key_id_hash(key_id_mode,
+                                                         dev_addr_mode,
+                                                         key_id_lookup_descriptor->device_pan_id,
+                                                         key_id_lookup_descriptor->device_address,
+                                                         key_id_lookup_descriptor->key_index,
+                                                         key_id_lookup_descriptor->key_source),
+                                        FTDF_SECURITY_KEY_INDEX_SIZE);
+        uint16_t entry;
+
+        while ((entry = ftdf_security_index.keys[slot]) != FTDF_INDEX_EMPTY) {
+                ftdf_key_descriptor_t *key_descriptor =
+                        ftdf_pib.key_table.key_descriptors + (entry >> 8);
+
+                if (ftdf_key_id_match(key_descriptor->key_id_lookup_descriptors + (entry & 0xff),
+                                      key_id_mode,
+                                      dev_addr_mode,
+                                      key_id_lookup_descriptor->device_pan_id,
+                                      key_id_lookup_descriptor->device_address,
+                                      key_id_lookup_descriptor->key_index,
+                                      key_id_lookup_descriptor->key_source)) {
+                        return FTDF_TRUE;
+                }
+
+                slot = (slot + 1) & (FTDF_SECURITY_KEY_INDEX_SIZE - 1);
+        }
+
+        if (++*nr_of_entries > FTDF_SECURITY_KEY_INDEX_SIZE * 3 / 4) {
+                return FTDF_FALSE;
+        }
+
+        ftdf_security_index.keys[slot] = FTDF_INDEX_ENTRY(key, look_up);
+
+        return FTDF_TRUE;
+}
+#endif /* FTDF_SECURITY_KEY_INDEX_SIZE */
+
+#if FTDF_SECURITY_DEVICE_INDEX_SIZE
+static ftdf_boolean_t ftdf_index_device(ftdf_size_t                     key,
+                                        ftdf_device_descriptor_handle_t handle,
+                                        ftdf_address_mode_t             dev_addr_mode,
+                                        int                             *nr_of_entries)
+{
+        ftdf_device_descriptor_t *device_descriptor = ftdf_pib.device_table.device_descriptors + handle;
+        ftdf_address_t dev_addr;
+
+        if (dev_addr_mode == FTDF_EXTENDED_ADDRESS) {
+                dev_addr.ext_address = device_descriptor->ext_address;
+        } else {
+                dev_addr.short_address = device_descriptor->short_address;
+        }
+
+        uint32_t slot = FTDF_INDEX_SLOT(ftdf_device_hash(key, dev_addr_mode,
+                                                         device_descriptor->pan_id, dev_addr),
+                                        FTDF_SECURITY_DEVICE_INDEX_SIZE);
+        uint16_t entry;
+
+        while ((entry = ftdf_security_index.devices[slot]) != FTDF_INDEX_EMPTY) {
+                if (((entry >> 8) == key) &&
+                        ftdf_device_match(ftdf_pib.device_table.device_descriptors + (entry & 0xff),
+                                          dev_addr_mode, device_descriptor->pan_id, dev_addr)) {
+                        return FTDF_TRUE;
+                }
+
+                slot = (slot + 1) & (FTDF_SECURITY_DEVICE_INDEX_SIZE - 1);
+        }
+
+        if (++*nr_of_entries > FTDF_SECURITY_DEVICE_INDEX_SIZE * 3 / 4) {
+                return FTDF_FALSE;
+        }
+
+        ftdf_security_index.devices[slot] = FTDF_INDEX_ENTRY(key, handle);
+
+        return FTDF_TRUE;
+}
+#endif /* FTDF_SECURITY_DEVICE_INDEX_SIZE */
+
+void ftdf_update_security_index(void)
+{
+#if FTDF_SECURITY_KEY_INDEX_SIZE || FTDF_SECURITY_DEVICE_INDEX_SIZE
+        ftdf_size_t key;
+#endif
+#if FTDF_SECURITY_KEY_INDEX_SIZE
+        int nr_of_keys = 0;
+
+        memset(ftdf_security_index.keys, 0xff, sizeof(ftdf_security_index.keys));
+        ftdf_security_index.keys_valid = FTDF_TRUE;
+
+        for (key = 0; key < ftdf_pib.key_table.nr_of_key_descriptors; key++) {
+                ftdf_key_descriptor_t *key_descriptor = ftdf_pib.key_table.key_descriptors + key;
+                ftdf_size_t n;
+
+                for (n = 0; n < key_descriptor->nr_of_key_id_lookup_descriptors; n++) {
+                        if (ftdf_security_index.keys_valid &&
+                                !ftdf_index_key_id(key, n, &nr_of_keys)) {
+                                ftdf_security_index.keys_valid = FTDF_FALSE;
+                        }
+                }
+        }
+#endif
+#if FTDF_SECURITY_DEVICE_INDEX_SIZE
+        int nr_of_devices = 0;
+
+        memset(ftdf_security_index.devices, 0xff, sizeof(ftdf_security_index.devices));
+        ftdf_security_index.devices_valid = FTDF_TRUE;
+
+        for (key = 0; key < ftdf_pib.key_table.nr_of_key_descriptors; key++) {
+                ftdf_key_descriptor_t *key_descriptor = ftdf_pib.key_table.key_descriptors + key;
+                ftdf_size_t n;
+
+                for (n = 0; n < key_descriptor->nr_of_device_descriptor_handles; n++) {
+                        ftdf_device_descriptor_handle_t handle = key_descriptor->device_descriptor_handles[n];
+
+                        if (!ftdf_security_index.devices_valid ||
+                                (handle >= ftdf_pib.device_table.nr_of_device_descriptors)) {
+                                continue;
+                        }
+
+                        if (!ftdf_index_device(key, handle, FTDF_EXTENDED_ADDRESS, &nr_of_devices)) {
+                                ftdf_security_index.devices_valid = FTDF_FALSE;
+                        }
+
+                        /* Short addresses 0xfffe and 0xffff are looked up by scanning the table */
+                        if ((ftdf_pib.device_table.device_descriptors[handle].short_address < 0xfffe) &&
+                                !ftdf_index_device(key, handle, FTDF_SHORT_ADDRESS, &nr_of_devices)) {
+                                ftdf_security_index.devices_valid = FTDF_FALSE;
+                        }
+                }
+        }
+#endif
+}
+
 ftdf_key_descriptor_t *ftdf_lookup_key(ftdf_address_mode_t dev_addr_mode,
                                        ftdf_pan_id_t       dev_pan_id,
                                        ftdf_address_t      dev_addr,
@@ -502,61 +813,39 @@ ftdf_key_descriptor_t *ftdf_lookup_key(ftdf_address_mode_t dev_addr_mode,
         ftdf_size_t key;
         ftdf_key_descriptor_t *key_descriptor = ftdf_pib.key_table.key_descriptors;
 
+#if FTDF_SECURITY_KEY_INDEX_SIZE
+        if (ftdf_security_index.keys_valid) {
+                uint32_t slot = FTDF_INDEX_SLOT(ftdf_key_id_hash(key_id_mode, dev_addr_mode,
+                                                                 dev_pan_id, dev_addr,
+                                                                 key_index, key_source),
+                                                FTDF_SECURITY_KEY_INDEX_SIZE);
+                uint16_t entry;
+
+                while ((entry = ftdf_security_index.keys[slot]) != FTDF_INDEX_EMPTY) {
+                        key_descriptor = ftdf_pib.key_table.key_descriptors + (entry >> 8);
+
+                        if (ftdf_key_id_match(key_descriptor->key_id_lookup_descriptors + (entry & 0xff),
+                                              key_id_mode, dev_addr_mode, dev_pan_id, dev_addr,
+                                              key_index, key_source)) {
+                                return key_descriptor;
+                        }
+
+                        slot = (slot + 1) & (FTDF_SECURITY_KEY_INDEX_SIZE - 1);
+                }
+
+                return NULL;
+        }
+#endif
+
         for (key = 0; key < ftdf_pib.key_table.nr_of_key_descriptors; key++) {
                 ftdf_size_t look_up;
                 ftdf_key_id_lookup_descriptor_t *key_id_lookup_descriptor =
                         key_descriptor->key_id_lookup_descriptors;
 
                 for (look_up = 0; look_up < key_descriptor->nr_of_key_id_lookup_descriptors; look_up++) {
-
-                        if (key_id_mode != key_id_lookup_descriptor->key_id_mode) {
-                                key_id_lookup_descriptor++;
-                                continue;
-                        }
-
-                        if (key_id_mode == 0) {
-                                if ((dev_addr_mode == key_id_lookup_descriptor->device_addr_mode) &&
-                                        (dev_pan_id == key_id_lookup_descriptor->device_pan_id)) {
-
-                                        if ((dev_addr_mode == FTDF_EXTENDED_ADDRESS) &&
-                                                (dev_addr.ext_address ==
-                                                 key_id_lookup_descriptor->device_address.ext_address)) {
-                                                return key_descriptor;
-
-                                        } else if ((dev_addr_mode == FTDF_SHORT_ADDRESS) &&
-                                                (dev_addr.short_address ==
-                                                 key_id_lookup_descriptor->device_address.short_address)) {
-                                                return key_descriptor;
-                                        }
-                                }
-                        } else {
-                                if (key_index == key_id_lookup_descriptor->key_index) {
-                                        if (key_id_mode == 1) {
-                                                return key_descriptor;
-                                        }
-
-                                        ftdf_size_t key_source_length;
-
-                                        if (key_id_mode == 2) {
-                                                key_source_length = 4;
-                                        } else {
-                                                key_source_length = 8;
-                                        }
-
-                                        int x;
-
-                                        for (x = 0; x < key_source_length; x++) {
-
-                                                if (key_source[x] !=
-                                                        key_id_lookup_descriptor->key_source[x]) {
-                                                        break;
-                                                }
-                                        }
-
-                                        if (x == key_source_length) {
-                                                return key_descriptor;
-                                        }
-                                }
+                        if (ftdf_key_id_match(key_id_lookup_descriptor, key_id_mode, dev_addr_mode,
+                                              dev_pan_id, dev_addr, key_index, key_source)) {
+                                return key_descriptor;
                         }
 
                         key_id_lookup_descriptor++;
@@ -568,11 +857,10 @@ ftdf_key_descriptor_t *ftdf_lookup_key(ftdf_address_mode_t dev_addr_mode,
         return NULL;
 }
 
-ftdf_device_descriptor_t *ftdf_lookup_device(ftdf_size_t                     nr_of_device_descriptor_handles,
-                                             ftdf_device_descriptor_handle_t *device_descriptor_handles,
-                                             ftdf_address_mode_t             dev_addr_mode,
-                                             ftdf_pan_id_t                   dev_pan_id,
-                                             ftdf_address_t                  dev_addr)
+ftdf_device_descriptor_t *ftdf_lookup_device(ftdf_key_descriptor_t *key_descriptor,
+                                             ftdf_address_mode_t   dev_addr_mode,
+                                             ftdf_pan_id_t         dev_pan_id,
+                                             ftdf_address_t        dev_addr)
 {
         if (dev_addr_mode == FTDF_NO_ADDRESS) {
                 ftdf_short_address_t coord_short_address = ftdf_pib.coord_short_address;
@@ -594,20 +882,42 @@ ftdf_device_descriptor_t *ftdf_lookup_device(ftdf_size_t                     nr_
                 }
         }
 
-        ftdf_device_descriptor_handle_t *device_descriptor_handle = device_descriptor_handles;
+#if FTDF_SECURITY_DEVICE_INDEX_SIZE
+        if (ftdf_security_index.devices_valid &&
+                ((dev_addr_mode == FTDF_EXTENDED_ADDRESS) ||
+                 ((dev_addr_mode == FTDF_SHORT_ADDRESS) && (dev_addr.short_address < 0xfffe)))) {
+                ftdf_size_t key = key_descriptor - ftdf_pib.key_table.key_descriptors;
+                uint32_t slot = FTDF_INDEX_SLOT(ftdf_device_hash(key, dev_addr_mode,
+                                                                 dev_pan_id, dev_addr),
+                                                FTDF_SECURITY_DEVICE_INDEX_SIZE);
+                uint16_t entry;
+
+                while ((entry = ftdf_security_index.devices[slot]) != FTDF_INDEX_EMPTY) {
+                        ftdf_device_descriptor_t *device_descriptor =
+                                ftdf_pib.device_table.device_descriptors + (entry & 0xff);
+
+                        if (((entry >> 8) == key) &&
+                                ftdf_device_match(device_descriptor, dev_addr_mode, dev_pan_id, dev_addr)) {
+                                return device_descriptor;
+                        }
+
+                        slot = (slot + 1) & (FTDF_SECURITY_DEVICE_INDEX_SIZE - 1);
+                }
+
+                return NULL;
+        }
+#endif
+
+        ftdf_device_descriptor_handle_t *device_descriptor_handle =
+                key_descriptor->device_descriptor_handles;
         ftdf_size_t handle;
 
-        for (handle = 0; handle < nr_of_device_descriptor_handles; handle++) {
+        for (handle = 0; handle < key_descriptor->nr_of_device_descriptor_handles; handle++) {
                 if (*device_descriptor_handle < ftdf_pib.device_table.nr_of_device_descriptors) {
                         ftdf_device_descriptor_t* device_descriptor =
                                 ftdf_pib.device_table.device_descriptors + *device_descriptor_handle;
 
-                        if ((dev_addr_mode == FTDF_EXTENDED_ADDRESS) &&
-                                (dev_addr.ext_address == device_descriptor->ext_address)) {
-                                return device_descriptor;
-                        } else if ((dev_addr_mode == FTDF_SHORT_ADDRESS) &&
-                                (dev_addr.short_address == device_descriptor->short_address) &&
-                                (dev_pan_id == device_descriptor->pan_id)) {
+                        if (ftdf_device_match(device_descriptor, dev_addr_mode, dev_pan_id, dev_addr)) {
                                 return device_descriptor;
                         }
                 }
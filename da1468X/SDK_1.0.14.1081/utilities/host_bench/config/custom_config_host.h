@@ -0,0 +1,33 @@
+/**
+ ****************************************************************************************
+ *
+ * @file custom_config_host.h
+ *
+ * @brief Board Support Package. User Configuration file for the host (POSIX) build.
+ *
+ * Copyright (C) 2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ ****************************************************************************************
+ */
+
+#ifndef CUSTOM_CONFIG_HOST_H_
+#define CUSTOM_CONFIG_HOST_H_
+
+#include "bsp_definitions.h"
+
+#define dg_configBLACK_ORCA_IC_REV              ( BLACK_ORCA_IC_REV_B )
+#define dg_configBLACK_ORCA_IC_STEP             ( BLACK_ORCA_IC_STEP_B )
+#define dg_configEXEC_MODE                      ( MODE_IS_RAM )
+#define dg_configCODE_LOCATION                  ( NON_VOLATILE_IS_NONE )
+
+#define CONFIG_USE_FTDF
+
+/*
+ * Indexes large enough for a table of 255 devices with one key, or with a key per device
+ */
+#define FTDF_SECURITY_KEY_INDEX_SIZE            512
+#define FTDF_SECURITY_DEVICE_INDEX_SIZE         1024
+
+#endif /* CUSTOM_CONFIG_HOST_H_ */
@@ -0,0 +1,26 @@
+/**
+ ****************************************************************************************
+ *
+ * @file core_cm0.h
+ *
+ * @brief Cortex-M0 core definitions for the host (POSIX) build
+ *
+ * Only the register access qualifiers used by the peripheral register descriptions are kept.
+ *
+ * Copyright (C) 2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ ****************************************************************************************
+ */
+
+#ifndef __CORE_CM0_H_GENERIC
+#define __CORE_CM0_H_GENERIC
+
+#include <stdint.h>
+
+#define __I     volatile const
+#define __O     volatile
+#define __IO    volatile
+
+#endif /* __CORE_CM0_H_GENERIC */
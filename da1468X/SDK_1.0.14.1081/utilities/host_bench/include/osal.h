@@ -0,0 +1,23 @@
+/**
+ ****************************************************************************************
+ *
+ * @file osal.h
+ *
+ * @brief OS abstraction layer for the host (POSIX) build
+ *
+ * The FTDF sources built on the host don't use the OS, they only need the platform
+ * definitions that come with osal.h on the target.
+ *
+ * Copyright (C) 2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ ****************************************************************************************
+ */
+
+#ifndef OSAL_H_
+#define OSAL_H_
+
+#include <sdk_defs.h>
+
+#endif /* OSAL_H_ */
@@ -0,0 +1,32 @@
+/**
+ ****************************************************************************************
+ *
+ * @file sdk_defs.h
+ *
+ * @brief Platform definitions for the host (POSIX) build
+ *
+ * Uses bsp/include/sdk_defs.h and its register descriptions, with the FTDF and DEM registers
+ * in host memory (see stubs/ftdf_host.c).
+ *
+ * Copyright (C) 2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ ****************************************************************************************
+ */
+
+#ifndef HOST_SDK_DEFS_H_
+#define HOST_SDK_DEFS_H_
+
+#include_next <sdk_defs.h>
+
+#undef FTDF
+#undef DEM
+
+extern FTDF_Type ftdf_host_regs;
+extern DEM_Type dem_host_regs;
+
+#define FTDF    (&ftdf_host_regs)
+#define DEM     (&dem_host_regs)
+
+#endif /* HOST_SDK_DEFS_H_ */
@@ -0,0 +1,18 @@
+/**
+ ****************************************************************************************
+ *
+ * @file system_DA14680.h
+ *
+ * @brief System initialization for the host (POSIX) build, nothing to initialize
+ *
+ * Copyright (C) 2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ ****************************************************************************************
+ */
+
+#ifndef SYSTEM_DA14680_H_
+#define SYSTEM_DA14680_H_
+
+#endif /* SYSTEM_DA14680_H_ */
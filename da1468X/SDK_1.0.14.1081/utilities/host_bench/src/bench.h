@@ -0,0 +1,65 @@
+/**
+ ****************************************************************************************
+ *
+ * @file bench.h
+ *
+ * @brief Host benchmark suite
+ *
+ * Copyright (C) 2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ ****************************************************************************************
+ */
+
+#ifndef BENCH_H_
+#define BENCH_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * \brief Benchmark definition
+ */
+typedef struct {
+        const char *name;               /**< Name used to select benchmark on the command line */
+        int (*run)(uint32_t scale);     /**< Returns the number of failed checks, \p scale
+                                             multiplies iterations */
+} bench_t;
+
+/**
+ * \brief Get monotonic host time
+ *
+ * \return time in nanoseconds
+ */
+uint64_t bench_now_ns(void);
+
+/**
+ * \brief Print one result line
+ *
+ * \param [in] name result name
+ * \param [in] ops number of operations performed
+ * \param [in] ns time spent in nanoseconds
+ * \param [in] fmt additional printf-like information, can be NULL
+ */
+void bench_report(const char *name, uint32_t ops, uint64_t ns, const char *fmt, ...)
+                                                        __attribute__((format(printf, 4, 5)));
+
+/**
+ * \brief Print one check line
+ *
+ * \param [in] name check name
+ * \param [in] ok check result
+ *
+ * \return 0 if the check passed, 1 otherwise
+ */
+int bench_check(const char *name, bool ok);
+
+/**
+ * \brief Pseudo random numbers, same sequence on every run
+ */
+uint32_t bench_rand(void);
+
+int bench_ftdf_security(uint32_t scale);
+
+#endif /* BENCH_H_ */
@@ -0,0 +1,417 @@
+/**
+ ****************************************************************************************
+ *
+ * @file bench_ftdf_security.c
+ *
+ * @brief FTDF frame security key and device lookup benchmark
+ *
+ * Checks ftdf_lookup_key() and ftdf_lookup_device() against the table scans they replace on
+ * random tables with many equal addresses and lookup descriptors, and on tables too large for
+ * the indexes. Then measures the lookup of every received secured frame on a coordinator with
+ * one network key shared by all devices and with a key per device.
+ *
+ * Copyright (C) 2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ ****************************************************************************************
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <ftdf.h>
+#include "internal.h"
+#include "ftdf_security_ref.h"
+#include "bench.h"
+
+/* Device descriptor handles and table sizes are 8 bits wide */
+#define MAX_DEVICES             255
+#define MAX_LOOKUPS             512
+#define FRAMES                  1024
+#define FRAME_OPS               200000
+#define RANDOM_TABLES           2000
+#define RANDOM_FRAMES           200
+
+typedef struct {
+        ftdf_address_mode_t addr_mode;
+        ftdf_pan_id_t       pan_id;
+        ftdf_address_t      addr;
+        ftdf_frame_type_t   frame_type;
+        ftdf_key_id_mode_t  key_id_mode;
+        ftdf_key_index_t    key_index;
+        ftdf_octet_t        key_source[8];
+} frame_t;
+
+static ftdf_device_descriptor_t devices[MAX_DEVICES];
+static ftdf_key_descriptor_t keys[MAX_DEVICES];
+static ftdf_key_id_lookup_descriptor_t lookups[MAX_LOOKUPS];
+static ftdf_device_descriptor_handle_t handles[MAX_LOOKUPS];
+static frame_t frames[FRAMES];
+
+/* Keeps the compiler from dropping the timed lookups */
+static volatile uintptr_t sink;
+
+static void set_tables(ftdf_size_t nr_of_keys, ftdf_size_t nr_of_devices)
+{
+        ftdf_pib.key_table.nr_of_key_descriptors = nr_of_keys;
+        ftdf_pib.key_table.key_descriptors = keys;
+        ftdf_pib.device_table.nr_of_device_descriptors = nr_of_devices;
+        ftdf_pib.device_table.device_descriptors = devices;
+
+        /* The setFunc of FTDF_PIB_KEY_TABLE and FTDF_PIB_DEVICE_TABLE */
+        ftdf_update_security_index();
+}
+
+static ftdf_device_descriptor_t *lookup(frame_t *frame, ftdf_key_descriptor_t **key)
+{
+        *key = ftdf_lookup_key(frame->addr_mode, frame->pan_id, frame->addr, frame->frame_type,
+                               frame->key_id_mode, frame->key_index, frame->key_source);
+        if (*key == NULL) {
+                return NULL;
+        }
+
+        return ftdf_lookup_device(*key, frame->addr_mode, frame->pan_id, frame->addr);
+}
+
+static ftdf_device_descriptor_t *lookup_ref(frame_t *frame, ftdf_key_descriptor_t **key)
+{
+        *key = ftdf_lookup_key_ref(frame->addr_mode, frame->pan_id, frame->addr, frame->frame_type,
+                                   frame->key_id_mode, frame->key_index, frame->key_source);
+        if (*key == NULL) {
+                return NULL;
+        }
+
+        return ftdf_lookup_device_ref((*key)->nr_of_device_descriptor_handles,
+                                      (*key)->device_descriptor_handles,
+                                      frame->addr_mode, frame->pan_id, frame->addr);
+}
+
+static bool check_frames(int nr_of_frames)
+{
+        int i;
+
+        for (i = 0; i < nr_of_frames; i++) {
+                ftdf_key_descriptor_t *key;
+                ftdf_key_descriptor_t *key_ref;
+                ftdf_device_descriptor_t *device = lookup(&frames[i], &key);
+                ftdf_device_descriptor_t *device_ref = lookup_ref(&frames[i], &key_ref);
+
+                if (key != key_ref || device != device_ref) {
+                        return false;
+                }
+        }
+
+        return true;
+}
+
+/* Addresses, PAN ids and key ids from small sets, so that many of them are equal */
+static ftdf_address_mode_t random_addr_mode(void)
+{
+        static const ftdf_address_mode_t modes[] = {
+                FTDF_NO_ADDRESS, FTDF_SHORT_ADDRESS, FTDF_EXTENDED_ADDRESS, FTDF_EXTENDED_ADDRESS
+        };
+
+        return modes[bench_rand() % 4];
+}
+
+static ftdf_short_address_t random_short_address(void)
+{
+        static const ftdf_short_address_t addresses[] = { 0x0001, 0x0002, 0x0003, 0xfffe, 0xffff };
+
+        return addresses[bench_rand() % 5];
+}
+
+static ftdf_address_t random_address(ftdf_address_mode_t addr_mode)
+{
+        ftdf_address_t addr;
+
+        addr.ext_address = 0x0123456789abcdefULL;
+        if (addr_mode == FTDF_EXTENDED_ADDRESS) {
+                addr.ext_address = 0xaabbccdd00000000ULL + bench_rand() % 4;
+        } else {
+                addr.short_address = random_short_address();
+        }
+
+        return addr;
+}
+
+static void random_key_id(ftdf_key_id_mode_t *key_id_mode, ftdf_key_index_t *key_index,
+                          ftdf_octet_t *key_source)
+{
+        int n;
+
+        *key_id_mode = bench_rand() % 4;
+        *key_index = bench_rand() % 3;
+        for (n = 0; n < 8; n++) {
+                key_source[n] = (bench_rand() % 4) ? 0x5a : 0xa5;
+        }
+}
+
+static void random_tables(void)
+{
+        ftdf_size_t nr_of_devices = 1 + bench_rand() % 24;
+        ftdf_size_t nr_of_keys = 1 + bench_rand() % 12;
+        int nr_of_lookups = 0;
+        int nr_of_handles = 0;
+        int i;
+
+        for (i = 0; i < nr_of_devices; i++) {
+                devices[i].pan_id = 0x1000 + bench_rand() % 2;
+                devices[i].short_address = random_short_address();
+                devices[i].ext_address = 0xaabbccdd00000000ULL + bench_rand() % 4;
+        }
+
+        for (i = 0; i < nr_of_keys; i++) {
+                ftdf_size_t nr = bench_rand() % 5;
+                int n;
+
+                keys[i].nr_of_key_id_lookup_descriptors = nr;
+                keys[i].key_id_lookup_descriptors = &lookups[nr_of_lookups];
+                for (n = 0; n < nr; n++, nr_of_lookups++) {
+                        ftdf_key_id_lookup_descriptor_t *l = &lookups[nr_of_lookups];
+
+                        random_key_id(&l->key_id_mode, &l->key_index, l->key_source);
+                        l->device_addr_mode = random_addr_mode();
+                        l->device_pan_id = 0x1000 + bench_rand() % 2;
+                        l->device_address = random_address(l->device_addr_mode);
+                }
+
+                /* Handles past the device table and duplicate handles included */
+                nr = bench_rand() % 8;
+                keys[i].nr_of_device_descriptor_handles = nr;
+                keys[i].device_descriptor_handles = &handles[nr_of_handles];
+                for (n = 0; n < nr; n++, nr_of_handles++) {
+                        handles[nr_of_handles] = bench_rand() % (nr_of_devices + 2);
+                }
+        }
+
+        ftdf_pib.pan_id = 0x1000 + bench_rand() % 2;
+        ftdf_pib.coord_short_address = random_short_address();
+        ftdf_pib.coord_ext_address = 0xaabbccdd00000000ULL + bench_rand() % 4;
+
+        set_tables(nr_of_keys, nr_of_devices);
+}
+
+static void random_frames(int nr_of_frames)
+{
+        int i;
+
+        for (i = 0; i < nr_of_frames; i++) {
+                frame_t *frame = &frames[i];
+
+                frame->addr_mode = random_addr_mode();
+                frame->pan_id = 0x1000 + bench_rand() % 2;
+                frame->addr = random_address(frame->addr_mode);
+                frame->frame_type = (bench_rand() % 4) ? FTDF_DATA_FRAME : FTDF_BEACON_FRAME;
+                random_key_id(&frame->key_id_mode, &frame->key_index, frame->key_source);
+        }
+}
+
+static int check_random(void)
+{
+        bool ok = true;
+        int i;
+
+        for (i = 0; i < RANDOM_TABLES && ok; i++) {
+                random_tables();
+                random_frames(RANDOM_FRAMES);
+                ok = check_frames(RANDOM_FRAMES);
+        }
+
+        return bench_check("random tables", ok);
+}
+
+static void init_devices(ftdf_size_t nr_of_devices)
+{
+        int i;
+
+        for (i = 0; i < nr_of_devices; i++) {
+                devices[i].pan_id = 0x1234;
+                devices[i].short_address = 0x0100 + i;
+                devices[i].ext_address = 0x0011223344550000ULL + i * 0x10001;
+                devices[i].frame_counter = 0;
+                devices[i].exempt = FTDF_FALSE;
+                handles[i] = i;
+        }
+}
+
+/* One key for all devices, found by key index (key id mode 1) */
+static void network_key(ftdf_size_t nr_of_devices)
+{
+        init_devices(nr_of_devices);
+
+        memset(&lookups[0], 0, sizeof(lookups[0]));
+        lookups[0].key_id_mode = 1;
+        lookups[0].key_index = 1;
+
+        keys[0].nr_of_key_id_lookup_descriptors = 1;
+        keys[0].key_id_lookup_descriptors = lookups;
+        keys[0].nr_of_device_descriptor_handles = nr_of_devices;
+        keys[0].device_descriptor_handles = handles;
+
+        set_tables(1, nr_of_devices);
+}
+
+static void network_key_frames(ftdf_size_t nr_of_devices)
+{
+        int i;
+
+        for (i = 0; i < FRAMES; i++) {
+                ftdf_device_descriptor_t *device = &devices[bench_rand() % nr_of_devices];
+
+                memset(&frames[i], 0, sizeof(frames[i]));
+                frames[i].frame_type = FTDF_DATA_FRAME;
+                frames[i].pan_id = device->pan_id;
+                frames[i].key_id_mode = 1;
+                frames[i].key_index = 1;
+                if (i & 1) {
+                        frames[i].addr_mode = FTDF_SHORT_ADDRESS;
+                        frames[i].addr.short_address = device->short_address;
+                } else {
+                        frames[i].addr_mode = FTDF_EXTENDED_ADDRESS;
+                        frames[i].addr.ext_address = device->ext_address;
+                }
+        }
+}
+
+/* A key per device, found by the extended address of the device (key id mode 0) */
+static void device_keys(ftdf_size_t nr_of_devices)
+{
+        int i;
+
+        init_devices(nr_of_devices);
+
+        for (i = 0; i < nr_of_devices; i++) {
+                memset(&lookups[i], 0, sizeof(lookups[i]));
+                lookups[i].key_id_mode = 0;
+                lookups[i].device_addr_mode = FTDF_EXTENDED_ADDRESS;
+                lookups[i].device_pan_id = devices[i].pan_id;
+                lookups[i].device_address.ext_address = devices[i].ext_address;
+
+                keys[i].nr_of_key_id_lookup_descriptors = 1;
+                keys[i].key_id_lookup_descriptors = &lookups[i];
+                keys[i].nr_of_device_descriptor_handles = 1;
+                keys[i].device_descriptor_handles = &handles[i];
+        }
+
+        set_tables(nr_of_devices, nr_of_devices);
+}
+
+static void device_keys_frames(ftdf_size_t nr_of_devices)
+{
+        int i;
+
+        for (i = 0; i < FRAMES; i++) {
+                ftdf_device_descriptor_t *device = &devices[bench_rand() % nr_of_devices];
+
+                memset(&frames[i], 0, sizeof(frames[i]));
+                frames[i].frame_type = FTDF_DATA_FRAME;
+                frames[i].pan_id = device->pan_id;
+                frames[i].key_id_mode = 0;
+                frames[i].addr_mode = FTDF_EXTENDED_ADDRESS;
+                frames[i].addr.ext_address = device->ext_address;
+        }
+}
+
+static int check_overflow(void)
+{
+        int failed = 0;
+        int i;
+
+        /* More key id lookup descriptors than the key index holds */
+        network_key(MAX_DEVICES);
+        for (i = 0; i < MAX_LOOKUPS; i++) {
+                memset(&lookups[i], 0, sizeof(lookups[i]));
+                lookups[i].key_id_mode = (i < MAX_DEVICES) ? 1 : 2;
+                lookups[i].key_index = i;
+                lookups[i].key_source[0] = i >> 8;
+        }
+        keys[0].nr_of_key_id_lookup_descriptors = MAX_DEVICES;
+        keys[1] = keys[0];
+        keys[1].key_id_lookup_descriptors = &lookups[MAX_DEVICES];
+        set_tables(2, MAX_DEVICES);
+        network_key_frames(MAX_DEVICES);
+        for (i = 0; i < FRAMES; i++) {
+                frames[i].key_id_mode = 1 + i % 2;
+                frames[i].key_index = i / 2;
+                frames[i].key_source[0] = i / 512;
+        }
+        failed += bench_check("key index overflow", check_frames(FRAMES));
+
+        /* More device descriptor handles than the device index holds */
+        device_keys(MAX_DEVICES);
+        for (i = 0; i < MAX_DEVICES; i++) {
+                keys[i].nr_of_device_descriptor_handles = MAX_DEVICES;
+                keys[i].device_descriptor_handles = handles;
+        }
+        set_tables(MAX_DEVICES, MAX_DEVICES);
+        device_keys_frames(MAX_DEVICES);
+        failed += bench_check("device index overflow", check_frames(FRAMES));
+
+        return failed;
+}
+
+static uint64_t time_frames(ftdf_device_descriptor_t *(*fn)(frame_t *, ftdf_key_descriptor_t **),
+                            uint32_t ops)
+{
+        uint64_t start = bench_now_ns();
+        uint32_t i;
+
+        for (i = 0; i < ops; i++) {
+                ftdf_key_descriptor_t *key;
+
+                sink += (uintptr_t)fn(&frames[i % FRAMES], &key) + (uintptr_t)key;
+        }
+
+        return bench_now_ns() - start;
+}
+
+static int run_frames(const char *name, ftdf_size_t nr_of_devices, uint32_t scale)
+{
+        uint32_t ops = FRAME_OPS * scale;
+        uint64_t ns_ref;
+        uint64_t ns;
+        char buf[64];
+        int failed;
+
+        snprintf(buf, sizeof(buf), "%s, %u devices", name, nr_of_devices);
+        failed = bench_check(buf, check_frames(FRAMES));
+
+        ns_ref = time_frames(lookup_ref, ops);
+        ns = time_frames(lookup, ops);
+
+        snprintf(buf, sizeof(buf), "%s, %u devices, scan", name, nr_of_devices);
+        bench_report(buf, ops, ns_ref, NULL);
+        snprintf(buf, sizeof(buf), "%s, %u devices, index", name, nr_of_devices);
+        bench_report(buf, ops, ns, "%.1fx faster", ns ? (double) ns_ref / ns : 0.0);
+
+        return failed;
+}
+
+int bench_ftdf_security(uint32_t scale)
+{
+        static const ftdf_size_t sizes[] = { 10, 100, MAX_DEVICES };
+        int failed = 0;
+        int i;
+
+        memset(&ftdf_pib, 0, sizeof(ftdf_pib));
+
+        failed += check_random();
+        failed += check_overflow();
+
+        ftdf_pib.coord_short_address = 0xffff;
+
+        for (i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+                network_key(sizes[i]);
+                network_key_frames(sizes[i]);
+                failed += run_frames("network key", sizes[i], scale);
+        }
+
+        for (i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+                device_keys(sizes[i]);
+                device_keys_frames(sizes[i]);
+                failed += run_frames("key per device", sizes[i], scale);
+        }
+
+        return failed;
+}
@@ -0,0 +1,169 @@
+/**
+ ****************************************************************************************
+ *
+ * @file ftdf_security_ref.c
+ *
+ * @brief Reference FTDF key and device lookup
+ *
+ * Copy of ftdf_lookup_key() and ftdf_lookup_device() from sdk/interfaces/ftdf/src/security.c
+ * before they used the key and device indexes: scans of the key and device tables.
+ *
+ * Copyright (C) 2015-2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ ****************************************************************************************
+ */
+
+#include <ftdf.h>
+#include "internal.h"
+#include "ftdf_security_ref.h"
+
+ftdf_key_descriptor_t *ftdf_lookup_key_ref(ftdf_address_mode_t dev_addr_mode,
+                                           ftdf_pan_id_t       dev_pan_id,
+                                           ftdf_address_t      dev_addr,
+                                           ftdf_frame_type_t   frame_type,
+                                           ftdf_key_id_mode_t  key_id_mode,
+                                           ftdf_key_index_t    key_index,
+                                           ftdf_octet_t        *key_source)
+{
+        if (key_id_mode == 0) {
+                if (dev_addr_mode == FTDF_NO_ADDRESS) {
+                        ftdf_short_address_t coord_short_address = ftdf_pib.coord_short_address;
+
+                        dev_pan_id = ftdf_pib.pan_id;
+
+                        if ((frame_type == FTDF_BEACON_FRAME) || (coord_short_address == 0xfffe)) {
+                                dev_addr.ext_address = ftdf_pib.coord_ext_address;
+                                dev_addr_mode = FTDF_EXTENDED_ADDRESS;
+                        }
+
+                        if (coord_short_address < 0xfffe) {
+                                dev_addr.short_address = coord_short_address;
+                                dev_addr_mode = FTDF_SHORT_ADDRESS;
+                        }
+
+                        if (coord_short_address == 0xffff) {
+                                return NULL;
+                        }
+                }
+        }
+
+        ftdf_size_t key;
+        ftdf_key_descriptor_t *key_descriptor = ftdf_pib.key_table.key_descriptors;
+
+        for (key = 0; key < ftdf_pib.key_table.nr_of_key_descriptors; key++) {
+                ftdf_size_t look_up;
+                ftdf_key_id_lookup_descriptor_t *key_id_lookup_descriptor =
+                        key_descriptor->key_id_lookup_descriptors;
+
+                for (look_up = 0; look_up < key_descriptor->nr_of_key_id_lookup_descriptors; look_up++) {
+
+                        if (key_id_mode != key_id_lookup_descriptor->key_id_mode) {
+                                key_id_lookup_descriptor++;
+                                continue;
+                        }
+
+                        if (key_id_mode == 0) {
+                                if ((dev_addr_mode == key_id_lookup_descriptor->device_addr_mode) &&
+                                        (dev_pan_id == key_id_lookup_descriptor->device_pan_id)) {
+
+                                        if ((dev_addr_mode == FTDF_EXTENDED_ADDRESS) &&
+                                                (dev_addr.ext_address ==
+                                                 key_id_lookup_descriptor->device_address.ext_address)) {
+                                                return key_descriptor;
+
+                                        } else if ((dev_addr_mode == FTDF_SHORT_ADDRESS) &&
+                                                (dev_addr.short_address ==
+                                                 key_id_lookup_descriptor->device_address.short_address)) {
+                                                return key_descriptor;
+                                        }
+                                }
+                        } else {
+                                if (key_index == key_id_lookup_descriptor->key_index) {
+                                        if (key_id_mode == 1) {
+                                                return key_descriptor;
+                                        }
+
+                                        ftdf_size_t key_source_length;
+
+                                        if (key_id_mode == 2) {
+                                                key_source_length = 4;
+                                        } else {
+                                                key_source_length = 8;
+                                        }
+
+                                        int x;
+
+                                        for (x = 0; x < key_source_length; x++) {
+
+                                                if (key_source[x] !=
+                                                        key_id_lookup_descriptor->key_source[x]) {
+                                                        break;
+                                                }
+                                        }
+
+                                        if (x == key_source_length) {
+                                                return key_descriptor;
+                                        }
+                                }
+                        }
+
+                        key_id_lookup_descriptor++;
+                }
+
+                key_descriptor++;
+        }
+
+        return NULL;
+}
+
+ftdf_device_descriptor_t *ftdf_lookup_device_ref(ftdf_size_t                     nr_of_device_descriptor_handles,
+                                                 ftdf_device_descriptor_handle_t *device_descriptor_handles,
+                                                 ftdf_address_mode_t             dev_addr_mode,
+                                                 ftdf_pan_id_t                   dev_pan_id,
+                                                 ftdf_address_t                  dev_addr)
+{
+        if (dev_addr_mode == FTDF_NO_ADDRESS) {
+                ftdf_short_address_t coord_short_address = ftdf_pib.coord_short_address;
+
+                dev_pan_id = ftdf_pib.pan_id;
+
+                if (coord_short_address == 0xfffe) {
+                        dev_addr.ext_address = ftdf_pib.coord_ext_address;
+                        dev_addr_mode = FTDF_EXTENDED_ADDRESS;
+                }
+
+                if (coord_short_address < 0xfffe) {
+                        dev_addr.short_address = coord_short_address;
+                        dev_addr_mode = FTDF_SHORT_ADDRESS;
+                }
+
+                if (coord_short_address == 0xffff) {
+                        return NULL;
+                }
+        }
+
+        ftdf_device_descriptor_handle_t *device_descriptor_handle = device_descriptor_handles;
+        ftdf_size_t handle;
+
+        for (handle = 0; handle < nr_of_device_descriptor_handles; handle++) {
+                if (*device_descriptor_handle < ftdf_pib.device_table.nr_of_device_descriptors) {
+                        ftdf_device_descriptor_t* device_descriptor =
+                                ftdf_pib.device_table.device_descriptors + *device_descriptor_handle;
+
+                        if ((dev_addr_mode == FTDF_EXTENDED_ADDRESS) &&
+                                (dev_addr.ext_address == device_descriptor->ext_address)) {
+                                return device_descriptor;
+                        } else if ((dev_addr_mode == FTDF_SHORT_ADDRESS) &&
+                                (dev_addr.short_address == device_descriptor->short_address) &&
+                                (dev_pan_id == device_descriptor->pan_id)) {
+                                return device_descriptor;
+                        }
+                }
+
+                device_descriptor_handle++;
+        }
+
+        return NULL;
+}
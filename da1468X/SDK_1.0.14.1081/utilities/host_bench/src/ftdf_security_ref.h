@@ -0,0 +1,41 @@
+/**
+ ****************************************************************************************
+ *
+ * @file ftdf_security_ref.h
+ *
+ * @brief Reference FTDF key and device lookup
+ *
+ * Copyright (C) 2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ ****************************************************************************************
+ */
+
+#ifndef FTDF_SECURITY_REF_H_
+#define FTDF_SECURITY_REF_H_
+
+#include <ftdf.h>
+
+/**
+ * \brief Find the key of a frame by scanning the key table, like ftdf_lookup_key()
+ */
+ftdf_key_descriptor_t *ftdf_lookup_key_ref(ftdf_address_mode_t dev_addr_mode,
+                                           ftdf_pan_id_t       dev_pan_id,
+                                           ftdf_address_t      dev_addr,
+                                           ftdf_frame_type_t   frame_type,
+                                           ftdf_key_id_mode_t  key_id_mode,
+                                           ftdf_key_index_t    key_index,
+                                           ftdf_octet_t        *key_source);
+
+/**
+ * \brief Find the device of a frame by scanning the device descriptor handles of its key, like
+ *        ftdf_lookup_device()
+ */
+ftdf_device_descriptor_t *ftdf_lookup_device_ref(ftdf_size_t                     nr_of_device_descriptor_handles,
+                                                 ftdf_device_descriptor_handle_t *device_descriptor_handles,
+                                                 ftdf_address_mode_t             dev_addr_mode,
+                                                 ftdf_pan_id_t                   dev_pan_id,
+                                                 ftdf_address_t                  dev_addr);
+
+#endif /* FTDF_SECURITY_REF_H_ */
@@ -0,0 +1,141 @@
+/**
+ ****************************************************************************************
+ *
+ * @file main.c
+ *
+ * @brief Host benchmark suite
+ *
+ * Runs the selected benchmarks of SDK modules built for the host.
+ *
+ * Copyright (C) 2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ ****************************************************************************************
+ */
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "bench.h"
+
+static const bench_t benches[] = {
+        { "ftdf_security", bench_ftdf_security },
+};
+
+static uint32_t rand_state = 0x12345678;
+
+uint64_t bench_now_ns(void)
+{
+        struct timespec ts;
+
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+
+        return (uint64_t) ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+void bench_report(const char *name, uint32_t ops, uint64_t ns, const char *fmt, ...)
+{
+        va_list args;
+
+        printf("  %-40s %9u ops %12.1f ns/op %12.0f ops/s", name, ops,
+                        ops ? (double) ns / ops : 0.0, ns ? ops * 1e9 / ns : 0.0);
+        if (fmt) {
+                printf("  ");
+                va_start(args, fmt);
+                vprintf(fmt, args);
+                va_end(args);
+        }
+        printf("\n");
+        fflush(stdout);
+}
+
+int bench_check(const char *name, bool ok)
+{
+        printf("  %-40s %s\n", name, ok ? "ok" : "FAILED");
+
+        return ok ? 0 : 1;
+}
+
+uint32_t bench_rand(void)
+{
+        /* xorshift32 */
+        rand_state ^= rand_state << 13;
+        rand_state ^= rand_state >> 17;
+        rand_state ^= rand_state << 5;
+
+        return rand_state;
+}
+
+static bool is_selected(const char *name, int argc, char *argv[], int first)
+{
+        int i;
+
+        if (first == argc) {
+                return true;
+        }
+
+        for (i = first; i < argc; i++) {
+                if (strcmp(argv[i], name) == 0) {
+                        return true;
+                }
+        }
+
+        return false;
+}
+
+static void usage(const char *prog)
+{
+        size_t i;
+
+        fprintf(stderr, "Usage: %s [-s scale] [benchmark...]\n\nBenchmarks:", prog);
+        for (i = 0; i < sizeof(benches) / sizeof(benches[0]); i++) {
+                fprintf(stderr, " %s", benches[i].name);
+        }
+        fprintf(stderr, "\n");
+        exit(2);
+}
+
+int main(int argc, char *argv[])
+{
+        uint32_t scale = 1;
+        int first = 1;
+        int failed = 0;
+        size_t j;
+        int i;
+
+        if (argc > 2 && strcmp(argv[1], "-s") == 0) {
+                scale = strtoul(argv[2], NULL, 0);
+                if (scale == 0) {
+                        usage(argv[0]);
+                }
+                first = 3;
+        }
+        for (i = first; i < argc; i++) {
+                for (j = 0; j < sizeof(benches) / sizeof(benches[0]); j++) {
+                        if (strcmp(argv[i], benches[j].name) == 0) {
+                                break;
+                        }
+                }
+                if (j == sizeof(benches) / sizeof(benches[0])) {
+                        usage(argv[0]);
+                }
+        }
+
+        for (j = 0; j < sizeof(benches) / sizeof(benches[0]); j++) {
+                if (!is_selected(benches[j].name, argc, argv, first)) {
+                        continue;
+                }
+                printf("%s:\n", benches[j].name);
+                fflush(stdout);
+                failed += benches[j].run(scale);
+        }
+
+        if (failed) {
+                printf("%d check(s) FAILED\n", failed);
+        }
+
+        return failed ? 1 : 0;
+}
@@ -0,0 +1,26 @@
+/**
+ ****************************************************************************************
+ *
+ * @file ftdf_host.c
+ *
+ * @brief FTDF state and registers for the host (POSIX) build
+ *
+ * The registers are plain memory: the security engine is never busy and never reports an
+ * authentication failure.
+ *
+ * Copyright (C) 2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ ****************************************************************************************
+ */
+
+#include <ftdf.h>
+#include "internal.h"
+
+FTDF_Type ftdf_host_regs;
+DEM_Type dem_host_regs;
+
+/* Normally in common.c and tsch.c */
+ftdf_pib_t ftdf_pib;
+ftdf_asn_t ftdf_tsch_slot_asn;
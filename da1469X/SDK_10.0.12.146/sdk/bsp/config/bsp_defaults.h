@@ -368,6 +368,30 @@
 # endif
 #endif
 
+/**
+ * \brief Maximum number of system clock voters
+ *
+ * The number of voters that can be registered with cm_sys_clk_voter_register(). Each one costs a
+ * byte of Retention Memory. It cannot be larger than 32.
+ *
+ * \bsp_default_note{\bsp_config_option_app,}
+ */
+#ifndef dg_configCM_MAX_SYS_CLK_VOTERS
+#define dg_configCM_MAX_SYS_CLK_VOTERS                  (8)
+#endif
+
+/**
+ * \brief Interpolate sys_timer_get_uptime_usec_hires() with the CPU cycle counter
+ *
+ * - 1: the DWT cycle counter is enabled and used while the system is awake
+ * - 0: sys_timer_get_uptime_usec_hires() has the resolution of the OS timer
+ *
+ * \bsp_default_note{\bsp_config_option_app,}
+ */
+#ifndef dg_configSYS_TIMER_USE_DWT
+#define dg_configSYS_TIMER_USE_DWT                      (0)
+#endif
+
 /**
  * \brief When set to 1, the DCDC is used.
  *
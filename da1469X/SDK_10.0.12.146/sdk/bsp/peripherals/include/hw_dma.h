@@ -198,7 +198,7 @@ typedef enum {
         HW_DMA_TRIG_UART3_RXTX = 0x7,
         HW_DMA_TRIG_PCM_RXTX = 0x8,
         HW_DMA_TRIG_SRC_RXTX = 0x9,
-        HW_DMA_TRIG_ADC = 0xC,
+        HW_DMA_TRIG_ADC = 0xC,          /**< GPADC on the even, SDADC on the odd channel of the pair */
         HW_DMA_TRIG_NONE = 0xF
 } HW_DMA_TRIG;
 
@@ -292,6 +292,31 @@ __STATIC_INLINE bool hw_gpadc_get_continuous(void)
         return REG_GETF(GPADC, GP_ADC_CTRL_REG, GP_ADC_CONT);
 }
 
+/**
+ * \brief Enable/Disable DMA functionality
+ *
+ * With DMA functionality enabled every conversion result raises a request on the ADC DMA
+ * trigger (\ref HW_DMA_TRIG_ADC, even channel of the pair).
+ *
+ * \param [in] enabled When true, DMA functionality is enabled
+ *
+ */
+__STATIC_INLINE void hw_gpadc_set_dma_functionality(bool enabled)
+{
+        REG_SETF(GPADC, GP_ADC_CTRL2_REG, GP_ADC_DMA_EN, !!enabled);
+}
+
+/**
+ * \brief Get DMA functionality state
+ *
+ * \return DMA functionality state
+ *
+ */
+__STATIC_INLINE bool hw_gpadc_get_dma_functionality(void)
+{
+        return REG_GETF(GPADC, GP_ADC_CTRL2_REG, GP_ADC_DMA_EN);
+}
+
 /**
  * \brief Set input channel
  *
@@ -514,14 +514,15 @@ __STATIC_INLINE uint16_t hw_sdadc_get_raw_value(void)
 }
 
 /**
- * \brief Get voltage in mV
+ * \brief Convert a result register value to mV
  *
  * \param [in] *cfg sdadc configuration
+ * \param [in] raw  value of the result register, e.g. stored by the DMA
  *
- * \return Directly get ADC from register, then convert to mV
+ * \return voltage in mV
  *
  */
-__STATIC_INLINE int32_t hw_sdadc_result_reg_to_millivolt(const sdadc_config *cfg)
+__STATIC_INLINE int32_t hw_sdadc_convert_to_millivolt(const sdadc_config *cfg, uint16_t raw)
 {
         int32_t converted;
         uint16_t max;
@@ -533,11 +534,11 @@ __STATIC_INLINE int32_t hw_sdadc_result_reg_to_millivolt(const sdadc_config *cfg
 
         switch (cfg->input_mode) {
         case HW_SDADC_INPUT_MODE_SINGLE_ENDED:
-                converted = (uint16_t) hw_sdadc_read_result_register();
+                converted = raw;
                 max = UINT16_MAX;
                 break;
         case HW_SDADC_INPUT_MODE_DIFFERENTIAL:
-                converted = (int16_t) hw_sdadc_read_result_register();
+                converted = (int16_t) raw;
                 max = UINT16_MAX >> 1;
                 break;
         default:
@@ -549,6 +550,19 @@ __STATIC_INLINE int32_t hw_sdadc_result_reg_to_millivolt(const sdadc_config *cfg
 
 }
 
+/**
+ * \brief Get voltage in mV
+ *
+ * \param [in] *cfg sdadc configuration
+ *
+ * \return Directly get ADC from register, then convert to mV
+ *
+ */
+__STATIC_INLINE int32_t hw_sdadc_result_reg_to_millivolt(const sdadc_config *cfg)
+{
+        return hw_sdadc_convert_to_millivolt(cfg, hw_sdadc_read_result_register());
+}
+
 /**
  * \brief Get voltage in mV
  *
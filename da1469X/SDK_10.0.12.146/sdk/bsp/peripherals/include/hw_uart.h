@@ -1326,6 +1326,76 @@ void hw_uart_enable_rx_circular_dma(HW_UART_ID uart);
  */
 void hw_uart_copy_rx_circular_dma_buffer(HW_UART_ID uart, uint8_t *buf, uint16_t len);
 
+/**
+ * \brief Get number of bytes received in circular RX DMA buffer and not consumed yet
+ *
+ * \param [in] uart identifies UART to use
+ *
+ * \return number of bytes available
+ *
+ */
+uint16_t hw_uart_rx_circular_dma_available(HW_UART_ID uart);
+
+/**
+ * \brief Get received data from circular RX DMA buffer without copying them
+ *
+ * Returns the received data that are contiguous in the buffer, starting at the oldest byte not
+ * consumed yet. If the data wrap around the end of the buffer, the rest is returned by the next
+ * call, after the returned part has been consumed with hw_uart_rx_circular_dma_consume().
+ *
+ * \param [in] uart identifies UART to use
+ * \param [out] data pointer to the received data
+ *
+ * \return number of bytes at \p data
+ *
+ */
+uint16_t hw_uart_rx_circular_dma_peek(HW_UART_ID uart, const uint8_t **data);
+
+/**
+ * \brief Release received data from circular RX DMA buffer
+ *
+ * \param [in] uart identifies UART to use
+ * \param [in] len number of bytes to release, not more than hw_uart_rx_circular_dma_available()
+ *
+ */
+void hw_uart_rx_circular_dma_consume(HW_UART_ID uart, uint16_t len);
+
+/**
+ * \brief Request notification when data are available in circular RX DMA buffer
+ *
+ * The callback is fired once, with the number of bytes available, when:
+ * - at least \p threshold bytes are available (DMA interrupt), or
+ * - some bytes are available and the RX line has been idle for 4 character times (UART character
+ *   timeout interrupt, reported only if the UART is configured to use the FIFO)
+ *
+ * If there are already enough data, or data were received and the line went idle since the
+ * previous notification, the callback is fired immediately from this function.
+ *
+ * This cannot be used while a hw_uart_receive() is in progress. The buffer must be large enough
+ * to hold the data received between two consecutive reads, since an overrun of the buffer
+ * cannot be detected.
+ *
+ * \param [in] uart identifies UART to use
+ * \param [in] threshold number of bytes to wait for, limited to the buffer size minus one
+ * \param [in] cb callback to fire
+ * \param [in] user_data parameter passed to \p cb
+ *
+ */
+void hw_uart_rx_circular_dma_notify(HW_UART_ID uart, uint16_t threshold, hw_uart_rx_callback cb,
+                                                                                void *user_data);
+
+/**
+ * \brief Cancel notification requested with hw_uart_rx_circular_dma_notify()
+ *
+ * If the notification is pending, the callback is fired with the number of bytes available.
+ *
+ * \param [in] uart identifies UART to use
+ *
+ * \return number of bytes available
+ *
+ */
+uint16_t hw_uart_rx_circular_dma_notify_cancel(HW_UART_ID uart);
+
 #endif /* dg_configUART_RX_CIRCULAR_DMA */
 
 #endif /* dg_configUSE_HW_UART */
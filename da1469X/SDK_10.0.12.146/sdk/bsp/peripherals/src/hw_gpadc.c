@@ -29,6 +29,8 @@
 
 #if (dg_configSYSTEMVIEW)
 #  include "SEGGER_SYSVIEW_FreeRTOS.h"
+#elif (dg_configENABLE_TASK_PROFILER == 1)
+#  include "task_profiler.h"
 #else
 #  define SEGGER_SYSTEMVIEW_ISR_ENTER()
 #  define SEGGER_SYSTEMVIEW_ISR_EXIT()
@@ -32,6 +32,8 @@
 
 #if (dg_configSYSTEMVIEW)
 #  include "SEGGER_SYSVIEW_FreeRTOS.h"
+#elif (dg_configENABLE_TASK_PROFILER == 1)
+#  include "task_profiler.h"
 #else
 #  define SEGGER_SYSTEMVIEW_ISR_ENTER()
 #  define SEGGER_SYSTEMVIEW_ISR_EXIT()
@@ -131,6 +133,9 @@ typedef struct {
         uint8_t                 *rx_dma_buf;
         uint16_t                rx_dma_buf_size;
         uint16_t                rx_dma_head;
+        hw_uart_rx_callback     rx_notify_cb;
+        void                    *rx_notify_user_data;
+        bool                    rx_dma_idle;
 #endif /* dg_configUART_RX_CIRCULAR_DMA */
 #endif /* HW_UART_DMA_SUPPORT */
 } UART_Data;
@@ -621,6 +626,11 @@ uint16_t hw_uart_abort_receive(HW_UART_ID uart)
                 /* Stop DMA even if DMA circular buffer is used */
                 hw_dma_channel_stop(ud->rx_dma.channel_number);
         }
+#endif
+#if dg_configUART_RX_CIRCULAR_DMA
+        if (ud->rx_dma_buf_size > 0) {
+                hw_uart_rx_circular_dma_notify_cancel(uart);
+        }
 #endif
         hw_uart_irq_stop_receive(uart);
 
@@ -755,10 +765,22 @@ __STATIC_INLINE void hw_uart_rx_isr(HW_UART_ID uart)
 
 }
 
+#if dg_configUART_RX_CIRCULAR_DMA
+static void hw_uart_rx_circular_dma_idle(UART_Data *ud);
+#endif
+
 __STATIC_INLINE void hw_uart_rx_timeout_isr(HW_UART_ID uart)
 {
         UART_Data *ud = UARTDATA(uart);
 
+#if dg_configUART_RX_CIRCULAR_DMA
+        /* DMA reads the data, only report that the line went idle */
+        if (ud->rx_dma_buf_size > 0) {
+                hw_uart_rx_circular_dma_idle(ud);
+                return;
+        }
+#endif
+
         hw_uart_rx_isr(uart);
 
         /*
@@ -1126,11 +1148,52 @@ void hw_uart_set_dma_channels_ex(HW_UART_ID uart, const uart_config_ex *uart_ini
 
 #if dg_configUART_RX_CIRCULAR_DMA
 
+/* Bytes between the read pointer and the DMA write index */
+static uint16_t hw_uart_rx_circular_dma_used(UART_Data *ud)
+{
+        uint16_t cur_idx = hw_dma_transfered_bytes(ud->rx_dma.channel_number);
+
+        if (cur_idx < ud->rx_dma_head) {
+                cur_idx += ud->rx_dma_buf_size;
+        }
+
+        return cur_idx - ud->rx_dma_head;
+}
+
+static void hw_uart_rx_circular_dma_fire_notify(UART_Data *ud)
+{
+        hw_uart_rx_callback cb = ud->rx_notify_cb;
+
+        ud->rx_notify_cb = NULL;
+        cb(ud->rx_notify_user_data, hw_uart_rx_circular_dma_used(ud));
+}
+
+static void hw_uart_rx_circular_dma_idle(UART_Data *ud)
+{
+        /*
+         * Character timeout, data stopped coming. If no one waits for them, remember it so that
+         * the next notification request is fired immediately.
+         */
+        if (hw_uart_rx_circular_dma_used(ud) == 0) {
+                return;
+        }
+        if (ud->rx_notify_cb) {
+                hw_uart_rx_circular_dma_fire_notify(ud);
+        } else {
+                ud->rx_dma_idle = true;
+        }
+}
+
 static void hw_uart_rx_circular_dma_callback(void *user_data, dma_size_t len)
 {
         UART_Data *ud = user_data;
         hw_uart_rx_callback cb = ud->rx_cb;
 
+        if (ud->rx_notify_cb) {
+                hw_uart_rx_circular_dma_fire_notify(ud);
+                return;
+        }
+
         if (!ud->rx_dma_active) {
                 return;
         }
@@ -1187,6 +1250,93 @@ void hw_uart_copy_rx_circular_dma_buffer(HW_UART_ID uart, uint8_t *buf, uint16_t
         GLOBAL_INT_RESTORE();
 }
 
+uint16_t hw_uart_rx_circular_dma_available(HW_UART_ID uart)
+{
+        return hw_uart_rx_circular_dma_used(UARTDATA(uart));
+}
+
+uint16_t hw_uart_rx_circular_dma_peek(HW_UART_ID uart, const uint8_t **data)
+{
+        UART_Data *ud = UARTDATA(uart);
+        uint16_t len = hw_uart_rx_circular_dma_used(ud);
+
+        *data = &ud->rx_dma_buf[ud->rx_dma_head];
+
+        return MIN(len, ud->rx_dma_buf_size - ud->rx_dma_head);
+}
+
+void hw_uart_rx_circular_dma_consume(HW_UART_ID uart, uint16_t len)
+{
+        UART_Data *ud = UARTDATA(uart);
+
+        ASSERT_ERROR(len <= hw_uart_rx_circular_dma_used(ud));
+
+        GLOBAL_INT_DISABLE();
+        ud->rx_dma_head = (ud->rx_dma_head + len) % ud->rx_dma_buf_size;
+        GLOBAL_INT_RESTORE();
+}
+
+void hw_uart_rx_circular_dma_notify(HW_UART_ID uart, uint16_t threshold, hw_uart_rx_callback cb,
+                                                                                void *user_data)
+{
+        UART_Data *ud = UARTDATA(uart);
+        uint16_t used;
+        bool data_ready;
+
+        ASSERT_ERROR(ud->rx_dma_buf_size > 0 && cb != NULL);
+        ASSERT_ERROR(ud->rx_dma_active == false && ud->rx_notify_cb == NULL);
+
+        threshold = MIN(MAX(threshold, 1), ud->rx_dma_buf_size - 1);
+
+        /* Freeze DMA so it does not move pointers while we try to update them */
+        hw_dma_freeze();
+
+        used = hw_uart_rx_circular_dma_used(ud);
+        data_ready = (used >= threshold) || (ud->rx_dma_idle && used > 0);
+        ud->rx_dma_idle = false;
+
+        if (!data_ready) {
+                hw_dma_channel_update_int_ix(ud->rx_dma.channel_number,
+                                        (ud->rx_dma_head + threshold - 1) % ud->rx_dma_buf_size);
+                ud->rx_notify_user_data = user_data;
+                ud->rx_notify_cb = cb;
+        }
+
+        hw_dma_unfreeze();
+
+        if (data_ready) {
+                cb(user_data, used);
+                return;
+        }
+
+        /*
+         * Character timeout is reported with the received data available interrupt. DMA keeps
+         * draining the FIFO, so the ISR does not read any data in this mode.
+         */
+        if (ud->rx_fifo_on) {
+                hw_uart_enable_rx_int(uart, true);
+        }
+}
+
+uint16_t hw_uart_rx_circular_dma_notify_cancel(HW_UART_ID uart)
+{
+        UART_Data *ud = UARTDATA(uart);
+        hw_uart_rx_callback cb;
+        uint16_t used;
+
+        GLOBAL_INT_DISABLE();
+        cb = ud->rx_notify_cb;
+        ud->rx_notify_cb = NULL;
+        GLOBAL_INT_RESTORE();
+
+        used = hw_uart_rx_circular_dma_used(ud);
+        if (cb) {
+                cb(ud->rx_notify_user_data, used);
+        }
+
+        return used;
+}
+
 #endif /* dg_configUART_RX_CIRCULAR_DMA */
 
 #endif /* HW_UART_DMA_SUPPORT */
@@ -81,6 +81,29 @@ typedef struct {
         bool swap_pushed_data_bytes;            /**< Swap CM33 pushed data bytes                       */
         bool swap_popped_data_bytes;            /**< Swap CM33 popped data bytes                       */
 } snc_queue_config_t;
+
+/**
+ * \brief SNC queue span, i.e. chunks that are consecutive in queue memory
+ *
+ */
+typedef struct {
+        uint32_t *first_chunk;                  /**< Header of the first chunk of the span             */
+        uint32_t num_of_chunks;                 /**< Number of chunks in the span                      */
+} snc_queue_span_t;
+
+/**
+ * \brief Chunks of an SNC queue accessed in place, as obtained by snc_queues_cm33_peek()
+ *
+ * The chunks up to the end of queue memory are in span[0], the chunks that wrap around to the
+ * beginning of queue memory are in span[1].
+ *
+ */
+typedef struct {
+        snc_queue_span_t span[2];               /**< Spans of chunks, in queue order                   */
+        uint32_t num_of_chunks;                 /**< Total number of chunks                            */
+        uint32_t chunk_words;                   /**< Distance between consecutive chunks in words      */
+        uint32_t hdr_words;                     /**< Chunk header size in words                        */
+} snc_queue_peek_t;
 #endif /* dg_configUSE_SNC_QUEUES */
 
 #if dg_configUSE_SNC_DEBUGGER
@@ -1147,6 +1147,115 @@ uint32_t snc_queues_cm33_get_cur_chunk_bytes(const snc_queue_t snc_queue)
         return (((snc_queue_c_hdr_t*)pQ)->preamble & SNC_QUEUE_PREAMBLE_MASK_SIZE);
 }
 
+uint32_t snc_queues_cm33_peek(const snc_queue_t snc_queue, uint32_t max_chunks,
+        snc_queue_peek_t *peek)
+{
+        snc_q_t *sncQ;
+        uint32_t first;
+        uint32_t idx;
+        uint32_t n = 0;
+
+        ASSERT_WARNING(snc_queue);
+        ASSERT_WARNING(peek);
+
+        sncQ = (snc_q_t *)snc_queue;
+        first = sncQ->read_chunk_pt - sncQ->pChunks;
+
+        // Count the written chunks in queue order, stopping at the first free one
+        idx = first;
+        while (n < max_chunks && n < sncQ->num_of_chunks &&
+                (((snc_queue_c_hdr_t*)sncQ->pChunks[idx])->preamble & SNC_QUEUE_PREAMBLE_MASK_WBIT)) {
+                ++n;
+                idx = (idx + 1 == sncQ->num_of_chunks) ? 0 : idx + 1;
+        }
+
+        // Chunks are laid out consecutively in queue data, split the range where it wraps around
+        peek->num_of_chunks = n;
+        peek->chunk_words = sncQ->pChunks[1] - sncQ->pChunks[0];
+        peek->hdr_words = (!(sncQ->flags & SNC_QUEUE_FLAG_NO_DATA_TIMESTAMP)) ?
+                                TIMESTAMPED_HEADER_SIZE : SIMPLE_HEADER_SIZE;
+        peek->span[0].first_chunk = sncQ->pChunks[first];
+        peek->span[0].num_of_chunks = MIN(n, sncQ->num_of_chunks - first);
+        peek->span[1].first_chunk = sncQ->pChunks[0];
+        peek->span[1].num_of_chunks = n - peek->span[0].num_of_chunks;
+
+        return n;
+}
+
+const uint32_t *snc_queues_cm33_peek_chunk(const snc_queue_peek_t *peek, uint32_t index,
+        uint32_t *size)
+{
+        const uint32_t *pChunk;
+
+        ASSERT_WARNING(peek);
+        ASSERT_WARNING(index < peek->num_of_chunks);
+
+        if (index < peek->span[0].num_of_chunks) {
+                pChunk = peek->span[0].first_chunk + index * peek->chunk_words;
+        } else {
+                index -= peek->span[0].num_of_chunks;
+                pChunk = peek->span[1].first_chunk + index * peek->chunk_words;
+        }
+
+        if (size) {
+                *size = ((const snc_queue_c_hdr_t*)pChunk)->preamble & SNC_QUEUE_PREAMBLE_MASK_SIZE;
+        }
+
+        return pChunk + peek->hdr_words;
+}
+
+uint32_t snc_queues_cm33_peek_timestamps(const snc_queue_peek_t *peek, uint32_t *timestamps,
+        uint32_t max_timestamps)
+{
+        const uint32_t *pChunk;
+        uint32_t n = 0;
+        uint32_t s, i;
+
+        ASSERT_WARNING(peek);
+
+        if (peek->hdr_words != TIMESTAMPED_HEADER_SIZE) {
+                return 0;
+        }
+
+        for (s = 0; s < 2; s++) {
+                pChunk = peek->span[s].first_chunk;
+                for (i = 0; i < peek->span[s].num_of_chunks && n < max_timestamps; i++) {
+                        timestamps[n++] = ((const snc_queue_c_hdr_t*)pChunk)->timestamp;
+                        pChunk += peek->chunk_words;
+                }
+        }
+
+        return n;
+}
+
+void snc_queues_cm33_consume(const snc_queue_t snc_queue, uint32_t num_of_chunks)
+{
+        snc_q_t *sncQ;
+        uint32_t **temp_read_pt;
+
+        ASSERT_WARNING(snc_queue);
+
+        sncQ = (snc_q_t *)snc_queue;
+        temp_read_pt = sncQ->read_chunk_pt;
+
+        while (num_of_chunks--) {
+                ASSERT_WARNING(((snc_queue_c_hdr_t*)*temp_read_pt)->preamble &
+                        SNC_QUEUE_PREAMBLE_MASK_WBIT);
+
+                // Clear the preamble to mark the chunk as read, as in snc_queues_cm33_pop()
+                ((snc_queue_c_hdr_t*)*temp_read_pt)->preamble = 0;
+
+                if (temp_read_pt == sncQ->last_chunk_pt) {
+                        temp_read_pt = sncQ->pChunks;
+                } else {
+                        ++temp_read_pt;
+                }
+        }
+
+        // Update the value of the queue read pointer once for all released chunks
+        sncQ->read_chunk_pt = temp_read_pt;
+}
+
 #endif /* dg_configUSE_SNC_QUEUES */
 
 #endif /* dg_configUSE_HW_SENSOR_NODE */
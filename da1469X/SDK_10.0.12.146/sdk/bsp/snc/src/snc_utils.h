@@ -419,6 +419,68 @@ uint32_t snc_queues_cm33_get_alloc_chunks(snc_queue_t snc_queue);
  * \return uint32_t             the number of bytes in the chunk
  */
 uint32_t snc_queues_cm33_get_cur_chunk_bytes(snc_queue_t snc_queue);
+
+/**
+ * \brief Function used in SYSCPU context to access the written chunks of an SNC queue in place
+ *
+ * Returns the written chunks starting from the next chunk to be popped, without copying or
+ * releasing them. The chunks stay untouched by the SNC until they are released with
+ * snc_queues_cm33_consume(), so their data can be processed directly in queue memory. The data
+ * of a chunk is as written by the SNC, i.e. one element per 32-bit word for byte and half-word
+ * element weights, and without the byte swapping of snc_queues_cm33_pop().
+ *
+ * Only one task may pop or consume from a queue.
+ *
+ * \param [in] snc_queue        a pointer to the queue
+ * \param [in] max_chunks       the maximum number of chunks to return
+ * \param [out] peek            the returned chunks
+ *
+ * \return uint32_t             the number of chunks returned (0 if the queue is empty)
+ *
+ * \sa snc_queues_cm33_peek_chunk
+ * \sa snc_queues_cm33_peek_timestamps
+ * \sa snc_queues_cm33_consume
+ */
+uint32_t snc_queues_cm33_peek(snc_queue_t snc_queue, uint32_t max_chunks, snc_queue_peek_t *peek);
+
+/**
+ * \brief Function used in SYSCPU context to get the data of a chunk obtained by
+ *        snc_queues_cm33_peek()
+ *
+ * \param [in] peek             the chunks obtained by snc_queues_cm33_peek()
+ * \param [in] index            the index of the chunk (0 for the oldest one)
+ * \param [out] size            the size of the chunk data in bytes
+ *
+ * \return const uint32_t*      a pointer to the chunk data in queue memory
+ */
+const uint32_t *snc_queues_cm33_peek_chunk(const snc_queue_peek_t *peek, uint32_t index,
+        uint32_t *size);
+
+/**
+ * \brief Function used in SYSCPU context to read the timestamps of the chunks obtained by
+ *        snc_queues_cm33_peek()
+ *
+ * \param [in] peek             the chunks obtained by snc_queues_cm33_peek()
+ * \param [out] timestamps      the returned timestamps, oldest first
+ * \param [in] max_timestamps   the size of the timestamps array
+ *
+ * \return uint32_t             the number of timestamps returned
+ *                              (0 if the queue does not support data timestamping)
+ */
+uint32_t snc_queues_cm33_peek_timestamps(const snc_queue_peek_t *peek, uint32_t *timestamps,
+        uint32_t max_timestamps);
+
+/**
+ * \brief Function used in SYSCPU context to release chunks obtained by snc_queues_cm33_peek()
+ *
+ * Releases the oldest chunks at once, so that the SNC can write them again, with the same effect
+ * as popping them one by one.
+ *
+ * \param [in] snc_queue        a pointer to the queue
+ * \param [in] num_of_chunks    the number of chunks to release, up to the number of chunks
+ *                              obtained by the last snc_queues_cm33_peek()
+ */
+void snc_queues_cm33_consume(snc_queue_t snc_queue, uint32_t num_of_chunks);
 #endif /* dg_configUSE_SNC_QUEUES */
 
 #endif /* dg_configUSE_HW_SENSOR_NODE */
@@ -149,6 +149,8 @@ typedef struct {
  * \param[in] buff_data_block pointer to the audio buffer data block
  * \param[in] app_ud Application user data
  *
+ * \sa sys_audio_sw_src.h for converting or mixing the buffers in software
+ *
  */
 typedef void (*sys_audio_mgr_buffer_ready_cb)(sys_audio_mgr_buffer_data_block_t *buff_data_block, void *app_ud);
 
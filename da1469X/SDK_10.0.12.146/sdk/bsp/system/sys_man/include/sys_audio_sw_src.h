@@ -0,0 +1,172 @@
+/**
+ * \addtogroup MID_SYS_SERVICES
+ * \{
+ * \addtogroup SYS_AUDIO_SW_SRC Audio Software Sample Rate Converter
+ *
+ * \brief Fixed-point sample rate conversion and mixing of audio memory buffers
+ *
+ * \{
+ *
+ * Block based processing of audio data in memory, meant to be called on the buffers handed over
+ * by the audio manager (sys_audio_mgr_buffer_ready_cb), e.g. to mix a prompt into a voice stream
+ * or to convert between 8/16/32/48 kHz without using an APU SRC instance.
+ *
+ * The converter is a polyphase FIR filter (Blackman windowed sinc) for the rational ratio
+ * out_rate / in_rate = L / M, designed when the converter is initialized. Each input sample
+ * costs dg_configSYS_AUDIO_SW_SRC_TAPS multiply-accumulates per step of the larger of L and M,
+ * rounded up to a multiple of L. The pass band extends to about 75% of the lower of the two
+ * Nyquist frequencies.
+ *
+ * \code{.c}
+ * static sys_audio_sw_src_t src;
+ *
+ * sys_audio_sw_src_init(&src, 16000, 48000);
+ * ...
+ * // buffer ready callback of the 16 kHz input path
+ * n = sys_audio_sw_src_q15(&src, in, in_len, out);
+ * \endcode
+ */
+
+/**
+ ****************************************************************************************
+ *
+ * @file sys_audio_sw_src.h
+ *
+ * @brief Audio software sample rate converter and mixer API
+ *
+ * Copyright (C) 2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ ****************************************************************************************
+ */
+
+#ifndef SYS_AUDIO_SW_SRC_H_
+#define SYS_AUDIO_SW_SRC_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#if dg_configSYS_AUDIO_SW_SRC
+
+/**
+ * \brief Maximum number of filter coefficients
+ */
+#define SYS_AUDIO_SW_SRC_MAX_COEFS      ((2 * dg_configSYS_AUDIO_SW_SRC_MAX_RATIO - 1) * \
+                                         dg_configSYS_AUDIO_SW_SRC_TAPS)
+
+/**
+ * \brief Maximum number of taps of a polyphase branch
+ */
+#define SYS_AUDIO_SW_SRC_MAX_PHASE_TAPS (dg_configSYS_AUDIO_SW_SRC_MAX_RATIO * \
+                                         dg_configSYS_AUDIO_SW_SRC_TAPS)
+
+/**
+ * \brief Mixer gain of 1.0, gains are unsigned Q15 (0x8000 is unity, up to 0xFFFF)
+ */
+#define SYS_AUDIO_SW_MIX_GAIN_UNITY     (0x8000)
+
+/**
+ * \brief Software sample rate converter instance
+ *
+ * One instance converts one channel in one sample format (Q15 or Q31), as it keeps the input
+ * history between calls.
+ */
+typedef struct {
+        uint8_t up;                     /**< Interpolation factor L */
+        uint8_t down;                   /**< Decimation factor M */
+        uint8_t phase;                  /**< Polyphase branch of the next output sample */
+        uint16_t taps;                  /**< Taps per polyphase branch */
+        uint16_t pos;                   /**< Position of the newest sample in hist */
+        int16_t coef[SYS_AUDIO_SW_SRC_MAX_COEFS];               /**< Q15, branch after branch */
+        int32_t hist[2 * SYS_AUDIO_SW_SRC_MAX_PHASE_TAPS];      /**< Input history, kept twice */
+} sys_audio_sw_src_t;
+
+/**
+ * \brief Initialize sample rate converter
+ *
+ * \param [out] src converter instance
+ * \param [in] in_rate input sample rate in Hz
+ * \param [in] out_rate output sample rate in Hz
+ *
+ * \return true if the converter was initialized, false if the reduced ratio out_rate / in_rate
+ *         has a term larger than dg_configSYS_AUDIO_SW_SRC_MAX_RATIO
+ */
+bool sys_audio_sw_src_init(sys_audio_sw_src_t *src, uint32_t in_rate, uint32_t out_rate);
+
+/**
+ * \brief Clear input history, e.g. when a stream restarts
+ *
+ * \param [in] src converter instance
+ */
+void sys_audio_sw_src_reset(sys_audio_sw_src_t *src);
+
+/**
+ * \brief Get the maximum number of output samples for a number of input samples
+ *
+ * \param [in] src converter instance
+ * \param [in] in_len number of input samples
+ *
+ * \return the size of the output buffer to pass to sys_audio_sw_src_q15()/sys_audio_sw_src_q31()
+ */
+size_t sys_audio_sw_src_max_output(const sys_audio_sw_src_t *src, size_t in_len);
+
+/**
+ * \brief Convert block of 16-bit samples
+ *
+ * \param [in] src converter instance
+ * \param [in] in input samples
+ * \param [in] in_len number of input samples, all of them are consumed
+ * \param [out] out output samples, room for sys_audio_sw_src_max_output() samples
+ *
+ * \return number of output samples
+ */
+size_t sys_audio_sw_src_q15(sys_audio_sw_src_t *src, const int16_t *in, size_t in_len,
+                            int16_t *out);
+
+/**
+ * \brief Convert block of 32-bit samples
+ *
+ * \param [in] src converter instance
+ * \param [in] in input samples
+ * \param [in] in_len number of input samples, all of them are consumed
+ * \param [out] out output samples, room for sys_audio_sw_src_max_output() samples
+ *
+ * \return number of output samples
+ */
+size_t sys_audio_sw_src_q31(sys_audio_sw_src_t *src, const int32_t *in, size_t in_len,
+                            int32_t *out);
+
+/**
+ * \brief Mix blocks of 16-bit samples with saturation
+ *
+ * \param [out] out mixed samples, can be the same buffer as one of the inputs
+ * \param [in] in input blocks
+ * \param [in] gain gain of each input, SYS_AUDIO_SW_MIX_GAIN_UNITY is 1.0
+ * \param [in] num_in number of inputs
+ * \param [in] len number of samples of each block
+ */
+void sys_audio_sw_mix_q15(int16_t *out, const int16_t *const in[], const uint16_t gain[],
+                          uint8_t num_in, size_t len);
+
+/**
+ * \brief Mix blocks of 32-bit samples with saturation
+ *
+ * \param [out] out mixed samples, can be the same buffer as one of the inputs
+ * \param [in] in input blocks
+ * \param [in] gain gain of each input, SYS_AUDIO_SW_MIX_GAIN_UNITY is 1.0
+ * \param [in] num_in number of inputs
+ * \param [in] len number of samples of each block
+ */
+void sys_audio_sw_mix_q31(int32_t *out, const int32_t *const in[], const uint16_t gain[],
+                          uint8_t num_in, size_t len);
+
+#endif /* dg_configSYS_AUDIO_SW_SRC */
+
+#endif /* SYS_AUDIO_SW_SRC_H_ */
+
+/**
+ * \}
+ * \}
+ */
@@ -36,6 +36,16 @@ typedef enum {
         cm_sysclk_success
 } cm_sys_clk_set_status_t;
 
+/**
+ * \brief Handle of a system clock voter
+ */
+typedef uint8_t cm_sys_clk_voter_t;
+
+/**
+ * \brief Invalid system clock voter, returned when no more voters can be registered
+ */
+#define CM_SYS_CLK_VOTER_INVALID        ((cm_sys_clk_voter_t)0xFF)
+
 /**
  * \brief Initialize clocks after power-up.
  *
@@ -86,6 +96,73 @@ void cm_rcx_calibrate(void);
  */
 cm_sys_clk_set_status_t cm_sys_clk_set(sys_clk_t type);
 
+#ifdef OS_FREERTOS
+/**
+ * \brief Register a system clock voter.
+ *
+ * \details Voting is an alternative to cm_sys_clk_set() for tasks that need a faster system clock
+ *          in short bursts, e.g. audio or BLE processing. Each voter requests a minimum system
+ *          clock and the system clock follows the lowest clock that satisfies all votes. Votes do
+ *          not allocate memory and take constant time.
+ *
+ *          The voters count as a single task using the PLL with respect to cm_sys_clk_set(). While
+ *          any vote is applied, cm_sys_clk_set() cannot lower the system clock below it, but the
+ *          clock it requested is restored when the votes are withdrawn.
+ *
+ * \return The voter, CM_SYS_CLK_VOTER_INVALID if dg_configCM_MAX_SYS_CLK_VOTERS voters are
+ *         already registered.
+ *
+ * \warning It may block. It cannot be called from Interrupt Context.
+ */
+cm_sys_clk_voter_t cm_sys_clk_voter_register(void);
+
+/**
+ * \brief Unregister a system clock voter, withdrawing its vote.
+ *
+ * \param[in] voter The voter.
+ *
+ * \warning It may block. It cannot be called from Interrupt Context.
+ */
+void cm_sys_clk_voter_unregister(cm_sys_clk_voter_t voter);
+
+/**
+ * \brief Vote for a minimum system clock.
+ *
+ * \details It replaces the previous vote of the voter. If the vote raises the system clock, the task
+ *          blocks until the XTAL32M has settled and, for sysclk_PLL96, the PLL has locked. A vote
+ *          for sysclk_RC32 is the same as cm_sys_clk_unvote().
+ *
+ * \param[in] voter The voter.
+ * \param[in] clk The minimum system clock.
+ *
+ * \return cm_sysclk_success            if the system clock satisfies the vote
+ *         cm_sysclk_div1_clk_in_use    if system clock cannot be switched because a peripheral is
+ *                                      clocked by DIV1 clock. The vote is not taken into account.
+ *         cm_sysclk_ahb_divider_in_use if the vote is for sysclk_PLL96 and the AHB divider is not
+ *                                      ahb_div1
+ *
+ * \warning It may block. It cannot be called from Interrupt Context.
+ */
+cm_sys_clk_set_status_t cm_sys_clk_vote(cm_sys_clk_voter_t voter, sys_clk_t clk);
+
+/**
+ * \brief Withdraw the vote of a voter.
+ *
+ * \details The system clock is lowered to the clock that satisfies the remaining votes or, if there
+ *          are none, to the clock set by cm_sys_clk_set().
+ *
+ * \param[in] voter The voter.
+ *
+ * \return cm_sysclk_success            if the system clock was lowered, or did not have to be
+ *         cm_sysclk_div1_clk_in_use    if system clock cannot be lowered because a peripheral is
+ *                                      clocked by DIV1 clock. It is lowered by the next vote or
+ *                                      withdrawal.
+ *
+ * \warning It may block. It cannot be called from Interrupt Context.
+ */
+cm_sys_clk_set_status_t cm_sys_clk_unvote(cm_sys_clk_voter_t voter);
+#endif /* OS_FREERTOS */
+
 
 /**
  * \brief Set the CPU clock.
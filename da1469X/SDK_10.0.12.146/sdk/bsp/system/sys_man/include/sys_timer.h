@@ -101,6 +101,64 @@ uint64_t sys_timer_get_uptime_usec(void);
  */
 __RETAINED_CODE uint64_t sys_timer_get_uptime_usec_fromISR(void);
 
+/**
+ * \brief Get uptime ticks value, without a critical section.
+ *
+ * \details Adds the OS timer cycles elapsed since the last update of the uptime to a snapshot of
+ *          it. The snapshot is updated by the functions above and by the power manager at every
+ *          sleep entry and wake-up. If it is older than half the range of the OS timer (256 sec
+ *          with XTAL32K), the function updates it first, as sys_timer_get_uptime_ticks() does.
+ *
+ * \return The uptime ticks, same as sys_timer_get_uptime_ticks() would return.
+ *
+ * \note It can be called from OS Tasks and from Interrupt Context.
+ *
+ */
+__RETAINED_CODE uint64_t sys_timer_get_uptime_ticks_fast(void);
+
+/**
+ * \brief Get uptime in usec, without a critical section.
+ *
+ * \details See sys_timer_get_uptime_ticks_fast(). The conversion to usec uses a multiplication and
+ *          a shift. With XTAL32K (32768Hz or 32000Hz) it is exact and the result is the same as
+ *          that of sys_timer_get_uptime_usec(). With RCX, each OS timer cycle counts with the RCX
+ *          period known at the last update of the uptime, with 2^-20 usec resolution.
+ *
+ *          The resolution is one OS timer cycle, e.g. 30.5usec with XTAL32K. Successive values are
+ *          monotonic.
+ *
+ * \return The uptime in usec.
+ *
+ * \note It can be called from OS Tasks and from Interrupt Context.
+ *
+ */
+__RETAINED_CODE uint64_t sys_timer_get_uptime_usec_fast(void);
+
+/**
+ * \brief Get uptime in usec with sub OS timer cycle resolution.
+ *
+ * \details When dg_configSYS_TIMER_USE_DWT is 1, the position within the current OS timer cycle is
+ *          interpolated from the CPU cycle counter (DWT CYCCNT) while the system is awake. The
+ *          result is never earlier than sys_timer_get_uptime_usec_fast() and stays within the same
+ *          OS timer cycle, so it is at most one OS timer cycle later. When the CPU clock matches
+ *          its nominal frequency the resolution is 1usec.
+ *
+ *          The cycle counter is anchored to an edge of the LP clock by the first call from an OS
+ *          Task after power-up, after each wake-up and after the CPU clock or the LP clock drifted
+ *          by more than an OS timer cycle. That call waits for the next edge, up to one OS timer
+ *          cycle. Calls from Interrupt Context never wait and return the start of the OS timer
+ *          cycle until a task has anchored the counter.
+ *
+ *          When dg_configSYS_TIMER_USE_DWT is 0, it is the same as
+ *          sys_timer_get_uptime_usec_fast().
+ *
+ * \return The uptime in usec.
+ *
+ * \note It can be called from OS Tasks and from Interrupt Context.
+ *
+ */
+uint64_t sys_timer_get_uptime_usec_hires(void);
+
 /**
  * \brief Get timestamp value.
  *
@@ -0,0 +1,231 @@
+/**
+ ****************************************************************************************
+ *
+ * @file sys_audio_sw_src.c
+ *
+ * @brief Audio software sample rate converter and mixer
+ *
+ * Copyright (C) 2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ ****************************************************************************************
+ */
+#if dg_configSYS_AUDIO_SW_SRC
+
+#include <string.h>
+#include <math.h>
+#include "sdk_defs.h"
+#include "sys_audio_sw_src.h"
+
+#define SW_SRC_PI               3.14159265f
+
+/* Half of the Blackman window transition band, in units of 1 / filter length */
+#define SW_SRC_HALF_TRANSITION  2.75f
+
+static uint32_t gcd(uint32_t a, uint32_t b)
+{
+        while (b) {
+                uint32_t t = a % b;
+
+                a = b;
+                b = t;
+        }
+
+        return a;
+}
+
+static inline int16_t sat_q15(int32_t v)
+{
+        if (v > INT16_MAX) {
+                return INT16_MAX;
+        }
+        if (v < INT16_MIN) {
+                return INT16_MIN;
+        }
+        return (int16_t)v;
+}
+
+static inline int32_t sat_q31(int64_t v)
+{
+        if (v > INT32_MAX) {
+                return INT32_MAX;
+        }
+        if (v < INT32_MIN) {
+                return INT32_MIN;
+        }
+        return (int32_t)v;
+}
+
+/*
+ * Design the prototype low pass filter at the upsampled rate and store it as polyphase
+ * branches, coef[p * taps + t] = h[p + t * L], each branch scaled to unity DC gain.
+ */
+static void design_filter(sys_audio_sw_src_t *src)
+{
+        const uint16_t taps = src->taps;
+        const uint32_t len = (uint32_t)src->up * taps;
+        const float center = (len - 1) / 2.0f;
+        const float fc = 0.5f / MAX(src->up, src->down) - SW_SRC_HALF_TRANSITION / len;
+        float h[SYS_AUDIO_SW_SRC_MAX_PHASE_TAPS];
+
+        for (uint8_t p = 0; p < src->up; p++) {
+                float sum = 0.0f;
+                int32_t qsum = 0;
+                uint16_t peak = 0;
+
+                for (uint16_t t = 0; t < taps; t++) {
+                        const uint32_t k = p + (uint32_t)t * src->up;
+                        const float x = k - center;
+                        const float w = 0.42f - 0.5f * cosf(2 * SW_SRC_PI * k / (len - 1)) +
+                                        0.08f * cosf(4 * SW_SRC_PI * k / (len - 1));
+                        float s = 2 * fc;
+
+                        if (x != 0.0f) {
+                                s = sinf(2 * SW_SRC_PI * fc * x) / (SW_SRC_PI * x);
+                        }
+                        h[t] = s * w;
+                        sum += h[t];
+                }
+
+                for (uint16_t t = 0; t < taps; t++) {
+                        const int32_t q = sat_q15((int32_t)lroundf(h[t] / sum * 32768.0f));
+
+                        src->coef[p * taps + t] = q;
+                        qsum += q;
+                        if (fabsf(h[t]) > fabsf(h[peak])) {
+                                peak = t;
+                        }
+                }
+
+                /* Put the rounding error into the largest tap, so DC passes unchanged */
+                src->coef[p * taps + peak] = sat_q15(src->coef[p * taps + peak] + 32768 - qsum);
+        }
+}
+
+bool sys_audio_sw_src_init(sys_audio_sw_src_t *src, uint32_t in_rate, uint32_t out_rate)
+{
+        uint32_t g, up, down;
+
+        if (in_rate == 0 || out_rate == 0) {
+                return false;
+        }
+
+        g = gcd(in_rate, out_rate);
+        up = out_rate / g;
+        down = in_rate / g;
+        if (up > dg_configSYS_AUDIO_SW_SRC_MAX_RATIO || down > dg_configSYS_AUDIO_SW_SRC_MAX_RATIO) {
+                return false;
+        }
+
+        src->up = up;
+        src->down = down;
+        src->taps = dg_configSYS_AUDIO_SW_SRC_TAPS * ((MAX(up, down) + up - 1) / up);
+        design_filter(src);
+        sys_audio_sw_src_reset(src);
+
+        return true;
+}
+
+void sys_audio_sw_src_reset(sys_audio_sw_src_t *src)
+{
+        src->phase = 0;
+        src->pos = 0;
+        memset(src->hist, 0, sizeof(src->hist));
+}
+
+size_t sys_audio_sw_src_max_output(const sys_audio_sw_src_t *src, size_t in_len)
+{
+        return (in_len * src->up + src->down - 1) / src->down + 1;
+}
+
+/*
+ * The history is kept twice, so hist[pos .. pos + taps - 1] always holds the newest taps
+ * samples in a contiguous block and no wrap check is needed in the filter loop.
+ */
+static inline const int32_t *push_sample(sys_audio_sw_src_t *src, int32_t x)
+{
+        src->pos = src->pos ? src->pos - 1 : src->taps - 1;
+        src->hist[src->pos] = x;
+        src->hist[src->pos + src->taps] = x;
+
+        return &src->hist[src->pos];
+}
+
+size_t sys_audio_sw_src_q15(sys_audio_sw_src_t *src, const int16_t *in, size_t in_len,
+                            int16_t *out)
+{
+        const uint16_t taps = src->taps;
+        size_t n = 0;
+
+        for (size_t i = 0; i < in_len; i++) {
+                const int32_t *x = push_sample(src, in[i]);
+
+                while (src->phase < src->up) {
+                        const int16_t *c = &src->coef[src->phase * taps];
+                        int32_t acc = 1 << 14;
+
+                        for (uint16_t t = 0; t < taps; t++) {
+                                acc += c[t] * x[t];
+                        }
+                        out[n++] = sat_q15(acc >> 15);
+                        src->phase += src->down;
+                }
+                src->phase -= src->up;
+        }
+
+        return n;
+}
+
+size_t sys_audio_sw_src_q31(sys_audio_sw_src_t *src, const int32_t *in, size_t in_len,
+                            int32_t *out)
+{
+        const uint16_t taps = src->taps;
+        size_t n = 0;
+
+        for (size_t i = 0; i < in_len; i++) {
+                const int32_t *x = push_sample(src, in[i]);
+
+                while (src->phase < src->up) {
+                        const int16_t *c = &src->coef[src->phase * taps];
+                        int64_t acc = 1 << 14;
+
+                        for (uint16_t t = 0; t < taps; t++) {
+                                acc += (int64_t)c[t] * x[t];
+                        }
+                        out[n++] = sat_q31(acc >> 15);
+                        src->phase += src->down;
+                }
+                src->phase -= src->up;
+        }
+
+        return n;
+}
+
+void sys_audio_sw_mix_q15(int16_t *out, const int16_t *const in[], const uint16_t gain[],
+                          uint8_t num_in, size_t len)
+{
+        for (size_t n = 0; n < len; n++) {
+                int64_t acc = 1 << 14;
+
+                for (uint8_t i = 0; i < num_in; i++) {
+                        acc += (int32_t)in[i][n] * gain[i];
+                }
+                out[n] = sat_q15((int32_t)(acc >> 15));
+        }
+}
+
+void sys_audio_sw_mix_q31(int32_t *out, const int32_t *const in[], const uint16_t gain[],
+                          uint8_t num_in, size_t len)
+{
+        for (size_t n = 0; n < len; n++) {
+                int64_t acc = 1 << 14;
+
+                for (uint8_t i = 0; i < num_in; i++) {
+                        acc += (int64_t)in[i][n] * gain[i];
+                }
+                out[n] = sat_q31(acc >> 15);
+        }
+}
+
+#endif /* dg_configSYS_AUDIO_SW_SRC */
@@ -50,6 +50,8 @@
 
 #if (dg_configSYSTEMVIEW)
 #include "SEGGER_SYSVIEW_FreeRTOS.h"
+#elif (dg_configENABLE_TASK_PROFILER == 1)
+#include "task_profiler.h"
 #else
 #define SEGGER_SYSTEMVIEW_ISR_ENTER()
 #define SEGGER_SYSTEMVIEW_ISR_EXIT()
@@ -58,6 +60,7 @@
 #ifdef OS_FREERTOS
 #include "osal.h"
 #include "sdk_list.h"
+#include "sys_clock_vote_internal.h"
 
 #define XTAL32_AVAILABLE                1       // XTAL32M availability
 #define LP_CLK_AVAILABLE                2       // LP clock availability
@@ -173,6 +176,10 @@ struct clk_mgr_task_list_elem_t {
 
 __RETAINED static void* clk_mgr_task_list;
 
+__RETAINED static clk_vote_table_t clk_votes;
+__RETAINED static sys_clk_t clk_vote_applied;           // Clock applied for the votes, RC32 if none
+__RETAINED static sys_clk_t sys_clk_requested;          // Last non-PLL clock set by the tasks
+
 #endif /* OS_FREERTOS */
 
 #define NUM_OF_CPU_CLK_CONF 5
@@ -851,6 +858,9 @@ void cm_sys_clk_init(sys_clk_t type)
 
         CM_EVENT_WAIT();
         pll_count = (sys_clk_next == sysclk_PLL96) ? 1 : 0;
+#ifdef OS_FREERTOS
+        sys_clk_requested = (sys_clk_next == sysclk_PLL96) ? sysclk_XTAL32M : sys_clk_next;
+#endif
         CM_EVENT_SIGNAL();
 
         CM_LEAVE_CRITICAL_SECTION();
@@ -872,6 +882,29 @@ static void sys_enable_pll(void)
         cm_wait_pll_lock();
 }
 
+/**
+ * \brief Set the system clock, switching to RC32 at the next wake-up
+ *
+ * \details Switching to RC32 is not allowed. If RC32 is requested, the system clock is switched to
+ *          XTAL32M and RC32 will be used as system clock the next time the CPU wakes-up.
+ */
+static cm_sys_clk_set_status_t sys_clk_set_or_defer_rc32(sys_clk_t type)
+{
+        cm_sys_clk_set_status_t ret;
+
+        if (type == sysclk_RC32 && sysclk != sysclk_RC32) {
+                ret = sys_clk_set(sysclk_XTAL32M);
+                if (ret == cm_sysclk_success) {
+                        sysclk = sysclk_RC32;
+                }
+        }
+        else {
+                ret = sys_clk_set(type);
+        }
+
+        return ret;
+}
+
 #ifdef OS_FREERTOS
 bool sys_clk_mgr_match_task(const void *elem, const void *ud)
 {
@@ -882,6 +915,7 @@ bool sys_clk_mgr_match_task(const void *elem, const void *ud)
 cm_sys_clk_set_status_t cm_sys_clk_set(sys_clk_t type)
 {
         cm_sys_clk_set_status_t ret;
+        sys_clk_t set_type = type;
 
         ASSERT_WARNING(type != sysclk_LP);                      // Not Applicable!
 
@@ -913,6 +947,9 @@ cm_sys_clk_set_status_t cm_sys_clk_set(sys_clk_t type)
 
         // Check if system clock can be switched
         if (type != sysclk_PLL96) {
+#ifdef OS_FREERTOS
+                sys_clk_requested = type;
+#endif
                 if (pll_count > 1) {
 #ifdef OS_FREERTOS
                         /* Check if the current task is in the list */
@@ -956,17 +993,13 @@ cm_sys_clk_set_status_t cm_sys_clk_set(sys_clk_t type)
                 pll_wait_lock_count--;
         }
 
-        if (type == sysclk_RC32 && sysclk != sysclk_RC32) {
-                // If RC32 clock is requested, then switch to XTAL32 since switching to RC32 is not allowed.
-                // RC32 will be used as system clock the next time the CPU wakes-up.
-                ret = sys_clk_set(sysclk_XTAL32M);
-                if (ret == cm_sysclk_success) {
-                        sysclk = sysclk_RC32;
-                }
-        }
-        else {
-                ret = sys_clk_set(type);
+#ifdef OS_FREERTOS
+        if (type == sysclk_RC32 && clk_vote_applied == sysclk_XTAL32M) {
+                // RC32 will be used when the votes are withdrawn
+                set_type = sysclk_XTAL32M;
         }
+#endif
+        ret = sys_clk_set_or_defer_rc32(set_type);
 
         if (ret == cm_sysclk_success) {
                 if (type == sysclk_PLL96) {
@@ -1026,6 +1059,155 @@ cm_sys_clk_set_status_t cm_sys_clk_set(sys_clk_t type)
         return ret;
 }
 
+#ifdef OS_FREERTOS
+/**
+ * \brief Apply the aggregate of the votes
+ *
+ * \details The voters count as one task using the PLL in pll_count. When they leave the PLL last,
+ *          the system clock falls back to the clock last requested by cm_sys_clk_set().
+ *
+ * \param[in] limit The highest clock that may be applied, i.e. for which the XTAL32M has settled
+ *                  and the PLL has locked
+ *
+ * \warning It must be called with the clock manager mutex taken.
+ */
+static cm_sys_clk_set_status_t clk_vote_apply(sys_clk_t limit)
+{
+        cm_sys_clk_set_status_t ret = cm_sysclk_success;
+        sys_clk_t target = clk_vote_aggregate(&clk_votes);
+
+        if (target > limit) {
+                target = limit;
+        }
+
+        if (target == clk_vote_applied) {
+                return cm_sysclk_success;
+        }
+
+        if (target == sysclk_PLL96) {
+                if (pll_count == 0) {
+                        ret = sys_clk_set(sysclk_PLL96);
+                }
+                if (ret == cm_sysclk_success) {
+                        pll_count++;
+                }
+        }
+        else if (clk_vote_applied == sysclk_PLL96) {
+                if (pll_count == 1) {
+                        ret = sys_clk_set_or_defer_rc32((target > sys_clk_requested) ?
+                                                        target : sys_clk_requested);
+                }
+                if (ret == cm_sysclk_success) {
+                        pll_count--;
+                        if (pll_count == 0 && pll_wait_lock_count == 0) {
+                                disable_pll();
+                                OS_EVENT_GROUP_CLEAR_BITS(xEventGroupCM_xtal, PLL_AVAILABLE);
+                        }
+                }
+        }
+        else if (pll_count == 0) {
+                ret = sys_clk_set_or_defer_rc32((target > sys_clk_requested) ?
+                                                target : sys_clk_requested);
+        }
+
+        if (ret == cm_sysclk_success) {
+                clk_vote_applied = target;
+        }
+
+        return ret;
+}
+
+cm_sys_clk_voter_t cm_sys_clk_voter_register(void)
+{
+        cm_sys_clk_voter_t voter;
+
+        CM_EVENT_WAIT();
+        voter = clk_vote_register(&clk_votes);
+        CM_EVENT_SIGNAL();
+
+        return voter;
+}
+
+void cm_sys_clk_voter_unregister(cm_sys_clk_voter_t voter)
+{
+        CM_EVENT_WAIT();
+        clk_vote_set(&clk_votes, voter, sysclk_RC32);
+        clk_vote_apply(clk_vote_applied);
+        clk_vote_unregister(&clk_votes, voter);
+        CM_EVENT_SIGNAL();
+}
+
+cm_sys_clk_set_status_t cm_sys_clk_vote(cm_sys_clk_voter_t voter, sys_clk_t clk)
+{
+        cm_sys_clk_set_status_t ret;
+        sys_clk_t previous;
+        sys_clk_t target;
+
+        ASSERT_WARNING(clk != sysclk_LP);                       // Not Applicable!
+
+        if (clk == sysclk_PLL96 && cm_ahb_get_clock_divider() != ahb_div1) {
+                // PLL can be used only when AHB divider is ahb_div1
+                return cm_sysclk_ahb_divider_in_use;
+        }
+
+        CM_EVENT_WAIT();
+        previous = clk_vote_set(&clk_votes, voter, clk);
+        target = clk_vote_aggregate(&clk_votes);
+
+        if (target <= clk_vote_applied) {
+                // Satisfied already, or lowered
+                ret = clk_vote_apply(clk_vote_applied);
+                CM_EVENT_SIGNAL();
+                return ret;
+        }
+
+        if (target == sysclk_PLL96) {
+                pll_wait_lock_count++;
+                if (pll_wait_lock_count == 1) {
+                        enable_pll();
+                }
+        }
+        CM_EVENT_SIGNAL();
+
+        cm_sys_enable_xtalm(target);
+        if (target == sysclk_PLL96) {
+                cm_wait_pll_lock();
+        }
+
+        CM_EVENT_WAIT();
+        if (target == sysclk_PLL96) {
+                pll_wait_lock_count--;
+        }
+
+        // Other voters may have changed the aggregate in the meantime
+        ret = clk_vote_apply(target);
+        if (ret != cm_sysclk_success) {
+                clk_vote_set(&clk_votes, voter, previous);
+        }
+
+        if (target == sysclk_PLL96 && pll_count == 0 && pll_wait_lock_count == 0) {
+                disable_pll();
+                OS_EVENT_GROUP_CLEAR_BITS(xEventGroupCM_xtal, PLL_AVAILABLE);
+        }
+        CM_EVENT_SIGNAL();
+
+        return ret;
+}
+
+cm_sys_clk_set_status_t cm_sys_clk_unvote(cm_sys_clk_voter_t voter)
+{
+        cm_sys_clk_set_status_t ret;
+
+        CM_EVENT_WAIT();
+        clk_vote_set(&clk_votes, voter, sysclk_RC32);
+        // Never raises the clock
+        ret = clk_vote_apply(clk_vote_applied);
+        CM_EVENT_SIGNAL();
+
+        return ret;
+}
+#endif /* OS_FREERTOS */
+
 #define CHECK_PER_DIV1_CLK(val, per) ((val & REG_MSK(CRG_COM, CLK_COM_REG, per ## _ENABLE)) && \
                                       (val & REG_MSK(CRG_COM, CLK_COM_REG, per ## _CLK_SEL)))
 
@@ -0,0 +1,98 @@
+/**
+ ****************************************************************************************
+ *
+ * @file sys_clock_vote.c
+ *
+ * @brief System clock vote table of the clock manager
+ *
+ * Copyright (C) 2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ ****************************************************************************************
+ */
+
+#include "sdk_defs.h"
+
+#if dg_configUSE_CLOCK_MGR
+
+#include "sys_clock_vote_internal.h"
+
+static const sys_clk_t level_clk[CLK_VOTE_LEVELS] = {
+        [CLK_VOTE_NONE]    = sysclk_RC32,
+        [CLK_VOTE_XTAL32M] = sysclk_XTAL32M,
+        [CLK_VOTE_PLL96]   = sysclk_PLL96,
+};
+
+static CLK_VOTE_LEVEL clk_level(sys_clk_t clk)
+{
+        switch (clk) {
+        case sysclk_PLL96:
+                return CLK_VOTE_PLL96;
+        case sysclk_XTAL32M:
+                return CLK_VOTE_XTAL32M;
+        case sysclk_RC32:
+                return CLK_VOTE_NONE;
+        default:
+                ASSERT_WARNING(0);
+                return CLK_VOTE_NONE;
+        }
+}
+
+cm_sys_clk_voter_t clk_vote_register(clk_vote_table_t *table)
+{
+        cm_sys_clk_voter_t voter;
+
+        for (voter = 0; voter < dg_configCM_MAX_SYS_CLK_VOTERS; voter++) {
+                if ((table->in_use & (1UL << voter)) == 0) {
+                        table->in_use |= 1UL << voter;
+                        table->vote[voter] = CLK_VOTE_NONE;
+                        return voter;
+                }
+        }
+
+        return CM_SYS_CLK_VOTER_INVALID;
+}
+
+void clk_vote_unregister(clk_vote_table_t *table, cm_sys_clk_voter_t voter)
+{
+        ASSERT_WARNING(voter < dg_configCM_MAX_SYS_CLK_VOTERS);
+        ASSERT_WARNING(table->in_use & (1UL << voter));
+        ASSERT_WARNING(table->vote[voter] == CLK_VOTE_NONE);
+
+        table->in_use &= ~(1UL << voter);
+}
+
+sys_clk_t clk_vote_set(clk_vote_table_t *table, cm_sys_clk_voter_t voter, sys_clk_t clk)
+{
+        CLK_VOTE_LEVEL previous;
+        CLK_VOTE_LEVEL level = clk_level(clk);
+
+        ASSERT_WARNING(voter < dg_configCM_MAX_SYS_CLK_VOTERS);
+        ASSERT_WARNING(table->in_use & (1UL << voter));
+
+        previous = table->vote[voter];
+        if (previous != CLK_VOTE_NONE) {
+                table->count[previous]--;
+        }
+        if (level != CLK_VOTE_NONE) {
+                table->count[level]++;
+        }
+        table->vote[voter] = level;
+
+        return level_clk[previous];
+}
+
+sys_clk_t clk_vote_aggregate(const clk_vote_table_t *table)
+{
+        if (table->count[CLK_VOTE_PLL96]) {
+                return sysclk_PLL96;
+        }
+        if (table->count[CLK_VOTE_XTAL32M]) {
+                return sysclk_XTAL32M;
+        }
+
+        return sysclk_RC32;
+}
+
+#endif /* dg_configUSE_CLOCK_MGR */
@@ -0,0 +1,104 @@
+/**
+ * \addtogroup BSP
+ * \{
+ * \addtogroup SYSTEM
+ * \{
+ * \addtogroup CLOCK_MANAGER
+ * \{
+ * \addtogroup INTERNAL
+ * \{
+ */
+
+/**
+ ****************************************************************************************
+ *
+ * @file sys_clock_vote_internal.h
+ *
+ * @brief System clock vote table of the clock manager
+ *
+ * Fixed-size table of minimum system clock votes. Voting keeps a count of voters per clock, so
+ * that a vote, its withdrawal and the aggregation to the lowest clock satisfying all voters
+ * take constant time. The table does not touch the hardware, the clock manager applies the
+ * aggregate.
+ *
+ * Copyright (C) 2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ ****************************************************************************************
+ */
+
+#ifndef SYS_CLOCK_VOTE_INTERNAL_H_
+#define SYS_CLOCK_VOTE_INTERNAL_H_
+
+#include <stdint.h>
+#include "sys_clock_mgr.h"
+
+#if (dg_configCM_MAX_SYS_CLK_VOTERS > 32)
+#error dg_configCM_MAX_SYS_CLK_VOTERS cannot be larger than 32.
+#endif
+
+/**
+ * \brief Vote levels, in increasing clock order
+ */
+typedef enum {
+        CLK_VOTE_NONE,                  /**< sysclk_RC32, no requirement */
+        CLK_VOTE_XTAL32M,               /**< sysclk_XTAL32M */
+        CLK_VOTE_PLL96,                 /**< sysclk_PLL96 */
+        CLK_VOTE_LEVELS,
+} CLK_VOTE_LEVEL;
+
+/**
+ * \brief Vote table
+ */
+typedef struct {
+        uint32_t in_use;                                        /**< Registered voters */
+        uint8_t vote[dg_configCM_MAX_SYS_CLK_VOTERS];           /**< CLK_VOTE_LEVEL per voter */
+        uint8_t count[CLK_VOTE_LEVELS];                         /**< Voters per level */
+} clk_vote_table_t;
+
+/**
+ * \brief Register a voter
+ *
+ * \param [in] table the vote table
+ *
+ * \return the voter, CM_SYS_CLK_VOTER_INVALID if the table is full
+ */
+cm_sys_clk_voter_t clk_vote_register(clk_vote_table_t *table);
+
+/**
+ * \brief Unregister a voter, the voter must not hold a vote
+ *
+ * \param [in] table the vote table
+ * \param [in] voter the voter
+ */
+void clk_vote_unregister(clk_vote_table_t *table, cm_sys_clk_voter_t voter);
+
+/**
+ * \brief Replace the vote of a voter
+ *
+ * \param [in] table the vote table
+ * \param [in] voter the voter
+ * \param [in] clk the minimum system clock, sysclk_RC32 withdraws the vote
+ *
+ * \return the previous vote of the voter
+ */
+sys_clk_t clk_vote_set(clk_vote_table_t *table, cm_sys_clk_voter_t voter, sys_clk_t clk);
+
+/**
+ * \brief Get the lowest system clock that satisfies all votes
+ *
+ * \param [in] table the vote table
+ *
+ * \return the highest clock voted for, sysclk_RC32 if there are no votes
+ */
+sys_clk_t clk_vote_aggregate(const clk_vote_table_t *table);
+
+#endif /* SYS_CLOCK_VOTE_INTERNAL_H_ */
+
+/**
+ * \}
+ * \}
+ * \}
+ * \}
+ */
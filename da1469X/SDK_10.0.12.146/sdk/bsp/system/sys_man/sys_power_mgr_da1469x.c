@@ -67,6 +67,27 @@
 #       include "ad_pmu.h"
 #       include "../adapters/src/ad_pmu_internal.h"
 #endif
+#if (dg_configENABLE_TASK_PROFILER == 1)
+#       include "task_profiler.h"
+#endif
+#if (dg_configENABLE_SLEEP_ANALYTICS == 1)
+#       include "sleep_analytics.h"
+#       define SA_PM_ENTER(mode)                        sa_pm_enter(mode)
+#       define SA_PM_STAY_AWAKE(reason, detail)         sa_pm_stay_awake(reason, detail)
+#       define SA_PM_IRQ_PENDING()                      sa_pm_irq_pending()
+#       define SA_PM_WOKEN_UP()                         sa_pm_woken_up()
+#       define SA_PM_RESUMED()                          sa_pm_resumed()
+#       define SA_PM_SYSCLK_READY()                     sa_pm_sysclk_ready()
+#       define SA_PM_EXIT(tick_stopped)                 sa_pm_exit(tick_stopped)
+#else
+#       define SA_PM_ENTER(mode)
+#       define SA_PM_STAY_AWAKE(reason, detail)
+#       define SA_PM_IRQ_PENDING()
+#       define SA_PM_WOKEN_UP()
+#       define SA_PM_RESUMED()
+#       define SA_PM_SYSCLK_READY()
+#       define SA_PM_EXIT(tick_stopped)
+#endif
 
 #define PM_ENABLE_PD_COM_WHILE_ACTIVE           (1)
 #define PM_ENABLE_SLEEP_DIAGNOSTICS             (0)
@@ -222,6 +243,9 @@ static bool adapters_wake_up_ind_called = false;
 static bool call_adapters_xtal16m_ready_ind = false;
 
 static uint64_t sleep_blocked_until = 0;
+#if (dg_configENABLE_SLEEP_ANALYTICS == 1)
+static pm_id_t sleep_blocked_by;                               // Adapter that set sleep_blocked_until
+#endif
 
 #if dg_configENABLE_DEBUGGER
 /* Contains the index of the combo trigger PDC LUT entry */
@@ -674,10 +698,16 @@ void pm_defer_sleep_for(pm_id_t id, uint32_t time_in_LP_cycles)
         if (sleep_is_blocked == false) {
                 sleep_blocked_until = lp_block_time;
                 sleep_is_blocked = true;
+#if (dg_configENABLE_SLEEP_ANALYTICS == 1)
+                sleep_blocked_by = id;
+#endif
         } else {
                 // Update only if the new block time is after the previous one
                 if (sleep_blocked_until < lp_block_time) {
                         sleep_blocked_until = lp_block_time;
+#if (dg_configENABLE_SLEEP_ANALYTICS == 1)
+                        sleep_blocked_by = id;
+#endif
                 }
         }
 }
@@ -880,6 +910,8 @@ static __RETAINED_CODE void system_wake_up(void)
                 sys_timer_get_timestamp_fromCPM(&lp_time2_ret);
 #endif
 
+                SA_PM_RESUMED();
+
                 cm_switch_to_xtalm_if_settled();
 
                 if (wakeup_mode_is_XTAL32) {
@@ -887,6 +919,8 @@ static __RETAINED_CODE void system_wake_up(void)
                         cm_halt_until_sysclk_ready();
                 }
 
+                SA_PM_SYSCLK_READY();
+
 #if (PWR_MGR_DEBUG == 1)
                 sys_timer_get_timestamp_fromCPM(&lp_time3_ret);
 #endif
@@ -963,6 +997,9 @@ __RETAINED_CODE static void apply_wfi(bool allow_entering_sleep, uint32_t sleep_
                 if (allow_entering_sleep) {
                         int i;
                         adapter_call_backs_t *p_Ad;
+
+                        SA_PM_IRQ_PENDING();
+
                         /*
                          * Inform Adapters about the aborted sleep because pm_system_sleeping
                          * will be left to "sys_idle" and the "wake-up" path will not be followed.
@@ -1077,6 +1114,8 @@ __RETAINED_CODE static void apply_wfi(bool allow_entering_sleep, uint32_t sleep_
                          *  current consumption.
                          */
                         hw_sys_reg_apply_config();
+
+                        SA_PM_WOKEN_UP();
                 }
 
 #if dg_configENABLE_DEBUGGER
@@ -1194,24 +1233,35 @@ void pm_sleep_enter(uint32_t low_power_periods)
         low_power_periods_ret = low_power_periods;
  #endif
 
+        SA_PM_ENTER(current_sleep_mode);
+
 #if (dg_configDISABLE_BACKGROUND_FLASH_OPS == 0)
         if (qspi_is_op_pending()) {
                 abort_sleep = true;
+                SA_PM_STAY_AWAKE(SA_AWAKE_FLASH_OP, 0);
         }
 #endif
 
         /* Check that TRNG service is not in the process of generating random numbers */
         if (sys_trng_producing_numbers() != 0) {
                 abort_sleep = true;
+                SA_PM_STAY_AWAKE(SA_AWAKE_TRNG, 0);
         }
 
 #if dg_configENABLE_DEBUGGER
         /* If the debugger is attached then sleep is not allowed */
         if (hw_sys_is_debugger_attached() || !jtag_wkup_delay_has_expired()) {
                 abort_sleep = true;
+                SA_PM_STAY_AWAKE(SA_AWAKE_DEBUGGER, 0);
         }
 #endif /* dg_configENABLE_DEBUGGER */
 
+#if (dg_configENABLE_SLEEP_ANALYTICS == 1)
+        if (current_sleep_mode == pm_mode_active || current_sleep_mode == pm_mode_idle) {
+                sa_pm_stay_awake(SA_AWAKE_MODE, current_sleep_mode);
+        }
+#endif
+
         /*
          * Update Real Time Clock value
          */
@@ -1255,6 +1305,7 @@ void pm_sleep_enter(uint32_t low_power_periods)
                                 if (wdog_period_lp_clks == 0) {
                                         // WDOG will expire soon, abort sleep
                                         allow_entering_sleep = false;
+                                        SA_PM_STAY_AWAKE(SA_AWAKE_WDOG, 0);
                                 } else {
                                         // Limit low_power_periods
                                         if (low_power_periods > 0) {
@@ -1291,6 +1342,7 @@ void pm_sleep_enter(uint32_t low_power_periods)
                                 // We are already late! The tick interrupt may already be pending...
                                 allow_entering_sleep = false;
                                 allow_stopping_tick = false;
+                                SA_PM_STAY_AWAKE(SA_AWAKE_TICK_LATE, 0);
                         }
                         else {
                                 os_sleep_time = low_power_periods - lp_tick_offset;
@@ -1303,6 +1355,7 @@ void pm_sleep_enter(uint32_t low_power_periods)
                                 }
                                 else {
                                         allow_entering_sleep = false;
+                                        SA_PM_STAY_AWAKE(SA_AWAKE_WAKEUP_TIME, wakeup_mode_is_XTAL32);
                                 }
                         }
                         // 1e. Initially, wake-up time is set for the OS case.
@@ -1325,6 +1378,7 @@ void pm_sleep_enter(uint32_t low_power_periods)
                                         if (rtc_offset < dg_configPM_MAX_ADAPTER_DEFER_TIME) {
                                                 // Still valid ==> Block is ON.
                                                 allow_entering_sleep = false;
+                                                SA_PM_STAY_AWAKE(SA_AWAKE_DEFERRED, sleep_blocked_by);
                                                 break;
                                         }
                                         else {
@@ -1345,6 +1399,7 @@ void pm_sleep_enter(uint32_t low_power_periods)
                                                         else {
                                                                 sleep_period = 0;
                                                                 allow_entering_sleep = false;
+                                                                SA_PM_STAY_AWAKE(SA_AWAKE_PREP_TIME, i);
                                                                 break;
                                                         }
                                                 }
@@ -1361,6 +1416,7 @@ void pm_sleep_enter(uint32_t low_power_periods)
                          // 4b. Abort power down if sleep_period is too short!
                          if (sleep_period < dg_configMIN_SLEEP_TIME) {
                                  allow_entering_sleep = false;
+                                 SA_PM_STAY_AWAKE(SA_AWAKE_TOO_SHORT, 0);
                          }
 
                          // 4c. Restore sleep time if power-down is not possible.
@@ -1382,6 +1438,7 @@ void pm_sleep_enter(uint32_t low_power_periods)
                          // 4d. Check if sleep period is too small!
                          if (sleep_period <= (TICK_PERIOD)) {
                                  allow_stopping_tick = false;
+                                 SA_PM_STAY_AWAKE(SA_AWAKE_TOO_SHORT, 0);
                          }
                  }
 
@@ -1477,6 +1534,7 @@ void pm_sleep_enter(uint32_t low_power_periods)
                  if (allow_entering_sleep) {
                          if (hw_dma_channel_active()) {
                                  allow_entering_sleep = false;
+                                 SA_PM_STAY_AWAKE(SA_AWAKE_DMA, 0);
                          }
                  }
 #endif /* dg_configUSE_HW_DMA */
@@ -1502,6 +1560,10 @@ void pm_sleep_enter(uint32_t low_power_periods)
                          // 2. If an Adapter rejected sleep, resume any Adapters that have already accepted it.
                          if (i >= 0) {
                                  allow_entering_sleep = false;   // Sleep has been canceled.
+                                 SA_PM_STAY_AWAKE(SA_AWAKE_VETO, i);
+#if (dg_configENABLE_TASK_PROFILER == 1)
+                                 tp_pm_sleep_vetoed();
+#endif
 
                                  i++;
                                  while (i < dg_configPM_MAX_ADAPTERS_CNT) {
@@ -1553,8 +1615,25 @@ void pm_sleep_enter(uint32_t low_power_periods)
 
          ASSERT_WARNING(__get_PRIMASK() == 1);
 
+#if (dg_configENABLE_TASK_PROFILER == 1)
+         if (abort_sleep || current_sleep_mode == pm_mode_active ||
+                                                        current_sleep_mode == pm_mode_idle) {
+                 tp_pm_event(TP_PM_IDLE_MODE);
+         } else if (!allow_stopping_tick) {
+                 tp_pm_event(TP_PM_IDLE_TICK);
+         } else if (!allow_entering_sleep) {
+                 tp_pm_event(TP_PM_IDLE_BLOCKED);
+         } else if (system_sleeping == sys_powered_down) {
+                 tp_pm_event(TP_PM_SLEEP);
+         } else {
+                 tp_pm_event(TP_PM_SLEEP_ABORTED);
+         }
+#endif
+
          /* Wake-up! */
          system_wake_up();
+
+         SA_PM_EXIT(allow_stopping_tick);
 }
 
 system_state_t pm_get_system_sleep_state(void)
@@ -30,7 +30,9 @@
 
 #ifdef OS_FREERTOS
 #include "sys_timer.h"
+#include "sys_timer_ts_internal.h"
 #include "FreeRTOS.h"
+#include "sys_clock_mgr.h"
 #include "sys_power_mgr.h"
 #include "sys_power_mgr_internal.h"
 #endif
@@ -65,6 +67,7 @@ __RETAINED uint32_t rt_trigger_mon_wr;
 #ifdef OS_FREERTOS
 __RETAINED static uint32_t current_time;
 __RETAINED static uint64_t sys_rtc_time;
+__RETAINED static sys_ts_latch_t ts_latch;
 #endif
 
 
@@ -219,6 +222,12 @@ __RETAINED_CODE uint32_t sys_timer_update_slept_time(void)
 {
         uint32_t trigger;
         uint32_t elapsed_ticks;
+#if (dg_configSYS_TIMER_USE_DWT == 1)
+        const sys_ts_anchor_t no_anchor = { 0 };
+
+        // The CPU cycle counter did not run while sleeping
+        sys_ts_set_anchor(&ts_latch, &no_anchor);
+#endif
         /*
          * Update Real Time Clock value and calculate the time spent sleeping.
          * lp_prescaled_time - lp_last_trigger : sleep time in lp cycles
@@ -328,10 +337,9 @@ uint32_t sys_timer_get_tick_offset(void)
 
 
 #ifdef OS_FREERTOS
-#if (dg_configUSE_LP_CLK == LP_CLK_RCX)
-__RETAINED static uint64_t sys_rtc_clock_time_fine;         // counts time in usec*1024*1024
-__RETAINED static uint64_t sys_rtc_clock_time;         // counts time in usec
-#endif
+
+/* Longest iteration of the LP clock edge detection loop for an accurate anchor */
+#define TS_ANCHOR_MAX_LOOP_CYCLES               ( 256 )
 
 __RETAINED_CODE static void update_timestamp_values(void)
 {
@@ -340,17 +348,14 @@ __RETAINED_CODE static void update_timestamp_values(void)
         current_time = hw_timer_get_count(HW_TIMER2);
         uint64_t rtc_tick = (current_time - prev_time) & LP_CNT_NATIVE_MASK;
 
+        sys_rtc_time += rtc_tick;
+
 #if (dg_configUSE_LP_CLK == LP_CLK_RCX)
-        uint64_t rcx_time_advance = 0;
-        rcx_time_advance = rtc_tick * (uint64_t)cm_get_rcx_clock_period();
-        if ((sys_rtc_clock_time_fine + rcx_time_advance) < sys_rtc_clock_time_fine) {
-                sys_rtc_clock_time +=  (sys_rtc_clock_time_fine >> 20);
-                /* Keep fractional part */
-                sys_rtc_clock_time_fine &= ((1 << 20) - 1);
-        }
-        sys_rtc_clock_time_fine += rcx_time_advance;
+        sys_ts_update(&ts_latch, sys_rtc_time, current_time, cm_get_rcx_clock_period());
+#else
+        sys_ts_update(&ts_latch, sys_rtc_time, current_time,
+                      SYS_TS_USEC_PER_TICK(configSYSTICK_CLOCK_HZ));
 #endif
-        sys_rtc_time += rtc_tick;
 }
 
 uint64_t sys_timer_get_uptime_ticks(void)
@@ -373,30 +378,153 @@ __RETAINED_CODE uint64_t sys_timer_get_uptime_ticks_fromISR(void)
 
 uint64_t sys_timer_get_uptime_usec(void)
 {
+        uint64_t usec;
+
         vPortEnterCritical();
         update_timestamp_values();
+        usec = ts_latch.snap[0].usec;
         vPortExitCritical();
 
-#if (dg_configUSE_LP_CLK == LP_CLK_RCX)
-        return sys_rtc_clock_time + (sys_rtc_clock_time_fine >> 20);
-#else
-        return (sys_rtc_time * 1000000) / configSYSTICK_CLOCK_HZ;
-#endif
+        return usec;
 }
 
 __RETAINED_CODE uint64_t sys_timer_get_uptime_usec_fromISR(void)
 {
+        uint64_t usec;
+
         uint32_t ulPreviousMask = portSET_INTERRUPT_MASK_FROM_ISR();
         update_timestamp_values();
+        usec = ts_latch.snap[0].usec;
         portCLEAR_INTERRUPT_MASK_FROM_ISR( ulPreviousMask );
 
-#if (dg_configUSE_LP_CLK == LP_CLK_RCX)
-        return sys_rtc_clock_time + (sys_rtc_clock_time_fine >> 20);
-#else
-        return (sys_rtc_time * 1000000) / configSYSTICK_CLOCK_HZ;
-#endif
+        return usec;
+}
+
+__STATIC_FORCEINLINE uint32_t ts_read_lp(void)
+{
+        return hw_timer_get_count(HW_TIMER2);
 }
 
+/*
+ * The snapshot is refreshed by every uptime request above and by the power manager. If it is
+ * older than half the timer range, take the locked path once to refresh it.
+ */
+__RETAINED_CODE static void ts_refresh(void)
+{
+        if (in_interrupt()) {
+                sys_timer_get_uptime_ticks_fromISR();
+        } else {
+                sys_timer_get_uptime_ticks();
+        }
+}
+
+__RETAINED_CODE uint64_t sys_timer_get_uptime_ticks_fast(void)
+{
+        sys_ts_snapshot_t snap;
+        uint32_t lp;
+        uint32_t elapsed;
+
+        sys_ts_read(&ts_latch, ts_read_lp, NULL, &snap, &lp, NULL);
+        elapsed = sys_ts_elapsed(&snap, lp, LP_CNT_NATIVE_MASK);
+        if (elapsed > LP_CNT_NATIVE_MASK / 2) {
+                ts_refresh();
+                return sys_timer_get_uptime_ticks_fast();
+        }
+
+        return snap.ticks + elapsed;
+}
+
+__RETAINED_CODE uint64_t sys_timer_get_uptime_usec_fast(void)
+{
+        sys_ts_snapshot_t snap;
+        uint32_t lp;
+        uint32_t elapsed;
+
+        sys_ts_read(&ts_latch, ts_read_lp, NULL, &snap, &lp, NULL);
+        elapsed = sys_ts_elapsed(&snap, lp, LP_CNT_NATIVE_MASK);
+        if (elapsed > LP_CNT_NATIVE_MASK / 2) {
+                ts_refresh();
+                return sys_timer_get_uptime_usec_fast();
+        }
+
+        return sys_ts_usec(&snap, elapsed << SYS_TS_LP_FRAC_BITS);
+}
+
+#if (dg_configSYS_TIMER_USE_DWT == 1)
+__STATIC_FORCEINLINE uint32_t ts_read_cycles(void)
+{
+        return DWT->CYCCNT;
+}
+
+/**
+ * \brief Anchor the CPU cycle counter to an edge of the LP clock
+ *
+ * \details Waits for the next edge of the LP clock, at most one LP cycle if not interrupted.
+ */
+static void ts_anchor(void)
+{
+        sys_ts_anchor_t anchor;
+        uint32_t lp;
+        uint32_t prev_cycles;
+
+        CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+        DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+        anchor.ticks_per_cycle = (uint32_t)(((uint64_t)configSYSTICK_CLOCK_HZ << 32) /
+                                            (cm_cpu_clk_get_fromISR() * 1000000UL));
+
+        lp = ts_read_lp();
+        anchor.cycles = ts_read_cycles();
+        for (;;) {
+                prev_cycles = anchor.cycles;
+                anchor.cycles = ts_read_cycles();
+                anchor.lp = ts_read_lp();
+                if (anchor.lp != lp) {
+                        // The edge is only known precisely if the loop was not interrupted
+                        if (anchor.cycles - prev_cycles < TS_ANCHOR_MAX_LOOP_CYCLES) {
+                                break;
+                        }
+                        lp = anchor.lp;
+                }
+        }
+
+        OS_ENTER_CRITICAL_SECTION();
+        // Readers may have used the previous anchor in this LP cycle only
+        if (ts_read_lp() == anchor.lp) {
+                sys_ts_set_anchor(&ts_latch, &anchor);
+        }
+        OS_LEAVE_CRITICAL_SECTION();
+}
+
+uint64_t sys_timer_get_uptime_usec_hires(void)
+{
+        sys_ts_snapshot_t snap;
+        uint32_t lp;
+        uint32_t cycles;
+        uint32_t elapsed;
+        uint32_t frac;
+        bool drifted;
+
+        sys_ts_read(&ts_latch, ts_read_lp, ts_read_cycles, &snap, &lp, &cycles);
+        elapsed = sys_ts_elapsed(&snap, lp, LP_CNT_NATIVE_MASK);
+        if (elapsed > LP_CNT_NATIVE_MASK / 2) {
+                ts_refresh();
+                return sys_timer_get_uptime_usec_hires();
+        }
+
+        frac = sys_ts_interpolate(&snap.anchor, lp, cycles, LP_CNT_NATIVE_MASK, &drifted);
+        if ((drifted || snap.anchor.ticks_per_cycle == 0) && !in_interrupt()) {
+                ts_anchor();
+        }
+
+        return sys_ts_usec(&snap, (elapsed << SYS_TS_LP_FRAC_BITS) + frac);
+}
+#else
+uint64_t sys_timer_get_uptime_usec_hires(void)
+{
+        return sys_timer_get_uptime_usec_fast();
+}
+#endif /* dg_configSYS_TIMER_USE_DWT */
 
 __RETAINED_CODE uint64_t sys_timer_get_timestamp_fromCPM(uint32_t* timer_value)
 {
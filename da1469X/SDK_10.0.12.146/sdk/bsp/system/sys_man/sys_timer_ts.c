@@ -0,0 +1,96 @@
+/**
+ ****************************************************************************************
+ *
+ * @file sys_timer_ts.c
+ *
+ * @brief Lock-free uptime snapshot of the system timer
+ *
+ * Copyright (C) 2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ ****************************************************************************************
+ */
+
+#include "sdk_defs.h"
+
+#ifdef OS_FREERTOS
+
+#include "sys_timer_ts_internal.h"
+
+#define LP_FRAC_ONE                     (1UL << SYS_TS_LP_FRAC_BITS)
+
+__RETAINED_CODE static void latch_publish(sys_ts_latch_t *latch, const sys_ts_snapshot_t *snap)
+{
+        latch->seq++;
+        __DMB();
+        latch->snap[0] = *snap;
+        __DMB();
+        latch->seq++;
+        __DMB();
+        latch->snap[1] = *snap;
+        __DMB();
+}
+
+__RETAINED_CODE void sys_ts_update(sys_ts_latch_t *latch, uint64_t ticks, uint32_t lp,
+                                   uint32_t usec_per_tick)
+{
+        sys_ts_snapshot_t snap = latch->snap[latch->seq & 1];
+        /* The first update has no previous cycle length */
+        uint32_t elapsed_usec_per_tick = snap.usec_per_tick ? snap.usec_per_tick : usec_per_tick;
+        uint64_t frac;
+
+        frac = snap.usec_frac + (uint64_t)(uint32_t)(ticks - snap.ticks) * elapsed_usec_per_tick;
+        snap.usec += frac >> SYS_TS_USEC_FRAC_BITS;
+        snap.usec_frac = frac & ((1UL << SYS_TS_USEC_FRAC_BITS) - 1);
+        snap.ticks = ticks;
+        snap.lp = lp;
+        snap.usec_per_tick = usec_per_tick;
+
+        latch_publish(latch, &snap);
+}
+
+__RETAINED_CODE void sys_ts_set_anchor(sys_ts_latch_t *latch, const sys_ts_anchor_t *anchor)
+{
+        sys_ts_snapshot_t snap = latch->snap[latch->seq & 1];
+
+        snap.anchor = *anchor;
+
+        latch_publish(latch, &snap);
+}
+
+uint32_t sys_ts_interpolate(const sys_ts_anchor_t *anchor, uint32_t lp, uint32_t cycles,
+                            uint32_t mask, bool *drifted)
+{
+        uint32_t whole;
+        uint64_t start;
+        uint64_t pos;
+
+        *drifted = false;
+
+        if (anchor->ticks_per_cycle == 0) {
+                return 0;
+        }
+
+        whole = (lp - anchor->lp) & mask;
+        if (whole == 0) {
+                return LP_FRAC_ONE - 1;
+        }
+
+        start = (uint64_t)whole << SYS_TS_LP_FRAC_BITS;
+        pos = ((uint64_t)(cycles - anchor->cycles) * anchor->ticks_per_cycle) >>
+                                                                (32 - SYS_TS_LP_FRAC_BITS);
+
+        if (pos < start) {
+                *drifted = (pos + LP_FRAC_ONE < start);
+                return 0;
+        }
+        if (pos >= start + LP_FRAC_ONE) {
+                *drifted = (pos >= start + 2 * LP_FRAC_ONE);
+                return LP_FRAC_ONE - 1;
+        }
+
+        return pos - start;
+}
+
+#endif /* OS_FREERTOS */
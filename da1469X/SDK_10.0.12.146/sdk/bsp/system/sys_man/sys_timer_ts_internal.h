@@ -0,0 +1,204 @@
+/**
+ * \addtogroup BSP
+ * \{
+ * \addtogroup SYSTEM
+ * \{
+ * \addtogroup SYS_TIMER
+ * \{
+ * \addtogroup INTERNAL
+ * \{
+ */
+
+/**
+ ****************************************************************************************
+ *
+ * @file sys_timer_ts_internal.h
+ *
+ * @brief Lock-free uptime snapshot of the system timer
+ *
+ * The system timer publishes the uptime at its last update (in LP cycles and in usec) together
+ * with the timer value it corresponds to. Readers add the timer cycles elapsed since then.
+ *
+ * The snapshot is kept twice, in a latch: the writer updates one copy while readers use the
+ * other, selected by the sequence counter. A reader retries only if an update completed while it
+ * was reading, so a reader interrupting the writer never waits for it. Updates must be serialized
+ * by the caller (interrupts disabled).
+ *
+ * Time in usec is accumulated in 2^-20 usec units, with the LP cycle length given at every update.
+ * For 32768 Hz and 32000 Hz the LP cycle is an exact number of such units, so the conversion is
+ * exact and needs no division.
+ *
+ * Copyright (C) 2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ ****************************************************************************************
+ */
+
+#ifndef SYS_TIMER_TS_INTERNAL_H_
+#define SYS_TIMER_TS_INTERNAL_H_
+
+#ifdef OS_FREERTOS
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "sdk_defs.h"
+
+/**
+ * \brief Fractional bits of the usec accumulator
+ */
+#define SYS_TS_USEC_FRAC_BITS           (20)
+
+/**
+ * \brief Fractional bits of the LP cycle positions interpolated with the CPU cycle counter
+ */
+#define SYS_TS_LP_FRAC_BITS             (8)
+
+/**
+ * \brief Length of an LP cycle of a fixed frequency clock, in 2^-20 usec
+ */
+#define SYS_TS_USEC_PER_TICK(hz)        ((uint32_t)((1000000ULL << SYS_TS_USEC_FRAC_BITS) / (hz)))
+
+/**
+ * \brief Relation between the CPU cycle counter and the LP clock
+ */
+typedef struct {
+        uint32_t lp;                    /**< Timer value right after an edge of the LP clock */
+        uint32_t cycles;                /**< CPU cycle counter at that edge */
+        uint32_t ticks_per_cycle;       /**< LP cycles per CPU cycle, in 2^-32, 0 if unknown */
+} sys_ts_anchor_t;
+
+/**
+ * \brief Uptime at a timer value
+ */
+typedef struct {
+        uint64_t ticks;                 /**< Uptime in LP cycles */
+        uint64_t usec;                  /**< Uptime in usec */
+        uint32_t usec_frac;             /**< Fraction of usec, in 2^-20 usec */
+        uint32_t usec_per_tick;         /**< Length of the LP cycles from here on, in 2^-20 usec */
+        uint32_t lp;                    /**< Timer value */
+        sys_ts_anchor_t anchor;         /**< Cycle counter anchor */
+} sys_ts_snapshot_t;
+
+/**
+ * \brief Latch of two snapshots
+ */
+typedef struct {
+        volatile uint32_t seq;          /**< Even: snap[0] is current, odd: snap[1] */
+        sys_ts_snapshot_t snap[2];
+} sys_ts_latch_t;
+
+/**
+ * \brief Take a snapshot and the timer value together
+ *
+ * \param [in] latch the latch
+ * \param [in] read_lp reads the timer
+ * \param [in] read_cycles reads the CPU cycle counter, can be NULL
+ * \param [out] snap the snapshot
+ * \param [out] lp the timer value
+ * \param [out] cycles the CPU cycle counter, if read_cycles is not NULL
+ */
+__STATIC_FORCEINLINE void sys_ts_read(const sys_ts_latch_t *latch, uint32_t (*read_lp)(void),
+                                      uint32_t (*read_cycles)(void), sys_ts_snapshot_t *snap,
+                                      uint32_t *lp, uint32_t *cycles)
+{
+        uint32_t seq;
+
+        do {
+                seq = latch->seq;
+                __DMB();
+                *snap = latch->snap[seq & 1];
+                *lp = read_lp();
+                if (read_cycles) {
+                        *cycles = read_cycles();
+                }
+                __DMB();
+        } while (seq != latch->seq);
+}
+
+/**
+ * \brief Timer cycles elapsed since a snapshot
+ *
+ * \param [in] snap the snapshot
+ * \param [in] lp the timer value
+ * \param [in] mask the timer value mask
+ *
+ * \return the elapsed cycles, larger than mask / 2 if the snapshot is too old to tell
+ */
+__STATIC_FORCEINLINE uint32_t sys_ts_elapsed(const sys_ts_snapshot_t *snap, uint32_t lp,
+                                             uint32_t mask)
+{
+        return (lp - snap->lp) & mask;
+}
+
+/**
+ * \brief Uptime in usec
+ *
+ * \param [in] snap the snapshot
+ * \param [in] elapsed LP cycles since the snapshot, in 2^-8 cycles
+ *
+ * \return the uptime in usec
+ */
+__STATIC_FORCEINLINE uint64_t sys_ts_usec(const sys_ts_snapshot_t *snap, uint32_t elapsed)
+{
+        uint64_t frac = snap->usec_frac +
+                        (((uint64_t)elapsed * snap->usec_per_tick) >> SYS_TS_LP_FRAC_BITS);
+
+        return snap->usec + (frac >> SYS_TS_USEC_FRAC_BITS);
+}
+
+/**
+ * \brief Publish the uptime at a new timer value
+ *
+ * \details The cycles since the previous snapshot are accounted with the LP cycle length of the
+ *          previous snapshot, \p usec_per_tick applies from \p lp on.
+ *
+ * \param [in] latch the latch
+ * \param [in] ticks the uptime in LP cycles
+ * \param [in] lp the timer value
+ * \param [in] usec_per_tick the LP cycle length, in 2^-20 usec
+ *
+ * \warning It must be called with interrupts disabled.
+ */
+__RETAINED_CODE void sys_ts_update(sys_ts_latch_t *latch, uint64_t ticks, uint32_t lp,
+                                   uint32_t usec_per_tick);
+
+/**
+ * \brief Publish a new cycle counter anchor
+ *
+ * \param [in] latch the latch
+ * \param [in] anchor the anchor, ticks_per_cycle 0 to stop interpolating
+ *
+ * \warning It must be called with interrupts disabled.
+ */
+__RETAINED_CODE void sys_ts_set_anchor(sys_ts_latch_t *latch, const sys_ts_anchor_t *anchor);
+
+/**
+ * \brief Position in the current LP cycle from the CPU cycle counter
+ *
+ * \details The position is kept within the LP cycle the timer is in, so interpolated time never
+ *          leaves the LP cycle it belongs to and stays monotonic as long as the cycle counter
+ *          runs. In the LP cycle of the anchor itself, readers that used the previous anchor may
+ *          already be anywhere in it, so the end of the cycle is returned.
+ *
+ * \param [in] anchor the anchor
+ * \param [in] lp the timer value
+ * \param [in] cycles the CPU cycle counter
+ * \param [in] mask the timer value mask
+ * \param [out] drifted set to true if the anchor is more than an LP cycle off and must be renewed
+ *
+ * \return the position in the LP cycle, in 2^-8 cycles
+ */
+uint32_t sys_ts_interpolate(const sys_ts_anchor_t *anchor, uint32_t lp, uint32_t cycles,
+                            uint32_t mask, bool *drifted);
+
+#endif /* OS_FREERTOS */
+
+#endif /* SYS_TIMER_TS_INTERNAL_H_ */
+
+/**
+ * \}
+ * \}
+ * \}
+ * \}
+ */
@@ -0,0 +1,222 @@
+/**
+ ****************************************************************************************
+ *
+ * @file sdk_ringbuf.h
+ *
+ * @brief Single-producer single-consumer ring buffer
+ *
+ * The ring buffer can be shared between one producer and one consumer running in different
+ * contexts (task and interrupt) without disabling interrupts. The producer only updates the
+ * write index and the consumer only updates the read index. Indexes run in the range
+ * [0, 2 * size) so a full buffer can be told apart from an empty one without wasting a byte.
+ *
+ * Two flavours are provided on top of the same structure, a buffer must only be used with one
+ * of them:
+ * - byte stream: ringbuf_write()/ringbuf_read() copy data in and out, while
+ *   ringbuf_write_reserve()/ringbuf_write_commit() and ringbuf_read_peek()/ringbuf_read_consume()
+ *   give access to the contiguous span at the write or read index, e.g. for DMA,
+ * - messages: ringbuf_msg_reserve()/ringbuf_msg_commit() and ringbuf_msg_peek()/
+ *   ringbuf_msg_consume() handle variable size messages, each stored contiguously and word
+ *   aligned.
+ *
+ * More than one producer (or consumer) must be serialized by the caller.
+ *
+ * Copyright (C) 2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ ****************************************************************************************
+ */
+
+#ifndef SDK_RINGBUF_H_
+#define SDK_RINGBUF_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef struct {
+        uint8_t *buf;                   /**< storage */
+        uint32_t size;                  /**< size of storage in bytes */
+        volatile uint32_t wr;           /**< write index, only updated by the producer */
+        volatile uint32_t rd;           /**< read index, only updated by the consumer */
+} ringbuf_t;
+
+/**
+ * Size in bytes of ring buffer storage holding \p count messages of \p len bytes
+ *
+ * Messages of different length may need padding at the end of storage, so fewer of them fit.
+ */
+#define RINGBUF_MSG_SPACE(len, count)   (((((len) + 3) & ~3) + 4) * (count))
+
+/**
+ * Initialize ring buffer
+ *
+ * For messages \p buf must be word aligned and \p size a multiple of 4.
+ *
+ * \param [in] rb       ring buffer
+ * \param [in] buf      storage
+ * \param [in] size     size of storage in bytes
+ *
+ */
+void ringbuf_init(ringbuf_t *rb, void *buf, uint32_t size);
+
+/**
+ * Get number of bytes stored in ring buffer
+ *
+ * \param [in] rb       ring buffer
+ *
+ * \return number of bytes that can be read
+ *
+ */
+static inline uint32_t ringbuf_used(const ringbuf_t *rb)
+{
+        uint32_t wr = rb->wr;
+        uint32_t rd = rb->rd;
+
+        return wr >= rd ? wr - rd : wr + 2 * rb->size - rd;
+}
+
+/**
+ * Get number of free bytes in ring buffer
+ *
+ * \param [in] rb       ring buffer
+ *
+ * \return number of bytes that can be written
+ *
+ */
+static inline uint32_t ringbuf_free(const ringbuf_t *rb)
+{
+        return rb->size - ringbuf_used(rb);
+}
+
+/**
+ * Check if ring buffer is empty
+ *
+ * \param [in] rb       ring buffer
+ *
+ * \return true if there is nothing to read
+ *
+ */
+static inline bool ringbuf_is_empty(const ringbuf_t *rb)
+{
+        return rb->wr == rb->rd;
+}
+
+/**
+ * Copy data into ring buffer (producer)
+ *
+ * \param [in] rb       ring buffer
+ * \param [in] data     data to write
+ * \param [in] len      number of bytes to write
+ *
+ * \return number of bytes written, less than \p len if there was not enough space
+ *
+ */
+uint32_t ringbuf_write(ringbuf_t *rb, const void *data, uint32_t len);
+
+/**
+ * Copy data out of ring buffer (consumer)
+ *
+ * \param [in] rb       ring buffer
+ * \param [out] data    buffer for the data
+ * \param [in] len      number of bytes to read
+ *
+ * \return number of bytes read, less than \p len if there was not enough data
+ *
+ */
+uint32_t ringbuf_read(ringbuf_t *rb, void *data, uint32_t len);
+
+/**
+ * Get contiguous free space at write index (producer)
+ *
+ * Data written to the returned space becomes visible to the consumer after
+ * ringbuf_write_commit(). Space is contiguous up to the end of storage, remaining free space
+ * (if any) is returned by the next call after commit.
+ *
+ * \param [in] rb       ring buffer
+ * \param [out] ptr     start of free space
+ *
+ * \return number of contiguous free bytes at \p ptr
+ *
+ */
+uint32_t ringbuf_write_reserve(ringbuf_t *rb, void **ptr);
+
+/**
+ * Make data written to reserved space visible to the consumer (producer)
+ *
+ * \param [in] rb       ring buffer
+ * \param [in] len      number of bytes written, not more than returned by ringbuf_write_reserve()
+ *
+ */
+void ringbuf_write_commit(ringbuf_t *rb, uint32_t len);
+
+/**
+ * Get contiguous data at read index (consumer)
+ *
+ * Data stays in ring buffer until ringbuf_read_consume() is called.
+ *
+ * \param [in] rb       ring buffer
+ * \param [out] ptr     start of data
+ *
+ * \return number of contiguous bytes at \p ptr
+ *
+ */
+uint32_t ringbuf_read_peek(ringbuf_t *rb, void **ptr);
+
+/**
+ * Release data read from ring buffer (consumer)
+ *
+ * \param [in] rb       ring buffer
+ * \param [in] len      number of bytes to release, not more than ringbuf_used()
+ *
+ */
+void ringbuf_read_consume(ringbuf_t *rb, uint32_t len);
+
+/**
+ * Reserve space for a message (producer)
+ *
+ * Message becomes visible to the consumer after ringbuf_msg_commit(). Only one message can be
+ * reserved at a time.
+ *
+ * \param [in] rb       ring buffer
+ * \param [in] len      maximum message length in bytes
+ *
+ * \return word aligned space for the message, NULL if there is not enough space
+ *
+ */
+void *ringbuf_msg_reserve(ringbuf_t *rb, uint32_t len);
+
+/**
+ * Make reserved message visible to the consumer (producer)
+ *
+ * \param [in] rb       ring buffer
+ * \param [in] msg      message returned by ringbuf_msg_reserve()
+ * \param [in] len      message length, not more than reserved
+ *
+ */
+void ringbuf_msg_commit(ringbuf_t *rb, void *msg, uint32_t len);
+
+/**
+ * Get oldest message (consumer)
+ *
+ * Message stays in ring buffer until ringbuf_msg_consume() is called.
+ *
+ * \param [in] rb       ring buffer
+ * \param [out] len     message length
+ *
+ * \return message, NULL if ring buffer is empty
+ *
+ */
+void *ringbuf_msg_peek(ringbuf_t *rb, uint32_t *len);
+
+/**
+ * Release oldest message (consumer)
+ *
+ * Must only be called after ringbuf_msg_peek() returned a message.
+ *
+ * \param [in] rb       ring buffer
+ *
+ */
+void ringbuf_msg_consume(ringbuf_t *rb);
+
+#endif /* SDK_RINGBUF_H_ */
@@ -0,0 +1,190 @@
+/**
+ ****************************************************************************************
+ *
+ * @file sdk_ringbuf.c
+ *
+ * @brief Single-producer single-consumer ring buffer
+ *
+ * Copyright (C) 2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ ****************************************************************************************
+ */
+
+#include <string.h>
+#include "sdk_defs.h"
+#include "sdk_ringbuf.h"
+
+/* Header of a message, message data follows */
+#define MSG_HDR_SIZE            (sizeof(uint32_t))
+/* Length of the record filling the end of storage when the next message does not fit there */
+#define MSG_PAD                 (0xFFFFFFFF)
+
+#define MSG_SPACE(len)          (MSG_HDR_SIZE + (((len) + 3) & ~3))
+
+/* Offset in storage of an index */
+static inline uint32_t index_to_offset(const ringbuf_t *rb, uint32_t idx)
+{
+        return idx >= rb->size ? idx - rb->size : idx;
+}
+
+static inline uint32_t index_advance(const ringbuf_t *rb, uint32_t idx, uint32_t len)
+{
+        idx += len;
+
+        return idx >= 2 * rb->size ? idx - 2 * rb->size : idx;
+}
+
+/*
+ * Indexes are published after the data (or the space) they cover has been accessed, so the
+ * other side never sees an index ahead of the memory.
+ */
+static inline void publish_wr(ringbuf_t *rb, uint32_t len)
+{
+        __DMB();
+        rb->wr = index_advance(rb, rb->wr, len);
+}
+
+static inline void publish_rd(ringbuf_t *rb, uint32_t len)
+{
+        __DMB();
+        rb->rd = index_advance(rb, rb->rd, len);
+}
+
+void ringbuf_init(ringbuf_t *rb, void *buf, uint32_t size)
+{
+        rb->buf = buf;
+        rb->size = size;
+        rb->wr = 0;
+        rb->rd = 0;
+}
+
+uint32_t ringbuf_write(ringbuf_t *rb, const void *data, uint32_t len)
+{
+        uint32_t offset = index_to_offset(rb, rb->wr);
+        uint32_t first;
+
+        len = MIN(len, ringbuf_free(rb));
+        first = MIN(len, rb->size - offset);
+
+        memcpy(rb->buf + offset, data, first);
+        memcpy(rb->buf, (const uint8_t *) data + first, len - first);
+
+        publish_wr(rb, len);
+
+        return len;
+}
+
+uint32_t ringbuf_read(ringbuf_t *rb, void *data, uint32_t len)
+{
+        uint32_t offset = index_to_offset(rb, rb->rd);
+        uint32_t first;
+
+        len = MIN(len, ringbuf_used(rb));
+        first = MIN(len, rb->size - offset);
+
+        memcpy(data, rb->buf + offset, first);
+        memcpy((uint8_t *) data + first, rb->buf, len - first);
+
+        publish_rd(rb, len);
+
+        return len;
+}
+
+uint32_t ringbuf_write_reserve(ringbuf_t *rb, void **ptr)
+{
+        uint32_t offset = index_to_offset(rb, rb->wr);
+
+        *ptr = rb->buf + offset;
+
+        return MIN(ringbuf_free(rb), rb->size - offset);
+}
+
+void ringbuf_write_commit(ringbuf_t *rb, uint32_t len)
+{
+        publish_wr(rb, len);
+}
+
+uint32_t ringbuf_read_peek(ringbuf_t *rb, void **ptr)
+{
+        uint32_t offset = index_to_offset(rb, rb->rd);
+
+        *ptr = rb->buf + offset;
+
+        return MIN(ringbuf_used(rb), rb->size - offset);
+}
+
+void ringbuf_read_consume(ringbuf_t *rb, uint32_t len)
+{
+        publish_rd(rb, len);
+}
+
+void *ringbuf_msg_reserve(ringbuf_t *rb, uint32_t len)
+{
+        uint32_t offset = index_to_offset(rb, rb->wr);
+        uint32_t space = MSG_SPACE(len);
+        uint32_t free = ringbuf_free(rb);
+
+        if (rb->size - offset >= space) {
+                return free >= space ? rb->buf + offset + MSG_HDR_SIZE : NULL;
+        }
+
+        /* Message goes to the start of storage, the end is skipped */
+        if (free >= rb->size - offset + space) {
+                return rb->buf + MSG_HDR_SIZE;
+        }
+
+        return NULL;
+}
+
+void ringbuf_msg_commit(ringbuf_t *rb, void *msg, uint32_t len)
+{
+        uint8_t *hdr = (uint8_t *) msg - MSG_HDR_SIZE;
+        uint32_t offset = index_to_offset(rb, rb->wr);
+        uint32_t space = MSG_SPACE(len);
+
+        *(uint32_t *) hdr = len;
+
+        if (hdr != rb->buf + offset) {
+                /*
+                 * Message was reserved at the start of storage, skip the end. The padding and the
+                 * message are published together, the reader expects a message after padding.
+                 */
+                *(uint32_t *) (rb->buf + offset) = MSG_PAD;
+                space += rb->size - offset;
+        }
+
+        publish_wr(rb, space);
+}
+
+void *ringbuf_msg_peek(ringbuf_t *rb, uint32_t *len)
+{
+        uint32_t offset;
+        uint32_t hdr;
+
+        if (ringbuf_is_empty(rb)) {
+                return NULL;
+        }
+
+        offset = index_to_offset(rb, rb->rd);
+        hdr = *(uint32_t *) (rb->buf + offset);
+
+        if (hdr == MSG_PAD) {
+                /* Padding is always followed by a message */
+                publish_rd(rb, rb->size - offset);
+                offset = 0;
+                hdr = *(uint32_t *) rb->buf;
+        }
+
+        *len = hdr;
+
+        return rb->buf + offset + MSG_HDR_SIZE;
+}
+
+void ringbuf_msg_consume(ringbuf_t *rb)
+{
+        uint32_t len = *(uint32_t *) (rb->buf + index_to_offset(rb, rb->rd));
+
+        publish_rd(rb, MSG_SPACE(len));
+}
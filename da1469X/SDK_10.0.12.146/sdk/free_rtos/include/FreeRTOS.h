@@ -78,6 +78,8 @@ extern "C" {
 
 #if (dg_configSYSTEMVIEW == 1)
 #include "SEGGER_SYSVIEW_FreeRTOS.h"
+#elif (dg_configENABLE_TASK_PROFILER == 1)
+#include "task_profiler.h"
 #endif /* (dg_configSYSTEMVIEW == 1) */
 
 #ifndef configMINIMAL_STACK_SIZE
@@ -29,6 +29,11 @@
 #ifndef FREERTOS_CONFIG_H
 #define FREERTOS_CONFIG_H
 
+#if defined(OS_FREERTOS_POSIX)
+/* Host build on top of the POSIX port, see utilities/host_bench */
+#include "FreeRTOSConfig_posix.h"
+#else
+
 /*-----------------------------------------------------------
  * Application specific definitions.
  *
@@ -89,6 +94,13 @@ extern uint32_t SystemCoreClock;
                 while (FreeRTOSDebugConfig[0] != FREERTOS_DEBUG_CONFIG_MAJOR_VERSION); \
         } while(0);
 
+#define configGENERATE_RUN_TIME_STATS           1
+extern unsigned long vGetRunTimeCounterValue(void);
+#define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS() {}
+#define portGET_RUN_TIME_COUNTER_VALUE() vGetRunTimeCounterValue()
+#elif (dg_configENABLE_TASK_PROFILER == 1)
+#define configUSE_TRACE_FACILITY                1
+#define configINCLUDE_FREERTOS_TASK_C_ADDITIONS_H 0
 #define configGENERATE_RUN_TIME_STATS           1
 extern unsigned long vGetRunTimeCounterValue(void);
 #define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS() {}
@@ -197,5 +209,7 @@ See http://www.FreeRTOS.org/RTOS-Cortex-M3-M4.html. */
 #define configMAX_SYSCALL_INTERRUPT_PRIORITY    (configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY<<(8-configPRIO_BITS))
 
 
+#endif /* OS_FREERTOS_POSIX */
+
 #endif /* FREERTOS_CONFIG_H */
 
@@ -75,6 +75,8 @@
 
 #if (dg_configSYSTEMVIEW)
 #  include "SEGGER_SYSVIEW_FreeRTOS.h"
+#elif (dg_configENABLE_TASK_PROFILER == 1)
+#  include "task_profiler.h"
 #else
 #  define SEGGER_SYSTEMVIEW_BLE_ISR_ENTER()
 #  define SEGGER_SYSTEMVIEW_BLE_ISR_EXIT()
@@ -667,6 +669,10 @@ void ad_ble_init(void)
 
         OS_QUEUE_CREATE(adapter_if.cmd_q, sizeof(ble_mgr_common_stack_msg_t *), AD_BLE_COMMAND_QUEUE_LENGTH);
         OS_QUEUE_CREATE(adapter_if.evt_q, sizeof(ble_mgr_common_stack_msg_t *), AD_BLE_EVENT_QUEUE_LENGTH);
+#if (dg_configENABLE_TASK_PROFILER == 1)
+        task_profiler_register_queue(adapter_if.cmd_q, "ad_ble_cmd");
+        task_profiler_register_queue(adapter_if.evt_q, "ad_ble_evt");
+#endif
 
         OS_ASSERT(adapter_if.cmd_q);
         OS_ASSERT(adapter_if.evt_q);
@@ -700,7 +706,7 @@ static void ad_ble_handle_stack_msg(ble_mgr_common_stack_msg_t *msg)
 {
 #if (dg_configBLE_ADV_STOP_DELAY_ENABLE == 1)
         if (waiting_for_evt) {
-                struct delayed_msg *d_msg = OS_MALLOC(sizeof(*d_msg));
+                struct delayed_msg *d_msg = OS_POOL_MALLOC(sizeof(*d_msg));
 
                 d_msg->msg = msg;
 
@@ -709,7 +715,7 @@ static void ad_ble_handle_stack_msg(ble_mgr_common_stack_msg_t *msg)
         }
         else if (advertising && (msg->msg_type == GTL_MSG)
                 && (msg->msg.gtl.msg_id == GAPM_CANCEL_CMD)) {
-                struct delayed_msg *d_msg = OS_MALLOC(sizeof(*d_msg));
+                struct delayed_msg *d_msg = OS_POOL_MALLOC(sizeof(*d_msg));
 
                 d_msg->msg = msg;
 
@@ -982,7 +988,7 @@ void ad_ble_stack_write(uint8_t* bufPtr, uint32_t size, void (*callback) (uint8_
                         }
 
                         // Allocate the space needed for the message
-                        msgBuf = OS_MALLOC(sizeof(ble_mgr_common_stack_msg_t) + param_length);
+                        msgBuf = OS_POOL_MALLOC(sizeof(ble_mgr_common_stack_msg_t) + param_length);
 
                         msgBuf->hdr.op_code = BLE_MGR_COMMON_STACK_MSG;     // fill message OP code
                         msgBuf->msg_type = *pxMsgPacked++;                  // fill stack message type
@@ -408,11 +408,17 @@ void ble_mgr_init(void)
         /* Create BLE manager queues */
         OS_QUEUE_CREATE(mgr_if.cmd_q, sizeof(ble_evt_hdr_t *), BLE_MGR_COMMAND_QUEUE_LENGTH);
         OS_ASSERT(mgr_if.cmd_q);
+#if (dg_configENABLE_TASK_PROFILER == 1)
+        task_profiler_register_queue(mgr_if.cmd_q, "ble_mgr_cmd");
+#endif
 #endif /* ((BLE_MGR_DIRECT_ACCESS == 0) || (defined(BLE_STACK_PASSTHROUGH_MODE))) */
 
 #if (BLE_MGR_USE_EVT_LIST == 0)
         OS_QUEUE_CREATE(mgr_if.evt_q, sizeof(ble_evt_hdr_t *), BLE_MGR_EVENT_QUEUE_LENGTH);
         OS_ASSERT(mgr_if.evt_q);
+#if (dg_configENABLE_TASK_PROFILER == 1)
+        task_profiler_register_queue(mgr_if.evt_q, "ble_mgr_evt");
+#endif
 #endif /* (BLE_MGR_USE_EVT_LIST == 0) */
 
         OS_QUEUE_CREATE(mgr_if.rsp_q, sizeof(ble_evt_hdr_t *), BLE_MGR_RESPONSE_QUEUE_LENGTH);
@@ -14,6 +14,10 @@
  * the \link AES_HASH AES hash engine documentation \endlink and in the ECC engine
  * documentation.
  *
+ * When AD_CRYPTO_CFG_JOB_QUEUE is enabled, operations can also be submitted asynchronously as
+ * jobs with ad_crypto_submit_job(). The adapter executes them back-to-back and calls their
+ * completion callback, without blocking the submitting task.
+ *
  * Example of SHA256 of a buffer:
  * \code{.c}
  * while (ad_crypto_acquire_aes_hash(10) != OS_MUTEX_TAKEN) {
@@ -151,10 +155,59 @@
 #define AD_CRYPTO_SHARED_ECC_RAM_SIZE   (1024)
 #endif
 
+/**
+ * \brief Enable the asynchronous job queue
+ *
+ * When enabled, the adapter creates a task that executes AES, HASH and ECC jobs submitted with
+ * ad_crypto_submit_job() back-to-back and notifies their completion through a callback.
+ *
+ * \note The job task is an additional user of the engines. If other tasks use the blocking
+ *       acquire/release API as well, AD_CRYPTO_CFG_ONE_AES_HASH_USER and/or
+ *       AD_CRYPTO_CFG_ONE_ECC_USER must be set to 0.
+ */
+#ifndef AD_CRYPTO_CFG_JOB_QUEUE
+#define AD_CRYPTO_CFG_JOB_QUEUE         (0)
+#endif
+
+/**
+ * \brief Default chunk size of AES/HASH jobs in bytes
+ *
+ * AES and HASH jobs are fed to the engine in chunks of this size. The next chunk is programmed
+ * from the AES/HASH interrupt, without involving the job task. It must be a multiple of 16.
+ */
+#ifndef AD_CRYPTO_CFG_JOB_CHUNK_SIZE
+#define AD_CRYPTO_CFG_JOB_CHUNK_SIZE    (2048)
+#endif
+
+/**
+ * \brief Priority of the job task
+ */
+#ifndef AD_CRYPTO_CFG_JOB_TASK_PRIORITY
+#define AD_CRYPTO_CFG_JOB_TASK_PRIORITY (OS_TASK_PRIORITY_NORMAL)
+#endif
+
+/**
+ * \brief Stack size of the job task in bytes
+ *
+ * Job completion callbacks and ECC operations run on this stack.
+ */
+#ifndef AD_CRYPTO_CFG_JOB_TASK_STACK_SIZE
+#define AD_CRYPTO_CFG_JOB_TASK_STACK_SIZE (256 * OS_STACK_WORD_SIZE)
+#endif
+
 /**
  * \}
  */
 
+#if (AD_CRYPTO_CFG_JOB_QUEUE == 1)
+#if dg_configUSE_HW_AES
+#include "hw_aes.h"
+#endif
+#if dg_configUSE_HW_HASH
+#include "hw_hash.h"
+#endif
+#endif /* AD_CRYPTO_CFG_JOB_QUEUE */
+
 #if dg_configUSE_HW_ECC
 
 /**
@@ -378,6 +431,144 @@ OS_BASE_TYPE ad_crypto_release_ecc(void);
 
 #endif /* dg_configUSE_HW_ECC */
 
+#if (AD_CRYPTO_CFG_JOB_QUEUE == 1)
+
+/**
+ * \brief Crypto job type
+ */
+typedef enum {
+        AD_CRYPTO_JOB_AES = 0,          /**< AES operation, requires dg_configUSE_HW_AES */
+        AD_CRYPTO_JOB_HASH = 1,         /**< HASH operation, requires dg_configUSE_HW_HASH */
+        AD_CRYPTO_JOB_ECC = 2,          /**< ECC operation, requires dg_configUSE_HW_ECC */
+} AD_CRYPTO_JOB_TYPE;
+
+/**
+ * \brief Crypto job completion status
+ *
+ * ECC jobs complete with the value returned by their operation.
+ */
+typedef enum {
+        AD_CRYPTO_JOB_ERROR_CONFIG = -1,        /**< The engine rejected the job configuration */
+        AD_CRYPTO_JOB_OK = 0,                   /**< The job completed */
+} AD_CRYPTO_JOB_STATUS;
+
+typedef struct ad_crypto_job ad_crypto_job_t;
+
+/**
+ * \brief Crypto job completion callback
+ *
+ * Called from the job task context, so it may use the OS API and submit further jobs.
+ *
+ * \param [in] job    The completed job
+ * \param [in] status AD_CRYPTO_JOB_OK, a negative AD_CRYPTO_JOB_STATUS or the return value of
+ *                    the ECC operation
+ */
+typedef void (*ad_crypto_job_cb)(ad_crypto_job_t *job, int status);
+
+/**
+ * \brief ECC job operation
+ *
+ * Called from the job task context with the ECC engine acquired, configured and its event
+ * signaling enabled. The operation programs the engine with the low level driver API and waits
+ * for it with ad_crypto_wait_ecc_event(). It must not release the engine or disable the event.
+ *
+ * \param [in] job The job being executed
+ *
+ * \return The completion status passed to the job callback
+ */
+typedef int (*ad_crypto_ecc_op)(ad_crypto_job_t *job);
+
+/**
+ * \brief Crypto job
+ *
+ * The job is owned by the adapter from ad_crypto_submit_job() until its callback is called,
+ * and must not be modified or freed in the meantime.
+ */
+struct ad_crypto_job {
+        AD_CRYPTO_JOB_TYPE      type;           /**< Job type, selects the member of cfg */
+        union {
+#if dg_configUSE_HW_AES
+                hw_aes_config_t aes;            /**< AES configuration. input_data_len is the
+                                                     total length of the job. The callback and
+                                                     wait_more_input fields are ignored. */
+#endif
+#if dg_configUSE_HW_HASH
+                hw_hash_config_t hash;          /**< HASH configuration. input_data_len is the
+                                                     total length of the job. The callback and
+                                                     wait_more_input fields are ignored. */
+#endif
+#if dg_configUSE_HW_ECC
+                ad_crypto_ecc_op ecc_op;        /**< ECC operation */
+#endif
+                uint32_t        reserved;
+        } cfg;
+        uint32_t                chunk_size;     /**< AES/HASH chunk size in bytes, a multiple of
+                                                     16 for AES and 8 for HASH. 0 selects
+                                                     AD_CRYPTO_CFG_JOB_CHUNK_SIZE. */
+        ad_crypto_job_cb        cb;             /**< Completion callback, may be NULL */
+        void                    *user_data;     /**< Free for the caller */
+
+        /* Adapter private */
+        ad_crypto_job_t         *next;
+        uint32_t                fed;
+};
+
+/**
+ * \brief Submit a crypto job
+ *
+ * The job is appended to the job queue and returns immediately. Jobs are executed in
+ * submission order by the adapter job task, which keeps the engines acquired, clocked and the
+ * system awake only while jobs are queued. AES and HASH jobs larger than their chunk size are
+ * streamed to the engine chunk by chunk from the AES/HASH interrupt.
+ *
+ * Example of an asynchronous AES-CTR encryption:
+ * \code{.c}
+ * static void aes_done(ad_crypto_job_t *job, int status)
+ * {
+ *         OS_TASK_NOTIFY(app_task, AES_DONE_NOTIF, OS_NOTIFY_SET_BITS);
+ * }
+ *
+ * job.type = AD_CRYPTO_JOB_AES;
+ * job.cfg.aes.mode = HW_AES_MODE_CTR;
+ * job.cfg.aes.operation = HW_AES_OPERATION_ENCRYPT;
+ * job.cfg.aes.key_size = HW_AES_KEY_SIZE_128;
+ * job.cfg.aes.key_expand = HW_AES_KEY_EXPAND_BY_HW;
+ * job.cfg.aes.output_data_mode = HW_AES_OUTPUT_DATA_MODE_ALL;
+ * job.cfg.aes.iv_cnt_ptr = counter;
+ * job.cfg.aes.keys_addr = (uint32_t)key;
+ * job.cfg.aes.input_data_addr = (uint32_t)plain;
+ * job.cfg.aes.output_data_addr = (uint32_t)cipher;
+ * job.cfg.aes.input_data_len = sizeof(plain);
+ * job.chunk_size = 0;
+ * job.cb = aes_done;
+ * ad_crypto_submit_job(&job);
+ * \endcode
+ *
+ * \param [in] job The job to submit
+ *
+ * \return true if the job was queued, false if its type is not supported in this configuration
+ *         or its chunk size is invalid
+ *
+ * \note This function must be called from task context.
+ *
+ * \sa ad_crypto_cancel_job()
+ */
+bool ad_crypto_submit_job(ad_crypto_job_t *job);
+
+/**
+ * \brief Cancel a queued crypto job
+ *
+ * Removes a job that has not been started yet from the job queue. The job callback is not
+ * called.
+ *
+ * \param [in] job The job to cancel
+ *
+ * \return true if the job was removed, false if it is running or has already completed
+ */
+bool ad_crypto_cancel_job(ad_crypto_job_t *job);
+
+#endif /* AD_CRYPTO_CFG_JOB_QUEUE */
+
 #endif /* AD_CRYPTO_H_ */
 
 #endif /* dg_configCRYPTO_ADAPTER */
@@ -32,6 +32,13 @@
 #include "hw_gpio.h"
 #include "osal.h"
 #include "resmgmt.h"
+#if dg_configGPADC_STREAM
+#include "hw_dma.h"
+#endif
+
+#if dg_configGPADC_STREAM && (dg_configUSE_HW_DMA == 0)
+#error "dg_configGPADC_STREAM requires dg_configUSE_HW_DMA"
+#endif
 
 #ifdef __cplusplus
 extern "C" {
@@ -211,6 +218,74 @@ int ad_gpadc_read_raw_to(ad_gpadc_handle_t handle, uint16_t *value, uint32_t tim
  */
 int ad_gpadc_read_async(ad_gpadc_handle_t handle, ad_gpadc_user_cb read_async_cb, void *user_data);
 
+#if dg_configGPADC_STREAM
+/**
+ * \brief Stream callback
+ *
+ * Called from DMA interrupt context every time a half of the stream buffer is filled.
+ *
+ * \param [in] user_data   user data passed in the stream configuration
+ * \param [in] samples     raw (left aligned) samples, averaged when decimation is enabled
+ * \param [in] count       number of samples
+ *
+ * \note The samples are valid until the DMA wraps around to the same half of the buffer, i.e. for
+ * ad_gpadc_stream_conf_t::block_len conversions.
+ */
+typedef void (*ad_gpadc_stream_cb)(void *user_data, const uint16_t *samples, uint16_t count);
+
+/**
+ * \brief Stream configuration
+ *
+ * The conversion rate is set by the driver configuration: the sample time, oversampling and
+ * chopping set the conversion time and gpadc_config::interval the pause between conversions
+ * (0 for back to back conversions). When both ADCs stream at the same time they must use the two
+ * channels of the same DMA channel pair, since they share the DMA trigger.
+ */
+typedef struct {
+        HW_DMA_CHANNEL          dma_channel;    /**< DMA channel, must be even (0, 2, 4 or 6) */
+        HW_DMA_PRIO             dma_prio;       /**< DMA channel priority */
+        uint16_t                *buffer;        /**< Buffer of 2 * block_len conversion results */
+        uint16_t                block_len;      /**< Conversion results per half buffer */
+        uint8_t                 decimation;     /**< Conversion results averaged per sample, must
+                                                     divide block_len, 0 or 1 disables averaging */
+        ad_gpadc_stream_cb      cb;             /**< Callback per filled half buffer */
+        void                    *user_data;     /**< User data passed to cb */
+} ad_gpadc_stream_conf_t;
+
+/**
+ * \brief Start continuous sampling to a DMA double buffer
+ *
+ * The GPADC runs in continuous mode and the DMA stores every conversion result in \p conf->buffer,
+ * wrapping around at its end. Each time a half of the buffer is filled \p conf->cb is called with
+ * that half, optionally averaged by \p conf->decimation, while the DMA fills the other half.
+ * No task runs per sample.
+ *
+ * The GPADC and the DMA channel stay acquired and the system does not enter sleep until
+ * ad_gpadc_stream_stop(), other reads of the GPADC fail or block meanwhile. The DMA and the ADC
+ * keep running while the CPU idles.
+ *
+ * \param [in] handle  handle returned from ad_gpadc_open()
+ * \param [in] conf    stream configuration, copied
+ *
+ * \return 0 on success, <0: error
+ *
+ * \sa ad_gpadc_stream_stop()
+ */
+int ad_gpadc_stream_start(ad_gpadc_handle_t handle, const ad_gpadc_stream_conf_t *conf);
+
+/**
+ * \brief Stop continuous sampling
+ *
+ * Stops the conversions and the DMA, no callback is called after this function returns. Must be
+ * called from the task that started the stream.
+ *
+ * \param [in] handle  handle returned from ad_gpadc_open()
+ *
+ * \return 0 on success, <0: error
+ */
+int ad_gpadc_stream_stop(ad_gpadc_handle_t handle);
+#endif /* dg_configGPADC_STREAM */
+
 /**
  * \brief Return maximum value that can be read for ADC source
  *
@@ -300,7 +375,7 @@ int ad_gpadc_io_config (const HW_GPADC_ID id, const ad_gpadc_io_conf_t *io, AD_I
  * - Releases the controller resources
  *
  * \param [in] p        pointer returned from ad_gpadc_open()
- * \param [in] force    force close even if an async read is pending
+ * \param [in] force    force close even if an async read is pending or a stream is running
  *
 * \return 0: success, <0: error code
  */
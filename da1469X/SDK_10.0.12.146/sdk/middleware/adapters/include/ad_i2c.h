@@ -67,6 +67,18 @@ extern "C" {
 # define CONFIG_I2C_USE_ASYNC_TRANSACTIONS	  (1)
 #endif
 
+/**
+ * \def CONFIG_I2C_USE_TRANSACTION_LIST
+ *
+ * \brief Controls whether I2C transaction list API will be used
+ *
+ * I2C transaction list API (see ad_i2c_transact()) keeps the state of the list being executed
+ * for every I2C bus declared. If the API is not to be used, setting this macro to 0 will save RAM.
+ */
+#ifndef CONFIG_I2C_USE_TRANSACTION_LIST
+# define CONFIG_I2C_USE_TRANSACTION_LIST          (1)
+#endif
+
 #ifndef I2C_DEFAULT_CLK_CFG
         #define I2C_DEFAULT_CLK_CFG .i2c.clock_cfg = { 0, 0, 0, 0, 0, 0 }
 #endif
@@ -439,6 +451,99 @@ int ad_i2c_write_read_async(ad_i2c_handle_t p, const uint8_t *wbuf, size_t wlen,
 
 #endif /* CONFIG_I2C_USE_ASYNC_TRANSACTIONS */
 
+#if CONFIG_I2C_USE_TRANSACTION_LIST
+
+/**
+ * \brief Action of I2C transaction list
+ */
+typedef enum {
+        AD_I2C_ACTION_SEND,             /**< Send data */
+        AD_I2C_ACTION_RECEIVE,          /**< Receive data */
+        AD_I2C_ACTION_DELAY,            /**< Busy wait */
+} AD_I2C_ACTION;
+
+/**
+ * \brief Element of I2C transaction list
+ *
+ * Use the AD_I2C_SND(), AD_I2C_RCV() and AD_I2C_DELAY() macros to initialize elements.
+ */
+typedef struct {
+        AD_I2C_ACTION action;   /**< Action to take */
+        uint8_t flags;          /**< Condition flags of the transfer, as in ad_i2c_write() */
+        uint16_t len;           /**< Number of bytes to transfer, microseconds for AD_I2C_ACTION_DELAY */
+        const uint8_t *wbuf;    /**< Data to send */
+        uint8_t *rbuf;          /**< Buffer for incoming data */
+} ad_i2c_transaction_t;
+
+/*
+ * The following macros are used to construct I2C transaction lists.
+ */
+#define AD_I2C_SND(_wbuf, _len, _flags) { .action = AD_I2C_ACTION_SEND, .flags = (_flags), \
+                                          .len = (_len), .wbuf = (_wbuf) }
+#define AD_I2C_RCV(_rbuf, _len, _flags) { .action = AD_I2C_ACTION_RECEIVE, .flags = (_flags), \
+                                          .len = (_len), .rbuf = (_rbuf) }
+#define AD_I2C_DELAY(_usec)             { .action = AD_I2C_ACTION_DELAY, .len = (_usec) }
+
+/**
+ * \brief Perform a blocking transaction list
+ *
+ * Transfers of the list are executed back to back. The next transfer is started from the
+ * completion interrupt of the previous one, so the caller task is woken up only once, after the
+ * whole list is over or a transfer failed. Typical use is reading a sensor FIFO and some
+ * registers in one call:
+ *
+ * \code{.c}
+ * const ad_i2c_transaction_t list[] = {
+ *         AD_I2C_SND(&fifo_reg, 1, HW_I2C_F_NONE),
+ *         AD_I2C_RCV(fifo, sizeof(fifo), HW_I2C_F_ADD_RESTART | HW_I2C_F_ADD_STOP),
+ *         AD_I2C_SND(&status_reg, 1, HW_I2C_F_NONE),
+ *         AD_I2C_RCV(&status, 1, HW_I2C_F_ADD_RESTART | HW_I2C_F_ADD_STOP),
+ * };
+ *
+ * ad_i2c_transact(handle, list, ARRAY_LENGTH(list));
+ * \endcode
+ *
+ * A send without STOP completes when the data are in the controller FIFO, so the following
+ * transfer is queued without the bus going idle. The last transfer of the list should have the
+ * HW_I2C_F_ADD_STOP flag.
+ *
+ * \param [in] p     handle returned from ad_i2c_open()
+ * \param [in] list  actions to execute
+ * \param [in] count number of actions in \p list
+ *
+ * \return 0 on success, <0: error, value from HW_I2C_ABORT_SOURCE enum on transfer failure
+ *
+ * \sa ad_i2c_open()
+ *
+ * \note Transfer lengths must be non zero. Delays are busy waits, executed in interrupt context
+ * when they follow a transfer, so they should be short.
+ */
+int ad_i2c_transact(ad_i2c_handle_t p, const ad_i2c_transaction_t *list, size_t count);
+
+/**
+ * \brief Perform a non blocking transaction list
+ *
+ * Same as ad_i2c_transact() but returns as soon as the first transfer has been started.
+ * Callback will be called when the whole list is over or a transfer failed, the remaining
+ * actions are skipped in that case.
+ *
+ * \param [in] p         handle returned from ad_i2c_open()
+ * \param [in] list      actions to execute, must stay valid until \p cb is called
+ * \param [in] count     number of actions in \p list
+ * \param [in] cb        callback to call after the list is over (from ISR context, or from the
+ *                       calling task if \p list contains no transfer)
+ * \param [in] user_data user data passed to cb callback
+ *
+ * \return 0 on success, <0: error
+ *
+ * \sa ad_i2c_open()
+ *
+ */
+int ad_i2c_transact_async(ad_i2c_handle_t p, const ad_i2c_transaction_t *list, size_t count,
+                          ad_i2c_user_cb cb, void *user_data);
+
+#endif /* CONFIG_I2C_USE_TRANSACTION_LIST */
+
 #if dg_configI2C_ADAPTER_SLAVE_SUPPORT
 
 typedef void (* ad_i2c_slave_event)(ad_i2c_handle_t p, void *user_data);
@@ -428,6 +428,56 @@ int ad_lcdc_draw_screen(ad_lcdc_handle_t handle, const hw_lcdc_layer_t *layer,
 int ad_lcdc_draw_screen_async(ad_lcdc_handle_t handle, const hw_lcdc_layer_t *layer,
         ad_lcdc_user_cb cb, void *user_data);
 
+/**
+ * \brief Update a set of screen regions with the layer parameters
+ *
+ * Each region is sent as a partial update of the screen. If tearing effect is enabled, the
+ * transfer waits once for the TE signal and then sends all regions back-to-back from the LCDC
+ * interrupt. When the transfer is over, the update region set with
+ * \ref ad_lcdc_set_partial_update() is restored.
+ *
+ * This function is blocking. It may wait first for device access, then it waits until transaction
+ * is completed. It has a timeout parameter to guard the transaction completion and not the
+ * acquisition of the device.
+ *
+ * \param [in] handle           Handle returned from ad_lcdc_open()
+ * \param [in] layer            Layer structure containing all layer information, normally
+ *                              covering the whole screen
+ * \param [in] regions          Screen regions to update
+ * \param [in] count            Number of entries in \p regions
+ * \param [in] timeout          Timeout of the transaction
+ *
+ * \warning The LCD must support the partial update of the corresponding dimensions.
+ *
+ * \sa ad_lcdc_draw_regions_async()
+ *
+ * \return 0 on success, <0: error
+ */
+int ad_lcdc_draw_regions(ad_lcdc_handle_t handle, const hw_lcdc_layer_t *layer,
+        const hw_lcdc_frame_t *regions, uint8_t count, OS_TICK_TIME timeout);
+
+/**
+ * \brief Update a set of screen regions with the layer parameters
+ *
+ * This function is not blocking. It may block only waiting for device access, then it sets up the
+ * transaction and returns immediately. See \ref ad_lcdc_draw_regions() for the transfer details.
+ *
+ * \param [in] handle           Handle returned from ad_lcdc_open()
+ * \param [in] layer            Layer structure containing all layer information, normally
+ *                              covering the whole screen
+ * \param [in] regions          Screen regions to update, must be valid until \p cb is called
+ * \param [in] count            Number of entries in \p regions
+ * \param [in] cb               Callback to call after transaction is over (from ISR context)
+ * \param [in] user_data        User data to pass to \p cb
+ *
+ * \warning Do not call this function consecutively without guaranteeing that the previous
+ *          asynchronous transaction has completed.
+ *
+ * \return 0 on success, <0: error
+ */
+int ad_lcdc_draw_regions_async(ad_lcdc_handle_t handle, const hw_lcdc_layer_t *layer,
+        const hw_lcdc_frame_t *regions, uint8_t count, ad_lcdc_user_cb cb, void *user_data);
+
 /**
  * \brief Initialize a continuous update of the LCD
  *
@@ -0,0 +1,202 @@
+/**
+ * \addtogroup MID_SYS_ADAPTERS
+ * \{
+ * \addtogroup LCDC_FB_ADAPTER LCD Frame Buffer Manager
+ *
+ * \brief Incremental screen updates on top of the LCD Controller Adapter
+ *
+ * The frame buffer manager keeps track of the regions of the frame buffer that have been
+ * modified since the last update (dirty rectangles), merges them and transfers only those regions
+ * to the LCD with \ref ad_lcdc_draw_regions_async(), synchronized to the tearing effect signal
+ * when the LCD provides it.
+ *
+ * Overlapping or nearby rectangles are merged when transferring their bounding box costs less
+ * than transferring them separately, counting each transfer as dg_configLCDC_FB_MERGE_COST
+ * pixels. At most dg_configLCDC_FB_MAX_RECTS rectangles are kept, when this is exceeded the two
+ * rectangles with the smallest merge overhead are merged.
+ *
+ * With a second buffer, the application draws the next frame while the previous one is being
+ * transferred. After each update the transferred regions are copied to the buffer the application
+ * draws into next, so that both buffers always hold a complete frame.
+ *
+ * Example usage:
+ * \code{.c}
+ * {
+ *   ad_lcdc_fb_t fb;
+ *   const ad_lcdc_fb_config_t cfg = {
+ *     .layer = { .baseaddr = (uint32_t)fb0, .resx = RESX, .resy = RESY, .format = FORMAT },
+ *     .back_baseaddr = (uint32_t)fb1,
+ *   };
+ *
+ *   ad_lcdc_fb_init(&fb, hndl, &cfg);
+ *   while (1) {
+ *     uint8_t *buf = ad_lcdc_fb_get_buffer(&fb);
+ *
+ *     draw_clock(buf, &digits_rect);
+ *     ad_lcdc_fb_invalidate(&fb, &digits_rect);
+ *     ad_lcdc_fb_flush_async(&fb, NULL, NULL);
+ *     ...
+ *   }
+ * }
+ * \endcode
+ *
+ * \{
+ */
+
+/**
+ ****************************************************************************************
+ *
+ * @file ad_lcdc_fb.h
+ *
+ * @brief LCD frame buffer manager with dirty rectangle tracking
+ *
+ * Copyright (C) 2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ ****************************************************************************************
+ */
+
+#ifndef AD_LCDC_FB_H_
+#define AD_LCDC_FB_H_
+
+#if dg_configLCDC_ADAPTER
+
+#include "ad_lcdc.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \brief Frame buffer manager configuration
+ */
+typedef struct {
+        hw_lcdc_layer_t layer;                  //!< Full screen layer of the first buffer
+        uint32_t back_baseaddr;                 //!< Address of the second buffer, 0 for single buffering
+        bool full_lines;                        //!< Extend regions to whole lines (JDI / Sharp LCDs)
+} ad_lcdc_fb_config_t;
+
+/**
+ * \brief Frame buffer manager data
+ *
+ * Allocated by the application, all fields are private except the statistics.
+ */
+typedef struct {
+        ad_lcdc_handle_t handle;                //!< LCDC handle
+        ad_lcdc_fb_config_t cfg;                //!< Configuration
+        uint8_t draw;                           //!< Index of the buffer the application draws into
+        uint8_t dirty_cnt;                      //!< Number of entries in \p dirty
+        uint8_t flush_cnt;                      //!< Number of entries in \p flush
+        volatile bool busy;                     //!< A transfer is in progress
+        hw_lcdc_frame_t dirty[dg_configLCDC_FB_MAX_RECTS];      //!< Modified since the last update
+        hw_lcdc_frame_t flush[dg_configLCDC_FB_MAX_RECTS];      //!< Transfer in progress
+        OS_EVENT done;                          //!< Signaled at the end of a transfer
+        ad_lcdc_user_cb cb;                     //!< Callback of the transfer in progress
+        void *user_data;                        //!< User data to pass to \p cb
+
+        uint32_t frames;                        //!< Statistics: updates performed
+        uint32_t regions;                       //!< Statistics: regions transferred
+        uint32_t pixels;                        //!< Statistics: pixels transferred
+} ad_lcdc_fb_t;
+
+/**
+ * \brief Initialize a frame buffer manager
+ *
+ * The whole screen is marked as modified, so the first update transfers the complete frame.
+ *
+ * \param [out] fb              Frame buffer manager data
+ * \param [in] handle           Handle returned from ad_lcdc_open()
+ * \param [in] cfg              Configuration, copied
+ *
+ * \return 0 on success, <0: error
+ */
+int ad_lcdc_fb_init(ad_lcdc_fb_t *fb, ad_lcdc_handle_t handle, const ad_lcdc_fb_config_t *cfg);
+
+/**
+ * \brief Release the resources of a frame buffer manager
+ *
+ * Waits for the transfer in progress, if any.
+ *
+ * \param [in] fb               Frame buffer manager data
+ */
+void ad_lcdc_fb_deinit(ad_lcdc_fb_t *fb);
+
+/**
+ * \brief Get the buffer the application draws into
+ *
+ * With double buffering the returned buffer changes after every update.
+ *
+ * \param [in] fb               Frame buffer manager data
+ *
+ * \return buffer address
+ */
+uint8_t *ad_lcdc_fb_get_buffer(ad_lcdc_fb_t *fb);
+
+/**
+ * \brief Mark a region of the buffer as modified
+ *
+ * The region is clipped to the screen and merged with the regions already marked.
+ *
+ * \param [in] fb               Frame buffer manager data
+ * \param [in] rect             Modified region, in screen coordinates
+ */
+void ad_lcdc_fb_invalidate(ad_lcdc_fb_t *fb, const hw_lcdc_frame_t *rect);
+
+/**
+ * \brief Mark the whole buffer as modified
+ *
+ * \param [in] fb               Frame buffer manager data
+ */
+void ad_lcdc_fb_invalidate_all(ad_lcdc_fb_t *fb);
+
+/**
+ * \brief Transfer the modified regions to the LCD
+ *
+ * Waits for the previous transfer, starts the transfer of the modified regions and returns.
+ * With double buffering the application can draw into the buffer returned by
+ * \ref ad_lcdc_fb_get_buffer() right away, with single buffering it must wait for the callback
+ * or call \ref ad_lcdc_fb_wait() first.
+ *
+ * \param [in] fb               Frame buffer manager data
+ * \param [in] cb               Callback to call after transaction is over (from ISR context),
+ *                              can be NULL. If there is nothing to transfer it is called before
+ *                              the function returns.
+ * \param [in] user_data        User data to pass to \p cb
+ *
+ * \return 0 on success, <0: error
+ */
+int ad_lcdc_fb_flush_async(ad_lcdc_fb_t *fb, ad_lcdc_user_cb cb, void *user_data);
+
+/**
+ * \brief Transfer the modified regions to the LCD and wait for the transfer
+ *
+ * \param [in] fb               Frame buffer manager data
+ * \param [in] timeout          Timeout of the transaction
+ *
+ * \return 0 on success, <0: error
+ */
+int ad_lcdc_fb_flush(ad_lcdc_fb_t *fb, OS_TICK_TIME timeout);
+
+/**
+ * \brief Wait for the transfer in progress
+ *
+ * \param [in] fb               Frame buffer manager data
+ * \param [in] timeout          Maximum time to wait
+ *
+ * \return 0 on success, AD_LCDC_ERROR_TIMEOUT if the transfer is still in progress
+ */
+int ad_lcdc_fb_wait(ad_lcdc_fb_t *fb, OS_TICK_TIME timeout);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* dg_configLCDC_ADAPTER */
+
+#endif /* AD_LCDC_FB_H_ */
+
+/**
+ * \}
+ * \}
+ */
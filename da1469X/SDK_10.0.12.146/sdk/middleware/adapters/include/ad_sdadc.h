@@ -32,6 +32,13 @@
 #include "hw_sdadc.h"
 #include "osal.h"
 #include "resmgmt.h"
+#if dg_configSDADC_STREAM
+#include "hw_dma.h"
+#endif
+
+#if dg_configSDADC_STREAM && (dg_configUSE_HW_DMA == 0)
+#error "dg_configSDADC_STREAM requires dg_configUSE_HW_DMA"
+#endif
 
 #ifdef __cplusplus
 extern "C" {
@@ -222,6 +229,86 @@ int ad_sdadc_read_async(ad_sdadc_handle_t handle, ad_sdadc_user_cb cb, void *use
  */
 int ad_sdadc_read(ad_sdadc_handle_t handle, int32_t *value);
 
+#if dg_configSDADC_STREAM
+/**
+ * \brief Stream callback
+ *
+ * Called from DMA interrupt context every time a half of the stream buffer is filled.
+ *
+ * \param [in] user_data   user data passed in the stream configuration
+ * \param [in] samples     result register values, averaged when decimation is enabled. Signed in
+ *                         differential mode, convert with ad_sdadc_conv_to_millivolt().
+ * \param [in] count       number of samples
+ *
+ * \note The samples are valid until the DMA wraps around to the same half of the buffer, i.e. for
+ * ad_sdadc_stream_conf_t::block_len conversions.
+ */
+typedef void (*ad_sdadc_stream_cb)(void *user_data, const uint16_t *samples, uint16_t count);
+
+/**
+ * \brief Stream configuration
+ *
+ * The conversion rate is set by the clock frequency and the oversampling rate of the driver
+ * configuration.
+ */
+typedef struct {
+        HW_DMA_CHANNEL          dma_channel;    /**< DMA channel, must be odd (1, 3, 5 or 7) */
+        HW_DMA_PRIO             dma_prio;       /**< DMA channel priority */
+        uint16_t                *buffer;        /**< Buffer of 2 * block_len conversion results */
+        uint16_t                block_len;      /**< Conversion results per half buffer */
+        uint8_t                 decimation;     /**< Conversion results averaged per sample, must
+                                                     divide block_len, 0 or 1 disables averaging */
+        ad_sdadc_stream_cb      cb;             /**< Callback per filled half buffer */
+        void                    *user_data;     /**< User data passed to cb */
+} ad_sdadc_stream_conf_t;
+
+/**
+ * \brief Start continuous sampling to a DMA double buffer
+ *
+ * The SDADC runs in continuous mode and the DMA stores every conversion result in \p conf->buffer,
+ * wrapping around at its end. Each time a half of the buffer is filled \p conf->cb is called with
+ * that half, optionally averaged by \p conf->decimation, while the DMA fills the other half.
+ * No task runs per sample.
+ *
+ * The DMA channel stays acquired and the system does not enter sleep until
+ * ad_sdadc_stream_stop(), other reads fail meanwhile. The DMA and the ADC keep running while the
+ * CPU idles. When both ADCs stream at the same time they must use the two channels of the same
+ * DMA channel pair, since they share the DMA trigger.
+ *
+ * \param [in] handle  handle returned from ad_sdadc_open()
+ * \param [in] conf    stream configuration, copied
+ *
+ * \return 0 on success, <0: error
+ *
+ * \sa ad_sdadc_stream_stop()
+ */
+int ad_sdadc_stream_start(ad_sdadc_handle_t handle, const ad_sdadc_stream_conf_t *conf);
+
+/**
+ * \brief Stop continuous sampling
+ *
+ * Stops the conversions and the DMA, no callback is called after this function returns.
+ *
+ * \param [in] handle  handle returned from ad_sdadc_open()
+ *
+ * \return 0 on success, <0: error
+ */
+int ad_sdadc_stream_stop(ad_sdadc_handle_t handle);
+
+/**
+ * \brief Convert a stream sample to mV
+ *
+ * \param [in] drv     driver configuration of the stream
+ * \param [in] sample  sample passed to the stream callback
+ *
+ * \return voltage in mV
+ */
+__STATIC_INLINE int32_t ad_sdadc_conv_to_millivolt(const ad_sdadc_driver_conf_t *drv, uint16_t sample)
+{
+        return hw_sdadc_convert_to_millivolt(drv, sample);
+}
+#endif /* dg_configSDADC_STREAM */
+
 #ifdef __cplusplus
 }
 #endif
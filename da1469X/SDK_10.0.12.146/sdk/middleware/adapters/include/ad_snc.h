@@ -288,6 +288,35 @@ uint32_t ad_snc_queue_get_alloc_chunks(uint32_t ucode_id, AD_SNC_QUEUE_TYPE qTyp
  * \return uint32_t             the number of bytes in the current chunk
  */
 uint32_t ad_snc_queue_get_cur_chunk_bytes(uint32_t ucode_id, AD_SNC_QUEUE_TYPE qType);
+
+/**
+ * \brief Access the written chunks of a uCode-Block's SNC-to-CM33 queue in place
+ *
+ * Zero-copy alternative to ad_snc_queue_pop(). The chunks are not released until
+ * ad_snc_queue_consume() is called, and can be processed directly in queue memory using
+ * snc_queues_cm33_peek_chunk() and snc_queues_cm33_peek_timestamps().
+ *
+ * \param [in] ucode_id         uCode ID of the registered uCode
+ * \param [in] max_chunks       maximum number of chunks to return
+ * \param [out] peek            the returned chunks
+ *
+ * \return uint32_t             the number of chunks returned (0 if the queue is empty)
+ *
+ * \sa ad_snc_queue_consume
+ */
+uint32_t ad_snc_queue_peek(uint32_t ucode_id, uint32_t max_chunks, snc_queue_peek_t *peek);
+
+/**
+ * \brief Release chunks of a uCode-Block's SNC-to-CM33 queue obtained by ad_snc_queue_peek()
+ *
+ * \param [in] ucode_id         uCode ID of the registered uCode
+ * \param [in] num_of_chunks    number of chunks to release, oldest first
+ *
+ * \return bool                 true if the chunks have been released
+ *
+ * \sa ad_snc_queue_peek
+ */
+bool ad_snc_queue_consume(uint32_t ucode_id, uint32_t num_of_chunks);
 #endif /* dg_configUSE_SNC_QUEUES */
 
 #if dg_configUSE_HW_TIMER
@@ -43,6 +43,8 @@
  *      ad_spi_reconfig();
  *      ad_spi_write_async();    Non blocking write - caller task should retry until function returns no error. It will then be notified when transaction is completed
  *      ad_spi_read_async();     Non blocking read  - caller task should retry until function returns no error. It will then be notified when transaction is completed
+ *      ad_spi_transact();       Blocking list of reads, writes, chip select changes and delays executed back to back
+ *      ad_spi_transact_async(); Non blocking version of ad_spi_transact()
  *      ad_spi_close();          Called by the application for releasing the resource. System is allowed to go to sleep (if no other module blocks sleep)
  *
  *
@@ -79,6 +81,18 @@ extern "C" {
 # define CONFIG_SPI_USE_ASYNC_TRANSACTIONS         (1)
 #endif
 
+/**
+ * \def CONFIG_SPI_USE_TRANSACTION_LIST
+ *
+ * \brief Controls whether SPI transaction list API will be used
+ *
+ * SPI transaction list API (see ad_spi_transact()) keeps the state of the list being executed
+ * for every SPI bus declared. If the API is not to be used, setting this macro to 0 will save RAM.
+ */
+#ifndef CONFIG_SPI_USE_TRANSACTION_LIST
+# define CONFIG_SPI_USE_TRANSACTION_LIST           (1)
+#endif
+
 /*
  * Data types definitions section
  */
@@ -377,6 +391,100 @@ int ad_spi_write_read_async(ad_spi_handle_t handle, const uint8_t *wbuf, size_t
 
 #endif /* CONFIG_SPI_USE_ASYNC_TRANSACTIONS */
 
+#if CONFIG_SPI_USE_TRANSACTION_LIST
+
+/**
+ * \brief Action of SPI transaction list
+ */
+typedef enum {
+        AD_SPI_ACTION_CS_ACTIVATE,      /**< Activate chip select */
+        AD_SPI_ACTION_CS_DEACTIVATE,    /**< Wait for the bus to be idle and deactivate chip select */
+        AD_SPI_ACTION_SEND,             /**< Send data, incoming data are discarded */
+        AD_SPI_ACTION_RECEIVE,          /**< Receive data */
+        AD_SPI_ACTION_SEND_RECEIVE,     /**< Send and receive data at the same time */
+        AD_SPI_ACTION_DELAY,            /**< Busy wait */
+} AD_SPI_ACTION;
+
+/**
+ * \brief Element of SPI transaction list
+ *
+ * Use the AD_SPI_CSA, AD_SPI_CSD, AD_SPI_SND(), AD_SPI_RCV(), AD_SPI_SRCV() and AD_SPI_DELAY()
+ * macros to initialize elements.
+ */
+typedef struct {
+        AD_SPI_ACTION action;   /**< Action to take */
+        uint16_t len;           /**< Number of bytes to transfer, microseconds for AD_SPI_ACTION_DELAY */
+        const uint8_t *wbuf;    /**< Data to send */
+        uint8_t *rbuf;          /**< Buffer for incoming data */
+} ad_spi_transaction_t;
+
+/*
+ * The following macros are used to construct SPI transaction lists.
+ */
+#define AD_SPI_CSA                      { .action = AD_SPI_ACTION_CS_ACTIVATE }
+#define AD_SPI_CSD                      { .action = AD_SPI_ACTION_CS_DEACTIVATE }
+#define AD_SPI_SND(_wbuf, _len)         { .action = AD_SPI_ACTION_SEND, .len = (_len), \
+                                          .wbuf = (_wbuf) }
+#define AD_SPI_RCV(_rbuf, _len)         { .action = AD_SPI_ACTION_RECEIVE, .len = (_len), \
+                                          .rbuf = (_rbuf) }
+#define AD_SPI_SRCV(_wbuf, _rbuf, _len) { .action = AD_SPI_ACTION_SEND_RECEIVE, .len = (_len), \
+                                          .wbuf = (_wbuf), .rbuf = (_rbuf) }
+#define AD_SPI_DELAY(_usec)             { .action = AD_SPI_ACTION_DELAY, .len = (_usec) }
+
+/**
+ * \brief Perform a blocking transaction list
+ *
+ * Actions of the list are executed back to back. The next action is started from the completion
+ * interrupt of the previous transfer, so the caller task is woken up only once, after the whole
+ * list is over. Typical use is reading a sensor FIFO and some registers in one call:
+ *
+ * \code{.c}
+ * const ad_spi_transaction_t list[] = {
+ *         AD_SPI_CSA, AD_SPI_SND(&fifo_cmd, 1), AD_SPI_RCV(fifo, sizeof(fifo)), AD_SPI_CSD,
+ *         AD_SPI_CSA, AD_SPI_SND(&status_cmd, 1), AD_SPI_RCV(&status, 1), AD_SPI_CSD,
+ * };
+ *
+ * ad_spi_transact(handle, list, ARRAY_LENGTH(list));
+ * \endcode
+ *
+ * \param [in] handle handle returned from ad_spi_open()
+ * \param [in] list   actions to execute
+ * \param [in] count  number of actions in \p list
+ *
+ * \return 0 on success, <0: error
+ *
+ * \sa ad_spi_open()
+ *
+ * \note Transfer lengths must be non zero and follow the alignment rules of ad_spi_write() and
+ * ad_spi_read(). Delays are busy waits, executed in interrupt context when they follow a
+ * transfer, so they should be short.
+ */
+int ad_spi_transact(ad_spi_handle_t handle, const ad_spi_transaction_t *list, size_t count);
+
+/**
+ * \brief Perform a non blocking transaction list
+ *
+ * Same as ad_spi_transact() but returns as soon as the first transfer has been started.
+ * Callback will be called when the whole list is over.
+ *
+ * \param [in] handle    handle returned from ad_spi_open()
+ * \param [in] list      actions to execute, must stay valid until \p cb is called
+ * \param [in] count     number of actions in \p list
+ * \param [in] cb        callback to call after the list is over (from ISR context, or from the
+ *                       calling task if \p list contains no transfer), \p transferred is the
+ *                       total number of bytes transferred
+ * \param [in] user_data user data passed to cb callback
+ *
+ * \return 0 on success, <0: error
+ *
+ * \sa ad_spi_open()
+ *
+ */
+int ad_spi_transact_async(ad_spi_handle_t handle, const ad_spi_transaction_t *list, size_t count,
+                                                        ad_spi_user_cb cb, void *user_data);
+
+#endif /* CONFIG_SPI_USE_TRANSACTION_LIST */
+
 #ifdef __cplusplus
 }
 #endif
@@ -304,6 +304,77 @@ HW_UART_ID ad_uart_get_hw_uart_id(ad_uart_handle_t handle);
  */
 int ad_uart_complete_async_read(ad_uart_handle_t handle);
 
+#if dg_configUART_RX_CIRCULAR_DMA
+/**
+ * \brief Read all available data from circular RX DMA buffer
+ *
+ * Copies the data already received, up to \p rlen bytes, without waiting for a specific
+ * number of bytes. If no data is available, waits up to \p timeout for \p rlen bytes to arrive
+ * or for the RX line to become idle after some bytes arrived, whichever happens first.
+ *
+ * The UART must be configured with \p dg_configUARTx_RX_CIRCULAR_DMA_BUF_SIZE > 0. Idle line
+ * detection uses the UART character timeout, which requires the FIFO to be enabled
+ * (\p use_fifo) with an RX trigger level above one character.
+ *
+ * \param [in]  handle  handle returned from ad_uart_open()
+ * \param [out] rbuf    buffer for incoming data
+ * \param [in]  rlen    size of \p rbuf
+ * \param [in]  timeout time to wait for data if none is available, 0 to return immediately
+ *
+ * \return number of bytes read, <0: error
+ *
+ */
+int ad_uart_read_available(ad_uart_handle_t handle, char *rbuf, size_t rlen, OS_TICK_TIME timeout);
+
+/**
+ * \brief Request notification when data are available in circular RX DMA buffer
+ *
+ * Callback is called once, with the number of bytes available, when \p threshold bytes are
+ * available or when the RX line becomes idle after some bytes arrived. If data are already
+ * available the callback is called from this function. The data can then be parsed in place
+ * with ad_uart_rx_ring_peek() and ad_uart_rx_ring_consume(), or copied with
+ * ad_uart_read_available().
+ *
+ * \param [in] handle    handle returned from ad_uart_open()
+ * \param [in] threshold number of bytes to wait for
+ * \param [in] cb        callback to call when data are available (from ISR context)
+ * \param [in] user_data user data passed to cb callback
+ *
+ * \warning Do not call this function again before the callback has been called.
+ *          ad_uart_complete_async_read() cancels the request and calls the callback.
+ *
+ * \return 0 on success, AD_UART_ERROR_CONTROLLER_CONF_INVALID if the UART does not use
+ *         circular RX DMA, <0: other error
+ *
+ */
+int ad_uart_rx_ring_notify(ad_uart_handle_t handle, uint16_t threshold, ad_uart_user_cb cb,
+                           void *user_data);
+
+/**
+ * \brief Get received data in circular RX DMA buffer without copying them
+ *
+ * Returns the oldest data not consumed yet that are contiguous in the buffer. Data wrapping
+ * around the end of the buffer are returned by the next call, after ad_uart_rx_ring_consume().
+ * Only the task parsing the received data may call this function.
+ *
+ * \param [in]  handle handle returned from ad_uart_open()
+ * \param [out] data   pointer to the received data
+ *
+ * \return number of bytes at \p data
+ *
+ */
+uint16_t ad_uart_rx_ring_peek(ad_uart_handle_t handle, const uint8_t **data);
+
+/**
+ * \brief Release data returned by ad_uart_rx_ring_peek()
+ *
+ * \param [in] handle handle returned from ad_uart_open()
+ * \param [in] len    number of bytes parsed
+ *
+ */
+void ad_uart_rx_ring_consume(ad_uart_handle_t handle, uint16_t len);
+#endif /* dg_configUART_RX_CIRCULAR_DMA */
+
 /**
 * \brief Initialize controller pins to on / off io configuration
 *
@@ -317,6 +317,328 @@ static void ad_crypto_wake_up_ind(bool arg)
 
 #endif /* dg_configUSE_HW_ECC */
 
+#if (AD_CRYPTO_CFG_JOB_QUEUE == 1)
+
+#define AD_CRYPTO_JOB_NOTIF_SUBMIT      (1 << 0)
+
+__RETAINED static ad_crypto_job_t *job_head;
+__RETAINED static ad_crypto_job_t *job_tail;
+__RETAINED static OS_TASK job_task;
+
+#if dg_configUSE_HW_AES || dg_configUSE_HW_HASH
+/* Job programmed to the AES/HASH engine, its remaining chunks are fed from the IRQ callback */
+static ad_crypto_job_t *volatile job_active;
+__RETAINED static bool job_aes_hash_held;
+__RETAINED static AD_CRYPTO_JOB_TYPE job_aes_hash_type;
+#endif
+#if dg_configUSE_HW_ECC
+__RETAINED static bool job_ecc_held;
+#endif
+
+static bool ad_crypto_job_is_supported(AD_CRYPTO_JOB_TYPE type)
+{
+        switch (type) {
+#if dg_configUSE_HW_AES
+        case AD_CRYPTO_JOB_AES:
+                return true;
+#endif
+#if dg_configUSE_HW_HASH
+        case AD_CRYPTO_JOB_HASH:
+                return true;
+#endif
+#if dg_configUSE_HW_ECC
+        case AD_CRYPTO_JOB_ECC:
+                return true;
+#endif
+        default:
+                return false;
+        }
+}
+
+#if dg_configUSE_HW_AES || dg_configUSE_HW_HASH
+
+static void ad_crypto_job_get_data(const ad_crypto_job_t *job, uint32_t *in, uint32_t *out,
+                                   uint32_t *len)
+{
+#if dg_configUSE_HW_AES
+        if (job->type == AD_CRYPTO_JOB_AES) {
+                *in = job->cfg.aes.input_data_addr;
+                *out = job->cfg.aes.output_data_addr;
+                *len = job->cfg.aes.input_data_len;
+                return;
+        }
+#endif
+#if dg_configUSE_HW_HASH
+        *in = job->cfg.hash.input_data_addr;
+        *out = job->cfg.hash.output_data_addr;
+        *len = job->cfg.hash.input_data_len;
+#endif
+}
+
+static void ad_crypto_job_irq_cb(uint32_t status)
+{
+        ad_crypto_job_t *job = job_active;
+        uint32_t in, out, len, chunk;
+
+        if (job == NULL) {
+                aes_hash_irq_cb(status);
+                return;
+        }
+
+        ad_crypto_job_get_data(job, &in, &out, &len);
+        if (job->fed >= len) {
+                /* The last chunk has been processed */
+                aes_hash_irq_cb(status);
+                return;
+        }
+
+        /* The engine waits for input, feed the next chunk without waking up the job task */
+        chunk = MIN(len - job->fed, job->chunk_size);
+        hw_aes_hash_set_input_data_addr(in + job->fed);
+#if dg_configUSE_HW_AES
+        if (job->type == AD_CRYPTO_JOB_AES &&
+            job->cfg.aes.output_data_mode == HW_AES_OUTPUT_DATA_MODE_ALL) {
+                hw_aes_hash_set_output_data_addr(out + job->fed);
+        }
+#endif
+        hw_aes_hash_set_input_data_len(chunk);
+        job->fed += chunk;
+        hw_aes_hash_set_input_data_mode(job->fed < len);
+        hw_aes_hash_start();
+}
+
+static int ad_crypto_job_run_aes_hash(ad_crypto_job_t *job)
+{
+        uint32_t in, out, len;
+        bool more;
+
+        if (!job_aes_hash_held) {
+                ad_crypto_acquire_aes_hash(OS_MUTEX_FOREVER);
+                ad_crypto_clear_aes_hash_event();
+                ad_crypto_status |= AD_CRYPTO_AES_HASH_EVENT_EN;
+                job_aes_hash_held = true;
+        } else if (job_aes_hash_type != job->type) {
+                /* The engine stays locked to the previous type while clocked */
+                hw_aes_hash_disable_clock();
+        }
+        job_aes_hash_type = job->type;
+
+        ad_crypto_job_get_data(job, &in, &out, &len);
+        job->fed = MIN(len, job->chunk_size);
+        more = job->fed < len;
+        job_active = job;
+
+#if dg_configUSE_HW_AES
+        if (job->type == AD_CRYPTO_JOB_AES) {
+                hw_aes_config_t cfg = job->cfg.aes;
+
+                cfg.wait_more_input = more;
+                cfg.input_data_len = job->fed;
+                cfg.callback = ad_crypto_job_irq_cb;
+                if (hw_aes_init(&cfg) != HW_AES_ERROR_NONE) {
+                        job_active = NULL;
+                        return AD_CRYPTO_JOB_ERROR_CONFIG;
+                }
+                hw_aes_start_operation(cfg.operation);
+        }
+#endif
+#if dg_configUSE_HW_HASH
+        if (job->type == AD_CRYPTO_JOB_HASH) {
+                hw_hash_config_t cfg = job->cfg.hash;
+
+                cfg.wait_more_input = more;
+                cfg.input_data_len = job->fed;
+                cfg.callback = ad_crypto_job_irq_cb;
+                if (hw_hash_init(&cfg) != HW_HASH_ERROR_NONE) {
+                        job_active = NULL;
+                        return AD_CRYPTO_JOB_ERROR_CONFIG;
+                }
+                hw_aes_hash_start();
+        }
+#endif
+
+        ad_crypto_wait_aes_hash_event(OS_EVENT_FOREVER, NULL);
+        job_active = NULL;
+
+        return AD_CRYPTO_JOB_OK;
+}
+
+static void ad_crypto_job_release_aes_hash(void)
+{
+        if (job_aes_hash_held) {
+                ad_crypto_disable_aes_hash_event();
+                ad_crypto_release_aes_hash();
+                job_aes_hash_held = false;
+        }
+}
+
+#endif /* dg_configUSE_HW_AES || dg_configUSE_HW_HASH */
+
+#if dg_configUSE_HW_ECC
+
+static int ad_crypto_job_run_ecc(ad_crypto_job_t *job)
+{
+        if (!job_ecc_held) {
+                ad_crypto_acquire_ecc(OS_MUTEX_FOREVER);
+                ad_crypto_enable_ecc_event();
+                job_ecc_held = true;
+        }
+
+        return job->cfg.ecc_op(job);
+}
+
+static void ad_crypto_job_release_ecc(void)
+{
+        if (job_ecc_held) {
+                ad_crypto_disable_ecc_event();
+                ad_crypto_release_ecc();
+                job_ecc_held = false;
+        }
+}
+
+#endif /* dg_configUSE_HW_ECC */
+
+static ad_crypto_job_t *ad_crypto_job_pop(void)
+{
+        ad_crypto_job_t *job;
+
+        OS_ENTER_CRITICAL_SECTION();
+        job = job_head;
+        if (job) {
+                job_head = job->next;
+                if (job_head == NULL) {
+                        job_tail = NULL;
+                }
+                job->next = NULL;
+        }
+        OS_LEAVE_CRITICAL_SECTION();
+
+        return job;
+}
+
+/*
+ * Release the engines not needed by the next queued job, so that they are clocked and keep the
+ * system awake only while there is work for them.
+ */
+static void ad_crypto_job_release_idle(void)
+{
+        AD_CRYPTO_JOB_TYPE next;
+        bool empty;
+
+        OS_ENTER_CRITICAL_SECTION();
+        empty = (job_head == NULL);
+        next = empty ? AD_CRYPTO_JOB_AES : job_head->type;
+        OS_LEAVE_CRITICAL_SECTION();
+
+#if dg_configUSE_HW_AES || dg_configUSE_HW_HASH
+        if (empty || next == AD_CRYPTO_JOB_ECC) {
+                ad_crypto_job_release_aes_hash();
+        }
+#endif
+#if dg_configUSE_HW_ECC
+        if (empty || next != AD_CRYPTO_JOB_ECC) {
+                ad_crypto_job_release_ecc();
+        }
+#endif
+}
+
+static void ad_crypto_job_task(void *params)
+{
+        ad_crypto_job_t *job;
+        uint32_t notif;
+        int status;
+
+        for (;;) {
+                OS_TASK_NOTIFY_WAIT(0, OS_TASK_NOTIFY_ALL_BITS, &notif, OS_TASK_NOTIFY_FOREVER);
+
+                while ((job = ad_crypto_job_pop()) != NULL) {
+#if dg_configUSE_HW_ECC
+                        if (job->type == AD_CRYPTO_JOB_ECC) {
+#if dg_configUSE_HW_AES || dg_configUSE_HW_HASH
+                                ad_crypto_job_release_aes_hash();
+#endif
+                                status = ad_crypto_job_run_ecc(job);
+                        } else
+#endif
+                        {
+#if dg_configUSE_HW_AES || dg_configUSE_HW_HASH
+#if dg_configUSE_HW_ECC
+                                ad_crypto_job_release_ecc();
+#endif
+                                status = ad_crypto_job_run_aes_hash(job);
+#else
+                                status = AD_CRYPTO_JOB_ERROR_CONFIG;
+#endif
+                        }
+
+                        /* The callback may submit the next job, keep the engine if it does */
+                        if (job->cb) {
+                                job->cb(job, status);
+                        }
+                        ad_crypto_job_release_idle();
+                }
+        }
+}
+
+bool ad_crypto_submit_job(ad_crypto_job_t *job)
+{
+        const uint32_t align = (job->type == AD_CRYPTO_JOB_AES) ? 16 : 8;
+
+        if (!ad_crypto_job_is_supported(job->type)) {
+                return false;
+        }
+
+        if (job->chunk_size == 0) {
+                job->chunk_size = AD_CRYPTO_CFG_JOB_CHUNK_SIZE;
+        }
+        if (job->type != AD_CRYPTO_JOB_ECC && (job->chunk_size % align) != 0) {
+                return false;
+        }
+
+        job->next = NULL;
+        job->fed = 0;
+
+        OS_ENTER_CRITICAL_SECTION();
+        if (job_tail) {
+                job_tail->next = job;
+        } else {
+                job_head = job;
+        }
+        job_tail = job;
+        OS_LEAVE_CRITICAL_SECTION();
+
+        OS_TASK_NOTIFY(job_task, AD_CRYPTO_JOB_NOTIF_SUBMIT, OS_NOTIFY_SET_BITS);
+
+        return true;
+}
+
+bool ad_crypto_cancel_job(ad_crypto_job_t *job)
+{
+        ad_crypto_job_t *prev = NULL;
+        ad_crypto_job_t *it;
+
+        OS_ENTER_CRITICAL_SECTION();
+        for (it = job_head; it != NULL && it != job; it = it->next) {
+                prev = it;
+        }
+        if (it) {
+                if (prev) {
+                        prev->next = it->next;
+                } else {
+                        job_head = it->next;
+                }
+                if (job_tail == it) {
+                        job_tail = prev;
+                }
+                it->next = NULL;
+        }
+        OS_LEAVE_CRITICAL_SECTION();
+
+        return it != NULL;
+}
+
+#endif /* AD_CRYPTO_CFG_JOB_QUEUE */
+
 const adapter_call_backs_t ad_crypto_pm_cbs = {
         .ad_prepare_for_sleep = NULL,
         .ad_sleep_canceled = NULL,
@@ -350,6 +672,20 @@ void ad_crypto_init(void *params)
         OS_ASSERT(ecc_event);
 #endif
 
+#if (AD_CRYPTO_CFG_JOB_QUEUE == 1)
+        job_head = NULL;
+        job_tail = NULL;
+        status = OS_TASK_CREATE("AD_CRYPTO",                   /* The text name assigned to the task, for
+                                                                   debug only; not used by the kernel. */
+                                ad_crypto_job_task,             /* The function that implements the task. */
+                                NULL,                           /* The parameter passed to the task. */
+                                AD_CRYPTO_CFG_JOB_TASK_STACK_SIZE,
+                                                                /* Stack size allocated for the task in bytes. */
+                                AD_CRYPTO_CFG_JOB_TASK_PRIORITY,/* The priority assigned to the task. */
+                                job_task);                      /* The task handle */
+        OS_ASSERT(status == OS_TASK_CREATE_SUCCESS);
+#endif
+
         pm_register_adapter(&ad_crypto_pm_cbs);
 }
 
@@ -61,6 +61,10 @@ typedef struct ad_gpadc_data {
         bool                            read_in_progress;       /**< Number of source_acquire calls */
         bool                            latch_input0;           /**< flag to indicate if input 0 needs latching */
         bool                            latch_input1;           /**< flag to indicate if input 1 needs latching */
+#if dg_configGPADC_STREAM
+        volatile bool                   streaming;              /**< Continuous sampling to DMA is running */
+        ad_gpadc_stream_conf_t          stream;                 /**< Configuration of the running stream */
+#endif
 } ad_gpadc_data;
 
 __RETAINED static ad_gpadc_data dynamic_data;
@@ -259,6 +263,11 @@ int ad_gpadc_reconfig(ad_gpadc_handle_t handle, const ad_gpadc_driver_conf_t *dr
         if (dynamic_data.read_in_progress) {
                 return AD_GPADC_ERROR_ASYNC_READ_IN_PROGRESS;
         }
+#if dg_configGPADC_STREAM
+        if (dynamic_data.streaming) {
+                return AD_GPADC_ERROR_ASYNC_READ_IN_PROGRESS;
+        }
+#endif
 
         ad_gpadc_acquire();
         dynamic_data.conf->drv = (ad_gpadc_driver_conf_t *) drv;
@@ -322,10 +331,23 @@ ad_gpadc_handle_t ad_gpadc_open(const ad_gpadc_controller_conf_t *conf)
         return dynamic_data.handle;
 }
 
+#if dg_configGPADC_STREAM
+static void ad_gpadc_stream_halt(void);
+#endif
+
 int ad_gpadc_close(ad_gpadc_handle_t handle, bool force)
 {
         AD_GPADC_ASSERT_HANDLE_VALID(handle)
 
+#if dg_configGPADC_STREAM
+        if (dynamic_data.streaming) {
+                if (!force) {
+                        return AD_GPADC_ERROR_ASYNC_READ_IN_PROGRESS;
+                }
+                ad_gpadc_stream_halt();
+        }
+#endif
+
         OS_ENTER_CRITICAL_SECTION();
         if (dynamic_data.read_in_progress) {
                 if (force) {
@@ -393,6 +415,12 @@ int ad_gpadc_read_async(ad_gpadc_handle_t handle, ad_gpadc_user_cb read_async_cb
                 ad_gpadc_release();
                 return AD_GPADC_ERROR_ASYNC_READ_IN_PROGRESS;
         }
+#if dg_configGPADC_STREAM
+        if (dynamic_data.streaming) {
+                ad_gpadc_release();
+                return AD_GPADC_ERROR_ASYNC_READ_IN_PROGRESS;
+        }
+#endif
 
         dynamic_data.read_in_progress = true;
 
@@ -442,6 +470,13 @@ static int ad_gpadc_read_internal_to(ad_gpadc_controller_conf_t *conf, uint16_t
         int ret = AD_GPADC_ERROR_TIMEOUT;
 
         if (ad_gpadc_acquire_to(timeout)) {
+#if dg_configGPADC_STREAM
+                if (dynamic_data.streaming) {
+                        /* The stream owner cannot take single measurements */
+                        ad_gpadc_release();
+                        return AD_GPADC_ERROR_ASYNC_READ_IN_PROGRESS;
+                }
+#endif
                 hw_gpadc_unregister_interrupt();
 
                 hw_gpadc_adc_measure();
@@ -476,6 +511,141 @@ int ad_gpadc_read_to(ad_gpadc_handle_t handle, uint16_t *value, uint32_t timeout
         return ret;
 }
 
+#if dg_configGPADC_STREAM
+/* Average every n results in place, returns the number of averages */
+static uint16_t ad_gpadc_stream_decimate(uint16_t *samples, uint16_t len, uint8_t n)
+{
+        uint16_t i, j, cnt = 0;
+        uint32_t sum;
+
+        for (i = 0; i < len; i += n) {
+                sum = 0;
+                for (j = 0; j < n; j++) {
+                        sum += samples[i + j];
+                }
+                samples[cnt++] = sum / n;
+        }
+
+        return cnt;
+}
+
+static void ad_gpadc_stream_dma_cb(void *user_data, dma_size_t len)
+{
+        ad_gpadc_stream_conf_t *stream = &dynamic_data.stream;
+        uint16_t *samples;
+        uint16_t count = stream->block_len;
+
+        /* Also called by hw_dma_channel_stop() */
+        if (!dynamic_data.streaming) {
+                return;
+        }
+
+        /* Interrupt alternately when the first and the second half of the buffer is full */
+        if (len <= stream->block_len) {
+                samples = stream->buffer;
+                hw_dma_channel_update_int_ix(stream->dma_channel, 2 * stream->block_len - 1);
+        } else {
+                samples = stream->buffer + stream->block_len;
+                hw_dma_channel_update_int_ix(stream->dma_channel, stream->block_len - 1);
+        }
+
+        if (stream->decimation > 1) {
+                count = ad_gpadc_stream_decimate(samples, count, stream->decimation);
+        }
+
+        stream->cb(stream->user_data, samples, count);
+}
+
+int ad_gpadc_stream_start(ad_gpadc_handle_t handle, const ad_gpadc_stream_conf_t *conf)
+{
+        DMA_setup dma;
+
+        AD_GPADC_ASSERT_HANDLE_VALID(handle)
+
+        if (!conf || !conf->buffer || !conf->cb || conf->block_len == 0 ||
+            conf->dma_channel >= HW_DMA_CHANNEL_INVALID || (conf->dma_channel & 1) ||
+            (conf->block_len % MAX(conf->decimation, 1))) {
+                return AD_GPADC_ERROR_CONFIG_INVALID;
+        }
+
+        ad_gpadc_acquire();
+
+        if (dynamic_data.read_in_progress || dynamic_data.streaming) {
+                ad_gpadc_release();
+                return AD_GPADC_ERROR_ASYNC_READ_IN_PROGRESS;
+        }
+
+        resource_acquire(RES_MASK(RES_ID_DMA_CH0 + conf->dma_channel), RES_WAIT_FOREVER);
+        /* The DMA and the ADC must keep running, allow only idle (WFI) until stopped */
+        pm_sleep_mode_request(pm_mode_idle);
+
+        dynamic_data.stream = *conf;
+        dynamic_data.streaming = true;
+
+        dma.channel_number = conf->dma_channel;
+        dma.bus_width = HW_DMA_BW_HALFWORD;
+        dma.irq_enable = HW_DMA_IRQ_STATE_ENABLED;
+        dma.irq_nr_of_trans = conf->block_len;
+        dma.dreq_mode = HW_DMA_DREQ_TRIGGERED;
+        dma.burst_mode = HW_DMA_BURST_MODE_DISABLED;
+        dma.a_inc = HW_DMA_AINC_FALSE;
+        dma.b_inc = HW_DMA_BINC_TRUE;
+        dma.circular = HW_DMA_MODE_CIRCULAR;
+        dma.dma_prio = conf->dma_prio;
+        dma.dma_idle = HW_DMA_IDLE_INTERRUPTING_MODE;
+        dma.dma_init = HW_DMA_INIT_AX_BX_AY_BY;
+        dma.dma_req_mux = HW_DMA_TRIG_ADC;
+        dma.src_address = (uint32_t) &GPADC->GP_ADC_RESULT_REG;
+        dma.dest_address = (uint32_t) conf->buffer;
+        dma.length = 2 * conf->block_len;
+        dma.callback = ad_gpadc_stream_dma_cb;
+        dma.user_data = NULL;
+
+        /* The results are collected by the DMA, no interrupt per conversion */
+        hw_gpadc_unregister_interrupt();
+        hw_gpadc_clear_interrupt();
+        hw_gpadc_set_dma_functionality(true);
+        hw_dma_channel_initialization(&dma);
+        hw_dma_channel_enable(conf->dma_channel, HW_DMA_STATE_ENABLED);
+
+        hw_gpadc_set_continuous(true);
+        hw_gpadc_start();
+
+        return AD_GPADC_ERROR_NONE;
+}
+
+static void ad_gpadc_stream_halt(void)
+{
+        const HW_DMA_CHANNEL channel = dynamic_data.stream.dma_channel;
+
+        dynamic_data.streaming = false;
+
+        hw_gpadc_set_continuous(false);
+        while (hw_gpadc_in_progress());
+        hw_gpadc_set_dma_functionality(false);
+        hw_dma_channel_stop(channel);
+        hw_gpadc_clear_interrupt();
+        hw_gpadc_set_continuous(dynamic_data.conf->drv->continuous);
+
+        pm_sleep_mode_release(pm_mode_idle);
+        resource_release(RES_MASK(RES_ID_DMA_CH0 + channel));
+        ad_gpadc_release();
+}
+
+int ad_gpadc_stream_stop(ad_gpadc_handle_t handle)
+{
+        AD_GPADC_ASSERT_HANDLE_VALID(handle)
+
+        if (!dynamic_data.streaming) {
+                return AD_GPADC_ERROR_OTHER;
+        }
+
+        ad_gpadc_stream_halt();
+
+        return AD_GPADC_ERROR_NONE;
+}
+#endif /* dg_configGPADC_STREAM */
+
 uint16_t ad_gpadc_get_source_max(const ad_gpadc_driver_conf_t *drv)
 {
         return 0xFFFF >> (6 - MIN(6, drv->oversampling));
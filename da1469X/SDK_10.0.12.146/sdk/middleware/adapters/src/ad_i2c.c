@@ -31,6 +31,7 @@
 #include "resmgmt.h"
 #include "sys_power_mgr.h"
 
+#include "hw_clk.h"
 #include "hw_sys.h"
 #include "sdk_list.h"
 #include "sys_bsr.h"
@@ -47,6 +48,13 @@ typedef struct {
         /**< Internal data */
         OS_TASK owner; /**< The task which opened the controller */
         ad_i2c_driver_conf_t *current_drv;
+#if CONFIG_I2C_USE_TRANSACTION_LIST
+        const ad_i2c_transaction_t *list;       /**< Next action of the running transaction list */
+        size_t list_count;                      /**< Number of actions left */
+        ad_i2c_user_cb list_cb;                 /**< Callback to call when the list is over */
+        void *list_user_data;                   /**< User data passed to list_cb */
+        uint16_t list_abort_source;             /**< Abort source of the failed transfer */
+#endif /* CONFIG_I2C_USE_TRANSACTION_LIST */
 #if dg_configI2C_ADAPTER_SLAVE_SUPPORT
         i2c_slave_state_data_t slave_data;
 #endif /* dg_configI2C_ADAPTER_SLAVE_SUPPORT */
@@ -606,6 +614,165 @@ int ad_i2c_write_read_async(ad_i2c_handle_t p, const uint8_t *wbuf, size_t wlen,
 }
 #endif /* CONFIG_I2C_USE_ASYNC_TRANSACTIONS */
 
+#if CONFIG_I2C_USE_TRANSACTION_LIST
+
+static void ad_i2c_list_do(ad_i2c_dynamic_data_t *i2c);
+
+static void ad_i2c_list_end(ad_i2c_dynamic_data_t *i2c, HW_I2C_ABORT_SOURCE error)
+{
+        ad_i2c_user_cb cb = i2c->list_cb;
+        void *user_data = i2c->list_user_data;
+
+        /* A new list can be started from the callback */
+        i2c->list = NULL;
+        i2c->list_count = 0;
+        cb(user_data, error);
+}
+
+/*
+ * Callback passed to low level driver, invoked after each transfer of the list.
+ */
+static void ad_i2c_list_cb(HW_I2C_ID id, void *cb_data, uint16_t len, bool success)
+{
+        ad_i2c_dynamic_data_t *i2c = (ad_i2c_dynamic_data_t *) cb_data;
+        uint16_t abort_source;
+
+        if (!success) {
+                abort_source = hw_i2c_get_abort_source(id);
+                if (abort_source == HW_I2C_ABORT_NONE) {
+                        abort_source = HW_I2C_ABORT_SW_ERROR;
+                }
+                ad_i2c_list_end(i2c, (HW_I2C_ABORT_SOURCE) abort_source);
+                return;
+        }
+
+        ad_i2c_list_do(i2c);
+}
+
+/*
+ * This function executes actions until a transfer is started or the list is over. The rest of
+ * the list is executed from the transfer completion interrupt. The low level driver releases the
+ * controller before calling the completion callback, so the next transfer can be started from
+ * there right away.
+ */
+static void ad_i2c_list_do(ad_i2c_dynamic_data_t *i2c)
+{
+        const HW_I2C_ID id = i2c->conf->id;
+        const ad_i2c_transaction_t *t;
+        uint8_t flags;
+
+        while (i2c->list_count) {
+                t = i2c->list++;
+                i2c->list_count--;
+                flags = t->flags;
+
+                switch (t->action) {
+                case AD_I2C_ACTION_SEND:
+                        if (flags & HW_I2C_F_ADD_STOP) {
+                                flags |= HW_I2C_F_WAIT_FOR_STOP;
+                        }
+                        hw_i2c_write_buffer_async(id, t->wbuf, t->len, ad_i2c_list_cb, i2c, flags);
+                        return;
+                case AD_I2C_ACTION_RECEIVE:
+#if (HW_I2C_DMA_SUPPORT == 1)
+                        if (i2c->conf->drv->dma_channel < HW_DMA_CHANNEL_INVALID && t->len > 1) {
+                                hw_i2c_read_buffer_dma(id, i2c->conf->drv->dma_channel, t->rbuf,
+                                                       t->len, ad_i2c_list_cb, i2c, flags);
+                                return;
+                        }
+#endif /* HW_I2C_DMA_SUPPORT */
+                        hw_i2c_read_buffer_async(id, t->rbuf, t->len, ad_i2c_list_cb, i2c, flags);
+                        return;
+                case AD_I2C_ACTION_DELAY:
+                        hw_clk_delay_usec(t->len);
+                        break;
+                default:
+                        OS_ASSERT(0);
+                }
+        }
+
+        ad_i2c_list_end(i2c, HW_I2C_ABORT_NONE);
+}
+
+static void ad_i2c_list_start(ad_i2c_dynamic_data_t *i2c, const ad_i2c_transaction_t *list,
+                              size_t count, ad_i2c_user_cb cb, void *user_data)
+{
+        const ad_i2c_transaction_t *t;
+
+        for (t = list; t < list + count; t++) {
+                ASSERT_WARNING((t->flags & ~(HW_I2C_F_NONE | HW_I2C_F_ADD_STOP |
+                                             HW_I2C_F_ADD_RESTART)) == 0);
+        }
+
+        i2c->list = list;
+        i2c->list_count = count;
+        i2c->list_cb = cb;
+        i2c->list_user_data = user_data;
+
+        ad_i2c_list_do(i2c);
+}
+
+static void ad_i2c_list_wait_event(void *user_data, HW_I2C_ABORT_SOURCE error)
+{
+        ad_i2c_dynamic_data_t *i2c = (ad_i2c_dynamic_data_t *) user_data;
+        const ad_i2c_static_data_t *i2c_static = ad_i2c_get_static_data_by_hw_id(i2c->conf->id);
+
+        i2c->list_abort_source = error;
+        /* List without transfers completes in the calling task */
+        if (in_interrupt()) {
+                OS_EVENT_SIGNAL_FROM_ISR(i2c_static->event);
+        } else {
+                OS_EVENT_SIGNAL(i2c_static->event);
+        }
+}
+
+int ad_i2c_transact(ad_i2c_handle_t p, const ad_i2c_transaction_t *list, size_t count)
+{
+        if (!(AD_I2C_HANDLE_IS_VALID(p))) {
+                OS_ASSERT(0);
+                return AD_I2C_ERROR_HANDLE_INVALID;
+        }
+        ad_i2c_dynamic_data_t *i2c = (ad_i2c_dynamic_data_t *)p;
+        const ad_i2c_static_data_t *i2c_static = ad_i2c_get_static_data_by_hw_id(i2c->conf->id);
+
+        OS_MUTEX_GET(i2c_static->busy, OS_MUTEX_FOREVER);
+        /* Check if i2c hw driver is in use and already occupied */
+        if (hw_i2c_is_occupied(i2c->conf->id)) {
+                OS_MUTEX_PUT(i2c_static->busy);
+                return AD_I2C_ERROR_CONTROLLER_BUSY;
+        }
+
+        ad_i2c_list_start(i2c, list, count, ad_i2c_list_wait_event, i2c);
+
+        OS_EVENT_WAIT(i2c_static->event, OS_EVENT_FOREVER);
+        OS_MUTEX_PUT(i2c_static->busy);
+
+        return (int)i2c->list_abort_source;
+}
+
+int ad_i2c_transact_async(ad_i2c_handle_t p, const ad_i2c_transaction_t *list, size_t count,
+                          ad_i2c_user_cb cb, void *user_data)
+{
+        if (!(AD_I2C_HANDLE_IS_VALID(p))) {
+                OS_ASSERT(0);
+                return AD_I2C_ERROR_HANDLE_INVALID;
+        }
+        ad_i2c_dynamic_data_t *i2c = (ad_i2c_dynamic_data_t *)p;
+        const ad_i2c_static_data_t *i2c_static = ad_i2c_get_static_data_by_hw_id(i2c->conf->id);
+
+        OS_MUTEX_GET(i2c_static->busy, OS_MUTEX_FOREVER);
+        /* Check if i2c hw driver is in use and already occupied */
+        if (hw_i2c_is_occupied(i2c->conf->id)) {
+                OS_MUTEX_PUT(i2c_static->busy);
+                return AD_I2C_ERROR_CONTROLLER_BUSY;
+        }
+
+        ad_i2c_list_start(i2c, list, count, cb, user_data);
+        OS_MUTEX_PUT(i2c_static->busy);
+        return AD_I2C_ERROR_NONE;
+}
+#endif /* CONFIG_I2C_USE_TRANSACTION_LIST */
+
 #if dg_configI2C_ADAPTER_SLAVE_SUPPORT
 
 static void ad_i2c_slave_cb(HW_I2C_ID id, HW_I2C_EVENT event);
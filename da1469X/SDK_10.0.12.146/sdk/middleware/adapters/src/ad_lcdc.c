@@ -100,6 +100,10 @@ typedef struct {
         OS_EVENT event;                         //!< Event for async calls
         ad_lcdc_user_cb callback;               //!< Callback function to call after transaction ends
         void *callback_data;                    //!< Callback data to pass to \p callback
+        hw_lcdc_layer_t regions_layer;          //!< Layer of the regions transfer in progress
+        const hw_lcdc_frame_t *regions;         //!< Regions of the transfer in progress
+        uint8_t regions_cnt;                    //!< Number of entries in \p regions
+        uint8_t regions_idx;                    //!< Next entry of \p regions to send
 } ad_lcdc_data_t;
 
 /**
@@ -563,17 +567,14 @@ int ad_lcdc_set_external_clock(ad_lcdc_handle_t handle, bool enable)
         return AD_LCDC_ERROR_NONE;
 }
 
-int ad_lcdc_set_partial_update(ad_lcdc_handle_t handle, hw_lcdc_frame_t *frame)
+/**
+ * \brief Set the region of the screen updated by the next frames
+ *
+ * \param[in] lcdc              LCDC run time data
+ * \param[in,out] frame         Region dimensions, modified if not supported by the controller
+ */
+static void ad_lcdc_set_region(ad_lcdc_data_t *lcdc, hw_lcdc_frame_t *frame)
 {
-        ad_lcdc_data_t *lcdc = (ad_lcdc_data_t *)handle;
-
-        if (!AD_LCDC_HANDLE_IS_VALID(handle)) {
-                OS_ASSERT(0);
-                return AD_LCDC_ERROR_HANDLE_INVALID;
-        }
-
-        OS_MUTEX_GET(lcdc->busy, OS_MUTEX_FOREVER);
-
         hw_lcdc_set_update_region(frame);
 
         if (lcdc->conf->drv->hw_init.phy_type == HW_LCDC_PHY_MIPI_SPI3
@@ -591,6 +592,20 @@ int ad_lcdc_set_partial_update(ad_lcdc_handle_t handle, hw_lcdc_frame_t *frame)
                         hw_lcdc_mipi_set_position(frame);
                 }
         }
+}
+
+int ad_lcdc_set_partial_update(ad_lcdc_handle_t handle, hw_lcdc_frame_t *frame)
+{
+        ad_lcdc_data_t *lcdc = (ad_lcdc_data_t *)handle;
+
+        if (!AD_LCDC_HANDLE_IS_VALID(handle)) {
+                OS_ASSERT(0);
+                return AD_LCDC_ERROR_HANDLE_INVALID;
+        }
+
+        OS_MUTEX_GET(lcdc->busy, OS_MUTEX_FOREVER);
+
+        ad_lcdc_set_region(lcdc, frame);
 
         lcdc->data->frame_valid = !((frame->startx == 0) && (frame->starty == 0)
                 && (frame->endx == lcdc->conf->drv->display.resx - 1)
@@ -800,6 +815,161 @@ int ad_lcdc_draw_screen_async(ad_lcdc_handle_t handle, const hw_lcdc_layer_t *la
         return AD_LCDC_ERROR_NONE;
 }
 
+static void ad_lcdc_regions_send_next(ad_lcdc_data_t *lcdc);
+
+/**
+ * \brief Callback function, called when the transmission of a region is complete.
+ *
+ * \param[in] handle            Handle returned from ad_lcdc_open()
+ */
+static void ad_lcdc_regions_frame_callback(ad_lcdc_handle_t handle)
+{
+        ad_lcdc_data_t *lcdc = (ad_lcdc_data_t *)handle;
+        hw_lcdc_enable_vsync_irq(false);
+
+        ad_lcdc_regions_send_next(lcdc);
+}
+
+/**
+ * \brief Callback function, called on TE signal detection to initiate the regions transmission.
+ *
+ * \param[in] handle            Handle returned from ad_lcdc_open()
+ */
+static void ad_lcdc_regions_tearing_callback(ad_lcdc_handle_t handle)
+{
+        ad_lcdc_data_t *lcdc = (ad_lcdc_data_t *)handle;
+        hw_lcdc_enable_vsync_irq(false);
+        hw_lcdc_enable_tearing_effect_irq(false);
+        hw_lcdc_set_tearing_effect(false, lcdc->conf->drv->te_polarity);
+
+        ad_lcdc_regions_send_next(lcdc);
+}
+
+/**
+ * \brief Send the next region of the transfer in progress, or complete the transfer.
+ *
+ * Regions are sent back-to-back from the frame end interrupt, so with tearing effect enabled only
+ * the first one waits for the TE signal. When all regions are sent, the update region set with
+ * ad_lcdc_set_partial_update() is restored.
+ *
+ * \param[in] lcdc              LCDC run time data
+ */
+static void ad_lcdc_regions_send_next(ad_lcdc_data_t *lcdc)
+{
+        hw_lcdc_frame_t frame;
+        ad_lcdc_user_cb cb;
+        void *user_data;
+
+        if (lcdc->regions_idx < lcdc->regions_cnt) {
+                frame = lcdc->regions[lcdc->regions_idx++];
+                ad_lcdc_set_region(lcdc, &frame);
+                hw_lcdc_set_layer(true, &lcdc->regions_layer);
+                ad_lcdc_send_one_frame(ad_lcdc_regions_frame_callback, lcdc);
+                return;
+        }
+
+        if (lcdc->data->frame_valid) {
+                frame = lcdc->data->frame;
+        } else {
+                frame.startx = 0;
+                frame.starty = 0;
+                frame.endx = lcdc->conf->drv->display.resx - 1;
+                frame.endy = lcdc->conf->drv->display.resy - 1;
+        }
+        ad_lcdc_set_region(lcdc, &frame);
+
+        lcdc->regions = NULL;
+        cb = lcdc->callback;
+        user_data = lcdc->callback_data;
+        lcdc->callback = NULL;
+        lcdc->callback_data = NULL;
+
+        if (cb) {
+                cb(user_data);
+        } else {
+                OS_EVENT_SIGNAL_FROM_ISR(lcdc->event);
+        }
+}
+
+/**
+ * \brief Set up a regions transfer and start it or wait for the TE signal.
+ */
+static void ad_lcdc_regions_start(ad_lcdc_data_t *lcdc, const hw_lcdc_layer_t *layer,
+        const hw_lcdc_frame_t *regions, uint8_t count)
+{
+        lcdc->regions_layer = *layer;
+        lcdc->regions = regions;
+        lcdc->regions_cnt = count;
+        lcdc->regions_idx = 0;
+
+        if (lcdc->conf->drv->te_enable) {
+                ad_lcdc_enable_tearing(lcdc->conf->drv->te_polarity,
+                        ad_lcdc_regions_tearing_callback, lcdc);
+        }
+        else {
+                ad_lcdc_regions_send_next(lcdc);
+        }
+}
+
+int ad_lcdc_draw_regions(ad_lcdc_handle_t handle, const hw_lcdc_layer_t *layer,
+        const hw_lcdc_frame_t *regions, uint8_t count, OS_TICK_TIME timeout)
+{
+        ad_lcdc_data_t *lcdc = (ad_lcdc_data_t *)handle;
+        OS_BASE_TYPE ret;
+
+        if (!AD_LCDC_HANDLE_IS_VALID(handle)) {
+                OS_ASSERT(0);
+                return AD_LCDC_ERROR_HANDLE_INVALID;
+        }
+
+        if (count == 0) {
+                return AD_LCDC_ERROR_NONE;
+        }
+
+        OS_MUTEX_GET(lcdc->busy, OS_MUTEX_FOREVER);
+
+        lcdc->callback = NULL;
+        lcdc->callback_data = NULL;
+        ad_lcdc_regions_start(lcdc, layer, regions, count);
+
+        ret = OS_EVENT_WAIT(lcdc->event, timeout);
+
+        OS_MUTEX_PUT(lcdc->busy);
+
+        return ret == OS_EVENT_SIGNALED ? AD_LCDC_ERROR_NONE : AD_LCDC_ERROR_TIMEOUT;
+}
+
+int ad_lcdc_draw_regions_async(ad_lcdc_handle_t handle, const hw_lcdc_layer_t *layer,
+        const hw_lcdc_frame_t *regions, uint8_t count, ad_lcdc_user_cb cb, void *user_data)
+{
+        ad_lcdc_data_t *lcdc = (ad_lcdc_data_t *)handle;
+
+        if (!AD_LCDC_HANDLE_IS_VALID(handle)) {
+                OS_ASSERT(0);
+                return AD_LCDC_ERROR_HANDLE_INVALID;
+        }
+
+        /* A not NULL callback must be registered before starting a transaction */
+        OS_ASSERT(cb != NULL);
+        OS_ASSERT(count > 0);
+
+        OS_MUTEX_GET(lcdc->busy, OS_MUTEX_FOREVER);
+        /* Check if LCDC HW driver or a previous regions transfer is still in use */
+        if (hw_lcdc_is_busy() || lcdc->regions) {
+                OS_MUTEX_PUT(lcdc->busy);
+                OS_ASSERT(0);
+                return AD_LCDC_ERROR_CONTROLLER_BUSY;
+        }
+
+        lcdc->callback = cb;
+        lcdc->callback_data = user_data;
+        ad_lcdc_regions_start(lcdc, layer, regions, count);
+
+        OS_MUTEX_PUT(lcdc->busy);
+
+        return AD_LCDC_ERROR_NONE;
+}
+
 static void continuous_mode_callback(ad_lcdc_handle_t handle)
 {
         ad_lcdc_data_t *lcdc = (ad_lcdc_data_t *)handle;
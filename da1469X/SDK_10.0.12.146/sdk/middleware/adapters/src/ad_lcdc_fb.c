@@ -0,0 +1,306 @@
+/**
+ * \addtogroup MID_SYS_ADAPTERS
+ * \{
+ * \addtogroup LCDC_FB_ADAPTER
+ * \{
+ */
+
+/**
+ ****************************************************************************************
+ *
+ * @file ad_lcdc_fb.c
+ *
+ * @brief LCD frame buffer manager with dirty rectangle tracking
+ *
+ * Copyright (C) 2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ ****************************************************************************************
+ */
+
+#if dg_configLCDC_ADAPTER
+
+#include <string.h>
+#include "osal.h"
+#include "ad_lcdc_fb.h"
+
+static uint32_t rect_area(const hw_lcdc_frame_t *r)
+{
+        return (uint32_t)(r->endx - r->startx + 1) * (r->endy - r->starty + 1);
+}
+
+static uint32_t rect_overlap(const hw_lcdc_frame_t *a, const hw_lcdc_frame_t *b)
+{
+        hw_lcdc_frame_t o = {
+                .startx = MAX(a->startx, b->startx),
+                .starty = MAX(a->starty, b->starty),
+                .endx = MIN(a->endx, b->endx),
+                .endy = MIN(a->endy, b->endy),
+        };
+
+        if (o.startx > o.endx || o.starty > o.endy) {
+                return 0;
+        }
+
+        return rect_area(&o);
+}
+
+static hw_lcdc_frame_t rect_union(const hw_lcdc_frame_t *a, const hw_lcdc_frame_t *b)
+{
+        hw_lcdc_frame_t u = {
+                .startx = MIN(a->startx, b->startx),
+                .starty = MIN(a->starty, b->starty),
+                .endx = MAX(a->endx, b->endx),
+                .endy = MAX(a->endy, b->endy),
+        };
+
+        return u;
+}
+
+/*
+ * Pixels transferred in excess when a and b are replaced by their bounding box, minus the cost
+ * of the transfer saved. Negative or zero means that merging is profitable.
+ */
+static int32_t merge_overhead(const hw_lcdc_frame_t *a, const hw_lcdc_frame_t *b)
+{
+        hw_lcdc_frame_t u = rect_union(a, b);
+
+        return (int32_t)(rect_area(&u) + rect_overlap(a, b) - rect_area(a) - rect_area(b)) -
+               dg_configLCDC_FB_MERGE_COST;
+}
+
+static void ad_lcdc_fb_remove(ad_lcdc_fb_t *fb, uint8_t i)
+{
+        fb->dirty[i] = fb->dirty[--fb->dirty_cnt];
+}
+
+static void ad_lcdc_fb_add(ad_lcdc_fb_t *fb, hw_lcdc_frame_t r)
+{
+        uint8_t i, best;
+        int32_t overhead, best_overhead;
+
+again:
+        for (i = 0; i < fb->dirty_cnt; i++) {
+                if (merge_overhead(&fb->dirty[i], &r) <= 0) {
+                        r = rect_union(&fb->dirty[i], &r);
+                        ad_lcdc_fb_remove(fb, i);
+                        /* The bigger rectangle may now be worth merging with another one */
+                        goto again;
+                }
+        }
+
+        if (fb->dirty_cnt == dg_configLCDC_FB_MAX_RECTS) {
+                best = 0;
+                best_overhead = INT32_MAX;
+                for (i = 0; i < fb->dirty_cnt; i++) {
+                        overhead = merge_overhead(&fb->dirty[i], &r);
+                        if (overhead < best_overhead) {
+                                best_overhead = overhead;
+                                best = i;
+                        }
+                }
+                r = rect_union(&fb->dirty[best], &r);
+                ad_lcdc_fb_remove(fb, best);
+                goto again;
+        }
+
+        fb->dirty[fb->dirty_cnt++] = r;
+}
+
+/* Byte offset of pixel x in a line, x is aligned to a byte for formats smaller than a byte */
+static uint32_t ad_lcdc_fb_line_offset(const ad_lcdc_fb_t *fb, uint16_t x)
+{
+        return hw_lcdc_stride_size(fb->cfg.layer.format, x);
+}
+
+static uint32_t ad_lcdc_fb_stride(const ad_lcdc_fb_t *fb)
+{
+        if (fb->cfg.layer.stride) {
+                return fb->cfg.layer.stride;
+        }
+
+        return hw_lcdc_stride_size(fb->cfg.layer.format, fb->cfg.layer.resx);
+}
+
+static uint32_t ad_lcdc_fb_baseaddr(const ad_lcdc_fb_t *fb, uint8_t index)
+{
+        return index ? fb->cfg.back_baseaddr : fb->cfg.layer.baseaddr;
+}
+
+/* Copy the regions just transferred from the displayed buffer to the one drawn next */
+static void ad_lcdc_fb_sync(ad_lcdc_fb_t *fb)
+{
+        const uint32_t stride = ad_lcdc_fb_stride(fb);
+        const uint8_t *src = (const uint8_t *)ad_lcdc_fb_baseaddr(fb, !fb->draw);
+        uint8_t *dst = (uint8_t *)ad_lcdc_fb_baseaddr(fb, fb->draw);
+        uint8_t i;
+        uint16_t y;
+
+        for (i = 0; i < fb->flush_cnt; i++) {
+                const hw_lcdc_frame_t *r = &fb->flush[i];
+                const uint32_t offset = ad_lcdc_fb_line_offset(fb, r->startx);
+                const uint32_t len = ad_lcdc_fb_line_offset(fb, r->endx + 1) - offset;
+
+                for (y = r->starty; y <= r->endy; y++) {
+                        memcpy(&dst[y * stride + offset], &src[y * stride + offset], len);
+                }
+        }
+}
+
+static void ad_lcdc_fb_done(void *user_data)
+{
+        ad_lcdc_fb_t *fb = user_data;
+        ad_lcdc_user_cb cb = fb->cb;
+
+        fb->busy = false;
+        OS_EVENT_SIGNAL_FROM_ISR(fb->done);
+
+        if (cb) {
+                cb(fb->user_data);
+        }
+}
+
+int ad_lcdc_fb_init(ad_lcdc_fb_t *fb, ad_lcdc_handle_t handle, const ad_lcdc_fb_config_t *cfg)
+{
+        if (!handle || !cfg || !cfg->layer.resx || !cfg->layer.resy) {
+                OS_ASSERT(0);
+                return AD_LCDC_ERROR_DRIVER_CONF_INVALID;
+        }
+
+        memset(fb, 0, sizeof(*fb));
+        fb->handle = handle;
+        fb->cfg = *cfg;
+        OS_EVENT_CREATE(fb->done);
+        OS_ASSERT(fb->done);
+
+        ad_lcdc_fb_invalidate_all(fb);
+
+        return AD_LCDC_ERROR_NONE;
+}
+
+void ad_lcdc_fb_deinit(ad_lcdc_fb_t *fb)
+{
+        ad_lcdc_fb_wait(fb, OS_EVENT_FOREVER);
+        OS_EVENT_DELETE(fb->done);
+}
+
+uint8_t *ad_lcdc_fb_get_buffer(ad_lcdc_fb_t *fb)
+{
+        return (uint8_t *)ad_lcdc_fb_baseaddr(fb, fb->draw);
+}
+
+void ad_lcdc_fb_invalidate(ad_lcdc_fb_t *fb, const hw_lcdc_frame_t *rect)
+{
+        hw_lcdc_frame_t r = *rect;
+
+        if (r.startx > r.endx || r.starty > r.endy ||
+            r.startx >= fb->cfg.layer.resx || r.starty >= fb->cfg.layer.resy) {
+                return;
+        }
+        r.endx = MIN(r.endx, fb->cfg.layer.resx - 1);
+        r.endy = MIN(r.endy, fb->cfg.layer.resy - 1);
+
+        if (fb->cfg.full_lines) {
+                r.startx = 0;
+                r.endx = fb->cfg.layer.resx - 1;
+        } else if (fb->cfg.layer.format == HW_LCDC_LCM_L1 ||
+                   fb->cfg.layer.format == HW_LCDC_LCM_L4) {
+                /* Keep regions byte aligned, so that they can be copied between buffers */
+                const uint16_t ppb = (fb->cfg.layer.format == HW_LCDC_LCM_L1) ? 8 : 2;
+
+                r.startx -= r.startx % ppb;
+                r.endx = MIN(r.endx | (ppb - 1), fb->cfg.layer.resx - 1);
+        }
+
+        ad_lcdc_fb_add(fb, r);
+}
+
+void ad_lcdc_fb_invalidate_all(ad_lcdc_fb_t *fb)
+{
+        const hw_lcdc_frame_t r = {
+                .startx = 0,
+                .starty = 0,
+                .endx = fb->cfg.layer.resx - 1,
+                .endy = fb->cfg.layer.resy - 1,
+        };
+
+        fb->dirty_cnt = 0;
+        ad_lcdc_fb_add(fb, r);
+}
+
+int ad_lcdc_fb_wait(ad_lcdc_fb_t *fb, OS_TICK_TIME timeout)
+{
+        while (fb->busy) {
+                if (OS_EVENT_WAIT(fb->done, timeout) != OS_EVENT_SIGNALED) {
+                        return fb->busy ? AD_LCDC_ERROR_TIMEOUT : AD_LCDC_ERROR_NONE;
+                }
+        }
+
+        return AD_LCDC_ERROR_NONE;
+}
+
+int ad_lcdc_fb_flush_async(ad_lcdc_fb_t *fb, ad_lcdc_user_cb cb, void *user_data)
+{
+        hw_lcdc_layer_t layer = fb->cfg.layer;
+        uint8_t i;
+        int ret;
+
+        /* The buffer of the previous transfer is the one drawn next with double buffering */
+        ad_lcdc_fb_wait(fb, OS_EVENT_FOREVER);
+
+        if (fb->dirty_cnt == 0) {
+                if (cb) {
+                        cb(user_data);
+                }
+                return AD_LCDC_ERROR_NONE;
+        }
+
+        memcpy(fb->flush, fb->dirty, fb->dirty_cnt * sizeof(fb->dirty[0]));
+        fb->flush_cnt = fb->dirty_cnt;
+        fb->dirty_cnt = 0;
+
+        fb->frames++;
+        fb->regions += fb->flush_cnt;
+        for (i = 0; i < fb->flush_cnt; i++) {
+                fb->pixels += rect_area(&fb->flush[i]);
+        }
+
+        layer.baseaddr = ad_lcdc_fb_baseaddr(fb, fb->draw);
+        fb->cb = cb;
+        fb->user_data = user_data;
+        fb->busy = true;
+
+        ret = ad_lcdc_draw_regions_async(fb->handle, &layer, fb->flush, fb->flush_cnt,
+                                         ad_lcdc_fb_done, fb);
+        if (ret != AD_LCDC_ERROR_NONE) {
+                fb->busy = false;
+                return ret;
+        }
+
+        if (fb->cfg.back_baseaddr) {
+                /* Reading the displayed buffer while it is being transferred is safe */
+                fb->draw = !fb->draw;
+                ad_lcdc_fb_sync(fb);
+        }
+
+        return AD_LCDC_ERROR_NONE;
+}
+
+int ad_lcdc_fb_flush(ad_lcdc_fb_t *fb, OS_TICK_TIME timeout)
+{
+        int ret = ad_lcdc_fb_flush_async(fb, NULL, NULL);
+
+        if (ret != AD_LCDC_ERROR_NONE) {
+                return ret;
+        }
+
+        return ad_lcdc_fb_wait(fb, timeout);
+}
+
+#endif /* dg_configLCDC_ADAPTER */
+
+/**
+ * \}
+ * \}
+ */
@@ -51,6 +51,10 @@ typedef struct ad_sdadc_data {
         OS_MUTEX                        busy;                   /**< Semaphore for thread safety */
         bool                            read_in_progress;       /**< Controller is busy reading */
         ad_sdadc_use_input_t            using;                  /**<Flags indicating if input channels are used */
+#if dg_configSDADC_STREAM
+        volatile bool                   streaming;              /**< Continuous sampling to DMA is running */
+        ad_sdadc_stream_conf_t          stream;                 /**< Configuration of the running stream */
+#endif
 } ad_sdadc_data;
 
 __RETAINED static ad_sdadc_data dynamic_data;
@@ -224,6 +228,12 @@ int ad_sdadc_reconfig(ad_sdadc_handle_t handle, const ad_sdadc_driver_conf_t *dr
                 ret = AD_SDADC_ERROR_READ_IN_PROGRESS;
                 goto out_of_here;
         }
+#if dg_configSDADC_STREAM
+        if (dynamic_data.streaming) {
+                ret = AD_SDADC_ERROR_READ_IN_PROGRESS;
+                goto out_of_here;
+        }
+#endif
 
         if (dynamic_data.current_drv->input_mode != drv->input_mode) {
                 /* use ad_sdadc_open instead */
@@ -295,6 +305,10 @@ ad_sdadc_handle_t ad_sdadc_open(const ad_sdadc_controller_conf_t *conf)
         return dynamic_data.handle;
 }
 
+#if dg_configSDADC_STREAM
+static void ad_sdadc_stream_halt(void);
+#endif
+
 int ad_sdadc_close(ad_sdadc_handle_t handle, bool forced)
 {
         int off_configuration_valid;
@@ -304,6 +318,15 @@ int ad_sdadc_close(ad_sdadc_handle_t handle, bool forced)
                 return AD_SDADC_ERROR_HANDLE_INVALID;
         }
 
+#if dg_configSDADC_STREAM
+        if (dynamic_data.streaming) {
+                if (!forced) {
+                        return AD_SDADC_ERROR_READ_IN_PROGRESS;
+                }
+                ad_sdadc_stream_halt();
+        }
+#endif
+
         OS_ENTER_CRITICAL_SECTION();
 
         if (dynamic_data.read_in_progress) {
@@ -367,6 +390,12 @@ int ad_sdadc_read_async(ad_sdadc_handle_t handle, ad_sdadc_user_cb cb, void *use
                 OS_MUTEX_PUT(dynamic_data.busy);
                 return AD_SDADC_ERROR_READ_IN_PROGRESS;
         }
+#if dg_configSDADC_STREAM
+        if (dynamic_data.streaming) {
+                OS_MUTEX_PUT(dynamic_data.busy);
+                return AD_SDADC_ERROR_READ_IN_PROGRESS;
+        }
+#endif
         dynamic_data.read_cb = cb;
         dynamic_data.user_data = user_data;
         dynamic_data.read_in_progress = true;
@@ -395,6 +424,12 @@ int ad_sdadc_read(ad_sdadc_handle_t handle, int32_t *value)
                 OS_MUTEX_PUT(dynamic_data.busy);
                 return AD_SDADC_ERROR_READ_IN_PROGRESS;
         }
+#if dg_configSDADC_STREAM
+        if (dynamic_data.streaming) {
+                OS_MUTEX_PUT(dynamic_data.busy);
+                return AD_SDADC_ERROR_READ_IN_PROGRESS;
+        }
+#endif
         dynamic_data.read_in_progress = true;
         hw_sdadc_unregister_interrupt();
         *value = hw_sdadc_get_voltage(dynamic_data.current_drv);
@@ -405,6 +440,155 @@ int ad_sdadc_read(ad_sdadc_handle_t handle, int32_t *value)
         return AD_SDADC_ERROR_NONE;
 }
 
+#if dg_configSDADC_STREAM
+/* Average every n results in place, returns the number of averages */
+static uint16_t ad_sdadc_stream_decimate(uint16_t *samples, uint16_t len, uint8_t n, bool is_signed)
+{
+        uint16_t i, j, cnt = 0;
+        int32_t sum;
+
+        for (i = 0; i < len; i += n) {
+                sum = 0;
+                for (j = 0; j < n; j++) {
+                        sum += is_signed ? (int16_t) samples[i + j] : samples[i + j];
+                }
+                samples[cnt++] = (uint16_t) (sum / n);
+        }
+
+        return cnt;
+}
+
+static void ad_sdadc_stream_dma_cb(void *user_data, dma_size_t len)
+{
+        ad_sdadc_stream_conf_t *stream = &dynamic_data.stream;
+        uint16_t *samples;
+        uint16_t count = stream->block_len;
+
+        /* Also called by hw_dma_channel_stop() */
+        if (!dynamic_data.streaming) {
+                return;
+        }
+
+        /* Interrupt alternately when the first and the second half of the buffer is full */
+        if (len <= stream->block_len) {
+                samples = stream->buffer;
+                hw_dma_channel_update_int_ix(stream->dma_channel, 2 * stream->block_len - 1);
+        } else {
+                samples = stream->buffer + stream->block_len;
+                hw_dma_channel_update_int_ix(stream->dma_channel, stream->block_len - 1);
+        }
+
+        if (stream->decimation > 1) {
+                count = ad_sdadc_stream_decimate(samples, count, stream->decimation,
+                        dynamic_data.current_drv->input_mode == HW_SDADC_INPUT_MODE_DIFFERENTIAL);
+        }
+
+        stream->cb(stream->user_data, samples, count);
+}
+
+int ad_sdadc_stream_start(ad_sdadc_handle_t handle, const ad_sdadc_stream_conf_t *conf)
+{
+        DMA_setup dma;
+
+        if (AD_SDADC_HANDLE_IS_INVALID(handle)) {
+                OS_ASSERT(0);
+                return AD_SDADC_ERROR_HANDLE_INVALID;
+        }
+
+        if (!conf || !conf->buffer || !conf->cb || conf->block_len == 0 ||
+            conf->dma_channel >= HW_DMA_CHANNEL_INVALID || !(conf->dma_channel & 1) ||
+            (conf->block_len % MAX(conf->decimation, 1))) {
+                return AD_SDADC_ERROR_DRIVER_CONF_INVALID;
+        }
+
+        OS_MUTEX_GET(dynamic_data.busy, OS_MUTEX_FOREVER);
+
+        if (dynamic_data.read_in_progress || dynamic_data.streaming || hw_sdadc_in_progress()) {
+                OS_MUTEX_PUT(dynamic_data.busy);
+                return AD_SDADC_ERROR_READ_IN_PROGRESS;
+        }
+
+        resource_acquire(RES_MASK(RES_ID_DMA_CH0 + conf->dma_channel), RES_WAIT_FOREVER);
+        /* The DMA and the ADC must keep running, allow only idle (WFI) until stopped */
+        pm_sleep_mode_request(pm_mode_idle);
+
+        dynamic_data.stream = *conf;
+        dynamic_data.streaming = true;
+
+        dma.channel_number = conf->dma_channel;
+        dma.bus_width = HW_DMA_BW_HALFWORD;
+        dma.irq_enable = HW_DMA_IRQ_STATE_ENABLED;
+        dma.irq_nr_of_trans = conf->block_len;
+        dma.dreq_mode = HW_DMA_DREQ_TRIGGERED;
+        dma.burst_mode = HW_DMA_BURST_MODE_DISABLED;
+        dma.a_inc = HW_DMA_AINC_FALSE;
+        dma.b_inc = HW_DMA_BINC_TRUE;
+        dma.circular = HW_DMA_MODE_CIRCULAR;
+        dma.dma_prio = conf->dma_prio;
+        dma.dma_idle = HW_DMA_IDLE_INTERRUPTING_MODE;
+        dma.dma_init = HW_DMA_INIT_AX_BX_AY_BY;
+        dma.dma_req_mux = HW_DMA_TRIG_ADC;
+        dma.src_address = (uint32_t) &SDADC->SDADC_RESULT_REG;
+        dma.dest_address = (uint32_t) conf->buffer;
+        dma.length = 2 * conf->block_len;
+        dma.callback = ad_sdadc_stream_dma_cb;
+        dma.user_data = NULL;
+
+        /* The results are collected by the DMA, no interrupt per conversion */
+        hw_sdadc_unregister_interrupt();
+        hw_sdadc_clear_interrupt();
+        hw_sdadc_set_dma_functionality(true);
+        hw_dma_channel_initialization(&dma);
+        hw_dma_channel_enable(conf->dma_channel, HW_DMA_STATE_ENABLED);
+
+        hw_sdadc_set_continuous(true);
+        hw_sdadc_start();
+
+        OS_MUTEX_PUT(dynamic_data.busy);
+
+        return AD_SDADC_ERROR_NONE;
+}
+
+static void ad_sdadc_stream_halt(void)
+{
+        const HW_DMA_CHANNEL channel = dynamic_data.stream.dma_channel;
+
+        dynamic_data.streaming = false;
+
+        hw_sdadc_set_continuous(false);
+        while (hw_sdadc_in_progress());
+        hw_sdadc_set_dma_functionality(false);
+        hw_dma_channel_stop(channel);
+        hw_sdadc_clear_interrupt();
+        hw_sdadc_set_continuous(dynamic_data.current_drv->continuous);
+
+        pm_sleep_mode_release(pm_mode_idle);
+        resource_release(RES_MASK(RES_ID_DMA_CH0 + channel));
+}
+
+int ad_sdadc_stream_stop(ad_sdadc_handle_t handle)
+{
+        int ret = AD_SDADC_ERROR_NONE;
+
+        if (AD_SDADC_HANDLE_IS_INVALID(handle)) {
+                OS_ASSERT(0);
+                return AD_SDADC_ERROR_HANDLE_INVALID;
+        }
+
+        OS_MUTEX_GET(dynamic_data.busy, OS_MUTEX_FOREVER);
+
+        if (dynamic_data.streaming) {
+                ad_sdadc_stream_halt();
+        } else {
+                ret = AD_SDADC_ERROR_DRIVER_UNINITIALIZED;
+        }
+
+        OS_MUTEX_PUT(dynamic_data.busy);
+
+        return ret;
+}
+#endif /* dg_configSDADC_STREAM */
+
 ADAPTER_INIT(ad_sdadc_adapter, ad_sdadc_init);
 
 #endif /* dg_configSDADC_ADAPTER */
@@ -1404,6 +1404,42 @@ uint32_t ad_snc_queue_get_cur_chunk_bytes(uint32_t ucode_id, AD_SNC_QUEUE_TYPE q
 
         return rtn;
 }
+
+uint32_t ad_snc_queue_peek(uint32_t ucode_id, uint32_t max_chunks, snc_queue_peek_t *peek)
+{
+        uint32_t rtn = 0;
+
+        // Acquire control over uCode SNC-to-CM33 queue
+        snc_queue_t sncQ = ad_snc_queue_acquire(ucode_id, AD_SNC_QUEUE_TYPE_SNC_CM33);
+
+        if (sncQ) {
+                rtn = snc_queues_cm33_peek(sncQ, max_chunks, peek);
+
+                // Release control over uCode queue
+                ad_snc_queue_release(ucode_id);
+        }
+
+        return rtn;
+}
+
+bool ad_snc_queue_consume(uint32_t ucode_id, uint32_t num_of_chunks)
+{
+        bool rtn = false;
+
+        // Acquire control over uCode SNC-to-CM33 queue
+        snc_queue_t sncQ = ad_snc_queue_acquire(ucode_id, AD_SNC_QUEUE_TYPE_SNC_CM33);
+
+        if (sncQ) {
+                snc_queues_cm33_consume(sncQ, num_of_chunks);
+
+                // Release control over uCode queue
+                ad_snc_queue_release(ucode_id);
+
+                rtn = true;
+        }
+
+        return rtn;
+}
 #endif /* dg_configUSE_SNC_QUEUES */
 
 #if dg_configUSE_HW_TIMER
@@ -37,6 +37,7 @@
 #include <stdarg.h>
 #include "ad_spi.h"
 #include "hw_spi.h"
+#include "hw_clk.h"
 #include "platform_devices.h"
 #include "resmgmt.h"
 
@@ -48,6 +49,13 @@ typedef struct {
         OS_TASK  owner; /**< The task which opened the controller */
         OS_EVENT event; /**< Semaphore for async calls  */
         OS_MUTEX busy;  /**< Semaphore for thread safety */
+#if CONFIG_SPI_USE_TRANSACTION_LIST
+        const ad_spi_transaction_t *list;       /**< Next action of the running transaction list */
+        size_t list_count;                      /**< Number of actions left */
+        uint32_t list_transferred;              /**< Bytes transferred by the list so far */
+        ad_spi_user_cb list_cb;                 /**< Callback to call when the list is over */
+        void *list_user_data;                   /**< User data passed to list_cb */
+#endif /* CONFIG_SPI_USE_TRANSACTION_LIST */
 } ad_spi_data_t;
 
 __RETAINED static ad_spi_data_t spi1_data;
@@ -516,6 +524,145 @@ int ad_spi_write_read_async(ad_spi_handle_t handle, const uint8_t *wbuf, size_t
 }
 #endif /* CONFIG_SPI_USE_ASYNC_TRANSACTIONS */
 
+#if CONFIG_SPI_USE_TRANSACTION_LIST
+
+static void ad_spi_list_do(ad_spi_data_t *spi);
+
+/*
+ * Callback passed to low level driver, invoked after each transfer of the list.
+ */
+static void ad_spi_list_cb(void *user_data, uint16_t transferred)
+{
+        ad_spi_data_t *spi = (ad_spi_data_t *) user_data;
+
+        spi->list_transferred += transferred;
+        ad_spi_list_do(spi);
+}
+
+/*
+ * This function executes actions until a transfer is started or the list is over. The rest of
+ * the list is executed from the transfer completion interrupt. The low level driver releases the
+ * controller before calling the completion callback, so the next transfer can be started from
+ * there right away.
+ */
+static void ad_spi_list_do(ad_spi_data_t *spi)
+{
+        const HW_SPI_ID id = spi->conf->id;
+        const ad_spi_transaction_t *t;
+        ad_spi_user_cb cb;
+        void *user_data;
+
+        while (spi->list_count) {
+                t = spi->list++;
+                spi->list_count--;
+
+                switch (t->action) {
+                case AD_SPI_ACTION_CS_ACTIVATE:
+                        ad_spi_activate_cs(spi);
+                        break;
+                case AD_SPI_ACTION_CS_DEACTIVATE:
+                        ad_spi_deactivate_cs_when_spi_done(spi);
+                        break;
+                case AD_SPI_ACTION_SEND:
+                        /* Same as ad_spi_write(), completes when the last byte is on the bus */
+                        hw_spi_writeread_buf(id, t->wbuf, NULL, t->len, ad_spi_list_cb, spi);
+                        return;
+                case AD_SPI_ACTION_RECEIVE:
+                        hw_spi_read_buf(id, t->rbuf, t->len, ad_spi_list_cb, spi);
+                        return;
+                case AD_SPI_ACTION_SEND_RECEIVE:
+                        hw_spi_writeread_buf(id, t->wbuf, t->rbuf, t->len, ad_spi_list_cb, spi);
+                        return;
+                case AD_SPI_ACTION_DELAY:
+                        hw_clk_delay_usec(t->len);
+                        break;
+                default:
+                        OS_ASSERT(0);
+                }
+        }
+
+        /* List is over, a new one can be started from the callback */
+        cb = spi->list_cb;
+        user_data = spi->list_user_data;
+        spi->list = NULL;
+        cb(user_data, (uint16_t) MIN(spi->list_transferred, UINT16_MAX));
+}
+
+static void ad_spi_list_start(ad_spi_data_t *spi, const ad_spi_transaction_t *list, size_t count,
+                                                        ad_spi_user_cb cb, void *user_data)
+{
+        spi->list = list;
+        spi->list_count = count;
+        spi->list_transferred = 0;
+        spi->list_cb = cb;
+        spi->list_user_data = user_data;
+
+        ad_spi_list_do(spi);
+}
+
+static void ad_spi_list_wait_event(void *p, uint16_t transferred)
+{
+        ad_spi_data_t *spi = (ad_spi_data_t *) p;
+
+        /* List without transfers completes in the calling task */
+        if (in_interrupt()) {
+                OS_EVENT_SIGNAL_FROM_ISR(spi->event);
+        } else {
+                OS_EVENT_SIGNAL(spi->event);
+        }
+}
+
+int ad_spi_transact(ad_spi_handle_t handle, const ad_spi_transaction_t *list, size_t count)
+{
+        ad_spi_data_t *spi = (ad_spi_data_t *) handle;
+
+        if (!AD_SPI_HANDLE_IS_VALID(handle)) {
+                OS_ASSERT(0);
+                return AD_SPI_ERROR_HANDLE_INVALID;
+        }
+
+        const HW_SPI_ID id = spi->conf->id;
+
+        OS_MUTEX_GET(spi->busy, OS_MUTEX_FOREVER);
+
+        if (hw_spi_is_occupied(id)) {
+                OS_MUTEX_PUT(spi->busy);
+                return AD_SPI_ERROR_TRANSF_IN_PROGRESS;
+        }
+
+        ad_spi_list_start(spi, list, count, ad_spi_list_wait_event, spi);
+
+        OS_EVENT_WAIT(spi->event, OS_EVENT_FOREVER);
+
+        OS_MUTEX_PUT(spi->busy);
+        return AD_SPI_ERROR_NONE;
+}
+
+int ad_spi_transact_async(ad_spi_handle_t handle, const ad_spi_transaction_t *list, size_t count,
+                                                        ad_spi_user_cb cb, void *user_data)
+{
+        ad_spi_data_t *spi = (ad_spi_data_t *) handle;
+
+        if (!AD_SPI_HANDLE_IS_VALID(handle)) {
+                OS_ASSERT(0);
+                return AD_SPI_ERROR_HANDLE_INVALID;
+        }
+
+        const HW_SPI_ID id = spi->conf->id;
+
+        OS_MUTEX_GET(spi->busy, OS_MUTEX_FOREVER);
+
+        if (hw_spi_is_occupied(id)) {
+                OS_MUTEX_PUT(spi->busy);
+                return AD_SPI_ERROR_TRANSF_IN_PROGRESS;
+        }
+
+        ad_spi_list_start(spi, list, count, cb, user_data);
+        OS_MUTEX_PUT(spi->busy);
+        return AD_SPI_ERROR_NONE;
+}
+#endif /* CONFIG_SPI_USE_TRANSACTION_LIST */
+
 int ad_spi_io_config(HW_SPI_ID id, const ad_spi_io_conf_t *io, AD_IO_CONF_STATE state)
 {
         /* SPI clk should be at least configured*/
@@ -594,6 +594,8 @@ int ad_uart_complete_async_read(ad_uart_handle_t handle)
 
 #if dg_configUART_RX_CIRCULAR_DMA
         if (ad_uart_data->use_rx_circular_dma) {
+                /* Ends also a pending ad_uart_rx_ring_notify() */
+                hw_uart_rx_circular_dma_notify_cancel(id);
                 return hw_uart_copy_dma_rx_to_user_buffer(id);
         }
 #endif
@@ -736,6 +738,111 @@ int ad_uart_read_async(ad_uart_handle_t handle, char *rbuf, size_t rlen, ad_uart
         }
 }
 
+#if dg_configUART_RX_CIRCULAR_DMA
+int ad_uart_read_available(ad_uart_handle_t handle, char *rbuf, size_t rlen, OS_TICK_TIME timeout)
+{
+        OS_ASSERT(AD_UART_HANDLE_IS_VALID(handle));
+
+        ad_uart_data_t *ad_uart_data = (ad_uart_data_t *)handle;
+        HW_UART_ID id = ad_uart_data->ctrl->id;
+        ad_uart_cb_data_t cb_data = {ad_uart_data, 0};
+        uint16_t len;
+
+        if (!ad_uart_data->use_rx_circular_dma) {
+                return AD_UART_ERROR_CONTROLLER_CONF_INVALID;
+        }
+
+        ad_uart_res_acquire(handle, AD_UART_RES_TYPE_READ, RES_WAIT_FOREVER);
+
+        /* Check ad_uart_close() for being faster */
+        if (!ad_uart_data->open_count) {
+                OS_ASSERT(0);
+                ad_uart_res_release(handle, AD_UART_RES_TYPE_READ);
+                return AD_UART_ERROR_DEVICE_CLOSED;
+        }
+
+        if (timeout && (hw_uart_rx_circular_dma_available(id) == 0)) {
+                /* Clear out an event left by a previous timed out wait */
+                OS_EVENT_CHECK(ad_uart_data->event_read);
+
+                hw_uart_rx_circular_dma_notify(id, rlen, ad_uart_signal_event_read, &cb_data);
+                OS_EVENT_WAIT(ad_uart_data->event_read, timeout);
+                hw_uart_rx_circular_dma_notify_cancel(id);
+        }
+
+        len = MIN(rlen, hw_uart_rx_circular_dma_available(id));
+        hw_uart_copy_rx_circular_dma_buffer(id, (uint8_t *) rbuf, len);
+
+        ad_uart_res_release(handle, AD_UART_RES_TYPE_READ);
+
+        return len;
+}
+
+static void ad_uart_signal_event_rx_ring(void *args, uint16_t available)
+{
+        ad_uart_data_t *ad_uart_data = (ad_uart_data_t *) args;
+
+        if (ad_uart_data->read_cb) {
+                ad_uart_data->read_cb(ad_uart_data->read_cb_data, available);
+        }
+        ad_uart_res_release(ad_uart_data, AD_UART_RES_TYPE_READ);
+}
+
+int ad_uart_rx_ring_notify(ad_uart_handle_t handle, uint16_t threshold, ad_uart_user_cb cb,
+                           void *user_data)
+{
+        OS_ASSERT(AD_UART_HANDLE_IS_VALID(handle));
+
+        ad_uart_data_t *ad_uart_data = (ad_uart_data_t *)handle;
+        HW_UART_ID id = ad_uart_data->ctrl->id;
+
+        if (!ad_uart_data->use_rx_circular_dma) {
+                return AD_UART_ERROR_CONTROLLER_CONF_INVALID;
+        }
+
+        if (!ad_uart_res_acquire(handle, AD_UART_RES_TYPE_READ, 0)) {
+
+                /* Check ad_uart_close() for being faster */
+                if (!ad_uart_data->open_count) {
+                        OS_ASSERT(0);
+                        ad_uart_res_release(handle, AD_UART_RES_TYPE_READ);
+                        return AD_UART_ERROR_DEVICE_CLOSED;
+                }
+
+                ad_uart_data->read_cb = cb;
+                ad_uart_data->read_cb_data = user_data;
+
+                hw_uart_rx_circular_dma_notify(id, threshold, ad_uart_signal_event_rx_ring, ad_uart_data);
+
+                return AD_UART_ERROR_NONE;
+        } else {
+                return AD_UART_ERROR_RESOURCE_NOT_AVAILABLE;
+        }
+}
+
+uint16_t ad_uart_rx_ring_peek(ad_uart_handle_t handle, const uint8_t **data)
+{
+        OS_ASSERT(AD_UART_HANDLE_IS_VALID(handle));
+
+        ad_uart_data_t *ad_uart_data = (ad_uart_data_t *)handle;
+
+        OS_ASSERT(ad_uart_data->use_rx_circular_dma);
+
+        return hw_uart_rx_circular_dma_peek(ad_uart_data->ctrl->id, data);
+}
+
+void ad_uart_rx_ring_consume(ad_uart_handle_t handle, uint16_t len)
+{
+        OS_ASSERT(AD_UART_HANDLE_IS_VALID(handle));
+
+        ad_uart_data_t *ad_uart_data = (ad_uart_data_t *)handle;
+
+        OS_ASSERT(ad_uart_data->use_rx_circular_dma);
+
+        hw_uart_rx_circular_dma_consume(ad_uart_data->ctrl->id, len);
+}
+#endif /* dg_configUART_RX_CIRCULAR_DMA */
+
 HW_UART_ID ad_uart_get_hw_uart_id(ad_uart_handle_t handle)
 {
         OS_ASSERT(AD_UART_HANDLE_IS_VALID(handle));
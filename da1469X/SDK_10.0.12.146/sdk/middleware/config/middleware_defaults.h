@@ -94,6 +94,16 @@
 #define dg_configSDADC_ADAPTER                  (0)
 #endif
 
+/* Continuous GPADC sampling to a DMA double buffer (ad_gpadc_stream_start()) */
+#ifndef dg_configGPADC_STREAM
+#define dg_configGPADC_STREAM                   (0)
+#endif
+
+/* Continuous SDADC sampling to a DMA double buffer (ad_sdadc_stream_start()) */
+#ifndef dg_configSDADC_STREAM
+#define dg_configSDADC_STREAM                   (0)
+#endif
+
 #ifdef dg_configTEMPSENS_ADAPTER
 #error "Configuration option dg_configTEMPSENS_ADAPTER  is no longer supported"
 #endif
@@ -122,6 +132,20 @@
 #define dg_configSYS_AUDIO_MGR                  (0)
 #endif
 
+#ifndef dg_configSYS_AUDIO_SW_SRC
+#define dg_configSYS_AUDIO_SW_SRC               (0)
+#endif
+
+/* Taps per polyphase branch for each step of the larger of the up/down factors */
+#ifndef dg_configSYS_AUDIO_SW_SRC_TAPS
+#define dg_configSYS_AUDIO_SW_SRC_TAPS          (24)
+#endif
+
+/* Largest up/down factor, 6 covers 8 kHz <-> 48 kHz */
+#ifndef dg_configSYS_AUDIO_SW_SRC_MAX_RATIO
+#define dg_configSYS_AUDIO_SW_SRC_MAX_RATIO     (6)
+#endif
+
 
 #ifndef dg_configSNC_ADAPTER
 #define dg_configSNC_ADAPTER                    (0)
@@ -139,6 +163,16 @@
 #define dg_configLCDC_ADAPTER                   (0)
 #endif
 
+/* Dirty rectangles tracked per frame by the LCDC frame buffer manager (ad_lcdc_fb.h) */
+#ifndef dg_configLCDC_FB_MAX_RECTS
+#define dg_configLCDC_FB_MAX_RECTS              (8)
+#endif
+
+/* Cost of one partial update transfer in pixels, dirty rectangles are merged below this cost */
+#ifndef dg_configLCDC_FB_MERGE_COST
+#define dg_configLCDC_FB_MERGE_COST             (1024)
+#endif
+
 #ifndef dg_configPMU_ADAPTER
 #define dg_configPMU_ADAPTER                    (1)
 #endif
@@ -242,6 +276,31 @@
 #define dg_configENABLE_TASK_MONITORING         (0)
 #endif
 
+/**
+ * \brief Enable the run-time task profiler
+ *
+ * Streams per-task CPU time, interrupt time, queue latency histograms and sleep statistics over
+ * SEGGER RTT, see sdk/middleware/monitoring/task_profiler.h.
+ *
+ * \note Cannot be enabled together with dg_configSYSTEMVIEW
+ * \bsp_default_note{\bsp_config_option_app,}
+ */
+#ifndef dg_configENABLE_TASK_PROFILER
+#define dg_configENABLE_TASK_PROFILER           (0)
+#endif
+
+/**
+ * \brief Enable the sleep decision analytics of the power manager
+ *
+ * Records why every idle period stayed awake or which source woke the system up, the wake-up
+ * latency and the residency per sleep mode, see sdk/middleware/monitoring/sleep_analytics.h.
+ *
+ * \bsp_default_note{\bsp_config_option_app,}
+ */
+#ifndef dg_configENABLE_SLEEP_ANALYTICS
+#define dg_configENABLE_SLEEP_ANALYTICS         (0)
+#endif
+
 /**
  * \brief Enable Micro Trace Buffer
  *
@@ -267,6 +326,59 @@
 #define dg_configTRACK_OS_HEAP                  (0)
 #endif
 
+/**
+ * \brief Use OS memory pools for small, frequently allocated objects
+ *
+ * When enabled, three fixed-size block pools (small, medium, large) are reserved and used by
+ * OS_POOL_MALLOC() (logging messages, BLE stack events, DGTL messages, message queue contents).
+ * OS_FREE() becomes pool-aware so ownership of such buffers can be passed to any SDK module.
+ *
+ * \bsp_default_note{\bsp_config_option_app,}
+ */
+#ifndef dg_configUSE_OS_MEM_POOLS
+#define dg_configUSE_OS_MEM_POOLS               (0)
+#endif
+
+#if (dg_configUSE_OS_MEM_POOLS == 1)
+
+/**
+ * \brief Block size and number of blocks of the small OS memory pool size class
+ *
+ * \bsp_default_note{\bsp_config_option_app,}
+ */
+#ifndef dg_configOS_MEM_POOL_SMALL_BLOCK_SIZE
+#define dg_configOS_MEM_POOL_SMALL_BLOCK_SIZE   (32)
+#endif
+#ifndef dg_configOS_MEM_POOL_SMALL_NUM_BLOCKS
+#define dg_configOS_MEM_POOL_SMALL_NUM_BLOCKS   (16)
+#endif
+
+/**
+ * \brief Block size and number of blocks of the medium OS memory pool size class
+ *
+ * \bsp_default_note{\bsp_config_option_app,}
+ */
+#ifndef dg_configOS_MEM_POOL_MEDIUM_BLOCK_SIZE
+#define dg_configOS_MEM_POOL_MEDIUM_BLOCK_SIZE  (64)
+#endif
+#ifndef dg_configOS_MEM_POOL_MEDIUM_NUM_BLOCKS
+#define dg_configOS_MEM_POOL_MEDIUM_NUM_BLOCKS  (16)
+#endif
+
+/**
+ * \brief Block size and number of blocks of the large OS memory pool size class
+ *
+ * \bsp_default_note{\bsp_config_option_app,}
+ */
+#ifndef dg_configOS_MEM_POOL_LARGE_BLOCK_SIZE
+#define dg_configOS_MEM_POOL_LARGE_BLOCK_SIZE   (128)
+#endif
+#ifndef dg_configOS_MEM_POOL_LARGE_NUM_BLOCKS
+#define dg_configOS_MEM_POOL_LARGE_NUM_BLOCKS   (8)
+#endif
+
+#endif /* dg_configUSE_OS_MEM_POOLS */
+
 /* ---------------------------------------------------------------------------------------------- */
 
 /**
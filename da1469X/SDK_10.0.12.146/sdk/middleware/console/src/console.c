@@ -30,6 +30,7 @@
 #include "osal.h"
 #include "resmgmt.h"
 #include "sdk_defs.h"
+#include "sdk_ringbuf.h"
 
 #if CONFIG_CONSOLE_RINGBUF_SIZE > 0
 #       define RINGBUF_SIZE (CONFIG_CONSOLE_RINGBUF_SIZE)
@@ -53,11 +54,12 @@ typedef struct {
         OS_EVENT fifo_not_full;       /**< Event to wake up waiting writers */
         OS_EVENT read_finished;       /**< Event to wake up readers */
         uint16_t read_size;           /**< Number of requested bytes */
-        uint16_t fifo_wrix;           /**< write ring buffer index */
-        uint16_t fifo_rdix;           /**< read ring buffer index */
-        uint16_t fifo_free;           /**< number of free bytes in fifo */
+        ringbuf_t fifo;               /**< fifo over ring_buf, consumed by UART callback */
         uint32_t drop_count;          /**< number of bytes already dropped */
         bool fifo_blocked;            /**< flag indicating that fifo is blocked */
+#if dg_configUART_RX_CIRCULAR_DMA
+        bool rx_ring;                 /**< read in progress waits on circular RX DMA buffer */
+#endif
         char ring_buf[RINGBUF_SIZE];  /**< ring buffer */
         char *read_buf;               /**< user buffer provided for read */
 } console_data_t;
@@ -69,34 +71,6 @@ static __RETAINED console_data_t console;
 #define CONSOLE_READ_REQUEST            0x04
 #define CONSOLE_READ_DONE               0x08
 
-/*
- * Copy data to console ring buffer, caller must ensure that data will fit.
- * This function will be called inside critical section.
- */
-static void console_write_to_ring_buffer(const char *ptr, int len)
-{
-        console.fifo_free -= len;
-        if (console.fifo_wrix + len > sizeof(console.ring_buf)) {
-                /*
-                 * This is case when some data must be written at the end of ring buffer.
-                 * and some from the beginning.
-                 */
-                int left;
-                memcpy(console.ring_buf + console.fifo_wrix, ptr,
-                                                        sizeof(console.ring_buf) - console.fifo_wrix);
-                left  = len - (sizeof(console.ring_buf) - console.fifo_wrix);
-                memcpy(console.ring_buf, ptr + sizeof(console.ring_buf) - console.fifo_wrix, left);
-                console.fifo_wrix = left;
-        } else {
-                /* Simple case without overlap */
-                memcpy(console.ring_buf + console.fifo_wrix, ptr, len);
-                console.fifo_wrix += len;
-                if (console.fifo_wrix >= sizeof(console.ring_buf)) {
-                        console.fifo_wrix = 0;
-                }
-        }
-}
-
 int console_write(const char *buf, int len)
 {
         int dropped;
@@ -105,17 +79,16 @@ int console_write(const char *buf, int len)
         for (;;) {
                 dropped = 0;
                 /*
-                 * Put as much as possible data into ring buffer.
+                 * Put as much as possible data into ring buffer. Writers can be tasks and
+                 * interrupts, so they are serialized here. Reading side (UART callback) does not
+                 * need the critical section.
                  */
                 OS_ENTER_CRITICAL_SECTION();
-                if (left > console.fifo_free) {
-                        /* not all can fit in ring buffer */
-                        dropped = left - console.fifo_free;
-                        left = console.fifo_free;
-                }
-                /* There was something to write this time, just put it in buffer */
                 if (left) {
-                        console_write_to_ring_buffer(buf, left);
+                        uint32_t written = ringbuf_write(&console.fifo, buf, left);
+                        /* not all can fit in ring buffer */
+                        dropped = left - written;
+                        left = written;
                 }
                 /*
                  * If something was not fitting in ring buffer but we are in interrupt or
@@ -196,20 +169,11 @@ int console_read(char *ptr, int len)
 static void console_write_cb(void *user_data, uint16_t transferred)
 {
         console_data_t *console = (console_data_t *) user_data;
-        uint32_t critical_section_status = 0;
-
-        OS_ENTER_CRITICAL_SECTION_FROM_ISR(critical_section_status);
 
-        /* Move read index and increase free FIFO counter */
-        console->fifo_rdix += transferred;
-        if (console->fifo_rdix >= sizeof(console->ring_buf)) {
-                console->fifo_rdix -= sizeof(console->ring_buf);
-        }
-        console->fifo_free += transferred;
+        /* Release written data, UART callback is the only reader of the FIFO */
+        ringbuf_read_consume(&console->fifo, transferred);
         console->fifo_blocked = false;
 
-        OS_LEAVE_CRITICAL_SECTION_FROM_ISR(critical_section_status);
-
         OS_TASK_NOTIFY_FROM_ISR(console->task, CONSOLE_WRITE_DONE, OS_NOTIFY_SET_BITS);
 }
 
@@ -264,23 +228,15 @@ static void console_task_fun(void *param)
                                  * Ring buffer has some new data that should go to UART.
                                  */
                                 if (0 != (current_requests & CONSOLE_WRITE_REQUEST) &&
-                                                                        console.fifo_free < sizeof(console.ring_buf)) {
-                                        uint16_t wx = console.fifo_wrix;
-                                        uint16_t size = 0;
-                                        if (console.fifo_rdix < wx) {
-                                                /*
-                                                 * In case when data to write is in one block in ring buffer
-                                                 * just print it in one run
-                                                 */
-                                                size = wx - console.fifo_rdix;
-                                        } else {
+                                                                        !ringbuf_is_empty(&console.fifo)) {
+                                        void *data;
+                                        uint32_t size = ringbuf_read_peek(&console.fifo, &data);
+                                        if (size < ringbuf_used(&console.fifo)) {
                                                 /*
                                                  * This time data to print starts at the end of ring buffer.
                                                  * UART will print this part first, and after writing that,
                                                  * data at the beginning will be printed.
-                                                 */
-                                                size = sizeof(console.ring_buf) - console.fifo_rdix;
-                                                /*
+                                                 *
                                                  * Write request was already cleared, but here asked for it again.
                                                  * This request will be masked till UART writes finishes.
                                                  */
@@ -294,7 +250,7 @@ static void console_task_fun(void *param)
                                                  */
                                                 mask ^= CONSOLE_WRITE_REQUEST | CONSOLE_WRITE_DONE;
 
-                                                ad_uart_write_async(uart, console.ring_buf + console.fifo_rdix, size, console_write_cb, &console);
+                                                ad_uart_write_async(uart, data, size, console_write_cb, &console);
                                         }
                                 }
 
@@ -312,7 +268,19 @@ static void console_task_fun(void *param)
                                          * and wait for read done.
                                          */
                                         mask ^= CONSOLE_READ_DONE | CONSOLE_READ_REQUEST;
+#if dg_configUART_RX_CIRCULAR_DMA
+                                        /*
+                                         * With circular RX DMA buffer, return whatever was typed
+                                         * once the line is idle instead of waiting for read_size.
+                                         */
+                                        console.rx_ring = ad_uart_rx_ring_notify(uart, console.read_size,
+                                                                console_read_cb, &console) == AD_UART_ERROR_NONE;
+                                        if (!console.rx_ring) {
+                                                ad_uart_read_async(uart, console.read_buf, console.read_size, console_read_cb, &console);
+                                        }
+#else
                                         ad_uart_read_async(uart, console.read_buf, console.read_size, console_read_cb, &console);
+#endif
                                 }
 
                                 if (0 != (current_requests & CONSOLE_READ_DONE)) {
@@ -320,6 +288,12 @@ static void console_task_fun(void *param)
                                          * Something was received. Enable read request again, and notify reader.
                                          */
                                         mask ^= CONSOLE_READ_DONE | CONSOLE_READ_REQUEST;
+#if dg_configUART_RX_CIRCULAR_DMA
+                                        if (console.rx_ring) {
+                                                console.read_size = ad_uart_read_available(uart,
+                                                        console.read_buf, console.read_size, 0);
+                                        }
+#endif
                                         OS_EVENT_SIGNAL(console.read_finished);
                                 }
                         }
@@ -335,7 +309,7 @@ void console_init(const ad_uart_controller_conf_t *ad_uart_ctrl_conf)
                 return;
         }
 
-        console.fifo_free = sizeof(console.ring_buf);
+        ringbuf_init(&console.fifo, console.ring_buf, sizeof(console.ring_buf));
         OS_MUTEX_CREATE(console.mutex);
         OS_EVENT_CREATE(console.fifo_not_full);
         OS_EVENT_CREATE(console.read_finished);
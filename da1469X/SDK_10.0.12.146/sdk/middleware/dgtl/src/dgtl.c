@@ -16,6 +16,7 @@
 
 #include <string.h>
 #include <osal.h>
+#include "sdk_ringbuf.h"
 #ifdef DGTL_CUSTOM_UART_CONFIG_HEADER
 #       ifndef DGTL_CUSTOM_UART_CONFIG
 #               error Please define DGTL_CUSTOM_UART_CONFIG
@@ -35,6 +36,10 @@
 #define NOTIF_QUEUE_TX_DONE     0x00000001
 #define NOTIF_UART_RX_DONE      0x00000002
 #define NOTIF_CLOSE_UART        0x00000004
+#define NOTIF_RX_QUEUE_FREE     0x00000008
+
+/* Number of messages in each queue */
+#define QUEUE_LENGTH            (10)
 
 /* HCI commands vendor specific opcodes which shall be forwarded to APPHCI instead of HCI queue */
 #define APP_SPECIFIC_HCI_MASK   0xFE00
@@ -64,11 +69,20 @@ typedef enum {
         QUEUE_IDX_LAST,
 } queue_idx_t;
 
+/*
+ * RX queues have a single producer (DGTL task) and a single consumer (registered owner), so
+ * they are ring buffers of message pointers.
+ */
 typedef struct {
         OS_TASK owner;
         uint32_t notif;
+        ringbuf_t ring;
+        dgtl_msg_t *ring_buf[QUEUE_LENGTH];
+        /* Set by DGTL task when ring is full, owner notifies DGTL task once it takes a message */
+        volatile bool blocked;
 } queue_info_t;
 
+/* TX queue element, stored by value in queue */
 typedef struct {
         dgtl_msg_t *msg;
         dgtl_sent_cb_t cb;
@@ -80,13 +94,15 @@ typedef struct {
         /* Mutex used for closing DGTL UART */
         OS_MUTEX mutex;
 
-        /* Available queues */
+        /* Available queues, TX queues use queue and RX queues use queue_info */
         OS_QUEUE queue[QUEUE_IDX_LAST];
         queue_info_t queue_info[QUEUE_IDX_LAST];
         /* Last position in high-priority queues list, for round-robin scheduling */
         size_t tx_queues_hi_pos;
-        /* Buffer pending to be freed */
-        dgtl_send_data_t *deferred_free;
+        /* Message being sent */
+        dgtl_send_data_t tx_data;
+        /* Message sent, pending to be freed */
+        volatile bool deferred_free;
 
 #if DGTL_DROPPED_LOG_QUEUE_COUNTER
         size_t log_queue_dropped;
@@ -126,9 +142,18 @@ typedef struct {
 
         dgtl_msg_t *msg;
         dgtl_pkt_t frame_header;
+        /* Received frame in msg waits for space in its queue */
+        bool rx_blocked;
 
         uint8_t resync_buf;
         uint8_t resync_idx;
+#if dg_configUART_RX_CIRCULAR_DMA
+        /* Frames are parsed directly from the UART circular RX DMA buffer */
+        bool rx_ring;
+        /* Destination and number of bytes still expected in the current state */
+        uint8_t *rx_ptr;
+        size_t rx_left;
+#endif
         OS_EVENT data_ready;
         OS_EVENT uart_closed;
 } uart_state_t;
@@ -150,7 +175,11 @@ __RETAINED static uart_state_t uart;
 void dgtl_app_specific_hci_cb(const dgtl_msg_t *msg) __WEAK;
 #endif
 
-static void push_frame_to_queue(void)
+/*
+ * Pass received frame to its queue. Returns false if the queue is full, frame is kept in
+ * uart.msg until the owner takes a message from the queue.
+ */
+static bool push_frame_to_queue(void)
 {
         queue_idx_t qidx;
         queue_info_t *qinfo;
@@ -166,7 +195,7 @@ static void push_frame_to_queue(void)
                                                                         == APP_SPECIFIC_HCI_MASK) {
                         dgtl_app_specific_hci_cb(uart.msg);
                         uart.msg = NULL;
-                        return;
+                        return true;
                 }
                 /* no break */
 #endif
@@ -191,15 +220,27 @@ static void push_frame_to_queue(void)
                  */
                 dgtl_msg_free(uart.msg);
                 uart.msg = NULL;
-                return;
+                return true;
         }
 
         qinfo = &dgtl.queue_info[qidx];
 
-        OS_QUEUE_PUT(dgtl.queue[qidx], &uart.msg, OS_QUEUE_FOREVER);
+        if (ringbuf_write(&qinfo->ring, &uart.msg, sizeof(uart.msg)) == 0) {
+                /*
+                 * Queue is full, stop receiving until owner takes a message. Try once more after
+                 * setting the flag in case owner took a message in the meantime.
+                 */
+                qinfo->blocked = true;
+                if (ringbuf_write(&qinfo->ring, &uart.msg, sizeof(uart.msg)) == 0) {
+                        return false;
+                }
+                qinfo->blocked = false;
+        }
         OS_TASK_NOTIFY(qinfo->owner, qinfo->notif, OS_NOTIFY_SET_BITS);
 
         uart.msg = NULL;
+
+        return true;
 }
 
 static void uart_read_cb(void *user_data, uint16_t transferred)
@@ -207,6 +248,19 @@ static void uart_read_cb(void *user_data, uint16_t transferred)
         OS_TASK_NOTIFY_FROM_ISR(dgtl.task, NOTIF_UART_RX_DONE, OS_NOTIFY_SET_BITS);
 }
 
+/* Receive the next len bytes of the frame to buf, uart_rx_done() is called when they are in */
+static void uart_receive(void *buf, size_t len)
+{
+#if dg_configUART_RX_CIRCULAR_DMA
+        if (uart.rx_ring) {
+                uart.rx_ptr = buf;
+                uart.rx_left = len;
+                return;
+        }
+#endif
+        ad_uart_read_async(uart.dev, buf, len, uart_read_cb, NULL);
+}
+
 static void uart_resync(bool cont)
 {
         uart.rx_state = UART_STATE_RESYNC;
@@ -214,7 +268,7 @@ static void uart_resync(bool cont)
                 uart.resync_idx = 0;
         }
 
-        ad_uart_read_async(uart.dev, (char *) &uart.resync_buf, 1, uart_read_cb, NULL);
+        uart_receive(&uart.resync_buf, 1);
 }
 
 static void uart_start_packet(void)
@@ -224,7 +278,7 @@ static void uart_start_packet(void)
         uart.frame_header.pkt_type = 0;
 
         uart.rx_state = UART_STATE_W4_TYPE;
-        ad_uart_read_async(uart.dev, (char *) &uart.frame_header.pkt_type, 1, uart_read_cb, NULL);
+        uart_receive(&uart.frame_header.pkt_type, 1);
 }
 
 static void uart_handle_rx_type(void)
@@ -241,9 +295,16 @@ static void uart_handle_rx_type(void)
 
         /* Packet type received, receive rest of the header of appropriate size */
         uart.rx_state = UART_STATE_W4_HEADER;
-        ad_uart_read_async(uart.dev,
-                                (char *) &uart.frame_header.pkt_type + sizeof(uart.frame_header.pkt_type),
-                                header_len - 1, uart_read_cb, NULL);
+        uart_receive((uint8_t *) &uart.frame_header.pkt_type + sizeof(uart.frame_header.pkt_type),
+                                                                                header_len - 1);
+}
+
+static void uart_handle_rx_frame(void)
+{
+        uart.rx_blocked = !push_frame_to_queue();
+        if (!uart.rx_blocked) {
+                uart_start_packet();
+        }
 }
 
 static void uart_handle_rx_header(void)
@@ -261,20 +322,18 @@ static void uart_handle_rx_header(void)
 
         /* No parameters to receive for this packet, push to queue immediately. */
         if (param_len == 0) {
-                push_frame_to_queue();
-                uart_start_packet();
+                uart_handle_rx_frame();
                 return;
         }
 
         /* Packet header received, receive parameters of appropriate size */
         uart.rx_state = UART_STATE_W4_PARAMETERS;
-        ad_uart_read_async(uart.dev, (char *) &uart.msg->data[header_len], param_len, uart_read_cb, NULL);
+        uart_receive(&uart.msg->data[header_len], param_len);
 }
 
 static void uart_handle_rx_parameters(void)
 {
-        push_frame_to_queue();
-        uart_start_packet();
+        uart_handle_rx_frame();
 }
 
 static void uart_handle_resync(void)
@@ -326,68 +385,115 @@ static void uart_rx_done(void)
         }
 }
 
-dgtl_send_data_t *send_data_create(dgtl_msg_t *msg, dgtl_sent_cb_t cb, void *user_data)
+#if dg_configUART_RX_CIRCULAR_DMA
+/*
+ * Parse everything received so far, then wait for the rest of the frame. Between frames wait
+ * for the line to become idle, so that a whole frame is normally handled on a single wake-up.
+ */
+static void uart_rx_ring(void)
 {
-        dgtl_send_data_t *send_data;
+        const uint8_t *data;
+        uint16_t len;
+        size_t threshold;
+
+        while (!uart.rx_blocked && (len = ad_uart_rx_ring_peek(uart.dev, &data)) > 0) {
+                len = MIN(len, uart.rx_left);
+                memcpy(uart.rx_ptr, data, len);
+                ad_uart_rx_ring_consume(uart.dev, len);
+                uart.rx_ptr += len;
+                uart.rx_left -= len;
+
+                if (uart.rx_left == 0) {
+                        uart_rx_done();
+                }
+        }
 
-        send_data = OS_MALLOC(sizeof(*send_data));
-        send_data->cb = cb;
-        send_data->msg = msg;
-        send_data->user_data = user_data;
+        /* Parsing resumes when the owner of the full queue takes a message */
+        if (uart.rx_blocked) {
+                return;
+        }
 
-        return send_data;
+        threshold = (uart.rx_state == UART_STATE_W4_HEADER ||
+                        uart.rx_state == UART_STATE_W4_PARAMETERS) ? uart.rx_left : UINT16_MAX;
+        /* Threshold is limited to the buffer size by the driver */
+        ad_uart_rx_ring_notify(uart.dev, MIN(threshold, UINT16_MAX), uart_read_cb, NULL);
 }
+#endif
 
-void send_data_destroy(dgtl_send_data_t *send_data)
+static void uart_rx_start(void)
 {
-        dgtl_msg_free(send_data->msg);
+#if dg_configUART_RX_CIRCULAR_DMA
+        uart.rx_ring = true;
+#endif
+        /* Wait for first packet type indicator */
+        uart_start_packet();
+#if dg_configUART_RX_CIRCULAR_DMA
+        /* DGTL UART has no circular RX DMA buffer, read each part of the frame separately */
+        if (ad_uart_rx_ring_notify(uart.dev, 1, uart_read_cb, NULL) ==
+                                                        AD_UART_ERROR_CONTROLLER_CONF_INVALID) {
+                uart.rx_ring = false;
+                uart_receive(uart.rx_ptr, uart.rx_left);
+        }
+#endif
+}
 
-        OS_FREE(send_data);
+static void uart_rx_queue_free(void)
+{
+        /* Frame which did not fit in its queue is pending */
+        if (uart.rx_blocked) {
+                uart_handle_rx_frame();
+#if dg_configUART_RX_CIRCULAR_DMA
+                if (uart.rx_ring && !uart.rx_blocked) {
+                        uart_rx_ring();
+                }
+#endif
+        }
 }
 
 static void uart_tx_done(void *user_data, uint16_t transferred)
 {
         /* There should not be another deferred free operation pending */
-        OS_ASSERT(dgtl.deferred_free == NULL);
+        OS_ASSERT(!dgtl.deferred_free);
 
-        /* Store buffer pointer */
-        dgtl.deferred_free = user_data;
+        /* Mark buffer as sent */
+        dgtl.deferred_free = true;
 
         /* Notify DGTL task to free the buffer */
         OS_TASK_NOTIFY_FROM_ISR(dgtl.task, NOTIF_QUEUE_TX_DONE, OS_NOTIFY_SET_BITS);
 }
 
-static dgtl_send_data_t *pick_message_from_hi_queue(void)
+static bool pick_message_from_hi_queue(dgtl_send_data_t *send_data)
 {
-        dgtl_send_data_t *msg = NULL;
+        bool found = false;
         size_t i;
 
-        for (i = 0; !msg && (i < TX_QUEUES_HI_COUNT); i++) {
+        for (i = 0; !found && (i < TX_QUEUES_HI_COUNT); i++) {
                 queue_idx_t qidx = tx_queues_hi[dgtl.tx_queues_hi_pos];
 
-                OS_QUEUE_GET(dgtl.queue[qidx], &msg, OS_QUEUE_NO_WAIT);
+                found = OS_QUEUE_GET(dgtl.queue[qidx], send_data, OS_QUEUE_NO_WAIT) == OS_QUEUE_OK;
 
                 if (++dgtl.tx_queues_hi_pos >= TX_QUEUES_HI_COUNT) {
                         dgtl.tx_queues_hi_pos = 0;
                 }
         }
 
-        return msg;
+        return found;
 }
 
 static void queue_tx_done(void)
 {
-        dgtl_send_data_t *send_data = NULL;
+        dgtl_send_data_t *send_data = &dgtl.tx_data;
+        bool found = false;
 
         if (uart.tx_state) {
                 if (dgtl.deferred_free) {
-                        if (dgtl.deferred_free->cb) {
-                                dgtl.deferred_free->cb(dgtl.deferred_free->user_data);
+                        if (send_data->cb) {
+                                send_data->cb(send_data->user_data);
                         }
 
                         /* UART TX has just been completed, buffer free operation pending */
-                        send_data_destroy(dgtl.deferred_free);
-                        dgtl.deferred_free = NULL;
+                        dgtl_msg_free(send_data->msg);
+                        dgtl.deferred_free = false;
                         uart.tx_state = false;
                 } else {
                         /* We are already transmitting something, will go back here when finished */
@@ -399,21 +505,22 @@ static void queue_tx_done(void)
         if (TX_QUEUES_HI_COUNT == 1) {
                 /* Always fetch from 1st queue if only single queue is enabled */
                 queue_idx_t qidx = tx_queues_hi[0];
-                OS_QUEUE_GET(dgtl.queue[qidx], &send_data, OS_QUEUE_NO_WAIT);
+                found = OS_QUEUE_GET(dgtl.queue[qidx], send_data, OS_QUEUE_NO_WAIT) == OS_QUEUE_OK;
         } else if (TX_QUEUES_HI_COUNT > 1) {
-                send_data = pick_message_from_hi_queue();
+                found = pick_message_from_hi_queue(send_data);
         }
 
         /*
          * If no message in any high-priority queue, try to get something from logs queue (or just
          * return if log queue is not available)
          */
-        if (!send_data) {
+        if (!found) {
 #if DGTL_QUEUE_ENABLE_LOG
-                OS_QUEUE_GET(dgtl.queue[QUEUE_IDX_LOG_TX], &send_data, OS_QUEUE_NO_WAIT);
+                found = OS_QUEUE_GET(dgtl.queue[QUEUE_IDX_LOG_TX], send_data, OS_QUEUE_NO_WAIT) ==
+                                                                                OS_QUEUE_OK;
 
                 /* Still nothing, just wait for another event */
-                if (!send_data) {
+                if (!found) {
                         return;
                 }
 #else
@@ -423,7 +530,7 @@ static void queue_tx_done(void)
 
         uart.tx_state = true;
         ad_uart_write_async(uart.dev, (char *) send_data->msg->data,
-                                dgtl_pkt_get_length((dgtl_pkt_t *) send_data->msg), uart_tx_done, send_data);
+                                dgtl_pkt_get_length((dgtl_pkt_t *) send_data->msg), uart_tx_done, NULL);
 }
 
 void dgtl_wkup_handler(void)
@@ -443,8 +550,7 @@ static void dgtl_task_func(void *param)
                 OS_EVENT_WAIT(uart.data_ready, OS_EVENT_FOREVER);
 
                 uart.dev = ad_uart_open(&DGTL_UART_CONFIG);
-                /* Wait for first packet type indicator */
-                uart_start_packet();
+                uart_rx_start();
 
                 while (uart.dev) {
                         uint32_t notif;
@@ -452,19 +558,38 @@ static void dgtl_task_func(void *param)
                         OS_TASK_NOTIFY_WAIT(0, (unsigned) -1, &notif, OS_TASK_NOTIFY_FOREVER);
 
                         if (notif & NOTIF_UART_RX_DONE) {
+#if dg_configUART_RX_CIRCULAR_DMA
+                                if (uart.rx_ring) {
+                                        uart_rx_ring();
+                                } else {
+                                        uart_rx_done();
+                                }
+#else
                                 uart_rx_done();
+#endif
                         }
 
                         if (notif & NOTIF_QUEUE_TX_DONE) {
                                 queue_tx_done();
                         }
 
+                        if (notif & NOTIF_RX_QUEUE_FREE) {
+                                uart_rx_queue_free();
+                        }
+
                         if (notif & NOTIF_CLOSE_UART) {
                                 break;
                         }
                 }
                 ad_uart_complete_async_read(uart.dev);
 
+                /* Frame still waiting for space in its queue is dropped */
+                if (uart.rx_blocked) {
+                        dgtl_msg_free(uart.msg);
+                        uart.msg = NULL;
+                        uart.rx_blocked = false;
+                }
+
                 /* Wait until any pending operation is completed */
                 while (ad_uart_close(uart.dev, false) != AD_UART_ERROR_NONE) {
                         OS_DELAY_MS(CLOSE_INTERVAL_MS);
@@ -488,7 +613,20 @@ void dgtl_init(void)
         }
 
         for (i = 0; i < QUEUE_IDX_LAST; i++) {
-                OS_QUEUE_CREATE(dgtl.queue[i], sizeof(void *), 10);
+                switch (i) {
+#if DGTL_QUEUE_ENABLE_HCI
+                case QUEUE_IDX_HCI_RX:
+#endif
+#if DGTL_QUEUE_ENABLE_APP
+                case QUEUE_IDX_APP_RX:
+#endif
+                        ringbuf_init(&dgtl.queue_info[i].ring, dgtl.queue_info[i].ring_buf,
+                                                                sizeof(dgtl.queue_info[i].ring_buf));
+                        break;
+                default:
+                        OS_QUEUE_CREATE(dgtl.queue[i], sizeof(dgtl_send_data_t), QUEUE_LENGTH);
+                        break;
+                }
         }
 
         OS_MUTEX_CREATE(dgtl.mutex);
@@ -544,7 +682,7 @@ void dgtl_register(dgtl_queue_t queue, uint32_t notif)
 
 bool dgtl_send_ex(dgtl_msg_t *msg, dgtl_sent_cb_t cb, void *user_data)
 {
-        dgtl_send_data_t *send_data;
+        dgtl_send_data_t send_data;
         queue_idx_t qidx;
         OS_BASE_TYPE timeout = OS_QUEUE_FOREVER;
         OS_BASE_TYPE ret;
@@ -582,7 +720,9 @@ bool dgtl_send_ex(dgtl_msg_t *msg, dgtl_sent_cb_t cb, void *user_data)
                 return false;
         }
 
-        send_data = send_data_create(msg, cb, user_data);
+        send_data.msg = msg;
+        send_data.cb = cb;
+        send_data.user_data = user_data;
         ret = OS_QUEUE_PUT(dgtl.queue[qidx], &send_data, timeout);
         if (ret == OS_QUEUE_OK) {
                 OS_TASK_NOTIFY(dgtl.task, NOTIF_QUEUE_TX_DONE, OS_NOTIFY_SET_BITS);
@@ -590,7 +730,7 @@ bool dgtl_send_ex(dgtl_msg_t *msg, dgtl_sent_cb_t cb, void *user_data)
         }
 #if DGTL_QUEUE_ENABLE_LOG
         else if (qidx == QUEUE_IDX_LOG_TX) {
-                send_data_destroy(send_data);
+                dgtl_msg_free(msg);
 #if DGTL_DROPPED_LOG_QUEUE_COUNTER
                 OS_ENTER_CRITICAL_SECTION();
                 dgtl.log_queue_dropped++;
@@ -600,7 +740,7 @@ bool dgtl_send_ex(dgtl_msg_t *msg, dgtl_sent_cb_t cb, void *user_data)
 #endif
         else {
                 /* Free message */
-                send_data_destroy(send_data);
+                dgtl_msg_free(msg);
         }
 
         return false;
@@ -613,7 +753,6 @@ void dgtl_send(dgtl_msg_t *msg)
 
 dgtl_msg_t *dgtl_receive(dgtl_queue_t queue)
 {
-        OS_BASE_TYPE ret;
         dgtl_msg_t *msg;
         queue_idx_t qidx;
         queue_info_t *qinfo;
@@ -641,11 +780,16 @@ dgtl_msg_t *dgtl_receive(dgtl_queue_t queue)
                 return NULL;
         }
 
-        ret = OS_QUEUE_GET(dgtl.queue[qidx], &msg, OS_QUEUE_NO_WAIT);
-        if (ret != OS_QUEUE_OK) {
+        if (ringbuf_read(&qinfo->ring, &msg, sizeof(msg)) == 0) {
                 return NULL;
         }
 
+        /* DGTL task waits for space in queue */
+        if (qinfo->blocked) {
+                qinfo->blocked = false;
+                OS_TASK_NOTIFY(dgtl.task, NOTIF_RX_QUEUE_FREE, OS_NOTIFY_SET_BITS);
+        }
+
         return msg;
 }
 
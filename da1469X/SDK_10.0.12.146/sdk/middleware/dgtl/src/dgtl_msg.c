@@ -73,7 +73,7 @@ dgtl_msg_t *dgtl_msg_alloc(uint8_t pkt_type, size_t length)
 
         ext_len = get_ext_len(pkt_type);
 
-        buf = OS_MALLOC(length + ext_len);
+        buf = OS_POOL_MALLOC(length + ext_len);
         buf[ext_len] = pkt_type;
 
         return ptr2msg(buf, pkt_type);
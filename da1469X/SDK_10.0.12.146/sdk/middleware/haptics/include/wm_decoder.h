@@ -35,6 +35,28 @@
 
 #define WM_SEQUENCE_ID_NONE  0xFF
 
+/* Limits of the frame/snippet tables built by wm_decoder_init() */
+#ifndef WM_MAX_SEQUENCES
+#define WM_MAX_SEQUENCES     16
+#endif
+
+#ifndef WM_MAX_SNIPPETS
+#define WM_MAX_SNIPPETS      15
+#endif
+
+#ifndef WM_MAX_FRAMES
+#define WM_MAX_FRAMES        128
+#endif
+
+#ifndef WM_MAX_PWLS
+#define WM_MAX_PWLS          128
+#endif
+
+#define WM_FRAME_END         0xFE
+#define WM_FRAME_ERROR       0xFF
+
+#define WM_PWL_RAMP          0x80
+
 
 /**
  * Waveform decoder configuration flags structure
@@ -70,6 +92,41 @@ typedef struct wm_pwl_segment_str {
 } wm_pwl_segment;
 
 
+/**
+ * Pre-decoded frame, entry of the frame table
+ */
+typedef struct wm_frame_str {
+    uint16_t frequency;   /* Drive frequency, 0 for default */
+    uint8_t snippet_id;   /* Snippet ID, or WM_FRAME_END/WM_FRAME_ERROR at the end of a sequence */
+    uint8_t loop_count;   /* Number of times the snippet is repeated */
+    uint8_t time_shift;   /* log2 of timebases per PWL time unit */
+    uint8_t gain_shift;   /* Left shift of PWL amplitudes */
+} wm_frame;
+
+
+/**
+ * Pre-decoded PWL pair, entry of the PWL table
+ */
+typedef struct wm_pwl_str {
+    int8_t amplitude;     /* Amplitude before gain, sign already resolved */
+    uint8_t time;         /* Duration in PWL time units (1..8), WM_PWL_RAMP if ramp */
+} wm_pwl;
+
+
+/**
+ * Waveform memory tables, built from the waveform memory buffer by
+ * wm_decoder_init()
+ */
+typedef struct wm_program_str {
+    uint8_t sequence_frame[WM_MAX_SEQUENCES];   /* First frame table entry of sequence */
+    uint8_t snippet_pwl[WM_MAX_SNIPPETS + 1];   /* First PWL table entry of snippet */
+    uint8_t snippet_len[WM_MAX_SNIPPETS + 1];   /* Number of PWL pairs of snippet */
+    uint8_t n_sequences;
+    wm_frame frames[WM_MAX_FRAMES];
+    wm_pwl pwls[WM_MAX_PWLS];
+} wm_program;
+
+
 /**
  * Waveform memory decoder structure
  */
@@ -82,8 +139,13 @@ typedef struct wm_decoder_str {
     uint8_t sequence_id;
     uint8_t frame_index;
     uint8_t pwl_index;
-    wm_frame_data frame_data;
+    uint8_t pwl_end;
+    uint8_t loop_count;
+    const wm_frame *frame;
     wm_pwl_segment segment;
+    int16_t start_level;
+    int16_t end_level;
+    wm_program program;
 
     /* 'Public' parameters (set by decoder but can be read externally) */
     uint16_t frequency;  /**< Drive frequency */
@@ -95,6 +157,13 @@ typedef struct wm_decoder_str {
 /**
  * Initialises waveform memory decoder.
  *
+ * The frames and snippets of all sequences are decoded into the frame and
+ * PWL tables of the decoder here, so the waveform memory buffer must be
+ * complete when this is called and changes to it later have no effect until
+ * the decoder is initialised again. Sequences that do not fit in the tables
+ * (see WM_MAX_FRAMES and WM_MAX_PWLS) or with an ID of WM_MAX_SEQUENCES or
+ * above report a decode error when triggered.
+ *
  * @param decoder      Pointer to the waveform memory decoder instance
  *                     structure
  * @param wm_data      Pointer to the waveform memory buffer
@@ -134,6 +203,30 @@ unsigned wm_decoder_trigger_sequence(wm_decoder *decoder, uint32_t time, unsigne
  */
 unsigned wm_decoder_update(wm_decoder *decoder, uint32_t time);
 
+
+/**
+ * Renders drive parameters for a block of equally spaced times.
+ *
+ * Produces the same values as calling wm_decoder_update() for each time and
+ * reading amplitude and frequency after each call. Once the sequence completes
+ * or a decode error occurs, the rest of the block is filled with 0.
+ *
+ * @param decoder      Pointer to the waveform memory decoder instance
+ *                     structure
+ * @param time         Time of the first entry
+ * @param step         Time between entries
+ * @param amplitude    Drive amplitudes, count entries
+ * @param frequency    Drive frequencies, count entries (can be NULL)
+ * @param count        Number of entries to render
+ *
+ * @return             Decoder state information:
+ *                       0: Playback of sequence active after the last entry
+ *                       1: Playback of sequence complete
+ *                       2: Waveform memory decode error within the block
+ */
+unsigned wm_decoder_render(wm_decoder *decoder, uint32_t time, uint32_t step,
+                           int16_t *amplitude, uint16_t *frequency, unsigned count);
+
 #endif /* WM_DECODER_H */
 
 /**
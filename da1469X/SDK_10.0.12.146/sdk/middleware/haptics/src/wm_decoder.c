@@ -35,28 +35,27 @@
 #define WM_SEQUENCE_END_INDEX(wm_data, sequence_id)      wm_data[WM_SEQUENCE_END_PTR_INDEX(wm_data, sequence_id)]
 
 
-typedef struct wm_frame_byte_0_str {
-    unsigned SNP_ID_L: 3;
-    unsigned TIMEBASE: 2;
-    unsigned GAIN: 2;
-    unsigned COMMAND_TYPE: 1;
-} wm_frame_byte_0;
+/* Frame byte 0 fields */
+#define WM_FRAME_SNP_ID_L(byte)                          ((byte) & 0x07)
+#define WM_FRAME_TIMEBASE(byte)                          (((byte) >> 3) & 0x03)
+#define WM_FRAME_GAIN(byte)                              (((byte) >> 5) & 0x03)
 
+/* Frame byte 1 fields */
+#define WM_FRAME_SNP_ID_H(byte)                          ((byte) & 0x01)
+#define WM_FRAME_FREQ(byte)                              (((byte) >> 1) & 0x01)
+#define WM_FRAME_FREQ_CMD(byte)                          (((byte) >> 2) & 0x01)
+#define WM_FRAME_SNP_ID_LOOP(byte)                       (((byte) >> 3) & 0x0F)
 
-typedef struct wm_frame_byte_1_str {
-    unsigned SNP_ID_H: 1;
-    unsigned FREQ: 1;
-    unsigned FREQ_CMD: 1;
-    unsigned SNP_ID_LOOP: 4;
-    unsigned COMMAND_TYPE: 1;
-} wm_frame_byte_1;
+/* COMMAND_TYPE bit, set in byte 1 of a frame only */
+#define WM_FRAME_COMMAND_TYPE(byte)                      ((byte) & 0x80)
 
+/* PWL byte fields */
+#define WM_PWL_AMP(byte)                                 ((byte) & 0x0F)
+#define WM_PWL_TIME(byte)                                (((byte) >> 4) & 0x07)
+#define WM_PWL_RMP(byte)                                 ((byte) & 0x80)
 
-typedef struct wm_pwl_byte_str {
-    unsigned AMP: 4;
-    unsigned TIME: 3;
-    unsigned RMP: 1;
-} wm_pwl_byte;
+
+static const uint8_t timebase_shifts[] = {0, 2, 4, 5, 6};
 
 
 /*
@@ -82,15 +81,16 @@ static inline unsigned wm_decoder_start(wm_decoder *decoder, uint32_t time, unsi
     decoder->start_time = time;
     decoder->sequence_id = sequence_id;
 
-    /* Initialise frame index to start of appropriate sequence */
-    decoder->frame_index = WM_SEQUENCE_INDEX(decoder->wm_data, sequence_id);
+    /* Initialise frame index to first frame table entry of sequence. Entry 0
+       is the error entry used for sequences that are not in the tables. */
+    decoder->frame_index = sequence_id < WM_MAX_SEQUENCES ? decoder->program.sequence_frame[sequence_id] : 0;
 
-    /* Reset PWL index (indicates no PWL pair is currently referenced) */
+    /* Reset PWL index (indicates no snippet is currently referenced) */
     decoder->pwl_index = 0;
+    decoder->pwl_end = 0;
 
-    /* Initialise 'previous' frame parameters */
-    decoder->frame_data.snippet_id = 0;
-    decoder->frame_data.loop_count = 0;
+    /* Initialise 'previous' frame loop counter */
+    decoder->loop_count = 0;
 
     /* Initialise 'previous' segment parameters */
     decoder->segment.end_time = 0;
@@ -127,73 +127,290 @@ static void wm_decoder_stop(wm_decoder *decoder)
 
 
 /*
- * Decodes frame at current frame pointer index, extracting the information
- * contained within it.
+ * Decodes the PWL pairs of all snippets into the PWL table. Snippet 0 is a
+ * single zero amplitude PWL pair with TIME = 1.
+ *
+ * @param decoder      Pointer to the waveform memory decoder instance
+ *                     structure
+ */
+static void wm_compile_snippets(wm_decoder *decoder)
+{
+    wm_program *program = &decoder->program;
+    const uint8_t *wm_data = decoder->wm_data;
+    unsigned snippet_id, i, n_pwls, len;
+    uint8_t start_index, end_index;
+    int amplitude;
+
+    program->pwls[0].amplitude = 0;
+    program->pwls[0].time = 2;
+    program->snippet_pwl[0] = 0;
+    program->snippet_len[0] = 1;
+    n_pwls = 1;
+
+    for ( snippet_id = 1; snippet_id <= WM_MAX_SNIPPETS; snippet_id++ ) {
+
+        /* Snippets that do not exist or do not fit are marked by zero
+           length, frames referencing them are decode errors */
+        program->snippet_len[snippet_id] = 0;
+        if ( snippet_id > wm_data[WM_N_SNIPPETS_INDEX] )
+            continue;
+
+        /* An empty snippet still plays the PWL pair at its start index */
+        start_index = WM_SNIPPET_INDEX(wm_data, snippet_id);
+        end_index = WM_SNIPPET_END_INDEX(wm_data, snippet_id);
+        len = end_index >= start_index ? end_index - start_index + 1 : 1;
+        if ( n_pwls + len > WM_MAX_PWLS )
+            continue;
+
+        program->snippet_pwl[snippet_id] = n_pwls;
+        program->snippet_len[snippet_id] = len;
+
+        for ( i = 0; i < len; i++ ) {
+            uint8_t pwl = wm_data[(uint8_t) (start_index + i)];
+
+            amplitude = WM_PWL_AMP(pwl);
+            if ( !decoder->flags.ACCELERATION_EN && amplitude > 7) {
+                amplitude -= 16;
+                if ( amplitude < -7 )
+                    amplitude = -7;
+            }
+            program->pwls[n_pwls].amplitude = amplitude;
+            program->pwls[n_pwls].time = (WM_PWL_TIME(pwl) + 1) | (WM_PWL_RMP(pwl) ? WM_PWL_RAMP : 0);
+            n_pwls++;
+        }
+
+    }
+
+}
+
+
+/*
+ * Decodes the frames of a sequence into the frame table, starting at given
+ * entry. The last entry written is WM_FRAME_END, or WM_FRAME_ERROR at the
+ * point where decoding the waveform memory fails.
  *
  * @param decoder      Pointer to the waveform memory decoder instance
  *                     structure
- * @param end_index    Sequence end index
+ * @param sequence_id  ID of sequence to decode
+ * @param n            First frame table entry
  *
- * @return             Decode state:
- *                       0: Frame decoded
- *                       1: Frame decode error
+ * @return             Frame table entry after the sequence, 0 if the
+ *                     sequence does not fit in the table
  */
-static inline unsigned wm_decode_frame(wm_decoder *decoder, unsigned end_index)
+static unsigned wm_compile_sequence(wm_decoder *decoder, unsigned sequence_id, unsigned n)
 {
-    wm_frame_byte_0 *byte_0 = (wm_frame_byte_0 *) &decoder->wm_data[decoder->frame_index];
-    wm_frame_byte_1 *byte_1;
+    wm_program *program = &decoder->program;
+    const uint8_t *wm_data = decoder->wm_data;
+    unsigned end_index = WM_SEQUENCE_END_INDEX(wm_data, sequence_id);
+    uint8_t frame_index = WM_SEQUENCE_INDEX(wm_data, sequence_id);
+    unsigned snippet_id, loop_count, frequency;
+    uint8_t byte_0, byte_1;
+    wm_frame *frame;
 
-    /* Check frame index is valid and that the value of COMMAND_TYPE of the
-       first byte is zero and if not return error */
-    if ( decoder->frame_index > end_index || byte_0->COMMAND_TYPE )
-        return 1;
+    for ( ; n < WM_MAX_FRAMES; n++ ) {
+
+        frame = &program->frames[n];
+
+        if ( frame_index == end_index + 1 ) {
+            frame->snippet_id = WM_FRAME_END;
+            return n + 1;
+        }
+
+        /* Check frame index is valid and that COMMAND_TYPE of the first byte
+           is zero */
+        if ( frame_index > end_index || WM_FRAME_COMMAND_TYPE(wm_data[frame_index]) )
+            break;
+        byte_0 = wm_data[frame_index];
+
+        snippet_id = WM_FRAME_SNP_ID_L(byte_0);
+        loop_count = 0;
+        frequency = 0;
+
+        /* The second byte belongs to this frame only if it is within the
+           sequence and its COMMAND_TYPE is set */
+        if ( ++frame_index <= end_index && WM_FRAME_COMMAND_TYPE(wm_data[frame_index]) ) {
+            byte_1 = wm_data[frame_index++];
+            snippet_id |= WM_FRAME_SNP_ID_H(byte_1) << 3;
+            loop_count = WM_FRAME_SNP_ID_LOOP(byte_1);
+
+            if ( WM_FRAME_FREQ_CMD(byte_1) ) {
+                if ( frame_index > end_index )
+                    break;
+                frequency = (WM_FRAME_FREQ(byte_1) << 8) | wm_data[frame_index++];
+            }
+        }
+
+        if ( !program->snippet_len[snippet_id] )
+            break;
+
+        frame->snippet_id = snippet_id;
+        frame->loop_count = loop_count;
+        frame->frequency = frequency < 12 ? 0 : (frequency + 1) * 2;
+        frame->time_shift = timebase_shifts[WM_FRAME_TIMEBASE(byte_0) + !decoder->flags.FREQ_WAVEFORM_TIMEBASE];
+        frame->gain_shift = 3 - WM_FRAME_GAIN(byte_0);
+
+    }
+
+    if ( n >= WM_MAX_FRAMES )
+        return 0;
 
 #ifdef TRACE_ENABLE
-    TRACE("  Decoding frame at index %d.\n", decoder->frame_index);
+    TRACE("Sequence %d: decode error at index %d.\n", sequence_id, frame_index);
 #endif
 
-    /* Extract fields of byte 0 */
-    decoder->frame_data.snippet_id = byte_0->SNP_ID_L;
-    decoder->frame_data.timebase = byte_0->TIMEBASE;
-    decoder->frame_data.gain = byte_0->GAIN;
-    decoder->frame_data.frequency = 0;
+    program->frames[n].snippet_id = WM_FRAME_ERROR;
+    return n + 1;
 
-    /* Increment frame index and read second byte */
-    byte_1 = (wm_frame_byte_1 *) &decoder->wm_data[++decoder->frame_index];
+}
 
-    /* Again check the frame index hasn't moved beyond end of sequence and
-       that the value of COMMAND_TYPE of the second byte is not zero. If so,
-       this byte belongs to the next frame so stop decoding */
-    if ( decoder->frame_index > end_index || !byte_1->COMMAND_TYPE ) {
-        decoder->frame_data.loop_count = 0;
-        return 0;
+
+/*
+ * Builds the frame and PWL tables from the waveform memory buffer.
+ *
+ * @param decoder      Pointer to the waveform memory decoder instance
+ *                     structure
+ */
+static void wm_compile(wm_decoder *decoder)
+{
+    wm_program *program = &decoder->program;
+    unsigned sequence_id, n_frames, next;
+
+    program->n_sequences = decoder->wm_data[WM_N_SEQUENCES_INDEX];
+
+    wm_compile_snippets(decoder);
+
+    /* Entry 0 is shared by all sequences that do not fit in the table */
+    program->frames[0].snippet_id = WM_FRAME_ERROR;
+    n_frames = 1;
+
+    for ( sequence_id = 0; sequence_id < WM_MAX_SEQUENCES; sequence_id++ ) {
+        next = sequence_id < program->n_sequences ? wm_compile_sequence(decoder, sequence_id, n_frames) : 0;
+        program->sequence_frame[sequence_id] = next ? n_frames : 0;
+        if ( next )
+            n_frames = next;
     }
 
-    /* Extract fields of byte 1 */
-    decoder->frame_data.snippet_id |= byte_1->SNP_ID_H << 3;
-    decoder->frame_data.loop_count = byte_1->SNP_ID_LOOP;
+}
 
-    /* Increment frame index */
-    decoder->frame_index++;
 
-    /* Check the value of FREQ_CMD is 1. If not, there is no additional FREQ
-       byte so stop decoding */
-    if ( !byte_1->FREQ_CMD )
-        return 0;
+/*
+ * Advances the decoder to the segment containing given time, decoding the
+ * next frames and PWL pairs from the tables as required.
+ *
+ * @param decoder             Pointer to the waveform memory decoder instance
+ *                            structure
+ * @param playback_timebases  Time since start of sequence in timebases
+ *
+ * @return             Decoder state information:
+ *                       0: Playback of sequence active
+ *                       1: Playback of sequence complete
+ *                       2: Waveform memory decode error
+ */
+static unsigned wm_decoder_advance(wm_decoder *decoder, uint16_t playback_timebases)
+{
+    const wm_program *program = &decoder->program;
+    const wm_frame *frame = decoder->frame;
+    const wm_pwl *pwl;
+    int32_t end_amplitude, scaler;
+    int shift;
 
-    /* Once again make sure the frame index hasn't moved beyond end of
-       sequence and if so return error */
-    if ( decoder->frame_index > end_index )
-        return 1;
+    while ( !decoder->segment.end_time || playback_timebases >= decoder->segment.end_time ) {
+
+        /* Check if end of snippet has been reached and if so, ... */
+        if ( decoder->pwl_index == decoder->pwl_end ) {
+
+            /* Check frame loop counter to see if current frame needs to be
+               repeated and if not move to the next frame */
+            if ( !decoder->loop_count-- ) {
+
+                frame = &program->frames[decoder->frame_index++];
+                decoder->frame = frame;
+
+                /* Check if end of sequence has been reached, or the frame could
+                   not be decoded, and if so, stop decoder */
+                if ( frame->snippet_id == WM_FRAME_END ) {
+                    wm_decoder_stop(decoder);
+                    return 1;
+                }
+                if ( frame->snippet_id == WM_FRAME_ERROR ) {
+                    wm_decoder_stop(decoder);
+                    return 2;
+                }
+
+                decoder->loop_count = frame->loop_count;
+
+                /* Set drive frequency */
+                decoder->frequency = frame->frequency;
+
+            }
+
+            /* Initialise PWL index to start of snippet */
+            decoder->pwl_index = program->snippet_pwl[frame->snippet_id];
+            decoder->pwl_end = decoder->pwl_index + program->snippet_len[frame->snippet_id];
+
+        }
+
+        pwl = &program->pwls[decoder->pwl_index++];
 
-    /* Extract frequency */
-    decoder->frame_data.frequency = (byte_1->FREQ << 8) | decoder->wm_data[decoder->frame_index++];
+        /* Calculate segment parameters from frame and PWL pair parameters */
+        decoder->segment.start_time = decoder->segment.end_time;
+        decoder->segment.end_time = decoder->segment.start_time + ((pwl->time & ~WM_PWL_RAMP) << frame->time_shift);
+        end_amplitude = pwl->amplitude * (1 << frame->gain_shift);
+        decoder->segment.start_amplitude = (pwl->time & WM_PWL_RAMP) ? decoder->segment.end_amplitude : end_amplitude;
+        decoder->segment.end_amplitude = end_amplitude;
+
+#ifdef TRACE_ENABLE
+        TRACE("        Segment Parameters:\n");
+        TRACE("          Start Time      = %d\n", decoder->segment.start_time);
+        TRACE("          End Time        = %d\n", decoder->segment.end_time);
+        TRACE("          Start Amplitude = %d\n", decoder->segment.start_amplitude);
+        TRACE("          End Amplitude   = %d\n", decoder->segment.end_amplitude);
+#endif
+
+    }
+
+    /* Convert start/end amplitudes to fixed-point representation */
+    scaler = decoder->flags.ACCELERATION_EN ? 4369 : 4681;
+    shift = decoder->flags.ACCELERATION_EN ? 4 : 3;
+    decoder->start_level = (decoder->segment.start_amplitude * scaler) >> shift;
+    decoder->end_level = (decoder->segment.end_amplitude * scaler) >> shift;
 
     return 0;
 
 }
 
 
+/*
+ * Calculates amplitude at given time within the current segment.
+ *
+ * @param decoder        Pointer to the waveform memory decoder instance
+ *                       structure
+ * @param playback_time  Time since start of sequence
+ *
+ * @return               Drive amplitude
+ */
+static inline int16_t wm_decoder_level(const wm_decoder *decoder, uint32_t playback_time)
+{
+    int32_t start_amplitude = decoder->start_level;
+    int32_t end_amplitude = decoder->end_level;
+    uint32_t segment_time, segment_duration;
+    int32_t scaler;
+
+    /* Flat segment, the interpolation below gives the start amplitude */
+    if ( start_amplitude == end_amplitude )
+        return start_amplitude;
+
+    /* Calculate ratio for current time within current segment */
+    segment_time = (playback_time - (decoder->segment.start_time << TIMER_DIV_SHIFT)) >> (TIMER_DIV_SHIFT - 8);
+    segment_duration = (decoder->segment.end_time - decoder->segment.start_time) << 8;
+    scaler = (segment_time << 15) / segment_duration;
+
+    /* Calculate amplitude by interpolating start/end amplitudes according to
+       ratio */
+    return start_amplitude + ((scaler * (end_amplitude - start_amplitude)) >> 15);
+}
+
+
 /*
  * Initialises waveform memory decoder.
  *
@@ -212,6 +429,9 @@ void wm_decoder_init(wm_decoder *decoder, uint8_t *wm_data, unsigned ACCELERATIO
     decoder->flags.ACCELERATION_EN = ACCELERATION_EN;
     decoder->flags.FREQ_WAVEFORM_TIMEBASE = FREQ_WAVEFORM_TIMEBASE;
 
+    /* Decode all sequences into the frame and PWL tables */
+    wm_compile(decoder);
+
     /* Initialise sequence ID */
     decoder->sequence_id = WM_SEQUENCE_ID_NONE;
 
@@ -239,7 +459,7 @@ unsigned wm_decoder_trigger_sequence(wm_decoder *decoder, uint32_t time, unsigne
     unsigned curr_sequence_id = decoder->sequence_id;
 
     /* Ensure sequence exists for given sequence ID. If not return error. */
-    if ( sequence_id >= decoder->wm_data[1] )
+    if ( sequence_id >= decoder->program.n_sequences )
         return 1;
 
     /* If a sequence is already being played back, stop it. */
@@ -279,123 +499,81 @@ unsigned wm_decoder_trigger_sequence(wm_decoder *decoder, uint32_t time, unsigne
  */
 unsigned wm_decoder_update(wm_decoder *decoder, uint32_t time)
 {
-    int shift;
-    unsigned end_index;
-    int32_t start_amplitude, end_amplitude, scaler;
-    uint32_t segment_time, segment_duration;
-    wm_pwl_byte *pwl;
-    uint8_t timebase_shifts[] = {0, 2, 4, 5, 6};
-    wm_pwl_byte snippet_0_pwl = {0, 1, 0};
+    unsigned state;
     uint32_t playback_time = time - decoder->start_time;
-    uint16_t playback_timebases = playback_time >> TIMER_DIV_SHIFT;
 
     /* If decoder is idle simply return state */
     if ( decoder->sequence_id == WM_SEQUENCE_ID_NONE )
         return 1;
 
-    /* Check if current time has advanced beyond current segment and if so,
-       iterate through sequence frames, snippets and PWL pairs until an
-       appropriate PWL pair is found or the sequence ends  */
-    while ( !decoder->segment.end_time || playback_timebases >= decoder->segment.end_time ) {
-
-        /* Check if end of snippet has been reached and if so, ... */
-        if ( !decoder->frame_data.snippet_id || decoder->pwl_index > WM_SNIPPET_END_INDEX(decoder->wm_data, decoder->frame_data.snippet_id) ) {
-
-            /* Check frame loop counter to see if current frame needs to be
-               repeated and if not decode the next frame */
-            if ( !decoder->frame_data.loop_count-- ) {
-
-                /* Check if end of sequence has been reached and if so, stop
-                   decoder */
-                end_index = WM_SEQUENCE_END_INDEX(decoder->wm_data, decoder->sequence_id);
-                if ( decoder->frame_index == end_index + 1 ) {
-                    wm_decoder_stop(decoder);
-                    return 1;
-                }
+    /* Move to the segment containing the current time */
+    state = wm_decoder_advance(decoder, playback_time >> TIMER_DIV_SHIFT);
+    if ( state )
+        return state;
 
-                /* Decode frame at current frame index, checking frame validity
-                   and if invalid, stop decoder and return error */
-                if ( wm_decode_frame(decoder, end_index) ) {
-#ifdef TRACE_ENABLE
-                    TRACE("  Error decoding frame at index %d.\n", decoder->frame_index);
-#endif
-                    wm_decoder_stop(decoder);
-                    return 2;
-                }
+    decoder->amplitude = wm_decoder_level(decoder, playback_time);
 
-                /* Set drive frequency */
-                decoder->frequency = decoder->frame_data.frequency < 12 ? 0 : (decoder->frame_data.frequency + 1) * 2;
+    return 0;
 
-#ifdef TRACE_ENABLE
-                TRACE("    Snippet ID = %d\n", decoder->frame_data.snippet_id);
-                TRACE("    Timebase   = %d\n", decoder->frame_data.timebase);
-                TRACE("    Gain       = %d\n", decoder->frame_data.gain);
-                TRACE("    Loop Count = %d\n", decoder->frame_data.loop_count);
-                TRACE("    Frequency  = %d\n", decoder->frame_data.frequency);
-#endif
+}
 
-            }
 
-            /* Initialise PWL index to start of snippet */
-            decoder->pwl_index = decoder->frame_data.snippet_id ? WM_SNIPPET_INDEX(decoder->wm_data, decoder->frame_data.snippet_id) : 0;
+/*
+ * Renders drive parameters for a block of equally spaced times.
+ *
+ * @param decoder      Pointer to the waveform memory decoder instance
+ *                     structure
+ * @param time         Time of the first entry
+ * @param step         Time between entries
+ * @param amplitude    Drive amplitudes, count entries
+ * @param frequency    Drive frequencies, count entries (can be NULL)
+ * @param count        Number of entries to render
+ *
+ * @return             Decoder state information:
+ *                       0: Playback of sequence active after the last entry
+ *                       1: Playback of sequence complete
+ *                       2: Waveform memory decode error within the block
+ */
+unsigned wm_decoder_render(wm_decoder *decoder, uint32_t time, uint32_t step,
+                           int16_t *amplitude, uint16_t *frequency, unsigned count)
+{
+    unsigned i = 0;
+    unsigned state = 1;
+    uint32_t playback_time = time - decoder->start_time;
+    uint16_t playback_timebases;
 
-#ifdef TRACE_ENABLE
-            TRACE("    Decoding snippet %d:\n", decoder->frame_data.snippet_id);
-#endif
+    if ( decoder->sequence_id != WM_SEQUENCE_ID_NONE ) {
 
-        }
+        state = 0;
 
-        /* Decode PWL pair at current PWL index */
-        pwl = decoder->frame_data.snippet_id ? (wm_pwl_byte *) &decoder->wm_data[decoder->pwl_index] : &snippet_0_pwl;
+        for ( ; i < count; i++, playback_time += step ) {
 
-#ifdef TRACE_ENABLE
-        TRACE("      Decoding PWL at index %d:\n", decoder->pwl_index);
-        TRACE("        RMP  = %d\n", pwl->RMP);
-        TRACE("        TIME = %d\n", pwl->TIME);
-        TRACE("        AMP  = %d\n", pwl->AMP);
-#endif
+            /* Only look at the tables when the current segment has ended */
+            playback_timebases = playback_time >> TIMER_DIV_SHIFT;
+            if ( !decoder->segment.end_time || playback_timebases >= decoder->segment.end_time ) {
+                state = wm_decoder_advance(decoder, playback_timebases);
+                if ( state )
+                    break;
+            }
 
-        /* Increment PWL index */
-        decoder->pwl_index++;
+            amplitude[i] = wm_decoder_level(decoder, playback_time);
+            if ( frequency )
+                frequency[i] = decoder->frequency;
 
-        /* Calculate segment parameters from frame and PWL pair parameters */
-        decoder->segment.start_time = decoder->segment.end_time;
-        decoder->segment.end_time = decoder->segment.start_time + (pwl->TIME + 1) * (1 << timebase_shifts[decoder->frame_data.timebase + !decoder->flags.FREQ_WAVEFORM_TIMEBASE]);
-        end_amplitude = pwl->AMP;
-        if ( !decoder->flags.ACCELERATION_EN && end_amplitude > 7) {
-            end_amplitude -= 16;
-            if ( end_amplitude < -7 )
-                end_amplitude = -7;
         }
-        end_amplitude <<= 3 - decoder->frame_data.gain;
-        decoder->segment.start_amplitude = pwl->RMP ? decoder->segment.end_amplitude : end_amplitude;
-        decoder->segment.end_amplitude = end_amplitude;
 
-#ifdef TRACE_ENABLE
-        TRACE("        Segment Parameters:\n");
-        TRACE("          Start Time      = %d\n", decoder->segment.start_time);
-        TRACE("          End Time        = %d\n", decoder->segment.end_time);
-        TRACE("          Start Amplitude = %d\n", decoder->segment.start_amplitude);
-        TRACE("          End Amplitude   = %d\n", decoder->segment.end_amplitude);
-#endif
+        if ( !state && i )
+            decoder->amplitude = amplitude[i - 1];
 
     }
 
-    /* Convert start/end amplitudes to fixed-point representation */
-    scaler = decoder->flags.ACCELERATION_EN ? 4369 : 4681;
-    shift = decoder->flags.ACCELERATION_EN ? 4 : 3;
-    start_amplitude = (decoder->segment.start_amplitude * scaler) >> shift;
-    end_amplitude = (decoder->segment.end_amplitude * scaler) >> shift;
-
-    /* Calculate ratio for current time within current segment */
-    segment_time = (playback_time - (decoder->segment.start_time << TIMER_DIV_SHIFT)) >> (TIMER_DIV_SHIFT - 8);
-    segment_duration = (decoder->segment.end_time - decoder->segment.start_time) << 8;
-    scaler = (segment_time << 15) / segment_duration;
-
-    /* Calculate amplitude by interpolating start/end amplitudes according to
-       ratio */
-    decoder->amplitude = start_amplitude + ((scaler * (end_amplitude - start_amplitude)) >> 15);
+    /* Decoder is idle, drive parameters are reset */
+    for ( ; i < count; i++ ) {
+        amplitude[i] = 0;
+        if ( frequency )
+            frequency[i] = 0;
+    }
 
-    return 0;
+    return state;
 
 }
@@ -53,10 +53,11 @@ typedef enum {
  * The logging module can be configured in four distinct, mutually exclusive
  * modes.
  *
- * The STANDALONE mode uses a queue into which messages are inserted. For each
- * message, a buffer is allocated. A logging-specific task is instantiated, that
- * dequeues the messages, one at a time, writes them to uart and then frees up
- * the buffer. The queue is used to provide 1. rate-decoupling, i.e. absorb
+ * The STANDALONE mode uses a queue into which messages are inserted. The queue
+ * is a ring buffer into which messages are formatted directly, no buffer is
+ * allocated per message. A logging-specific task is instantiated, that
+ * dequeues the messages, one at a time, writes them to uart from the ring buffer
+ * and then releases them. The queue is used to provide 1. rate-decoupling, i.e. absorb
  * peaks of logging rate, and 2. to provide atomicity, i.e. each message will be
  * printed on its entirety on the UART; no messages will be mixed, even if
  * logged simultaneously by two different tasks.
@@ -126,6 +127,9 @@ typedef enum {
  * less than this number (in bytes), the log will be suppressed. This ensures that
  * logs don't fill up the system memory.
  *
+ * NOTE: Standalone and Queue modes store messages in a ring buffer of
+ * LOGGING_RINGBUF_SIZE bytes and don't use the heap, so this is not checked.
+ *
  */
 #ifndef LOGGING_MIN_ALLOWED_FREE_HEAP
 #define LOGGING_MIN_ALLOWED_FREE_HEAP 600
@@ -234,22 +238,33 @@ typedef enum {
 /**
  * \brief Logging queue length
  *
- * In Standalone or Queue mode, defines the number of log entries available in
- * the logging queue. When the queue fills up, any additional entries will be
- * silently discarded.
+ * In Standalone or Queue mode, defines the number of average sized log entries
+ * the logging queue is dimensioned for (see LOGGING_RINGBUF_SIZE).
  */
 #ifndef LOGGING_QUEUE_LENGTH
 #define LOGGING_QUEUE_LENGTH 12
 #endif
 
+/**
+ * \brief Logging ring buffer size
+ *
+ * In Standalone or Queue mode, defines the size in bytes of the ring buffer
+ * holding the log messages. Every message takes its length rounded up to a
+ * multiple of 4, plus 4 bytes. When the ring buffer fills up, any additional
+ * entries will be silently discarded. Must be a multiple of 4.
+ */
+#ifndef LOGGING_RINGBUF_SIZE
+#define LOGGING_RINGBUF_SIZE (LOGGING_QUEUE_LENGTH * 64)
+#endif
+
 /**
  * \brief Minimum message size
  *
  * When in Standalone or Queue mode, the log_printf function will first
- * allocate a buffer of LOGGING_MIN_MSG_SIZE size and attempt to fill it with
- * the parsed log message. If the buffer doesn't fit the message, it will be
- * freed and a new buffer will be allocated with enough space to fill the, then
- * known, parsed message.
+ * reserve LOGGING_MIN_MSG_SIZE bytes in the ring buffer and attempt to fill them
+ * with the parsed log message. If the space doesn't fit the message, enough
+ * space for the, then known, parsed message will be reserved and the message
+ * will be parsed again.
  *
  * This value should be large enough to accomodate most messages with incurring
  * the extra processing, but also small enough to avoid unnecessary space waste.
@@ -266,7 +281,8 @@ typedef enum {
  * full) will be counted. When the queue gets empty, a log indicating the
  * number of suppressed messages will be sent to the queue.
  *
- * NOTE: This involves a critical section, so it may incur an overhead, if set
+ * NOTE: The counter is protected by the logging mutex, which is taken for
+ * every message anyway
  *
  */
 #ifndef LOGGING_SUPPRESSED_COUNT_ENABLE
@@ -372,8 +388,8 @@ void log_printf_raw(const char *fmt, ...);
  *       \<T\>: The log tag. A small number (0, 1, etc...)
  *       \<message\>: The actual log message
  *
- * This function (in Standalone or Queue mode) allocates / frees memory. It
- * MUST NOT be used from an ISR.
+ * This function (in Standalone or Queue mode) takes a mutex. It MUST NOT be
+ * used from an ISR.
  *
  * \param[in] severity - A logging_severity_e enum value. Represents the severity
  *            level for the log. If this is >= LOGGING_MIN_COMPILED_SEVERITY
@@ -23,6 +23,7 @@
 
 
 #include "sdk_defs.h"
+#include "sdk_ringbuf.h"
 #include "logging.h"
 
 #include "hw_sys.h"
@@ -66,7 +67,22 @@
 
 #ifdef USE_QUEUE
 
-__RETAINED static OS_QUEUE xLogQueue;
+/*
+ * Log messages are formatted directly into the ring buffer. Producers are tasks only, they are
+ * serialized by the mutex so the consumer never needs to disable interrupts.
+ */
+__RETAINED static uint32_t log_ring_buf[LOGGING_RINGBUF_SIZE / sizeof(uint32_t)];
+__RETAINED static ringbuf_t log_ring;
+__RETAINED static OS_MUTEX log_mutex;
+
+#ifdef LOGGING_MODE_STANDALONE
+/* Signaled when a message was put in the ring buffer */
+__RETAINED static OS_EVENT log_pending;
+#if (dg_configENABLE_TASK_PROFILER == 1)
+/* Ring buffer id of the task profiler, which reports the logging latency */
+__RETAINED static uint32_t log_profiler_id;
+#endif
+#endif
 
 #if LOGGING_SUPPRESSED_COUNT_ENABLE == 1
 __RETAINED static uint32_t suppressed_messages;
@@ -183,7 +199,8 @@ static void uart_tx_cb(void *user_data, uint16_t written)
  */
 static void prvLogTask(void *pvParameters)
 {
-        struct mcif_message_s *current_message;
+        void *current_message;
+        uint32_t len;
 
 #if LOGGING_USE_DMA == 1
         hw_uart_tx_callback cb = uart_tx_cb;
@@ -193,15 +210,20 @@ static void prvLogTask(void *pvParameters)
 
         for (;;) {
                 is_active = false;
-                OS_QUEUE_GET(xLogQueue, &current_message, portMAX_DELAY);
+                while ((current_message = ringbuf_msg_peek(&log_ring, &len)) == NULL) {
+#if (dg_configENABLE_TASK_PROFILER == 1)
+                        task_profiler_ring_wait(log_profiler_id);
+#endif
+                        OS_EVENT_WAIT(log_pending, OS_EVENT_FOREVER);
+                }
                 is_active = true;
 
                 hw_sys_pd_com_enable();
                 hw_gpio_pad_latch_enable(LOGGING_STANDALONE_GPIO_PORT_UART_TX, LOGGING_STANDALONE_GPIO_PIN_UART_TX);
                 uart_init();
 
-                hw_uart_send(LOGGING_STANDALONE_UART, current_message->buffer, current_message->len,
-                        cb, NULL);
+                /* Message is sent directly from the ring buffer and released when done */
+                hw_uart_send(LOGGING_STANDALONE_UART, current_message, len, cb, NULL);
                 while (hw_uart_is_busy(LOGGING_STANDALONE_UART)) {}
 
                 hw_gpio_pad_latch_disable(LOGGING_STANDALONE_GPIO_PORT_UART_TX, LOGGING_STANDALONE_GPIO_PIN_UART_TX);
@@ -210,7 +232,10 @@ static void prvLogTask(void *pvParameters)
 #if LOGGING_USE_DMA == 1
                 OS_EVENT_WAIT(xSemaphore, OS_EVENT_FOREVER);
 #endif
-                OS_FREE(current_message);
+                ringbuf_msg_consume(&log_ring);
+#if (dg_configENABLE_TASK_PROFILER == 1)
+                task_profiler_ring_take(log_profiler_id);
+#endif
         }
 }
 
@@ -232,13 +257,12 @@ void log_init(void)
 
 #ifdef USE_QUEUE
 #if LOGGING_SUPPRESSED_COUNT_ENABLE == 1
-        OS_ENTER_CRITICAL_SECTION();
         suppressed_messages = 0;
-        OS_LEAVE_CRITICAL_SECTION();
 #endif
 
-        OS_QUEUE_CREATE(xLogQueue, sizeof(struct mcif_message_s *), LOGGING_QUEUE_LENGTH);
-        OS_ASSERT(xLogQueue);
+        ringbuf_init(&log_ring, log_ring_buf, sizeof(log_ring_buf));
+        OS_MUTEX_CREATE(log_mutex);
+        OS_ASSERT(log_mutex);
 #endif
 
 #ifdef LOGGING_MODE_STANDALONE
@@ -247,6 +271,10 @@ void log_init(void)
 
 #if LOGGING_USE_DMA == 1
         OS_EVENT_CREATE(xSemaphore);
+#endif
+        OS_EVENT_CREATE(log_pending);
+#if (dg_configENABLE_TASK_PROFILER == 1)
+        log_profiler_id = task_profiler_register_ring("log");
 #endif
         // create FreeRTOS task
         OS_TASK LoggingTaskHandle = NULL;
@@ -271,150 +299,109 @@ void log_set_severity(logging_severity_e severity)
 
 #ifdef USE_QUEUE
 
-#if LOGGING_SUPPRESSED_COUNT_ENABLE == 1
-#define SUPPRESSED_BUFFER_SZ sizeof(LOGGING_SUPPRESSED_MSG_TMPL) + 24
-__STATIC_INLINE void log_suppressed(void)
+/*
+ * Format message into the ring buffer, called with log_mutex taken
+ *
+ * A buffer of LOGGING_MIN_MSG_SIZE is tried first, longer messages are formatted again once
+ * their size is known. Reserved space is only taken by ringbuf_msg_commit(), so it can be
+ * reserved again with another size.
+ */
+static bool log_put(const char *fmt, va_list args)
 {
-        struct mcif_message_s *msg;
-        uint32_t suppressed_count;
-
-        if ((LOGGING_SUPPRESSED_SEVERITY < LOGGING_MIN_COMPILED_SEVERITY) ||
-                (LOGGING_SUPPRESSED_SEVERITY < logging_min_severity))
-                return;
-
+        va_list args_copy;
+        char *buf;
+        int n;
 
-        /* Get a local, thread-safe reference of suppressed_messages. We don't want to
-         * close interrupts while calling snprintf
-         */
-        OS_ENTER_CRITICAL_SECTION();
-        suppressed_count = suppressed_messages;
-        OS_LEAVE_CRITICAL_SECTION();
+        buf = ringbuf_msg_reserve(&log_ring, LOGGING_MIN_MSG_SIZE);
+        if (!buf) {
+                return false;
+        }
 
-        /* If suppressed messages >= LOGGING_SUPPRESSED_MIN_COUNT
-         * try to queue a suppressed messages log
-         */
-        if (suppressed_count >= LOGGING_SUPPRESSED_MIN_COUNT) {
+        va_copy(args_copy, args);
+        n = vsnprintf(buf, LOGGING_MIN_MSG_SIZE, fmt, args_copy);
+        va_end(args_copy);
 
-                /* Early check to skip unneeded (and perhaps catastrophic)
-                 * allocations and snprintf processing
-                 */
-                if (uxQueueSpacesAvailable(xLogQueue) == 0) {
-                        return;
+        if (n >= LOGGING_MIN_MSG_SIZE) {
+                buf = ringbuf_msg_reserve(&log_ring, n + 1);
+                if (!buf) {
+                        return false;
                 }
+                vsnprintf(buf, n + 1, fmt, args);
+        }
 
-                /* allocate a few bytes more to account for the
-                 * "header" string AND the bytes in the actual
-                 * suppressed count.
-                 */
-                msg = OS_MALLOC(sizeof(struct mcif_message_s) +
-                SUPPRESSED_BUFFER_SZ);
-
-                msg->len = 1 + snprintf(msg->buffer, SUPPRESSED_BUFFER_SZ,
-                        "[%lu] %c %d " LOGGING_SUPPRESSED_MSG_TMPL,
-                        OS_GET_TICK_COUNT(),
-                        logging_severity_chars[LOGGING_SUPPRESSED_SEVERITY],
-                        LOGGING_SUPPRESSED_TAG,
-                        suppressed_count);
-
-                /* Attempt to queue the message. If it succeeds, subtract the printed
-                 * suppressed_messages counter from the total suppressed messages (because
-                 * in the meanwhile, more messages may get suppressed).
-                 */
-                if (OS_QUEUE_PUT(xLogQueue, &msg, 0) != pdPASS) {
-                        /* Still full. Try later */
-                        OS_FREE(msg);
-                }
-                else {
-                        OS_ENTER_CRITICAL_SECTION();
-                        suppressed_messages -= suppressed_count;
-                        OS_LEAVE_CRITICAL_SECTION();
-                }
+#if defined(LOGGING_MODE_STANDALONE) && (dg_configENABLE_TASK_PROFILER == 1)
+        /* Before the commit, the logging task cannot take the message before it is reported */
+        task_profiler_ring_put(log_profiler_id, ringbuf_is_empty(&log_ring));
+#endif
+        ringbuf_msg_commit(&log_ring, buf, n + 1);
 
-        }
+        return true;
 }
-#endif
 
-__STATIC_INLINE void log_send(struct mcif_message_s *msg)
+static bool log_put_fmt(const char *fmt, ...)
 {
+        va_list args;
+        bool ret;
+
+        va_start(args, fmt);
+        ret = log_put(fmt, args);
+        va_end(args);
+
+        return ret;
+}
 
-        /* Even though we checked before for space in the queue, some other
-         * task may get it before we reach this point
-         */
-        if (OS_QUEUE_PUT(xLogQueue, &msg, 0) != pdPASS) {
-                OS_FREE(msg);
 #if LOGGING_SUPPRESSED_COUNT_ENABLE == 1
-                OS_ENTER_CRITICAL_SECTION();
-                suppressed_messages++;
-                OS_LEAVE_CRITICAL_SECTION();
-#endif
+/*
+ * Report suppressed messages, called with log_mutex taken
+ */
+__STATIC_INLINE void log_suppressed(void)
+{
+        if ((LOGGING_SUPPRESSED_SEVERITY < LOGGING_MIN_COMPILED_SEVERITY) ||
+                (LOGGING_SUPPRESSED_SEVERITY < logging_min_severity))
                 return;
-        }
 
-#if LOGGING_SUPPRESSED_COUNT_ENABLE == 1
-        log_suppressed();
-#endif
+        /* If suppressed messages >= LOGGING_SUPPRESSED_MIN_COUNT
+         * try to queue a suppressed messages log
+         */
+        if (suppressed_messages >= LOGGING_SUPPRESSED_MIN_COUNT) {
+                /* If the ring buffer is still full, try later */
+                if (log_put_fmt("[%lu] %c %d " LOGGING_SUPPRESSED_MSG_TMPL,
+                                OS_GET_TICK_COUNT(),
+                                logging_severity_chars[LOGGING_SUPPRESSED_SEVERITY],
+                                LOGGING_SUPPRESSED_TAG,
+                                suppressed_messages)) {
+                        suppressed_messages = 0;
+                }
+        }
 }
+#endif
 
 void log_printf_raw(const char *fmt, ...)
 {
         va_list args;
-        int n;
-        struct mcif_message_s *msg;
+        bool queued;
 
-        /* Check for space (although some other task may still get the available slot later)
-         * to save some time (and memory peaking) from the malloc and copy
-         */
-        if (uxQueueSpacesAvailable(xLogQueue) == 0) {
-#if LOGGING_SUPPRESSED_COUNT_ENABLE == 1
-                OS_ENTER_CRITICAL_SECTION();
-                suppressed_messages++;
-                OS_LEAVE_CRITICAL_SECTION();
-#endif
-                return;
-        }
+        OS_MUTEX_GET(log_mutex, OS_MUTEX_FOREVER);
+
+        va_start(args, fmt);
+        queued = log_put(fmt, args);
+        va_end(args);
 
-#if LOGGING_MIN_ALLOWED_FREE_HEAP
-        OS_ENTER_CRITICAL_SECTION();
-        if (xPortGetFreeHeapSize() <= LOGGING_MIN_ALLOWED_FREE_HEAP) {
 #if LOGGING_SUPPRESSED_COUNT_ENABLE == 1
+        if (queued) {
+                log_suppressed();
+        } else {
                 suppressed_messages++;
-#endif
-                OS_LEAVE_CRITICAL_SECTION();
-                return;
         }
 #endif
-        msg = OS_MALLOC(
-                sizeof(struct mcif_message_s) + LOGGING_MIN_MSG_SIZE);
-#if LOGGING_MIN_ALLOWED_FREE_HEAP
-        OS_LEAVE_CRITICAL_SECTION();
-#endif
 
-        va_start(args, fmt);
-        n = vsnprintf(msg->buffer, LOGGING_MIN_MSG_SIZE, fmt, args);
-        va_end(args);
+        OS_MUTEX_PUT(log_mutex);
 
-        if (n >= LOGGING_MIN_MSG_SIZE) {
-                OS_FREE(msg);
-#if LOGGING_MIN_ALLOWED_FREE_HEAP
-                OS_ENTER_CRITICAL_SECTION();
-                if (xPortGetFreeHeapSize() <= LOGGING_MIN_ALLOWED_FREE_HEAP) {
-#if LOGGING_SUPPRESSED_COUNT_ENABLE == 1
-                        suppressed_messages++;
-#endif
-                        OS_LEAVE_CRITICAL_SECTION();
-                        return;
-                }
-#endif
-                msg = OS_MALLOC(sizeof(struct mcif_message_s) + n + 1);
-#if LOGGING_MIN_ALLOWED_FREE_HEAP
-                OS_LEAVE_CRITICAL_SECTION();
-#endif
-                va_start(args, fmt);
-                vsnprintf(msg->buffer, n + 1, fmt, args);
-                va_end(args);
+#ifdef LOGGING_MODE_STANDALONE
+        if (queued) {
+                OS_EVENT_SIGNAL(log_pending);
         }
-        msg->len = n + 1;
-        log_send(msg);
+#endif
 }
 
 #endif /* USE_QUEUE */
@@ -0,0 +1,379 @@
+/**
+ * \addtogroup MIDDLEWARE
+ * \{
+ * \addtogroup SLEEP_ANALYTICS
+ * \{
+ */
+
+/*
+ *****************************************************************************************
+ *
+ * @file sleep_analytics.c
+ *
+ * @brief Sleep decision analytics of the power manager
+ *
+ * Copyright (C) 2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ *****************************************************************************************
+ */
+
+#include <string.h>
+#include "sdk_defs.h"
+#include "osal.h"
+#include "hw_pdc.h"
+#include "hw_timer.h"
+#include "sys_clock_mgr.h"
+#include "sys_timer.h"
+#include "sleep_analytics.h"
+#ifdef SLEEP_ANALYTICS_UART_CONFIG
+#include "ad_uart.h"
+#else
+#include "SEGGER_RTT.h"
+#endif
+
+#if (dg_configENABLE_SLEEP_ANALYTICS == 1)
+
+#if (SLEEP_ANALYTICS_RING_SIZE & (SLEEP_ANALYTICS_RING_SIZE - 1)) != 0
+#error SLEEP_ANALYTICS_RING_SIZE must be a power of 2.
+#endif
+
+#define SA_TASK_PRIORITY        ( OS_TASK_PRIORITY_NORMAL )
+#define SA_TASK_STACK_SIZE      ( 512 )
+
+/* Hello and PDC LUT are sent again every so many periods, so that a host attaching late catches up */
+#define SA_ANNOUNCE_PERIODS     ( 10 )
+
+/* Records are collected in a buffer and sent together; the largest one is the PDC LUT */
+#define SA_MAX_RECORD_SIZE      ( 2 + 4 * HW_PDC_LUT_SIZE )
+#define SA_TX_BUFFER_SIZE       ( 256 )
+
+#define SA_LP_CNT_MASK          ( TIMER2_TIMER2_TIMER_VAL_REG_TIM_TIMER_VALUE_Msk >> \
+                                  TIMER2_TIMER2_TIMER_VAL_REG_TIM_TIMER_VALUE_Pos )
+
+typedef struct {
+        sa_event_t event;
+        uint32_t woken_time;
+        uint32_t resumed_time;
+        bool woken;
+        bool xtal_ready;
+} sa_current_t;
+
+__RETAINED static OS_TASK sa_task_handle;
+__RETAINED static sa_event_t sa_ring[SLEEP_ANALYTICS_RING_SIZE];
+__RETAINED static volatile uint32_t sa_ring_head;
+__RETAINED static volatile uint32_t sa_ring_tail;
+__RETAINED static uint32_t sa_dropped;
+__RETAINED static sa_current_t sa_current;
+__RETAINED static uint8_t sa_tx_buffer[SA_TX_BUFFER_SIZE];
+__RETAINED static uint32_t sa_tx_len;
+__RETAINED static uint32_t sa_tx_records;
+#ifndef SLEEP_ANALYTICS_UART_CONFIG
+__RETAINED static uint8_t sa_rtt_buffer[SLEEP_ANALYTICS_RTT_BUFFER_SIZE];
+#endif
+
+static uint16_t saturate_u16(uint32_t v)
+{
+        return v > UINT16_MAX ? UINT16_MAX : v;
+}
+
+/*
+ * Hooks, called by the power manager from the idle task with the scheduler suspended
+ */
+
+void sa_pm_enter(uint8_t mode)
+{
+        memset(&sa_current, 0, sizeof(sa_current));
+        sa_current.event.timestamp = (uint32_t)sys_timer_get_uptime_ticks_fromISR();
+        sa_current.event.mode = mode;
+        sa_current.event.count = 1;
+}
+
+void sa_pm_stay_awake(SA_AWAKE reason, uint32_t detail)
+{
+        /* Only the first reason is kept, the later checks merely confirm it */
+        if (sa_current.event.reason == SA_AWAKE_NONE) {
+                sa_current.event.reason = reason;
+                sa_current.event.detail = detail;
+        }
+}
+
+void sa_pm_irq_pending(void)
+{
+        uint32_t pending;
+        uint32_t irq = 0;
+
+        pending = NVIC->ISER[0] & NVIC->ISPR[0] & ~(1UL << XTAL32M_RDY_IRQn);
+        if (pending == 0) {
+                pending = NVIC->ISER[1] & NVIC->ISPR[1];
+                irq = 32;
+        }
+        if (pending) {
+                irq += __CLZ(__RBIT(pending));
+        }
+
+        sa_pm_stay_awake(SA_AWAKE_IRQ_PENDING, irq);
+}
+
+/* Called right after wake-up, while the flash is still powered down */
+__RETAINED_CODE void sa_pm_woken_up(void)
+{
+        sa_current.woken_time = hw_timer_get_count(HW_TIMER2);
+        sa_current.event.pdc_pending = hw_pdc_get_pending_cm33();
+        sa_current.woken = true;
+}
+
+void sa_pm_resumed(void)
+{
+        if (sa_current.woken) {
+                sa_current.resumed_time = hw_timer_get_count(HW_TIMER2);
+                sa_current.xtal_ready = cm_poll_xtalm_ready();
+        }
+}
+
+void sa_pm_sysclk_ready(void)
+{
+        uint32_t now;
+
+        if (!sa_current.woken) {
+                return;
+        }
+
+        now = hw_timer_get_count(HW_TIMER2);
+        sa_current.event.wake_latency =
+                        saturate_u16((now - sa_current.woken_time) & SA_LP_CNT_MASK);
+        if (!sa_current.xtal_ready) {
+                sa_current.event.xtal_wait =
+                        saturate_u16((now - sa_current.resumed_time) & SA_LP_CNT_MASK);
+        }
+}
+
+static bool merge_event(const sa_event_t *ev)
+{
+        sa_event_t *last;
+
+        /* Only into an event the export task has not taken yet */
+        if (sa_ring_head == sa_ring_tail) {
+                return false;
+        }
+
+        last = &sa_ring[(sa_ring_head - 1) & (SLEEP_ANALYTICS_RING_SIZE - 1)];
+
+        if (ev->state == SA_STATE_SLEEP || last->state != ev->state || last->mode != ev->mode ||
+                        last->reason != ev->reason || last->detail != ev->detail ||
+                        last->count == UINT16_MAX) {
+                return false;
+        }
+
+        last->active = ev->timestamp - last->timestamp - last->duration;
+        last->duration += ev->duration;
+        last->count++;
+
+        return true;
+}
+
+void sa_pm_exit(bool tick_stopped)
+{
+        sa_event_t *ev = &sa_current.event;
+        uint32_t head = sa_ring_head;
+
+        ev->duration = (uint32_t)sys_timer_get_uptime_ticks_fromISR() - ev->timestamp;
+
+        if (sa_current.woken) {
+                ev->state = SA_STATE_SLEEP;
+        } else {
+                ev->state = tick_stopped ? SA_STATE_IDLE : SA_STATE_TICK;
+                if (ev->reason == SA_AWAKE_NONE) {
+                        /* goto_deepsleep() gave up, or the tick was kept for the next OS timer */
+                        ev->reason = tick_stopped ? SA_AWAKE_SLEEP_ABORTED : SA_AWAKE_TOO_SHORT;
+                }
+        }
+
+        if (merge_event(ev)) {
+                return;
+        }
+
+        if (head - sa_ring_tail >= SLEEP_ANALYTICS_RING_SIZE) {
+                sa_dropped++;
+                return;
+        }
+
+        sa_ring[head & (SLEEP_ANALYTICS_RING_SIZE - 1)] = *ev;
+        __DMB();
+        sa_ring_head = head + 1;
+}
+
+uint32_t sleep_analytics_read(sa_event_t *events, uint32_t max)
+{
+        uint32_t n = 0;
+        uint32_t tail;
+
+        OS_ENTER_CRITICAL_SECTION();
+        tail = sa_ring_tail;
+        while (n < max && tail != sa_ring_head) {
+                events[n++] = sa_ring[tail & (SLEEP_ANALYTICS_RING_SIZE - 1)];
+                tail++;
+        }
+        sa_ring_tail = tail;
+        OS_LEAVE_CRITICAL_SECTION();
+
+        return n;
+}
+
+/*
+ * Export
+ */
+
+static void put_u16(uint8_t **p, uint16_t v)
+{
+        *(*p)++ = v;
+        *(*p)++ = v >> 8;
+}
+
+static void put_u32(uint8_t **p, uint32_t v)
+{
+        put_u16(p, v);
+        put_u16(p, v >> 16);
+}
+
+static void flush_records(void)
+{
+        if (sa_tx_len == 0) {
+                return;
+        }
+
+#ifdef SLEEP_ANALYTICS_UART_CONFIG
+        {
+                ad_uart_handle_t uart = ad_uart_open(&SLEEP_ANALYTICS_UART_CONFIG);
+
+                if (uart) {
+                        ad_uart_write(uart, (const char *)sa_tx_buffer, sa_tx_len);
+                        ad_uart_close(uart, false);
+                } else {
+                        sa_dropped += sa_tx_records;
+                }
+        }
+#else
+        /* Whole records or nothing, the decoder can't resync on partial ones */
+        if (SEGGER_RTT_WriteSkipNoLock(SLEEP_ANALYTICS_RTT_CHANNEL, sa_tx_buffer, sa_tx_len) == 0) {
+                sa_dropped += sa_tx_records;
+        }
+#endif
+
+        sa_tx_len = 0;
+        sa_tx_records = 0;
+}
+
+static uint8_t *begin_record(void)
+{
+        if (sa_tx_len + SA_MAX_RECORD_SIZE > sizeof(sa_tx_buffer)) {
+                flush_records();
+        }
+
+        return &sa_tx_buffer[sa_tx_len + 2];
+}
+
+static void end_record(SA_REC type, uint8_t *end)
+{
+        uint8_t *rec = &sa_tx_buffer[sa_tx_len];
+
+        rec[0] = type;
+        rec[1] = end - rec - 2;
+        sa_tx_len = end - sa_tx_buffer;
+        sa_tx_records++;
+}
+
+static void send_hello(void)
+{
+        uint8_t *p = begin_record();
+        int i;
+
+        *p++ = SLEEP_ANALYTICS_FORMAT_VERSION;
+        put_u32(&p, configSYSTICK_CLOCK_HZ);
+        put_u16(&p, SLEEP_ANALYTICS_RING_SIZE);
+        end_record(SA_REC_HELLO, p);
+
+        /* The host names the wake-up sources after the PDC LUT entries */
+        p = begin_record();
+        for (i = 0; i < HW_PDC_LUT_SIZE; i++) {
+                put_u32(&p, hw_pdc_read_entry(i));
+        }
+        end_record(SA_REC_PDC_LUT, p);
+}
+
+static void send_events(void)
+{
+        sa_event_t ev;
+        uint8_t *p;
+
+        while (sleep_analytics_read(&ev, 1)) {
+                p = begin_record();
+                put_u32(&p, ev.timestamp);
+                put_u32(&p, ev.duration);
+                put_u32(&p, ev.active);
+                put_u16(&p, ev.wake_latency);
+                put_u16(&p, ev.xtal_wait);
+                put_u16(&p, ev.pdc_pending);
+                put_u16(&p, ev.count);
+                *p++ = ev.state;
+                *p++ = ev.mode;
+                *p++ = ev.reason;
+                *p++ = ev.detail;
+                end_record(SA_REC_EVENT, p);
+        }
+}
+
+static void send_period(void)
+{
+        uint8_t *p = begin_record();
+        uint32_t dropped;
+
+        OS_ENTER_CRITICAL_SECTION();
+        dropped = sa_dropped;
+        sa_dropped = 0;
+        OS_LEAVE_CRITICAL_SECTION();
+
+        put_u32(&p, (uint32_t)sys_timer_get_uptime_ticks());
+        put_u16(&p, saturate_u16(dropped));
+        end_record(SA_REC_PERIOD, p);
+}
+
+static void sa_task(void *params)
+{
+        uint32_t period = 0;
+
+        for (;;) {
+                OS_DELAY_MS(SLEEP_ANALYTICS_PERIOD_MS);
+
+                if ((period++ % SA_ANNOUNCE_PERIODS) == 0) {
+                        send_hello();
+                }
+                send_events();
+                send_period();
+                flush_records();
+        }
+}
+
+void sleep_analytics_init(void)
+{
+        if (sa_task_handle) {
+                return;
+        }
+
+#ifndef SLEEP_ANALYTICS_UART_CONFIG
+        SEGGER_RTT_ConfigUpBuffer(SLEEP_ANALYTICS_RTT_CHANNEL, "SleepAnalytics", sa_rtt_buffer,
+                                sizeof(sa_rtt_buffer), SEGGER_RTT_MODE_NO_BLOCK_SKIP);
+#endif
+
+        OS_TASK_CREATE("sleepan", sa_task, NULL, SA_TASK_STACK_SIZE, SA_TASK_PRIORITY,
+                                                                                sa_task_handle);
+        OS_ASSERT(sa_task_handle);
+}
+
+#endif /* dg_configENABLE_SLEEP_ANALYTICS */
+
+/**
+ * \}
+ * \}
+ */
@@ -0,0 +1,191 @@
+/**
+ * \addtogroup UTILITIES
+ * \{
+ * \addtogroup UTI_SLEEP_ANALYTICS
+ * \{
+ */
+
+/**
+ ****************************************************************************************
+ *
+ * @file sleep_analytics.h
+ *
+ * @brief Sleep decision analytics of the power manager
+ *
+ * Every pass through pm_sleep_enter() leaves one event in a retained ring buffer:
+ * - the state reached (tick kept running, idle, sleep) and the sleep mode,
+ * - the first reason that kept the system awake, with the adapter that deferred or vetoed
+ *   sleep or the pending interrupt that aborted it,
+ * - the PDC LUT entries pending at wake-up, i.e. the wake-up source,
+ * - the wake-up latency until the system clock is ready and the part of it spent waiting for
+ *   the XTAL32M to settle.
+ *
+ * A low priority task exports the events over a SEGGER RTT up channel or a UART.
+ * utilities/python_scripts/analysis/sleep_analytics_decode.py turns them into residency per
+ * sleep mode, wake-up latency histograms and an energy budget per wake-up source and per
+ * stay-awake reason.
+ *
+ * Copyright (C) 2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ *****************************************************************************************
+ */
+
+#ifndef SLEEP_ANALYTICS_H
+#define SLEEP_ANALYTICS_H
+
+#if (dg_configENABLE_SLEEP_ANALYTICS == 1)
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "sdk_defs.h"
+
+/**
+ * \brief Number of events kept in the retained ring buffer
+ *
+ * Must be a power of 2. Events that find the ring full are dropped and counted.
+ */
+#ifndef SLEEP_ANALYTICS_RING_SIZE
+#define SLEEP_ANALYTICS_RING_SIZE               (64)
+#endif
+
+/**
+ * \brief Export period in ms
+ */
+#ifndef SLEEP_ANALYTICS_PERIOD_MS
+#define SLEEP_ANALYTICS_PERIOD_MS               (1000)
+#endif
+
+/**
+ * \brief RTT up channel used for the export
+ *
+ * Channel 0 is the terminal, channel 1 is used by SystemView or the task profiler.
+ */
+#ifndef SLEEP_ANALYTICS_RTT_CHANNEL
+#define SLEEP_ANALYTICS_RTT_CHANNEL             (2)
+#endif
+
+/**
+ * \brief Size of the RTT up buffer
+ */
+#ifndef SLEEP_ANALYTICS_RTT_BUFFER_SIZE
+#define SLEEP_ANALYTICS_RTT_BUFFER_SIZE         (1024)
+#endif
+
+/*
+ * The events are exported over a UART instead of RTT when the application defines
+ * SLEEP_ANALYTICS_UART_CONFIG as an ad_uart_controller_conf_t. An attached debugger keeps the
+ * system out of sleep, so RTT is only useful for the idle side of the picture.
+ */
+
+/**
+ * \brief Version of the record format, increment on incompatible changes
+ */
+#define SLEEP_ANALYTICS_FORMAT_VERSION          (1)
+
+/**
+ * \brief Record types
+ *
+ * Every record starts with a type and a payload length byte, all values are little endian.
+ */
+typedef enum {
+        /** u8 version, u32 LP clock Hz, u16 ring size */
+        SA_REC_HELLO = 0x01,
+        /** u32 entries[HW_PDC_LUT_SIZE] */
+        SA_REC_PDC_LUT = 0x02,
+        /** u32 timestamp, u16 dropped events */
+        SA_REC_PERIOD = 0x10,
+        /** sa_event_t */
+        SA_REC_EVENT = 0x11,
+} SA_REC;
+
+/**
+ * \brief State reached in one pass through pm_sleep_enter()
+ */
+typedef enum {
+        SA_STATE_TICK,                  /**< WFI with the OS tick running */
+        SA_STATE_IDLE,                  /**< WFI with the OS tick stopped */
+        SA_STATE_SLEEP,                 /**< Powered down */
+} SA_STATE;
+
+/**
+ * \brief First reason that kept the system out of sleep
+ */
+typedef enum {
+        SA_AWAKE_NONE,                  /**< Entered sleep */
+        SA_AWAKE_MODE,                  /**< Sleep mode is active or idle, detail: sleep mode */
+        SA_AWAKE_FLASH_OP,              /**< Background flash operation pending */
+        SA_AWAKE_TRNG,                  /**< TRNG producing random numbers */
+        SA_AWAKE_DEBUGGER,              /**< Debugger attached or JTAG wake-up delay */
+        SA_AWAKE_WDOG,                  /**< Watchdog about to expire */
+        SA_AWAKE_TICK_LATE,             /**< OS tick already due */
+        SA_AWAKE_WAKEUP_TIME,           /**< OS timer closer than the wake-up time, detail: 1 if it includes XTAL32M settling */
+        SA_AWAKE_DEFERRED,              /**< pm_defer_sleep_for(), detail: adapter id */
+        SA_AWAKE_PREP_TIME,             /**< Adapter sleep preparation time, detail: adapter id */
+        SA_AWAKE_TOO_SHORT,             /**< Sleep period shorter than dg_configMIN_SLEEP_TIME */
+        SA_AWAKE_DMA,                   /**< DMA channel active */
+        SA_AWAKE_VETO,                  /**< ad_prepare_for_sleep() returned false, detail: adapter id */
+        SA_AWAKE_IRQ_PENDING,           /**< Interrupt pending before WFI, detail: IRQ number */
+        SA_AWAKE_SLEEP_ABORTED,         /**< Power down aborted by the hardware */
+} SA_AWAKE;
+
+/**
+ * \brief Event of one pass through pm_sleep_enter()
+ *
+ * Times are in LP clock cycles. The time between the end of an event and the timestamp of the
+ * next one is spent active.
+ *
+ * Consecutive passes that stay awake for the same reason (typically one per OS tick) are merged
+ * into one event while it is still in the ring buffer.
+ */
+typedef struct {
+        uint32_t timestamp;             /**< Entry to pm_sleep_enter(), low 32 bits of the uptime */
+        uint32_t duration;              /**< In pm_sleep_enter(), summed over merged passes */
+        uint32_t active;                /**< Active between merged passes */
+        uint16_t wake_latency;          /**< From wake-up until the system clock was ready */
+        uint16_t xtal_wait;             /**< Part of wake_latency spent waiting for XTAL32M */
+        uint16_t pdc_pending;           /**< PDC LUT entries pending at wake-up */
+        uint16_t count;                 /**< Number of merged passes */
+        uint8_t state;                  /**< SA_STATE */
+        uint8_t mode;                   /**< sleep_mode_t */
+        uint8_t reason;                 /**< SA_AWAKE */
+        uint8_t detail;                 /**< Depends on reason */
+} sa_event_t;
+
+/**
+ * \brief Initialize the analytics and start the export task
+ */
+void sleep_analytics_init(void);
+
+/**
+ * \brief Take events out of the ring buffer
+ *
+ * For exporting over another transport. Do not use together with the export task.
+ *
+ * \param [out] events buffer for the events
+ * \param [in] max size of the buffer, in events
+ *
+ * \return number of events copied, oldest first
+ */
+uint32_t sleep_analytics_read(sa_event_t *events, uint32_t max);
+
+/*
+ * Hooks of the power manager, not to be called by applications
+ */
+void sa_pm_enter(uint8_t mode);
+void sa_pm_stay_awake(SA_AWAKE reason, uint32_t detail);
+void sa_pm_irq_pending(void);
+__RETAINED_CODE void sa_pm_woken_up(void);
+void sa_pm_resumed(void);
+void sa_pm_sysclk_ready(void);
+void sa_pm_exit(bool tick_stopped);
+
+#endif /* dg_configENABLE_SLEEP_ANALYTICS */
+
+#endif /* SLEEP_ANALYTICS_H */
+
+/**
+ * \}
+ * \}
+ */
@@ -138,6 +138,50 @@ void tm_print_tasks_status()
         printf(NEWLINE "Available heap min watermark %d", OS_GET_HEAP_WATERMARK());
         printf(NEWLINE "Available current heap %d" NEWLINE, OS_GET_FREE_HEAP_SIZE());
 }
+
+#if (dg_configUSE_OS_MEM_POOLS == 1)
+static const char *pool_class_name[OS_MEM_POOL_CLASS_COUNT] = {
+        [OS_MEM_POOL_CLASS_SMALL] = "small",
+        [OS_MEM_POOL_CLASS_MEDIUM] = "medium",
+        [OS_MEM_POOL_CLASS_LARGE] = "large",
+};
+#endif /* dg_configUSE_OS_MEM_POOLS */
+
+void tm_print_heap_stats()
+{
+        OS_HEAP_STATS heap_stats;
+        uint32_t fragmentation = 0;
+
+        OS_GET_HEAP_STATS(&heap_stats);
+
+        /* Percentage of free heap that cannot be handed out as a single block */
+        if (heap_stats.xAvailableHeapSpaceInBytes) {
+                fragmentation = 100 - (100 * heap_stats.xSizeOfLargestFreeBlockInBytes) /
+                                                        heap_stats.xAvailableHeapSpaceInBytes;
+        }
+
+        printf(NEWLINE "Available current heap %d", heap_stats.xAvailableHeapSpaceInBytes);
+        printf(NEWLINE "Available heap min watermark %d", heap_stats.xMinimumEverFreeBytesRemaining);
+        printf(NEWLINE "Heap free blocks %d", heap_stats.xNumberOfFreeBlocks);
+        printf(NEWLINE "Heap largest free block %d", heap_stats.xSizeOfLargestFreeBlockInBytes);
+        printf(NEWLINE "Heap smallest free block %d", heap_stats.xSizeOfSmallestFreeBlockInBytes);
+        printf(NEWLINE "Heap fragmentation %ld%%", fragmentation);
+        printf(NEWLINE "Heap allocations %d frees %d" NEWLINE,
+                heap_stats.xNumberOfSuccessfulAllocations, heap_stats.xNumberOfSuccessfulFrees);
+
+#if (dg_configUSE_OS_MEM_POOLS == 1)
+        OS_MEM_POOL_CLASS cls;
+        OS_POOL_STATS pool_stats;
+
+        for (cls = 0; cls < OS_MEM_POOL_CLASS_COUNT; cls++) {
+                os_mem_pool_get_class_stats(cls, &pool_stats);
+                printf(NEWLINE "Pool %s (%d x %d) used %ld max %ld failed %ld", pool_class_name[cls],
+                        pool_stats.num_blocks, pool_stats.block_size, pool_stats.used,
+                        pool_stats.max_used, pool_stats.alloc_failed);
+        }
+        printf(NEWLINE);
+#endif /* dg_configUSE_OS_MEM_POOLS */
+}
 #endif /*dg_configENABLE_TASK_MONITORING*/
 
 /**
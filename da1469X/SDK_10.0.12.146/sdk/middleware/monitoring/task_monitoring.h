@@ -54,6 +54,12 @@ void tm_print_registered_tasks(void);
  */
 void tm_print_tasks_status(void);
 
+/**
+ * \brief Print heap fragmentation and OS memory pool statistics.
+ *
+ */
+void tm_print_heap_stats(void);
+
 #endif /*dg_configENABLE_TASK_MONITORING*/
 
 #endif /*TASK_MONITORING_H*/
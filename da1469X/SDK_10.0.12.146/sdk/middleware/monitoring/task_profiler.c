@@ -0,0 +1,484 @@
+/**
+ * \addtogroup MIDDLEWARE
+ * \{
+ * \addtogroup TASK_PROFILER
+ * \{
+ */
+
+/*
+ *****************************************************************************************
+ *
+ * @file task_profiler.c
+ *
+ * @brief Run-time task CPU and latency profiler streaming over SEGGER RTT
+ *
+ * Copyright (C) 2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ *****************************************************************************************
+ */
+
+#include <string.h>
+#include "sdk_defs.h"
+#include "osal.h"
+#include "interrupts.h"
+#include "sys_clock_mgr.h"
+#include "SEGGER_RTT.h"
+#include "task_profiler.h"
+
+#if (dg_configENABLE_TASK_PROFILER == 1)
+
+#if (dg_configSYSTEMVIEW == 1)
+#error dg_configENABLE_TASK_PROFILER cannot be used together with dg_configSYSTEMVIEW.
+#endif
+
+#if (configGENERATE_RUN_TIME_STATS == 0) || (configUSE_TRACE_FACILITY == 0)
+#error dg_configENABLE_TASK_PROFILER needs the FreeRTOS run-time stats and trace facility.
+#endif
+
+#define TP_TASK_PRIORITY        ( OS_TASK_PRIORITY_HIGHEST )
+#define TP_TASK_STACK_SIZE      ( 512 )
+
+/* Task info is sent again every so many periods, so that a host attaching late catches up */
+#define TP_ANNOUNCE_PERIODS     ( 10 )
+
+/* Largest record is the queue histogram */
+#define TP_MAX_RECORD_SIZE      ( 2 + 6 + 2 * TASK_PROFILER_HIST_BUCKETS )
+#define TP_MAX_NAME_LEN         ( 16 )
+
+typedef struct {
+        uint32_t max;
+        uint16_t bucket[TASK_PROFILER_HIST_BUCKETS];
+} tp_hist_t;
+
+typedef struct {
+        const char *name;
+        uint32_t nonempty_since;
+        uint32_t block_start;
+        bool blocked;
+        tp_hist_t hist[2];
+} tp_queue_t;
+
+typedef struct {
+        uint32_t number;
+        uint32_t run_time;
+} tp_task_t;
+
+typedef struct {
+        uint32_t isr_cycles;
+        uint32_t isr_count;
+        uint16_t pm[TP_PM_SLEEP_ABORTED + 1];
+        uint16_t vetoed;
+} tp_counters_t;
+
+__RETAINED static OS_TASK tp_task_handle;
+__RETAINED static tp_queue_t tp_queues[TASK_PROFILER_MAX_QUEUES];
+__RETAINED static uint32_t tp_queue_count;
+__RETAINED static tp_task_t tp_tasks[TASK_PROFILER_MAX_TASKS];
+__RETAINED static OS_TASK_STATUS tp_status[TASK_PROFILER_MAX_TASKS];
+__RETAINED static tp_counters_t tp_counters;
+__RETAINED static uint32_t tp_isr_nesting;
+__RETAINED static uint32_t tp_isr_start;
+__RETAINED static uint32_t tp_dropped;
+__RETAINED static uint32_t tp_announced;
+__RETAINED static uint32_t tp_last_time;
+__RETAINED static uint8_t tp_rtt_buffer[TASK_PROFILER_RTT_BUFFER_SIZE];
+
+static void enable_cycle_counter(void)
+{
+        CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+        DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+static uint32_t now(void)
+{
+        return portGET_RUN_TIME_COUNTER_VALUE();
+}
+
+/*
+ * Hooks
+ */
+
+void tp_isr_enter(void)
+{
+        /* Nested interrupts restore the counter before returning, no locking needed */
+        if (tp_isr_nesting++ == 0) {
+                tp_isr_start = DWT->CYCCNT;
+        }
+}
+
+void tp_isr_exit(void)
+{
+        if (--tp_isr_nesting == 0) {
+                tp_counters.isr_cycles += DWT->CYCCNT - tp_isr_start;
+                tp_counters.isr_count++;
+        }
+}
+
+static void hist_add(tp_hist_t *hist, uint32_t t)
+{
+        uint32_t bucket = t ? 32 - __CLZ(t) : 0;
+
+        if (bucket >= TASK_PROFILER_HIST_BUCKETS) {
+                bucket = TASK_PROFILER_HIST_BUCKETS - 1;
+        }
+        if (hist->bucket[bucket] < UINT16_MAX) {
+                hist->bucket[bucket]++;
+        }
+        if (t > hist->max) {
+                hist->max = t;
+        }
+}
+
+/* Called from the kernel with interrupts masked */
+void tp_queue_send(uint32_t id, uint32_t waiting)
+{
+        if (waiting == 0) {
+                tp_queues[id - 1].nonempty_since = now();
+        }
+}
+
+/* Called from the kernel with interrupts masked */
+void tp_queue_receive(uint32_t id, uint32_t remaining)
+{
+        tp_queue_t *q = &tp_queues[id - 1];
+        uint32_t t = now();
+
+        if (q->blocked) {
+                q->blocked = false;
+                hist_add(&q->hist[TP_QUEUE_HIST_WAIT], t - q->block_start);
+        }
+        hist_add(&q->hist[TP_QUEUE_HIST_RESPONSE], t - q->nonempty_since);
+
+        /* Messages left behind have been waiting at least since now */
+        q->nonempty_since = t;
+}
+
+/* Called from the kernel with the scheduler suspended */
+void tp_queue_block(uint32_t id)
+{
+        tp_queue_t *q = &tp_queues[id - 1];
+
+        /* The kernel retries after spurious wake-ups, only the first attempt counts */
+        if (!q->blocked) {
+                q->block_start = now();
+                q->blocked = true;
+        }
+}
+
+void tp_pm_event(TP_PM_EVENT event)
+{
+        if (tp_counters.pm[event] < UINT16_MAX) {
+                tp_counters.pm[event]++;
+        }
+        if (event == TP_PM_SLEEP) {
+                /* Debug block loses its state while sleeping */
+                enable_cycle_counter();
+        }
+}
+
+void tp_pm_sleep_vetoed(void)
+{
+        if (tp_counters.vetoed < UINT16_MAX) {
+                tp_counters.vetoed++;
+        }
+}
+
+/*
+ * Records
+ */
+
+static void put_u16(uint8_t **p, uint16_t v)
+{
+        *(*p)++ = v;
+        *(*p)++ = v >> 8;
+}
+
+static void put_u32(uint8_t **p, uint32_t v)
+{
+        put_u16(p, v);
+        put_u16(p, v >> 16);
+}
+
+static void put_name(uint8_t **p, const char *name)
+{
+        size_t len = strnlen(name, TP_MAX_NAME_LEN);
+
+        memcpy(*p, name, len);
+        *p += len;
+}
+
+static void send_record(TP_REC type, uint8_t *rec, uint8_t *end)
+{
+        rec[0] = type;
+        rec[1] = end - rec - 2;
+
+        /* Whole records or nothing, the decoder can't resync on partial ones */
+        if (SEGGER_RTT_WriteSkipNoLock(TASK_PROFILER_RTT_CHANNEL, rec, end - rec) == 0) {
+                tp_dropped++;
+        }
+}
+
+static void send_hello(void)
+{
+        uint8_t rec[TP_MAX_RECORD_SIZE];
+        uint8_t *p = rec + 2;
+
+        *p++ = TASK_PROFILER_FORMAT_VERSION;
+        put_u32(&p, configSYSTICK_CLOCK_HZ);
+        put_u16(&p, TASK_PROFILER_PERIOD_MS);
+        send_record(TP_REC_HELLO, rec, p);
+}
+
+static void send_queue_info(void)
+{
+        uint8_t rec[TP_MAX_RECORD_SIZE];
+        uint8_t *p;
+        uint32_t i;
+
+        for (i = 0; i < tp_queue_count; i++) {
+                p = rec + 2;
+                *p++ = i + 1;
+                put_name(&p, tp_queues[i].name);
+                send_record(TP_REC_QUEUE_INFO, rec, p);
+        }
+}
+
+static void send_task_info(const OS_TASK_STATUS *status)
+{
+        uint8_t rec[TP_MAX_RECORD_SIZE];
+        uint8_t *p = rec + 2;
+
+        *p++ = status->xTaskNumber;
+        *p++ = status->uxBasePriority;
+        put_name(&p, status->pcTaskName);
+        send_record(TP_REC_TASK_INFO, rec, p);
+}
+
+static tp_task_t *find_task(uint32_t number)
+{
+        int i;
+        tp_task_t *unused = NULL;
+
+        for (i = 0; i < TASK_PROFILER_MAX_TASKS; i++) {
+                if (tp_tasks[i].number == number) {
+                        return &tp_tasks[i];
+                }
+                if (tp_tasks[i].number == 0 && !unused) {
+                        unused = &tp_tasks[i];
+                }
+        }
+
+        if (unused) {
+                unused->number = number;
+                unused->run_time = 0;
+        }
+
+        return unused;
+}
+
+static void send_tasks(bool announce)
+{
+        uint8_t rec[TP_MAX_RECORD_SIZE];
+        uint8_t *p;
+        UBaseType_t count;
+        UBaseType_t i;
+        tp_task_t *task;
+
+        count = OS_GET_TASKS_STATUS(tp_status, TASK_PROFILER_MAX_TASKS);
+
+        /* Forget deleted tasks */
+        for (i = 0; i < TASK_PROFILER_MAX_TASKS; i++) {
+                UBaseType_t j;
+
+                for (j = 0; j < count; j++) {
+                        if (tp_status[j].xTaskNumber == tp_tasks[i].number) {
+                                break;
+                        }
+                }
+                if (j == count) {
+                        tp_tasks[i].number = 0;
+                }
+        }
+
+        for (i = 0; i < count; i++) {
+                const OS_TASK_STATUS *status = &tp_status[i];
+
+                if (announce || status->xTaskNumber > tp_announced) {
+                        send_task_info(status);
+                        if (status->xTaskNumber > tp_announced) {
+                                tp_announced = status->xTaskNumber;
+                        }
+                }
+
+                task = find_task(status->xTaskNumber);
+                if (!task) {
+                        continue;
+                }
+
+                p = rec + 2;
+                *p++ = status->xTaskNumber;
+                *p++ = status->eCurrentState;
+                put_u32(&p, status->ulRunTimeCounter - task->run_time);
+                put_u16(&p, status->usStackHighWaterMark);
+                send_record(TP_REC_TASK_TIME, rec, p);
+
+                task->run_time = status->ulRunTimeCounter;
+        }
+}
+
+static void send_queues(void)
+{
+        uint8_t rec[TP_MAX_RECORD_SIZE];
+        uint8_t *p;
+        tp_hist_t hist;
+        uint32_t i;
+        int kind;
+        int b;
+
+        for (i = 0; i < tp_queue_count; i++) {
+                for (kind = TP_QUEUE_HIST_WAIT; kind <= TP_QUEUE_HIST_RESPONSE; kind++) {
+                        OS_ENTER_CRITICAL_SECTION();
+                        hist = tp_queues[i].hist[kind];
+                        memset(&tp_queues[i].hist[kind], 0, sizeof(hist));
+                        OS_LEAVE_CRITICAL_SECTION();
+
+                        if (hist.max == 0 && hist.bucket[0] == 0) {
+                                continue;
+                        }
+
+                        p = rec + 2;
+                        *p++ = i + 1;
+                        *p++ = kind;
+                        put_u32(&p, hist.max);
+                        for (b = 0; b < TASK_PROFILER_HIST_BUCKETS; b++) {
+                                put_u16(&p, hist.bucket[b]);
+                        }
+                        send_record(TP_REC_QUEUE_HIST, rec, p);
+                }
+        }
+}
+
+static void send_period(void)
+{
+        uint8_t rec[TP_MAX_RECORD_SIZE];
+        uint8_t *p = rec + 2;
+        tp_counters_t counters;
+        uint32_t t = now();
+        int i;
+
+        OS_ENTER_CRITICAL_SECTION();
+        counters = tp_counters;
+        memset(&tp_counters, 0, sizeof(tp_counters));
+        OS_LEAVE_CRITICAL_SECTION();
+
+        put_u32(&p, t);
+        put_u32(&p, t - tp_last_time);
+        put_u32(&p, counters.isr_cycles);
+        put_u32(&p, counters.isr_count);
+        put_u32(&p, cm_cpu_clk_get() * 1000000);
+        for (i = 0; i <= TP_PM_SLEEP_ABORTED; i++) {
+                put_u16(&p, counters.pm[i]);
+        }
+        put_u16(&p, counters.vetoed);
+        put_u16(&p, tp_dropped > UINT16_MAX ? UINT16_MAX : tp_dropped);
+        tp_dropped = 0;
+        send_record(TP_REC_PERIOD, rec, p);
+
+        tp_last_time = t;
+}
+
+static void tp_task(void *params)
+{
+        uint32_t period = 0;
+        bool announce;
+
+        for (;;) {
+                OS_DELAY_MS(TASK_PROFILER_PERIOD_MS);
+
+                announce = (period++ % TP_ANNOUNCE_PERIODS) == 0;
+                if (announce) {
+                        send_hello();
+                        send_queue_info();
+                }
+                send_period();
+                send_tasks(announce);
+                send_queues();
+        }
+}
+
+uint32_t task_profiler_register_ring(const char *name)
+{
+        uint32_t id = 0;
+
+        OS_ENTER_CRITICAL_SECTION();
+        OS_ASSERT(tp_queue_count < TASK_PROFILER_MAX_QUEUES);
+        if (tp_queue_count < TASK_PROFILER_MAX_QUEUES) {
+                tp_queues[tp_queue_count].name = name;
+                id = ++tp_queue_count;
+        }
+        OS_LEAVE_CRITICAL_SECTION();
+
+        return id;
+}
+
+void task_profiler_register_queue(void *queue, const char *name)
+{
+        uint32_t id = task_profiler_register_ring(name);
+
+        if (id) {
+                vQueueSetQueueNumber(queue, id);
+        }
+}
+
+/* Ring buffer events come from tasks, the hooks expect interrupts masked as in the kernel */
+void task_profiler_ring_put(uint32_t id, bool was_empty)
+{
+        if (id) {
+                OS_ENTER_CRITICAL_SECTION();
+                tp_queue_send(id, was_empty ? 0 : 1);
+                OS_LEAVE_CRITICAL_SECTION();
+        }
+}
+
+void task_profiler_ring_take(uint32_t id)
+{
+        if (id) {
+                OS_ENTER_CRITICAL_SECTION();
+                tp_queue_receive(id, 0);
+                OS_LEAVE_CRITICAL_SECTION();
+        }
+}
+
+void task_profiler_ring_wait(uint32_t id)
+{
+        if (id) {
+                OS_ENTER_CRITICAL_SECTION();
+                tp_queue_block(id);
+                OS_LEAVE_CRITICAL_SECTION();
+        }
+}
+
+void task_profiler_init(void)
+{
+        if (tp_task_handle) {
+                return;
+        }
+
+        SEGGER_RTT_ConfigUpBuffer(TASK_PROFILER_RTT_CHANNEL, "TaskProfiler", tp_rtt_buffer,
+                                sizeof(tp_rtt_buffer), SEGGER_RTT_MODE_NO_BLOCK_SKIP);
+        enable_cycle_counter();
+        tp_last_time = now();
+
+        OS_TASK_CREATE("tprof", tp_task, NULL, TP_TASK_STACK_SIZE, TP_TASK_PRIORITY,
+                                                                                tp_task_handle);
+        OS_ASSERT(tp_task_handle);
+}
+
+#endif /* dg_configENABLE_TASK_PROFILER */
+
+/**
+ * \}
+ * \}
+ */
@@ -0,0 +1,249 @@
+/**
+ * \addtogroup UTILITIES
+ * \{
+ * \addtogroup UTI_TASK_PROFILER
+ * \{
+ */
+
+/**
+ ****************************************************************************************
+ *
+ * @file task_profiler.h
+ *
+ * @brief Run-time task CPU and latency profiler streaming over SEGGER RTT
+ *
+ * The profiler periodically sends compact binary records over an RTT up channel:
+ * - per-task CPU time taken from the FreeRTOS run-time statistics,
+ * - time spent in interrupt handlers,
+ * - wait and response time histograms of registered queues,
+ * - idle and sleep counts of the power manager.
+ *
+ * utilities/python_scripts/analysis/task_profiler_decode.py turns the stream into per-task
+ * utilisation and latency tables.
+ *
+ * This file is included by FreeRTOS.h in order to install the kernel trace hooks, so it must
+ * not include any OS header.
+ *
+ * Copyright (C) 2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ *****************************************************************************************
+ */
+
+#ifndef TASK_PROFILER_H
+#define TASK_PROFILER_H
+
+#if (dg_configENABLE_TASK_PROFILER == 1)
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * \brief RTT up channel used by the profiler
+ *
+ * Channel 0 is the terminal (CONFIG_RTT), channel 1 is also used by SystemView which cannot be
+ * enabled together with the profiler.
+ */
+#ifndef TASK_PROFILER_RTT_CHANNEL
+#define TASK_PROFILER_RTT_CHANNEL       (1)
+#endif
+
+/**
+ * \brief Size of the RTT up buffer
+ *
+ * Records that do not fit are dropped; the number of dropped records is reported in the next
+ * period record.
+ */
+#ifndef TASK_PROFILER_RTT_BUFFER_SIZE
+#define TASK_PROFILER_RTT_BUFFER_SIZE   (1024)
+#endif
+
+/**
+ * \brief Reporting period in ms
+ */
+#ifndef TASK_PROFILER_PERIOD_MS
+#define TASK_PROFILER_PERIOD_MS         (1000)
+#endif
+
+/**
+ * \brief Maximum number of tasks reported
+ */
+#ifndef TASK_PROFILER_MAX_TASKS
+#define TASK_PROFILER_MAX_TASKS         (16)
+#endif
+
+/**
+ * \brief Maximum number of registered queues
+ */
+#ifndef TASK_PROFILER_MAX_QUEUES
+#define TASK_PROFILER_MAX_QUEUES        (8)
+#endif
+
+/**
+ * \brief Number of histogram buckets
+ *
+ * Bucket n counts times t, in run-time counter ticks, with 2^(n-1) <= t < 2^n; bucket 0 counts
+ * t == 0 and the last bucket everything above.
+ */
+#define TASK_PROFILER_HIST_BUCKETS      (16)
+
+/**
+ * \brief Version of the record format, increment on incompatible changes
+ */
+#define TASK_PROFILER_FORMAT_VERSION    (1)
+
+/**
+ * \brief Record types
+ *
+ * Every record starts with a type and a payload length byte, all values are little endian.
+ */
+typedef enum {
+        /** u8 version, u32 run-time counter Hz, u16 period ms */
+        TP_REC_HELLO = 0x01,
+        /** u8 task number, u8 base priority, name */
+        TP_REC_TASK_INFO = 0x02,
+        /** u8 queue id, name */
+        TP_REC_QUEUE_INFO = 0x03,
+        /**
+         * u32 timestamp, u32 elapsed (run-time counter ticks), u32 ISR cycles, u32 ISR count,
+         * u32 CPU clock Hz, u16 idle (mode), u16 idle (tick), u16 idle (blocked), u16 sleep,
+         * u16 sleep aborted, u16 sleep vetoed, u16 dropped records
+         */
+        TP_REC_PERIOD = 0x10,
+        /** u8 task number, u8 state, u32 run time (run-time counter ticks), u16 stack free */
+        TP_REC_TASK_TIME = 0x11,
+        /** u8 queue id, u8 kind (TP_QUEUE_HIST), u32 max, u16 buckets[TASK_PROFILER_HIST_BUCKETS] */
+        TP_REC_QUEUE_HIST = 0x12,
+} TP_REC;
+
+/**
+ * \brief Queue histogram kinds
+ */
+typedef enum {
+        TP_QUEUE_HIST_WAIT = 0,         /**< Receiver blocked on an empty queue */
+        TP_QUEUE_HIST_RESPONSE = 1,     /**< Queue not empty until the receiver took a message */
+} TP_QUEUE_HIST;
+
+/**
+ * \brief Outcome of one power manager idle entry
+ */
+typedef enum {
+        TP_PM_IDLE_MODE,                /**< Sleep not allowed by the sleep mode or pending work */
+        TP_PM_IDLE_TICK,                /**< OS timer too close to stop the tick */
+        TP_PM_IDLE_BLOCKED,             /**< Sleep too short, watchdog, DMA or adapter veto */
+        TP_PM_SLEEP,                    /**< Entered sleep */
+        TP_PM_SLEEP_ABORTED,            /**< Sleep prepared but aborted by pending interrupt */
+} TP_PM_EVENT;
+
+/**
+ * \brief Initialize the profiler and start the reporting task
+ *
+ * The task runs at OS_TASK_PRIORITY_HIGHEST so that reports keep flowing when other tasks
+ * starve the CPU. Its own (small) CPU time and the periodic wake-up are part of the report.
+ */
+void task_profiler_init(void);
+
+/**
+ * \brief Register a queue for wait and response time profiling
+ *
+ * \param [in] queue the queue
+ * \param [in] name short name reported to the host
+ */
+void task_profiler_register_queue(void *queue, const char *name);
+
+/**
+ * \brief Register a ring buffer for wait and response time profiling
+ *
+ * Ring buffers have no kernel hooks, their owner reports the events with
+ * task_profiler_ring_put(), task_profiler_ring_take() and task_profiler_ring_wait(). They are
+ * reported to the host like queues.
+ *
+ * \param [in] name short name reported to the host
+ *
+ * \return id to pass to the other ring functions, 0 if TASK_PROFILER_MAX_QUEUES are registered
+ */
+uint32_t task_profiler_register_ring(const char *name);
+
+/**
+ * \brief A message was put in a registered ring buffer
+ *
+ * \param [in] id id returned by task_profiler_register_ring()
+ * \param [in] was_empty the ring buffer was empty before the message was put
+ */
+void task_profiler_ring_put(uint32_t id, bool was_empty);
+
+/**
+ * \brief The receiver is done with the oldest message of a registered ring buffer
+ *
+ * The response time is measured up to this call, i.e. it includes the processing of the
+ * message when it is released after processing.
+ *
+ * \param [in] id id returned by task_profiler_register_ring()
+ */
+void task_profiler_ring_take(uint32_t id);
+
+/**
+ * \brief The receiver blocks on an empty registered ring buffer
+ *
+ * \param [in] id id returned by task_profiler_register_ring()
+ */
+void task_profiler_ring_wait(uint32_t id);
+
+/*
+ * Hooks, not to be called by applications
+ */
+void tp_isr_enter(void);
+void tp_isr_exit(void);
+void tp_queue_send(uint32_t id, uint32_t waiting);
+void tp_queue_receive(uint32_t id, uint32_t remaining);
+void tp_queue_block(uint32_t id);
+void tp_pm_event(TP_PM_EVENT event);
+void tp_pm_sleep_vetoed(void);
+
+/*
+ * Interrupt handlers instrumented for SystemView are profiled through the same hook points.
+ */
+#define SEGGER_SYSTEMVIEW_ISR_ENTER()           tp_isr_enter()
+#define SEGGER_SYSTEMVIEW_ISR_EXIT()            tp_isr_exit()
+#define SEGGER_SYSTEMVIEW_BLE_ISR_ENTER()       tp_isr_enter()
+#define SEGGER_SYSTEMVIEW_BLE_ISR_EXIT()        tp_isr_exit()
+#define SEGGER_SYSTEMVIEW_CPM_ISR_ENTER()       tp_isr_enter()
+#define SEGGER_SYSTEMVIEW_CPM_ISR_EXIT()        tp_isr_exit()
+
+/*
+ * FreeRTOS trace hooks. Queue numbers are only used by the trace facility, the profiler uses
+ * them as index + 1 of registered queues; 0 means not profiled.
+ */
+#define traceQUEUE_CREATE(pxNewQueue) \
+        do { (pxNewQueue)->uxQueueNumber = 0; } while (0)
+#define traceQUEUE_SEND(pxQueue) \
+        do { \
+                if ((pxQueue)->uxQueueNumber) { \
+                        tp_queue_send((pxQueue)->uxQueueNumber, (pxQueue)->uxMessagesWaiting); \
+                } \
+        } while (0)
+#define traceQUEUE_SEND_FROM_ISR(pxQueue)       traceQUEUE_SEND(pxQueue)
+#define traceQUEUE_RECEIVE(pxQueue) \
+        do { \
+                if ((pxQueue)->uxQueueNumber) { \
+                        tp_queue_receive((pxQueue)->uxQueueNumber, \
+                                                        (pxQueue)->uxMessagesWaiting - 1); \
+                } \
+        } while (0)
+#define traceQUEUE_RECEIVE_FROM_ISR(pxQueue)    traceQUEUE_RECEIVE(pxQueue)
+#define traceBLOCKING_ON_QUEUE_RECEIVE(pxQueue) \
+        do { \
+                if ((pxQueue)->uxQueueNumber) { \
+                        tp_queue_block((pxQueue)->uxQueueNumber); \
+                } \
+        } while (0)
+
+#endif /* dg_configENABLE_TASK_PROFILER */
+
+#endif /* TASK_PROFILER_H */
+
+/**
+ * \}
+ * \}
+ */
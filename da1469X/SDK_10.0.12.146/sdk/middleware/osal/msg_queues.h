@@ -39,11 +39,12 @@ typedef void *(*MSG_ALLOC)(size_t); /**< Message content allocator */
  * \brief Default memory allocation function for queues
  *
  * If not otherwise specified, default memory allocation function used by queues
- * will be taken from OS.
+ * will be taken from OS. Message contents are short lived, so OS memory pools are
+ * used when enabled (see dg_configUSE_OS_MEM_POOLS).
  *
  */
 #ifndef MSG_QUEUE_MALLOC
-#define MSG_QUEUE_MALLOC OS_MALLOC_FUNC
+#define MSG_QUEUE_MALLOC OS_POOL_MALLOC_FUNC
 #endif
 
 /**
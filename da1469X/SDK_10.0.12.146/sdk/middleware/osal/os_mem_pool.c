@@ -0,0 +1,312 @@
+/**
+ ****************************************************************************************
+ *
+ * @file os_mem_pool.c
+ *
+ * @brief Fixed-size block memory pool implementation
+ *
+ * Copyright (C) 2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ ****************************************************************************************
+ */
+
+#if !defined(OS_BAREMETAL)
+
+#include <stdbool.h>
+#include <string.h>
+#include <sdk_defs.h>
+#include <osal.h>
+#include <interrupts.h>
+#include "os_mem_pool.h"
+
+#if defined(__ARM_FEATURE_LDREX)
+
+/*
+ * On Cortex-M the exclusive monitor is cleared on every exception entry and return, so a
+ * LDREX/STREX sequence interrupted by an ISR (or a context switch) that touches the pool
+ * will simply be retried. This makes the pop below immune to the ABA problem without
+ * disabling interrupts.
+ */
+
+static void *pool_pop(os_mem_pool_t *pool)
+{
+        void *head;
+
+        do {
+                head = (void *) __LDREXW((volatile uint32_t *) &pool->free_list);
+                if (head == NULL) {
+                        __CLREX();
+                        return NULL;
+                }
+        } while (__STREXW((uint32_t) *(void **) head, (volatile uint32_t *) &pool->free_list));
+
+        return head;
+}
+
+static void pool_push(os_mem_pool_t *pool, void *block)
+{
+        void *head;
+
+        do {
+                head = (void *) __LDREXW((volatile uint32_t *) &pool->free_list);
+                *(void **) block = head;
+        } while (__STREXW((uint32_t) block, (volatile uint32_t *) &pool->free_list));
+}
+
+static bool pool_take_unused(os_mem_pool_t *pool, uint32_t *index)
+{
+        uint32_t brk;
+
+        do {
+                brk = __LDREXW(&pool->brk);
+                if (brk >= pool->num_blocks) {
+                        __CLREX();
+                        return false;
+                }
+        } while (__STREXW(brk + 1, &pool->brk));
+
+        *index = brk;
+        return true;
+}
+
+static uint32_t pool_used_add(os_mem_pool_t *pool, int32_t delta)
+{
+        uint32_t used;
+
+        do {
+                used = __LDREXW(&pool->used) + delta;
+        } while (__STREXW(used, &pool->used));
+
+        return used;
+}
+
+#else
+
+/*
+ * No exclusive access instructions, fall back to (short) critical sections.
+ */
+
+#define POOL_LOCK(status) \
+        do { \
+                if (in_interrupt()) { \
+                        OS_ENTER_CRITICAL_SECTION_FROM_ISR(status); \
+                } else { \
+                        OS_ENTER_CRITICAL_SECTION(); \
+                } \
+        } while (0)
+
+#define POOL_UNLOCK(status) \
+        do { \
+                if (in_interrupt()) { \
+                        OS_LEAVE_CRITICAL_SECTION_FROM_ISR(status); \
+                } else { \
+                        OS_LEAVE_CRITICAL_SECTION(); \
+                } \
+        } while (0)
+
+static void *pool_pop(os_mem_pool_t *pool)
+{
+        void *head;
+        uint32_t status = 0;
+
+        POOL_LOCK(status);
+        head = pool->free_list;
+        if (head) {
+                pool->free_list = *(void **) head;
+        }
+        POOL_UNLOCK(status);
+
+        return head;
+}
+
+static void pool_push(os_mem_pool_t *pool, void *block)
+{
+        uint32_t status = 0;
+
+        POOL_LOCK(status);
+        *(void **) block = pool->free_list;
+        pool->free_list = block;
+        POOL_UNLOCK(status);
+}
+
+static bool pool_take_unused(os_mem_pool_t *pool, uint32_t *index)
+{
+        bool ret = false;
+        uint32_t status = 0;
+
+        POOL_LOCK(status);
+        if (pool->brk < pool->num_blocks) {
+                *index = pool->brk++;
+                ret = true;
+        }
+        POOL_UNLOCK(status);
+
+        return ret;
+}
+
+static uint32_t pool_used_add(os_mem_pool_t *pool, int32_t delta)
+{
+        uint32_t used;
+        uint32_t status = 0;
+
+        POOL_LOCK(status);
+        used = pool->used + delta;
+        pool->used = used;
+        POOL_UNLOCK(status);
+
+        return used;
+}
+
+#endif /* __ARM_FEATURE_LDREX */
+
+void os_mem_pool_init(os_mem_pool_t *pool, void *mem, size_t block_size, size_t num_blocks)
+{
+        block_size = OS_MEM_POOL_ALIGN(block_size);
+
+        OS_ASSERT(block_size <= UINT16_MAX && num_blocks <= UINT16_MAX);
+        OS_ASSERT(((uintptr_t) mem & (OS_MEM_POOL_MIN_BLOCK_SIZE - 1)) == 0);
+
+        memset(pool, 0, sizeof(*pool));
+        pool->start = mem;
+        pool->end = pool->start + block_size * num_blocks;
+        pool->block_size = block_size;
+        pool->num_blocks = num_blocks;
+}
+
+os_mem_pool_t *os_mem_pool_create(size_t block_size, size_t num_blocks)
+{
+        os_mem_pool_t *pool;
+        size_t header_size = OS_MEM_POOL_ALIGN(sizeof(*pool));
+
+        pool = OS_MALLOC(header_size + OS_MEM_POOL_ALIGN(block_size) * num_blocks);
+        if (pool) {
+                os_mem_pool_init(pool, (uint8_t *) pool + header_size, block_size, num_blocks);
+        }
+
+        return pool;
+}
+
+void os_mem_pool_delete(os_mem_pool_t *pool)
+{
+        OS_ASSERT(pool->used == 0);
+
+        OS_FREE(pool);
+}
+
+void *os_mem_pool_alloc(os_mem_pool_t *pool)
+{
+        void *block;
+        uint32_t index;
+        uint32_t used;
+
+        block = pool_pop(pool);
+        if (block == NULL) {
+                if (!pool_take_unused(pool, &index)) {
+                        pool->alloc_failed++;
+                        return NULL;
+                }
+                block = pool->start + index * pool->block_size;
+        }
+
+        used = pool_used_add(pool, 1);
+        /* Statistics only, a lost update here is harmless */
+        if (used > pool->max_used) {
+                pool->max_used = used;
+        }
+
+        return block;
+}
+
+void os_mem_pool_free(os_mem_pool_t *pool, void *addr)
+{
+        if (addr == NULL) {
+                return;
+        }
+
+        OS_ASSERT(os_mem_pool_contains(pool, addr));
+        OS_ASSERT((((uint8_t *) addr - pool->start) % pool->block_size) == 0);
+
+        pool_push(pool, addr);
+        pool_used_add(pool, -1);
+}
+
+void os_mem_pool_get_stats(const os_mem_pool_t *pool, os_mem_pool_stats_t *stats)
+{
+        stats->block_size = pool->block_size;
+        stats->num_blocks = pool->num_blocks;
+        stats->used = pool->used;
+        stats->max_used = pool->max_used;
+        stats->alloc_failed = pool->alloc_failed;
+}
+
+#if (dg_configUSE_OS_MEM_POOLS == 1)
+
+#define SMALL_BLOCK_SIZE        OS_MEM_POOL_ALIGN(dg_configOS_MEM_POOL_SMALL_BLOCK_SIZE)
+#define MEDIUM_BLOCK_SIZE       OS_MEM_POOL_ALIGN(dg_configOS_MEM_POOL_MEDIUM_BLOCK_SIZE)
+#define LARGE_BLOCK_SIZE        OS_MEM_POOL_ALIGN(dg_configOS_MEM_POOL_LARGE_BLOCK_SIZE)
+
+#if (dg_configOS_MEM_POOL_SMALL_BLOCK_SIZE >= dg_configOS_MEM_POOL_MEDIUM_BLOCK_SIZE) || \
+    (dg_configOS_MEM_POOL_MEDIUM_BLOCK_SIZE >= dg_configOS_MEM_POOL_LARGE_BLOCK_SIZE)
+#error "OS memory pool size classes must be given in increasing block size order"
+#endif
+
+__RETAINED static uint32_t small_area[SMALL_BLOCK_SIZE * dg_configOS_MEM_POOL_SMALL_NUM_BLOCKS / 4];
+__RETAINED static uint32_t medium_area[MEDIUM_BLOCK_SIZE * dg_configOS_MEM_POOL_MEDIUM_NUM_BLOCKS / 4];
+__RETAINED static uint32_t large_area[LARGE_BLOCK_SIZE * dg_configOS_MEM_POOL_LARGE_NUM_BLOCKS / 4];
+
+/* Pools must be ordered by increasing block size */
+__RETAINED_RW static os_mem_pool_t system_pools[OS_MEM_POOL_CLASS_COUNT] = {
+        [OS_MEM_POOL_CLASS_SMALL] = OS_MEM_POOL_INITIALIZER(small_area, SMALL_BLOCK_SIZE,
+                                                dg_configOS_MEM_POOL_SMALL_NUM_BLOCKS),
+        [OS_MEM_POOL_CLASS_MEDIUM] = OS_MEM_POOL_INITIALIZER(medium_area, MEDIUM_BLOCK_SIZE,
+                                                dg_configOS_MEM_POOL_MEDIUM_NUM_BLOCKS),
+        [OS_MEM_POOL_CLASS_LARGE] = OS_MEM_POOL_INITIALIZER(large_area, LARGE_BLOCK_SIZE,
+                                                dg_configOS_MEM_POOL_LARGE_NUM_BLOCKS),
+};
+
+void *os_mem_pool_malloc(size_t size)
+{
+        int i;
+        void *addr;
+
+        for (i = 0; i < OS_MEM_POOL_CLASS_COUNT; i++) {
+                if (size <= system_pools[i].block_size) {
+                        addr = os_mem_pool_alloc(&system_pools[i]);
+                        if (addr) {
+                                return addr;
+                        }
+                        /* Class exhausted, don't spill into bigger classes */
+                        break;
+                }
+        }
+
+        return pvPortMalloc(size);
+}
+
+void os_mem_pool_release(void *addr)
+{
+        int i;
+
+        for (i = 0; i < OS_MEM_POOL_CLASS_COUNT; i++) {
+                if (os_mem_pool_contains(&system_pools[i], addr)) {
+                        os_mem_pool_free(&system_pools[i], addr);
+                        return;
+                }
+        }
+
+        /* OS_FREE is routed here, so go directly to the heap */
+        vPortFree(addr);
+}
+
+void os_mem_pool_get_class_stats(OS_MEM_POOL_CLASS cls, os_mem_pool_stats_t *stats)
+{
+        OS_ASSERT(cls < OS_MEM_POOL_CLASS_COUNT);
+
+        os_mem_pool_get_stats(&system_pools[cls], stats);
+}
+
+#endif /* dg_configUSE_OS_MEM_POOLS */
+
+#endif /* !defined(OS_BAREMETAL) */
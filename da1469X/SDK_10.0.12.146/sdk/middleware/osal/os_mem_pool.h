@@ -0,0 +1,233 @@
+/**
+ * \addtogroup MID_RTO_OSAL
+ * \{
+ * \addtogroup OSAL_MEM_POOLS Fixed-size memory pools for Abstract OS
+ *
+ * \brief OSAL fixed-size block memory pools
+ *
+ * Memory pools hand out blocks of a single, fixed size from a statically sized area.
+ * Allocation and release are O(1), do not fragment the OS heap and can be called both from
+ * task and ISR context. On cores providing exclusive load/store instructions the free list is
+ * maintained lock-free, otherwise a short critical section is used.
+ *
+ * On top of the plain pools, a set of system size classes (small, medium, large) is provided
+ * when dg_configUSE_OS_MEM_POOLS is set. OS_POOL_MALLOC() picks the smallest class that fits
+ * the request and falls back to the OS heap when the class is exhausted or the request is
+ * too big. In that configuration OS_FREE() becomes pool-aware, so a buffer allocated with
+ * OS_POOL_MALLOC() can be handed over to code that releases it with OS_FREE().
+ *
+ * \{
+ */
+
+/**
+ ****************************************************************************************
+ *
+ * @file os_mem_pool.h
+ *
+ * @brief Fixed-size block memory pool API
+ *
+ * Copyright (C) 2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ ****************************************************************************************
+ */
+
+#ifndef OS_MEM_POOL_H_
+#define OS_MEM_POOL_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * \brief Minimum block size of a memory pool
+ *
+ * Free blocks store the free list link in place, so a block must be able to hold a pointer.
+ * Block sizes are also rounded up to this value to keep blocks word aligned.
+ */
+#define OS_MEM_POOL_MIN_BLOCK_SIZE      (sizeof(void *))
+
+/**
+ * \brief Round block size to the pool alignment
+ */
+#define OS_MEM_POOL_ALIGN(size)         (((size) + OS_MEM_POOL_MIN_BLOCK_SIZE - 1) & \
+                                                        ~(OS_MEM_POOL_MIN_BLOCK_SIZE - 1))
+
+/**
+ * \brief Memory pool
+ *
+ * Blocks that have never been allocated are taken from the area above \p brk, blocks that were
+ * released are kept in \p free_list. This allows a pool to be defined statically (see
+ * OS_MEM_POOL_INITIALIZER()) without any run-time initialization.
+ */
+typedef struct os_mem_pool {
+        void * volatile free_list;      /**< Released blocks, linked through their first word */
+        volatile uint32_t brk;          /**< Number of blocks ever handed out from the area */
+        volatile uint32_t used;         /**< Number of blocks currently allocated */
+        uint32_t max_used;              /**< Maximum number of blocks allocated at the same time */
+        uint32_t alloc_failed;          /**< Number of allocations that found the pool empty */
+        uint8_t *start;                 /**< Start of the pool area */
+        uint8_t *end;                   /**< End of the pool area (first byte after the area) */
+        uint16_t block_size;            /**< Size of each block in bytes */
+        uint16_t num_blocks;            /**< Number of blocks in the pool */
+} os_mem_pool_t;
+
+/**
+ * \brief Memory pool usage statistics
+ *
+ * \sa os_mem_pool_get_stats
+ */
+typedef struct {
+        uint16_t block_size;            /**< Size of each block in bytes */
+        uint16_t num_blocks;            /**< Number of blocks in the pool */
+        uint32_t used;                  /**< Number of blocks currently allocated */
+        uint32_t max_used;              /**< Maximum number of blocks allocated at the same time */
+        uint32_t alloc_failed;          /**< Number of allocations that found the pool empty */
+} os_mem_pool_stats_t;
+
+/**
+ * \brief Static memory pool initializer
+ *
+ * \param [in] _mem pool area, at least \p _block_size * \p _num_blocks bytes, word aligned
+ * \param [in] _block_size size of each block, must be multiple of OS_MEM_POOL_MIN_BLOCK_SIZE
+ * \param [in] _num_blocks number of blocks in the pool
+ *
+ * \note The pool structure must not be placed in a zero-initialized section
+ *       (use __RETAINED_RW for retained pools).
+ */
+#define OS_MEM_POOL_INITIALIZER(_mem, _block_size, _num_blocks) \
+        { \
+                .start = (uint8_t *) (_mem), \
+                .end = (uint8_t *) (_mem) + (_block_size) * (_num_blocks), \
+                .block_size = (_block_size), \
+                .num_blocks = (_num_blocks), \
+        }
+
+/**
+ * \brief Initialize memory pool over user provided area
+ *
+ * \param [out] pool pool to initialize
+ * \param [in] mem pool area, at least OS_MEM_POOL_ALIGN(\p block_size) * \p num_blocks bytes,
+ *                 word aligned
+ * \param [in] block_size size of each block in bytes
+ * \param [in] num_blocks number of blocks in the pool
+ */
+void os_mem_pool_init(os_mem_pool_t *pool, void *mem, size_t block_size, size_t num_blocks);
+
+/**
+ * \brief Create memory pool
+ *
+ * Pool descriptor and pool area are allocated from the OS heap with a single allocation,
+ * so a pool created once at start-up does not contribute to heap fragmentation.
+ *
+ * \param [in] block_size size of each block in bytes
+ * \param [in] num_blocks number of blocks in the pool
+ *
+ * \return pool handle, NULL if there was not enough heap
+ *
+ * \sa os_mem_pool_delete
+ */
+os_mem_pool_t *os_mem_pool_create(size_t block_size, size_t num_blocks);
+
+/**
+ * \brief Delete memory pool created with os_mem_pool_create()
+ *
+ * \param [in] pool pool to delete, all blocks must have been released
+ */
+void os_mem_pool_delete(os_mem_pool_t *pool);
+
+/**
+ * \brief Allocate block from memory pool
+ *
+ * Can be called from task and ISR context.
+ *
+ * \param [in] pool pool to allocate from
+ *
+ * \return pointer to block of pool->block_size bytes, NULL if pool is exhausted
+ */
+void *os_mem_pool_alloc(os_mem_pool_t *pool);
+
+/**
+ * \brief Release block to memory pool
+ *
+ * Can be called from task and ISR context.
+ *
+ * \param [in] pool pool that \p addr was allocated from
+ * \param [in] addr block to release, NULL is ignored
+ */
+void os_mem_pool_free(os_mem_pool_t *pool, void *addr);
+
+/**
+ * \brief Check if address belongs to memory pool
+ *
+ * \param [in] pool pool to check
+ * \param [in] addr address to check
+ *
+ * \return true if \p addr lies inside pool area
+ */
+static inline bool os_mem_pool_contains(const os_mem_pool_t *pool, const void *addr)
+{
+        return ((const uint8_t *) addr >= pool->start) && ((const uint8_t *) addr < pool->end);
+}
+
+/**
+ * \brief Get memory pool statistics
+ *
+ * \param [in] pool pool to query
+ * \param [out] stats pool usage statistics
+ */
+void os_mem_pool_get_stats(const os_mem_pool_t *pool, os_mem_pool_stats_t *stats);
+
+#if (dg_configUSE_OS_MEM_POOLS == 1)
+
+/**
+ * \brief System memory pool size classes
+ */
+typedef enum {
+        OS_MEM_POOL_CLASS_SMALL,        /**< dg_configOS_MEM_POOL_SMALL_BLOCK_SIZE blocks */
+        OS_MEM_POOL_CLASS_MEDIUM,       /**< dg_configOS_MEM_POOL_MEDIUM_BLOCK_SIZE blocks */
+        OS_MEM_POOL_CLASS_LARGE,        /**< dg_configOS_MEM_POOL_LARGE_BLOCK_SIZE blocks */
+        OS_MEM_POOL_CLASS_COUNT,
+} OS_MEM_POOL_CLASS;
+
+/**
+ * \brief Allocate memory from system size classes
+ *
+ * Memory is taken from the smallest size class that can hold \p size bytes. If there is no
+ * such class or it is exhausted, memory is allocated from the OS heap.
+ *
+ * \param [in] size number of bytes to allocate
+ *
+ * \return pointer to allocated memory, NULL if neither the pools nor the heap could satisfy
+ *         the request
+ *
+ * \sa os_mem_pool_release
+ */
+void *os_mem_pool_malloc(size_t size);
+
+/**
+ * \brief Release memory allocated from system size classes or the OS heap
+ *
+ * Memory is returned to the size class owning \p addr, or to the OS heap otherwise.
+ *
+ * \param [in] addr memory to release, NULL is ignored
+ */
+void os_mem_pool_release(void *addr);
+
+/**
+ * \brief Get statistics of system size class
+ *
+ * \param [in] cls size class
+ * \param [out] stats pool usage statistics
+ */
+void os_mem_pool_get_class_stats(OS_MEM_POOL_CLASS cls, os_mem_pool_stats_t *stats);
+
+#endif /* dg_configUSE_OS_MEM_POOLS */
+
+#endif /* OS_MEM_POOL_H_ */
+
+/**
+ * \}
+ * \}
+ */
@@ -31,6 +31,7 @@
 #include <task.h>
 #include <timers.h>
 #include <interrupts.h>
+#include "os_mem_pool.h"
 
 #define OS_STACK_WORD_SIZE      (sizeof(StackType_t))
 
@@ -1131,10 +1132,17 @@ typedef enum {
 /**
  * \brief Name for OS free memory function
  *
+ * When OS memory pools are enabled, memory is released through the pool-aware function, so
+ * that buffers allocated with OS_POOL_MALLOC() can be freed with OS_FREE().
+ *
  * \sa OS_FREE
  *
  */
+#if (dg_configUSE_OS_MEM_POOLS == 1)
+#define OS_FREE_FUNC os_mem_pool_release
+#else
 #define OS_FREE_FUNC vPortFree
+#endif
 
 /**
  * \brief Name for non-retain memory free function
@@ -1161,6 +1169,91 @@ typedef enum {
  */
 #define OS_FREE_NORET(addr) OS_FREE_NORET_FUNC(addr)
 
+#define OS_POOL                 os_mem_pool_t *
+#define OS_POOL_STATS           os_mem_pool_stats_t
+
+/**
+ * \brief Create OS memory pool of fixed-size blocks
+ *
+ * Pool is allocated from the OS heap once, blocks are later taken and returned in O(1) without
+ * touching the heap.
+ *
+ * \param [out] pool pool handle, NULL if pool could not be created
+ * \param [in] block_size size of each block in bytes
+ * \param [in] num_blocks number of blocks in the pool
+ *
+ * \sa OS_POOL_DELETE
+ *
+ */
+#define OS_POOL_CREATE(pool, block_size, num_blocks) \
+        do { \
+                (pool) = os_mem_pool_create((block_size), (num_blocks)); \
+        } while (0)
+
+/**
+ * \brief Delete OS memory pool
+ *
+ * \param [in] pool pool handle, all blocks must have been released
+ *
+ */
+#define OS_POOL_DELETE(pool) os_mem_pool_delete(pool)
+
+/**
+ * \brief Allocate block from OS memory pool
+ *
+ * Can be called from task and ISR context.
+ *
+ * \param [in] pool pool handle
+ *
+ * \return pointer to block, NULL if pool is exhausted
+ *
+ */
+#define OS_POOL_ALLOC(pool) os_mem_pool_alloc(pool)
+
+/**
+ * \brief Release block to OS memory pool
+ *
+ * Can be called from task and ISR context.
+ *
+ * \param [in] pool pool handle
+ * \param [in] addr block allocated from \p pool
+ *
+ */
+#define OS_POOL_FREE(pool, addr) os_mem_pool_free((pool), (addr))
+
+/**
+ * \brief Get OS memory pool usage statistics
+ *
+ * \param [in] pool pool handle
+ * \param [out] stats pointer to OS_POOL_STATS
+ *
+ */
+#define OS_POOL_GET_STATS(pool, stats) os_mem_pool_get_stats((pool), (stats))
+
+/**
+ * \brief Name for OS memory pool size class allocation function
+ *
+ * \sa OS_POOL_MALLOC
+ *
+ */
+#if (dg_configUSE_OS_MEM_POOLS == 1)
+#define OS_POOL_MALLOC_FUNC os_mem_pool_malloc
+#else
+#define OS_POOL_MALLOC_FUNC OS_MALLOC_FUNC
+#endif
+
+/**
+ * \brief Allocate memory from system memory pool size classes
+ *
+ * Intended for small, frequently allocated objects (messages, events). Falls back to the OS heap
+ * when no size class fits or the size class is exhausted, or when dg_configUSE_OS_MEM_POOLS is
+ * not set. Memory is released with OS_FREE().
+ *
+ * \sa OS_FREE
+ *
+ */
+#define OS_POOL_MALLOC(size) OS_POOL_MALLOC_FUNC(size)
+
 #if ( configUSE_TRACE_FACILITY == 1 )
 
 /**
@@ -1218,6 +1311,19 @@ typedef enum {
  */
 #define OS_GET_FREE_HEAP_SIZE() xPortGetFreeHeapSize()
 
+#define OS_HEAP_STATS           HeapStats_t
+
+/**
+ * \brief Get heap statistics
+ *
+ * Function walks the heap free list and reports, besides free heap size, the number of free
+ * blocks and the largest free block, which together show how fragmented the heap is.
+ *
+ * \param [out] stats pointer to OS_HEAP_STATS
+ *
+ */
+#define OS_GET_HEAP_STATS(stats) vPortGetHeapStats(stats)
+
 /**
  * \brief Get current number OS tasks
  *
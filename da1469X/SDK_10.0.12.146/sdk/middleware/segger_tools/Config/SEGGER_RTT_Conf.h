@@ -67,7 +67,7 @@ Revision: $Rev: 7859 $
 #ifndef SEGGER_RTT_CONF_H
 #define SEGGER_RTT_CONF_H
 
-#if defined (CONFIG_RTT) || dg_configSYSTEMVIEW
+#if defined (CONFIG_RTT) || dg_configSYSTEMVIEW || dg_configENABLE_TASK_PROFILER || dg_configENABLE_SLEEP_ANALYTICS
 
 #ifdef __IAR_SYSTEMS_ICC__
   #include <intrinsics.h>
@@ -330,7 +330,7 @@ Revision: $Rev: 7859 $
   #define SEGGER_RTT_UNLOCK()              // Unlock RTT (nestable) (i.e. enable previous interrupt lock state)
 #endif
 
-#endif /* defined (CONFIG_RTT) || dg_configSYSTEMVIEW */
+#endif /* defined (CONFIG_RTT) || dg_configSYSTEMVIEW || dg_configENABLE_TASK_PROFILER || dg_configENABLE_SLEEP_ANALYTICS */
 
 #endif
 /*************************** End of file ****************************/
@@ -83,7 +83,8 @@ Additional information:
 ----------------------------------------------------------------------
 */
 
-#if (defined (CONFIG_RTT) || (dg_configSYSTEMVIEW == 1))
+#if (defined (CONFIG_RTT) || (dg_configSYSTEMVIEW == 1) || (dg_configENABLE_TASK_PROFILER == 1) || \
+     (dg_configENABLE_SLEEP_ANALYTICS == 1))
 
 #include "SEGGER_RTT.h"
 
@@ -1742,6 +1743,6 @@ int SEGGER_RTT_TerminalOut (char TerminalId, const char* s) {
   return Status;
 }
 
-#endif /* (defined (CONFIG_RTT) || (dg_configSYSTEMVIEW == 1)) */
+#endif /* (defined (CONFIG_RTT) || (dg_configSYSTEMVIEW == 1) || (dg_configENABLE_TASK_PROFILER == 1) || (dg_configENABLE_SLEEP_ANALYTICS == 1)) */
 
 /*************************** End of file ****************************/
@@ -67,7 +67,8 @@ Revision: $Rev: 6849 $
 #ifndef SEGGER_RTT_H
 #define SEGGER_RTT_H
 
-#if (defined (CONFIG_RTT) || (dg_configSYSTEMVIEW == 1))
+#if (defined (CONFIG_RTT) || (dg_configSYSTEMVIEW == 1) || (dg_configENABLE_TASK_PROFILER == 1) || \
+     (dg_configENABLE_SLEEP_ANALYTICS == 1))
 
 #include "SEGGER_RTT_Conf.h"
 
@@ -247,7 +248,7 @@ int SEGGER_RTT_printf(unsigned BufferIndex, const char * sFormat, ...);
 #define RTT_CTRL_BG_BRIGHT_CYAN       "[4;46m"
 #define RTT_CTRL_BG_BRIGHT_WHITE      "[4;47m"
 
-#endif /* (defined (CONFIG_RTT) || (dg_configSYSTEMVIEW == 1)) */
+#endif /* (defined (CONFIG_RTT) || (dg_configSYSTEMVIEW == 1) || (dg_configENABLE_TASK_PROFILER == 1) || (dg_configENABLE_SLEEP_ANALYTICS == 1)) */
 
 #endif
 
@@ -0,0 +1,61 @@
+/**
+ ****************************************************************************************
+ *
+ * @file custom_config_host.h
+ *
+ * @brief Board Support Package. User Configuration file for the host (POSIX) build.
+ *
+ * Copyright (C) 2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ ****************************************************************************************
+ */
+
+#ifndef CUSTOM_CONFIG_HOST_H_
+#define CUSTOM_CONFIG_HOST_H_
+
+#include "bsp_definitions.h"
+
+#define dg_configEXEC_MODE                      ( MODE_IS_RAM )
+#define dg_configCODE_LOCATION                  ( NON_VOLATILE_IS_NONE )
+#define dg_configFLASH_CONNECTED_TO             ( FLASH_CONNECTED_TO_1V8 )
+
+#define OS_FREERTOS                             /* Define this to use FreeRTOS */
+#define OS_FREERTOS_POSIX                       /* ... on top of the host POSIX port */
+#ifndef configTOTAL_HEAP_SIZE
+#define configTOTAL_HEAP_SIZE                   ( 256 * 1024 )  /* FreeRTOS Total Heap Size */
+#endif
+
+/*
+ * Memory pools can be switched off from the command line (make POOLS=0) to compare against
+ * the plain FreeRTOS heap.
+ */
+#ifndef dg_configUSE_OS_MEM_POOLS
+#define dg_configUSE_OS_MEM_POOLS               ( 1 )
+#endif
+
+#define dg_configFLASH_ADAPTER                  ( 1 )       /* RAM backed, see stubs/ad_flash_ram.c */
+#define dg_configNVMS_ADAPTER                   ( 1 )
+#define dg_configNVMS_VES                       ( 1 )
+#define dg_configUART_ADAPTER                   ( 1 )       /* pty backed, see stubs/uart_pty.c */
+#define dg_configSPI_ADAPTER                    ( 1 )       /* see stubs/hw_spi_mock.c */
+#define dg_configI2C_ADAPTER                    ( 1 )       /* see stubs/hw_i2c_mock.c */
+#define dg_configLCDC_ADAPTER                   ( 1 )       /* see stubs/lcdc_sim.c */
+#define dg_configUSE_CONSOLE                    ( 1 )
+#define dg_configSYS_AUDIO_SW_SRC               ( 1 )
+
+#define LOGGING_MODE_STANDALONE
+#define LOGGING_QUEUE_LENGTH                    ( 32 )
+
+/* The BLE storage is compiled without the BLE manager, see stubs/ble_mgr_host.c */
+#define CONFIG_USE_BLE
+#define CONFIG_BLE_STORAGE
+#define defaultBLE_MAX_BONDED                   ( 8 )
+
+/* Include bsp default values */
+#include "bsp_defaults.h"
+/* Include middleware default values */
+#include "middleware_defaults.h"
+
+#endif /* CUSTOM_CONFIG_HOST_H_ */
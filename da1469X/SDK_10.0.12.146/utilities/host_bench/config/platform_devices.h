@@ -0,0 +1,20 @@
+/**
+ ****************************************************************************************
+ *
+ * @file platform_devices.h
+ *
+ * @brief Platform devices of the host (POSIX) build
+ *
+ * Controller configurations are defined by the benchmarks using them.
+ *
+ * Copyright (C) 2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ ****************************************************************************************
+ */
+
+#ifndef PLATFORM_DEVICES_H_
+#define PLATFORM_DEVICES_H_
+
+#endif /* PLATFORM_DEVICES_H_ */
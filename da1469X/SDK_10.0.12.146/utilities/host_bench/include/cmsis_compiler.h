@@ -0,0 +1,47 @@
+/**
+ ****************************************************************************************
+ *
+ * @file cmsis_compiler.h
+ *
+ * @brief CMSIS compiler abstraction for the host (POSIX) build
+ *
+ * Copyright (C) 2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ ****************************************************************************************
+ */
+
+#ifndef __CMSIS_COMPILER_H
+#define __CMSIS_COMPILER_H
+
+#include <stdint.h>
+
+#define __ASM                   __asm
+#define __INLINE                inline
+#define __STATIC_INLINE         static inline
+#define __STATIC_FORCEINLINE    __attribute__((always_inline)) static inline
+#define __NO_RETURN             __attribute__((__noreturn__))
+#define __USED                  __attribute__((used))
+#define __WEAK                  __attribute__((weak))
+#define __PACKED                __attribute__((packed, aligned(1)))
+#define __PACKED_STRUCT         struct __attribute__((packed, aligned(1)))
+#define __PACKED_UNION          union __attribute__((packed, aligned(1)))
+#define __ALIGNED(x)            __attribute__((aligned(x)))
+#define __RESTRICT              __restrict
+
+#define __NOP()                 do { } while (0)
+#ifdef HOST_BENCH_DMB_HOOK
+/* Objects built with HOST_BENCH_DMB_HOOK call the hook at every DMB, a benchmark can run the
+ * other side of a lock-free structure there */
+extern void (*host_bench_dmb_hook)(void);
+#define __DMB()                 do { __sync_synchronize();                                     \
+                                        if (host_bench_dmb_hook) { host_bench_dmb_hook(); }    \
+                                } while (0)
+#else
+#define __DMB()                 __sync_synchronize()
+#endif
+#define __DSB()                 __sync_synchronize()
+#define __ISB()                 __sync_synchronize()
+
+#endif /* __CMSIS_COMPILER_H */
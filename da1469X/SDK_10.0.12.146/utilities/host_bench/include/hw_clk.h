@@ -0,0 +1,61 @@
+/**
+ ****************************************************************************************
+ *
+ * @file hw_clk.h
+ *
+ * @brief Clock definitions for the host (POSIX) build
+ *
+ * Copyright (C) 2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ ****************************************************************************************
+ */
+
+#ifndef HW_CLK_H_
+#define HW_CLK_H_
+
+#include <stdint.h>
+
+/*
+ * Clock types of sys_clock_mgr.h, same values as on the target
+ */
+typedef enum sysclk_type {
+        sysclk_RC32    = 0,     //!< RC32
+        sysclk_XTAL32M = 2,     //!< 32MHz
+        sysclk_PLL96   = 6,     //!< 96MHz
+        sysclk_LP      = 255,   //!< not applicable
+} sys_clk_t;
+
+typedef enum cpu_clk_type {
+        cpuclk_2M = 2,          //!< 2 MHz
+        cpuclk_4M = 4,          //!< 4 MHz
+        cpuclk_8M = 8,          //!< 8 MHz
+        cpuclk_16M = 16,        //!< 16 MHz
+        cpuclk_32M = 32,        //!< 32 MHz
+        cpuclk_96M = 96         //!< 96 MHz
+} cpu_clk_t;
+
+typedef enum ahbdiv_type {
+        ahb_div1 = 0,           //!< Divide by 1
+        ahb_div2,               //!< Divide by 2
+        ahb_div4,               //!< Divide by 4
+        ahb_div8,               //!< Divide by 8
+        ahb_div16,              //!< Divide by 16
+} ahb_div_t;
+
+typedef enum apbdiv_type {
+        apb_div1 = 0,           //!< Divide by 1
+        apb_div2,               //!< Divide by 2
+        apb_div4,               //!< Divide by 4
+        apb_div8,               //!< Divide by 8
+} apb_div_t;
+
+/**
+ * \brief Busy wait on the host monotonic clock
+ *
+ * \param [in] usec microseconds to wait
+ */
+void hw_clk_delay_usec(uint32_t usec);
+
+#endif /* HW_CLK_H_ */
@@ -0,0 +1,46 @@
+/**
+ ****************************************************************************************
+ *
+ * @file hw_dma.h
+ *
+ * @brief DMA definitions for the host (POSIX) build
+ *
+ * Copyright (C) 2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ ****************************************************************************************
+ */
+
+#ifndef HW_DMA_H_
+#define HW_DMA_H_
+
+/**
+ * \brief DMA channel number
+ *
+ * Only used to fill in configuration structures, there is no DMA on the host.
+ */
+typedef enum {
+        HW_DMA_CHANNEL_0 = 0,
+        HW_DMA_CHANNEL_1 = 1,
+        HW_DMA_CHANNEL_2 = 2,
+        HW_DMA_CHANNEL_3 = 3,
+        HW_DMA_CHANNEL_4 = 4,
+        HW_DMA_CHANNEL_5 = 5,
+        HW_DMA_CHANNEL_6 = 6,
+        HW_DMA_CHANNEL_7 = 7,
+        HW_DMA_CHANNEL_INVALID = 8
+} HW_DMA_CHANNEL;
+
+typedef enum {
+        HW_DMA_PRIO_0 = 0,
+        HW_DMA_PRIO_1,
+        HW_DMA_PRIO_2,
+        HW_DMA_PRIO_3,
+        HW_DMA_PRIO_4,
+        HW_DMA_PRIO_5,
+        HW_DMA_PRIO_6,
+        HW_DMA_PRIO_7
+} HW_DMA_PRIO;
+
+#endif /* HW_DMA_H_ */
@@ -0,0 +1,183 @@
+/**
+ ****************************************************************************************
+ *
+ * @file hw_gpio.h
+ *
+ * @brief GPIO definitions for the host (POSIX) build
+ *
+ * Keeps the enumerations of bsp/peripherals/include/hw_gpio.h so that pin configuration
+ * tables of the middleware compile; pin functions are no-ops on the host.
+ *
+ * Copyright (C) 2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ ****************************************************************************************
+ */
+
+#ifndef HW_GPIO_H_
+#define HW_GPIO_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define HW_GPIO_PORT_NONE       (HW_GPIO_PORT_MAX)
+#define HW_GPIO_PIN_NONE        (HW_GPIO_PIN_MAX)
+#define HW_GPIO_MODE_NONE       (HW_GPIO_MODE_INVALID)
+
+/**
+ * \brief GPIO input/output mode
+ *
+ */
+typedef enum {
+        HW_GPIO_MODE_INPUT = 0,                 /**< GPIO as an input */
+        HW_GPIO_MODE_INPUT_PULLUP = 0x100,      /**< GPIO as an input with pull-up */
+        HW_GPIO_MODE_INPUT_PULLDOWN = 0x200,    /**< GPIO as an input with pull-down */
+        HW_GPIO_MODE_OUTPUT = 0x300,            /**< GPIO as an (implicitly push-pull) output */
+        HW_GPIO_MODE_OUTPUT_PUSH_PULL = 0x300,  /**< GPIO as an (explicitly push-pull) output */
+        HW_GPIO_MODE_OUTPUT_OPEN_DRAIN = 0x700, /**< GPIO as an open-drain output */
+        HW_GPIO_MODE_INVALID = 0xFFF,           /**< GPIO configured as nothing */
+} HW_GPIO_MODE;
+
+/**
+ * \brief GPIO power source
+ *
+ */
+typedef enum {
+        HW_GPIO_POWER_V33 = 0,          /**< V33 (3.3 V) power rail */
+        HW_GPIO_POWER_VDD1V8P = 1,      /**< VDD1V8P (1.8 V) power rail */
+        HW_GPIO_POWER_NONE = 2,         /**< Invalid power rail */
+} HW_GPIO_POWER;
+
+/**
+ * \brief GPIO port number
+ *
+ */
+typedef enum {
+        HW_GPIO_PORT_0 = 0,     /**< GPIO Port 0 */
+        HW_GPIO_PORT_1 = 1,     /**< GPIO Port 1 */
+        HW_GPIO_PORT_MAX        /**< GPIO Port max */
+} HW_GPIO_PORT;
+
+/**
+ * \brief GPIO pin number
+ *
+ */
+typedef enum {
+        HW_GPIO_PIN_0 = 0,      /**< GPIO Pin 0 */
+        HW_GPIO_PIN_1 = 1,      /**< GPIO Pin 1 */
+        HW_GPIO_PIN_2 = 2,      /**< GPIO Pin 2 */
+        HW_GPIO_PIN_3 = 3,      /**< GPIO Pin 3 */
+        HW_GPIO_PIN_4 = 4,      /**< GPIO Pin 4 */
+        HW_GPIO_PIN_5 = 5,      /**< GPIO Pin 5 */
+        HW_GPIO_PIN_6 = 6,      /**< GPIO Pin 6 */
+        HW_GPIO_PIN_7 = 7,      /**< GPIO Pin 7 */
+        HW_GPIO_PIN_8 = 8,      /**< GPIO Pin 8 */
+        HW_GPIO_PIN_9 = 9,      /**< GPIO Pin 9 */
+        HW_GPIO_PIN_10 = 10,    /**< GPIO Pin 10 */
+        HW_GPIO_PIN_11 = 11,    /**< GPIO Pin 11 */
+        HW_GPIO_PIN_12 = 12,    /**< GPIO Pin 12 */
+        HW_GPIO_PIN_13 = 13,    /**< GPIO Pin 13 */
+        HW_GPIO_PIN_14 = 14,    /**< GPIO Pin 14 */
+        HW_GPIO_PIN_15 = 15,    /**< GPIO Pin 15 */
+        HW_GPIO_PIN_16 = 16,    /**< GPIO Pin 16 */
+        HW_GPIO_PIN_17 = 17,    /**< GPIO Pin 17 */
+        HW_GPIO_PIN_18 = 18,    /**< GPIO Pin 18 */
+        HW_GPIO_PIN_19 = 19,    /**< GPIO Pin 19 */
+        HW_GPIO_PIN_20 = 20,    /**< GPIO Pin 20 */
+        HW_GPIO_PIN_21 = 21,    /**< GPIO Pin 21 */
+        HW_GPIO_PIN_22 = 22,    /**< GPIO Pin 22 */
+        HW_GPIO_PIN_23 = 23,    /**< GPIO Pin 23 */
+        HW_GPIO_PIN_24 = 24,    /**< GPIO Pin 24 */
+        HW_GPIO_PIN_25 = 25,    /**< GPIO Pin 25 */
+        HW_GPIO_PIN_26 = 26,    /**< GPIO Pin 26 */
+        HW_GPIO_PIN_27 = 27,    /**< GPIO Pin 27 */
+        HW_GPIO_PIN_28 = 28,    /**< GPIO Pin 28 */
+        HW_GPIO_PIN_29 = 29,    /**< GPIO Pin 29 */
+        HW_GPIO_PIN_30 = 30,    /**< GPIO Pin 30 */
+        HW_GPIO_PIN_31 = 31,    /**< GPIO Pin 31 */
+        HW_GPIO_PIN_MAX         /**< GPIO Pin max*/
+} HW_GPIO_PIN;
+
+/**
+ * \brief GPIO function
+ *
+ */
+typedef enum {
+        HW_GPIO_FUNC_GPIO = 0,                  /**< GPIO */
+        HW_GPIO_FUNC_UART_RX = 1,               /**< GPIO as UART RX */
+        HW_GPIO_FUNC_UART_TX = 2,               /**< GPIO as UART TX */
+        HW_GPIO_FUNC_UART2_RX = 3,              /**< GPIO as UART2 RX */
+        HW_GPIO_FUNC_UART2_TX = 4,              /**< GPIO as UART2 TX */
+        HW_GPIO_FUNC_UART2_CTSN = 5,            /**< GPIO as UART2 CTSN */
+        HW_GPIO_FUNC_UART2_RTSN = 6,            /**< GPIO as UART2 RTSN */
+        HW_GPIO_FUNC_UART3_RX = 7,              /**< GPIO as UART3 RX */
+        HW_GPIO_FUNC_UART3_TX = 8,              /**< GPIO as UART3 TX */
+        HW_GPIO_FUNC_UART3_CTSN = 9,            /**< GPIO as UART3 CTSN */
+        HW_GPIO_FUNC_UART3_RTSN = 10,           /**< GPIO as UART3 RTSN */
+        HW_GPIO_FUNC_ISO_CLK = 11,              /**< GPIO as ISO CLK */
+        HW_GPIO_FUNC_ISO_DATA = 12,             /**< GPIO as ISO DATA */
+        HW_GPIO_FUNC_SPI_DI = 13,               /**< GPIO as SPI DI */
+        HW_GPIO_FUNC_SPI_DO = 14,               /**< GPIO as SPI DO */
+        HW_GPIO_FUNC_SPI_CLK = 15,              /**< GPIO as SPI CLK */
+        HW_GPIO_FUNC_SPI_EN = 16,               /**< GPIO as SPI EN */
+        HW_GPIO_FUNC_SPI2_DI = 17,              /**< GPIO as SPI2 DI */
+        HW_GPIO_FUNC_SPI2_DO = 18,              /**< GPIO as SPI2 DO */
+        HW_GPIO_FUNC_SPI2_CLK = 19,             /**< GPIO as SPI2 CLK */
+        HW_GPIO_FUNC_SPI2_EN = 20,              /**< GPIO as SPI2 EN */
+        HW_GPIO_FUNC_I2C_SCL = 21,              /**< GPIO as I2C SCL */
+        HW_GPIO_FUNC_I2C_SDA = 22,              /**< GPIO as I2C SDA */
+        HW_GPIO_FUNC_I2C2_SCL = 23,             /**< GPIO as I2C2 SCL */
+        HW_GPIO_FUNC_I2C2_SDA = 24,             /**< GPIO as I2C2 SDA */
+        HW_GPIO_FUNC_USB_SOF = 25,              /**< GPIO as USB SOF */
+        HW_GPIO_FUNC_ADC = 26,                  /**< GPIO as ADC (dedicated pin) */
+        HW_GPIO_FUNC_USB = 27,                  /**< GPIO as USB */
+        HW_GPIO_FUNC_PCM_DI = 28,               /**< GPIO as PCM DI */
+        HW_GPIO_FUNC_PCM_DO = 29,               /**< GPIO as PCM DO */
+        HW_GPIO_FUNC_PCM_FSC = 30,              /**< GPIO as PCM FSC */
+        HW_GPIO_FUNC_PCM_CLK = 31,              /**< GPIO as PCM CLK */
+        HW_GPIO_FUNC_PDM_DATA = 32,             /**< GPIO as PDM DATA */
+        HW_GPIO_FUNC_PDM_CLK = 33,              /**< GPIO as PDM CLK */
+        HW_GPIO_FUNC_COEX_EXT_ACT = 34,         /**< GPIO as COEX EXT ACT0 */
+        HW_GPIO_FUNC_COEX_SMART_ACT = 35,       /**< GPIO as COEX SMART ACT */
+        HW_GPIO_FUNC_COEX_SMART_PRI = 36,       /**< GPIO as COEX SMART PRI */
+        HW_GPIO_FUNC_PORT0_DCF = 37,            /**< GPIO as PORT0 DCF */
+        HW_GPIO_FUNC_PORT1_DCF = 38,            /**< GPIO as PORT1 DCF */
+        HW_GPIO_FUNC_PORT2_DCF = 39,            /**< GPIO as PORT2 DCF */
+        HW_GPIO_FUNC_PORT3_DCF = 40,            /**< GPIO as PORT3 DCF */
+        HW_GPIO_FUNC_PORT4_DCF = 41,            /**< GPIO as PORT4 DCF */
+        HW_GPIO_FUNC_CLOCK = 42,                /**< GPIO as CLOCK */
+        HW_GPIO_FUNC_PG = 43,                   /**< GPIO as PG */
+        HW_GPIO_FUNC_LCD = 44,                  /**< GPIO as LCD */
+        HW_GPIO_FUNC_LCD_SPI_DC = 45,           /**< GPIO as LCD SPI DC */
+        HW_GPIO_FUNC_LCD_SPI_DO = 46,           /**< GPIO as LCD SPI DO */
+        HW_GPIO_FUNC_LCD_SPI_CLK = 47,          /**< GPIO as LCD SPI CLK */
+        HW_GPIO_FUNC_LCD_SPI_EN = 48,           /**< GPIO as LCD SPI EN */
+        HW_GPIO_FUNC_TIM_PWM = 49,              /**< GPIO as TIM PWM */
+        HW_GPIO_FUNC_TIM2_PWM = 50,             /**< GPIO as TIM2 PWM */
+        HW_GPIO_FUNC_TIM_1SHOT = 51,            /**< GPIO as TIM 1SHOT */
+        HW_GPIO_FUNC_TIM2_1SHOT = 52,           /**< GPIO as TIM2 1SHOT */
+        HW_GPIO_FUNC_TIM3_PWM = 53,             /**< GPIO as TIM3 PWM */
+        HW_GPIO_FUNC_TIM4_PWM = 54,             /**< GPIO as TIM4 PWM */
+        HW_GPIO_FUNC_AGC_EXT = 55,              /**< GPIO as AGC EXT */
+        HW_GPIO_FUNC_CMAC_DIAG0 = 56,           /**< GPIO as CMAC DIAG0 */
+        HW_GPIO_FUNC_CMAC_DIAG1 = 57,           /**< GPIO as CMAC DIAG1 */
+        HW_GPIO_FUNC_CMAC_DIAG2 = 58,           /**< GPIO as CMAC DIAG2 */
+        HW_GPIO_FUNC_CMAC_DIAGX = 59,           /**< GPIO as CMAC DIAGX */
+        HW_GPIO_FUNC_LAST,
+} HW_GPIO_FUNC;
+
+static inline void hw_gpio_set_pin_function(HW_GPIO_PORT port, HW_GPIO_PIN pin, HW_GPIO_MODE mode,
+                                                                        HW_GPIO_FUNC function)
+{
+}
+
+static inline void hw_gpio_pad_latch_enable(HW_GPIO_PORT port, HW_GPIO_PIN pin)
+{
+}
+
+static inline void hw_gpio_pad_latch_disable(HW_GPIO_PORT port, HW_GPIO_PIN pin)
+{
+}
+
+#endif /* HW_GPIO_H_ */
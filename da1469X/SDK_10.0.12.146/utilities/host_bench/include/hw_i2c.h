@@ -0,0 +1,108 @@
+/**
+ ****************************************************************************************
+ *
+ * @file hw_i2c.h
+ *
+ * @brief I2C definitions for the host (POSIX) build
+ *
+ * Subset of bsp/peripherals/include/hw_i2c.h used by the I2C adapter (master mode), implemented
+ * by stubs/hw_i2c_mock.c.
+ *
+ * Copyright (C) 2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ ****************************************************************************************
+ */
+
+#ifndef HW_I2C_H_
+#define HW_I2C_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define HW_I2C_DMA_SUPPORT              ( 0 )
+
+/*
+ * I2C ids keep the type of the target, but are plain indexes into the controller table of
+ * stubs/hw_i2c_mock.c
+ */
+#define HW_I2C1         ((void *) 1)
+#define HW_I2C2         ((void *) 2)
+typedef void * HW_I2C_ID;
+
+/*
+ * Flags passed to read/write operations
+ */
+#define HW_I2C_F_NONE                   0x00000000      /**< No special command for the operation                          */
+#define HW_I2C_F_WAIT_FOR_STOP          0x00000001      /**< Operation will wait until stop condition occurs               */
+#define HW_I2C_F_ADD_STOP               0x00000002      /**< Add stop condition after read or write                        */
+#define HW_I2C_F_ADD_RESTART            0x00000004      /**< Add Restart condition at the start of read or write           */
+
+/* There are no registers, reads of register fields return 0 */
+#define HW_I2C_REG_GETF(id, reg, field) ( 0 )
+
+/**
+ * \brief I2C abort source
+ *
+ */
+typedef enum {
+        HW_I2C_ABORT_NONE = 0,                          /**< no abort occured */
+        HW_I2C_ABORT_7B_ADDR_NO_ACK = 0x0001,           /**< address byte of 7-bit address was not acknowledged by any slave */
+        HW_I2C_ABORT_TX_DATA_NO_ACK = 0x0008,           /**< data were not acknowledged by slave */
+        HW_I2C_ABORT_ARBITRATION_LOST = 0x1000,         /**< bus arbitration lost */
+        HW_I2C_ABORT_SW_ERROR                           /**< abort due to software error */
+} HW_I2C_ABORT_SOURCE;
+
+typedef enum {
+        HW_I2C_SPEED_STANDARD = 0,  /**< 100kb/s */
+        HW_I2C_SPEED_FAST,          /**< 400kb/s */
+        HW_I2C_SPEED_HIGH           /**< 3.4Mb/s */
+} HW_I2C_SPEED;
+
+typedef enum {
+        HW_I2C_MODE_MASTER = 0,  /**< master mode */
+        HW_I2C_MODE_SLAVE        /**< slave mode (not supported on the host) */
+} HW_I2C_MODE;
+
+typedef enum {
+        HW_I2C_ADDRESSING_7B = 0,  /**< 7-bit addressing */
+        HW_I2C_ADDRESSING_10B      /**< 10-bit addressing */
+} HW_I2C_ADDRESSING;
+
+typedef void (*hw_i2c_complete_cb)(HW_I2C_ID id, void *cb_data, uint16_t len, bool success);
+
+/**
+ * \brief I2C configuration (the clock settings of the target are not needed)
+ */
+typedef struct {
+        HW_I2C_SPEED        speed;      /**< bus speed */
+        HW_I2C_MODE         mode;       /**< mode of operation */
+        HW_I2C_ADDRESSING   addr_mode;  /**< addressing mode */
+        uint16_t            address;    /**< target slave address */
+} i2c_config;
+
+void hw_i2c_init(HW_I2C_ID id, const i2c_config *cfg);
+void hw_i2c_deinit(HW_I2C_ID id);
+void hw_i2c_enable(HW_I2C_ID id);
+void hw_i2c_disable(HW_I2C_ID id);
+bool hw_i2c_is_occupied(HW_I2C_ID id);
+uint8_t hw_i2c_is_master(HW_I2C_ID id);
+bool hw_i2c_controler_is_busy(HW_I2C_ID id);
+bool hw_i2c_is_master_busy(HW_I2C_ID id);
+bool hw_i2c_is_tx_fifo_empty(HW_I2C_ID id);
+bool hw_i2c_is_rx_fifo_not_empty(HW_I2C_ID id);
+void hw_i2c_master_abort_transfer(HW_I2C_ID id);
+uint16_t hw_i2c_get_abort_source(HW_I2C_ID id);
+void hw_i2c_reset_abort_source(HW_I2C_ID id);
+void hw_i2c_reset_int_all(HW_I2C_ID id);
+void hw_i2c_unregister_int(HW_I2C_ID id);
+int hw_i2c_write_buffer_async(HW_I2C_ID id, const uint8_t *data, uint16_t len,
+                                        hw_i2c_complete_cb cb, void *cb_data, uint32_t flags);
+int hw_i2c_read_buffer_async(HW_I2C_ID id, uint8_t *data, uint16_t len,
+                                        hw_i2c_complete_cb cb, void *cb_data, uint32_t flags);
+int hw_i2c_write_then_read_async(HW_I2C_ID id, const uint8_t *w_data, uint16_t w_len,
+                                        uint8_t *r_data, uint16_t r_len, hw_i2c_complete_cb cb,
+                                        void *cb_data, uint32_t flags);
+
+#endif /* HW_I2C_H_ */
@@ -0,0 +1,95 @@
+/**
+ ****************************************************************************************
+ *
+ * @file hw_lcdc.h
+ *
+ * @brief LCD controller definitions for the host (POSIX) build
+ *
+ * Subset of bsp/peripherals/include/hw_lcdc.h needed by the LCDC adapter API and the frame
+ * buffer manager. The adapter transfer functions are implemented by stubs/lcdc_sim.c.
+ *
+ * Copyright (C) 2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ ****************************************************************************************
+ */
+
+#ifndef HW_LCDC_H_
+#define HW_LCDC_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef enum {
+        HW_LCDC_LCM_RGBA5551 = 0x01,
+        HW_LCDC_LCM_ABGR8888 = 0x02,
+        HW_LCDC_LCM_RGB332   = 0x04,
+        HW_LCDC_LCM_RGB565   = 0x05,
+        HW_LCDC_LCM_BGRA8888 = 0x06,
+        HW_LCDC_LCM_L8       = 0x07,
+        HW_LCDC_LCM_L1       = 0x08,
+        HW_LCDC_LCM_L4       = 0x09,
+        HW_LCDC_LCM_RGBA8888 = 0x0d,
+        HW_LCDC_LCM_ARGB8888 = 0x0e,
+} HW_LCDC_LAYER_COLOR_MODE;
+
+typedef enum {
+        HW_LCDC_FIFO_PREFETCH_LVL_DISABLED,
+} HW_LCDC_FIFO_PREFETCH_LVL;
+
+typedef enum {
+        HW_LCDC_PHY_NONE,
+        HW_LCDC_PHY_MIPI_SPI3,
+        HW_LCDC_PHY_MIPI_SPI4,
+        HW_LCDC_PHY_JDI_SPI,
+        HW_LCDC_PHY_SHARP_SPI,
+        HW_LCDC_PHY_JDI_PARALLEL,
+        HW_LCDC_PHY_CLASSIC_PARALLEL,
+        HW_LCDC_PHY_CUSTOM,
+} HW_LCDC_PHY;
+
+typedef enum {
+        HW_LCDC_EXT_CLK_OFF,
+} HW_LCDC_EXT_CLK;
+
+typedef enum {
+        HW_LCDC_TE_POL_LOW,
+        HW_LCDC_TE_POL_HIGH,
+} HW_LCDC_TE;
+
+typedef struct {
+        uint16_t startx, starty;
+        uint16_t endx, endy;
+} hw_lcdc_frame_t;
+
+typedef struct {
+        uint32_t baseaddr;
+        int32_t  stride;
+        int16_t  startx, starty;
+        uint16_t resx, resy;
+        HW_LCDC_LAYER_COLOR_MODE format;
+        HW_LCDC_FIFO_PREFETCH_LVL dma_prefetch_lvl;
+} hw_lcdc_layer_t;
+
+/**
+ * \brief LCDC configuration, only the interface type is used on the host
+ */
+typedef struct {
+        HW_LCDC_PHY phy_type;
+} hw_lcdc_config_t;
+
+typedef struct {
+        uint16_t resx, resy;
+} hw_lcdc_display_t;
+
+typedef struct {
+        uint16_t unused;
+} hw_lcdc_jdi_parallel_timings_t;
+
+/**
+ * \brief Get the line size of a layer in bytes
+ */
+uint32_t hw_lcdc_stride_size(HW_LCDC_LAYER_COLOR_MODE format, uint16_t width);
+
+#endif /* HW_LCDC_H_ */
@@ -0,0 +1,20 @@
+/**
+ ****************************************************************************************
+ *
+ * @file hw_pdc.h
+ *
+ * @brief Power Domain Controller definitions for the host (POSIX) build
+ *
+ * Included by the SNC headers; nothing of it is used on the host.
+ *
+ * Copyright (C) 2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ ****************************************************************************************
+ */
+
+#ifndef HW_PDC_H_
+#define HW_PDC_H_
+
+#endif /* HW_PDC_H_ */
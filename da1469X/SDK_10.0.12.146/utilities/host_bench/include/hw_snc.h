@@ -0,0 +1,21 @@
+/**
+ ****************************************************************************************
+ *
+ * @file hw_snc.h
+ *
+ * @brief Sensor Node Controller definitions for the host (POSIX) build
+ *
+ * There is no SNC on the host. The SNC headers include this file but the CM33 side of the SNC
+ * queues (snc_queues.c) needs nothing from it.
+ *
+ * Copyright (C) 2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ ****************************************************************************************
+ */
+
+#ifndef HW_SNC_H_
+#define HW_SNC_H_
+
+#endif /* HW_SNC_H_ */
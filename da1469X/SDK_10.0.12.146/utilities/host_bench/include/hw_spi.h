@@ -0,0 +1,79 @@
+/**
+ ****************************************************************************************
+ *
+ * @file hw_spi.h
+ *
+ * @brief SPI definitions for the host (POSIX) build
+ *
+ * Subset of bsp/peripherals/include/hw_spi.h used by the SPI adapter, implemented by
+ * stubs/hw_spi_mock.c.
+ *
+ * Copyright (C) 2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ ****************************************************************************************
+ */
+
+#ifndef HW_SPI_H_
+#define HW_SPI_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "hw_gpio.h"
+
+#define HW_SPI_DMA_SUPPORT              ( 0 )
+
+typedef void (*hw_spi_tx_callback)(void *user_data, uint16_t transferred);
+
+/*
+ * SPI ids keep the type of the target, but are plain indexes into the controller table of
+ * stubs/hw_spi_mock.c
+ */
+#define HW_SPI1         ((void *) 1)
+#define HW_SPI2         ((void *) 2)
+typedef void * HW_SPI_ID;
+
+typedef enum {
+        HW_SPI_WORD_8BIT = 0,
+        HW_SPI_WORD_16BIT = 1,
+        HW_SPI_WORD_32BIT = 2,
+        HW_SPI_WORD_9BIT = 3,
+} HW_SPI_WORD;
+
+typedef enum {
+        HW_SPI_MODE_MASTER,
+        HW_SPI_MODE_SLAVE,
+} HW_SPI_MODE;
+
+typedef struct {
+        HW_GPIO_PORT port;
+        HW_GPIO_PIN pin;
+} SPI_Pad;
+
+/**
+ * \brief SPI configuration (the clock and FIFO settings of the target are not needed)
+ */
+typedef struct
+{
+        SPI_Pad         cs_pad;
+        HW_SPI_WORD     word_mode;
+        HW_SPI_MODE     smn_role;
+} spi_config;
+
+void hw_spi_init(HW_SPI_ID id, const spi_config *cfg);
+void hw_spi_deinit(HW_SPI_ID id);
+void hw_spi_enable(HW_SPI_ID id, uint8_t on);
+bool hw_spi_is_occupied(const HW_SPI_ID id);
+HW_SPI_MODE hw_spi_is_slave(HW_SPI_ID id);
+void hw_spi_set_cs_low(HW_SPI_ID id);
+void hw_spi_set_cs_high(HW_SPI_ID id);
+void hw_spi_wait_while_busy(HW_SPI_ID id);
+void hw_spi_writeread_buf(HW_SPI_ID id, const uint8_t *out_buf, uint8_t *in_buf, uint16_t len,
+                                                        hw_spi_tx_callback cb, void *user_data);
+void hw_spi_write_buf(HW_SPI_ID id, const uint8_t *out_buf, uint16_t len,
+                                                        hw_spi_tx_callback cb, void *user_data);
+void hw_spi_read_buf(HW_SPI_ID id, uint8_t *in_buf, uint16_t len,
+                                                        hw_spi_tx_callback cb, void *user_data);
+
+#endif /* HW_SPI_H_ */
@@ -0,0 +1,51 @@
+/**
+ ****************************************************************************************
+ *
+ * @file hw_sys.h
+ *
+ * @brief System definitions for the host (POSIX) build
+ *
+ * Copyright (C) 2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ ****************************************************************************************
+ */
+
+#ifndef HW_SYS_H_
+#define HW_SYS_H_
+
+/*
+ * \brief Enumerations used when accessing the SW BSR variable
+ */
+typedef enum {
+        SW_BSR_MASTER_NONE = 1 << 0,
+        SW_BSR_MASTER_SNC = 1 << 1,
+        SW_BSR_MASTER_SYSCPU = 1 << 2,
+        SW_BSR_MASTER_CMAC = 1 << 3,
+} SW_BSR_MASTER_ID;
+
+typedef enum {
+        BSR_PERIPH_ID_SNC = 0,
+        BSR_PERIPH_ID_SPI1 = 1,
+        BSR_PERIPH_ID_SPI2 = 2,
+        BSR_PERIPH_ID_UART1 = 3,
+        BSR_PERIPH_ID_UART2 = 4,
+        BSR_PERIPH_ID_UART3 = 5,
+        BSR_PERIPH_ID_I2C1 = 6,
+        BSR_PERIPH_ID_I2C2 = 7,
+        BSR_PERIPH_ID_MOTOR = 8,
+        BSR_PERIPH_ID_GPADC = 9,
+        BSR_PERIPH_ID_SDADC = 10,
+        BSR_PERIPH_ID_MAX = 16,
+} HW_SYS_BSR_PERIPH_ID;
+
+static inline void hw_sys_pd_com_enable(void)
+{
+}
+
+static inline void hw_sys_pd_com_disable(void)
+{
+}
+
+#endif /* HW_SYS_H_ */
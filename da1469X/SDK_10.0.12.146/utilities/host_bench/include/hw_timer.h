@@ -0,0 +1,27 @@
+/**
+ ****************************************************************************************
+ *
+ * @file hw_timer.h
+ *
+ * @brief Timer definitions for the host (POSIX) build
+ *
+ * Keeps the timer id type of bsp/peripherals/include/hw_timer.h for the declarations of the
+ * SNC timer macros.
+ *
+ * Copyright (C) 2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ ****************************************************************************************
+ */
+
+#ifndef HW_TIMER_H_
+#define HW_TIMER_H_
+
+/**
+ * \brief Timer id
+ *
+ */
+typedef void * HW_TIMER_ID;
+
+#endif /* HW_TIMER_H_ */
@@ -0,0 +1,125 @@
+/**
+ ****************************************************************************************
+ *
+ * @file hw_uart.h
+ *
+ * @brief UART definitions for the host (POSIX) build
+ *
+ * Copyright (C) 2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ ****************************************************************************************
+ */
+
+#ifndef HW_UART_H_
+#define HW_UART_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "hw_dma.h"
+
+#define HW_UART_DMA_SUPPORT     (1)
+#define HW_UART_USE_DMA_SUPPORT (1)
+
+/*
+ * UART ids keep the type of the target, but are plain indexes into the pty table of
+ * stubs/uart_pty.c
+ */
+#define HW_UART1        ((uint16_t *) 1)
+#define HW_UART2        ((uint16_t *) 2)
+#define HW_UART3        ((uint16_t *) 3)
+typedef uint16_t * HW_UART_ID;
+
+/**
+ * \brief Baud rates (ignored, the pty transfers at memory speed)
+ */
+typedef enum {
+        HW_UART_BAUDRATE_1000000   = 0x00000200,
+        HW_UART_BAUDRATE_500000    = 0x00000400,
+        HW_UART_BAUDRATE_230400    = 0x0000080b,
+        HW_UART_BAUDRATE_115200    = 0x00001106,
+        HW_UART_BAUDRATE_57600     = 0x0000220c,
+        HW_UART_BAUDRATE_38400     = 0x00003401,
+        HW_UART_BAUDRATE_28800     = 0x00004507,
+        HW_UART_BAUDRATE_19200     = 0x00006803,
+        HW_UART_BAUDRATE_14400     = 0x00008a0e,
+        HW_UART_BAUDRATE_9600      = 0x0000d005,
+        HW_UART_BAUDRATE_4800      = 0x0001a00b,
+} HW_UART_BAUDRATE;
+
+typedef enum {
+        HW_UART_DATABITS_5        = 0,
+        HW_UART_DATABITS_6        = 1,
+        HW_UART_DATABITS_7        = 2,
+        HW_UART_DATABITS_8        = 3,
+} HW_UART_DATABITS;
+
+typedef enum {
+        HW_UART_PARITY_NONE     = 0,
+        HW_UART_PARITY_ODD      = 1,
+        HW_UART_PARITY_EVEN     = 3,
+} HW_UART_PARITY;
+
+typedef enum {
+        HW_UART_STOPBITS_1 = 0,
+        HW_UART_STOPBITS_2 = 1,
+} HW_UART_STOPBITS;
+
+typedef enum {
+        HW_UART_CONFIG_ERR_NOERR        = 0,
+} HW_UART_CONFIG_ERR;
+
+typedef struct {
+        HW_UART_BAUDRATE        baud_rate;
+        HW_UART_DATABITS        data:2;
+        HW_UART_PARITY          parity:2;
+        HW_UART_STOPBITS        stop:1;
+        uint8_t                 auto_flow_control:1;
+        uint8_t                 use_fifo:1;
+        uint8_t                 use_dma:1;
+        HW_DMA_CHANNEL          tx_dma_channel:4;
+        HW_DMA_CHANNEL          rx_dma_channel:4;
+} uart_config;
+
+typedef struct {
+        HW_UART_BAUDRATE        baud_rate;
+        HW_UART_DATABITS        data:2;
+        HW_UART_PARITY          parity:2;
+        HW_UART_STOPBITS        stop:1;
+        uint8_t                 auto_flow_control:1;
+        uint8_t                 use_fifo:1;
+        uint8_t                 tx_fifo_tr_lvl:2;
+        uint8_t                 rx_fifo_tr_lvl:2;
+        uint8_t                 use_dma:1;
+        uint8_t                 tx_dma_burst_lvl:2;
+        uint8_t                 rx_dma_burst_lvl:2;
+        HW_DMA_CHANNEL          tx_dma_channel:4;
+        HW_DMA_CHANNEL          rx_dma_channel:4;
+} uart_config_ex;
+
+typedef void (*hw_uart_tx_callback)(void *user_data, uint16_t written);
+typedef void (*hw_uart_rx_callback)(void *user_data, uint16_t read);
+
+void hw_uart_init(HW_UART_ID uart, const uart_config *cfg);
+
+/**
+ * \brief Write buffer to the pty
+ *
+ * Without callback the call returns when all data is written. With callback the transfer is
+ * handed over to the UART thread and \p cb is called from (simulated) interrupt context.
+ */
+HW_UART_CONFIG_ERR hw_uart_send(HW_UART_ID uart, const void *data, uint16_t len,
+                                                        hw_uart_tx_callback cb, void *user_data);
+
+bool hw_uart_is_busy(HW_UART_ID uart);
+
+/**
+ * \brief CTS is always asserted on the pty
+ */
+static inline bool hw_uart_cts_getf(HW_UART_ID uart)
+{
+        return true;
+}
+
+#endif /* HW_UART_H_ */
@@ -0,0 +1,32 @@
+/**
+ ****************************************************************************************
+ *
+ * @file interrupts.h
+ *
+ * @brief Interrupt context helpers for the host (POSIX) build
+ *
+ * Copyright (C) 2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ ****************************************************************************************
+ */
+
+#ifndef INTERRUPTS_H_
+#define INTERRUPTS_H_
+
+#include <stdbool.h>
+#include "sdk_defs.h"
+#include "FreeRTOS.h"
+
+/**
+ * \brief Check if running in (simulated) interrupt context
+ *
+ * \sa vPortEnterISR
+ */
+static inline bool in_interrupt(void)
+{
+        return xPortInISR() != pdFALSE;
+}
+
+#endif /* INTERRUPTS_H_ */
@@ -0,0 +1,34 @@
+/**
+ ****************************************************************************************
+ *
+ * @file qspi_automode.h
+ *
+ * @brief QSPI flash definitions for the host (POSIX) build
+ *
+ * Copyright (C) 2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ ****************************************************************************************
+ */
+
+#ifndef QSPI_AUTOMODE_H_
+#define QSPI_AUTOMODE_H_
+
+#include <stdint.h>
+
+/**
+ * \brief Flash sector size, the RAM backed flash keeps the erase granularity of the target
+ */
+#define FLASH_SECTOR_SIZE       (0x1000)
+
+/**
+ * \brief Get CPU accessible pointer to flash contents
+ *
+ * \param [in] addr flash address
+ *
+ * \return pointer into the RAM image of the flash
+ */
+const void *qspi_automode_addr(uint32_t addr);
+
+#endif /* QSPI_AUTOMODE_H_ */
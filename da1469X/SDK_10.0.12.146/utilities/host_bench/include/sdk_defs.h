@@ -0,0 +1,73 @@
+/**
+ ****************************************************************************************
+ *
+ * @file sdk_defs.h
+ *
+ * @brief Platform definitions for the host (POSIX) build
+ *
+ * Replaces bsp/include/sdk_defs.h. Only the generic helpers used by the middleware are kept,
+ * memory map and register access macros have no meaning on the host.
+ *
+ * Copyright (C) 2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ ****************************************************************************************
+ */
+
+#ifndef __SDK_DEFS_H__
+#define __SDK_DEFS_H__
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include "cmsis_compiler.h"
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Retention attributes, all memory is retained on the host */
+#define __RETAINED
+#define __RETAINED_1
+#define __RETAINED_RW
+#define __RETAINED_UNINIT
+#define __RETAINED_CONST_INIT
+#define __RETAINED_CODE
+
+#define __UNUSED                __attribute__((unused))
+#define __LTO_EXT               __attribute__((externally_visible))
+
+#define ASSERT_WARNING(a)       do { if (!(a)) { abort(); } } while (0)
+#define ASSERT_ERROR(a)         do { if (!(a)) { abort(); } } while (0)
+
+/* The host port runs one task at a time, so the simulated CPU is never preempted by code
+ * that could touch data protected this way */
+#define GLOBAL_INT_DISABLE()    do {
+#define GLOBAL_INT_RESTORE()    } while (0)
+
+#define MIN(a, b)  (((a) < (b)) ? (a) : (b))
+#define MAX(a, b)  (((a) > (b)) ? (a) : (b))
+
+#define ARRAY_LENGTH(array) (sizeof((array))/sizeof((array)[0]))
+
+#define SWAP16(a) __builtin_bswap16(a)
+#define SWAP32(a) __builtin_bswap32(a)
+
+#define DEPRECATED __attribute__((deprecated))
+#define DEPRECATED_MSG(msg) __attribute__((deprecated(msg)))
+#define DEPRECATED_LITERAL_MACRO(macro, msg)
+
+#define OPT_MEMCPY      memcpy
+#define OPT_MEMMOVE     memmove
+#define OPT_MEMSET      memset
+
+typedef unsigned char      uint8;   //  8 bits
+typedef unsigned short     uint16;  // 16 bits
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __SDK_DEFS_H__ */
@@ -0,0 +1,37 @@
+/**
+ ****************************************************************************************
+ *
+ * @file sys_bsr.h
+ *
+ * @brief Busy status register definitions for the host (POSIX) build
+ *
+ * There is only one master on the host, acquiring a peripheral always succeeds.
+ *
+ * Copyright (C) 2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ ****************************************************************************************
+ */
+
+#ifndef SYS_BSR_H_
+#define SYS_BSR_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "hw_sys.h"
+
+static inline void sys_sw_bsr_acquire(SW_BSR_MASTER_ID sw_bsr_master_id, uint32_t periph_id)
+{
+}
+
+static inline bool sys_sw_bsr_acquired(SW_BSR_MASTER_ID sw_bsr_master_id, uint32_t periph_id)
+{
+        return true;
+}
+
+static inline void sys_sw_bsr_release(SW_BSR_MASTER_ID sw_bsr_master_id, uint32_t periph_id)
+{
+}
+
+#endif /* SYS_BSR_H_ */
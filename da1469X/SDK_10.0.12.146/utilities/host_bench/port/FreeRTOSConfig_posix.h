@@ -0,0 +1,84 @@
+/**
+ ****************************************************************************************
+ *
+ * @file FreeRTOSConfig_posix.h
+ *
+ * @brief FreeRTOS configuration for the host (POSIX) build
+ *
+ * Included by sdk/free_rtos/include/FreeRTOSConfig.h when OS_FREERTOS_POSIX is defined.
+ * Kept as close as possible to the target configuration, so that kernel behavior seen by the
+ * middleware is the same. Hardware related options (tickless idle, interrupt priorities) are
+ * dropped.
+ *
+ * Copyright (C) 2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ ****************************************************************************************
+ */
+
+#ifndef FREERTOS_CONFIG_POSIX_H_
+#define FREERTOS_CONFIG_POSIX_H_
+
+#include <stdint.h>
+
+#define configUSE_PREEMPTION                    1
+#define configUSE_IDLE_HOOK                     1       /* Tick is driven from the idle task */
+#define configUSE_TICK_HOOK                     0
+#define configCPU_CLOCK_HZ                      ( 32000000UL )
+#define configTICK_RATE_HZ                      ( ( TickType_t ) 500 )
+
+#define configMAX_PRIORITIES                    ( 7 )
+#define configMINIMAL_STACK_SIZE                ( ( unsigned short ) 100 )
+#ifndef configTOTAL_HEAP_SIZE
+#define configTOTAL_HEAP_SIZE                   ( ( size_t ) ( 256 * 1024 ) )
+#endif
+#define configMAX_TASK_NAME_LEN                 ( 16 )
+#define configUSE_TRACE_FACILITY                1
+#define configGENERATE_RUN_TIME_STATS           0
+#define configUSE_16_BIT_TICKS                  0
+#define configIDLE_SHOULD_YIELD                 1
+#define configUSE_MUTEXES                       1
+#define configQUEUE_REGISTRY_SIZE               8
+#define configCHECK_FOR_STACK_OVERFLOW          0       /* Tasks run on pthread stacks */
+#define configUSE_RECURSIVE_MUTEXES             1
+#define configUSE_MALLOC_FAILED_HOOK            1
+#define configUSE_APPLICATION_TASK_TAG          0
+#define configUSE_COUNTING_SEMAPHORES           1
+#define configUSE_QUEUE_SETS                    1
+#define configUSE_TICKLESS_IDLE                 0
+
+/* Co-routine definitions. */
+#define configUSE_CO_ROUTINES                   0
+#define configMAX_CO_ROUTINE_PRIORITIES         ( 2 )
+
+/* Software timer definitions. */
+#define configUSE_TIMERS                        1
+#define configTIMER_TASK_PRIORITY               ( configMAX_PRIORITIES - 1 )
+#ifndef configTIMER_QUEUE_LENGTH
+#define configTIMER_QUEUE_LENGTH                6
+#endif
+#ifndef configTIMER_TASK_STACK_DEPTH
+#define configTIMER_TASK_STACK_DEPTH            ( configMINIMAL_STACK_SIZE )
+#endif
+
+#define INCLUDE_vTaskPrioritySet                1
+#define INCLUDE_uxTaskPriorityGet               1
+#define INCLUDE_vTaskDelete                     1
+#define INCLUDE_vTaskCleanUpResources           1
+#define INCLUDE_vTaskSuspend                    1
+#define INCLUDE_vTaskDelayUntil                 1
+#define INCLUDE_vTaskDelay                      1
+#define INCLUDE_eTaskGetState                   1
+#define INCLUDE_xEventGroupSetBitFromISR        1
+#define INCLUDE_xTimerPendFunctionCall          1
+#define INCLUDE_uxTaskGetStackHighWaterMark     1
+#define INCLUDE_xTaskGetCurrentTaskHandle       1
+
+void vAssertCalled(const char *file, int line);
+#define configASSERT( x ) if( ( x ) == 0 ) { vAssertCalled( __FILE__, __LINE__ ); }
+
+/* Defining portENTER_CRITICAL here keeps portable.h from pulling in the DA1469x port */
+#include "portmacro.h"
+
+#endif /* FREERTOS_CONFIG_POSIX_H_ */
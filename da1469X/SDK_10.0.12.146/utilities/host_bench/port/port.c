@@ -0,0 +1,272 @@
+/**
+ ****************************************************************************************
+ *
+ * @file port.c
+ *
+ * @brief FreeRTOS port for the host (POSIX) build
+ *
+ * Each task is backed by a detached pthread. A single mutex models the CPU: the thread of the
+ * running task always owns it and only releases it while waiting to be scheduled again, so
+ * FreeRTOS data structures are only ever touched by one thread at a time. A context switch
+ * marks the next thread as running, wakes it and puts the current thread to sleep on its own
+ * condition variable.
+ *
+ * The tick is generated by the idle task: it releases the CPU, sleeps until the next tick
+ * boundary (CLOCK_MONOTONIC) and calls xTaskIncrementTick(). As a consequence the tick count
+ * does not advance while a task is busy; time spent in benchmarks must be measured with the host
+ * clock. Simulated interrupts that make a task ready wake the idle task up before the tick.
+ *
+ * Copyright (C) 2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ ****************************************************************************************
+ */
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+typedef struct {
+        pthread_t thread;
+        pthread_cond_t cond;            /* Signaled when the thread is given the CPU */
+        bool running;                   /* Thread owns the CPU */
+        bool exiting;                   /* Task has been deleted, thread must exit */
+        TaskFunction_t code;
+        void *params;
+} host_thread_t;
+
+#define NSEC_PER_SEC            (1000000000L)
+#define TICK_PERIOD_NSEC        (NSEC_PER_SEC / configTICK_RATE_HZ)
+
+extern void * volatile pxCurrentTCB;
+
+static pthread_mutex_t cpu_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t scheduler_end_cond = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t idle_cond;
+static bool scheduler_running;
+static UBaseType_t critical_nesting;
+static volatile bool yield_pending;
+static struct timespec next_tick;
+static __thread bool isr_context;
+
+/* pxPortInitialiseStack() stores the thread at the top of the task stack and returns its
+ * address, which the kernel keeps as the first member of the TCB. */
+static host_thread_t *thread_of(void *tcb)
+{
+        StackType_t *top_of_stack = *(StackType_t **) tcb;
+
+        return (host_thread_t *) *top_of_stack;
+}
+
+static void thread_exit(host_thread_t *t)
+{
+        pthread_mutex_unlock(&cpu_lock);
+        pthread_cond_destroy(&t->cond);
+        free(t);
+        pthread_exit(NULL);
+}
+
+/* Called with cpu_lock held, returns with cpu_lock held and the thread owning the CPU */
+static void wait_for_cpu(host_thread_t *t)
+{
+        while (!t->running && !t->exiting) {
+                pthread_cond_wait(&t->cond, &cpu_lock);
+        }
+
+        if (t->exiting) {
+                thread_exit(t);
+        }
+}
+
+static void switch_to(host_thread_t *self, host_thread_t *next)
+{
+        self->running = false;
+        next->running = true;
+        pthread_cond_signal(&next->cond);
+        wait_for_cpu(self);
+}
+
+static void *thread_main(void *arg)
+{
+        host_thread_t *t = arg;
+
+        pthread_mutex_lock(&cpu_lock);
+        wait_for_cpu(t);
+
+        t->code(t->params);
+
+        /* Tasks must not return */
+        configASSERT(0);
+        return NULL;
+}
+
+StackType_t *pxPortInitialiseStack(StackType_t *pxTopOfStack, TaskFunction_t pxCode,
+                                                                        void *pvParameters)
+{
+        host_thread_t *t;
+        pthread_attr_t attr;
+
+        t = calloc(1, sizeof(*t));
+        configASSERT(t);
+        t->code = pxCode;
+        t->params = pvParameters;
+        pthread_cond_init(&t->cond, NULL);
+
+        pthread_attr_init(&attr);
+        pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+        if (pthread_create(&t->thread, &attr, thread_main, t) != 0) {
+                configASSERT(0);
+        }
+        pthread_attr_destroy(&attr);
+
+        *pxTopOfStack = (StackType_t) t;
+
+        return pxTopOfStack;
+}
+
+void vPortCleanUpTCB(void *pxTCB)
+{
+        host_thread_t *t = thread_of(pxTCB);
+
+        t->exiting = true;
+        pthread_cond_signal(&t->cond);
+}
+
+BaseType_t xPortStartScheduler(void)
+{
+        host_thread_t *first;
+        pthread_condattr_t attr;
+
+        pthread_condattr_init(&attr);
+        pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+        pthread_cond_init(&idle_cond, &attr);
+        pthread_condattr_destroy(&attr);
+
+        pthread_mutex_lock(&cpu_lock);
+
+        scheduler_running = true;
+        clock_gettime(CLOCK_MONOTONIC, &next_tick);
+
+        first = thread_of(pxCurrentTCB);
+        first->running = true;
+        pthread_cond_signal(&first->cond);
+
+        while (scheduler_running) {
+                pthread_cond_wait(&scheduler_end_cond, &cpu_lock);
+        }
+
+        pthread_mutex_unlock(&cpu_lock);
+
+        return pdFALSE;
+}
+
+void vPortEndScheduler(void)
+{
+        host_thread_t *self = thread_of(pxCurrentTCB);
+
+        scheduler_running = false;
+        pthread_cond_signal(&scheduler_end_cond);
+
+        /* Give up the CPU for good, vTaskStartScheduler() returns in the main thread */
+        self->running = false;
+        wait_for_cpu(self);
+}
+
+void vPortYield(void)
+{
+        host_thread_t *self;
+        host_thread_t *next;
+
+        if (isr_context || critical_nesting) {
+                /* Performed when the current task leaves the critical section or is resumed */
+                yield_pending = true;
+                return;
+        }
+
+        do {
+                yield_pending = false;
+                self = thread_of(pxCurrentTCB);
+                vTaskSwitchContext();
+                next = thread_of(pxCurrentTCB);
+                if (next != self) {
+                        switch_to(self, next);
+                }
+        } while (yield_pending);
+}
+
+void vPortYieldFromISR(void)
+{
+        /* ...FromISR() API is sometimes used from tasks too, switch right away as PendSV would */
+        vPortYield();
+}
+
+void vPortEnterCritical(void)
+{
+        critical_nesting++;
+}
+
+void vPortExitCritical(void)
+{
+        configASSERT(critical_nesting);
+
+        critical_nesting--;
+        if (critical_nesting == 0 && yield_pending && !isr_context) {
+                vPortYield();
+        }
+}
+
+void vPortEnterISR(void)
+{
+        pthread_mutex_lock(&cpu_lock);
+        isr_context = true;
+}
+
+void vPortExitISR(void)
+{
+        isr_context = false;
+        if (yield_pending) {
+                pthread_cond_signal(&idle_cond);
+        }
+        pthread_mutex_unlock(&cpu_lock);
+}
+
+BaseType_t xPortInISR(void)
+{
+        return isr_context;
+}
+
+void vApplicationIdleHook(void)
+{
+        struct timespec now;
+
+        /* Let simulated interrupts in while waiting for the next tick */
+        while (!yield_pending) {
+                if (pthread_cond_timedwait(&idle_cond, &cpu_lock, &next_tick) == ETIMEDOUT) {
+                        break;
+                }
+        }
+
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        if (now.tv_sec > next_tick.tv_sec ||
+                        (now.tv_sec == next_tick.tv_sec && now.tv_nsec >= next_tick.tv_nsec)) {
+                next_tick.tv_nsec += TICK_PERIOD_NSEC;
+                if (next_tick.tv_nsec >= NSEC_PER_SEC) {
+                        next_tick.tv_nsec -= NSEC_PER_SEC;
+                        next_tick.tv_sec++;
+                }
+
+                if (xTaskIncrementTick() != pdFALSE) {
+                        yield_pending = true;
+                }
+        }
+
+        if (yield_pending) {
+                vPortYield();
+        }
+}
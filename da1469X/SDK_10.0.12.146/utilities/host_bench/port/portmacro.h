@@ -0,0 +1,118 @@
+/**
+ ****************************************************************************************
+ *
+ * @file portmacro.h
+ *
+ * @brief FreeRTOS port for the host (POSIX) build
+ *
+ * Every FreeRTOS task is backed by a pthread, but only the thread owning the simulated CPU
+ * runs at any time, so kernel data is never accessed concurrently. Context switches hand the
+ * CPU over from one thread to the other. Simulated interrupts (e.g. the pty backed UART) take
+ * the CPU only while no task runs, i.e. while the idle task sleeps waiting for the next tick.
+ *
+ * Copyright (C) 2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ ****************************************************************************************
+ */
+
+#ifndef PORTMACRO_H
+#define PORTMACRO_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Type definitions. */
+#define portCHAR                char
+#define portFLOAT               float
+#define portDOUBLE              double
+#define portLONG                long
+#define portSHORT               short
+#define portSTACK_TYPE          unsigned long
+#define portBASE_TYPE           long
+
+typedef portSTACK_TYPE StackType_t;
+typedef long BaseType_t;
+typedef unsigned long UBaseType_t;
+
+#if( configUSE_16_BIT_TICKS == 1 )
+        typedef uint16_t TickType_t;
+        #define portMAX_DELAY ( TickType_t ) 0xffff
+#else
+        typedef uint32_t TickType_t;
+        #define portMAX_DELAY ( TickType_t ) 0xffffffffUL
+        #define portTICK_TYPE_IS_ATOMIC 1
+#endif
+
+#define PRIVILEGED_APP_FUNCTION
+#define PRIVILEGED_DATA
+#define INITIALISED_PRIVILEGED_DATA
+
+/* Architecture specifics. */
+#define portSTACK_GROWTH                ( -1 )
+#define portTICK_PERIOD_MS              ( ( TickType_t ) 1000 / configTICK_RATE_HZ )
+#define portBYTE_ALIGNMENT              8
+#define portPOINTER_SIZE_TYPE           uintptr_t
+#define portNOP()
+
+#define portCONVERT_MS_2_TICKS( x )     (TickType_t)( ( ((uint64_t) x) * configTICK_RATE_HZ ) / 1000 )
+#define portCONVERT_TICKS_2_MS( x )     (uint32_t)( ( ((uint64_t) x) * 1000 ) / configTICK_RATE_HZ )
+
+/* Scheduler utilities. */
+void vPortYield(void);
+void vPortYieldFromISR(void);
+
+#define portYIELD()                     vPortYield()
+#define portEND_SWITCHING_ISR( xSwitchRequired ) \
+        do { if( xSwitchRequired ) vPortYieldFromISR(); } while (0)
+#define portYIELD_FROM_ISR( x )         portEND_SWITCHING_ISR( x )
+
+/* Critical section management. */
+void vPortEnterCritical(void);
+void vPortExitCritical(void);
+
+#define portSET_INTERRUPT_MASK_FROM_ISR()       0
+#define portCLEAR_INTERRUPT_MASK_FROM_ISR(x)    ( void ) ( x )
+#define portDISABLE_INTERRUPTS()
+#define portENABLE_INTERRUPTS()
+#define portENTER_CRITICAL()                    vPortEnterCritical()
+#define portEXIT_CRITICAL()                     vPortExitCritical()
+
+/* Task function macros as described on the FreeRTOS.org WEB site. */
+#define portTASK_FUNCTION_PROTO( vFunction, pvParameters ) void vFunction( void *pvParameters )
+#define portTASK_FUNCTION( vFunction, pvParameters ) void vFunction( void *pvParameters )
+
+/* Tasks are backed by threads, which must be released together with the TCB. */
+void vPortCleanUpTCB(void *pxTCB);
+#define portCLEAN_UP_TCB( pxTCB )       vPortCleanUpTCB( pxTCB )
+
+#define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS()
+#define portGET_RUN_TIME_COUNTER_VALUE() 0
+
+/**
+ * \brief Enter simulated interrupt context
+ *
+ * Called by host threads emulating peripherals before using FreeRTOS ...FromISR() API. Blocks
+ * until no task is running.
+ */
+void vPortEnterISR(void);
+
+/**
+ * \brief Leave simulated interrupt context
+ */
+void vPortExitISR(void);
+
+/**
+ * \brief Check if current thread is in simulated interrupt context
+ */
+BaseType_t xPortInISR(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PORTMACRO_H */
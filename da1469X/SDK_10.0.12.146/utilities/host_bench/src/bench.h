@@ -0,0 +1,90 @@
+/**
+ ****************************************************************************************
+ *
+ * @file bench.h
+ *
+ * @brief Host benchmark suite
+ *
+ * Copyright (C) 2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ ****************************************************************************************
+ */
+
+#ifndef BENCH_H_
+#define BENCH_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "hw_uart.h"
+
+/**
+ * \brief Benchmark definition
+ */
+typedef struct {
+        const char *name;               /**< Name used to select benchmark on the command line */
+        void (*run)(uint32_t scale);    /**< Runs in task context, \p scale multiplies iterations */
+} bench_t;
+
+/**
+ * \brief Get monotonic host time
+ *
+ * \return time in nanoseconds
+ */
+uint64_t bench_now_ns(void);
+
+/**
+ * \brief Get host CPU cycle counter
+ *
+ * \return time stamp counter on x86 hosts, 0 elsewhere
+ */
+static inline uint64_t bench_now_cycles(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+        return __builtin_ia32_rdtsc();
+#else
+        return 0;
+#endif
+}
+
+/**
+ * \brief Print one result line
+ *
+ * \param [in] name result name
+ * \param [in] ops number of operations performed
+ * \param [in] ns time spent in nanoseconds
+ * \param [in] fmt additional printf-like information, can be NULL
+ */
+void bench_report(const char *name, uint32_t ops, uint64_t ns, const char *fmt, ...)
+                                                        __attribute__((format(printf, 4, 5)));
+
+/**
+ * \brief Wait until nothing more comes out of the UART
+ *
+ * \param [in] uart UART id
+ *
+ * \return number of bytes drained from the UART so far
+ */
+uint32_t bench_wait_uart_idle(HW_UART_ID uart);
+
+/**
+ * \brief Pseudo random numbers, same sequence on every run
+ */
+uint32_t bench_rand(void);
+
+void bench_msg_queue(uint32_t scale);
+void bench_logging(uint32_t scale);
+void bench_console(uint32_t scale);
+void bench_nvms(uint32_t scale);
+void bench_storage(uint32_t scale);
+void bench_spi_i2c(uint32_t scale);
+void bench_audio_src(uint32_t scale);
+void bench_haptics(uint32_t scale);
+void bench_lcdc_fb(uint32_t scale);
+void bench_clk_vote(uint32_t scale);
+void bench_timestamp(uint32_t scale);
+void bench_ringbuf(uint32_t scale);
+void bench_snc_queues(uint32_t scale);
+
+#endif /* BENCH_H_ */
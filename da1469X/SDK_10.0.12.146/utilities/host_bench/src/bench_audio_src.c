@@ -0,0 +1,282 @@
+/**
+ ****************************************************************************************
+ *
+ * @file bench_audio_src.c
+ *
+ * @brief Audio software sample rate converter and mixer benchmark
+ *
+ * Converts a 1 kHz sine at -1 dBFS in blocks of 10 ms, as it would be done in the audio manager
+ * buffer ready callback, and reports the time and host cycles per input sample. The output is
+ * compared to a least squares sine fit (THD+N) and to a double precision resampler with a four
+ * times longer filter.
+ *
+ * Copyright (C) 2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ ****************************************************************************************
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <sdk_defs.h>
+#include <sys_audio_sw_src.h>
+#include "bench.h"
+
+#define SECONDS                 1
+#define MAX_RATE                48000
+#define TONE_HZ                 1000.0
+#define TONE_AMPLITUDE          0.891           /* -1 dBFS */
+#define BLOCK_MS                10
+#define SETTLE_SAMPLES          512             /* skipped in the measurements, filter delay */
+#define REF_TAPS                (4 * dg_configSYS_AUDIO_SW_SRC_TAPS)
+#define REF_MAX_LEN             (2 * dg_configSYS_AUDIO_SW_SRC_MAX_RATIO * REF_TAPS)
+
+static sys_audio_sw_src_t src;
+static int16_t in_q15[MAX_RATE * SECONDS];
+static int16_t out_q15[MAX_RATE * dg_configSYS_AUDIO_SW_SRC_MAX_RATIO * SECONDS + 2];
+static int32_t in_q31[MAX_RATE * SECONDS];
+static int32_t out_q31[MAX_RATE * dg_configSYS_AUDIO_SW_SRC_MAX_RATIO * SECONDS + 2];
+static double ref[MAX_RATE * dg_configSYS_AUDIO_SW_SRC_MAX_RATIO * SECONDS + 2];
+static double ref_h[REF_MAX_LEN];
+static double y[MAX_RATE * dg_configSYS_AUDIO_SW_SRC_MAX_RATIO * SECONDS + 2];
+
+/*
+ * Residual of the least squares fit y = a * sin(wn) + b * cos(wn) + c, relative to the fitted
+ * sine, in dB.
+ */
+static double thd_n_db(const double *y, size_t len, double w)
+{
+        double s[3][3] = { { 0 } }, r[3] = { 0 }, p[3], res = 0;
+        int i, j, k;
+
+        for (size_t n = 0; n < len; n++) {
+                const double v[3] = { sin(w * n), cos(w * n), 1.0 };
+
+                for (i = 0; i < 3; i++) {
+                        for (j = 0; j < 3; j++) {
+                                s[i][j] += v[i] * v[j];
+                        }
+                        r[i] += v[i] * y[n];
+                }
+        }
+
+        /* Gaussian elimination, the normal matrix is well conditioned */
+        for (i = 0; i < 3; i++) {
+                for (j = i + 1; j < 3; j++) {
+                        const double f = s[j][i] / s[i][i];
+
+                        for (k = i; k < 3; k++) {
+                                s[j][k] -= f * s[i][k];
+                        }
+                        r[j] -= f * r[i];
+                }
+        }
+        for (i = 2; i >= 0; i--) {
+                p[i] = r[i];
+                for (k = i + 1; k < 3; k++) {
+                        p[i] -= s[i][k] * p[k];
+                }
+                p[i] /= s[i][i];
+        }
+
+        for (size_t n = 0; n < len; n++) {
+                const double e = y[n] - p[0] * sin(w * n) - p[1] * cos(w * n) - p[2];
+
+                res += e * e;
+        }
+
+        return 10 * log10(res / len / ((p[0] * p[0] + p[1] * p[1]) / 2));
+}
+
+/* Error of y against the reference output relative to the reference power, in dB */
+static double diff_db(const double *y, const double *r, size_t len)
+{
+        double e = 0, p = 0;
+
+        for (size_t n = 0; n < len; n++) {
+                e += (y[n] - r[n]) * (y[n] - r[n]);
+                p += r[n] * r[n];
+        }
+
+        return 10 * log10(e / p);
+}
+
+/*
+ * Double precision polyphase resampler with the same structure and delay as the converter under
+ * test but a longer Blackman windowed sinc. The filter is REF_TAPS / TAPS times longer and the
+ * output is shifted accordingly when compared.
+ */
+static size_t ref_resample(const int16_t *x, size_t len, uint8_t up, uint8_t down, uint32_t taps)
+{
+        const uint32_t flen = up * taps;
+        const double center = (flen - 1) / 2.0;
+        const double fc = 0.5 / (up > down ? up : down) - 2.75 / flen;
+        size_t n = 0;
+        uint32_t phase = 0;
+
+        for (uint32_t p = 0; p < up; p++) {
+                double sum = 0;
+
+                for (uint32_t t = 0; t < taps; t++) {
+                        const uint32_t k = p + t * up;
+                        const double d = k - center;
+                        const double w = 0.42 - 0.5 * cos(2 * M_PI * k / (flen - 1)) +
+                                         0.08 * cos(4 * M_PI * k / (flen - 1));
+
+                        ref_h[p * taps + t] = (d != 0 ? sin(2 * M_PI * fc * d) / (M_PI * d) :
+                                                        2 * fc) * w;
+                        sum += ref_h[p * taps + t];
+                }
+                for (uint32_t t = 0; t < taps; t++) {
+                        ref_h[p * taps + t] /= sum;
+                }
+        }
+
+        for (size_t i = 0; i < len; i++) {
+                while (phase < up) {
+                        double acc = 0;
+
+                        for (uint32_t t = 0; t < taps && t <= i; t++) {
+                                acc += ref_h[phase * taps + t] * x[i - t];
+                        }
+                        ref[n++] = acc;
+                        phase += down;
+                }
+                phase -= up;
+        }
+
+        return n;
+}
+
+static void fill_tone(uint32_t rate, size_t len)
+{
+        for (size_t n = 0; n < len; n++) {
+                const double v = TONE_AMPLITUDE * sin(2 * M_PI * TONE_HZ * n / rate);
+
+                in_q15[n] = (int16_t)lrint(v * 32767);
+                in_q31[n] = (int32_t)in_q15[n] << 16;
+        }
+}
+
+static void run_src(uint32_t in_rate, uint32_t out_rate, uint32_t scale)
+{
+        const size_t len = in_rate * SECONDS;
+        const size_t block = in_rate * BLOCK_MS / 1000;
+        uint64_t ns_q15 = 0, ns_q31 = 0, cyc_q15 = 0, cyc_q31 = 0;
+        size_t n = 0, ref_len, ref_taps, delay;
+        double thd, thd_ref, vs_ref;
+        char name[32];
+
+        fill_tone(in_rate, len);
+        if (!sys_audio_sw_src_init(&src, in_rate, out_rate)) {
+                printf("  %u -> %u Hz not supported\n", in_rate, out_rate);
+                return;
+        }
+
+        for (uint32_t s = 0; s < scale; s++) {
+                uint64_t t0, c0;
+
+                sys_audio_sw_src_reset(&src);
+                n = 0;
+                t0 = bench_now_ns();
+                c0 = bench_now_cycles();
+                for (size_t i = 0; i < len; i += block) {
+                        n += sys_audio_sw_src_q15(&src, &in_q15[i], block, &out_q15[n]);
+                }
+                cyc_q15 += bench_now_cycles() - c0;
+                ns_q15 += bench_now_ns() - t0;
+
+                sys_audio_sw_src_reset(&src);
+                n = 0;
+                t0 = bench_now_ns();
+                c0 = bench_now_cycles();
+                for (size_t i = 0; i < len; i += block) {
+                        n += sys_audio_sw_src_q31(&src, &in_q31[i], block, &out_q31[n]);
+                }
+                cyc_q31 += bench_now_cycles() - c0;
+                ns_q31 += bench_now_ns() - t0;
+        }
+
+        ref_taps = src.taps * REF_TAPS / dg_configSYS_AUDIO_SW_SRC_TAPS;
+        ref_len = ref_resample(in_q15, len, src.up, src.down, ref_taps);
+        /* Both filters are linear phase, align the centers */
+        delay = src.up * (ref_taps - src.taps) / 2 / src.down;
+
+        for (size_t i = 0; i < n; i++) {
+                y[i] = out_q15[i];
+        }
+        thd = thd_n_db(&y[SETTLE_SAMPLES], n - 2 * SETTLE_SAMPLES, 2 * M_PI * TONE_HZ / out_rate);
+        thd_ref = thd_n_db(&ref[SETTLE_SAMPLES], ref_len - 2 * SETTLE_SAMPLES,
+                           2 * M_PI * TONE_HZ / out_rate);
+        vs_ref = diff_db(&y[SETTLE_SAMPLES], &ref[SETTLE_SAMPLES + delay],
+                         n - 2 * SETTLE_SAMPLES - delay);
+
+        snprintf(name, sizeof(name), "src q15 %u -> %u", in_rate, out_rate);
+        bench_report(name, len * scale, ns_q15, "%.1f cycles/sample  %u MAC/sample  "
+                     "THD+N %.1f dB (ref %.1f dB)  vs ref %.1f dB",
+                     (double)cyc_q15 / (len * scale), src.taps * src.up / src.down,
+                     thd, thd_ref, vs_ref);
+
+        for (size_t i = 0; i < n; i++) {
+                y[i] = out_q31[i] / 65536.0;
+        }
+        thd = thd_n_db(&y[SETTLE_SAMPLES], n - 2 * SETTLE_SAMPLES, 2 * M_PI * TONE_HZ / out_rate);
+        vs_ref = diff_db(&y[SETTLE_SAMPLES], &ref[SETTLE_SAMPLES + delay],
+                         n - 2 * SETTLE_SAMPLES - delay);
+
+        snprintf(name, sizeof(name), "src q31 %u -> %u", in_rate, out_rate);
+        bench_report(name, len * scale, ns_q31, "%.1f cycles/sample  THD+N %.1f dB  vs ref %.1f dB",
+                     (double)cyc_q31 / (len * scale), thd, vs_ref);
+}
+
+static void run_mix(uint32_t scale)
+{
+        const size_t len = MAX_RATE * SECONDS;
+        const int16_t *const in[2] = { in_q15, out_q15 };
+        const uint16_t gain[2] = { SYS_AUDIO_SW_MIX_GAIN_UNITY / 2, SYS_AUDIO_SW_MIX_GAIN_UNITY };
+        uint64_t t0, c0, ns = 0, cyc = 0;
+        uint32_t clipped = 0;
+
+        fill_tone(MAX_RATE, len);
+        for (size_t n = 0; n < len; n++) {
+                out_q15[n] = (int16_t)(bench_rand() >> 18) - 8192;
+        }
+
+        for (uint32_t s = 0; s < scale; s++) {
+                t0 = bench_now_ns();
+                c0 = bench_now_cycles();
+                sys_audio_sw_mix_q15(&out_q15[len], in, gain, 2, len);
+                cyc += bench_now_cycles() - c0;
+                ns += bench_now_ns() - t0;
+        }
+
+        for (size_t n = 0; n < len; n++) {
+                const int32_t exp = (in_q15[n] / 2 + out_q15[n]);
+
+                ASSERT_WARNING(out_q15[len + n] >= exp - 1 && out_q15[len + n] <= exp + 1);
+                clipped += (out_q15[len + n] == INT16_MAX || out_q15[len + n] == INT16_MIN);
+        }
+
+        bench_report("mix q15 2-way", len * scale, ns, "%.1f cycles/sample  %u clipped",
+                     (double)cyc / (len * scale), clipped);
+}
+
+void bench_audio_src(uint32_t scale)
+{
+        static const uint32_t rates[][2] = {
+                { 16000, 48000 },
+                { 48000, 16000 },
+                { 32000, 48000 },
+                { 48000, 32000 },
+                { 16000, 32000 },
+                { 8000, 48000 },
+                { 48000, 8000 },
+        };
+
+        for (size_t i = 0; i < ARRAY_LENGTH(rates); i++) {
+                run_src(rates[i][0], rates[i][1], scale);
+        }
+        run_mix(scale);
+}
@@ -0,0 +1,321 @@
+/**
+ ****************************************************************************************
+ *
+ * @file bench_clk_vote.c
+ *
+ * @brief System clock vote table benchmark
+ *
+ * Replays traces of tasks that need a faster system clock in bursts, once through a model of
+ * cm_sys_clk_set() (PLL users kept in a list, the last non-PLL request wins) and once through the
+ * vote table of the clock manager (sys_clock_vote.c), and reports the clock switches, the time
+ * spent at each system clock and the time spent below the clock some task needs. The vote table
+ * must always select the lowest clock that satisfies all tasks.
+ *
+ * Copyright (C) 2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ ****************************************************************************************
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <sdk_defs.h>
+#include <osal.h>
+#include <sdk_list.h>
+#include "sys_clock_vote_internal.h"
+#include "bench.h"
+
+#define TRACE_US                (10 * 1000 * 1000)
+#define MAX_TASKS               4
+#define NUM_CLKS                3
+
+/* Task needing clk for duration_us every period_us */
+typedef struct {
+        const char *name;
+        sys_clk_t clk;
+        uint32_t period_us;
+        uint32_t offset_us;
+        uint32_t duration_us;
+} burst_t;
+
+typedef struct {
+        const char *name;
+        uint8_t num_tasks;
+        burst_t tasks[MAX_TASKS];
+} trace_t;
+
+typedef struct {
+        uint32_t time_us;
+        uint8_t task;
+        bool start;
+} event_t;
+
+typedef struct {
+        uint32_t switches;
+        uint32_t pll_starts;
+        uint64_t time_us[NUM_CLKS];
+        uint64_t below_demand_us;
+} clk_stats_t;
+
+/* Model of the PLL bookkeeping of cm_sys_clk_set() */
+typedef struct legacy_elem_t legacy_elem_t;
+struct legacy_elem_t {
+        legacy_elem_t *next;
+        OS_TASK task;
+        uint8_t task_pll_count;
+};
+
+typedef struct {
+        void *list;
+        uint8_t pll_count;
+        sys_clk_t sysclk;
+} legacy_t;
+
+static const trace_t traces[] = {
+        {
+                "audio+ble", 2, {
+                        { "audio",  sysclk_PLL96,   10000,    0,  2000 },
+                        { "ble",    sysclk_PLL96,    7500,  700,  1200 },
+                },
+        },
+        {
+                "audio+ble+sensor", 3, {
+                        { "audio",  sysclk_PLL96,   10000,    0,  2000 },
+                        { "ble",    sysclk_PLL96,    7500,  700,  1200 },
+                        { "sensor", sysclk_XTAL32M, 50000, 1500,  6000 },
+                },
+        },
+};
+
+static uint8_t clk_index(sys_clk_t clk)
+{
+        return clk == sysclk_PLL96 ? 2 : (clk == sysclk_XTAL32M ? 1 : 0);
+}
+
+static int event_cmp(const void *a, const void *b)
+{
+        const event_t *ea = a, *eb = b;
+
+        if (ea->time_us != eb->time_us) {
+                return ea->time_us < eb->time_us ? -1 : 1;
+        }
+        /* Burst ends first, a task never overlaps itself */
+        return (int)ea->start - (int)eb->start;
+}
+
+static uint32_t build_events(const trace_t *t, uint32_t length_us, event_t **events)
+{
+        uint32_t cnt = 0;
+        uint32_t max = 0;
+
+        for (uint8_t i = 0; i < t->num_tasks; i++) {
+                max += 2 * (length_us / t->tasks[i].period_us + 1);
+        }
+        *events = malloc(max * sizeof(event_t));
+        ASSERT_WARNING(*events);
+
+        for (uint8_t i = 0; i < t->num_tasks; i++) {
+                const burst_t *b = &t->tasks[i];
+
+                for (uint32_t s = b->offset_us; s + b->duration_us <= length_us; s += b->period_us) {
+                        (*events)[cnt++] = (event_t){ s, i, true };
+                        (*events)[cnt++] = (event_t){ s + b->duration_us, i, false };
+                }
+        }
+        qsort(*events, cnt, sizeof(event_t), event_cmp);
+
+        return cnt;
+}
+
+static bool legacy_match(const void *elem, const void *ud)
+{
+        return ((const legacy_elem_t *)elem)->task == ud;
+}
+
+/* Same decisions as cm_sys_clk_set(), without the hardware */
+static void legacy_set(legacy_t *l, OS_TASK task, sys_clk_t type)
+{
+        legacy_elem_t *elem = list_find(l->list, legacy_match, task);
+
+        if (type == sysclk_PLL96) {
+                if (elem == NULL) {
+                        elem = OS_MALLOC(sizeof(legacy_elem_t));
+                        OS_ASSERT(elem);
+                        elem->task = task;
+                        elem->task_pll_count = 1;
+                        list_add(&l->list, elem);
+                        l->pll_count++;
+                } else {
+                        elem->task_pll_count++;
+                }
+                l->sysclk = sysclk_PLL96;
+                return;
+        }
+
+        if (elem) {
+                if (--elem->task_pll_count == 0) {
+                        list_unlink(&l->list, legacy_match, task);
+                        OS_FREE(elem);
+                        l->pll_count--;
+                }
+        }
+        if (l->pll_count == 0) {
+                l->sysclk = type;
+        }
+        /* else cm_sysclk_pll_used_by_task */
+}
+
+static void account(clk_stats_t *st, sys_clk_t *current, sys_clk_t next, sys_clk_t demand,
+                    uint32_t elapsed_us)
+{
+        st->time_us[clk_index(*current)] += elapsed_us;
+        if (*current < demand) {
+                st->below_demand_us += elapsed_us;
+        }
+        if (next != *current) {
+                st->switches++;
+                if (next == sysclk_PLL96) {
+                        st->pll_starts++;
+                }
+                *current = next;
+        }
+}
+
+static sys_clk_t demand_of(const trace_t *t, const bool *active)
+{
+        sys_clk_t demand = sysclk_RC32;
+
+        for (uint8_t i = 0; i < t->num_tasks; i++) {
+                if (active[i] && t->tasks[i].clk > demand) {
+                        demand = t->tasks[i].clk;
+                }
+        }
+
+        return demand;
+}
+
+/*
+ * Legacy: every task calls cm_sys_clk_set() with its clock at the start of a burst and with
+ * sysclk_RC32, the clock the application runs at otherwise, at the end
+ */
+static void replay_legacy(const trace_t *t, const event_t *ev, uint32_t cnt, clk_stats_t *st)
+{
+        legacy_t l = { .sysclk = sysclk_RC32 };
+        sys_clk_t current = sysclk_RC32;
+        bool active[MAX_TASKS] = { 0 };
+        uint32_t last_us = 0;
+
+        for (uint32_t i = 0; i < cnt; i++) {
+                sys_clk_t demand = demand_of(t, active);
+
+                active[ev[i].task] = ev[i].start;
+                legacy_set(&l, (OS_TASK)(uintptr_t)(ev[i].task + 1),
+                           ev[i].start ? t->tasks[ev[i].task].clk : sysclk_RC32);
+                account(st, &current, l.sysclk, demand, ev[i].time_us - last_us);
+                last_us = ev[i].time_us;
+        }
+        ASSERT_WARNING(l.list == NULL);
+}
+
+static void replay_votes(const trace_t *t, const event_t *ev, uint32_t cnt, clk_stats_t *st)
+{
+        clk_vote_table_t table = { 0 };
+        cm_sys_clk_voter_t voter[MAX_TASKS];
+        sys_clk_t current = sysclk_RC32;
+        bool active[MAX_TASKS] = { 0 };
+        uint32_t last_us = 0;
+
+        for (uint8_t i = 0; i < t->num_tasks; i++) {
+                voter[i] = clk_vote_register(&table);
+                ASSERT_WARNING(voter[i] != CM_SYS_CLK_VOTER_INVALID);
+        }
+
+        for (uint32_t i = 0; i < cnt; i++) {
+                sys_clk_t demand = demand_of(t, active);
+                sys_clk_t next;
+
+                active[ev[i].task] = ev[i].start;
+                clk_vote_set(&table, voter[ev[i].task],
+                             ev[i].start ? t->tasks[ev[i].task].clk : sysclk_RC32);
+                next = clk_vote_aggregate(&table);
+                if (next != demand_of(t, active)) {
+                        printf("%s: %s at %u us, votes select %d instead of %d\n", t->name,
+                               t->tasks[ev[i].task].name, ev[i].time_us, next,
+                               demand_of(t, active));
+                        fflush(stdout);
+                        ASSERT_WARNING(0);
+                }
+                account(st, &current, next, demand, ev[i].time_us - last_us);
+                last_us = ev[i].time_us;
+        }
+
+        for (uint8_t i = 0; i < t->num_tasks; i++) {
+                clk_vote_unregister(&table, voter[i]);
+        }
+        ASSERT_WARNING(table.in_use == 0);
+}
+
+static void report(const char *trace, const char *method, const clk_stats_t *st, uint32_t ops,
+                   uint64_t ns)
+{
+        char name[48];
+        uint64_t total = st->time_us[0] + st->time_us[1] + st->time_us[2];
+
+        snprintf(name, sizeof(name), "clk_vote %s %s", trace, method);
+        bench_report(name, ops, ns, "%u switches  %u PLL starts  RC32 %.1f%%  XTAL32M %.1f%%  "
+                     "PLL96 %.1f%%  below demand %.2f%%", st->switches, st->pll_starts,
+                     100.0 * st->time_us[0] / total, 100.0 * st->time_us[1] / total,
+                     100.0 * st->time_us[2] / total, 100.0 * st->below_demand_us / total);
+}
+
+static void run(const trace_t *t, uint32_t scale)
+{
+        legacy_t l = { .sysclk = sysclk_RC32 };
+        clk_vote_table_t table = { 0 };
+        cm_sys_clk_voter_t voter[MAX_TASKS];
+        clk_stats_t legacy_stats = { 0 };
+        clk_stats_t vote_stats = { 0 };
+        volatile sys_clk_t sink;
+        event_t *ev;
+        uint32_t cnt;
+        uint64_t t0, legacy_ns, vote_ns;
+
+        cnt = build_events(t, TRACE_US * scale, &ev);
+
+        replay_legacy(t, ev, cnt, &legacy_stats);
+        replay_votes(t, ev, cnt, &vote_stats);
+
+        /* Bookkeeping cost only, same calls as the replays without the accounting */
+        t0 = bench_now_ns();
+        for (uint32_t i = 0; i < cnt; i++) {
+                legacy_set(&l, (OS_TASK)(uintptr_t)(ev[i].task + 1),
+                           ev[i].start ? t->tasks[ev[i].task].clk : sysclk_RC32);
+                sink = l.sysclk;
+        }
+        legacy_ns = bench_now_ns() - t0;
+
+        for (uint8_t i = 0; i < t->num_tasks; i++) {
+                voter[i] = clk_vote_register(&table);
+        }
+        t0 = bench_now_ns();
+        for (uint32_t i = 0; i < cnt; i++) {
+                clk_vote_set(&table, voter[ev[i].task],
+                             ev[i].start ? t->tasks[ev[i].task].clk : sysclk_RC32);
+                sink = clk_vote_aggregate(&table);
+        }
+        vote_ns = bench_now_ns() - t0;
+        (void)sink;
+
+        report(t->name, "set", &legacy_stats, cnt, legacy_ns);
+        report(t->name, "vote", &vote_stats, cnt, vote_ns);
+
+        free(ev);
+}
+
+void bench_clk_vote(uint32_t scale)
+{
+        for (size_t i = 0; i < ARRAY_LENGTH(traces); i++) {
+                run(&traces[i], scale);
+        }
+}
@@ -0,0 +1,57 @@
+/**
+ ****************************************************************************************
+ *
+ * @file bench_console.c
+ *
+ * @brief Console write benchmark over the pty UART
+ *
+ * Copyright (C) 2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ ****************************************************************************************
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <osal.h>
+#include <console.h>
+#include "bench.h"
+
+#define CONSOLE_UART            HW_UART1
+#define WRITES                  2000
+
+static const ad_uart_controller_conf_t console_uart_conf = {
+        .id = CONSOLE_UART,
+};
+
+static void run(const char *name, uint32_t count, int len)
+{
+        char line[128];
+        uint32_t drained;
+        uint64_t start;
+        uint32_t i;
+
+        memset(line, 'x', len - 1);
+        line[len - 1] = '\n';
+
+        drained = bench_wait_uart_idle(CONSOLE_UART);
+
+        start = bench_now_ns();
+        for (i = 0; i < count; i++) {
+                console_write(line, len);
+        }
+        drained = bench_wait_uart_idle(CONSOLE_UART) - drained;
+
+        /* Host time includes the final idle detection period */
+        bench_report(name, count, bench_now_ns() - start, "%u of %u bytes out",
+                                                (unsigned) drained, (unsigned) (count * len));
+}
+
+void bench_console(uint32_t scale)
+{
+        console_init(&console_uart_conf);
+
+        run("console_write 16B", WRITES * scale, 16);
+        run("console_write 128B", WRITES * scale, 128);
+}
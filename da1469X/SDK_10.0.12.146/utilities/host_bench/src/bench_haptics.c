@@ -0,0 +1,398 @@
+/**
+ ****************************************************************************************
+ *
+ * @file bench_haptics.c
+ *
+ * @brief Haptic waveform memory decoder benchmark
+ *
+ * Plays every sequence of a set of waveform memory blobs with the table based decoder
+ * (wm_decoder_update() and wm_decoder_render()) and with the reference decoder that parses
+ * the waveform memory on every update (wm_decoder_ref.c), and checks that amplitude, frequency
+ * and decoder state are identical at every step. Then measures host cycles per rendered ms.
+ *
+ * The blobs are an example blob, random blobs, random blobs with corrupted frames and, if
+ * HOST_BENCH_WM_BLOB names a file, the waveform memory in that file.
+ *
+ * Copyright (C) 2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ ****************************************************************************************
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sdk_defs.h>
+#include "wm_decoder.h"
+#include "wm_decoder_ref.h"
+#include "bench.h"
+
+#define RANDOM_BLOBS            100
+#define TICKS_PER_MS            24094           /* 2 ^ TIMER_DIV_SHIFT ticks per 1.36 ms */
+#define RENDER_STEP             (TICKS_PER_MS / 4)
+#define RENDER_BLOCK            64
+#define MAX_STEPS               2000000         /* per sequence, guards against endless loops */
+
+typedef struct {
+        uint8_t snippet_id;
+        uint8_t timebase;
+        uint8_t gain;
+        uint8_t loop_count;
+        uint16_t frequency;                     /* 0 for no FREQ command */
+} frame_t;
+
+typedef struct {
+        uint8_t data[WM_MAX_SIZE];
+        unsigned size;
+        unsigned n_snippets;
+        unsigned n_sequences;
+        unsigned seq_start;                     /* index of first sequence byte */
+} blob_t;
+
+typedef struct {
+        uint32_t blobs;
+        uint32_t sequences;
+        uint32_t steps;
+        uint32_t errors;                        /* sequences ending with a decode error */
+} check_stats_t;
+
+static wm_decoder decoder;
+static wm_ref_decoder ref;
+static int16_t amplitude[RENDER_BLOCK];
+static uint16_t frequency[RENDER_BLOCK];
+
+/* Start a blob with the number of snippets and sequences, pointers are filled later */
+static void blob_begin(blob_t *blob, unsigned n_snippets, unsigned n_sequences)
+{
+        memset(blob, 0, sizeof(*blob));
+        blob->n_snippets = n_snippets;
+        blob->n_sequences = n_sequences;
+        blob->data[0] = n_snippets;
+        blob->data[1] = n_sequences;
+        blob->size = 2 + n_snippets + n_sequences;
+}
+
+static bool blob_add_snippet(blob_t *blob, unsigned snippet_id, const uint8_t *pwl, unsigned len)
+{
+        if (blob->size + len > WM_MAX_SIZE) {
+                return false;
+        }
+        memcpy(&blob->data[blob->size], pwl, len);
+        blob->size += len;
+        blob->data[2 + snippet_id - 1] = blob->size - 1;
+        blob->seq_start = blob->size;
+
+        return true;
+}
+
+static bool blob_add_sequence(blob_t *blob, unsigned sequence_id, const frame_t *frames,
+                              unsigned n_frames)
+{
+        uint8_t buf[3];
+        unsigned len;
+
+        for (unsigned i = 0; i < n_frames; i++) {
+                const frame_t *f = &frames[i];
+
+                buf[0] = (f->snippet_id & 7) | (f->timebase << 3) | (f->gain << 5);
+                len = 1;
+                if (f->snippet_id > 7 || f->loop_count || f->frequency) {
+                        buf[1] = 0x80 | (f->snippet_id >> 3) | (f->loop_count << 3);
+                        len = 2;
+                        if (f->frequency) {
+                                buf[1] |= 0x04 | ((f->frequency >> 8) & 1) << 1;
+                                buf[2] = f->frequency & 0xFF;
+                                len = 3;
+                        }
+                }
+                if (blob->size + len > WM_MAX_SIZE) {
+                        return false;
+                }
+                memcpy(&blob->data[blob->size], buf, len);
+                blob->size += len;
+        }
+        blob->data[2 + blob->n_snippets + sequence_id] = blob->size - 1;
+
+        return true;
+}
+
+static void build_example(blob_t *blob)
+{
+        /* Ramp up and down, click, buzz with braking, silence */
+        static const uint8_t ramp[] = { 0x07, 0x8F, 0x30, 0xB0 };
+        static const uint8_t click[] = { 0x0F, 0x19, 0x00 };
+        static const uint8_t buzz[] = { 0x3C, 0x74, 0x2A, 0x10 };
+        static const frame_t seq0[] = { { 1, 0, 0, 0, 0 } };
+        static const frame_t seq1[] = { { 2, 1, 1, 2, 0 }, { 0, 2, 0, 1, 0 }, { 2, 1, 1, 0, 0 } };
+        static const frame_t seq2[] = { { 3, 2, 0, 3, 170 }, { 1, 3, 2, 0, 240 } };
+        static const frame_t seq3[] = { { 1, 0, 3, 15, 0 }, { 3, 0, 0, 0, 11 } };
+
+        blob_begin(blob, 3, 4);
+        blob_add_snippet(blob, 1, ramp, sizeof(ramp));
+        blob_add_snippet(blob, 2, click, sizeof(click));
+        blob_add_snippet(blob, 3, buzz, sizeof(buzz));
+        blob_add_sequence(blob, 0, seq0, ARRAY_LENGTH(seq0));
+        blob_add_sequence(blob, 1, seq1, ARRAY_LENGTH(seq1));
+        blob_add_sequence(blob, 2, seq2, ARRAY_LENGTH(seq2));
+        blob_add_sequence(blob, 3, seq3, ARRAY_LENGTH(seq3));
+}
+
+static void build_random(blob_t *blob, bool all_snippets)
+{
+        uint8_t pwl[8];
+        frame_t frames[6];
+        unsigned n_snippets, n_sequences, n, i;
+
+retry:
+        n_snippets = all_snippets ? 15 : 1 + bench_rand() % 15;
+        n_sequences = 1 + bench_rand() % WM_MAX_SEQUENCES;
+        blob_begin(blob, n_snippets, n_sequences);
+
+        for (unsigned s = 1; s <= n_snippets; s++) {
+                n = 1 + bench_rand() % 6;
+                for (i = 0; i < n; i++) {
+                        pwl[i] = bench_rand();
+                }
+                if (!blob_add_snippet(blob, s, pwl, n)) {
+                        goto retry;
+                }
+        }
+
+        for (unsigned s = 0; s < n_sequences; s++) {
+                /* Empty sequences are allowed, they complete immediately */
+                n = bench_rand() % 6;
+                for (i = 0; i < n; i++) {
+                        frames[i].snippet_id = bench_rand() % (n_snippets + 1);
+                        frames[i].timebase = bench_rand() % 4;
+                        frames[i].gain = bench_rand() % 4;
+                        frames[i].loop_count = bench_rand() % 8 ? bench_rand() % 4 : 15;
+                        frames[i].frequency = bench_rand() % 2 ? bench_rand() % 512 : 0;
+                }
+                if (!blob_add_sequence(blob, s, frames, n)) {
+                        goto retry;
+                }
+        }
+}
+
+/* Flip COMMAND_TYPE of a few sequence bytes, some frames become undecodable */
+static void corrupt(blob_t *blob)
+{
+        unsigned n = 1 + bench_rand() % 3;
+
+        if (blob->size == blob->seq_start) {
+                return;
+        }
+        while (n--) {
+                blob->data[blob->seq_start + bench_rand() % (blob->size - blob->seq_start)] ^= 0x80;
+        }
+}
+
+static void mismatch(const blob_t *blob, unsigned sequence_id, uint32_t t, const char *what,
+                     int got, int expected)
+{
+        printf("  mismatch in sequence %u at %u ticks: %s %d, expected %d\n  blob:", sequence_id,
+               t, what, got, expected);
+        for (unsigned i = 0; i < blob->size; i++) {
+                printf(" %02x", blob->data[i]);
+        }
+        printf("\n");
+        fflush(stdout);
+        ASSERT_WARNING(0);
+}
+
+/*
+ * Play one sequence with both decoders. Steps are random around one timebase with update(),
+ * fixed with render(), so both segment crossings and several segments per step are exercised.
+ */
+static void check_sequence(blob_t *blob, unsigned sequence_id, bool render, check_stats_t *stats)
+{
+        uint32_t t = bench_rand();
+        unsigned state, ref_state, steps = 0;
+        uint32_t step;
+
+        ref_state = wm_ref_decoder_trigger_sequence(&ref, t, sequence_id);
+        state = wm_decoder_trigger_sequence(&decoder, t, sequence_id);
+        if (state != ref_state) {
+                mismatch(blob, sequence_id, 0, "trigger state", state, ref_state);
+        }
+
+        while (ref_state == 0 && steps < MAX_STEPS) {
+                if (render) {
+                        step = RENDER_STEP;
+                        state = wm_decoder_render(&decoder, t + step, step, amplitude, frequency,
+                                                  RENDER_BLOCK);
+                        for (unsigned i = 0; i < RENDER_BLOCK; i++) {
+                                t += step;
+                                /* A decode error is reported once, render() keeps it */
+                                if (ref_state != 2) {
+                                        ref_state = wm_ref_decoder_update(&ref, t);
+                                } else {
+                                        wm_ref_decoder_update(&ref, t);
+                                }
+                                if (amplitude[i] != ref.amplitude) {
+                                        mismatch(blob, sequence_id, t - ref.start_time,
+                                                 "amplitude", amplitude[i], ref.amplitude);
+                                }
+                                if (frequency[i] != ref.frequency) {
+                                        mismatch(blob, sequence_id, t - ref.start_time,
+                                                 "frequency", frequency[i], ref.frequency);
+                                }
+                        }
+                        steps += RENDER_BLOCK;
+                } else {
+                        t += bench_rand() % (2 << TIMER_DIV_SHIFT);
+                        ref_state = wm_ref_decoder_update(&ref, t);
+                        state = wm_decoder_update(&decoder, t);
+                        if (decoder.amplitude != ref.amplitude) {
+                                mismatch(blob, sequence_id, t - ref.start_time, "amplitude",
+                                         decoder.amplitude, ref.amplitude);
+                        }
+                        if (decoder.frequency != ref.frequency) {
+                                mismatch(blob, sequence_id, t - ref.start_time, "frequency",
+                                         decoder.frequency, ref.frequency);
+                        }
+                        steps++;
+                }
+                if (state != ref_state) {
+                        mismatch(blob, sequence_id, t - ref.start_time, "state", state, ref_state);
+                }
+        }
+
+        stats->errors += ref_state == 2;
+        stats->steps += steps;
+        stats->sequences++;
+}
+
+static void check_blob(blob_t *blob, check_stats_t *stats)
+{
+        for (unsigned config = 0; config < 4; config++) {
+                wm_ref_decoder_init(&ref, blob->data, config & 1, config >> 1);
+                wm_decoder_init(&decoder, blob->data, config & 1, config >> 1);
+
+                for (unsigned s = 0; s < blob->n_sequences; s++) {
+                        check_sequence(blob, s, false, stats);
+                        check_sequence(blob, s, true, stats);
+                }
+        }
+        stats->blobs++;
+}
+
+static bool load_blob(blob_t *blob, const char *path)
+{
+        FILE *f = fopen(path, "rb");
+
+        if (!f) {
+                printf("  cannot open %s\n", path);
+                return false;
+        }
+        memset(blob, 0, sizeof(*blob));
+        blob->size = fread(blob->data, 1, sizeof(blob->data), f);
+        fclose(f);
+        if (blob->size < 2) {
+                return false;
+        }
+        blob->n_snippets = blob->data[0];
+        blob->n_sequences = MIN(blob->data[1], WM_MAX_SEQUENCES);
+
+        return true;
+}
+
+/* Play all sequences of a blob, return number of ms played */
+static uint32_t play_ref(const blob_t *blob)
+{
+        uint32_t t, ms = 0;
+
+        for (unsigned s = 0; s < blob->n_sequences; s++) {
+                t = 0;
+                wm_ref_decoder_trigger_sequence(&ref, t, s);
+                do {
+                        t += RENDER_STEP;
+                } while (wm_ref_decoder_update(&ref, t) == 0);
+                ms += t / TICKS_PER_MS;
+        }
+
+        return ms;
+}
+
+static uint32_t play_update(const blob_t *blob)
+{
+        uint32_t t, ms = 0;
+
+        for (unsigned s = 0; s < blob->n_sequences; s++) {
+                t = 0;
+                wm_decoder_trigger_sequence(&decoder, t, s);
+                do {
+                        t += RENDER_STEP;
+                } while (wm_decoder_update(&decoder, t) == 0);
+                ms += t / TICKS_PER_MS;
+        }
+
+        return ms;
+}
+
+static uint32_t play_render(const blob_t *blob)
+{
+        uint32_t t, ms = 0;
+
+        for (unsigned s = 0; s < blob->n_sequences; s++) {
+                t = 0;
+                wm_decoder_trigger_sequence(&decoder, t, s);
+                do {
+                        t += RENDER_STEP * RENDER_BLOCK;
+                } while (wm_decoder_render(&decoder, t - RENDER_STEP * (RENDER_BLOCK - 1),
+                                           RENDER_STEP, amplitude, frequency, RENDER_BLOCK) == 0);
+                ms += t / TICKS_PER_MS;
+        }
+
+        return ms;
+}
+
+static void measure(const char *name, const blob_t *blob, uint32_t (*play)(const blob_t *blob),
+                    uint32_t scale)
+{
+        uint64_t t0, c0, ns, cycles;
+        uint32_t ms = 0;
+
+        t0 = bench_now_ns();
+        c0 = bench_now_cycles();
+        for (uint32_t i = 0; i < 100 * scale; i++) {
+                ms += play(blob);
+        }
+        cycles = bench_now_cycles() - c0;
+        ns = bench_now_ns() - t0;
+
+        bench_report(name, ms, ns, "%.1f cycles/ms", ms ? (double)cycles / ms : 0.0);
+}
+
+void bench_haptics(uint32_t scale)
+{
+        static blob_t blob;
+        check_stats_t stats = { 0 };
+        const char *path = getenv("HOST_BENCH_WM_BLOB");
+
+        build_example(&blob);
+        check_blob(&blob, &stats);
+        for (unsigned i = 0; i < RANDOM_BLOBS * scale; i++) {
+                build_random(&blob, false);
+                check_blob(&blob, &stats);
+                build_random(&blob, true);
+                corrupt(&blob);
+                check_blob(&blob, &stats);
+        }
+        if (path && load_blob(&blob, path)) {
+                check_blob(&blob, &stats);
+        }
+        printf("  check: %u blobs, %u sequences, %u steps identical, %u decode errors\n",
+               stats.blobs, stats.sequences, stats.steps, stats.errors);
+
+        if (!path || !load_blob(&blob, path)) {
+                build_example(&blob);
+        }
+        wm_ref_decoder_init(&ref, blob.data, 0, 1);
+        wm_decoder_init(&decoder, blob.data, 0, 1);
+
+        measure("wm update, parse (reference)", &blob, play_ref, scale);
+        measure("wm update, tables", &blob, play_update, scale);
+        measure("wm render, tables", &blob, play_render, scale);
+}
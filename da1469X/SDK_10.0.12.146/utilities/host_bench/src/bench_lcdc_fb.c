@@ -0,0 +1,242 @@
+/**
+ ****************************************************************************************
+ *
+ * @file bench_lcdc_fb.c
+ *
+ * @brief LCD frame buffer manager benchmark
+ *
+ * Replays screen update traces through the frame buffer manager (ad_lcdc_fb.h) on the simulated
+ * LCD of stubs/lcdc_sim.c, with single and double buffering, and reports the pixels and bytes
+ * sent to the LCD per frame compared to full frame updates. After every update the LCD memory
+ * and, with double buffering, the buffer drawn next must match a reference image.
+ *
+ * Copyright (C) 2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ ****************************************************************************************
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <sys/mman.h>
+#include <sdk_defs.h>
+#include <ad_lcdc_fb.h>
+#include "lcdc_sim.h"
+#include "bench.h"
+
+#define FRAMES                  600
+#define MAX_TRACE_RECTS         16
+#define SPI_HZ                  48000000        /* single lane MIPI DBI type C */
+
+typedef struct {
+        const char *name;
+        uint16_t resx, resy;
+        HW_LCDC_LAYER_COLOR_MODE format;
+        bool full_lines;
+        /* Returns the rectangles drawn in frame n */
+        uint8_t (*frame)(uint32_t n, uint16_t resx, uint16_t resy, hw_lcdc_frame_t *rects);
+} trace_t;
+
+static hw_lcdc_frame_t rect(uint16_t x, uint16_t y, uint16_t w, uint16_t h)
+{
+        hw_lcdc_frame_t r = { .startx = x, .starty = y, .endx = x + w - 1, .endy = y + h - 1 };
+
+        return r;
+}
+
+/* Digital watch face: seconds, minutes, a second marker on the rim, heart rate and steps */
+static uint8_t trace_watch(uint32_t n, uint16_t resx, uint16_t resy, hw_lcdc_frame_t *rects)
+{
+        const double r = resx / 2 - 12;
+        double a0 = 2 * M_PI * ((n + 59) % 60) / 60, a1 = 2 * M_PI * (n % 60) / 60;
+        uint8_t cnt = 0;
+
+        rects[cnt++] = rect(resx / 2 + 60, resy / 2 - 28, 36, 56);
+        if (n % 10 == 0) {
+                rects[cnt++] = rect(resx / 2 + 20, resy / 2 - 28, 36, 56);
+        }
+        if (n % 60 == 0) {
+                rects[cnt++] = rect(resx / 2 - 56, resy / 2 - 28, 36, 56);
+        }
+        if (n % 600 == 0) {
+                rects[cnt++] = rect(resx / 2 - 96, resy / 2 - 28, 36, 56);
+        }
+        /* Erase the previous marker, draw the new one */
+        rects[cnt++] = rect(resx / 2 + r * sin(a0) - 6, resy / 2 - r * cos(a0) - 6, 12, 12);
+        rects[cnt++] = rect(resx / 2 + r * sin(a1) - 6, resy / 2 - r * cos(a1) - 6, 12, 12);
+        if (n % 5 == 0) {
+                rects[cnt++] = rect(resx / 2 - 30, resy - 90, 60, 28);
+        }
+        if (n % 30 == 0) {
+                rects[cnt++] = rect(resx / 2 - 45, 60, 90, 40);
+        }
+
+        return cnt;
+}
+
+/* Watch face with a notification banner sliding in every minute */
+static uint8_t trace_notify(uint32_t n, uint16_t resx, uint16_t resy, hw_lcdc_frame_t *rects)
+{
+        uint8_t cnt = trace_watch(n, resx, resy, rects);
+        const uint32_t step = n % 60;
+
+        if (step < 8) {
+                rects[cnt++] = rect(0, 0, resx, (step + 1) * 15);
+        } else if (step == 20) {
+                rects[cnt++] = rect(0, 0, resx, 8 * 15);
+        }
+
+        return cnt;
+}
+
+/* 1 to 12 random rectangles of up to 80 x 80 pixels */
+static uint8_t trace_random(uint32_t n, uint16_t resx, uint16_t resy, hw_lcdc_frame_t *rects)
+{
+        const uint8_t cnt = 1 + bench_rand() % 12;
+
+        for (uint8_t i = 0; i < cnt; i++) {
+                const uint16_t w = 1 + bench_rand() % 80;
+                const uint16_t h = 1 + bench_rand() % 80;
+
+                rects[i] = rect(bench_rand() % (resx - w + 1), bench_rand() % (resy - h + 1), w, h);
+        }
+
+        return cnt;
+}
+
+/* Scrolling list, the whole screen changes */
+static uint8_t trace_scroll(uint32_t n, uint16_t resx, uint16_t resy, hw_lcdc_frame_t *rects)
+{
+        rects[0] = rect(0, 0, resx, resy);
+
+        return 1;
+}
+
+static const trace_t traces[] = {
+        { "watch",        390, 390, HW_LCDC_LCM_RGB565, false, trace_watch  },
+        { "notify",       390, 390, HW_LCDC_LCM_RGB565, false, trace_notify },
+        { "random",       390, 390, HW_LCDC_LCM_RGB565, false, trace_random },
+        { "scroll",       390, 390, HW_LCDC_LCM_RGB565, false, trace_scroll },
+        { "watch mip",    176, 176, HW_LCDC_LCM_L1,     true,  trace_watch  },
+        { "random mip",   176, 176, HW_LCDC_LCM_L1,     true,  trace_random },
+};
+
+/* Draw a pattern depending on the position and the frame, so that misplaced copies show */
+static void fill(uint8_t *buf, const trace_t *t, const hw_lcdc_frame_t *r, uint32_t color)
+{
+        const uint32_t stride = hw_lcdc_stride_size(t->format, t->resx);
+
+        for (uint16_t y = r->starty; y <= r->endy; y++) {
+                for (uint16_t x = r->startx; x <= r->endx; x++) {
+                        if (t->format == HW_LCDC_LCM_L1) {
+                                const uint8_t bit = 1 << (x % 8);
+
+                                if ((x ^ y ^ color) & 1) {
+                                        buf[y * stride + x / 8] |= bit;
+                                } else {
+                                        buf[y * stride + x / 8] &= ~bit;
+                                }
+                        } else {
+                                uint16_t *p = (uint16_t *)&buf[y * stride + x * 2];
+
+                                *p = color + x * 7 + y * 13;
+                        }
+                }
+        }
+}
+
+/*
+ * The layer addresses are 32 bits like on the target, so the buffers must be mapped in the
+ * lower 4 GB of the address space.
+ */
+static uint8_t *alloc_low(size_t size)
+{
+        void *p = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_32BIT,
+                       -1, 0);
+
+        ASSERT_WARNING(p != MAP_FAILED);
+
+        return p;
+}
+
+static void run(const trace_t *t, bool dbl, uint32_t frames)
+{
+        const size_t size = (size_t)hw_lcdc_stride_size(t->format, t->resx) * t->resy;
+        const uint32_t full_bytes = size + LCDC_SIM_REGION_CMD_BYTES;
+        uint8_t *fb0 = alloc_low(size), *fb1 = alloc_low(size), *ref = alloc_low(size);
+        hw_lcdc_frame_t rects[MAX_TRACE_RECTS];
+        ad_lcdc_handle_t lcd = lcdc_sim_open(t->resx, t->resy, t->format);
+        const lcdc_sim_stats_t *stats = lcdc_sim_stats(lcd);
+        ad_lcdc_fb_config_t cfg = {
+                .layer = {
+                        .baseaddr = (uint32_t)(uintptr_t)fb0,
+                        .resx = t->resx,
+                        .resy = t->resy,
+                        .format = t->format,
+                },
+                .back_baseaddr = dbl ? (uint32_t)(uintptr_t)fb1 : 0,
+                .full_lines = t->full_lines,
+        };
+        ad_lcdc_fb_t fb;
+        uint64_t t0, ns = 0;
+        char name[40];
+
+        ad_lcdc_fb_init(&fb, lcd, &cfg);
+        ad_lcdc_fb_flush(&fb, OS_EVENT_FOREVER);
+
+        for (uint32_t n = 0; n < frames; n++) {
+                const uint8_t cnt = t->frame(n, t->resx, t->resy, rects);
+
+                /* The watch face is laid out for the big display, clip it to the small one */
+                for (uint8_t i = 0; i < cnt; i++) {
+                        rects[i].endx = MIN(rects[i].endx, t->resx - 1);
+                        rects[i].endy = MIN(rects[i].endy, t->resy - 1);
+                }
+
+                t0 = bench_now_ns();
+                for (uint8_t i = 0; i < cnt; i++) {
+                        fill(ad_lcdc_fb_get_buffer(&fb), t, &rects[i], n * 31 + i);
+                        ad_lcdc_fb_invalidate(&fb, &rects[i]);
+                }
+                ad_lcdc_fb_flush_async(&fb, NULL, NULL);
+                ns += bench_now_ns() - t0;
+
+                for (uint8_t i = 0; i < cnt; i++) {
+                        fill(ref, t, &rects[i], n * 31 + i);
+                }
+
+                ad_lcdc_fb_wait(&fb, OS_EVENT_FOREVER);
+                if (memcmp(lcdc_sim_memory(lcd), ref, size) ||
+                    memcmp(ad_lcdc_fb_get_buffer(&fb), ref, size)) {
+                        printf("%s: frame %u differs from the reference\n", t->name, n);
+                        fflush(stdout);
+                        ASSERT_WARNING(0);
+                }
+        }
+
+        /* Statistics of the traced frames only, not of the initial full frame */
+        snprintf(name, sizeof(name), "lcdc_fb %s %s", t->name, dbl ? "double" : "single");
+        bench_report(name, frames, ns, "%.0f px/frame (%.1f%% of full)  %.2f regions/frame  "
+                     "%.2f ms/frame at %u MHz (full %.2f ms)",
+                     (double)(stats->pixels - (uint64_t)t->resx * t->resy) / frames,
+                     100.0 * (stats->bytes - full_bytes) / frames / full_bytes,
+                     (double)(stats->regions - 1) / frames,
+                     (stats->bytes - full_bytes) * 8000.0 / frames / SPI_HZ, SPI_HZ / 1000000,
+                     full_bytes * 8000.0 / SPI_HZ);
+
+        ad_lcdc_fb_deinit(&fb);
+        lcdc_sim_close(lcd);
+        munmap(fb0, size);
+        munmap(fb1, size);
+        munmap(ref, size);
+}
+
+void bench_lcdc_fb(uint32_t scale)
+{
+        for (size_t i = 0; i < ARRAY_LENGTH(traces); i++) {
+                run(&traces[i], false, FRAMES * scale);
+                run(&traces[i], true, FRAMES * scale);
+        }
+}
@@ -0,0 +1,53 @@
+/**
+ ****************************************************************************************
+ *
+ * @file bench_logging.c
+ *
+ * @brief Logging benchmark (standalone mode over the pty UART)
+ *
+ * Copyright (C) 2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ ****************************************************************************************
+ */
+
+#include <stdio.h>
+#include <osal.h>
+#include <logging.h>
+#include "bench.h"
+
+#define MESSAGES                2000
+
+static void run(const char *name, uint32_t count, bool paced)
+{
+        uint32_t drained;
+        uint64_t start;
+        uint64_t call_ns = 0;
+        uint64_t t;
+        uint32_t i;
+
+        drained = bench_wait_uart_idle(LOGGING_STANDALONE_UART);
+
+        start = bench_now_ns();
+        for (i = 0; i < count; i++) {
+                t = bench_now_ns();
+                log_printf(LOG_NOTICE, 1, "message %u value %08x\n", (unsigned) i,
+                                                                (unsigned) bench_rand());
+                call_ns += bench_now_ns() - t;
+                if (paced) {
+                        /* Let the logging task run, no messages get dropped */
+                        OS_TASK_YIELD();
+                }
+        }
+        drained = bench_wait_uart_idle(LOGGING_STANDALONE_UART) - drained;
+
+        bench_report(name, count, call_ns, "%u bytes out in %.1f ms", (unsigned) drained,
+                                                        (bench_now_ns() - start) / 1e6);
+}
+
+void bench_logging(uint32_t scale)
+{
+        run("log_printf burst", MESSAGES * scale, false);
+        run("log_printf paced", MESSAGES * scale, true);
+}
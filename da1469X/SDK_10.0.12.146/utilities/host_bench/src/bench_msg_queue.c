@@ -0,0 +1,105 @@
+/**
+ ****************************************************************************************
+ *
+ * @file bench_msg_queue.c
+ *
+ * @brief Message queue benchmark
+ *
+ * Copyright (C) 2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ ****************************************************************************************
+ */
+
+#include <stdio.h>
+#include <osal.h>
+#include <msg_queues.h>
+#include "bench.h"
+
+#define QUEUE_LENGTH            8
+#define MESSAGES                20000
+#define MAX_PAYLOAD             256
+
+static msg_queue queue;
+static OS_EVENT consumer_done;
+static volatile uint32_t consumed;
+
+static void consumer_task(void *param)
+{
+        uint32_t count = (uint32_t) (uintptr_t) param;
+        msg m;
+
+        while (consumed < count) {
+                msg_queue_get(&queue, &m, OS_QUEUE_FOREVER);
+                msg_release(&m);
+                consumed++;
+        }
+
+        OS_EVENT_SIGNAL(consumer_done);
+        OS_TASK_DELETE(NULL);
+}
+
+/* Send and receive from the same task, no context switch involved */
+static void run_loopback(uint32_t count, MSG_SIZE size)
+{
+        static uint8_t payload[MAX_PAYLOAD];
+        char name[40];
+        uint64_t start;
+        uint32_t i;
+        msg m;
+
+        start = bench_now_ns();
+        for (i = 0; i < count; i++) {
+                msg_queue_send(&queue, 1, 0, payload, size, OS_QUEUE_FOREVER);
+                msg_queue_get(&queue, &m, OS_QUEUE_FOREVER);
+                msg_release(&m);
+        }
+
+        snprintf(name, sizeof(name), "send+get %u bytes", (unsigned) size);
+        bench_report(name, count, bench_now_ns() - start, NULL);
+}
+
+/* Producer and consumer in different tasks */
+static void run_task_to_task(uint32_t count, MSG_SIZE size)
+{
+        static uint8_t payload[MAX_PAYLOAD];
+        char name[40];
+        OS_TASK consumer;
+        uint64_t start;
+        uint32_t i;
+
+        consumed = 0;
+        OS_TASK_CREATE("consumer", consumer_task, (void *) (uintptr_t) count, 1024,
+                                                        OS_TASK_PRIORITY_NORMAL, consumer);
+        OS_ASSERT(consumer);
+
+        start = bench_now_ns();
+        for (i = 0; i < count; i++) {
+                msg_queue_send(&queue, 1, 0, payload, size, OS_QUEUE_FOREVER);
+        }
+        OS_EVENT_WAIT(consumer_done, OS_EVENT_FOREVER);
+
+        snprintf(name, sizeof(name), "task to task %u bytes", (unsigned) size);
+        bench_report(name, count, bench_now_ns() - start, NULL);
+}
+
+void bench_msg_queue(uint32_t scale)
+{
+        static const MSG_SIZE sizes[] = { 16, 64, 200 };
+        uint32_t count = MESSAGES * scale;
+        size_t i;
+
+        msg_queue_create(&queue, QUEUE_LENGTH, DEFAULT_OS_ALLOCATOR);
+        OS_EVENT_CREATE(consumer_done);
+
+        for (i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+                run_loopback(count, sizes[i]);
+        }
+        for (i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+                run_task_to_task(count, sizes[i]);
+        }
+
+        OS_EVENT_DELETE(consumer_done);
+        msg_queue_delete(&queue);
+}
@@ -0,0 +1,117 @@
+/**
+ ****************************************************************************************
+ *
+ * @file bench_nvms.c
+ *
+ * @brief NVMS benchmark, direct and VES partitions on the RAM backed flash
+ *
+ * Copyright (C) 2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ ****************************************************************************************
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <osal.h>
+#include <ad_nvms.h>
+#include "ad_flash_ram.h"
+#include "bench.h"
+
+#define DIRECT_CHUNK            256
+#define VES_RECORD_SIZE         32
+#define VES_AREA_SIZE           (8 * 1024)
+#define VES_WRITES              5000
+
+static void report_flash(const char *name, uint32_t ops, uint64_t ns)
+{
+        ad_flash_ram_stats_t stats;
+
+        ad_flash_ram_get_stats(&stats);
+        bench_report(name, ops, ns, "%u page programs, %u sector erases",
+                                (unsigned) stats.page_programs, (unsigned) stats.sector_erases);
+}
+
+static void bench_direct(nvms_t part, uint32_t scale)
+{
+        static uint8_t buf[DIRECT_CHUNK];
+        size_t size = ad_nvms_get_size(part);
+        uint32_t count = size / DIRECT_CHUNK;
+        uint64_t start;
+        uint32_t i;
+
+        for (i = 0; i < sizeof(buf); i++) {
+                buf[i] = bench_rand();
+        }
+
+        /* Sequential fill of erased flash, no erase needed */
+        ad_nvms_erase_region(part, 0, size);
+        ad_flash_ram_reset_stats();
+        start = bench_now_ns();
+        for (i = 0; i < count; i++) {
+                ad_nvms_write(part, i * DIRECT_CHUNK, buf, sizeof(buf));
+        }
+        report_flash("direct write 256B seq", count, bench_now_ns() - start);
+
+        /* Random rewrites, every write needs read-modify-erase-write of the sector */
+        count = 100 * scale;
+        ad_flash_ram_reset_stats();
+        start = bench_now_ns();
+        for (i = 0; i < count; i++) {
+                buf[0] = i;
+                ad_nvms_write(part, (bench_rand() % (size / DIRECT_CHUNK)) * DIRECT_CHUNK, buf,
+                                                                                sizeof(buf));
+        }
+        report_flash("direct rewrite 256B rnd", count, bench_now_ns() - start);
+
+        count = size / DIRECT_CHUNK;
+        ad_flash_ram_reset_stats();
+        start = bench_now_ns();
+        for (i = 0; i < count; i++) {
+                ad_nvms_read(part, i * DIRECT_CHUNK, buf, sizeof(buf));
+        }
+        report_flash("direct read 256B seq", count, bench_now_ns() - start);
+}
+
+static void bench_ves(nvms_t part, uint32_t scale)
+{
+        uint8_t record[VES_RECORD_SIZE];
+        uint32_t count = VES_WRITES * scale;
+        uint64_t start;
+        uint32_t i;
+
+        memset(record, 0, sizeof(record));
+
+        /* Small random updates in a settings-like area, the typical VES use case */
+        ad_flash_ram_reset_stats();
+        start = bench_now_ns();
+        for (i = 0; i < count; i++) {
+                record[0] = i;
+                ad_nvms_write(part, (bench_rand() % (VES_AREA_SIZE / VES_RECORD_SIZE)) *
+                                                VES_RECORD_SIZE, record, sizeof(record));
+        }
+        ad_nvms_flush(part, true);
+        report_flash("ves write 32B rnd", count, bench_now_ns() - start);
+
+        ad_flash_ram_reset_stats();
+        start = bench_now_ns();
+        for (i = 0; i < count; i++) {
+                ad_nvms_read(part, (bench_rand() % (VES_AREA_SIZE / VES_RECORD_SIZE)) *
+                                                VES_RECORD_SIZE, record, sizeof(record));
+        }
+        report_flash("ves read 32B rnd", count, bench_now_ns() - start);
+}
+
+void bench_nvms(uint32_t scale)
+{
+        nvms_t part;
+
+        part = ad_nvms_open(NVMS_LOG_PART);
+        OS_ASSERT(part);
+        bench_direct(part, scale);
+
+        part = ad_nvms_open(NVMS_GENERIC_PART);
+        OS_ASSERT(part);
+        bench_ves(part, scale);
+}
@@ -0,0 +1,202 @@
+/**
+ ****************************************************************************************
+ *
+ * @file bench_ringbuf.c
+ *
+ * @brief Message ring buffer benchmark (sdk_ringbuf.h)
+ *
+ * sdk_ringbuf.o is built with HOST_BENCH_DMB_HOOK, so the consumer can run at every barrier
+ * of the producer, i.e. in the middle of ringbuf_msg_commit(), as the logging task does when
+ * it preempts a task in log_put(). Messages of random length wrap around the end of storage,
+ * and the consumer checks that it never sees a message before its commit returned, that every
+ * message has its length and data, and that the read index never passes the write index.
+ *
+ * Copyright (C) 2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ ****************************************************************************************
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <sdk_defs.h>
+#include <sdk_ringbuf.h>
+#include "bench.h"
+
+#define MESSAGES                20000
+#define RING_SIZE               256
+#define MSG_MAX_LEN             61
+
+void (*host_bench_dmb_hook)(void);
+
+static uint32_t storage[RING_SIZE / sizeof(uint32_t)];
+static ringbuf_t rb;
+
+static struct {
+        uint8_t lens[256];      /* Lengths of the messages in the ring, by number */
+        uint32_t committed;     /* Messages whose ringbuf_msg_commit() returned */
+        uint32_t consumed;
+        bool in_commit;
+        bool in_consumer;
+        bool wrap;              /* Commit in progress wraps around the end of storage */
+        uint32_t wraps;
+        uint32_t mid_commit;    /* Consumer runs in a wrapping commit */
+} st;
+
+static void fail(const char *what, uint32_t got, uint32_t expected)
+{
+        printf("ringbuf: %s at message %u: %u, expected %u\n", what, (unsigned)st.consumed,
+               (unsigned)got, (unsigned)expected);
+        fflush(stdout);
+        ASSERT_WARNING(0);
+}
+
+static uint8_t msg_byte(uint32_t n, uint32_t i)
+{
+        return (uint8_t)(n * 13 + i);
+}
+
+static void consume_all(void)
+{
+        uint8_t *msg;
+        uint32_t len;
+        uint32_t i;
+
+        st.in_consumer = true;
+
+        while ((msg = ringbuf_msg_peek(&rb, &len)) != NULL) {
+                if (st.consumed >= st.committed) {
+                        fail("message visible before its commit returned", st.consumed,
+                             st.committed);
+                }
+                if (len != st.lens[st.consumed & 0xff]) {
+                        fail("length", len, st.lens[st.consumed & 0xff]);
+                }
+                for (i = 0; i < len; i++) {
+                        if (msg[i] != msg_byte(st.consumed, i)) {
+                                fail("data", msg[i], msg_byte(st.consumed, i));
+                        }
+                }
+
+                ringbuf_msg_consume(&rb);
+                st.consumed++;
+
+                if (ringbuf_used(&rb) > RING_SIZE) {
+                        fail("read index past write index", ringbuf_used(&rb), RING_SIZE);
+                }
+                if (st.in_commit && st.wrap) {
+                        st.mid_commit++;
+                }
+        }
+
+        st.in_consumer = false;
+}
+
+/* The consumer preempts the producer at a barrier, not every time so that the ring fills */
+static void dmb_hook(void)
+{
+        if (st.in_consumer || (bench_rand() & 1)) {
+                return;
+        }
+
+        consume_all();
+}
+
+static void *reserve(uint32_t len)
+{
+        void *msg = ringbuf_msg_reserve(&rb, len);
+
+        if (msg == NULL) {
+                consume_all();
+                msg = ringbuf_msg_reserve(&rb, len);
+                ASSERT_WARNING(msg != NULL);
+        }
+
+        return msg;
+}
+
+static void produce(uint32_t n)
+{
+        uint32_t len = bench_rand() % (MSG_MAX_LEN + 1);
+        uint32_t offset = rb.wr >= RING_SIZE ? rb.wr - RING_SIZE : rb.wr;
+        uint8_t *msg = reserve(len);
+        uint32_t i;
+
+        for (i = 0; i < len; i++) {
+                msg[i] = msg_byte(n, i);
+        }
+        st.lens[n & 0xff] = len;
+
+        st.wrap = (msg == (uint8_t *)storage + sizeof(uint32_t)) && (offset != 0);
+        st.wraps += st.wrap;
+
+        st.in_commit = true;
+        ringbuf_msg_commit(&rb, msg, len);
+        st.in_commit = false;
+        st.committed++;
+}
+
+static void check(uint32_t count)
+{
+        uint64_t start = bench_now_ns();
+        uint32_t n;
+
+        memset(&st, 0, sizeof(st));
+        ringbuf_init(&rb, storage, RING_SIZE);
+
+        host_bench_dmb_hook = dmb_hook;
+        for (n = 0; n < count; n++) {
+                produce(n);
+        }
+        consume_all();
+        host_bench_dmb_hook = NULL;
+
+        if (st.consumed != count) {
+                fail("messages consumed", st.consumed, count);
+        }
+
+        bench_report("ringbuf msg interleaved", count, bench_now_ns() - start,
+                     "%u wrapped commits, %u messages consumed in a wrapping commit",
+                     (unsigned)st.wraps, (unsigned)st.mid_commit);
+}
+
+/* Producer fills the ring, then the consumer empties it */
+static void run(uint32_t count)
+{
+        volatile uint32_t sink = 0;
+        uint64_t start;
+        uint32_t n = 0;
+        uint8_t *msg;
+        uint32_t len;
+
+        ringbuf_init(&rb, storage, RING_SIZE);
+
+        start = bench_now_ns();
+        while (n < count) {
+                len = bench_rand() % (MSG_MAX_LEN + 1);
+                msg = ringbuf_msg_reserve(&rb, len);
+
+                if (msg == NULL) {
+                        while ((msg = ringbuf_msg_peek(&rb, &len)) != NULL) {
+                                sink += len ? msg[0] : 0;
+                                ringbuf_msg_consume(&rb);
+                        }
+                        continue;
+                }
+
+                memset(msg, (uint8_t)n, len);
+                ringbuf_msg_commit(&rb, msg, len);
+                n++;
+        }
+        (void)sink;
+
+        bench_report("ringbuf msg burst", count, bench_now_ns() - start,
+                     "reserve, commit, peek and consume");
+}
+
+void bench_ringbuf(uint32_t scale)
+{
+        check(MESSAGES * scale);
+        run(MESSAGES * 10 * scale);
+}
@@ -0,0 +1,361 @@
+/**
+ ****************************************************************************************
+ *
+ * @file bench_snc_queues.c
+ *
+ * @brief SNC queue in-place access benchmark (snc_queues.c, CM33 side)
+ *
+ * snc_queues.c is built as is; its SeNIS uCode builders are dropped by the linker. Two queues
+ * with the same configuration receive the same chunks, written with snc_queues_cm33_push() in
+ * the layout of the SNC (one element per word, preamble with the write bit). Queue A is read
+ * with snc_queues_cm33_peek() and released with snc_queues_cm33_consume(), queue B with
+ * snc_queues_cm33_pop(). Reads and writes are interleaved so that the chunks wrap around the
+ * end of queue memory.
+ *
+ * After every peek the spans must follow the layout of snc_queues_cm33_create(), and every
+ * chunk's data, size and timestamp must be those that popping B returns. After every partial
+ * or full consume the read pointer and the whole queue memory, preambles included, must be
+ * the same in A and B. Then shows the time per chunk of draining a full queue both ways.
+ *
+ * Copyright (C) 2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ ****************************************************************************************
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <sdk_defs.h>
+#include "snc_defs.h"
+#include "snc_queues.h"
+#include "bench.h"
+
+#define STEPS                   20000
+#define MAX_CHUNKS              32
+#define MAX_CHUNK_BYTES         64
+#define DRAIN_CHUNKS            32
+#define DRAIN_CHUNK_BYTES       12      /* 6-axis sample, 16-bit elements */
+#define DRAINS                  2000
+
+typedef struct {
+        const char *name;
+        snc_queue_config_t cfg;
+} q_config_t;
+
+/* Chunks of word elements are whole words, pop and push handle trailing bytes differently */
+static const q_config_t configs[] = {
+        { "byte ts",    { 10, 6, SNC_QUEUE_ELEMENT_SIZE_BYTE, true, false, false } },
+        { "hword",      { 13, 5, SNC_QUEUE_ELEMENT_SIZE_HWORD, false, false, false } },
+        { "hword ts",   { 4, 2, SNC_QUEUE_ELEMENT_SIZE_HWORD, true, false, false } },
+        { "word ts",    { 24, 8, SNC_QUEUE_ELEMENT_SIZE_WORD, true, false, false } },
+        { "word",       { 64, 3, SNC_QUEUE_ELEMENT_SIZE_WORD, false, false, false } },
+};
+
+static struct {
+        const q_config_t *qc;
+        snc_queue_t a;                  /* Peek and consume */
+        snc_queue_t b;                  /* Pop */
+        const uint32_t *base_a;
+        const uint32_t *base_b;
+        uint32_t chunk_words;
+        uint32_t hdr_words;
+        uint32_t rd;                    /* Index of the oldest chunk */
+        uint32_t count;                 /* Chunks in the queue */
+        uint32_t sizes[MAX_CHUNKS];     /* Pushed chunks, by index */
+        uint32_t timestamps[MAX_CHUNKS];
+        uint8_t data[MAX_CHUNKS][MAX_CHUNK_BYTES];
+        uint32_t step;
+        uint32_t wrapped_peeks;         /* Peeks with chunks in both spans */
+        uint32_t partial;               /* Consumes that leave peeked chunks in the queue */
+} st;
+
+static void fail(const char *what, uint32_t got, uint32_t expected)
+{
+        printf("snc_queues %s: %s at step %u: %u, expected %u\n", st.qc->name, what,
+               (unsigned)st.step, (unsigned)got, (unsigned)expected);
+        fflush(stdout);
+        ASSERT_WARNING(0);
+}
+
+static void check_eq(const char *what, uint32_t got, uint32_t expected)
+{
+        if (got != expected) {
+                fail(what, got, expected);
+        }
+}
+
+/* Chunk data in queue memory as snc_queues_cm33_pop() packs it, without byte swapping */
+static void pack(const uint32_t *elements, uint32_t size, uint8_t *out)
+{
+        uint32_t i;
+
+        for (i = 0; i < size; i++) {
+                switch (st.qc->cfg.element_weight) {
+                case SNC_QUEUE_ELEMENT_SIZE_BYTE:
+                        out[i] = (uint8_t)elements[i];
+                        break;
+                case SNC_QUEUE_ELEMENT_SIZE_HWORD:
+                        out[i] = ((const uint8_t *)&elements[i / 2])[i % 2];
+                        break;
+                default:
+                        out[i] = ((const uint8_t *)elements)[i];
+                        break;
+                }
+        }
+}
+
+static void push(void)
+{
+        const uint32_t max = st.qc->cfg.max_chunk_bytes;
+        uint32_t idx = (st.rd + st.count) % st.qc->cfg.num_of_chunks;
+        uint32_t size = bench_rand() % (max + 1);
+        uint32_t i;
+
+        if (st.count == st.qc->cfg.num_of_chunks) {
+                check_eq("push to full A", snc_queues_cm33_push(st.a, st.data[0], size, 0), false);
+                check_eq("push to full B", snc_queues_cm33_push(st.b, st.data[0], size, 0), false);
+                return;
+        }
+
+        if (st.qc->cfg.element_weight == SNC_QUEUE_ELEMENT_SIZE_WORD) {
+                size &= ~3;
+        }
+        for (i = 0; i < size; i++) {
+                st.data[idx][i] = (uint8_t)bench_rand();
+        }
+        st.sizes[idx] = size;
+        st.timestamps[idx] = bench_rand();
+
+        check_eq("push to A", snc_queues_cm33_push(st.a, st.data[idx], size, st.timestamps[idx]),
+                 true);
+        check_eq("push to B", snc_queues_cm33_push(st.b, st.data[idx], size, st.timestamps[idx]),
+                 true);
+        st.count++;
+}
+
+/* Offset of the read pointer from the start of queue memory, in chunks */
+static uint32_t read_chunk(snc_queue_t q, const uint32_t *base)
+{
+        snc_queue_peek_t peek;
+
+        snc_queues_cm33_peek(q, 0, &peek);
+        return (peek.span[0].first_chunk - base) / st.chunk_words;
+}
+
+static void check_state(void)
+{
+        const uint32_t words = st.chunk_words * st.qc->cfg.num_of_chunks;
+        uint32_t i;
+
+        check_eq("read chunk of A", read_chunk(st.a, st.base_a), st.rd);
+        check_eq("read chunk of B", read_chunk(st.b, st.base_b), st.rd);
+        check_eq("free chunks", snc_queues_cm33_get_free_chunks(st.a),
+                 snc_queues_cm33_get_free_chunks(st.b));
+        check_eq("empty", snc_queues_cm33_queue_is_empty(st.a),
+                 snc_queues_cm33_queue_is_empty(st.b));
+        check_eq("current chunk bytes", snc_queues_cm33_get_cur_chunk_bytes(st.a),
+                 snc_queues_cm33_get_cur_chunk_bytes(st.b));
+
+        for (i = 0; i < words; i++) {
+                check_eq(i % st.chunk_words ? "queue memory" : "preamble", st.base_a[i],
+                         st.base_b[i]);
+        }
+}
+
+static void check_peek(uint32_t max_chunks)
+{
+        const uint32_t num = st.qc->cfg.num_of_chunks;
+        uint32_t timestamps[MAX_CHUNKS + 1];
+        uint8_t peeked[MAX_CHUNK_BYTES];
+        uint8_t popped[MAX_CHUNK_BYTES];
+        snc_queue_peek_t peek;
+        const uint32_t *elements;
+        uint32_t n = MIN(max_chunks, st.count);
+        uint32_t max_ts = bench_rand() % (n + 2);
+        uint32_t size, pop_size, pop_ts;
+        uint32_t consume;
+        uint32_t i, idx;
+
+        check_eq("peeked chunks", snc_queues_cm33_peek(st.a, max_chunks, &peek), n);
+        check_eq("peek chunks", peek.num_of_chunks, n);
+        check_eq("chunk words", peek.chunk_words, st.chunk_words);
+        check_eq("header words", peek.hdr_words, st.hdr_words);
+        check_eq("span 0 first chunk", peek.span[0].first_chunk - st.base_a,
+                 st.rd * st.chunk_words);
+        check_eq("span 0 chunks", peek.span[0].num_of_chunks, MIN(n, num - st.rd));
+        check_eq("span 1 first chunk", peek.span[1].first_chunk - st.base_a, 0);
+        check_eq("span 1 chunks", peek.span[1].num_of_chunks, n - MIN(n, num - st.rd));
+        st.wrapped_peeks += peek.span[1].num_of_chunks != 0;
+
+        check_eq("timestamps", snc_queues_cm33_peek_timestamps(&peek, timestamps, max_ts),
+                 st.qc->cfg.enable_data_timestamp ? MIN(max_ts, n) : 0);
+
+        /* Queue B is popped up to the chunks consumed from A, then only its next chunk is read */
+        consume = (bench_rand() & 3) ? bench_rand() % (n + 1) : n;
+        st.partial += consume < n;
+
+        for (i = 0; i < n; i++) {
+                idx = (st.rd + i) % num;
+
+                elements = snc_queues_cm33_peek_chunk(&peek, i, &size);
+                check_eq("chunk size", size, st.sizes[idx]);
+                check_eq("chunk address", elements - st.base_a,
+                         (idx * st.chunk_words) + st.hdr_words);
+                pack(elements, size, peeked);
+
+                if (i > consume) {
+                        continue;
+                }
+                if (i == consume) {
+                        check_eq("B current chunk bytes", snc_queues_cm33_get_cur_chunk_bytes(st.b),
+                                 size);
+                        continue;
+                }
+
+                check_eq("pop from B", snc_queues_cm33_pop(st.b, popped, &pop_size, &pop_ts), true);
+                check_eq("popped size", pop_size, size);
+                if (memcmp(peeked, popped, size) || memcmp(peeked, st.data[idx], size)) {
+                        fail("chunk data", i, idx);
+                }
+                if (st.qc->cfg.enable_data_timestamp) {
+                        check_eq("popped timestamp", pop_ts, st.timestamps[idx]);
+                        if (i < max_ts) {
+                                check_eq("timestamp", timestamps[i], pop_ts);
+                        }
+                }
+        }
+
+        snc_queues_cm33_consume(st.a, consume);
+        st.rd = (st.rd + consume) % num;
+        st.count -= consume;
+
+        check_state();
+}
+
+static void check(const q_config_t *qc, uint32_t steps)
+{
+        const snc_queue_config_t *cfg = &qc->cfg;
+        snc_queue_peek_t peek;
+        uint32_t i, n;
+
+        memset(&st, 0, sizeof(st));
+        st.qc = qc;
+        st.a = snc_queues_cm33_create(cfg);
+        st.b = snc_queues_cm33_create(cfg);
+
+        /* Layout of snc_queues_cm33_create(), the read pointer is at the start of queue memory */
+        st.hdr_words = cfg->enable_data_timestamp ? 2 : 1;
+        st.chunk_words = st.hdr_words + ((cfg->max_chunk_bytes + 1) / cfg->element_weight) +
+                cfg->element_weight - 2;
+        snc_queues_cm33_peek(st.a, 0, &peek);
+        st.base_a = peek.span[0].first_chunk;
+        snc_queues_cm33_peek(st.b, 0, &peek);
+        st.base_b = peek.span[0].first_chunk;
+
+        /* Half-word elements leave bytes unwritten, start from the same memory contents */
+        memset((uint32_t *)st.base_a, 0, st.chunk_words * cfg->num_of_chunks * sizeof(uint32_t));
+        memset((uint32_t *)st.base_b, 0, st.chunk_words * cfg->num_of_chunks * sizeof(uint32_t));
+        check_state();
+
+        for (st.step = 0; st.step < steps; st.step++) {
+                n = bench_rand() % (cfg->num_of_chunks + 2);
+                for (i = 0; i < n; i++) {
+                        push();
+                }
+                check_peek(bench_rand() % (cfg->num_of_chunks + 2));
+        }
+
+        /* Empty both queues */
+        while (st.count) {
+                check_peek(st.count);
+        }
+        check_eq("B empty", snc_queues_cm33_queue_is_empty(st.b), true);
+
+        printf("  %-14s %u chunks x %u bytes: %u peeks across the end, %u partial consumes\n",
+               qc->name, (unsigned)cfg->num_of_chunks, (unsigned)cfg->max_chunk_bytes,
+               (unsigned)st.wrapped_peeks, (unsigned)st.partial);
+
+        snc_queues_cm33_destroy(st.a);
+        snc_queues_cm33_destroy(st.b);
+}
+
+static void fill(snc_queue_t q, const uint8_t *sample)
+{
+        uint32_t i;
+
+        for (i = 0; i < DRAIN_CHUNKS; i++) {
+                snc_queues_cm33_push(q, sample, DRAIN_CHUNK_BYTES, i);
+        }
+}
+
+/* The task woken up by the SNC drains a full queue of 16-bit samples and sums them up */
+static void drain(uint32_t count)
+{
+        static const snc_queue_config_t cfg = {
+                DRAIN_CHUNK_BYTES, DRAIN_CHUNKS, SNC_QUEUE_ELEMENT_SIZE_HWORD, true, false, false
+        };
+        uint32_t timestamps[DRAIN_CHUNKS];
+        uint8_t sample[DRAIN_CHUNK_BYTES];
+        int16_t buf[DRAIN_CHUNK_BYTES / 2];
+        snc_queue_peek_t peek;
+        const uint32_t *elements;
+        uint64_t ns_pop = 0, ns_peek = 0, start;
+        uint32_t size, ts, sum_pop, sum_peek;
+        uint32_t d, i, j, n;
+        snc_queue_t q;
+
+        for (i = 0; i < sizeof(sample); i++) {
+                sample[i] = (uint8_t)bench_rand();
+        }
+        q = snc_queues_cm33_create(&cfg);
+
+        for (d = 0; d < count; d++) {
+                fill(q, sample);
+                start = bench_now_ns();
+                sum_pop = 0;
+                while (snc_queues_cm33_pop(q, (uint8_t *)buf, &size, &ts)) {
+                        for (j = 0; j < size / 2; j++) {
+                                sum_pop += buf[j];
+                        }
+                        sum_pop += ts;
+                }
+                ns_pop += bench_now_ns() - start;
+
+                fill(q, sample);
+                start = bench_now_ns();
+                sum_peek = 0;
+                n = snc_queues_cm33_peek(q, DRAIN_CHUNKS, &peek);
+                snc_queues_cm33_peek_timestamps(&peek, timestamps, n);
+                for (i = 0; i < n; i++) {
+                        elements = snc_queues_cm33_peek_chunk(&peek, i, &size);
+                        for (j = 0; j < size / 2; j++) {
+                                sum_peek += (int16_t)elements[j];
+                        }
+                        sum_peek += timestamps[i];
+                }
+                snc_queues_cm33_consume(q, n);
+                ns_peek += bench_now_ns() - start;
+                check_eq("drained sum", sum_peek, sum_pop);
+        }
+        snc_queues_cm33_destroy(q);
+
+        bench_report("snc_queues pop", count * DRAIN_CHUNKS, ns_pop,
+                     "%u chunks x %u bytes, copy and pack", DRAIN_CHUNKS, DRAIN_CHUNK_BYTES);
+        bench_report("snc_queues peek", count * DRAIN_CHUNKS, ns_peek,
+                     "in place, one consume per drain");
+}
+
+void bench_snc_queues(uint32_t scale)
+{
+        uint64_t start = bench_now_ns();
+        uint32_t i;
+
+        for (i = 0; i < ARRAY_LENGTH(configs); i++) {
+                check(&configs[i], STEPS * scale);
+        }
+        bench_report("snc_queues check", ARRAY_LENGTH(configs) * STEPS * scale,
+                     bench_now_ns() - start, "peek, peek_chunk, peek_timestamps and consume "
+                     "match pop");
+        drain(DRAINS * scale);
+}
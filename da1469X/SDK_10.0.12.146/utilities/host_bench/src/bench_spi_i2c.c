@@ -0,0 +1,338 @@
+/**
+ ****************************************************************************************
+ *
+ * @file bench_spi_i2c.c
+ *
+ * @brief SPI and I2C adapter benchmark, one call per transfer versus transaction lists
+ *
+ * Reads a sensor FIFO and a block of status registers from the register file devices of
+ * stubs/bus_mock.h, first with one adapter call per transfer and then with a single transaction
+ * list. Both must produce the same bus trace and data.
+ *
+ * Copyright (C) 2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ ****************************************************************************************
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <osal.h>
+#include <ad_spi.h>
+#include <ad_i2c.h>
+#include "bus_mock.h"
+#include "bench.h"
+
+#define READS                   2000
+#define FIFO_REG                0x10
+#define FIFO_SIZE               32
+#define STATUS_REG              0x40
+#define STATUS_SIZE             4
+#define SPI_READ                0x80
+
+#define IO_PIN(_pin, _mode)     { HW_GPIO_PORT_0, (_pin), \
+                                  { (_mode), HW_GPIO_FUNC_GPIO, true }, \
+                                  { HW_GPIO_MODE_INPUT, HW_GPIO_FUNC_GPIO, true } }
+
+static const ad_io_conf_t spi_cs[] = {
+        IO_PIN(HW_GPIO_PIN_3, HW_GPIO_MODE_OUTPUT),
+};
+
+static const ad_spi_io_conf_t spi_io = {
+        .spi_do = IO_PIN(HW_GPIO_PIN_0, HW_GPIO_MODE_OUTPUT),
+        .spi_clk = IO_PIN(HW_GPIO_PIN_1, HW_GPIO_MODE_OUTPUT),
+        .spi_di = IO_PIN(HW_GPIO_PIN_2, HW_GPIO_MODE_INPUT),
+        .cs_cnt = 1,
+        .spi_cs = spi_cs,
+        .voltage_level = HW_GPIO_POWER_V33,
+};
+
+static const ad_spi_driver_conf_t spi_drv = {
+        .spi = {
+                .cs_pad = { HW_GPIO_PORT_0, HW_GPIO_PIN_3 },
+                .word_mode = HW_SPI_WORD_8BIT,
+                .smn_role = HW_SPI_MODE_MASTER,
+        },
+};
+
+static const ad_spi_controller_conf_t spi_conf = {
+        .id = HW_SPI1,
+        .io = &spi_io,
+        .drv = &spi_drv,
+};
+
+static const ad_i2c_io_conf_t i2c_io = {
+        .scl = IO_PIN(HW_GPIO_PIN_4, HW_GPIO_MODE_OUTPUT),
+        .sda = IO_PIN(HW_GPIO_PIN_5, HW_GPIO_MODE_OUTPUT),
+        .voltage_level = HW_GPIO_POWER_V33,
+};
+
+static const ad_i2c_driver_conf_t i2c_drv = {
+        .i2c = {
+                .speed = HW_I2C_SPEED_FAST,
+                .mode = HW_I2C_MODE_MASTER,
+                .addr_mode = HW_I2C_ADDRESSING_7B,
+                .address = 0x28,
+        },
+};
+
+static const ad_i2c_controller_conf_t i2c_conf = {
+        .id = HW_I2C1,
+        .io = &i2c_io,
+        .drv = &i2c_drv,
+};
+
+static const uint8_t spi_fifo_cmd = SPI_READ | FIFO_REG;
+static const uint8_t spi_status_cmd = SPI_READ | STATUS_REG;
+static const uint8_t i2c_fifo_reg = FIFO_REG;
+static const uint8_t i2c_status_reg = STATUS_REG;
+
+static uint8_t fifo[FIFO_SIZE];
+static uint8_t status[STATUS_SIZE];
+
+static const ad_spi_transaction_t spi_list[] = {
+        AD_SPI_CSA,
+        AD_SPI_SND(&spi_fifo_cmd, 1),
+        AD_SPI_RCV(fifo, FIFO_SIZE),
+        AD_SPI_CSD,
+        AD_SPI_CSA,
+        AD_SPI_SND(&spi_status_cmd, 1),
+        AD_SPI_RCV(status, STATUS_SIZE),
+        AD_SPI_CSD,
+};
+
+static const ad_i2c_transaction_t i2c_list[] = {
+        AD_I2C_SND(&i2c_fifo_reg, 1, HW_I2C_F_NONE),
+        AD_I2C_RCV(fifo, FIFO_SIZE, HW_I2C_F_ADD_RESTART | HW_I2C_F_ADD_STOP),
+        AD_I2C_SND(&i2c_status_reg, 1, HW_I2C_F_NONE),
+        AD_I2C_RCV(status, STATUS_SIZE, HW_I2C_F_ADD_RESTART | HW_I2C_F_ADD_STOP),
+};
+
+static OS_EVENT done;
+static int async_result;
+
+static void fill_regs(uint8_t *regs)
+{
+        int i;
+
+        for (i = 0; i < BUS_MOCK_REGS; i++) {
+                regs[i] = bench_rand();
+        }
+}
+
+static void check_data(const uint8_t *regs)
+{
+        OS_ASSERT(memcmp(fifo, regs + FIFO_REG, FIFO_SIZE) == 0);
+        OS_ASSERT(memcmp(status, regs + STATUS_REG, STATUS_SIZE) == 0);
+        memset(fifo, 0, sizeof(fifo));
+        memset(status, 0, sizeof(status));
+}
+
+static void spi_read_calls(ad_spi_handle_t spi)
+{
+        ad_spi_activate_cs(spi);
+        ad_spi_write(spi, &spi_fifo_cmd, 1);
+        ad_spi_read(spi, fifo, FIFO_SIZE);
+        ad_spi_deactivate_cs_when_spi_done(spi);
+        ad_spi_activate_cs(spi);
+        ad_spi_write(spi, &spi_status_cmd, 1);
+        ad_spi_read(spi, status, STATUS_SIZE);
+        ad_spi_deactivate_cs_when_spi_done(spi);
+}
+
+static void i2c_read_calls(ad_i2c_handle_t i2c)
+{
+        ad_i2c_write_read(i2c, &i2c_fifo_reg, 1, fifo, FIFO_SIZE, HW_I2C_F_ADD_STOP);
+        ad_i2c_write_read(i2c, &i2c_status_reg, 1, status, STATUS_SIZE, HW_I2C_F_ADD_STOP);
+}
+
+static void spi_done_cb(void *user_data, uint16_t transferred)
+{
+        async_result = transferred;
+        OS_EVENT_SIGNAL_FROM_ISR(done);
+}
+
+static void i2c_done_cb(void *user_data, HW_I2C_ABORT_SOURCE error)
+{
+        async_result = error;
+        OS_EVENT_SIGNAL_FROM_ISR(done);
+}
+
+/* Copy of the trace of the first method, the other methods must produce the same */
+static bus_mock_trace_t ref_trace[BUS_MOCK_TRACE_SIZE];
+static uint32_t ref_count;
+
+static void trace_save(void)
+{
+        const bus_mock_trace_t *trace;
+
+        ref_count = bus_mock_trace_get(&trace);
+        OS_ASSERT(ref_count > 0 && ref_count <= BUS_MOCK_TRACE_SIZE);
+        memcpy(ref_trace, trace, ref_count * sizeof(*trace));
+        bus_mock_trace_reset();
+}
+
+static void trace_check(void)
+{
+        const bus_mock_trace_t *trace;
+
+        OS_ASSERT(bus_mock_trace_get(&trace) == ref_count);
+        OS_ASSERT(memcmp(ref_trace, trace, ref_count * sizeof(*trace)) == 0);
+        bus_mock_trace_reset();
+}
+
+typedef enum {
+        METHOD_CALLS,
+        METHOD_LIST,
+        METHOD_LIST_ASYNC,
+} METHOD;
+
+static const char *method_names[] = { "calls", "list", "list async" };
+
+static void run_spi(ad_spi_handle_t spi, METHOD method)
+{
+        switch (method) {
+        case METHOD_CALLS:
+                spi_read_calls(spi);
+                break;
+        case METHOD_LIST:
+                OS_ASSERT(ad_spi_transact(spi, spi_list, ARRAY_LENGTH(spi_list)) == 0);
+                break;
+        case METHOD_LIST_ASYNC:
+                OS_ASSERT(ad_spi_transact_async(spi, spi_list, ARRAY_LENGTH(spi_list), spi_done_cb,
+                                                                                NULL) == 0);
+                OS_EVENT_WAIT(done, OS_EVENT_FOREVER);
+                OS_ASSERT(async_result == 2 * 1 + FIFO_SIZE + STATUS_SIZE);
+                break;
+        }
+}
+
+static void run_i2c(ad_i2c_handle_t i2c, METHOD method)
+{
+        switch (method) {
+        case METHOD_CALLS:
+                i2c_read_calls(i2c);
+                break;
+        case METHOD_LIST:
+                OS_ASSERT(ad_i2c_transact(i2c, i2c_list, ARRAY_LENGTH(i2c_list)) == 0);
+                break;
+        case METHOD_LIST_ASYNC:
+                OS_ASSERT(ad_i2c_transact_async(i2c, i2c_list, ARRAY_LENGTH(i2c_list), i2c_done_cb,
+                                                                                NULL) == 0);
+                OS_EVENT_WAIT(done, OS_EVENT_FOREVER);
+                OS_ASSERT(async_result == HW_I2C_ABORT_NONE);
+                break;
+        }
+}
+
+static void bench_spi(uint32_t scale)
+{
+        ad_spi_handle_t spi = ad_spi_open(&spi_conf);
+        uint8_t *regs = bus_mock_spi_regs(HW_SPI1);
+        uint32_t reads = READS * scale;
+        uint32_t irqs;
+        uint64_t start;
+        METHOD method;
+        char name[32];
+        uint32_t i;
+
+        OS_ASSERT(spi);
+        fill_regs(regs);
+
+        for (method = METHOD_CALLS; method <= METHOD_LIST_ASYNC; method++) {
+                /* Check bus sequence and data once, then measure */
+                bus_mock_trace_reset();
+                run_spi(spi, method);
+                if (method == METHOD_CALLS) {
+                        trace_save();
+                } else {
+                        trace_check();
+                }
+                check_data(regs);
+
+                irqs = bus_mock_irq_count();
+                start = bench_now_ns();
+                for (i = 0; i < reads; i++) {
+                        run_spi(spi, method);
+                }
+                snprintf(name, sizeof(name), "spi fifo+status, %s", method_names[method]);
+                bench_report(name, reads, bench_now_ns() - start, "%u bus events, %.1f irqs/op",
+                        (unsigned) ref_count, (double) (bus_mock_irq_count() - irqs) / reads);
+                check_data(regs);
+        }
+
+        OS_ASSERT(ad_spi_close(spi, false) == 0);
+}
+
+static void bench_i2c(uint32_t scale)
+{
+        ad_i2c_handle_t i2c = ad_i2c_open(&i2c_conf);
+        uint8_t *regs = bus_mock_i2c_regs(HW_I2C1);
+        uint32_t reads = READS * scale;
+        const bus_mock_trace_t *trace;
+        uint32_t count;
+        uint32_t irqs;
+        uint64_t start;
+        METHOD method;
+        char name[32];
+        uint32_t i;
+
+        OS_ASSERT(i2c);
+        fill_regs(regs);
+
+        for (method = METHOD_CALLS; method <= METHOD_LIST_ASYNC; method++) {
+                bus_mock_trace_reset();
+                run_i2c(i2c, method);
+                if (method == METHOD_CALLS) {
+                        trace_save();
+                } else {
+                        trace_check();
+                }
+                check_data(regs);
+
+                irqs = bus_mock_irq_count();
+                start = bench_now_ns();
+                for (i = 0; i < reads; i++) {
+                        run_i2c(i2c, method);
+                }
+                snprintf(name, sizeof(name), "i2c fifo+status, %s", method_names[method]);
+                bench_report(name, reads, bench_now_ns() - start, "%u bus events, %.1f irqs/op",
+                        (unsigned) ref_count, (double) (bus_mock_irq_count() - irqs) / reads);
+                check_data(regs);
+        }
+
+        /* Address NACK must stop the list, the controller ends with STOP */
+        bus_mock_trace_reset();
+        bus_mock_i2c_nack_next(HW_I2C1);
+        OS_ASSERT(ad_i2c_transact(i2c, i2c_list, ARRAY_LENGTH(i2c_list)) ==
+                                                                HW_I2C_ABORT_7B_ADDR_NO_ACK);
+        count = bus_mock_trace_get(&trace);
+        OS_ASSERT(count == 3);
+        OS_ASSERT(trace[1].event == BUS_MOCK_I2C_ABORT && trace[2].event == BUS_MOCK_I2C_STOP);
+
+        bus_mock_trace_reset();
+        bus_mock_i2c_nack_next(HW_I2C1);
+        OS_ASSERT(ad_i2c_transact_async(i2c, i2c_list, ARRAY_LENGTH(i2c_list), i2c_done_cb,
+                                                                                NULL) == 0);
+        OS_EVENT_WAIT(done, OS_EVENT_FOREVER);
+        OS_ASSERT(async_result == HW_I2C_ABORT_7B_ADDR_NO_ACK);
+        OS_ASSERT(bus_mock_trace_get(NULL) == 3);
+        printf("  i2c list aborted on NACK\n");
+
+        OS_ASSERT(ad_i2c_close(i2c, false) == 0);
+}
+
+void bench_spi_i2c(uint32_t scale)
+{
+        OS_EVENT_CREATE(done);
+
+        /* No ADAPTER_INIT on the host */
+        ad_spi_init();
+        ad_i2c_init();
+
+        bench_spi(scale);
+        bench_i2c(scale);
+
+        OS_EVENT_DELETE(done);
+}
@@ -0,0 +1,158 @@
+/**
+ ****************************************************************************************
+ *
+ * @file bench_storage.c
+ *
+ * @brief BLE storage (bonding data) load and save benchmark
+ *
+ * Copyright (C) 2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ ****************************************************************************************
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <osal.h>
+#include <ad_nvms.h>
+#include "storage.h"
+#include "storage_flash.h"
+#include "ad_flash_ram.h"
+#include "bench.h"
+
+#define SAVES                   50
+#define LOADS                   50
+#define APP_VALUES              4
+#define APP_VALUE_SIZE          16
+
+static bd_address_t first_addr;
+
+static void fill_random(void *buf, size_t len)
+{
+        uint8_t *p = buf;
+
+        while (len--) {
+                *p++ = bench_rand();
+        }
+}
+
+static void add_bonded_device(int index)
+{
+        bd_address_t addr;
+        device_t *dev;
+        void *value;
+        int i;
+
+        addr.addr_type = PUBLIC_ADDRESS;
+        fill_random(addr.addr, sizeof(addr.addr));
+        addr.addr[0] = index;
+
+        if (index == 0) {
+                first_addr = addr;
+        }
+
+        dev = find_device_by_addr(&addr, true);
+        OS_ASSERT(dev);
+
+        dev->paired = true;
+        dev->bonded = true;
+        dev->sec_level = GAP_SEC_LEVEL_3;
+        dev->mtu = 247;
+
+        dev->ltk = OS_MALLOC(sizeof(*dev->ltk));
+        fill_random(dev->ltk, sizeof(*dev->ltk));
+        dev->ltk->key_size = 16;
+        dev->remote_ltk = OS_MALLOC(sizeof(*dev->remote_ltk));
+        fill_random(dev->remote_ltk, sizeof(*dev->remote_ltk));
+        dev->remote_ltk->key_size = 16;
+        dev->irk = OS_MALLOC(sizeof(*dev->irk));
+        fill_random(dev->irk, sizeof(*dev->irk));
+
+        for (i = 0; i < APP_VALUES; i++) {
+                value = OS_MALLOC(APP_VALUE_SIZE);
+                fill_random(value, APP_VALUE_SIZE);
+                app_value_put(dev, i + 1, APP_VALUE_SIZE, value, NULL, true);
+        }
+}
+
+static void count_device(device_t *dev, void *ud)
+{
+        int *count = ud;
+
+        if (dev->bonded) {
+                (*count)++;
+        }
+}
+
+static int bonded_count(void)
+{
+        int count = 0;
+
+        device_foreach(count_device, &count);
+
+        return count;
+}
+
+static void report_flash(const char *name, uint32_t ops, uint64_t ns)
+{
+        ad_flash_ram_stats_t stats;
+
+        ad_flash_ram_get_stats(&stats);
+        bench_report(name, ops, ns, "%u flash reads, %u page programs, %u sector erases",
+                                (unsigned) stats.reads, (unsigned) stats.page_programs,
+                                (unsigned) stats.sector_erases);
+}
+
+void bench_storage(uint32_t scale)
+{
+        uint32_t count;
+        uint64_t start;
+        uint64_t ns;
+        uint32_t i;
+        int dev;
+
+        storage_init();
+
+        storage_acquire();
+        for (dev = 0; dev < defaultBLE_MAX_BONDED; dev++) {
+                add_bonded_device(dev);
+        }
+        storage_release();
+
+        /* Unchanged data, measures the read-compare cost of the VES */
+        count = SAVES * scale;
+        ad_flash_ram_reset_stats();
+        start = bench_now_ns();
+        for (i = 0; i < count; i++) {
+                storage_acquire();
+                storage_flash_save();
+                storage_release();
+        }
+        report_flash("save unchanged", count, bench_now_ns() - start);
+
+        /* Flags of one device changed, e.g. after pairing again with a different security */
+        ad_flash_ram_reset_stats();
+        start = bench_now_ns();
+        for (i = 0; i < count; i++) {
+                storage_acquire();
+                find_device_by_addr(&first_addr, false)->mitm = i & 1;
+                storage_flash_save();
+                storage_release();
+        }
+        report_flash("save one changed", count, bench_now_ns() - start);
+
+        count = LOADS * scale;
+        ns = 0;
+        ad_flash_ram_reset_stats();
+        for (i = 0; i < count; i++) {
+                storage_cleanup();
+                start = bench_now_ns();
+                storage_init();
+                ns += bench_now_ns() - start;
+                OS_ASSERT(bonded_count() == defaultBLE_MAX_BONDED);
+        }
+        report_flash("load", count, ns);
+
+        storage_cleanup();
+}
@@ -0,0 +1,375 @@
+/**
+ ****************************************************************************************
+ *
+ * @file bench_timestamp.c
+ *
+ * @brief Lock-free uptime snapshot benchmark
+ *
+ * Simulates the OS timer and the CPU cycle counter over a timeline with sleep, CPU clock
+ * changes and, with RCX, a drifting LP clock and periodic calibration, and reads the uptime
+ * through the snapshot of the system timer (sys_timer_ts.c) the way sys_timer.c does: fast
+ * reads with OS timer resolution and reads interpolated with the cycle counter. Updates of the
+ * snapshot are injected in the middle of reads.
+ *
+ * Every fast read must match a model of the uptime (LP cycles counted, usec accumulated with
+ * the LP cycle length known at each update; with XTAL32K the same as ticks * 10^6 / Hz). Every
+ * read must be monotonic and interpolated reads must stay within the LP cycle they belong to.
+ * Reports the error against the exact position in the LP cycle and against real time.
+ *
+ * Copyright (C) 2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ ****************************************************************************************
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <sdk_defs.h>
+#include "sys_timer_ts_internal.h"
+#include "bench.h"
+
+#define LP_MASK                 0xFFFFFF        /* 24-bit OS timer */
+#define SIM_US                  (20 * 1000 * 1000)
+#define XTAL32M_PPM             10.0
+#define CPU_LOOP_NS             50              /* one iteration of the edge detection loop */
+#define RCX_CAL_PERIOD_US       500000
+
+typedef struct {
+        const char *name;
+        uint32_t hz;                    /* configSYSTICK_CLOCK_HZ, nominal RCX frequency */
+        double lp_error;                /* actual / nominal - 1 */
+        bool rcx;
+} ts_config_t;
+
+typedef struct {
+        uint32_t reads;
+        uint64_t ns;
+        double max_err;
+        double sum_err;
+} read_stats_t;
+
+typedef struct {
+        const ts_config_t *cfg;
+        sys_ts_latch_t latch;
+
+        /* Hardware */
+        uint64_t t_ns;
+        double lp_phase;                /* LP cycles since power-up */
+        double cyc_phase;               /* CPU cycles counted by DWT CYCCNT */
+        uint32_t cpu_mhz;
+        bool awake;
+        double rcx_drift;
+
+        /* sys_timer.c state */
+        uint32_t current_time;
+        uint64_t sys_rtc_time;
+        uint32_t rcx_period;            /* cm_get_rcx_clock_period() */
+        uint32_t rcx_hz;                /* rcx_clock_hz */
+
+        /* Model */
+        double ref_q20;                 /* usec in 2^-20 at ref_ticks, exact below 2^53 */
+        uint64_t ref_ticks;
+        uint32_t ref_usec_per_tick;
+
+        /* Readers */
+        uint64_t last_fast;
+        uint64_t last_hires;
+        bool inject;
+        uint32_t injected;
+        uint32_t refreshes;
+        uint32_t anchors;
+        uint64_t spin_ns;
+        read_stats_t fast;
+        read_stats_t hires;
+        double max_real_err;
+} sim_t;
+
+static const ts_config_t configs[] = {
+        { "xtal32k", 32768,  30e-6, false },
+        { "rc32k",   32000, 0.5e-2, false },
+        { "rcx",     15000, 0.8e-3, true  },
+};
+
+static sim_t sim;
+
+static double lp_hz_actual(void)
+{
+        return sim.cfg->hz * (1.0 + sim.cfg->lp_error + sim.rcx_drift);
+}
+
+static void advance(uint64_t ns)
+{
+        sim.t_ns += ns;
+        sim.lp_phase += ns * lp_hz_actual() / 1e9;
+        if (sim.awake) {
+                sim.cyc_phase += ns * sim.cpu_mhz * (1.0 + XTAL32M_PPM * 1e-6) / 1e3;
+        }
+}
+
+static uint32_t usec_per_tick(void)
+{
+        return sim.cfg->rcx ? sim.rcx_period : SYS_TS_USEC_PER_TICK(sim.cfg->hz);
+}
+
+static uint32_t hw_lp(void)
+{
+        return (uint64_t)sim.lp_phase & LP_MASK;
+}
+
+static uint32_t hw_cycles(void)
+{
+        return (uint32_t)(uint64_t)sim.cyc_phase;
+}
+
+/* update_timestamp_values() of sys_timer.c, and the model */
+static void update(void)
+{
+        uint32_t prev_time = sim.current_time;
+
+        sim.current_time = hw_lp();
+        sim.sys_rtc_time += (sim.current_time - prev_time) & LP_MASK;
+        sys_ts_update(&sim.latch, sim.sys_rtc_time, sim.current_time, usec_per_tick());
+
+        sim.ref_q20 += (double)(sim.sys_rtc_time - sim.ref_ticks) *
+                       (sim.ref_usec_per_tick ? sim.ref_usec_per_tick : usec_per_tick());
+        sim.ref_ticks = sim.sys_rtc_time;
+        sim.ref_usec_per_tick = usec_per_tick();
+}
+
+/* OS timer read, a higher priority interrupt may update the snapshot right before it */
+static uint32_t read_lp(void)
+{
+        if (sim.inject && bench_rand() % 8 == 0) {
+                sim.inject = false;
+                sim.injected++;
+                update();
+        }
+
+        return hw_lp();
+}
+
+static uint64_t model_usec(double ticks)
+{
+        return (uint64_t)((sim.ref_q20 + (ticks - sim.ref_ticks) * sim.ref_usec_per_tick) /
+                          (1 << SYS_TS_USEC_FRAC_BITS));
+}
+
+static double model_usec_exact(double ticks)
+{
+        return (sim.ref_q20 + (ticks - sim.ref_ticks) * sim.ref_usec_per_tick) /
+               (1 << SYS_TS_USEC_FRAC_BITS);
+}
+
+static void fail(const char *what, uint64_t got, uint64_t expected)
+{
+        printf("%s: %s at %.6f s: %llu, expected %llu\n", sim.cfg->name, what, sim.t_ns / 1e9,
+               (unsigned long long)got, (unsigned long long)expected);
+        fflush(stdout);
+        ASSERT_WARNING(0);
+}
+
+static void account(read_stats_t *st, double err)
+{
+        err = fabs(err);
+        st->reads++;
+        st->sum_err += err;
+        if (err > st->max_err) {
+                st->max_err = err;
+        }
+}
+
+/* sys_timer_get_uptime_usec_fast() */
+static void read_fast(void)
+{
+        sys_ts_snapshot_t snap;
+        uint32_t lp;
+        uint32_t elapsed;
+        uint64_t t0, usec, ticks;
+
+        sim.inject = true;
+        for (;;) {
+                t0 = bench_now_ns();
+                sys_ts_read(&sim.latch, read_lp, NULL, &snap, &lp, NULL);
+                elapsed = sys_ts_elapsed(&snap, lp, LP_MASK);
+                usec = sys_ts_usec(&snap, elapsed << SYS_TS_LP_FRAC_BITS);
+                sim.fast.ns += bench_now_ns() - t0;
+                if (elapsed <= LP_MASK / 2) {
+                        break;
+                }
+                sim.refreshes++;
+                update();
+        }
+        sim.inject = false;
+
+        ticks = snap.ticks + elapsed;
+        if (ticks != (uint64_t)sim.lp_phase) {
+                fail("ticks", ticks, (uint64_t)sim.lp_phase);
+        }
+        if (usec != model_usec(ticks)) {
+                fail("usec", usec, model_usec(ticks));
+        }
+        if (!sim.cfg->rcx && usec != ticks * 1000000 / sim.cfg->hz) {
+                fail("usec vs division", usec, ticks * 1000000 / sim.cfg->hz);
+        }
+        if (usec < sim.last_fast) {
+                fail("fast not monotonic", usec, sim.last_fast);
+        }
+        sim.last_fast = usec;
+
+        account(&sim.fast, usec - model_usec_exact(sim.lp_phase));
+        if (fabs(usec - sim.t_ns / 1e3) > sim.max_real_err) {
+                sim.max_real_err = fabs(usec - sim.t_ns / 1e3);
+        }
+}
+
+/* ts_anchor() of sys_timer.c */
+static void anchor(void)
+{
+        sys_ts_anchor_t a;
+        uint64_t start = sim.t_ns;
+        uint32_t hz = sim.cfg->rcx ? sim.rcx_hz : sim.cfg->hz;
+
+        a.ticks_per_cycle = (uint32_t)(((uint64_t)hz << 32) / (sim.cpu_mhz * 1000000UL));
+
+        /* Wait for the edge, the loop reads it within CPU_LOOP_NS */
+        advance((uint64_t)((floor(sim.lp_phase) + 1 - sim.lp_phase) * 1e9 / lp_hz_actual()) + 1);
+        advance(bench_rand() % CPU_LOOP_NS);
+        a.cycles = hw_cycles();
+        a.lp = hw_lp();
+
+        sim.anchors++;
+        sim.spin_ns += sim.t_ns - start;
+        sys_ts_set_anchor(&sim.latch, &a);
+}
+
+/* sys_timer_get_uptime_usec_hires() */
+static void read_hires(bool from_isr)
+{
+        sys_ts_snapshot_t snap;
+        uint32_t lp, cycles, elapsed, frac;
+        uint64_t t0, usec, ticks;
+        bool drifted;
+
+        sim.inject = true;
+        for (;;) {
+                t0 = bench_now_ns();
+                sys_ts_read(&sim.latch, read_lp, hw_cycles, &snap, &lp, &cycles);
+                elapsed = sys_ts_elapsed(&snap, lp, LP_MASK);
+                frac = sys_ts_interpolate(&snap.anchor, lp, cycles, LP_MASK, &drifted);
+                usec = sys_ts_usec(&snap, (elapsed << SYS_TS_LP_FRAC_BITS) + frac);
+                sim.hires.ns += bench_now_ns() - t0;
+                if (elapsed <= LP_MASK / 2) {
+                        break;
+                }
+                sim.refreshes++;
+                update();
+        }
+        sim.inject = false;
+
+        ticks = snap.ticks + elapsed;
+        if (usec < model_usec(ticks) || usec > model_usec(ticks + 1)) {
+                fail("hires outside LP cycle", usec, model_usec(ticks));
+        }
+        if (usec < sim.last_hires) {
+                fail("hires not monotonic", usec, sim.last_hires);
+        }
+        sim.last_hires = usec;
+        account(&sim.hires, usec - model_usec_exact(sim.lp_phase));
+
+        if ((drifted || snap.anchor.ticks_per_cycle == 0) && !from_isr) {
+                anchor();
+        }
+}
+
+static void sleep_for(uint64_t ns)
+{
+        const sys_ts_anchor_t no_anchor = { 0 };
+
+        update();                               /* sleep entry */
+        sim.awake = false;
+        sys_ts_set_anchor(&sim.latch, &no_anchor);
+        advance(ns);
+        if (bench_rand() % 2) {
+                sim.cyc_phase = 0;              /* debug block powered down */
+        }
+        sim.awake = true;
+        update();                               /* wake-up */
+}
+
+static void calibrate_rcx(void)
+{
+        double hz;
+
+        sim.rcx_drift = 1e-3 * sin(sim.t_ns / 7e9);
+        hz = lp_hz_actual();
+        sim.rcx_hz = (uint32_t)(hz + 0.5);
+        sim.rcx_period = (uint32_t)((1000000.0 * (1 << SYS_TS_USEC_FRAC_BITS)) / hz + 0.5);
+}
+
+static void run(const ts_config_t *cfg, uint32_t scale)
+{
+        char name[48];
+        uint64_t end_ns = (uint64_t)SIM_US * 1000 * scale;
+        uint64_t next_cal = 0;
+        bool gap_done = false;
+
+        memset(&sim, 0, sizeof(sim));
+        sim.cfg = cfg;
+        sim.cpu_mhz = 96;
+        sim.awake = true;
+        calibrate_rcx();
+        update();
+
+        while (sim.t_ns < end_ns) {
+                uint32_t r = bench_rand() % 1000;
+
+                advance(1000 + bench_rand() % 200000);
+
+                if (cfg->rcx && sim.t_ns >= next_cal) {
+                        calibrate_rcx();
+                        next_cal = sim.t_ns + RCX_CAL_PERIOD_US * 1000ULL;
+                }
+
+                if (r < 400) {
+                        read_fast();
+                } else if (r < 800) {
+                        read_hires(r >= 700);
+                } else if (r < 900) {
+                        update();
+                } else if (r < 905) {
+                        sleep_for(1000000ULL + (uint64_t)(bench_rand() % 300) * 1000000);
+                } else if (r < 920) {
+                        sim.cpu_mhz = (sim.cpu_mhz == 96) ? 32 : 96;
+                }
+
+                if (!gap_done && sim.t_ns > end_ns / 2) {
+                        /* Awake without any update for more than half the OS timer range */
+                        uint64_t gap_ns = (uint64_t)((LP_MASK / 2 + 1000) * 1e9 / lp_hz_actual());
+
+                        advance(gap_ns);
+                        end_ns += gap_ns;
+                        gap_done = true;
+                        read_fast();
+                }
+        }
+
+        snprintf(name, sizeof(name), "timestamp %s fast", cfg->name);
+        bench_report(name, sim.fast.reads, sim.fast.ns, "err %.1f us mean %.1f us max  "
+                     "%.0f us max vs real time  %u updates mid-read  %u refreshes",
+                     sim.fast.sum_err / sim.fast.reads, sim.fast.max_err, sim.max_real_err,
+                     sim.injected, sim.refreshes);
+        snprintf(name, sizeof(name), "timestamp %s hires", cfg->name);
+        bench_report(name, sim.hires.reads, sim.hires.ns, "err %.2f us mean %.1f us max  "
+                     "%u anchors  %.1f us/s waiting for LP edges",
+                     sim.hires.sum_err / sim.hires.reads, sim.hires.max_err, sim.anchors,
+                     sim.spin_ns / 1e3 / (sim.t_ns / 1e9));
+}
+
+void bench_timestamp(uint32_t scale)
+{
+        for (size_t i = 0; i < ARRAY_LENGTH(configs); i++) {
+                run(&configs[i], scale);
+        }
+}
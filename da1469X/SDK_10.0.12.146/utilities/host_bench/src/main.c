@@ -0,0 +1,226 @@
+/**
+ ****************************************************************************************
+ *
+ * @file main.c
+ *
+ * @brief Host benchmark suite
+ *
+ * Starts the FreeRTOS scheduler on top of the POSIX port and runs the selected benchmarks
+ * from a task, like an application would on the target.
+ *
+ * Copyright (C) 2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ ****************************************************************************************
+ */
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <osal.h>
+#include <ad_flash.h>
+#include <ad_nvms.h>
+#include <logging.h>
+#include <resmgmt.h>
+#include "uart_pty.h"
+#include "bench.h"
+
+#define UART_IDLE_TICKS         ( OS_MS_2_TICKS(20) )
+
+#define BENCH_TASK_PRIORITY     ( OS_TASK_PRIORITY_NORMAL )
+#define BENCH_TASK_STACK_SIZE   ( 4096 )
+
+static const bench_t benches[] = {
+        { "msg_queue",  bench_msg_queue },
+        { "logging",    bench_logging   },
+        { "console",    bench_console   },
+        { "nvms",       bench_nvms      },
+        { "storage",    bench_storage   },
+        { "spi_i2c",    bench_spi_i2c   },
+        { "audio_src",  bench_audio_src },
+        { "haptics",    bench_haptics   },
+        { "lcdc_fb",    bench_lcdc_fb   },
+        { "clk_vote",   bench_clk_vote  },
+        { "timestamp",  bench_timestamp },
+        { "ringbuf",    bench_ringbuf   },
+        { "snc_queues", bench_snc_queues },
+};
+
+static const char **selected;
+static int selected_count;
+static uint32_t scale = 1;
+static uint32_t rand_state = 0x12345678;
+
+uint64_t bench_now_ns(void)
+{
+        struct timespec ts;
+
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+
+        return (uint64_t) ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+void bench_report(const char *name, uint32_t ops, uint64_t ns, const char *fmt, ...)
+{
+        va_list args;
+
+        printf("  %-32s %9u ops %12.1f ns/op %12.0f ops/s", name, ops,
+                        ops ? (double) ns / ops : 0.0, ns ? ops * 1e9 / ns : 0.0);
+        if (fmt) {
+                printf("  ");
+                va_start(args, fmt);
+                vprintf(fmt, args);
+                va_end(args);
+        }
+        printf("\n");
+        fflush(stdout);
+}
+
+uint32_t bench_wait_uart_idle(HW_UART_ID uart)
+{
+        uint32_t drained = uart_pty_get_drained(uart);
+        uint32_t last;
+
+        do {
+                last = drained;
+                OS_DELAY(UART_IDLE_TICKS);
+                drained = uart_pty_get_drained(uart);
+        } while (drained != last);
+
+        return drained;
+}
+
+uint32_t bench_rand(void)
+{
+        /* xorshift32 */
+        rand_state ^= rand_state << 13;
+        rand_state ^= rand_state >> 17;
+        rand_state ^= rand_state << 5;
+
+        return rand_state;
+}
+
+static bool is_selected(const char *name)
+{
+        int i;
+
+        if (selected_count == 0) {
+                return true;
+        }
+
+        for (i = 0; i < selected_count; i++) {
+                if (strcmp(selected[i], name) == 0) {
+                        return true;
+                }
+        }
+
+        return false;
+}
+
+static void print_heap_stats(void)
+{
+        OS_HEAP_STATS stats;
+
+        OS_GET_HEAP_STATS(&stats);
+        printf("heap: free %u, min ever free %u, largest free block %u, %u allocs, %u frees\n",
+                (unsigned) stats.xAvailableHeapSpaceInBytes,
+                (unsigned) stats.xMinimumEverFreeBytesRemaining,
+                (unsigned) stats.xSizeOfLargestFreeBlockInBytes,
+                (unsigned) stats.xNumberOfSuccessfulAllocations,
+                (unsigned) stats.xNumberOfSuccessfulFrees);
+
+#if (dg_configUSE_OS_MEM_POOLS == 1)
+        {
+                OS_POOL_STATS pool_stats;
+                int i;
+
+                for (i = 0; i < OS_MEM_POOL_CLASS_COUNT; i++) {
+                        os_mem_pool_get_class_stats(i, &pool_stats);
+                        printf("pool %4u x %3u: max used %3u, failed %u\n",
+                                (unsigned) pool_stats.block_size,
+                                (unsigned) pool_stats.num_blocks,
+                                (unsigned) pool_stats.max_used,
+                                (unsigned) pool_stats.alloc_failed);
+                }
+        }
+#endif
+}
+
+static void bench_task(void *param)
+{
+        size_t i;
+
+        resource_init();
+        ad_flash_init();
+        ad_nvms_init();
+        log_init();
+
+        for (i = 0; i < sizeof(benches) / sizeof(benches[0]); i++) {
+                if (!is_selected(benches[i].name)) {
+                        continue;
+                }
+                printf("%s:\n", benches[i].name);
+                fflush(stdout);
+                benches[i].run(scale);
+        }
+
+        print_heap_stats();
+
+        vTaskEndScheduler();
+}
+
+static void usage(const char *prog)
+{
+        size_t i;
+
+        fprintf(stderr, "Usage: %s [-s scale] [benchmark...]\n\nBenchmarks:", prog);
+        for (i = 0; i < sizeof(benches) / sizeof(benches[0]); i++) {
+                fprintf(stderr, " %s", benches[i].name);
+        }
+        fprintf(stderr, "\n");
+        exit(1);
+}
+
+int main(int argc, char *argv[])
+{
+        OS_TASK task;
+        int first = 1;
+        int i;
+
+        if (argc > 2 && strcmp(argv[1], "-s") == 0) {
+                scale = strtoul(argv[2], NULL, 0);
+                if (scale == 0) {
+                        usage(argv[0]);
+                }
+                first = 3;
+        }
+        for (i = first; i < argc; i++) {
+                if (argv[i][0] == '-') {
+                        usage(argv[0]);
+                }
+        }
+        selected = (const char **) &argv[first];
+        selected_count = argc - first;
+
+        OS_TASK_CREATE("bench", bench_task, NULL, BENCH_TASK_STACK_SIZE, BENCH_TASK_PRIORITY, task);
+        OS_ASSERT(task);
+
+        vTaskStartScheduler();
+
+        return 0;
+}
+
+void vApplicationMallocFailedHook(void)
+{
+        fprintf(stderr, "malloc failed\n");
+        abort();
+}
+
+void vAssertCalled(const char *file, int line)
+{
+        fprintf(stderr, "assertion failed at %s:%d\n", file, line);
+        abort();
+}
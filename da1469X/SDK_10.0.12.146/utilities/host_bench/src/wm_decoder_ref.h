@@ -0,0 +1,41 @@
+/**
+ ****************************************************************************************
+ *
+ * @file wm_decoder_ref.h
+ *
+ * @brief Reference haptic waveform memory decoder
+ *
+ * Copyright (C) 2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ ****************************************************************************************
+ */
+
+#ifndef WM_DECODER_REF_H_
+#define WM_DECODER_REF_H_
+
+#include "wm_decoder.h"
+
+/**
+ * \brief Decoder state of the reference decoder, as wm_decoder before the frame tables
+ */
+typedef struct {
+        uint8_t *wm_data;
+        uint32_t start_time;
+        wm_decoder_flags flags;
+        uint8_t sequence_id;
+        uint8_t frame_index;
+        uint8_t pwl_index;
+        wm_frame_data frame_data;
+        wm_pwl_segment segment;
+        uint16_t frequency;
+        int16_t amplitude;
+} wm_ref_decoder;
+
+void wm_ref_decoder_init(wm_ref_decoder *decoder, uint8_t *wm_data, unsigned ACCELERATION_EN,
+                         unsigned FREQ_WAVEFORM_TIMEBASE);
+unsigned wm_ref_decoder_trigger_sequence(wm_ref_decoder *decoder, uint32_t time, unsigned sequence_id);
+unsigned wm_ref_decoder_update(wm_ref_decoder *decoder, uint32_t time);
+
+#endif /* WM_DECODER_REF_H_ */
@@ -0,0 +1,187 @@
+/**
+ ****************************************************************************************
+ *
+ * @file ad_flash_ram.c
+ *
+ * @brief RAM backed flash adapter for the host (POSIX) build
+ *
+ * Implements the ad_flash API on top of a RAM image. NOR flash semantics are kept: writes can
+ * only clear bits and erase works on whole sectors, so that the NVMS drivers take the same
+ * decisions (erase or update in place) as on the target.
+ *
+ * Copyright (C) 2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ ****************************************************************************************
+ */
+
+#include <string.h>
+#include <osal.h>
+#include <ad_flash.h>
+#include <sys_power_mgr.h>
+#include "ad_flash_ram.h"
+
+#define FLASH_PAGE_SIZE   0x0100
+
+__RETAINED static bool initialized;
+__RETAINED static OS_MUTEX flash_mutex;
+static uint8_t flash_image[AD_FLASH_RAM_SIZE];
+static ad_flash_ram_stats_t flash_stats;
+
+const void *qspi_automode_addr(uint32_t addr)
+{
+        OS_ASSERT(addr < AD_FLASH_RAM_SIZE);
+
+        return &flash_image[addr];
+}
+
+void ad_flash_ram_get_stats(ad_flash_ram_stats_t *stats)
+{
+        ad_flash_lock();
+        *stats = flash_stats;
+        ad_flash_unlock();
+}
+
+void ad_flash_ram_reset_stats(void)
+{
+        ad_flash_lock();
+        memset(&flash_stats, 0, sizeof(flash_stats));
+        ad_flash_unlock();
+}
+
+void ad_flash_ram_format(void)
+{
+        memset(flash_image, 0xFF, sizeof(flash_image));
+}
+
+void ad_flash_init(void)
+{
+        if (!initialized) {
+                initialized = true;
+                OS_MUTEX_CREATE(flash_mutex);
+                OS_ASSERT(flash_mutex);
+                ad_flash_ram_format();
+        }
+}
+
+void ad_flash_lock(void)
+{
+        OS_MUTEX_GET(flash_mutex, OS_MUTEX_FOREVER);
+}
+
+void ad_flash_unlock(void)
+{
+        OS_MUTEX_PUT(flash_mutex);
+}
+
+size_t ad_flash_read(uint32_t addr, uint8_t *buf, size_t len)
+{
+        ASSERT_WARNING(buf);
+
+        if (addr >= AD_FLASH_RAM_SIZE) {
+                return 0;
+        }
+        len = MIN(len, AD_FLASH_RAM_SIZE - addr);
+
+        ad_flash_lock();
+        memcpy(buf, &flash_image[addr], len);
+        flash_stats.reads++;
+        flash_stats.read_bytes += len;
+        ad_flash_unlock();
+
+        return len;
+}
+
+size_t ad_flash_write(uint32_t addr, const uint8_t *buf, size_t size)
+{
+        size_t offset = 0;
+        size_t chunk;
+        size_t i;
+
+        ASSERT_WARNING(buf);
+
+        if (addr >= AD_FLASH_RAM_SIZE) {
+                return 0;
+        }
+        size = MIN(size, AD_FLASH_RAM_SIZE - addr);
+
+        ad_flash_lock();
+        flash_stats.writes++;
+        while (offset < size) {
+                /* Program never crosses page boundary */
+                chunk = FLASH_PAGE_SIZE - ((addr + offset) & (FLASH_PAGE_SIZE - 1));
+                chunk = MIN(chunk, size - offset);
+                for (i = 0; i < chunk; i++) {
+                        flash_image[addr + offset + i] &= buf[offset + i];
+                }
+                flash_stats.page_programs++;
+                offset += chunk;
+        }
+        flash_stats.write_bytes += size;
+        ad_flash_unlock();
+
+        return size;
+}
+
+bool ad_flash_erase_region(uint32_t addr, size_t size)
+{
+        uint32_t sector;
+        uint32_t end;
+
+        if (addr >= AD_FLASH_RAM_SIZE || size == 0) {
+                return false;
+        }
+
+        sector = addr & ~(AD_FLASH_SECTOR_SIZE - 1);
+        end = MIN(addr + size, AD_FLASH_RAM_SIZE);
+
+        ad_flash_lock();
+        for (; sector < end; sector += AD_FLASH_SECTOR_SIZE) {
+                memset(&flash_image[sector], 0xFF, AD_FLASH_SECTOR_SIZE);
+                flash_stats.sector_erases++;
+        }
+        ad_flash_unlock();
+
+        return true;
+}
+
+int ad_flash_update_possible(uint32_t addr, const uint8_t *data_to_write, size_t size)
+{
+        int i;
+        int same;
+        const uint8_t *old = qspi_automode_addr(addr);
+
+        ASSERT_WARNING(data_to_write);
+
+        /* Check if new data is same as old one, in which case no write will be needed */
+        for (i = 0; i < size && old[i] == data_to_write[i]; ++i) {
+        }
+
+        /* This much did not change */
+        same = i;
+
+        /* Check if new data can be stored by clearing bits only */
+        for (; i < size ; ++i) {
+                if ((old[i] & data_to_write[i]) != data_to_write[i])
+                        return -1;
+        }
+        return same;
+}
+
+size_t ad_flash_erase_size(void)
+{
+        return AD_FLASH_SECTOR_SIZE;
+}
+
+bool ad_flash_chip_erase(void)
+{
+        return ad_flash_erase_region(0, AD_FLASH_RAM_SIZE);
+}
+
+void ad_flash_skip_cache_flushing(uint32_t base, uint32_t size)
+{
+        /* No cache on the host */
+}
+
+ADAPTER_INIT(ad_flash_adapter, ad_flash_init)
@@ -0,0 +1,59 @@
+/**
+ ****************************************************************************************
+ *
+ * @file ad_flash_ram.h
+ *
+ * @brief RAM backed flash adapter for the host (POSIX) build
+ *
+ * Copyright (C) 2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ ****************************************************************************************
+ */
+
+#ifndef AD_FLASH_RAM_H_
+#define AD_FLASH_RAM_H_
+
+#include <stdint.h>
+
+/**
+ * \brief Size of the emulated flash, matches the default 4MB partition table
+ */
+#ifndef AD_FLASH_RAM_SIZE
+#define AD_FLASH_RAM_SIZE       (4 * 1024 * 1024)
+#endif
+
+/**
+ * \brief Flash operation counters
+ *
+ * Every operation that would reach the QSPI controller on the target is counted, so that
+ * benchmarks can report flash wear and an estimation of flash time next to CPU time.
+ */
+typedef struct {
+        uint32_t reads;                 /**< Number of read calls */
+        uint32_t read_bytes;            /**< Bytes read */
+        uint32_t writes;                /**< Number of write calls */
+        uint32_t write_bytes;           /**< Bytes programmed */
+        uint32_t page_programs;         /**< Page program commands (writes split on page boundary) */
+        uint32_t sector_erases;         /**< Sectors erased */
+} ad_flash_ram_stats_t;
+
+/**
+ * \brief Get flash operation counters
+ *
+ * \param [out] stats counters since start or last ad_flash_ram_reset_stats()
+ */
+void ad_flash_ram_get_stats(ad_flash_ram_stats_t *stats);
+
+/**
+ * \brief Reset flash operation counters
+ */
+void ad_flash_ram_reset_stats(void);
+
+/**
+ * \brief Erase the whole emulated flash without counting it
+ */
+void ad_flash_ram_format(void);
+
+#endif /* AD_FLASH_RAM_H_ */
@@ -0,0 +1,30 @@
+/**
+ ****************************************************************************************
+ *
+ * @file ble_mgr_host.c
+ *
+ * @brief BLE manager stub for the host (POSIX) build
+ *
+ * Only the parts used by the BLE storage are provided. Every task is treated as the BLE
+ * manager task, so storage is flushed synchronously from storage_release().
+ *
+ * Copyright (C) 2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ ****************************************************************************************
+ */
+
+#include <osal.h>
+#include "ble_mgr.h"
+#include "storage_flash.h"
+
+bool ble_mgr_is_own_task(void)
+{
+        return true;
+}
+
+void ble_mgr_notify_commit_storage(void)
+{
+        storage_flash_save();
+}
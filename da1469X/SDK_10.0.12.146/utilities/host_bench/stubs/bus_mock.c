@@ -0,0 +1,126 @@
+/**
+ ****************************************************************************************
+ *
+ * @file bus_mock.c
+ *
+ * @brief Common part of the SPI and I2C bus mocks for the host (POSIX) build
+ *
+ * Also implements the IO configuration and delay functions used by the adapters.
+ *
+ * Copyright (C) 2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ ****************************************************************************************
+ */
+
+#include <time.h>
+#include <osal.h>
+#include <ad.h>
+#include <hw_clk.h>
+#include "bus_mock.h"
+
+static bus_mock_trace_t trace[BUS_MOCK_TRACE_SIZE];
+static uint32_t trace_count;
+static volatile uint32_t irq_count;
+
+static void *irq_thread(void *param)
+{
+        bus_mock_irq_t *irq = param;
+        void (*handler)(void *arg);
+        void *arg;
+
+        pthread_mutex_lock(&irq->lock);
+        for (;;) {
+                while (!irq->handler) {
+                        pthread_cond_wait(&irq->cond, &irq->lock);
+                }
+                handler = irq->handler;
+                arg = irq->arg;
+                irq->handler = NULL;
+                pthread_mutex_unlock(&irq->lock);
+
+                vPortEnterISR();
+                irq_count++;
+                handler(arg);
+                vPortExitISR();
+
+                pthread_mutex_lock(&irq->lock);
+        }
+
+        return NULL;
+}
+
+void bus_mock_irq_raise(bus_mock_irq_t *irq, void (*handler)(void *arg), void *arg)
+{
+        /* Callers own the simulated CPU, so there is no race on first use */
+        if (!irq->started) {
+                pthread_mutex_init(&irq->lock, NULL);
+                pthread_cond_init(&irq->cond, NULL);
+                pthread_create(&irq->thread, NULL, irq_thread, irq);
+                irq->started = true;
+        }
+
+        pthread_mutex_lock(&irq->lock);
+        OS_ASSERT(irq->handler == NULL);
+        irq->handler = handler;
+        irq->arg = arg;
+        pthread_cond_broadcast(&irq->cond);
+        pthread_mutex_unlock(&irq->lock);
+}
+
+uint32_t bus_mock_irq_count(void)
+{
+        return irq_count;
+}
+
+void bus_mock_trace_add(uint8_t bus, BUS_MOCK_EVENT event, uint16_t len)
+{
+        if (trace_count < BUS_MOCK_TRACE_SIZE) {
+                trace[trace_count].bus = bus;
+                trace[trace_count].event = event;
+                trace[trace_count].len = len;
+        }
+        trace_count++;
+}
+
+void bus_mock_trace_reset(void)
+{
+        trace_count = 0;
+}
+
+uint32_t bus_mock_trace_get(const bus_mock_trace_t **t)
+{
+        if (t) {
+                *t = trace;
+        }
+
+        return trace_count;
+}
+
+void hw_clk_delay_usec(uint32_t usec)
+{
+        struct timespec start, now;
+        uint64_t elapsed;
+
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        do {
+                clock_gettime(CLOCK_MONOTONIC, &now);
+                elapsed = (now.tv_sec - start.tv_sec) * 1000000000ULL + now.tv_nsec - start.tv_nsec;
+        } while (elapsed < usec * 1000ULL);
+}
+
+/*
+ * Pins are not simulated
+ */
+
+AD_IO_ERROR ad_io_configure(const ad_io_conf_t *io, uint8_t size, HW_GPIO_POWER voltage_level,
+                                                                        AD_IO_CONF_STATE state)
+{
+        return AD_IO_ERROR_NONE;
+}
+
+AD_IO_ERROR ad_io_set_pad_latch(const ad_io_conf_t *io, uint8_t size, AD_IO_PAD_LATCHES_OP operation)
+{
+        return AD_IO_ERROR_NONE;
+}
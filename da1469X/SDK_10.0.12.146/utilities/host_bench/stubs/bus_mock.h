@@ -0,0 +1,122 @@
+/**
+ ****************************************************************************************
+ *
+ * @file bus_mock.h
+ *
+ * @brief SPI and I2C bus mocks for the host (POSIX) build
+ *
+ * stubs/hw_spi_mock.c and stubs/hw_i2c_mock.c implement the low level drivers used by the SPI
+ * and I2C adapters. Every controller has a register file device attached: the first byte written
+ * after chip select activation (SPI) or after START/RESTART (I2C) selects the register, following
+ * bytes are written to or read from consecutive registers. For SPI bit 7 of the first byte
+ * selects a read. Transfers complete from a per controller thread in simulated interrupt context,
+ * like the SPI/I2C/DMA interrupts do on the target.
+ *
+ * Every bus event (chip select change, START, transfer, ...) is appended to a trace, so the
+ * sequence produced by the adapters can be checked.
+ *
+ * Copyright (C) 2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ ****************************************************************************************
+ */
+
+#ifndef BUS_MOCK_H_
+#define BUS_MOCK_H_
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include "hw_spi.h"
+#include "hw_i2c.h"
+
+#define BUS_MOCK_REGS           ( 128 )
+#define BUS_MOCK_TRACE_SIZE     ( 256 )
+
+/**
+ * \brief Bus event recorded in the trace
+ */
+typedef enum {
+        BUS_MOCK_SPI_CS_LOW,
+        BUS_MOCK_SPI_CS_HIGH,
+        BUS_MOCK_SPI_WRITE,
+        BUS_MOCK_SPI_READ,
+        BUS_MOCK_SPI_WRITE_READ,
+        BUS_MOCK_I2C_START,
+        BUS_MOCK_I2C_RESTART,
+        BUS_MOCK_I2C_WRITE,
+        BUS_MOCK_I2C_READ,
+        BUS_MOCK_I2C_STOP,
+        BUS_MOCK_I2C_ABORT,
+} BUS_MOCK_EVENT;
+
+typedef struct {
+        uint8_t bus;                    /**< Controller index, 1 for SPI1/I2C1 */
+        uint8_t event;                  /**< BUS_MOCK_EVENT */
+        uint16_t len;                   /**< Number of bytes of a transfer */
+} bus_mock_trace_t;
+
+/**
+ * \brief Simulated interrupt of a controller
+ */
+typedef struct {
+        bool started;
+        pthread_t thread;
+        pthread_mutex_t lock;
+        pthread_cond_t cond;
+        void (*handler)(void *arg);
+        void *arg;
+} bus_mock_irq_t;
+
+/**
+ * \brief Run handler in simulated interrupt context
+ *
+ * Can be called from tasks and from handlers, only one handler can be pending per interrupt.
+ *
+ * \param [in] irq interrupt
+ * \param [in] handler function to run
+ * \param [in] arg argument of \p handler
+ */
+void bus_mock_irq_raise(bus_mock_irq_t *irq, void (*handler)(void *arg), void *arg);
+
+/**
+ * \brief Get number of handlers run from simulated interrupt context so far
+ */
+uint32_t bus_mock_irq_count(void);
+
+/**
+ * \brief Append event to the trace, events after the trace is full are counted only
+ */
+void bus_mock_trace_add(uint8_t bus, BUS_MOCK_EVENT event, uint16_t len);
+
+/**
+ * \brief Clear the trace
+ */
+void bus_mock_trace_reset(void);
+
+/**
+ * \brief Get the trace
+ *
+ * \param [out] trace recorded events, can be NULL
+ *
+ * \return number of events, may be more than BUS_MOCK_TRACE_SIZE
+ */
+uint32_t bus_mock_trace_get(const bus_mock_trace_t **trace);
+
+/**
+ * \brief Get registers of the device attached to SPI controller
+ */
+uint8_t *bus_mock_spi_regs(HW_SPI_ID id);
+
+/**
+ * \brief Get registers of the device attached to I2C controller
+ */
+uint8_t *bus_mock_i2c_regs(HW_I2C_ID id);
+
+/**
+ * \brief Make the next I2C transfer fail with HW_I2C_ABORT_7B_ADDR_NO_ACK
+ */
+void bus_mock_i2c_nack_next(HW_I2C_ID id);
+
+#endif /* BUS_MOCK_H_ */
@@ -0,0 +1,257 @@
+/**
+ ****************************************************************************************
+ *
+ * @file hw_i2c_mock.c
+ *
+ * @brief I2C low level driver mock for the host (POSIX) build, master mode only
+ *
+ * Copyright (C) 2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ ****************************************************************************************
+ */
+
+#include <string.h>
+#include <osal.h>
+#include "bus_mock.h"
+
+#define I2C_COUNT               2
+
+typedef struct {
+        bus_mock_irq_t irq;
+        volatile bool busy;
+        uint16_t abort_source;
+        bool nack_next;
+        bool started;                   /* Between START and STOP */
+        /* Transfer in progress, write then read for hw_i2c_write_then_read_async() */
+        const uint8_t *out;
+        uint16_t out_len;
+        uint8_t *in;
+        uint16_t in_len;
+        uint32_t flags;
+        hw_i2c_complete_cb cb;
+        void *cb_data;
+        /* Attached device */
+        uint8_t regs[BUS_MOCK_REGS];
+        uint8_t reg;
+} i2c_mock_t;
+
+static i2c_mock_t i2cs[I2C_COUNT];
+
+static uint8_t i2c_index(HW_I2C_ID id)
+{
+        uintptr_t index = (uintptr_t) id - 1;
+
+        OS_ASSERT(index < I2C_COUNT);
+
+        return index;
+}
+
+static i2c_mock_t *get_i2c(HW_I2C_ID id)
+{
+        return &i2cs[i2c_index(id)];
+}
+
+/* START or RESTART, returns true when a new message begins */
+static bool begin(i2c_mock_t *c, uint8_t bus, bool restart)
+{
+        if (!c->started) {
+                bus_mock_trace_add(bus, BUS_MOCK_I2C_START, 0);
+                c->started = true;
+                return true;
+        }
+        if (restart) {
+                bus_mock_trace_add(bus, BUS_MOCK_I2C_RESTART, 0);
+                return true;
+        }
+
+        return false;
+}
+
+static void device_write(i2c_mock_t *c, const uint8_t *data, uint16_t len, bool new_message)
+{
+        uint16_t i = 0;
+
+        if (new_message && len) {
+                c->reg = data[i++] % BUS_MOCK_REGS;
+        }
+        for (; i < len; i++) {
+                c->regs[c->reg] = data[i];
+                c->reg = (c->reg + 1) % BUS_MOCK_REGS;
+        }
+}
+
+static void device_read(i2c_mock_t *c, uint8_t *data, uint16_t len)
+{
+        uint16_t i;
+
+        for (i = 0; i < len; i++) {
+                data[i] = c->regs[c->reg];
+                c->reg = (c->reg + 1) % BUS_MOCK_REGS;
+        }
+}
+
+static void transfer_irq(void *arg)
+{
+        i2c_mock_t *c = arg;
+        uint8_t bus = c - i2cs + 1;
+        HW_I2C_ID id = (HW_I2C_ID) (uintptr_t) bus;
+        hw_i2c_complete_cb cb = c->cb;
+        bool restart = c->flags & HW_I2C_F_ADD_RESTART;
+        uint16_t len = 0;
+        bool success = true;
+
+        if (c->nack_next) {
+                /* Controller generates STOP after an abort */
+                c->nack_next = false;
+                begin(c, bus, restart);
+                bus_mock_trace_add(bus, BUS_MOCK_I2C_ABORT, 0);
+                bus_mock_trace_add(bus, BUS_MOCK_I2C_STOP, 0);
+                c->started = false;
+                c->abort_source = HW_I2C_ABORT_7B_ADDR_NO_ACK;
+                success = false;
+        } else {
+                if (c->out) {
+                        device_write(c, c->out, c->out_len, begin(c, bus, restart));
+                        bus_mock_trace_add(bus, BUS_MOCK_I2C_WRITE, c->out_len);
+                        len = c->out_len;
+                        /* Read of write-then-read always starts with RESTART */
+                        restart = true;
+                }
+                if (c->in) {
+                        begin(c, bus, restart);
+                        device_read(c, c->in, c->in_len);
+                        bus_mock_trace_add(bus, BUS_MOCK_I2C_READ, c->in_len);
+                        len = c->in_len;
+                }
+                if (c->flags & HW_I2C_F_ADD_STOP) {
+                        bus_mock_trace_add(bus, BUS_MOCK_I2C_STOP, 0);
+                        c->started = false;
+                }
+        }
+
+        /* Like the driver, release the controller first so the callback can start a new transfer */
+        c->cb = NULL;
+        c->busy = false;
+        cb(id, c->cb_data, len, success);
+}
+
+static int start_transfer(HW_I2C_ID id, const uint8_t *out, uint16_t out_len, uint8_t *in,
+                        uint16_t in_len, hw_i2c_complete_cb cb, void *cb_data, uint32_t flags)
+{
+        i2c_mock_t *c = get_i2c(id);
+
+        OS_ASSERT(!c->busy);
+        OS_ASSERT(cb);
+
+        c->out = out;
+        c->out_len = out_len;
+        c->in = in;
+        c->in_len = in_len;
+        c->flags = flags;
+        c->cb = cb;
+        c->cb_data = cb_data;
+        c->busy = true;
+        bus_mock_irq_raise(&c->irq, transfer_irq, c);
+
+        return 0;
+}
+
+void hw_i2c_init(HW_I2C_ID id, const i2c_config *cfg)
+{
+        OS_ASSERT(cfg->mode == HW_I2C_MODE_MASTER);
+}
+
+void hw_i2c_deinit(HW_I2C_ID id)
+{
+}
+
+void hw_i2c_enable(HW_I2C_ID id)
+{
+}
+
+void hw_i2c_disable(HW_I2C_ID id)
+{
+}
+
+bool hw_i2c_is_occupied(HW_I2C_ID id)
+{
+        return get_i2c(id)->busy;
+}
+
+uint8_t hw_i2c_is_master(HW_I2C_ID id)
+{
+        return 1;
+}
+
+bool hw_i2c_controler_is_busy(HW_I2C_ID id)
+{
+        return false;
+}
+
+bool hw_i2c_is_master_busy(HW_I2C_ID id)
+{
+        return false;
+}
+
+bool hw_i2c_is_tx_fifo_empty(HW_I2C_ID id)
+{
+        return true;
+}
+
+bool hw_i2c_is_rx_fifo_not_empty(HW_I2C_ID id)
+{
+        return false;
+}
+
+void hw_i2c_master_abort_transfer(HW_I2C_ID id)
+{
+}
+
+uint16_t hw_i2c_get_abort_source(HW_I2C_ID id)
+{
+        return get_i2c(id)->abort_source;
+}
+
+void hw_i2c_reset_abort_source(HW_I2C_ID id)
+{
+        get_i2c(id)->abort_source = HW_I2C_ABORT_NONE;
+}
+
+void hw_i2c_reset_int_all(HW_I2C_ID id)
+{
+}
+
+void hw_i2c_unregister_int(HW_I2C_ID id)
+{
+}
+
+int hw_i2c_write_buffer_async(HW_I2C_ID id, const uint8_t *data, uint16_t len,
+                                        hw_i2c_complete_cb cb, void *cb_data, uint32_t flags)
+{
+        return start_transfer(id, data, len, NULL, 0, cb, cb_data, flags);
+}
+
+int hw_i2c_read_buffer_async(HW_I2C_ID id, uint8_t *data, uint16_t len,
+                                        hw_i2c_complete_cb cb, void *cb_data, uint32_t flags)
+{
+        return start_transfer(id, NULL, 0, data, len, cb, cb_data, flags);
+}
+
+int hw_i2c_write_then_read_async(HW_I2C_ID id, const uint8_t *w_data, uint16_t w_len,
+                                        uint8_t *r_data, uint16_t r_len, hw_i2c_complete_cb cb,
+                                        void *cb_data, uint32_t flags)
+{
+        return start_transfer(id, w_data, w_len, r_data, r_len, cb, cb_data, flags);
+}
+
+uint8_t *bus_mock_i2c_regs(HW_I2C_ID id)
+{
+        return get_i2c(id)->regs;
+}
+
+void bus_mock_i2c_nack_next(HW_I2C_ID id)
+{
+        get_i2c(id)->nack_next = true;
+}
@@ -0,0 +1,189 @@
+/**
+ ****************************************************************************************
+ *
+ * @file hw_spi_mock.c
+ *
+ * @brief SPI low level driver mock for the host (POSIX) build
+ *
+ * Copyright (C) 2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ ****************************************************************************************
+ */
+
+#include <string.h>
+#include <osal.h>
+#include "bus_mock.h"
+
+#define SPI_COUNT               2
+#define SPI_READ_BIT            0x80
+
+typedef struct {
+        bus_mock_irq_t irq;
+        HW_SPI_MODE role;
+        volatile bool busy;
+        /* Transfer in progress */
+        const uint8_t *out;
+        uint8_t *in;
+        uint16_t len;
+        hw_spi_tx_callback cb;
+        void *user_data;
+        /* Attached device */
+        uint8_t regs[BUS_MOCK_REGS];
+        uint8_t reg;
+        bool reg_pending;
+        bool reading;
+} spi_mock_t;
+
+static spi_mock_t spis[SPI_COUNT];
+
+static uint8_t spi_index(HW_SPI_ID id)
+{
+        uintptr_t index = (uintptr_t) id - 1;
+
+        OS_ASSERT(index < SPI_COUNT);
+
+        return index;
+}
+
+static spi_mock_t *get_spi(HW_SPI_ID id)
+{
+        return &spis[spi_index(id)];
+}
+
+/* One byte exchanged with the device, dummy bytes sent while reading are not stored */
+static uint8_t device_exchange(spi_mock_t *s, uint8_t mosi, bool dummy)
+{
+        uint8_t miso = 0xFF;
+
+        if (s->reg_pending) {
+                s->reg = mosi & ~SPI_READ_BIT;
+                s->reading = (mosi & SPI_READ_BIT) != 0;
+                s->reg_pending = false;
+        } else if (s->reading) {
+                miso = s->regs[s->reg];
+                s->reg = (s->reg + 1) % BUS_MOCK_REGS;
+        } else if (!dummy) {
+                s->regs[s->reg] = mosi;
+                s->reg = (s->reg + 1) % BUS_MOCK_REGS;
+        }
+
+        return miso;
+}
+
+static void transfer(spi_mock_t *s)
+{
+        uint16_t i;
+        uint8_t miso;
+
+        for (i = 0; i < s->len; i++) {
+                miso = device_exchange(s, s->out ? s->out[i] : 0, s->out == NULL);
+                if (s->in) {
+                        s->in[i] = miso;
+                }
+        }
+}
+
+static void transfer_irq(void *arg)
+{
+        spi_mock_t *s = arg;
+        hw_spi_tx_callback cb = s->cb;
+
+        transfer(s);
+
+        /* Like the driver, release the controller first so the callback can start a new transfer */
+        s->cb = NULL;
+        s->busy = false;
+        cb(s->user_data, s->len);
+}
+
+static void start_transfer(HW_SPI_ID id, const uint8_t *out, uint8_t *in, uint16_t len,
+                                                        hw_spi_tx_callback cb, void *user_data)
+{
+        spi_mock_t *s = get_spi(id);
+
+        OS_ASSERT(!s->busy);
+        bus_mock_trace_add(spi_index(id) + 1, !in ? BUS_MOCK_SPI_WRITE :
+                        out ? BUS_MOCK_SPI_WRITE_READ : BUS_MOCK_SPI_READ, len);
+
+        s->out = out;
+        s->in = in;
+        s->len = len;
+
+        if (cb == NULL) {
+                /* Blocking transfer */
+                transfer(s);
+                return;
+        }
+
+        s->cb = cb;
+        s->user_data = user_data;
+        s->busy = true;
+        bus_mock_irq_raise(&s->irq, transfer_irq, s);
+}
+
+void hw_spi_init(HW_SPI_ID id, const spi_config *cfg)
+{
+        get_spi(id)->role = cfg->smn_role;
+}
+
+void hw_spi_deinit(HW_SPI_ID id)
+{
+}
+
+void hw_spi_enable(HW_SPI_ID id, uint8_t on)
+{
+}
+
+bool hw_spi_is_occupied(const HW_SPI_ID id)
+{
+        return get_spi(id)->busy;
+}
+
+HW_SPI_MODE hw_spi_is_slave(HW_SPI_ID id)
+{
+        return get_spi(id)->role;
+}
+
+void hw_spi_set_cs_low(HW_SPI_ID id)
+{
+        spi_mock_t *s = get_spi(id);
+
+        bus_mock_trace_add(spi_index(id) + 1, BUS_MOCK_SPI_CS_LOW, 0);
+        s->reg_pending = true;
+        s->reading = false;
+}
+
+void hw_spi_set_cs_high(HW_SPI_ID id)
+{
+        bus_mock_trace_add(spi_index(id) + 1, BUS_MOCK_SPI_CS_HIGH, 0);
+}
+
+void hw_spi_wait_while_busy(HW_SPI_ID id)
+{
+        /* Transfers are complete when their callback is called */
+}
+
+void hw_spi_writeread_buf(HW_SPI_ID id, const uint8_t *out_buf, uint8_t *in_buf, uint16_t len,
+                                                        hw_spi_tx_callback cb, void *user_data)
+{
+        start_transfer(id, out_buf, in_buf, len, cb, user_data);
+}
+
+void hw_spi_write_buf(HW_SPI_ID id, const uint8_t *out_buf, uint16_t len,
+                                                        hw_spi_tx_callback cb, void *user_data)
+{
+        start_transfer(id, out_buf, NULL, len, cb, user_data);
+}
+
+void hw_spi_read_buf(HW_SPI_ID id, uint8_t *in_buf, uint16_t len,
+                                                        hw_spi_tx_callback cb, void *user_data)
+{
+        start_transfer(id, NULL, in_buf, len, cb, user_data);
+}
+
+uint8_t *bus_mock_spi_regs(HW_SPI_ID id)
+{
+        return get_spi(id)->regs;
+}
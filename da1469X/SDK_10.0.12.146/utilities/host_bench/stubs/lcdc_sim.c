@@ -0,0 +1,176 @@
+/**
+ ****************************************************************************************
+ *
+ * @file lcdc_sim.c
+ *
+ * @brief LCD controller and LCD simulator for the host (POSIX) build
+ *
+ * Copyright (C) 2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ ****************************************************************************************
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <osal.h>
+#include "bus_mock.h"
+#include "lcdc_sim.h"
+
+typedef struct {
+        uint16_t resx, resy;
+        HW_LCDC_LAYER_COLOR_MODE format;
+        uint8_t *mem;
+        lcdc_sim_stats_t stats;
+        bus_mock_irq_t irq;
+        /* Asynchronous transfer in progress */
+        volatile bool busy;
+        hw_lcdc_layer_t layer;
+        const hw_lcdc_frame_t *regions;
+        uint8_t count;
+        ad_lcdc_user_cb cb;
+        void *user_data;
+} lcdc_sim_t;
+
+static lcdc_sim_t sim;
+
+uint32_t hw_lcdc_stride_size(HW_LCDC_LAYER_COLOR_MODE format, uint16_t width)
+{
+        switch (format) {
+        case HW_LCDC_LCM_L1:
+                return (width + 7) / 8;
+        case HW_LCDC_LCM_L4:
+                return (width + 1) / 2;
+        case HW_LCDC_LCM_RGB332:
+        case HW_LCDC_LCM_L8:
+                return width;
+        case HW_LCDC_LCM_RGBA5551:
+        case HW_LCDC_LCM_RGB565:
+                return width * 2;
+        default:
+                return width * 4;
+        }
+}
+
+ad_lcdc_handle_t lcdc_sim_open(uint16_t resx, uint16_t resy, HW_LCDC_LAYER_COLOR_MODE format)
+{
+        OS_ASSERT(sim.mem == NULL);
+
+        sim.resx = resx;
+        sim.resy = resy;
+        sim.format = format;
+        sim.mem = calloc(resy, hw_lcdc_stride_size(format, resx));
+        OS_ASSERT(sim.mem);
+        memset(&sim.stats, 0, sizeof(sim.stats));
+
+        return &sim;
+}
+
+void lcdc_sim_close(ad_lcdc_handle_t handle)
+{
+        lcdc_sim_t *lcdc = handle;
+
+        OS_ASSERT(lcdc == &sim && !lcdc->busy);
+        free(lcdc->mem);
+        lcdc->mem = NULL;
+}
+
+const uint8_t *lcdc_sim_memory(ad_lcdc_handle_t handle)
+{
+        return ((lcdc_sim_t *)handle)->mem;
+}
+
+const lcdc_sim_stats_t *lcdc_sim_stats(ad_lcdc_handle_t handle)
+{
+        return &((lcdc_sim_t *)handle)->stats;
+}
+
+/* Offset of the byte holding pixel x in a line */
+static uint32_t lcdc_sim_offset(HW_LCDC_LAYER_COLOR_MODE format, uint16_t x)
+{
+        switch (format) {
+        case HW_LCDC_LCM_L1:
+                return x / 8;
+        case HW_LCDC_LCM_L4:
+                return x / 2;
+        default:
+                return hw_lcdc_stride_size(format, x);
+        }
+}
+
+/* Copy the regions from the layer to the LCD memory, as the LCD would receive them */
+static void lcdc_sim_transfer(lcdc_sim_t *lcdc, const hw_lcdc_layer_t *layer,
+                              const hw_lcdc_frame_t *regions, uint8_t count)
+{
+        const uint32_t lcd_stride = hw_lcdc_stride_size(lcdc->format, lcdc->resx);
+        const uint32_t stride = layer->stride ? layer->stride :
+                                                hw_lcdc_stride_size(layer->format, layer->resx);
+        const uint8_t *src = (const uint8_t *)layer->baseaddr;
+
+        OS_ASSERT(layer->format == lcdc->format && layer->startx == 0 && layer->starty == 0);
+
+        lcdc->stats.updates++;
+        for (uint8_t i = 0; i < count; i++) {
+                const hw_lcdc_frame_t *r = &regions[i];
+                /* Sub-byte formats are sent in whole bytes */
+                const uint32_t offset = lcdc_sim_offset(lcdc->format, r->startx);
+                const uint32_t len = hw_lcdc_stride_size(lcdc->format, r->endx + 1) - offset;
+                const uint32_t pixels = (r->endx - r->startx + 1) * (r->endy - r->starty + 1);
+
+                OS_ASSERT(r->startx <= r->endx && r->endx < lcdc->resx);
+                OS_ASSERT(r->starty <= r->endy && r->endy < lcdc->resy);
+
+                for (uint16_t y = r->starty; y <= r->endy; y++) {
+                        memcpy(&lcdc->mem[y * lcd_stride + offset], &src[y * stride + offset], len);
+                }
+
+                lcdc->stats.regions++;
+                lcdc->stats.pixels += pixels;
+                lcdc->stats.bytes += LCDC_SIM_REGION_CMD_BYTES + len * (r->endy - r->starty + 1);
+        }
+}
+
+int ad_lcdc_draw_regions(ad_lcdc_handle_t handle, const hw_lcdc_layer_t *layer,
+        const hw_lcdc_frame_t *regions, uint8_t count, OS_TICK_TIME timeout)
+{
+        lcdc_sim_t *lcdc = handle;
+
+        OS_ASSERT(lcdc == &sim && !lcdc->busy);
+        if (count) {
+                lcdc_sim_transfer(lcdc, layer, regions, count);
+        }
+
+        return AD_LCDC_ERROR_NONE;
+}
+
+static void lcdc_sim_irq(void *arg)
+{
+        lcdc_sim_t *lcdc = arg;
+        ad_lcdc_user_cb cb = lcdc->cb;
+
+        lcdc_sim_transfer(lcdc, &lcdc->layer, lcdc->regions, lcdc->count);
+        lcdc->busy = false;
+        cb(lcdc->user_data);
+}
+
+int ad_lcdc_draw_regions_async(ad_lcdc_handle_t handle, const hw_lcdc_layer_t *layer,
+        const hw_lcdc_frame_t *regions, uint8_t count, ad_lcdc_user_cb cb, void *user_data)
+{
+        lcdc_sim_t *lcdc = handle;
+
+        OS_ASSERT(lcdc == &sim && cb != NULL && count > 0);
+        if (lcdc->busy) {
+                return AD_LCDC_ERROR_CONTROLLER_BUSY;
+        }
+
+        lcdc->busy = true;
+        lcdc->layer = *layer;
+        lcdc->regions = regions;
+        lcdc->count = count;
+        lcdc->cb = cb;
+        lcdc->user_data = user_data;
+        bus_mock_irq_raise(&lcdc->irq, lcdc_sim_irq, lcdc);
+
+        return AD_LCDC_ERROR_NONE;
+}
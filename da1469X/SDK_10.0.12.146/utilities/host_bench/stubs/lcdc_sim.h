@@ -0,0 +1,67 @@
+/**
+ ****************************************************************************************
+ *
+ * @file lcdc_sim.h
+ *
+ * @brief LCD controller and LCD simulator for the host (POSIX) build
+ *
+ * stubs/lcdc_sim.c implements the region transfer functions of the LCDC adapter on a simulated
+ * LCD with its own pixel memory. Every transfer copies the regions from the layer memory to the
+ * LCD memory and is counted, so that the pixels and bytes sent to the LCD for an update trace can
+ * be measured and the displayed image can be checked. Asynchronous transfers complete in
+ * simulated interrupt context.
+ *
+ * Copyright (C) 2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ ****************************************************************************************
+ */
+
+#ifndef LCDC_SIM_H_
+#define LCDC_SIM_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <ad_lcdc.h>
+
+/* Bytes sent per region by a MIPI DBI type C LCD: column/page address and memory write commands */
+#define LCDC_SIM_REGION_CMD_BYTES       ( 11 )
+
+/**
+ * \brief Transfer counters
+ */
+typedef struct {
+        uint32_t updates;               /**< Calls of ad_lcdc_draw_regions(_async)(), TE waits */
+        uint32_t regions;               /**< Regions transferred */
+        uint64_t pixels;                /**< Pixels transferred */
+        uint64_t bytes;                 /**< Bytes transferred, pixels and commands */
+} lcdc_sim_stats_t;
+
+/**
+ * \brief Open a simulated LCD, its memory is cleared
+ *
+ * \param [in] resx horizontal resolution
+ * \param [in] resy vertical resolution
+ * \param [in] format pixel format of the LCD memory, same as the layers drawn to it
+ *
+ * \return handle to pass to the LCDC adapter functions
+ */
+ad_lcdc_handle_t lcdc_sim_open(uint16_t resx, uint16_t resy, HW_LCDC_LAYER_COLOR_MODE format);
+
+/**
+ * \brief Close a simulated LCD
+ */
+void lcdc_sim_close(ad_lcdc_handle_t handle);
+
+/**
+ * \brief Get the LCD memory, lines are hw_lcdc_stride_size() bytes
+ */
+const uint8_t *lcdc_sim_memory(ad_lcdc_handle_t handle);
+
+/**
+ * \brief Get the transfer counters
+ */
+const lcdc_sim_stats_t *lcdc_sim_stats(ad_lcdc_handle_t handle);
+
+#endif /* LCDC_SIM_H_ */
@@ -0,0 +1,56 @@
+/**
+ ****************************************************************************************
+ *
+ * @file sys_power_mgr_host.c
+ *
+ * @brief Power Manager stub for the host (POSIX) build
+ *
+ * The host never sleeps. Requests are only counted so that unbalanced request/release pairs
+ * are caught.
+ *
+ * Copyright (C) 2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ ****************************************************************************************
+ */
+
+#include <osal.h>
+#include <sys_power_mgr.h>
+
+#define MAX_ADAPTERS            ( 16 )
+
+static int active_requests;
+static const adapter_call_backs_t *adapters[MAX_ADAPTERS];
+static int adapter_count;
+
+void pm_sleep_mode_request(sleep_mode_t mode)
+{
+        OS_ENTER_CRITICAL_SECTION();
+        active_requests++;
+        OS_LEAVE_CRITICAL_SECTION();
+}
+
+void pm_sleep_mode_release(sleep_mode_t mode)
+{
+        OS_ENTER_CRITICAL_SECTION();
+        OS_ASSERT(active_requests > 0);
+        active_requests--;
+        OS_LEAVE_CRITICAL_SECTION();
+}
+
+pm_id_t pm_register_adapter(const adapter_call_backs_t *cb)
+{
+        OS_ASSERT(adapter_count < MAX_ADAPTERS);
+
+        adapters[adapter_count] = cb;
+
+        return adapter_count++;
+}
+
+void pm_unregister_adapter(pm_id_t id)
+{
+        OS_ASSERT(id < adapter_count);
+
+        adapters[id] = NULL;
+}
@@ -0,0 +1,409 @@
+/**
+ ****************************************************************************************
+ *
+ * @file uart_pty.c
+ *
+ * @brief pty backed UART for the host (POSIX) build
+ *
+ * Implements the subset of the UART LLD used by the middleware and the UART adapter on top of
+ * a pseudo terminal. Each UART gets a worker thread that performs the asynchronous transfers
+ * and calls the completion callbacks from simulated interrupt context (vPortEnterISR()), like
+ * the DMA/UART interrupt does on the target.
+ *
+ * Copyright (C) 2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ ****************************************************************************************
+ */
+
+#define _GNU_SOURCE
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <unistd.h>
+#include <osal.h>
+#include <ad_uart.h>
+#include "uart_pty.h"
+
+#define UART_COUNT              3
+#define RX_POLL_INTERVAL_MS     10
+
+typedef struct {
+        void *open_ref;                 /* Non-NULL while opened through ad_uart_open() */
+        HW_UART_ID id;
+        int master;
+        int slave;
+        char name[64];
+        pthread_t worker;
+        pthread_t drain;
+        pthread_mutex_t lock;
+        pthread_cond_t cond;
+        /* Asynchronous transmission */
+        const uint8_t *tx_buf;
+        uint16_t tx_len;
+        hw_uart_tx_callback tx_cb;
+        void *tx_user_data;
+        volatile bool tx_busy;
+        /* Asynchronous reception */
+        uint8_t *rx_buf;
+        uint16_t rx_len;
+        uint16_t rx_done;
+        hw_uart_rx_callback rx_cb;
+        void *rx_user_data;
+        bool rx_pending;
+        volatile uint32_t drained;
+} uart_pty_t;
+
+static uart_pty_t uarts[UART_COUNT];
+static pthread_mutex_t init_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static void write_all(int fd, const void *buf, size_t len)
+{
+        const uint8_t *p = buf;
+        ssize_t n;
+
+        while (len) {
+                n = write(fd, p, len);
+                if (n < 0) {
+                        if (errno == EINTR) {
+                                continue;
+                        }
+                        return;
+                }
+                p += n;
+                len -= n;
+        }
+}
+
+static void *drain_thread(void *arg)
+{
+        uart_pty_t *u = arg;
+        char buf[256];
+        ssize_t n;
+
+        for (;;) {
+                n = read(u->slave, buf, sizeof(buf));
+                if (n > 0) {
+                        __atomic_add_fetch(&u->drained, n, __ATOMIC_RELAXED);
+                } else if (n < 0 && errno != EINTR) {
+                        return NULL;
+                }
+        }
+}
+
+/* Called with u->lock held, returns true when the pending read request was completed */
+static bool receive_some(uart_pty_t *u)
+{
+        struct pollfd pfd = { .fd = u->master, .events = POLLIN };
+        uint8_t buf[256];
+        size_t len = MIN(sizeof(buf), (size_t) (u->rx_len - u->rx_done));
+        ssize_t n;
+
+        /* Read into a local buffer, the request may be aborted while the lock is released */
+        pthread_mutex_unlock(&u->lock);
+        n = poll(&pfd, 1, RX_POLL_INTERVAL_MS);
+        if (n > 0) {
+                n = read(u->master, buf, len);
+        }
+        pthread_mutex_lock(&u->lock);
+
+        if (!u->rx_pending) {
+                return false;
+        }
+        if (n > 0) {
+                memcpy(u->rx_buf + u->rx_done, buf, n);
+                u->rx_done += n;
+        }
+
+        return u->rx_done == u->rx_len;
+}
+
+static void *worker_thread(void *arg)
+{
+        uart_pty_t *u = arg;
+        hw_uart_tx_callback tx_cb;
+        hw_uart_rx_callback rx_cb;
+        void *user_data;
+        uint16_t len;
+
+        pthread_mutex_lock(&u->lock);
+        for (;;) {
+                while (!u->tx_cb && !u->rx_pending) {
+                        pthread_cond_wait(&u->cond, &u->lock);
+                }
+
+                if (u->tx_cb) {
+                        pthread_mutex_unlock(&u->lock);
+                        write_all(u->master, u->tx_buf, u->tx_len);
+                        pthread_mutex_lock(&u->lock);
+
+                        tx_cb = u->tx_cb;
+                        user_data = u->tx_user_data;
+                        len = u->tx_len;
+                        u->tx_cb = NULL;
+                        u->tx_busy = false;
+
+                        pthread_mutex_unlock(&u->lock);
+                        vPortEnterISR();
+                        tx_cb(user_data, len);
+                        vPortExitISR();
+                        pthread_mutex_lock(&u->lock);
+                }
+
+                if (u->rx_pending && receive_some(u)) {
+                        /*
+                         * Request can be aborted by the task until the interrupt is entered,
+                         * check again once the CPU is owned.
+                         */
+                        pthread_mutex_unlock(&u->lock);
+                        vPortEnterISR();
+                        pthread_mutex_lock(&u->lock);
+                        rx_cb = u->rx_pending ? u->rx_cb : NULL;
+                        user_data = u->rx_user_data;
+                        len = u->rx_done;
+                        u->rx_pending = false;
+                        pthread_mutex_unlock(&u->lock);
+                        if (rx_cb) {
+                                rx_cb(user_data, len);
+                        }
+                        vPortExitISR();
+                        pthread_mutex_lock(&u->lock);
+                }
+        }
+
+        return NULL;
+}
+
+static uart_pty_t *get_uart(HW_UART_ID id)
+{
+        uintptr_t index = (uintptr_t) id - 1;
+        uart_pty_t *u;
+        struct termios tio;
+
+        OS_ASSERT(index < UART_COUNT);
+        u = &uarts[index];
+
+        pthread_mutex_lock(&init_lock);
+        if (u->id) {
+                pthread_mutex_unlock(&init_lock);
+                return u;
+        }
+
+        u->id = id;
+        u->master = posix_openpt(O_RDWR | O_NOCTTY);
+        OS_ASSERT(u->master >= 0);
+        grantpt(u->master);
+        unlockpt(u->master);
+        ptsname_r(u->master, u->name, sizeof(u->name));
+
+        /* Raw mode, data must reach the other side unmodified */
+        u->slave = open(u->name, O_RDWR | O_NOCTTY);
+        OS_ASSERT(u->slave >= 0);
+        tcgetattr(u->slave, &tio);
+        cfmakeraw(&tio);
+        tcsetattr(u->slave, TCSANOW, &tio);
+
+        pthread_mutex_init(&u->lock, NULL);
+        pthread_cond_init(&u->cond, NULL);
+        pthread_create(&u->worker, NULL, worker_thread, u);
+
+        if (getenv(UART_PTY_ATTACH_ENV)) {
+                fprintf(stderr, "UART%u: %s\n", (unsigned) index + 1, u->name);
+        } else {
+                pthread_create(&u->drain, NULL, drain_thread, u);
+        }
+        pthread_mutex_unlock(&init_lock);
+
+        return u;
+}
+
+uint32_t uart_pty_get_drained(HW_UART_ID uart)
+{
+        return __atomic_load_n(&get_uart(uart)->drained, __ATOMIC_RELAXED);
+}
+
+const char *uart_pty_get_name(HW_UART_ID uart)
+{
+        uintptr_t index = (uintptr_t) uart - 1;
+
+        return (index < UART_COUNT && uarts[index].id) ? uarts[index].name : NULL;
+}
+
+/*
+ * UART LLD
+ */
+
+void hw_uart_init(HW_UART_ID uart, const uart_config *cfg)
+{
+        get_uart(uart);
+}
+
+HW_UART_CONFIG_ERR hw_uart_send(HW_UART_ID uart, const void *data, uint16_t len,
+                                                        hw_uart_tx_callback cb, void *user_data)
+{
+        uart_pty_t *u = get_uart(uart);
+
+        if (cb == NULL) {
+                /* Blocking transfer, the CPU is busy until the last byte is out */
+                write_all(u->master, data, len);
+                return HW_UART_CONFIG_ERR_NOERR;
+        }
+
+        pthread_mutex_lock(&u->lock);
+        OS_ASSERT(!u->tx_busy);
+        u->tx_buf = data;
+        u->tx_len = len;
+        u->tx_user_data = user_data;
+        u->tx_cb = cb;
+        u->tx_busy = true;
+        pthread_cond_broadcast(&u->cond);
+        pthread_mutex_unlock(&u->lock);
+
+        return HW_UART_CONFIG_ERR_NOERR;
+}
+
+bool hw_uart_is_busy(HW_UART_ID uart)
+{
+        return get_uart(uart)->tx_busy;
+}
+
+static void hw_uart_receive(uart_pty_t *u, void *data, uint16_t len, hw_uart_rx_callback cb,
+                                                                                void *user_data)
+{
+        pthread_mutex_lock(&u->lock);
+        OS_ASSERT(!u->rx_pending);
+        u->rx_buf = data;
+        u->rx_len = len;
+        u->rx_done = 0;
+        u->rx_cb = cb;
+        u->rx_user_data = user_data;
+        u->rx_pending = true;
+        pthread_cond_broadcast(&u->cond);
+        pthread_mutex_unlock(&u->lock);
+}
+
+static uint16_t hw_uart_abort_receive(uart_pty_t *u)
+{
+        uint16_t done;
+
+        /* Not waiting for the worker here, it may need the CPU to complete a transmission */
+        pthread_mutex_lock(&u->lock);
+        u->rx_pending = false;
+        done = u->rx_done;
+        pthread_mutex_unlock(&u->lock);
+
+        return done;
+}
+
+/*
+ * UART adapter
+ */
+
+typedef struct {
+        OS_EVENT event;
+        uint16_t transferred;
+} sync_cb_data_t;
+
+static void sync_cb(void *user_data, uint16_t transferred)
+{
+        sync_cb_data_t *data = user_data;
+
+        data->transferred = transferred;
+        OS_EVENT_SIGNAL_FROM_ISR(data->event);
+}
+
+void ad_uart_init(void)
+{
+}
+
+ad_uart_handle_t ad_uart_open(const ad_uart_controller_conf_t *ad_uart_ctrl_conf)
+{
+        uart_pty_t *u = get_uart(ad_uart_ctrl_conf->id);
+
+        u->open_ref = u;
+
+        return u;
+}
+
+int ad_uart_close(ad_uart_handle_t handle, bool force)
+{
+        uart_pty_t *u = handle;
+
+        if (!force && (u->tx_busy || u->rx_pending)) {
+                return AD_UART_ERROR_CONTROLLER_BUSY;
+        }
+        if (u->rx_pending) {
+                hw_uart_abort_receive(u);
+        }
+        u->open_ref = NULL;
+
+        return AD_UART_ERROR_NONE;
+}
+
+int ad_uart_reconfig(ad_uart_handle_t handle, const ad_uart_driver_conf_t *ad_drv)
+{
+        return AD_UART_ERROR_NONE;
+}
+
+int ad_uart_write(ad_uart_handle_t handle, const char *wbuf, size_t wlen)
+{
+        uart_pty_t *u = handle;
+
+        write_all(u->master, wbuf, wlen);
+
+        return AD_UART_ERROR_NONE;
+}
+
+int ad_uart_read(ad_uart_handle_t handle, char *rbuf, size_t rlen, OS_TICK_TIME timeout)
+{
+        uart_pty_t *u = handle;
+        sync_cb_data_t data = { 0 };
+
+        OS_EVENT_CREATE(data.event);
+        hw_uart_receive(u, rbuf, rlen, sync_cb, &data);
+        if (OS_EVENT_WAIT(data.event, timeout) != OS_EVENT_SIGNALED) {
+                data.transferred = hw_uart_abort_receive(u);
+        }
+        OS_EVENT_DELETE(data.event);
+
+        return data.transferred;
+}
+
+int ad_uart_write_async(ad_uart_handle_t handle, const char *wbuf, size_t wlen,
+                          ad_uart_user_cb cb, void *user_data)
+{
+        uart_pty_t *u = handle;
+
+        hw_uart_send(u->id, wbuf, wlen, cb, user_data);
+
+        return AD_UART_ERROR_NONE;
+}
+
+int ad_uart_read_async(ad_uart_handle_t handle, char *rbuf, size_t rlen, ad_uart_user_cb cb,
+                         void *user_data)
+{
+        hw_uart_receive(handle, rbuf, rlen, cb, user_data);
+
+        return AD_UART_ERROR_NONE;
+}
+
+HW_UART_ID ad_uart_get_hw_uart_id(ad_uart_handle_t handle)
+{
+        return ((uart_pty_t *) handle)->id;
+}
+
+int ad_uart_complete_async_read(ad_uart_handle_t handle)
+{
+        return hw_uart_abort_receive(handle);
+}
+
+int ad_uart_io_config(HW_UART_ID id, const ad_uart_io_conf_t *io, AD_IO_CONF_STATE state)
+{
+        return AD_UART_ERROR_NONE;
+}
@@ -0,0 +1,50 @@
+/**
+ ****************************************************************************************
+ *
+ * @file uart_pty.h
+ *
+ * @brief pty backed UART for the host (POSIX) build
+ *
+ * Copyright (C) 2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ ****************************************************************************************
+ */
+
+#ifndef UART_PTY_H_
+#define UART_PTY_H_
+
+#include <stdint.h>
+#include "hw_uart.h"
+
+/**
+ * \brief Environment variable selecting how the slave side of the pty is handled
+ *
+ * When not set, the slave side is opened and drained by the UART module itself (data sent is
+ * counted and discarded). When set, the slave name is printed and data is left for an external
+ * program (e.g. a terminal or a DGTL host tool) to consume.
+ */
+#define UART_PTY_ATTACH_ENV     "HOST_BENCH_UART_ATTACH"
+
+/**
+ * \brief Get number of bytes sent by the firmware that reached the other side of the pty
+ *
+ * Only counted when the pty is drained internally.
+ *
+ * \param [in] uart UART id
+ *
+ * \return number of bytes drained
+ */
+uint32_t uart_pty_get_drained(HW_UART_ID uart);
+
+/**
+ * \brief Get name of the slave side of the pty
+ *
+ * \param [in] uart UART id
+ *
+ * \return device name, NULL if UART was never used
+ */
+const char *uart_pty_get_name(HW_UART_ID uart);
+
+#endif /* UART_PTY_H_ */
@@ -0,0 +1,294 @@
+#!/usr/bin/env python
+
+#########################################################################################
+# Copyright (C) 2022 Dialog Semiconductor.
+# This computer program includes Confidential, Proprietary Information
+# of Dialog Semiconductor. All Rights Reserved.
+#########################################################################################
+
+# Decoder of the sleep analytics stream (sdk/middleware/monitoring/sleep_analytics.h).
+#
+# Capture the UART (or the RTT channel) of the analytics to a file, e.g.
+#   JLinkRTTLogger -Device DA14699 -If SWD -Speed 4000 -RTTChannel 2 sleep.bin
+# and run
+#   python sleep_analytics_decode.py sleep.bin --sleep-ua 10 --active-ua 3000
+#
+# The currents default to rough placeholders, measure the board for a real energy budget.
+
+from __future__ import print_function
+import argparse
+import struct
+import sys
+
+FORMAT_VERSION = 1
+PDC_LUT_SIZE = 16
+HIST_BUCKETS = 16
+
+REC_HELLO = 0x01
+REC_PDC_LUT = 0x02
+REC_PERIOD = 0x10
+REC_EVENT = 0x11
+
+STATE_TICK = 0
+STATE_IDLE = 1
+STATE_SLEEP = 2
+STATE_NAMES = ['tick', 'idle', 'sleep']
+
+MODE_NAMES = ['active', 'idle', 'extended sleep', 'deep sleep', 'hibernation']
+
+AWAKE_MODE = 1
+AWAKE_WAKEUP_TIME = 7
+AWAKE_DEFERRED = 8
+AWAKE_PREP_TIME = 9
+AWAKE_VETO = 12
+AWAKE_IRQ_PENDING = 13
+AWAKE_NAMES = ['none', 'sleep mode', 'flash operation', 'TRNG', 'debugger', 'watchdog',
+               'tick late', 'wake-up time', 'deferred', 'preparation time', 'too short', 'DMA',
+               'vetoed', 'IRQ pending', 'sleep aborted']
+
+PDC_PERIPH_NAMES = ['timer', 'OS timer', 'timer3', 'timer4', 'RTC alarm', 'RTC timer',
+                    'MAC timer', 'motor ctrl', 'XTAL32M ready', 'RF diag',
+                    'combo (CMAC/VBUS/JTAG/debounce)', 'SNC']
+
+
+def pdc_entry_name(entry):
+    select = entry & 0x3
+    trig_id = (entry >> 2) & 0x1f
+    if select == 0:
+        return 'P0_%02d' % trig_id
+    if select == 1:
+        return 'P1_%02d' % trig_id
+    if select == 2:
+        if trig_id < len(PDC_PERIPH_NAMES):
+            return PDC_PERIPH_NAMES[trig_id]
+        return 'peripheral %d' % trig_id
+    return 'software'
+
+
+class Analytics(object):
+    def __init__(self, currents, voltage, adapters):
+        self.lp_hz = 32768
+        self.pdc_lut = [0] * PDC_LUT_SIZE
+        self.events = []
+        self.dropped = 0
+        self.currents = currents
+        self.voltage = voltage
+        self.adapters = adapters
+
+    def seconds(self, cycles):
+        return float(cycles) / self.lp_hz
+
+    def us(self, cycles):
+        return cycles * 1e6 / self.lp_hz
+
+    def energy_uj(self, current_ua, cycles):
+        return current_ua * self.seconds(cycles) * self.voltage
+
+    def wake_source(self, pending):
+        names = [pdc_entry_name(self.pdc_lut[i]) for i in range(PDC_LUT_SIZE)
+                 if pending & (1 << i) and self.pdc_lut[i]]
+        return ' + '.join(sorted(set(names))) if names else 'unknown'
+
+    def adapter_name(self, adapter_id):
+        return self.adapters.get(adapter_id, 'adapter %d' % adapter_id)
+
+    def reason_name(self, reason, detail):
+        name = AWAKE_NAMES[reason] if reason < len(AWAKE_NAMES) else '#%d' % reason
+        if reason == AWAKE_MODE:
+            return '%s (%s)' % (name, MODE_NAMES[detail] if detail < len(MODE_NAMES) else detail)
+        if reason in (AWAKE_DEFERRED, AWAKE_PREP_TIME, AWAKE_VETO):
+            return '%s (%s)' % (name, self.adapter_name(detail))
+        if reason == AWAKE_IRQ_PENDING:
+            return '%s (IRQ %d)' % (name, detail)
+        if reason == AWAKE_WAKEUP_TIME and detail:
+            return '%s (XTAL32M settling)' % name
+        return name
+
+    def sleep_current(self, mode):
+        if mode == 3:
+            return self.currents['deep_sleep']
+        if mode == 4:
+            return self.currents['hibernation']
+        return self.currents['sleep']
+
+    def record(self, rec_type, payload):
+        if rec_type == REC_HELLO:
+            version, self.lp_hz, _ = struct.unpack_from('<BIH', payload)
+            if version != FORMAT_VERSION:
+                sys.exit('Unsupported format version %d' % version)
+        elif rec_type == REC_PDC_LUT:
+            self.pdc_lut = list(struct.unpack_from('<%dI' % PDC_LUT_SIZE, payload))
+        elif rec_type == REC_PERIOD:
+            _, dropped = struct.unpack_from('<IH', payload)
+            self.dropped += dropped
+        elif rec_type == REC_EVENT:
+            self.events.append(struct.unpack_from('<IIIHHHHBBBB', payload))
+
+    def parse(self, data):
+        pos = 0
+        while pos + 2 <= len(data):
+            rec_type = data[pos]
+            length = data[pos + 1]
+            if pos + 2 + length > len(data):
+                break
+            self.record(rec_type, data[pos + 2:pos + 2 + length])
+            pos += 2 + length
+
+    def bucket_label(self, i):
+        if i == 0:
+            return '0'
+        if i == HIST_BUCKETS - 1:
+            return '>= %.0fus' % self.us(1 << (i - 1))
+        return '< %.0fus' % self.us(1 << i)
+
+    def report(self):
+        if len(self.events) < 2:
+            print('%d events, %d dropped, nothing to report' % (len(self.events), self.dropped))
+            return
+
+        residency = {}
+        sources = {}
+        reasons = {}
+        budget = {'sleep': 0.0, 'idle': 0.0, 'wake-up': 0.0, 'active': 0.0}
+        hist = [0] * HIST_BUCKETS
+        total = 0
+
+        # The last event has no successor to bound its active time
+        for ev, nxt in zip(self.events, self.events[1:]):
+            (timestamp, duration, active, latency, xtal_wait, pending, count, state, mode,
+             reason, detail) = ev
+            span = (nxt[0] - timestamp) & 0xffffffff
+            after = span - duration - active
+            if after < 0 or span > 0x7fffffff:
+                # Lost events in between
+                continue
+            total += span
+
+            key = (state, mode)
+            res = residency.setdefault(key, [0, 0])
+            res[0] += count
+            res[1] += duration
+
+            active_uj = self.energy_uj(self.currents['active'], active + after)
+            budget['active'] += active_uj
+
+            if state == STATE_SLEEP:
+                asleep = max(duration - latency, 0)
+                sleep_uj = self.energy_uj(self.sleep_current(mode), asleep)
+                wake_uj = self.energy_uj(self.currents['wakeup'], latency)
+                budget['sleep'] += sleep_uj
+                budget['wake-up'] += wake_uj
+
+                src = sources.setdefault(self.wake_source(pending), [0, 0, 0, 0, 0.0])
+                src[0] += 1
+                src[1] += latency
+                src[2] = max(src[2], latency)
+                src[3] += xtal_wait
+                src[4] += wake_uj + active_uj
+
+                bucket = latency.bit_length() if latency else 0
+                hist[min(bucket, HIST_BUCKETS - 1)] += 1
+            else:
+                current = self.currents['idle' if state == STATE_IDLE else 'tick']
+                idle_uj = self.energy_uj(current, duration)
+                budget['idle'] += idle_uj
+
+                rsn = reasons.setdefault(self.reason_name(reason, detail), [0, 0, 0.0, 0.0])
+                rsn[0] += count
+                rsn[1] += duration
+                rsn[2] += idle_uj + active_uj
+                rsn[3] += self.energy_uj(current - self.currents['sleep'], duration)
+
+        seconds = self.seconds(total)
+        energy = sum(budget.values())
+        print('%d events, %.1f s, %d events dropped' % (len(self.events), seconds, self.dropped))
+        if total == 0:
+            return
+        print('Average current %.1f uA, %.1f uJ' % (energy / seconds / self.voltage, energy))
+
+        print('')
+        print('Residency:')
+        for key in sorted(residency):
+            state, mode = key
+            passes, cycles = residency[key]
+            print('  %-6s %-16s %8d %10.3f s %7.2f %%' % (
+                STATE_NAMES[state], MODE_NAMES[mode] if mode < len(MODE_NAMES) else mode, passes,
+                self.seconds(cycles), 100.0 * cycles / total))
+
+        print('')
+        print('Energy budget:')
+        for name in ['sleep', 'idle', 'wake-up', 'active']:
+            print('  %-8s %12.1f uJ %7.2f %%' % (name, budget[name],
+                                                 100.0 * budget[name] / energy if energy else 0))
+
+        print('')
+        print('Wake-up sources (energy of the wake-up and the activity that follows):')
+        print('  %-36s %8s %10s %10s %10s %12s %7s' % ('Source', 'Count', 'Latency', 'Max',
+                                                        'XTAL wait', 'Energy', '%'))
+        for name in sorted(sources, key=lambda n: -sources[n][4]):
+            n, lat, lat_max, xtal, uj = sources[name]
+            print('  %-36s %8d %8.0fus %8.0fus %8.0fus %10.1fuJ %7.2f' % (
+                name, n, self.us(lat) / n, self.us(lat_max), self.us(xtal) / n, uj,
+                100.0 * uj / energy if energy else 0))
+
+        print('')
+        print('Stay-awake reasons (excess: energy above sleeping for the same time):')
+        print('  %-36s %8s %12s %12s %12s' % ('Reason', 'Passes', 'Time', 'Energy', 'Excess'))
+        for name in sorted(reasons, key=lambda n: -reasons[n][3]):
+            n, cycles, uj, excess = reasons[name]
+            print('  %-36s %8d %10.3f s %10.1fuJ %10.1fuJ' % (name, n, self.seconds(cycles),
+                                                              uj, excess))
+
+        if sum(hist):
+            print('')
+            print('Wake-up latency:')
+            scale = max(hist)
+            for i in range(HIST_BUCKETS):
+                if hist[i] == 0:
+                    continue
+                bar = '#' * int(40 * hist[i] / scale)
+                print('  %12s %8d %s' % (self.bucket_label(i), hist[i], bar))
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Decode sleep analytics stream')
+    parser.add_argument('file', help='binary capture of the sleep analytics UART or RTT channel')
+    parser.add_argument('--voltage', type=float, default=3.0, help='supply voltage (V)')
+    parser.add_argument('--active-ua', type=float, default=3000, help='current while active')
+    parser.add_argument('--idle-ua', type=float, default=1500,
+                        help='current in WFI with the tick stopped and clocks lowered')
+    parser.add_argument('--tick-ua', type=float, help='current in WFI with the tick running, '
+                        'default same as --idle-ua')
+    parser.add_argument('--wakeup-ua', type=float, default=2000,
+                        help='current from wake-up until the system clock is ready')
+    parser.add_argument('--sleep-ua', type=float, default=10, help='current in extended sleep')
+    parser.add_argument('--deep-sleep-ua', type=float, help='default same as --sleep-ua')
+    parser.add_argument('--hibernation-ua', type=float, help='default same as --sleep-ua')
+    parser.add_argument('--adapter', action='append', default=[], metavar='ID=NAME',
+                        help='name of a power manager adapter id, may be repeated')
+    args = parser.parse_args()
+
+    currents = {
+        'active': args.active_ua,
+        'idle': args.idle_ua,
+        'tick': args.tick_ua if args.tick_ua is not None else args.idle_ua,
+        'wakeup': args.wakeup_ua,
+        'sleep': args.sleep_ua,
+        'deep_sleep': args.deep_sleep_ua if args.deep_sleep_ua is not None else args.sleep_ua,
+        'hibernation': args.hibernation_ua if args.hibernation_ua is not None else args.sleep_ua,
+    }
+    adapters = {}
+    for item in args.adapter:
+        adapter_id, _, name = item.partition('=')
+        adapters[int(adapter_id)] = name
+
+    with open(args.file, 'rb') as f:
+        data = bytearray(f.read())
+
+    analytics = Analytics(currents, args.voltage, adapters)
+    analytics.parse(data)
+    analytics.report()
+
+
+if __name__ == '__main__':
+    main()
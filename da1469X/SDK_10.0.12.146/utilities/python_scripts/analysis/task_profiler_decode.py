@@ -0,0 +1,190 @@
+#!/usr/bin/env python
+
+#########################################################################################
+# Copyright (C) 2022 Dialog Semiconductor.
+# This computer program includes Confidential, Proprietary Information
+# of Dialog Semiconductor. All Rights Reserved.
+#########################################################################################
+
+# Decoder of the task profiler stream (sdk/middleware/monitoring/task_profiler.h).
+#
+# Capture the RTT channel of the profiler to a file, e.g.
+#   JLinkRTTLogger -Device DA14699 -If SWD -Speed 4000 -RTTChannel 1 profile.bin
+# and run
+#   python task_profiler_decode.py profile.bin
+
+from __future__ import print_function
+import argparse
+import struct
+import sys
+
+FORMAT_VERSION = 1
+HIST_BUCKETS = 16
+
+REC_HELLO = 0x01
+REC_TASK_INFO = 0x02
+REC_QUEUE_INFO = 0x03
+REC_PERIOD = 0x10
+REC_TASK_TIME = 0x11
+REC_QUEUE_HIST = 0x12
+
+QUEUE_HIST_NAMES = ['wait', 'response']
+PM_NAMES = ['idle (mode)', 'idle (tick)', 'idle (blocked)', 'sleep', 'sleep aborted',
+            'sleep vetoed']
+TASK_STATES = ['running', 'ready', 'blocked', 'suspended', 'deleted', 'invalid']
+
+
+class Profile(object):
+    def __init__(self):
+        self.counter_hz = 32768
+        self.period_ms = 0
+        self.tasks = {}
+        self.queues = {}
+        self.elapsed = 0
+        self.periods = 0
+        self.isr_seconds = 0.0
+        self.isr_count = 0
+        self.pm = [0] * len(PM_NAMES)
+        self.dropped = 0
+        self.run_time = {}
+        self.max_period_load = {}
+        self.stack_free = {}
+        self.state = {}
+        self.hists = {}
+        self.hist_max = {}
+        self.period_run_time = {}
+        self.period_elapsed = 0
+
+    def task_name(self, number):
+        return self.tasks.get(number, ('#%d' % number, 0))[0]
+
+    def queue_name(self, qid):
+        return self.queues.get(qid, '#%d' % qid)
+
+    def ticks_to_us(self, ticks):
+        return ticks * 1e6 / self.counter_hz
+
+    def end_period(self):
+        if self.period_elapsed == 0:
+            return
+        for number, run_time in self.period_run_time.items():
+            load = 100.0 * run_time / self.period_elapsed
+            if load > self.max_period_load.get(number, 0):
+                self.max_period_load[number] = load
+        self.period_run_time = {}
+
+    def record(self, rec_type, payload):
+        if rec_type == REC_HELLO:
+            version, self.counter_hz, self.period_ms = struct.unpack_from('<BIH', payload)
+            if version != FORMAT_VERSION:
+                sys.exit('Unsupported format version %d' % version)
+        elif rec_type == REC_TASK_INFO:
+            number, priority = struct.unpack_from('<BB', payload)
+            self.tasks[number] = (payload[2:].decode('ascii', 'replace'), priority)
+        elif rec_type == REC_QUEUE_INFO:
+            self.queues[payload[0]] = payload[1:].decode('ascii', 'replace')
+        elif rec_type == REC_PERIOD:
+            values = struct.unpack_from('<IIIII7H', payload)
+            _, elapsed, isr_cycles, isr_count, cpu_hz = values[:5]
+            self.end_period()
+            self.period_elapsed = elapsed
+            self.elapsed += elapsed
+            self.periods += 1
+            if cpu_hz:
+                self.isr_seconds += float(isr_cycles) / cpu_hz
+            self.isr_count += isr_count
+            for i in range(len(PM_NAMES)):
+                self.pm[i] += values[5 + i]
+            self.dropped += values[11]
+        elif rec_type == REC_TASK_TIME:
+            number, state, run_time, stack_free = struct.unpack_from('<BBIH', payload)
+            self.run_time[number] = self.run_time.get(number, 0) + run_time
+            self.period_run_time[number] = self.period_run_time.get(number, 0) + run_time
+            self.state[number] = state
+            if number not in self.stack_free or stack_free < self.stack_free[number]:
+                self.stack_free[number] = stack_free
+        elif rec_type == REC_QUEUE_HIST:
+            qid, kind, max_ticks = struct.unpack_from('<BBI', payload)
+            buckets = struct.unpack_from('<%dH' % HIST_BUCKETS, payload, 6)
+            key = (qid, kind)
+            hist = self.hists.setdefault(key, [0] * HIST_BUCKETS)
+            for i in range(HIST_BUCKETS):
+                hist[i] += buckets[i]
+            self.hist_max[key] = max(self.hist_max.get(key, 0), max_ticks)
+
+    def parse(self, data):
+        pos = 0
+        while pos + 2 <= len(data):
+            rec_type = data[pos]
+            length = data[pos + 1]
+            if pos + 2 + length > len(data):
+                break
+            self.record(rec_type, data[pos + 2:pos + 2 + length])
+            pos += 2 + length
+        self.end_period()
+
+    def bucket_label(self, i):
+        if i == 0:
+            return '0'
+        upper = self.ticks_to_us(1 << i)
+        if i == HIST_BUCKETS - 1:
+            return '>= %.0fus' % self.ticks_to_us(1 << (i - 1))
+        return '< %.0fus' % upper
+
+    def report(self):
+        seconds = float(self.elapsed) / self.counter_hz
+        print('%d periods, %.1f s, %d records dropped' % (self.periods, seconds, self.dropped))
+        if self.elapsed == 0:
+            return
+
+        print('')
+        print('%-16s %4s %8s %8s %10s %10s' % ('Task', 'Prio', 'CPU %', 'Peak %', 'Stack free',
+                                               'State'))
+        for number in sorted(self.run_time, key=lambda n: -self.run_time[n]):
+            state = self.state.get(number, len(TASK_STATES) - 1)
+            print('%-16s %4d %8.2f %8.2f %10d %10s' % (
+                self.task_name(number), self.tasks.get(number, ('', 0))[1],
+                100.0 * self.run_time[number] / self.elapsed,
+                self.max_period_load.get(number, 0), self.stack_free.get(number, 0),
+                TASK_STATES[min(state, len(TASK_STATES) - 1)]))
+
+        print('')
+        print('Interrupts: %d, %.3f%% of time (included in the interrupted task above)' % (
+            self.isr_count, 100.0 * self.isr_seconds / seconds))
+
+        print('')
+        print('Power manager:')
+        for name, count in zip(PM_NAMES, self.pm):
+            print('  %-16s %10d %10.1f/s' % (name, count, count / seconds))
+
+        for key in sorted(self.hists):
+            qid, kind = key
+            hist = self.hists[key]
+            total = sum(hist)
+            print('')
+            print('Queue %s, %s time: %d samples, max %.0fus' % (
+                self.queue_name(qid), QUEUE_HIST_NAMES[kind], total,
+                self.ticks_to_us(self.hist_max[key])))
+            scale = max(hist)
+            for i in range(HIST_BUCKETS):
+                if hist[i] == 0:
+                    continue
+                bar = '#' * int(40 * hist[i] / scale)
+                print('  %12s %8d %s' % (self.bucket_label(i), hist[i], bar))
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Decode task profiler RTT stream')
+    parser.add_argument('file', help='binary capture of the profiler RTT channel')
+    args = parser.parse_args()
+
+    with open(args.file, 'rb') as f:
+        data = bytearray(f.read())
+
+    profile = Profile()
+    profile.parse(data)
+    profile.report()
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,196 @@
+/**
+ ****************************************************************************************
+ *
+ * @file senis_asm.h
+ *
+ * @brief Host SeNIS compiler
+ *
+ * Builds uCode in the System RAM of the SNC simulator (snc_sim.h), with the same instruction
+ * encoding as the SeNIS framework (sdk/bsp/snc/src/SeNIS_macros.h, _SENIS_B_* macros). Operands
+ * are addresses in the simulated address space, given as SA_DA(addr) for direct addressing,
+ * SA_IA(addr) for indirect addressing (addr holds the address to use) and SA_L(label) for a
+ * label, like da(), ia() and l() in SeNIS.
+ *
+ * Usage:
+ * \code{.c}
+ * senis_asm_t a;
+ * uint32_t var = snc_sim_alloc(4);
+ * SENIS_ASM_LABEL loop;
+ *
+ * senis_asm_init(&a, 64);
+ * loop = senis_asm_label(&a);
+ * senis_asm_inc1(&a, var);
+ * senis_asm_rdcbi(&a, var, 3);
+ * senis_asm_cobr_eq(&a, SA_L(loop));
+ * senis_asm_slp(&a);
+ * senis_asm_end(&a);
+ * snc_sim_run(a.base, 0);
+ * \endcode
+ *
+ * Copyright (C) 2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ ****************************************************************************************
+ */
+
+#ifndef SENIS_ASM_H_
+#define SENIS_ASM_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define SENIS_ASM_MAX_LABELS    ( 64 )
+#define SENIS_ASM_MAX_FIXUPS    ( 128 )
+
+/**
+ * \brief SeNIS opcodes, same as SENIS_OPCODE_TYPE of snc.h
+ */
+typedef enum {
+        SENIS_OP_NOP,
+        SENIS_OP_WADAD,
+        SENIS_OP_WADVA,
+        SENIS_OP_TOBRE,
+        SENIS_OP_RDCBI,
+        SENIS_OP_RDCGR,
+        SENIS_OP_COBR,
+        SENIS_OP_INC,
+        SENIS_OP_DEL,
+        SENIS_OP_SLP,
+} SENIS_OPCODE_TYPE;
+
+/**
+ * \brief SeNIS instruction flags, same as SENIS_FLAG_TYPE of snc.h
+ */
+typedef enum {
+        SENIS_FLAG_DA1  = (1 << 27),
+        SENIS_FLAG_InA2 = (1 << 26),
+        SENIS_FLAG_REG  = (1 << 19),
+        SENIS_FLAG_INC4 = (1 << 19),
+} SENIS_FLAG_TYPE;
+
+#define SENIS_ADDR_MASK         ( 0x7FFFF )
+
+/**
+ * \brief Operand addressing
+ */
+typedef enum {
+        SA_DIRECT,
+        SA_INDIRECT,
+        SA_LABEL,
+} SA_OPER_TYPE;
+
+typedef struct {
+        SA_OPER_TYPE type;
+        uint32_t addr;                  /**< Address, or label for SA_LABEL */
+} sa_oper_t;
+
+#define SA_DA(_addr)    ((sa_oper_t) { SA_DIRECT, (_addr) })
+#define SA_IA(_addr)    ((sa_oper_t) { SA_INDIRECT, (_addr) })
+#define SA_L(_label)    ((sa_oper_t) { SA_LABEL, (_label) })
+
+typedef uint32_t SENIS_ASM_LABEL;
+
+/**
+ * \brief uCode under construction
+ */
+typedef struct {
+        uint32_t base;                  /**< Address of the first instruction */
+        uint32_t size;                  /**< Capacity in words */
+        uint32_t len;                   /**< Words emitted */
+        uint32_t labels[SENIS_ASM_MAX_LABELS];  /**< Label addresses, 0 if not placed */
+        uint32_t label_count;
+        struct {
+                uint32_t addr;          /**< Word to patch */
+                SENIS_ASM_LABEL label;
+        } fixups[SENIS_ASM_MAX_FIXUPS];
+        uint32_t fixup_count;
+        uint32_t consts;                /**< Constants 0 and 1, like snc_const[] */
+        bool error;                     /**< Capacity exceeded or label not placed */
+} senis_asm_t;
+
+/**
+ * \brief Start uCode, allocating its space in System RAM
+ *
+ * \param [in] a uCode
+ * \param [in] size capacity in words
+ */
+void senis_asm_init(senis_asm_t *a, uint32_t size);
+
+/**
+ * \brief Finish uCode, resolving label references
+ *
+ * \return false if the uCode did not fit or a label was not placed
+ */
+bool senis_asm_end(senis_asm_t *a);
+
+/**
+ * \brief Create label placed at the current position
+ */
+SENIS_ASM_LABEL senis_asm_label(senis_asm_t *a);
+
+/**
+ * \brief Create label to be placed later with senis_asm_place()
+ */
+SENIS_ASM_LABEL senis_asm_label_new(senis_asm_t *a);
+
+/**
+ * \brief Place label at the current position
+ */
+void senis_asm_place(senis_asm_t *a, SENIS_ASM_LABEL label);
+
+/*
+ * SeNIS commands, see SeNIS.h
+ */
+void senis_asm_nop(senis_asm_t *a);
+void senis_asm_wadad(senis_asm_t *a, sa_oper_t dst, sa_oper_t src);
+void senis_asm_wadva(senis_asm_t *a, sa_oper_t dst, uint32_t value);
+void senis_asm_tobre(senis_asm_t *a, uint32_t addr, uint32_t mask);
+void senis_asm_rdcbi(senis_asm_t *a, uint32_t addr, uint8_t bit_pos);
+void senis_asm_rdcgr(senis_asm_t *a, uint32_t addr, uint32_t gt_addr);
+void senis_asm_cobr_eq(senis_asm_t *a, sa_oper_t target);
+void senis_asm_cobr_gr(senis_asm_t *a, sa_oper_t target);
+void senis_asm_cobr_loop(senis_asm_t *a, sa_oper_t target, uint8_t cnt);
+void senis_asm_inc1(senis_asm_t *a, uint32_t addr);
+void senis_asm_inc4(senis_asm_t *a, uint32_t addr);
+void senis_asm_del(senis_asm_t *a, uint8_t ticks);
+void senis_asm_slp(senis_asm_t *a);
+
+/*
+ * Constructs built from SeNIS commands, like their SENIS_xxx() counterparts
+ */
+
+/**
+ * \brief Unconditional branch, as SENIS_goto()
+ */
+void senis_asm_goto(senis_asm_t *a, sa_oper_t target);
+
+/**
+ * \brief Wait until a register bit has a value, polling it
+ *
+ * \param [in] a uCode
+ * \param [in] addr register address
+ * \param [in] bit_pos bit position
+ * \param [in] set true to wait until the bit is set, false until it is cleared
+ */
+void senis_asm_wait_bit(senis_asm_t *a, uint32_t addr, uint8_t bit_pos, bool set);
+
+/**
+ * \brief Raise interrupt to CM33, as SNC_CM33_NOTIFY()
+ */
+void senis_asm_cm33_notify(senis_asm_t *a);
+
+/**
+ * \brief Push words to an SNC-to-CM33 queue created with snc_sim_queue_create()
+ *
+ * Same effect as SNC_queues_snc_get_wq(), copying the data and SNC_queues_snc_push(), but
+ * inline. The data is dropped if the queue is full.
+ *
+ * \param [in] a uCode
+ * \param [in] q queue address
+ * \param [in] data address of the data in System RAM
+ * \param [in] words number of words
+ */
+void senis_asm_queue_push(senis_asm_t *a, uint32_t q, uint32_t data, uint32_t words);
+
+#endif /* SENIS_ASM_H_ */
@@ -0,0 +1,278 @@
+/**
+ ****************************************************************************************
+ *
+ * @file snc_sim.h
+ *
+ * @brief Sensor Node Controller simulator for the host
+ *
+ * Executes SeNIS uCode on a simulated DA1469x address space: System RAM at
+ * SNC_SIM_SYSRAM_BASE, the SNC registers and models of the I2C, SPI, GPADC and GPIO blocks used
+ * from uCode. Instruction semantics follow the SNC emulator (sdk/bsp/snc/src/snc_emu.c).
+ *
+ * Every instruction is charged a number of SNC clock cycles according to snc_sim_config_t
+ * (instruction word fetches, data accesses, register accesses, taken branches). Peripherals
+ * complete their operations after the time given by their bus clock, so polling loops in uCode
+ * cost what they would cost on the target. The cost model is an approximation; the defaults can
+ * be calibrated against measurements on silicon.
+ *
+ * Copyright (C) 2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ ****************************************************************************************
+ */
+
+#ifndef SNC_SIM_H_
+#define SNC_SIM_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define SNC_SIM_SYSRAM_BASE     ( 0x20000000 )  /**< Same as SENIS_MEM_BASE_ADDRESS */
+#define SNC_SIM_SYSRAM_SIZE     ( 512 * 1024 )
+#define SNC_SIM_REGS_BASE       ( 0x50000000 )  /**< Same as SENIS_REGS_BASE_ADDRESS */
+
+#define SNC_SIM_I2C_COUNT       ( 2 )
+#define SNC_SIM_SPI_COUNT       ( 2 )
+#define SNC_SIM_DEV_REGS        ( 128 )         /**< Registers of the devices attached to buses */
+
+/**
+ * \brief Simulator configuration
+ */
+typedef struct {
+        uint32_t snc_hz;                /**< SNC clock frequency */
+        uint32_t lp_clk_hz;             /**< Low power clock frequency, used by DEL */
+        uint32_t divn_hz;               /**< DIVN clock, source of the SPI clock */
+        uint8_t fetch_cycles;           /**< Cycles per instruction word fetched */
+        uint8_t mem_cycles;             /**< Cycles per data access to System RAM */
+        uint8_t reg_cycles;             /**< Cycles per data access to a register */
+        uint8_t branch_cycles;          /**< Additional cycles of a taken branch */
+        uint16_t gpadc_conv_cycles;     /**< GPADC conversion time in SNC cycles */
+} snc_sim_config_t;
+
+/**
+ * \brief Default configuration, 32MHz SNC clock
+ */
+extern const snc_sim_config_t snc_sim_default_config;
+
+/**
+ * \brief Result of a uCode run
+ */
+typedef enum {
+        SNC_SIM_DONE,                   /**< SLP was executed */
+        SNC_SIM_HARD_FAULT,             /**< Invalid opcode */
+        SNC_SIM_BUS_ERROR,              /**< Access outside System RAM and modelled registers */
+        SNC_SIM_CYCLE_LIMIT,            /**< Cycle limit reached, e.g. endless polling loop */
+} SNC_SIM_RESULT;
+
+/**
+ * \brief Overall statistics
+ */
+typedef struct {
+        uint32_t runs;                  /**< Completed runs (SNC wake-ups) */
+        uint64_t cycles;                /**< Cycles while SNC was active, including delays */
+        uint64_t max_run_cycles;        /**< Longest run */
+        uint64_t delay_cycles;          /**< Cycles spent in DEL */
+        uint64_t instructions;          /**< Executed instructions */
+        uint64_t mem_accesses;          /**< Data accesses to System RAM */
+        uint64_t reg_accesses;          /**< Data accesses to registers */
+        uint32_t cm33_irqs;             /**< Interrupts raised towards CM33 */
+} snc_sim_stats_t;
+
+/**
+ * \brief Per instruction statistics
+ */
+typedef struct {
+        uint32_t execs;                 /**< Number of times executed */
+        uint64_t cycles;                /**< Cycles spent, including delays */
+} snc_sim_pc_stats_t;
+
+/**
+ * \brief Bus (or converter) statistics of a peripheral
+ */
+typedef struct {
+        uint64_t busy_cycles;           /**< Time the bus was busy, in SNC cycles */
+        uint32_t transfers;             /**< I2C messages, SPI chip select periods, conversions */
+        uint32_t bytes;                 /**< Bytes transferred */
+} snc_sim_bus_stats_t;
+
+/**
+ * \brief Initialize simulator, clears System RAM, registers and statistics
+ *
+ * \param [in] cfg configuration, NULL for snc_sim_default_config
+ */
+void snc_sim_init(const snc_sim_config_t *cfg);
+
+/**
+ * \brief Get configuration in use
+ */
+const snc_sim_config_t *snc_sim_get_config(void);
+
+/**
+ * \brief Allocate System RAM, like OS_MALLOC() on the target
+ *
+ * \param [in] size size in bytes, rounded up to words
+ *
+ * \return address of the zeroed block in the simulated address space
+ */
+uint32_t snc_sim_alloc(uint32_t size);
+
+/**
+ * \brief Read word from the simulated address space, without statistics or time passing
+ */
+uint32_t snc_sim_read(uint32_t addr);
+
+/**
+ * \brief Write word to the simulated address space, without statistics or time passing
+ */
+void snc_sim_write(uint32_t addr, uint32_t value);
+
+/**
+ * \brief Copy data into System RAM
+ *
+ * \return false if the range is not within System RAM
+ */
+bool snc_sim_load(uint32_t addr, const void *data, uint32_t len);
+
+/**
+ * \brief Run uCode until SLP, like the SNC does on a PDC event
+ *
+ * \param [in] pc address of the first instruction
+ * \param [in] max_cycles limit of the run, 0 for no limit
+ *
+ * \return result of the run
+ */
+SNC_SIM_RESULT snc_sim_run(uint32_t pc, uint64_t max_cycles);
+
+/**
+ * \brief Get address of the instruction that caused the last run to fail
+ */
+uint32_t snc_sim_get_fault_pc(void);
+
+/**
+ * \brief Get current time in SNC cycles
+ *
+ * Time passes only while uCode runs, the SNC is considered asleep between runs.
+ */
+uint64_t snc_sim_now(void);
+
+/**
+ * \brief Let time pass between runs, so peripherals complete pending operations
+ */
+void snc_sim_idle(uint64_t cycles);
+
+/**
+ * \brief Get overall statistics
+ */
+void snc_sim_get_stats(snc_sim_stats_t *stats);
+
+/**
+ * \brief Get statistics of instruction at pc, NULL if pc is not in System RAM
+ */
+const snc_sim_pc_stats_t *snc_sim_get_pc_stats(uint32_t pc);
+
+/**
+ * \brief Clear statistics, peripheral statistics included
+ */
+void snc_sim_reset_stats(void);
+
+/**
+ * \brief Disassemble one instruction
+ *
+ * \param [in] addr address of the instruction
+ * \param [out] buf text
+ * \param [in] len size of buf
+ *
+ * \return number of words of the instruction
+ */
+uint32_t snc_sim_disasm(uint32_t addr, char *buf, size_t len);
+
+/*
+ * Peripheral models (snc_sim_periph.c)
+ */
+
+/**
+ * \brief Get registers of the device attached to I2C controller (0: I2C, 1: I2C2)
+ *
+ * The first byte written after START/RESTART selects the register, following bytes are written
+ * to or read from consecutive registers.
+ */
+uint8_t *snc_sim_i2c_dev_regs(int id);
+
+/**
+ * \brief Get registers of the device attached to SPI controller (0: SPI, 1: SPI2)
+ *
+ * The first byte after chip select activation selects the register, bit 7 selects a read.
+ */
+uint8_t *snc_sim_spi_dev_regs(int id);
+
+/**
+ * \brief Attach SPI device to a GPIO used as chip select
+ *
+ * \param [in] id SPI controller (0: SPI, 1: SPI2)
+ * \param [in] port GPIO port
+ * \param [in] pin GPIO pin
+ */
+void snc_sim_spi_set_cs(int id, uint8_t port, uint8_t pin);
+
+/**
+ * \brief Set function giving the GPADC conversion results, NULL for a ramp
+ */
+void snc_sim_gpadc_set_source(uint16_t (*source)(uint32_t conversion));
+
+void snc_sim_i2c_get_stats(int id, snc_sim_bus_stats_t *stats);
+void snc_sim_spi_get_stats(int id, snc_sim_bus_stats_t *stats);
+void snc_sim_gpadc_get_stats(snc_sim_bus_stats_t *stats);
+
+/*
+ * SNC-to-CM33 queues (snc_sim_queue.c), same memory layout as the queues of snc_queues.c
+ */
+
+/**
+ * \brief Create queue in System RAM, like snc_queues_cm33_create() for word elements
+ *
+ * \param [in] num_of_chunks number of chunks
+ * \param [in] max_chunk_bytes maximum data size of a chunk
+ *
+ * \return address of the queue
+ */
+uint32_t snc_sim_queue_create(uint32_t num_of_chunks, uint32_t max_chunk_bytes);
+
+/**
+ * \brief Pop one chunk in CM33 context, like snc_queues_cm33_pop()
+ *
+ * \param [in] q queue address
+ * \param [out] size data size of the chunk, can be NULL
+ *
+ * \return false if the queue is empty
+ */
+bool snc_sim_queue_pop(uint32_t q, uint32_t *size);
+
+/**
+ * \brief Get number of chunks pushed and not popped, like snc_queues_cm33_get_alloc_chunks()
+ */
+uint32_t snc_sim_queue_get_alloc_chunks(uint32_t q);
+
+/**
+ * \brief Queue offsets, same as snc_q_t of snc_queues.c on the 32-bit target
+ */
+enum {
+        SNC_SIM_Q_PCHUNKS = 0,
+        SNC_SIM_Q_FLAGS = 4,
+        SNC_SIM_Q_WRITE_CHUNK_PT = 8,
+        SNC_SIM_Q_READ_CHUNK_PT = 12,
+        SNC_SIM_Q_CHUNK_WP_TO_PUSH = 16,
+        SNC_SIM_Q_CHUNK_RP_TO_POP = 20,
+        SNC_SIM_Q_MAX_CHUNK_SIZE_BYTES = 24,
+        SNC_SIM_Q_NUM_OF_CHUNKS = 28,
+        SNC_SIM_Q_LAST_CHUNK_PT = 32,
+        SNC_SIM_Q_DATA = 36,
+        SNC_SIM_Q_SIZE = 40,
+};
+
+#define SNC_SIM_Q_PREAMBLE_WBIT         ( 0x80000000 )
+#define SNC_SIM_Q_FLAG_NO_TIMESTAMP     ( 1 << 0 )
+#define SNC_SIM_Q_FLAG_WEIGHT_WORD      ( 1 << 5 )
+
+#endif /* SNC_SIM_H_ */
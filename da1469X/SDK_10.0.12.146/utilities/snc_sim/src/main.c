@@ -0,0 +1,438 @@
+/**
+ ****************************************************************************************
+ *
+ * @file main.c
+ *
+ * @brief SNC simulator command line tool
+ *
+ * Runs uCode on the SNC simulator as if triggered periodically by the PDC, with CM33 draining
+ * the SNC-to-CM33 queue whenever it is notified, and reports SNC active time, bus time and
+ * queue fill level. uCode is either one of the built-in examples, built with the host SeNIS
+ * compiler, or a raw image taken from the target.
+ *
+ * Copyright (C) 2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ ****************************************************************************************
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "snc_sim.h"
+#include "senis_asm.h"
+
+/* Registers used by the examples, as in DA1469x-00.h */
+#define I2C_DATA_CMD_REG        ( 0x50020610 )
+#define I2C_STATUS_REG          ( 0x50020670 )
+#define I2C_RXFLR_REG           ( 0x50020678 )
+#define SPI_CTRL_REG            ( 0x50020300 )
+#define SPI_RX_TX_REG           ( 0x50020304 )
+#define SPI_CLEAR_INT_REG       ( 0x50020308 )
+#define GP_ADC_CTRL_REG         ( 0x50030900 )
+#define GP_ADC_CLEAR_INT_REG    ( 0x50030914 )
+#define GP_ADC_RESULT_REG       ( 0x50030918 )
+#define P0_SET_DATA_REG         ( 0x50020A08 )
+#define P0_RESET_DATA_REG       ( 0x50020A10 )
+
+#define I2C_DATA_CMD_I2C_CMD    ( 1 << 8 )
+#define I2C_DATA_CMD_I2C_STOP   ( 1 << 9 )
+#define I2C_STATUS_RFNE_Pos     ( 3 )
+#define SPI_CTRL_SPI_INT_BIT_Pos ( 13 )
+#define GP_ADC_CTRL_START_Pos   ( 1 )
+
+#define SENSOR_REG              ( 0x28 )        /* First data register of the example sensor */
+#define SENSOR_BYTES            ( 6 )
+#define SPI_CS_PIN              ( 20 )          /* P0_20 */
+
+#define QUEUE_CHUNKS            ( 8 )
+#define GPADC_BATCH             ( 4 )           /* Samples per CM33 notification */
+
+#define UCODE_MAX_WORDS         ( 1024 )
+
+typedef struct {
+        uint32_t q;                     /* SNC-to-CM33 queue, 0 if none */
+} example_ctx_t;
+
+typedef struct {
+        const char *name;
+        const char *descr;
+        void (*build)(senis_asm_t *a, example_ctx_t *ctx);
+} example_t;
+
+static uint32_t runs = 100;
+static uint32_t period_us = 10000;
+static bool verbose;
+
+static void sensor_setup(uint8_t *regs)
+{
+        int i;
+
+        for (i = 0; i < SENSOR_BYTES; i++) {
+                regs[SENSOR_REG + i] = 0x10 + i;
+        }
+}
+
+/* Read sensor data over I2C waiting for every byte */
+static void build_i2c_poll(senis_asm_t *a, example_ctx_t *ctx)
+{
+        uint32_t buf = snc_sim_alloc(SENSOR_BYTES * 4);
+        int i;
+
+        sensor_setup(snc_sim_i2c_dev_regs(0));
+        ctx->q = snc_sim_queue_create(QUEUE_CHUNKS, SENSOR_BYTES * 4);
+
+        senis_asm_wadva(a, SA_DA(I2C_DATA_CMD_REG), SENSOR_REG);
+        for (i = 0; i < SENSOR_BYTES; i++) {
+                senis_asm_wadva(a, SA_DA(I2C_DATA_CMD_REG), I2C_DATA_CMD_I2C_CMD |
+                        (i == SENSOR_BYTES - 1 ? I2C_DATA_CMD_I2C_STOP : 0));
+                senis_asm_wait_bit(a, I2C_STATUS_REG, I2C_STATUS_RFNE_Pos, true);
+                senis_asm_wadad(a, SA_DA(buf + i * 4), SA_DA(I2C_DATA_CMD_REG));
+        }
+        senis_asm_queue_push(a, ctx->q, buf, SENSOR_BYTES);
+        senis_asm_cm33_notify(a);
+        senis_asm_slp(a);
+}
+
+/* Read sensor data over I2C queueing all commands in the TX FIFO first */
+static void build_i2c_batch(senis_asm_t *a, example_ctx_t *ctx)
+{
+        uint32_t buf = snc_sim_alloc(SENSOR_BYTES * 4);
+        uint32_t last = snc_sim_alloc(4);
+        SENIS_ASM_LABEL poll;
+        SENIS_ASM_LABEL done;
+        int i;
+
+        sensor_setup(snc_sim_i2c_dev_regs(0));
+        ctx->q = snc_sim_queue_create(QUEUE_CHUNKS, SENSOR_BYTES * 4);
+        snc_sim_write(last, SENSOR_BYTES - 1);
+
+        senis_asm_wadva(a, SA_DA(I2C_DATA_CMD_REG), SENSOR_REG);
+        for (i = 0; i < SENSOR_BYTES; i++) {
+                senis_asm_wadva(a, SA_DA(I2C_DATA_CMD_REG), I2C_DATA_CMD_I2C_CMD |
+                        (i == SENSOR_BYTES - 1 ? I2C_DATA_CMD_I2C_STOP : 0));
+        }
+        poll = senis_asm_label(a);
+        done = senis_asm_label_new(a);
+        senis_asm_rdcgr(a, I2C_RXFLR_REG, last);
+        senis_asm_cobr_gr(a, SA_L(done));
+        senis_asm_goto(a, SA_L(poll));
+        senis_asm_place(a, done);
+        for (i = 0; i < SENSOR_BYTES; i++) {
+                senis_asm_wadad(a, SA_DA(buf + i * 4), SA_DA(I2C_DATA_CMD_REG));
+        }
+        senis_asm_queue_push(a, ctx->q, buf, SENSOR_BYTES);
+        senis_asm_cm33_notify(a);
+        senis_asm_slp(a);
+}
+
+/* Read sensor data over SPI, chip select on a GPIO */
+static void build_spi(senis_asm_t *a, example_ctx_t *ctx)
+{
+        uint32_t buf = snc_sim_alloc(SENSOR_BYTES * 4);
+        int i;
+
+        sensor_setup(snc_sim_spi_dev_regs(0));
+        snc_sim_spi_set_cs(0, 0, SPI_CS_PIN);
+        ctx->q = snc_sim_queue_create(QUEUE_CHUNKS, SENSOR_BYTES * 4);
+        /* SPI_ON, 8-bit words, DIVN / 4 */
+        snc_sim_write(SPI_CTRL_REG, (1 << 0) | (1 << 3));
+
+        senis_asm_wadva(a, SA_DA(P0_RESET_DATA_REG), 1 << SPI_CS_PIN);
+        for (i = -1; i < SENSOR_BYTES; i++) {
+                senis_asm_wadva(a, SA_DA(SPI_RX_TX_REG), i < 0 ? 0x80 | SENSOR_REG : 0);
+                senis_asm_wait_bit(a, SPI_CTRL_REG, SPI_CTRL_SPI_INT_BIT_Pos, true);
+                senis_asm_wadad(a, SA_DA(buf + (i < 0 ? 0 : i) * 4), SA_DA(SPI_RX_TX_REG));
+                senis_asm_wadva(a, SA_DA(SPI_CLEAR_INT_REG), 1);
+        }
+        senis_asm_wadva(a, SA_DA(P0_SET_DATA_REG), 1 << SPI_CS_PIN);
+        senis_asm_queue_push(a, ctx->q, buf, SENSOR_BYTES);
+        senis_asm_cm33_notify(a);
+        senis_asm_slp(a);
+}
+
+static void gpadc_sample(senis_asm_t *a, example_ctx_t *ctx, uint32_t sample)
+{
+        ctx->q = snc_sim_queue_create(QUEUE_CHUNKS, 4);
+
+        /* GP_ADC_EN | GP_ADC_START */
+        senis_asm_wadva(a, SA_DA(GP_ADC_CTRL_REG), (1 << 0) | (1 << GP_ADC_CTRL_START_Pos));
+        senis_asm_wait_bit(a, GP_ADC_CTRL_REG, GP_ADC_CTRL_START_Pos, false);
+        senis_asm_wadad(a, SA_DA(sample), SA_DA(GP_ADC_RESULT_REG));
+        senis_asm_wadva(a, SA_DA(GP_ADC_CLEAR_INT_REG), 1);
+        senis_asm_queue_push(a, ctx->q, sample, 1);
+}
+
+/* Queue a GPADC sample and notify CM33 on every run */
+static void build_gpadc(senis_asm_t *a, example_ctx_t *ctx)
+{
+        uint32_t sample = snc_sim_alloc(4);
+
+        gpadc_sample(a, ctx, sample);
+        senis_asm_cm33_notify(a);
+        senis_asm_slp(a);
+}
+
+/* Queue a GPADC sample and notify CM33 every GPADC_BATCH runs */
+static void build_gpadc_batch(senis_asm_t *a, example_ctx_t *ctx)
+{
+        uint32_t sample = snc_sim_alloc(4);
+        uint32_t count = snc_sim_alloc(4);
+        uint32_t threshold = snc_sim_alloc(4);
+        SENIS_ASM_LABEL notify = senis_asm_label_new(a);
+
+        snc_sim_write(threshold, GPADC_BATCH - 1);
+
+        gpadc_sample(a, ctx, sample);
+        senis_asm_inc1(a, count);
+        senis_asm_rdcgr(a, count, threshold);
+        senis_asm_cobr_gr(a, SA_L(notify));
+        senis_asm_slp(a);
+        senis_asm_place(a, notify);
+        senis_asm_wadva(a, SA_DA(count), 0);
+        senis_asm_cm33_notify(a);
+        senis_asm_slp(a);
+}
+
+static const example_t examples[] = {
+        { "i2c_poll",    "I2C read, waiting for every byte",      build_i2c_poll    },
+        { "i2c_batch",   "I2C read, all commands queued at once", build_i2c_batch   },
+        { "spi",         "SPI read, GPIO chip select",            build_spi         },
+        { "gpadc",       "GPADC sample, notify on every sample",  build_gpadc       },
+        { "gpadc_batch", "GPADC sample, notify every 4 samples",  build_gpadc_batch },
+};
+
+static double cycles_to_us(uint64_t cycles)
+{
+        return cycles * 1e6 / snc_sim_get_config()->snc_hz;
+}
+
+static void print_profile(uint32_t start, uint32_t words)
+{
+        uint32_t addr = start;
+        char text[64];
+
+        printf("    %-10s %-44s %8s %10s\n", "address", "instruction", "execs", "cycles/run");
+        while (addr < start + words * 4) {
+                const snc_sim_pc_stats_t *ps = snc_sim_get_pc_stats(addr);
+                uint32_t n = snc_sim_disasm(addr, text, sizeof(text));
+
+                if (ps && ps->execs) {
+                        printf("    0x%08x %-44s %8u %10.1f\n", addr, text, ps->execs,
+                                (double) ps->cycles / runs);
+                } else {
+                        printf("    0x%08x %-44s %8s\n", addr, text, "-");
+                }
+                addr += n * 4;
+        }
+}
+
+/* Run uCode as triggered every period_us, CM33 popping the queue when notified */
+static bool simulate(const char *name, uint32_t pc, uint32_t words, uint32_t q)
+{
+        snc_sim_stats_t stats;
+        snc_sim_bus_stats_t i2c, spi, gpadc;
+        uint64_t period = (uint64_t) period_us * snc_sim_get_config()->snc_hz / 1000000;
+        uint32_t irqs = 0;
+        uint32_t q_max = 0;
+        uint32_t popped = 0;
+        uint32_t i;
+
+        snc_sim_reset_stats();
+
+        for (i = 0; i < runs; i++) {
+                uint64_t start = snc_sim_now();
+                SNC_SIM_RESULT res = snc_sim_run(pc, period);
+
+                if (res != SNC_SIM_DONE) {
+                        static const char *reason[] = { "done", "hard fault", "bus error",
+                                                        "cycle limit" };
+
+                        fprintf(stderr, "%s: %s at 0x%08x, run %u\n", name, reason[res],
+                                snc_sim_get_fault_pc(), i);
+                        return false;
+                }
+
+                if (q) {
+                        uint32_t fill = snc_sim_queue_get_alloc_chunks(q);
+
+                        if (fill > q_max) {
+                                q_max = fill;
+                        }
+                }
+
+                snc_sim_get_stats(&stats);
+                if (stats.cm33_irqs != irqs) {
+                        irqs = stats.cm33_irqs;
+                        while (q && snc_sim_queue_pop(q, NULL)) {
+                                popped++;
+                        }
+                }
+
+                if (snc_sim_now() - start < period) {
+                        snc_sim_idle(period - (snc_sim_now() - start));
+                }
+        }
+
+        snc_sim_get_stats(&stats);
+        snc_sim_i2c_get_stats(0, &i2c);
+        snc_sim_spi_get_stats(0, &spi);
+        snc_sim_gpadc_get_stats(&gpadc);
+
+        printf("%-12s %8.2f %8.2f %8.1f %8.2f %8.2f %8.2f %6u/%-3u %6u %6u\n", name,
+                cycles_to_us(stats.cycles) / runs, cycles_to_us(stats.max_run_cycles),
+                (double) stats.instructions / runs,
+                cycles_to_us(i2c.busy_cycles) / runs, cycles_to_us(spi.busy_cycles) / runs,
+                cycles_to_us(gpadc.busy_cycles) / runs,
+                q_max, q ? snc_sim_read(q + SNC_SIM_Q_NUM_OF_CHUNKS) : 0, popped,
+                stats.cm33_irqs);
+
+        if (verbose) {
+                print_profile(pc, words);
+        }
+        return true;
+}
+
+static void print_header(void)
+{
+        printf("%-12s %8s %8s %8s %8s %8s %8s %10s %6s %6s\n", "uCode", "avg[us]", "max[us]",
+                "instr", "i2c[us]", "spi[us]", "adc[us]", "q max", "popped", "irqs");
+}
+
+static bool run_example(const example_t *ex)
+{
+        senis_asm_t *a = malloc(sizeof(*a));
+        example_ctx_t ctx = { 0 };
+        bool ok;
+
+        senis_asm_init(a, UCODE_MAX_WORDS);
+        ex->build(a, &ctx);
+        if (!senis_asm_end(a)) {
+                fprintf(stderr, "%s: uCode build failed\n", ex->name);
+                free(a);
+                return false;
+        }
+        ok = simulate(ex->name, a->base, a->len, ctx.q);
+        free(a);
+        return ok;
+}
+
+static bool run_image(const char *arg, uint32_t entry)
+{
+        char path[256];
+        const char *at = strrchr(arg, '@');
+        uint32_t addr;
+        uint8_t *data;
+        long len;
+        FILE *f;
+        bool ok;
+
+        if (!at || at == arg || (size_t) (at - arg) >= sizeof(path)) {
+                fprintf(stderr, "image must be given as file@address\n");
+                return false;
+        }
+        memcpy(path, arg, at - arg);
+        path[at - arg] = '\0';
+        addr = strtoul(at + 1, NULL, 0);
+
+        f = fopen(path, "rb");
+        if (!f) {
+                perror(path);
+                return false;
+        }
+        fseek(f, 0, SEEK_END);
+        len = ftell(f);
+        fseek(f, 0, SEEK_SET);
+        data = malloc(len);
+        ok = data && fread(data, 1, len, f) == (size_t) len;
+        fclose(f);
+
+        /* Image is a little endian dump of target System RAM, same as the host */
+        if (!ok || !snc_sim_load(addr, data, len)) {
+                fprintf(stderr, "%s: cannot load at 0x%08x\n", path, addr);
+                free(data);
+                return false;
+        }
+        free(data);
+
+        return simulate(path, entry ? entry : addr, len / 4, 0);
+}
+
+static void usage(const char *prog)
+{
+        size_t i;
+
+        fprintf(stderr,
+                "Usage: %s [-n runs] [-p period_us] [-c snc_mhz] [-v] [example...]\n"
+                "       %s [-n runs] [-p period_us] [-c snc_mhz] [-v] -l file@address [-e entry]\n"
+                "\nExamples:\n", prog, prog);
+        for (i = 0; i < sizeof(examples) / sizeof(examples[0]); i++) {
+                fprintf(stderr, "  %-12s %s\n", examples[i].name, examples[i].descr);
+        }
+        exit(1);
+}
+
+int main(int argc, char *argv[])
+{
+        snc_sim_config_t cfg = snc_sim_default_config;
+        const char *image = NULL;
+        uint32_t entry = 0;
+        bool ok = true;
+        size_t i;
+        int opt;
+
+        while ((opt = getopt(argc, argv, "n:p:c:vl:e:h")) != -1) {
+                switch (opt) {
+                case 'n':
+                        runs = strtoul(optarg, NULL, 0);
+                        break;
+                case 'p':
+                        period_us = strtoul(optarg, NULL, 0);
+                        break;
+                case 'c':
+                        cfg.snc_hz = strtoul(optarg, NULL, 0) * 1000000;
+                        break;
+                case 'v':
+                        verbose = true;
+                        break;
+                case 'l':
+                        image = optarg;
+                        break;
+                case 'e':
+                        entry = strtoul(optarg, NULL, 0);
+                        break;
+                default:
+                        usage(argv[0]);
+                }
+        }
+        if (runs == 0 || period_us == 0 || cfg.snc_hz == 0) {
+                usage(argv[0]);
+        }
+
+        printf("SNC %u MHz, %u runs every %u us\n\n", (unsigned) (cfg.snc_hz / 1000000),
+                (unsigned) runs, (unsigned) period_us);
+        print_header();
+
+        if (image) {
+                snc_sim_init(&cfg);
+                return run_image(image, entry) ? 0 : 1;
+        }
+
+        for (i = 0; i < sizeof(examples) / sizeof(examples[0]); i++) {
+                int j;
+                bool selected = optind == argc;
+
+                for (j = optind; j < argc; j++) {
+                        selected |= strcmp(argv[j], examples[i].name) == 0;
+                }
+                if (!selected) {
+                        continue;
+                }
+                snc_sim_init(&cfg);
+                ok &= run_example(&examples[i]);
+        }
+
+        return ok ? 0 : 1;
+}
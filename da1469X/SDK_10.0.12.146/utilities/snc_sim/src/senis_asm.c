@@ -0,0 +1,288 @@
+/**
+ ****************************************************************************************
+ *
+ * @file senis_asm.c
+ *
+ * @brief Host SeNIS compiler
+ *
+ * Copyright (C) 2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ ****************************************************************************************
+ */
+
+#include "snc_sim.h"
+#include "senis_asm.h"
+
+/* SNC_CTRL_REG and its SNC_IRQ_CONFIG / SNC_IRQ_EN fields, as in DA1469x-00.h */
+#define SNC_CTRL_REG_ADDR               ( 0x50020C00 )
+#define SNC_CTRL_SNC_IRQ_CONFIG_Msk     ( 0xC0 )
+#define SNC_CTRL_SNC_IRQ_EN_Msk         ( 0x20 )
+
+/* Temporary variables of the constructs */
+enum {
+        TMP_CHUNK_PT,
+        TMP_CHUNK,
+        TMP_PREAMBLE,
+        TMP_COUNT,
+};
+
+/* Address field of an instruction word, with the register flag (_SNC_ADDR_SET_MODE/VALUE) */
+static uint32_t addr_field(uint32_t addr)
+{
+        uint32_t w = addr & SENIS_ADDR_MASK;
+
+        if ((addr & SNC_SIM_REGS_BASE) == SNC_SIM_REGS_BASE) {
+                w |= SENIS_FLAG_REG;
+        }
+        return w;
+}
+
+static uint32_t tmp(const senis_asm_t *a, int idx)
+{
+        return a->consts + 8 + idx * 4;
+}
+
+static uint32_t pos(const senis_asm_t *a)
+{
+        return a->base + a->len * 4;
+}
+
+static void emit(senis_asm_t *a, uint32_t word)
+{
+        if (a->len >= a->size) {
+                a->error = true;
+                return;
+        }
+        snc_sim_write(pos(a), word);
+        a->len++;
+}
+
+/* Emit a branch instruction, its target being direct, indirect or a label */
+static void emit_branch(senis_asm_t *a, uint32_t attr, sa_oper_t target)
+{
+        if (target.type == SA_LABEL) {
+                if (target.addr >= a->label_count || a->fixup_count == SENIS_ASM_MAX_FIXUPS) {
+                        a->error = true;
+                        return;
+                }
+                a->fixups[a->fixup_count].addr = pos(a);
+                a->fixups[a->fixup_count].label = target.addr;
+                a->fixup_count++;
+                emit(a, (SENIS_OP_COBR << 28) | (attr << 20));
+                return;
+        }
+        if (target.type == SA_INDIRECT) {
+                attr |= 0x10;
+        }
+        emit(a, (SENIS_OP_COBR << 28) | (attr << 20) | (target.addr & SENIS_ADDR_MASK));
+}
+
+void senis_asm_init(senis_asm_t *a, uint32_t size)
+{
+        *a = (senis_asm_t) { 0 };
+        a->size = size;
+        a->base = snc_sim_alloc(size * 4);
+        a->consts = snc_sim_alloc(8 + TMP_COUNT * 4);
+        snc_sim_write(a->consts + 4, 1);
+}
+
+bool senis_asm_end(senis_asm_t *a)
+{
+        uint32_t i;
+
+        for (i = 0; i < a->fixup_count; i++) {
+                uint32_t target = a->labels[a->fixups[i].label];
+                uint32_t w = snc_sim_read(a->fixups[i].addr);
+
+                if (!target) {
+                        a->error = true;
+                        continue;
+                }
+                snc_sim_write(a->fixups[i].addr, (w & ~SENIS_ADDR_MASK) | (target & SENIS_ADDR_MASK));
+        }
+        a->fixup_count = 0;
+
+        return !a->error;
+}
+
+SENIS_ASM_LABEL senis_asm_label_new(senis_asm_t *a)
+{
+        if (a->label_count == SENIS_ASM_MAX_LABELS) {
+                a->error = true;
+                return 0;
+        }
+        a->labels[a->label_count] = 0;
+        return a->label_count++;
+}
+
+void senis_asm_place(senis_asm_t *a, SENIS_ASM_LABEL label)
+{
+        if (label < a->label_count) {
+                a->labels[label] = pos(a);
+        }
+}
+
+SENIS_ASM_LABEL senis_asm_label(senis_asm_t *a)
+{
+        SENIS_ASM_LABEL label = senis_asm_label_new(a);
+
+        senis_asm_place(a, label);
+        return label;
+}
+
+void senis_asm_nop(senis_asm_t *a)
+{
+        emit(a, SENIS_OP_NOP << 28);
+}
+
+void senis_asm_wadad(senis_asm_t *a, sa_oper_t dst, sa_oper_t src)
+{
+        uint32_t w1 = (SENIS_OP_WADAD << 28) | addr_field(dst.addr);
+
+        if (dst.type == SA_LABEL || src.type == SA_LABEL) {
+                a->error = true;
+                return;
+        }
+        if (dst.type == SA_DIRECT) {
+                w1 |= SENIS_FLAG_DA1;
+        }
+        if (src.type == SA_INDIRECT) {
+                w1 |= SENIS_FLAG_InA2;
+        }
+        emit(a, w1);
+        emit(a, addr_field(src.addr));
+}
+
+void senis_asm_wadva(senis_asm_t *a, sa_oper_t dst, uint32_t value)
+{
+        uint32_t w1 = (SENIS_OP_WADVA << 28) | addr_field(dst.addr);
+
+        if (dst.type == SA_LABEL) {
+                a->error = true;
+                return;
+        }
+        if (dst.type == SA_DIRECT) {
+                w1 |= SENIS_FLAG_DA1;
+        }
+        emit(a, w1);
+        emit(a, value);
+}
+
+void senis_asm_tobre(senis_asm_t *a, uint32_t addr, uint32_t mask)
+{
+        emit(a, (SENIS_OP_TOBRE << 28) | addr_field(addr));
+        emit(a, mask);
+}
+
+void senis_asm_rdcbi(senis_asm_t *a, uint32_t addr, uint8_t bit_pos)
+{
+        emit(a, (SENIS_OP_RDCBI << 28) | addr_field(addr) | ((bit_pos & 0x1F) << 23));
+}
+
+void senis_asm_rdcgr(senis_asm_t *a, uint32_t addr, uint32_t gt_addr)
+{
+        emit(a, (SENIS_OP_RDCGR << 28) | addr_field(addr));
+        emit(a, addr_field(gt_addr));
+}
+
+void senis_asm_cobr_eq(senis_asm_t *a, sa_oper_t target)
+{
+        emit_branch(a, 0x0A, target);
+}
+
+void senis_asm_cobr_gr(senis_asm_t *a, sa_oper_t target)
+{
+        emit_branch(a, 0x05, target);
+}
+
+void senis_asm_cobr_loop(senis_asm_t *a, sa_oper_t target, uint8_t cnt)
+{
+        if (target.type == SA_INDIRECT) {
+                a->error = true;
+                return;
+        }
+        emit_branch(a, 0x80 | (cnt & 0x7F), target);
+}
+
+void senis_asm_inc1(senis_asm_t *a, uint32_t addr)
+{
+        emit(a, (SENIS_OP_INC << 28) | (addr & SENIS_ADDR_MASK));
+}
+
+void senis_asm_inc4(senis_asm_t *a, uint32_t addr)
+{
+        emit(a, (SENIS_OP_INC << 28) | (addr & SENIS_ADDR_MASK) | SENIS_FLAG_INC4);
+}
+
+void senis_asm_del(senis_asm_t *a, uint8_t ticks)
+{
+        emit(a, (SENIS_OP_DEL << 28) + ticks);
+}
+
+void senis_asm_slp(senis_asm_t *a)
+{
+        emit(a, SENIS_OP_SLP << 28);
+}
+
+void senis_asm_goto(senis_asm_t *a, sa_oper_t target)
+{
+        /* Bit 0 of constant 1 is always set */
+        senis_asm_rdcbi(a, a->consts + 4, 0);
+        senis_asm_cobr_eq(a, target);
+}
+
+void senis_asm_wait_bit(senis_asm_t *a, uint32_t addr, uint8_t bit_pos, bool set)
+{
+        SENIS_ASM_LABEL poll = senis_asm_label(a);
+
+        senis_asm_rdcbi(a, addr, bit_pos);
+        if (set) {
+                SENIS_ASM_LABEL done = senis_asm_label_new(a);
+
+                senis_asm_cobr_eq(a, SA_L(done));
+                senis_asm_goto(a, SA_L(poll));
+                senis_asm_place(a, done);
+        } else {
+                senis_asm_cobr_eq(a, SA_L(poll));
+        }
+}
+
+void senis_asm_cm33_notify(senis_asm_t *a)
+{
+        senis_asm_wadva(a, SA_DA(SNC_CTRL_REG_ADDR),
+                SNC_CTRL_SNC_IRQ_CONFIG_Msk | SNC_CTRL_SNC_IRQ_EN_Msk);
+}
+
+void senis_asm_queue_push(senis_asm_t *a, uint32_t q, uint32_t data, uint32_t words)
+{
+        SENIS_ASM_LABEL full = senis_asm_label_new(a);
+        SENIS_ASM_LABEL no_wrap = senis_asm_label_new(a);
+        uint32_t i;
+
+        /* Get write chunk, it is full if its write bit is still set */
+        senis_asm_wadad(a, SA_DA(tmp(a, TMP_CHUNK_PT)), SA_DA(q + SNC_SIM_Q_WRITE_CHUNK_PT));
+        senis_asm_wadad(a, SA_DA(tmp(a, TMP_CHUNK)), SA_IA(tmp(a, TMP_CHUNK_PT)));
+        senis_asm_wadad(a, SA_DA(tmp(a, TMP_PREAMBLE)), SA_IA(tmp(a, TMP_CHUNK)));
+        senis_asm_rdcbi(a, tmp(a, TMP_PREAMBLE), 31);
+        senis_asm_cobr_eq(a, SA_L(full));
+
+        /* Copy data after the preamble */
+        for (i = 0; i < words; i++) {
+                senis_asm_inc4(a, tmp(a, TMP_CHUNK));
+                senis_asm_wadad(a, SA_IA(tmp(a, TMP_CHUNK)), SA_DA(data + i * 4));
+        }
+
+        /* Write preamble, then advance write chunk pointer */
+        senis_asm_wadad(a, SA_DA(tmp(a, TMP_CHUNK)), SA_IA(tmp(a, TMP_CHUNK_PT)));
+        senis_asm_wadva(a, SA_IA(tmp(a, TMP_CHUNK)), (words * 4) | SNC_SIM_Q_PREAMBLE_WBIT);
+        senis_asm_rdcgr(a, q + SNC_SIM_Q_LAST_CHUNK_PT, tmp(a, TMP_CHUNK_PT));
+        senis_asm_inc4(a, tmp(a, TMP_CHUNK_PT));
+        senis_asm_cobr_gr(a, SA_L(no_wrap));
+        senis_asm_wadad(a, SA_DA(tmp(a, TMP_CHUNK_PT)), SA_DA(q + SNC_SIM_Q_PCHUNKS));
+        senis_asm_place(a, no_wrap);
+        senis_asm_wadad(a, SA_DA(q + SNC_SIM_Q_WRITE_CHUNK_PT), SA_DA(tmp(a, TMP_CHUNK_PT)));
+
+        senis_asm_place(a, full);
+}
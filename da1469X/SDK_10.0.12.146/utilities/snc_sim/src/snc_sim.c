@@ -0,0 +1,507 @@
+/**
+ ****************************************************************************************
+ *
+ * @file snc_sim.c
+ *
+ * @brief Sensor Node Controller simulator core
+ *
+ * The instruction interpreter follows execute_snc_emu() of sdk/bsp/snc/src/snc_emu.c, on a
+ * simulated 32-bit address space instead of the target memory.
+ *
+ * Copyright (C) 2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ ****************************************************************************************
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "senis_asm.h"
+#include "snc_sim_internal.h"
+
+/* SNC registers, as in DA1469x-00.h */
+#define SNC_BASE                        ( 0x50020C00 )
+#define SNC_REG_COUNT                   ( 8 )
+
+typedef enum {
+        SNC_CTRL_REG,
+        SNC_STATUS_REG,
+        SNC_LP_TIMER_REG,
+        SNC_PC_REG,
+        SNC_R1_REG,
+        SNC_R2_REG,
+        SNC_TMP1_REG,
+        SNC_TMP2_REG,
+} SNC_REG;
+
+#define SNC_CTRL_SNC_IRQ_ACK            ( 1 << 8 )
+#define SNC_CTRL_SNC_IRQ_CONFIG_CM33    ( 1 << 6 )
+#define SNC_CTRL_SNC_IRQ_EN             ( 1 << 5 )
+#define SNC_CTRL_SNC_BRANCH_LOOP_INIT   ( 1 << 4 )
+
+#define SNC_STATUS_EQ_FLAG              ( 1 << 0 )
+#define SNC_STATUS_GR_FLAG              ( 1 << 1 )
+#define SNC_STATUS_SNC_DONE_STATUS      ( 1 << 2 )
+
+/* Operands of an instruction, as OP1_R/OP1_M/OP2_R/OP2_M of snc_emu.c */
+#define OP_R(_w)        ( SNC_SIM_REGS_BASE + ((_w) & SENIS_ADDR_MASK) )
+#define OP_M(_w)        ( SNC_SIM_SYSRAM_BASE + ((_w) & SENIS_ADDR_MASK) )
+#define OP(_w)          ( ((_w) & SENIS_FLAG_REG) ? OP_R(_w) : OP_M(_w) )
+
+#define SYSRAM_WORDS    ( SNC_SIM_SYSRAM_SIZE / 4 )
+
+const snc_sim_config_t snc_sim_default_config = {
+        .snc_hz = 32000000,
+        .lp_clk_hz = 32768,
+        .divn_hz = 32000000,
+        .fetch_cycles = 1,
+        .mem_cycles = 1,
+        .reg_cycles = 2,
+        .branch_cycles = 1,
+        .gpadc_conv_cycles = 160,
+};
+
+static struct {
+        snc_sim_config_t cfg;
+        uint32_t ram[SYSRAM_WORDS];
+        uint32_t brk;                   /* First free System RAM word */
+        uint32_t regs[SNC_REG_COUNT];
+        uint32_t pc;
+        uint32_t branch_loop_cnt;
+        uint32_t fault_pc;
+        bool bus_error;
+        uint64_t now;
+        snc_sim_stats_t stats;
+        snc_sim_pc_stats_t pc_stats[SYSRAM_WORDS];
+} sim;
+
+static bool in_sysram(uint32_t addr)
+{
+        return addr >= SNC_SIM_SYSRAM_BASE && addr < SNC_SIM_SYSRAM_BASE + SNC_SIM_SYSRAM_SIZE;
+}
+
+static bool in_snc_regs(uint32_t addr)
+{
+        return addr >= SNC_BASE && addr < SNC_BASE + SNC_REG_COUNT * 4;
+}
+
+static void snc_reg_write(SNC_REG reg, uint32_t value)
+{
+        switch (reg) {
+        case SNC_CTRL_REG:
+                if (value & SNC_CTRL_SNC_BRANCH_LOOP_INIT) {
+                        sim.branch_loop_cnt = 0;
+                }
+                if ((value & SNC_CTRL_SNC_IRQ_EN) && !(sim.regs[reg] & SNC_CTRL_SNC_IRQ_EN) &&
+                        (value & SNC_CTRL_SNC_IRQ_CONFIG_CM33)) {
+                        sim.stats.cm33_irqs++;
+                        /* CM33 handles the interrupt while the SNC sleeps, consider it acknowledged */
+                        value &= ~SNC_CTRL_SNC_IRQ_EN;
+                }
+                if (value & SNC_CTRL_SNC_IRQ_ACK) {
+                        value &= ~SNC_CTRL_SNC_IRQ_EN;
+                }
+                sim.regs[reg] = value & ~(SNC_CTRL_SNC_IRQ_ACK | SNC_CTRL_SNC_BRANCH_LOOP_INIT);
+                break;
+        case SNC_STATUS_REG:
+                sim.regs[reg] = (sim.regs[reg] & ~(SNC_STATUS_EQ_FLAG | SNC_STATUS_GR_FLAG)) |
+                        (value & (SNC_STATUS_EQ_FLAG | SNC_STATUS_GR_FLAG));
+                break;
+        case SNC_PC_REG:
+        case SNC_LP_TIMER_REG:
+                break;
+        default:
+                sim.regs[reg] = value;
+                break;
+        }
+}
+
+static uint32_t raw_read(uint32_t addr, bool *ok)
+{
+        uint32_t value = 0;
+
+        *ok = true;
+        if (in_sysram(addr) && !(addr & 3)) {
+                return sim.ram[(addr - SNC_SIM_SYSRAM_BASE) / 4];
+        }
+        if (in_snc_regs(addr) && !(addr & 3)) {
+                SNC_REG reg = (addr - SNC_BASE) / 4;
+
+                return reg == SNC_PC_REG ? sim.pc : sim.regs[reg];
+        }
+        *ok = snc_sim_periph_read(addr, &value);
+        return value;
+}
+
+static bool raw_write(uint32_t addr, uint32_t value)
+{
+        if (in_sysram(addr) && !(addr & 3)) {
+                sim.ram[(addr - SNC_SIM_SYSRAM_BASE) / 4] = value;
+                return true;
+        }
+        if (in_snc_regs(addr) && !(addr & 3)) {
+                snc_reg_write((addr - SNC_BASE) / 4, value);
+                return true;
+        }
+        return snc_sim_periph_write(addr, value);
+}
+
+static void charge_access(uint32_t addr)
+{
+        if (in_sysram(addr)) {
+                sim.now += sim.cfg.mem_cycles;
+                sim.stats.mem_accesses++;
+        } else {
+                sim.now += sim.cfg.reg_cycles;
+                sim.stats.reg_accesses++;
+        }
+}
+
+/* Data access of uCode, time passes before the access completes */
+static uint32_t bus_read(uint32_t addr)
+{
+        bool ok;
+        uint32_t value;
+
+        charge_access(addr);
+        value = raw_read(addr, &ok);
+        if (!ok) {
+                sim.bus_error = true;
+        }
+        return value;
+}
+
+static void bus_write(uint32_t addr, uint32_t value)
+{
+        charge_access(addr);
+        if (!raw_write(addr, value)) {
+                sim.bus_error = true;
+        }
+}
+
+static uint32_t fetch(void)
+{
+        bool ok;
+        uint32_t word;
+
+        sim.now += sim.cfg.fetch_cycles;
+        word = in_sysram(sim.pc) ? raw_read(sim.pc, &ok) : 0;
+        if (!in_sysram(sim.pc)) {
+                sim.bus_error = true;
+        }
+        sim.pc += 4;
+        return word;
+}
+
+static void set_flag(uint32_t flag, bool set)
+{
+        if (set) {
+                sim.regs[SNC_STATUS_REG] |= flag;
+        } else {
+                sim.regs[SNC_STATUS_REG] &= ~flag;
+        }
+}
+
+/* Destination of WADAD/WADVA: register, direct or indirect System RAM address */
+static void write_dst(uint32_t word, uint32_t value)
+{
+        if (word & SENIS_FLAG_REG) {
+                bus_write(OP_R(word), value);
+        } else if (word & SENIS_FLAG_DA1) {
+                bus_write(OP_M(word), value);
+        } else {
+                bus_write(bus_read(OP_M(word)), value);
+        }
+}
+
+static void branch(uint32_t word, uint32_t attr)
+{
+        sim.pc = (attr & 0x10) ? bus_read(OP_M(word)) : OP_M(word);
+        sim.now += sim.cfg.branch_cycles;
+}
+
+/* Execute one instruction, returns false when SLP is executed or on a fault */
+static bool step(SNC_SIM_RESULT *result)
+{
+        uint32_t w1 = fetch();
+        uint32_t w2;
+        uint32_t value;
+        uint32_t attr;
+
+        switch (w1 >> 28) {
+        case SENIS_OP_NOP:
+                break;
+        case SENIS_OP_WADAD:
+                w2 = fetch();
+                if (w2 & SENIS_FLAG_REG) {
+                        value = bus_read(OP_R(w2));
+                } else if (w1 & SENIS_FLAG_InA2) {
+                        value = bus_read(bus_read(OP_M(w2)));
+                } else {
+                        value = bus_read(OP_M(w2));
+                }
+                write_dst(w1, value);
+                break;
+        case SENIS_OP_WADVA:
+                w2 = fetch();
+                write_dst(w1, w2);
+                break;
+        case SENIS_OP_TOBRE:
+                w2 = fetch();
+                bus_write(OP(w1), bus_read(OP(w1)) ^ w2);
+                break;
+        case SENIS_OP_RDCBI:
+                value = bus_read(OP(w1));
+                set_flag(SNC_STATUS_EQ_FLAG, value & (1UL << ((w1 >> 23) & 0x1F)));
+                break;
+        case SENIS_OP_RDCGR:
+                w2 = fetch();
+                value = bus_read(OP(w1));
+                set_flag(SNC_STATUS_GR_FLAG, value > bus_read(OP(w2)));
+                break;
+        case SENIS_OP_COBR:
+                attr = (w1 >> 20) & 0xFF;
+                if (attr & 0x80) {
+                        if (attr == 0x80) {
+                                /* Loop counter of 0, no branch */
+                        } else if (sim.branch_loop_cnt == 0x80) {
+                                sim.branch_loop_cnt = 0;
+                        } else if (sim.branch_loop_cnt & 0x80) {
+                                sim.branch_loop_cnt--;
+                                branch(w1, 0);
+                        } else {
+                                sim.branch_loop_cnt = attr - 1;
+                                branch(w1, 0);
+                        }
+                } else if ((attr & 0x0F) == 0x0A) {
+                        if (sim.regs[SNC_STATUS_REG] & SNC_STATUS_EQ_FLAG) {
+                                branch(w1, attr);
+                        }
+                } else if ((attr & 0x0F) == 0x05) {
+                        if (sim.regs[SNC_STATUS_REG] & SNC_STATUS_GR_FLAG) {
+                                branch(w1, attr);
+                        }
+                }
+                break;
+        case SENIS_OP_INC:
+                bus_write(OP_M(w1), bus_read(OP_M(w1)) + ((w1 & SENIS_FLAG_INC4) ? 4 : 1));
+                break;
+        case SENIS_OP_DEL:
+        {
+                uint64_t delay = SNC_SIM_CYCLES(sim.cfg.snc_hz, w1 & 0xFF, sim.cfg.lp_clk_hz);
+
+                sim.regs[SNC_LP_TIMER_REG] = w1 & 0xFF;
+                sim.now += delay;
+                sim.stats.delay_cycles += delay;
+                break;
+        }
+        case SENIS_OP_SLP:
+                sim.regs[SNC_STATUS_REG] |= SNC_STATUS_SNC_DONE_STATUS;
+                *result = SNC_SIM_DONE;
+                return false;
+        default:
+                *result = SNC_SIM_HARD_FAULT;
+                return false;
+        }
+
+        if (sim.bus_error) {
+                *result = SNC_SIM_BUS_ERROR;
+                return false;
+        }
+        return true;
+}
+
+void snc_sim_init(const snc_sim_config_t *cfg)
+{
+        memset(&sim, 0, sizeof(sim));
+        sim.cfg = cfg ? *cfg : snc_sim_default_config;
+        sim.regs[SNC_STATUS_REG] = SNC_STATUS_SNC_DONE_STATUS;
+        snc_sim_periph_reset();
+}
+
+const snc_sim_config_t *snc_sim_get_config(void)
+{
+        return &sim.cfg;
+}
+
+uint32_t snc_sim_alloc(uint32_t size)
+{
+        uint32_t words = (size + 3) / 4;
+        uint32_t addr;
+
+        if (sim.brk + words > SYSRAM_WORDS) {
+                fprintf(stderr, "snc_sim: out of System RAM\n");
+                return 0;
+        }
+        addr = SNC_SIM_SYSRAM_BASE + sim.brk * 4;
+        memset(&sim.ram[sim.brk], 0, words * 4);
+        sim.brk += words;
+        return addr;
+}
+
+uint32_t snc_sim_read(uint32_t addr)
+{
+        bool ok;
+
+        return raw_read(addr, &ok);
+}
+
+void snc_sim_write(uint32_t addr, uint32_t value)
+{
+        raw_write(addr, value);
+}
+
+bool snc_sim_load(uint32_t addr, const void *data, uint32_t len)
+{
+        if (!in_sysram(addr) || len > SNC_SIM_SYSRAM_BASE + SNC_SIM_SYSRAM_SIZE - addr) {
+                return false;
+        }
+        memcpy((uint8_t *) sim.ram + (addr - SNC_SIM_SYSRAM_BASE), data, len);
+        return true;
+}
+
+SNC_SIM_RESULT snc_sim_run(uint32_t pc, uint64_t max_cycles)
+{
+        SNC_SIM_RESULT result = SNC_SIM_DONE;
+        uint64_t start = sim.now;
+        uint64_t run_cycles;
+
+        sim.pc = pc;
+        sim.branch_loop_cnt = 0;
+        sim.bus_error = false;
+        sim.regs[SNC_STATUS_REG] &= ~SNC_STATUS_SNC_DONE_STATUS;
+
+        for (;;) {
+                uint32_t ipc = sim.pc;
+                uint64_t t = sim.now;
+                bool more = step(&result);
+
+                if (in_sysram(ipc)) {
+                        snc_sim_pc_stats_t *ps = &sim.pc_stats[(ipc - SNC_SIM_SYSRAM_BASE) / 4];
+
+                        ps->execs++;
+                        ps->cycles += sim.now - t;
+                }
+                sim.stats.instructions++;
+
+                if (!more) {
+                        if (result != SNC_SIM_DONE) {
+                                sim.fault_pc = ipc;
+                        }
+                        break;
+                }
+                if (max_cycles && sim.now - start >= max_cycles) {
+                        sim.fault_pc = sim.pc;
+                        result = SNC_SIM_CYCLE_LIMIT;
+                        break;
+                }
+        }
+
+        run_cycles = sim.now - start;
+        sim.stats.runs++;
+        sim.stats.cycles += run_cycles;
+        if (run_cycles > sim.stats.max_run_cycles) {
+                sim.stats.max_run_cycles = run_cycles;
+        }
+        return result;
+}
+
+uint32_t snc_sim_get_fault_pc(void)
+{
+        return sim.fault_pc;
+}
+
+uint64_t snc_sim_now(void)
+{
+        return sim.now;
+}
+
+void snc_sim_idle(uint64_t cycles)
+{
+        sim.now += cycles;
+}
+
+void snc_sim_get_stats(snc_sim_stats_t *stats)
+{
+        *stats = sim.stats;
+}
+
+const snc_sim_pc_stats_t *snc_sim_get_pc_stats(uint32_t pc)
+{
+        if (!in_sysram(pc)) {
+                return NULL;
+        }
+        return &sim.pc_stats[(pc - SNC_SIM_SYSRAM_BASE) / 4];
+}
+
+void snc_sim_reset_stats(void)
+{
+        memset(&sim.stats, 0, sizeof(sim.stats));
+        memset(sim.pc_stats, 0, sizeof(sim.pc_stats));
+        snc_sim_periph_reset_stats();
+}
+
+static const char *oper(char *buf, size_t len, uint32_t addr, bool indirect)
+{
+        snprintf(buf, len, indirect ? "ia(0x%08x)" : "da(0x%08x)", addr);
+        return buf;
+}
+
+uint32_t snc_sim_disasm(uint32_t addr, char *buf, size_t len)
+{
+        uint32_t w1 = snc_sim_read(addr);
+        uint32_t w2 = snc_sim_read(addr + 4);
+        uint32_t attr = (w1 >> 20) & 0xFF;
+        char o1[24];
+        char o2[24];
+
+        switch (w1 >> 28) {
+        case SENIS_OP_NOP:
+                snprintf(buf, len, "NOP");
+                return 1;
+        case SENIS_OP_WADAD:
+                snprintf(buf, len, "WADAD  %s, %s",
+                        oper(o1, sizeof(o1), OP(w1), !(w1 & (SENIS_FLAG_REG | SENIS_FLAG_DA1))),
+                        oper(o2, sizeof(o2), OP(w2), !(w2 & SENIS_FLAG_REG) && (w1 & SENIS_FLAG_InA2)));
+                return 2;
+        case SENIS_OP_WADVA:
+                snprintf(buf, len, "WADVA  %s, 0x%08x",
+                        oper(o1, sizeof(o1), OP(w1), !(w1 & (SENIS_FLAG_REG | SENIS_FLAG_DA1))), w2);
+                return 2;
+        case SENIS_OP_TOBRE:
+                snprintf(buf, len, "TOBRE  %s, 0x%08x", oper(o1, sizeof(o1), OP(w1), false), w2);
+                return 2;
+        case SENIS_OP_RDCBI:
+                snprintf(buf, len, "RDCBI  %s, %u", oper(o1, sizeof(o1), OP(w1), false),
+                        (w1 >> 23) & 0x1F);
+                return 1;
+        case SENIS_OP_RDCGR:
+                snprintf(buf, len, "RDCGR  %s, %s", oper(o1, sizeof(o1), OP(w1), false),
+                        oper(o2, sizeof(o2), OP(w2), false));
+                return 2;
+        case SENIS_OP_COBR:
+                if (attr & 0x80) {
+                        snprintf(buf, len, "COBR   loop, %s, %u",
+                                oper(o1, sizeof(o1), OP_M(w1), false), attr & 0x7F);
+                } else {
+                        snprintf(buf, len, "COBR   %s, %s",
+                                (attr & 0x0F) == 0x0A ? "eq" : (attr & 0x0F) == 0x05 ? "gr" : "??",
+                                oper(o1, sizeof(o1), OP_M(w1), attr & 0x10));
+                }
+                return 1;
+        case SENIS_OP_INC:
+                snprintf(buf, len, "INC%c   %s", (w1 & SENIS_FLAG_INC4) ? '4' : '1',
+                        oper(o1, sizeof(o1), OP_M(w1), false));
+                return 1;
+        case SENIS_OP_DEL:
+                snprintf(buf, len, "DEL    %u", w1 & 0xFF);
+                return 1;
+        case SENIS_OP_SLP:
+                snprintf(buf, len, "SLP");
+                return 1;
+        default:
+                snprintf(buf, len, ".word  0x%08x", w1);
+                return 1;
+        }
+}
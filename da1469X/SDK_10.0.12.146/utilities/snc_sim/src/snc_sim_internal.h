@@ -0,0 +1,51 @@
+/**
+ ****************************************************************************************
+ *
+ * @file snc_sim_internal.h
+ *
+ * @brief Interface between the SNC simulator core and the peripheral models
+ *
+ * Copyright (C) 2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ ****************************************************************************************
+ */
+
+#ifndef SNC_SIM_INTERNAL_H_
+#define SNC_SIM_INTERNAL_H_
+
+#include "snc_sim.h"
+
+/* Cycles for a duration at a given clock, rounded up */
+#define SNC_SIM_CYCLES(_sim_hz, _count, _hz)  \
+        ((((uint64_t) (_count) * (_sim_hz)) + (_hz) - 1) / (_hz))
+
+/**
+ * \brief Read peripheral register
+ *
+ * \param [in] addr register address
+ * \param [out] value register value
+ *
+ * \return false if there is no modelled register at addr
+ */
+bool snc_sim_periph_read(uint32_t addr, uint32_t *value);
+
+/**
+ * \brief Write peripheral register
+ *
+ * \return false if there is no modelled register at addr
+ */
+bool snc_sim_periph_write(uint32_t addr, uint32_t value);
+
+/**
+ * \brief Reset peripheral models and their statistics
+ */
+void snc_sim_periph_reset(void);
+
+/**
+ * \brief Clear peripheral statistics
+ */
+void snc_sim_periph_reset_stats(void);
+
+#endif /* SNC_SIM_INTERNAL_H_ */
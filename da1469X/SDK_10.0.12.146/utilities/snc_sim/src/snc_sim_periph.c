@@ -0,0 +1,636 @@
+/**
+ ****************************************************************************************
+ *
+ * @file snc_sim_periph.c
+ *
+ * @brief Peripheral models of the SNC simulator
+ *
+ * Models the registers of the I2C, SPI, GPADC and GPIO blocks that uCode uses. Operations
+ * complete after the time it takes on the bus; the state of a block is brought up to date
+ * lazily, when uCode accesses one of its registers. Other registers of the blocks are plain
+ * storage.
+ *
+ * Copyright (C) 2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ ****************************************************************************************
+ */
+
+#include <string.h>
+#include "snc_sim_internal.h"
+
+/* Register blocks, as in DA1469x-00.h */
+#define I2C_BASE                        ( 0x50020600 )
+#define I2C2_BASE                       ( 0x50020700 )
+#define I2C_BLOCK_SIZE                  ( 0xA8 )
+#define SPI_BASE                        ( 0x50020300 )
+#define SPI2_BASE                       ( 0x50020400 )
+#define SPI_BLOCK_SIZE                  ( 0x0C )
+#define GPADC_BASE                      ( 0x50030900 )
+#define GPADC_BLOCK_SIZE                ( 0x1C )
+#define GPIO_BASE                       ( 0x50020A00 )
+#define GPIO_BLOCK_SIZE                 ( 0x104 )
+
+#define I2C_CON_REG                     ( 0x00 )
+#define I2C_DATA_CMD_REG                ( 0x10 )
+#define I2C_STATUS_REG                  ( 0x70 )
+#define I2C_TXFLR_REG                   ( 0x74 )
+#define I2C_RXFLR_REG                   ( 0x78 )
+#define I2C_TX_ABRT_SOURCE_REG          ( 0x80 )
+
+#define I2C_CON_I2C_SPEED_Pos           ( 1 )
+#define I2C_DATA_CMD_I2C_CMD            ( 1 << 8 )
+#define I2C_DATA_CMD_I2C_STOP           ( 1 << 9 )
+#define I2C_DATA_CMD_I2C_RESTART        ( 1 << 10 )
+#define I2C_STATUS_I2C_ACTIVITY         ( 1 << 0 )
+#define I2C_STATUS_TFNF                 ( 1 << 1 )
+#define I2C_STATUS_TFE                  ( 1 << 2 )
+#define I2C_STATUS_RFNE                 ( 1 << 3 )
+#define I2C_STATUS_RFF                  ( 1 << 4 )
+#define I2C_STATUS_MST_ACTIVITY         ( 1 << 5 )
+
+#define SPI_CTRL_REG                    ( 0x00 )
+#define SPI_RX_TX_REG                   ( 0x04 )
+#define SPI_CLEAR_INT_REG               ( 0x08 )
+
+#define SPI_CTRL_SPI_CLK_Pos            ( 3 )
+#define SPI_CTRL_SPI_WORD_Pos           ( 8 )
+#define SPI_CTRL_SPI_INT_BIT            ( 1 << 13 )
+#define SPI_CTRL_SPI_BUSY               ( 1 << 19 )
+#define SPI_CTRL_SPI_RX_FIFO_EMPTY      ( 1 << 21 )
+#define SPI_CTRL_SPI_RX_FIFO_FULL       ( 1 << 22 )
+#define SPI_CTRL_SPI_TX_FIFO_EMPTY      ( 1 << 23 )
+#define SPI_CTRL_STATUS_MASK            ( SPI_CTRL_SPI_INT_BIT | SPI_CTRL_SPI_BUSY | \
+                                          SPI_CTRL_SPI_RX_FIFO_EMPTY | SPI_CTRL_SPI_RX_FIFO_FULL | \
+                                          SPI_CTRL_SPI_TX_FIFO_EMPTY )
+
+#define GP_ADC_CTRL_REG                 ( 0x00 )
+#define GP_ADC_CLEAR_INT_REG            ( 0x14 )
+#define GP_ADC_RESULT_REG               ( 0x18 )
+
+#define GP_ADC_CTRL_GP_ADC_START        ( 1 << 1 )
+#define GP_ADC_CTRL_GP_ADC_INT          ( 1 << 4 )
+
+#define P0_SET_DATA_REG                 ( 0x08 )
+#define P1_SET_DATA_REG                 ( 0x0C )
+#define P0_RESET_DATA_REG               ( 0x10 )
+#define P1_RESET_DATA_REG               ( 0x14 )
+
+#define I2C_FIFO_DEPTH                  ( 32 )
+#define SPI_FIFO_DEPTH                  ( 4 )
+
+/* I2C bit periods: START + address + ACK, data + ACK, STOP */
+#define I2C_START_BITS                  ( 10 )
+#define I2C_BYTE_BITS                   ( 9 )
+#define I2C_STOP_BITS                   ( 1 )
+
+typedef struct {
+        uint32_t regs[I2C_BLOCK_SIZE / 4];
+        struct {
+                uint16_t cmd;
+                bool start;
+                uint64_t done;
+        } tx[I2C_FIFO_DEPTH];           /* Commands in progress, in order of completion */
+        uint32_t tx_head;
+        uint32_t tx_count;
+        uint8_t rx[I2C_FIFO_DEPTH];
+        uint32_t rx_head;
+        uint32_t rx_count;
+        uint64_t bus_free;              /* Time the last command completes */
+        bool in_msg;
+        bool reading;
+        /* Attached device */
+        uint8_t dev_regs[SNC_SIM_DEV_REGS];
+        uint8_t dev_ptr;
+        bool dev_expect_reg;
+        snc_sim_bus_stats_t stats;
+} i2c_t;
+
+typedef struct {
+        uint32_t ctrl;
+        struct {
+                uint32_t rx;
+                uint64_t done;
+        } fifo[SPI_FIFO_DEPTH];         /* Words in progress or received */
+        uint32_t head;
+        uint32_t count;
+        uint64_t bus_free;
+        bool int_bit;
+        /* Attached device */
+        uint8_t cs_port;
+        uint8_t cs_pin;
+        bool selected;
+        uint8_t dev_regs[SNC_SIM_DEV_REGS];
+        uint8_t dev_ptr;
+        bool dev_read;
+        bool dev_expect_reg;
+        snc_sim_bus_stats_t stats;
+} spi_t;
+
+static struct {
+        uint32_t regs[GPADC_BLOCK_SIZE / 4];
+        uint64_t done;
+        bool busy;
+        uint32_t conversions;
+        uint16_t (*source)(uint32_t conversion);
+        snc_sim_bus_stats_t stats;
+} gpadc;
+
+static i2c_t i2c[SNC_SIM_I2C_COUNT];
+static spi_t spi[SNC_SIM_SPI_COUNT];
+static uint32_t gpio_regs[GPIO_BLOCK_SIZE / 4];
+
+static const uint32_t i2c_base[SNC_SIM_I2C_COUNT] = { I2C_BASE, I2C2_BASE };
+static const uint32_t spi_base[SNC_SIM_SPI_COUNT] = { SPI_BASE, SPI2_BASE };
+
+static bool in_block(uint32_t addr, uint32_t base, uint32_t size)
+{
+        return addr >= base && addr < base + size;
+}
+
+/*
+ * I2C
+ */
+
+static uint32_t i2c_bit_cycles(const i2c_t *c, uint32_t bits)
+{
+        static const uint32_t speed_hz[] = { 400000, 100000, 400000, 3400000 };
+        uint32_t speed = (c->regs[I2C_CON_REG / 4] >> I2C_CON_I2C_SPEED_Pos) & 0x3;
+
+        return SNC_SIM_CYCLES(snc_sim_get_config()->snc_hz, bits, speed_hz[speed]);
+}
+
+static void i2c_complete(i2c_t *c, uint16_t cmd, bool start)
+{
+        if (start) {
+                c->dev_expect_reg = true;
+        }
+
+        if (cmd & I2C_DATA_CMD_I2C_CMD) {
+                if (c->rx_count < I2C_FIFO_DEPTH) {
+                        c->rx[(c->rx_head + c->rx_count++) % I2C_FIFO_DEPTH] =
+                                c->dev_regs[c->dev_ptr++ % SNC_SIM_DEV_REGS];
+                }
+        } else if (c->dev_expect_reg) {
+                c->dev_ptr = cmd & 0xFF;
+        } else {
+                c->dev_regs[c->dev_ptr++ % SNC_SIM_DEV_REGS] = cmd & 0xFF;
+        }
+        c->dev_expect_reg = false;
+}
+
+static void i2c_update(i2c_t *c)
+{
+        uint64_t now = snc_sim_now();
+
+        while (c->tx_count && c->tx[c->tx_head].done <= now) {
+                i2c_complete(c, c->tx[c->tx_head].cmd, c->tx[c->tx_head].start);
+                c->tx_head = (c->tx_head + 1) % I2C_FIFO_DEPTH;
+                c->tx_count--;
+        }
+}
+
+static void i2c_push(i2c_t *c, uint16_t cmd)
+{
+        uint64_t now = snc_sim_now();
+        uint64_t t = c->bus_free > now ? c->bus_free : now;
+        uint32_t idx;
+        bool read = cmd & I2C_DATA_CMD_I2C_CMD;
+        bool start = !c->in_msg || (cmd & I2C_DATA_CMD_I2C_RESTART) || read != c->reading;
+
+        if (c->tx_count == I2C_FIFO_DEPTH) {
+                /* TX FIFO overflow, the command is lost */
+                return;
+        }
+
+        if (start) {
+                if (!c->in_msg) {
+                        c->stats.transfers++;
+                }
+                t += i2c_bit_cycles(c, I2C_START_BITS);
+                c->in_msg = true;
+                c->reading = read;
+        }
+        t += i2c_bit_cycles(c, I2C_BYTE_BITS);
+        if (cmd & I2C_DATA_CMD_I2C_STOP) {
+                t += i2c_bit_cycles(c, I2C_STOP_BITS);
+                c->in_msg = false;
+        }
+        c->stats.busy_cycles += t - (c->bus_free > now ? c->bus_free : now);
+        c->stats.bytes++;
+        c->bus_free = t;
+
+        idx = (c->tx_head + c->tx_count++) % I2C_FIFO_DEPTH;
+        c->tx[idx].cmd = cmd;
+        c->tx[idx].start = start;
+        c->tx[idx].done = t;
+}
+
+static uint32_t i2c_read(i2c_t *c, uint32_t offset)
+{
+        uint32_t value;
+
+        i2c_update(c);
+
+        switch (offset) {
+        case I2C_DATA_CMD_REG:
+                if (!c->rx_count) {
+                        return 0;
+                }
+                value = c->rx[c->rx_head];
+                c->rx_head = (c->rx_head + 1) % I2C_FIFO_DEPTH;
+                c->rx_count--;
+                return value;
+        case I2C_STATUS_REG:
+                value = 0;
+                if (c->tx_count || c->in_msg) {
+                        value |= I2C_STATUS_I2C_ACTIVITY | I2C_STATUS_MST_ACTIVITY;
+                }
+                if (c->tx_count < I2C_FIFO_DEPTH) {
+                        value |= I2C_STATUS_TFNF;
+                }
+                if (!c->tx_count) {
+                        value |= I2C_STATUS_TFE;
+                }
+                if (c->rx_count) {
+                        value |= I2C_STATUS_RFNE;
+                }
+                if (c->rx_count == I2C_FIFO_DEPTH) {
+                        value |= I2C_STATUS_RFF;
+                }
+                return value;
+        case I2C_TXFLR_REG:
+                return c->tx_count;
+        case I2C_RXFLR_REG:
+                return c->rx_count;
+        case I2C_TX_ABRT_SOURCE_REG:
+                /* The device always acknowledges */
+                return 0;
+        default:
+                return c->regs[offset / 4];
+        }
+}
+
+static void i2c_write(i2c_t *c, uint32_t offset, uint32_t value)
+{
+        i2c_update(c);
+
+        if (offset == I2C_DATA_CMD_REG) {
+                i2c_push(c, value & 0x7FF);
+        } else {
+                c->regs[offset / 4] = value;
+        }
+}
+
+/*
+ * SPI
+ */
+
+static void spi_update(spi_t *c)
+{
+        uint64_t now = snc_sim_now();
+        uint32_t i;
+
+        for (i = 0; i < c->count; i++) {
+                if (c->fifo[(c->head + i) % SPI_FIFO_DEPTH].done <= now) {
+                        c->int_bit = true;
+                }
+        }
+}
+
+static uint32_t spi_rx_ready(const spi_t *c)
+{
+        uint64_t now = snc_sim_now();
+        uint32_t n = 0;
+
+        while (n < c->count && c->fifo[(c->head + n) % SPI_FIFO_DEPTH].done <= now) {
+                n++;
+        }
+        return n;
+}
+
+static uint8_t spi_dev_byte(spi_t *c, uint8_t b)
+{
+        uint8_t rx = 0;
+
+        if (!c->selected) {
+                return 0xFF;
+        }
+        if (c->dev_expect_reg) {
+                c->dev_ptr = b & 0x7F;
+                c->dev_read = b & 0x80;
+                c->dev_expect_reg = false;
+        } else if (c->dev_read) {
+                rx = c->dev_regs[c->dev_ptr++ % SNC_SIM_DEV_REGS];
+        } else {
+                c->dev_regs[c->dev_ptr++ % SNC_SIM_DEV_REGS] = b;
+        }
+        return rx;
+}
+
+static void spi_push(spi_t *c, uint32_t value)
+{
+        static const uint8_t clk_div[] = { 8, 4, 2, 14 };
+        static const uint8_t word_bits[] = { 8, 16, 32, 9 };
+        uint64_t now = snc_sim_now();
+        uint64_t t = c->bus_free > now ? c->bus_free : now;
+        uint32_t bits = word_bits[(c->ctrl >> SPI_CTRL_SPI_WORD_Pos) & 0x3];
+        uint32_t spi_hz = snc_sim_get_config()->divn_hz / clk_div[(c->ctrl >> SPI_CTRL_SPI_CLK_Pos) & 0x3];
+        uint32_t rx = 0;
+        uint32_t idx;
+        int i;
+
+        if (c->count == SPI_FIFO_DEPTH) {
+                /* TX FIFO overflow, the word is lost */
+                return;
+        }
+
+        /* Device sees the bytes MSB first */
+        for (i = (bits + 7) / 8 - 1; i >= 0; i--) {
+                rx = (rx << 8) | spi_dev_byte(c, value >> (8 * i));
+        }
+
+        t += SNC_SIM_CYCLES(snc_sim_get_config()->snc_hz, bits, spi_hz);
+        c->stats.busy_cycles += t - (c->bus_free > now ? c->bus_free : now);
+        c->stats.bytes += (bits + 7) / 8;
+        c->bus_free = t;
+
+        idx = (c->head + c->count++) % SPI_FIFO_DEPTH;
+        c->fifo[idx].rx = rx;
+        c->fifo[idx].done = t;
+}
+
+static uint32_t spi_read(spi_t *c, uint32_t offset)
+{
+        uint32_t ready;
+        uint32_t value;
+
+        spi_update(c);
+        ready = spi_rx_ready(c);
+
+        switch (offset) {
+        case SPI_CTRL_REG:
+                value = c->ctrl & ~SPI_CTRL_STATUS_MASK;
+                if (c->int_bit) {
+                        value |= SPI_CTRL_SPI_INT_BIT;
+                }
+                if (ready < c->count) {
+                        value |= SPI_CTRL_SPI_BUSY;
+                } else {
+                        value |= SPI_CTRL_SPI_TX_FIFO_EMPTY;
+                }
+                if (!ready) {
+                        value |= SPI_CTRL_SPI_RX_FIFO_EMPTY;
+                }
+                if (ready == SPI_FIFO_DEPTH) {
+                        value |= SPI_CTRL_SPI_RX_FIFO_FULL;
+                }
+                return value;
+        case SPI_RX_TX_REG:
+                if (!ready) {
+                        return 0;
+                }
+                value = c->fifo[c->head].rx;
+                c->head = (c->head + 1) % SPI_FIFO_DEPTH;
+                c->count--;
+                return value;
+        default:
+                return 0;
+        }
+}
+
+static void spi_write(spi_t *c, uint32_t offset, uint32_t value)
+{
+        spi_update(c);
+
+        switch (offset) {
+        case SPI_CTRL_REG:
+                c->ctrl = value & ~SPI_CTRL_STATUS_MASK;
+                break;
+        case SPI_RX_TX_REG:
+                spi_push(c, value);
+                break;
+        case SPI_CLEAR_INT_REG:
+                c->int_bit = false;
+                break;
+        }
+}
+
+static void spi_cs(uint8_t port, uint32_t mask, bool active)
+{
+        int id;
+
+        for (id = 0; id < SNC_SIM_SPI_COUNT; id++) {
+                spi_t *c = &spi[id];
+
+                if (c->cs_port != port || !(mask & (1UL << c->cs_pin)) || c->selected == active) {
+                        continue;
+                }
+                c->selected = active;
+                if (active) {
+                        c->dev_expect_reg = true;
+                        c->stats.transfers++;
+                }
+        }
+}
+
+/*
+ * GPADC
+ */
+
+static void gpadc_update(void)
+{
+        if (gpadc.busy && gpadc.done <= snc_sim_now()) {
+                uint32_t n = gpadc.conversions++;
+
+                gpadc.busy = false;
+                gpadc.regs[GP_ADC_CTRL_REG / 4] &= ~GP_ADC_CTRL_GP_ADC_START;
+                gpadc.regs[GP_ADC_CTRL_REG / 4] |= GP_ADC_CTRL_GP_ADC_INT;
+                gpadc.regs[GP_ADC_RESULT_REG / 4] = gpadc.source ? gpadc.source(n) :
+                                                                   (uint16_t) (n * 64);
+        }
+}
+
+static void gpadc_write(uint32_t offset, uint32_t value)
+{
+        gpadc_update();
+
+        switch (offset) {
+        case GP_ADC_CTRL_REG:
+                if ((value & GP_ADC_CTRL_GP_ADC_START) && !gpadc.busy) {
+                        uint32_t conv = snc_sim_get_config()->gpadc_conv_cycles;
+
+                        gpadc.busy = true;
+                        gpadc.done = snc_sim_now() + conv;
+                        gpadc.stats.busy_cycles += conv;
+                        gpadc.stats.transfers++;
+                        gpadc.stats.bytes += 2;
+                }
+                /* INT is read-only, cleared through GP_ADC_CLEAR_INT_REG */
+                gpadc.regs[offset / 4] = (value & ~GP_ADC_CTRL_GP_ADC_INT) |
+                        (gpadc.regs[offset / 4] & GP_ADC_CTRL_GP_ADC_INT);
+                if (gpadc.busy) {
+                        gpadc.regs[offset / 4] |= GP_ADC_CTRL_GP_ADC_START;
+                }
+                break;
+        case GP_ADC_CLEAR_INT_REG:
+                gpadc.regs[GP_ADC_CTRL_REG / 4] &= ~GP_ADC_CTRL_GP_ADC_INT;
+                break;
+        case GP_ADC_RESULT_REG:
+                break;
+        default:
+                gpadc.regs[offset / 4] = value;
+                break;
+        }
+}
+
+/*
+ * GPIO
+ */
+
+static void gpio_write(uint32_t offset, uint32_t value)
+{
+        switch (offset) {
+        case P0_SET_DATA_REG:
+        case P1_SET_DATA_REG:
+                gpio_regs[(offset - P0_SET_DATA_REG) / 4] |= value;
+                spi_cs((offset - P0_SET_DATA_REG) / 4, value, false);
+                break;
+        case P0_RESET_DATA_REG:
+        case P1_RESET_DATA_REG:
+                gpio_regs[(offset - P0_RESET_DATA_REG) / 4] &= ~value;
+                spi_cs((offset - P0_RESET_DATA_REG) / 4, value, true);
+                break;
+        default:
+                gpio_regs[offset / 4] = value;
+                break;
+        }
+}
+
+bool snc_sim_periph_read(uint32_t addr, uint32_t *value)
+{
+        int id;
+
+        if (addr & 3) {
+                return false;
+        }
+
+        for (id = 0; id < SNC_SIM_I2C_COUNT; id++) {
+                if (in_block(addr, i2c_base[id], I2C_BLOCK_SIZE)) {
+                        *value = i2c_read(&i2c[id], addr - i2c_base[id]);
+                        return true;
+                }
+        }
+        for (id = 0; id < SNC_SIM_SPI_COUNT; id++) {
+                if (in_block(addr, spi_base[id], SPI_BLOCK_SIZE)) {
+                        *value = spi_read(&spi[id], addr - spi_base[id]);
+                        return true;
+                }
+        }
+        if (in_block(addr, GPADC_BASE, GPADC_BLOCK_SIZE)) {
+                gpadc_update();
+                *value = gpadc.regs[(addr - GPADC_BASE) / 4];
+                return true;
+        }
+        if (in_block(addr, GPIO_BASE, GPIO_BLOCK_SIZE)) {
+                *value = gpio_regs[(addr - GPIO_BASE) / 4];
+                return true;
+        }
+        return false;
+}
+
+bool snc_sim_periph_write(uint32_t addr, uint32_t value)
+{
+        int id;
+
+        if (addr & 3) {
+                return false;
+        }
+
+        for (id = 0; id < SNC_SIM_I2C_COUNT; id++) {
+                if (in_block(addr, i2c_base[id], I2C_BLOCK_SIZE)) {
+                        i2c_write(&i2c[id], addr - i2c_base[id], value);
+                        return true;
+                }
+        }
+        for (id = 0; id < SNC_SIM_SPI_COUNT; id++) {
+                if (in_block(addr, spi_base[id], SPI_BLOCK_SIZE)) {
+                        spi_write(&spi[id], addr - spi_base[id], value);
+                        return true;
+                }
+        }
+        if (in_block(addr, GPADC_BASE, GPADC_BLOCK_SIZE)) {
+                gpadc_write(addr - GPADC_BASE, value);
+                return true;
+        }
+        if (in_block(addr, GPIO_BASE, GPIO_BLOCK_SIZE)) {
+                gpio_write(addr - GPIO_BASE, value);
+                return true;
+        }
+        return false;
+}
+
+void snc_sim_periph_reset(void)
+{
+        int id;
+
+        memset(i2c, 0, sizeof(i2c));
+        memset(spi, 0, sizeof(spi));
+        memset(&gpadc, 0, sizeof(gpadc));
+        memset(gpio_regs, 0, sizeof(gpio_regs));
+
+        for (id = 0; id < SNC_SIM_SPI_COUNT; id++) {
+                spi[id].cs_port = 0xFF;
+        }
+}
+
+void snc_sim_periph_reset_stats(void)
+{
+        int id;
+
+        for (id = 0; id < SNC_SIM_I2C_COUNT; id++) {
+                memset(&i2c[id].stats, 0, sizeof(i2c[id].stats));
+        }
+        for (id = 0; id < SNC_SIM_SPI_COUNT; id++) {
+                memset(&spi[id].stats, 0, sizeof(spi[id].stats));
+        }
+        memset(&gpadc.stats, 0, sizeof(gpadc.stats));
+}
+
+uint8_t *snc_sim_i2c_dev_regs(int id)
+{
+        return i2c[id].dev_regs;
+}
+
+uint8_t *snc_sim_spi_dev_regs(int id)
+{
+        return spi[id].dev_regs;
+}
+
+void snc_sim_spi_set_cs(int id, uint8_t port, uint8_t pin)
+{
+        spi[id].cs_port = port;
+        spi[id].cs_pin = pin;
+        spi[id].selected = false;
+}
+
+void snc_sim_gpadc_set_source(uint16_t (*source)(uint32_t conversion))
+{
+        gpadc.source = source;
+}
+
+void snc_sim_i2c_get_stats(int id, snc_sim_bus_stats_t *stats)
+{
+        *stats = i2c[id].stats;
+}
+
+void snc_sim_spi_get_stats(int id, snc_sim_bus_stats_t *stats)
+{
+        *stats = spi[id].stats;
+}
+
+void snc_sim_gpadc_get_stats(snc_sim_bus_stats_t *stats)
+{
+        *stats = gpadc.stats;
+}
@@ -0,0 +1,86 @@
+/**
+ ****************************************************************************************
+ *
+ * @file snc_sim_queue.c
+ *
+ * @brief SNC-to-CM33 queues of the SNC simulator
+ *
+ * CM33 side of the queues of sdk/bsp/snc/src/snc_queues.c, operating on the simulated System
+ * RAM. Only word elements without data timestamp are supported.
+ *
+ * Copyright (C) 2022 Dialog Semiconductor.
+ * This computer program includes Confidential, Proprietary Information
+ * of Dialog Semiconductor. All Rights Reserved.
+ *
+ ****************************************************************************************
+ */
+
+#include "snc_sim.h"
+
+#define SNC_SIM_Q_PREAMBLE_SIZE_MASK    ( 0x7FFFFFFF )
+#define SIMPLE_HEADER_SIZE              ( 1 )
+
+uint32_t snc_sim_queue_create(uint32_t num_of_chunks, uint32_t max_chunk_bytes)
+{
+        uint32_t q = snc_sim_alloc(SNC_SIM_Q_SIZE);
+        uint32_t chunk_elements = ((max_chunk_bytes + 1) / 4) + 4 - 2;
+        uint32_t chunk_words = SIMPLE_HEADER_SIZE + chunk_elements;
+        uint32_t data = snc_sim_alloc(chunk_words * num_of_chunks * 4);
+        uint32_t chunks = snc_sim_alloc(num_of_chunks * 4);
+        uint32_t i;
+
+        for (i = 0; i < num_of_chunks; i++) {
+                snc_sim_write(chunks + i * 4, data + i * chunk_words * 4);
+        }
+
+        snc_sim_write(q + SNC_SIM_Q_PCHUNKS, chunks);
+        snc_sim_write(q + SNC_SIM_Q_FLAGS, SNC_SIM_Q_FLAG_WEIGHT_WORD | SNC_SIM_Q_FLAG_NO_TIMESTAMP);
+        snc_sim_write(q + SNC_SIM_Q_WRITE_CHUNK_PT, chunks);
+        snc_sim_write(q + SNC_SIM_Q_READ_CHUNK_PT, chunks);
+        snc_sim_write(q + SNC_SIM_Q_MAX_CHUNK_SIZE_BYTES, max_chunk_bytes);
+        snc_sim_write(q + SNC_SIM_Q_NUM_OF_CHUNKS, num_of_chunks);
+        snc_sim_write(q + SNC_SIM_Q_LAST_CHUNK_PT, chunks + (num_of_chunks - 1) * 4);
+        snc_sim_write(q + SNC_SIM_Q_DATA, data);
+
+        return q;
+}
+
+bool snc_sim_queue_pop(uint32_t q, uint32_t *size)
+{
+        uint32_t read_pt = snc_sim_read(q + SNC_SIM_Q_READ_CHUNK_PT);
+        uint32_t chunk = snc_sim_read(read_pt);
+        uint32_t preamble = snc_sim_read(chunk);
+
+        if (!(preamble & SNC_SIM_Q_PREAMBLE_WBIT)) {
+                return false;
+        }
+        if (size) {
+                *size = preamble & SNC_SIM_Q_PREAMBLE_SIZE_MASK;
+        }
+
+        /* Mark the chunk as read and advance to the next one */
+        snc_sim_write(chunk, 0);
+        if (read_pt == snc_sim_read(q + SNC_SIM_Q_LAST_CHUNK_PT)) {
+                read_pt = snc_sim_read(q + SNC_SIM_Q_PCHUNKS);
+        } else {
+                read_pt += 4;
+        }
+        snc_sim_write(q + SNC_SIM_Q_READ_CHUNK_PT, read_pt);
+
+        return true;
+}
+
+uint32_t snc_sim_queue_get_alloc_chunks(uint32_t q)
+{
+        uint32_t chunks = snc_sim_read(q + SNC_SIM_Q_PCHUNKS);
+        uint32_t num = snc_sim_read(q + SNC_SIM_Q_NUM_OF_CHUNKS);
+        uint32_t alloc = 0;
+        uint32_t i;
+
+        for (i = 0; i < num; i++) {
+                if (snc_sim_read(snc_sim_read(chunks + i * 4)) & SNC_SIM_Q_PREAMBLE_WBIT) {
+                        alloc++;
+                }
+        }
+        return alloc;
+}